@@ -356,6 +356,7 @@ private:
         return;
       }
       auto Duration = std::chrono::steady_clock::now() - Start;
+      Server->recordLatency(Method, Duration);
       if (Reply) {
         log("--> reply:{0}({1}) {2:ms}", Method, ID, Duration);
         if (TraceArgs)
@@ -647,6 +648,71 @@ void ClangdLSPServer::onSync(const NoParams &Params,
                                   "Not idle after a minute"));
 }
 
+void ClangdLSPServer::onMemoryUsage(const NoParams &,
+                                    Callback<llvm::json::Value> Reply) {
+  ClangdServer::MemoryUsage Usage = Server->getMemoryUsage();
+  Reply(llvm::json::Object{
+      {"asts", int64_t(Usage.ASTs)},
+      {"preambles", int64_t(Usage.Preambles)},
+      {"dynamicIndex", int64_t(Usage.DynamicIndex)},
+      {"backgroundIndex", int64_t(Usage.BackgroundIndex)},
+  });
+}
+
+void ClangdLSPServer::recordLatency(
+    llvm::StringRef Method, std::chrono::steady_clock::duration Latency) {
+  auto Millis =
+      std::chrono::duration_cast<std::chrono::milliseconds>(Latency).count();
+  unsigned Bucket = 0;
+  while (Bucket + 1 < NumLatencyBuckets && (int64_t(1) << Bucket) <= Millis)
+    ++Bucket;
+  std::lock_guard<std::mutex> Lock(LatenciesMutex);
+  auto It = Latencies.try_emplace(Method);
+  if (It.second)
+    It.first->second.fill(0);
+  ++It.first->second[Bucket];
+}
+
+// Returns the upper bound in milliseconds of the bucket containing the
+// \p Percentile-th percentile, or None if it's in the last, unbounded bucket.
+static llvm::Optional<int64_t>
+latencyPercentile(llvm::ArrayRef<unsigned> Buckets, unsigned Count,
+                  unsigned Percentile) {
+  uint64_t Rank = (uint64_t(Count) * Percentile + 99) / 100;
+  uint64_t Seen = 0;
+  for (unsigned I = 0; I + 1 < Buckets.size(); ++I) {
+    Seen += Buckets[I];
+    if (Seen >= Rank)
+      return int64_t(1) << I;
+  }
+  return None;
+}
+
+void ClangdLSPServer::onLatencyHistogram(const NoParams &,
+                                         Callback<llvm::json::Value> Reply) {
+  // Reply() records the latency of this request, so it must not be called
+  // with LatenciesMutex held.
+  llvm::StringMap<LatencyBuckets> Snapshot;
+  {
+    std::lock_guard<std::mutex> Lock(LatenciesMutex);
+    Snapshot = Latencies;
+  }
+  llvm::json::Object Result;
+  for (const auto &MethodAndBuckets : Snapshot) {
+    const LatencyBuckets &Buckets = MethodAndBuckets.second;
+    unsigned Count = 0;
+    for (unsigned N : Buckets)
+      Count += N;
+    Result[MethodAndBuckets.first()] = llvm::json::Object{
+        {"count", Count},
+        {"p50", latencyPercentile(Buckets, Count, 50)},
+        {"p99", latencyPercentile(Buckets, Count, 99)},
+        {"buckets", llvm::json::Array(Buckets)},
+    };
+  }
+  Reply(std::move(Result));
+}
+
 void ClangdLSPServer::onDocumentDidOpen(
     const DidOpenTextDocumentParams &Params) {
   PathRef File = Params.textDocument.uri.file();
@@ -1365,6 +1431,8 @@ ClangdLSPServer::ClangdLSPServer(
   MsgHandler->bind("textDocument/documentLink", &ClangdLSPServer::onDocumentLink);
   MsgHandler->bind("textDocument/semanticTokens", &ClangdLSPServer::onSemanticTokens);
   MsgHandler->bind("textDocument/semanticTokens/edits", &ClangdLSPServer::onSemanticTokensEdits);
+  MsgHandler->bind("$/memoryUsage", &ClangdLSPServer::onMemoryUsage);
+  MsgHandler->bind("$/latencyHistogram", &ClangdLSPServer::onLatencyHistogram);
   // clang-format on
 }
 
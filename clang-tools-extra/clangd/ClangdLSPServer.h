@@ -22,6 +22,8 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/JSON.h"
+#include <array>
+#include <chrono>
 #include <memory>
 
 namespace clang {
@@ -122,6 +124,8 @@ private:
   void onSemanticTokens(const SemanticTokensParams &, Callback<SemanticTokens>);
   void onSemanticTokensEdits(const SemanticTokensEditsParams &,
                              Callback<SemanticTokensOrEdits>);
+  void onMemoryUsage(const NoParams &, Callback<llvm::json::Value>);
+  void onLatencyHistogram(const NoParams &, Callback<llvm::json::Value>);
 
   std::vector<Fix> getFixes(StringRef File, const clangd::Diagnostic &D);
 
@@ -167,6 +171,15 @@ private:
   // Last semantic-tokens response, for incremental requests.
   std::mutex SemanticTokensMutex;
   llvm::StringMap<SemanticTokens> LastSemanticTokens;
+  // Reply latencies of LSP calls by method, for $/latencyHistogram.
+  // Bucket I counts the replies that took less than 2^I milliseconds, the
+  // last bucket counts all slower ones.
+  static constexpr unsigned NumLatencyBuckets = 18;
+  using LatencyBuckets = std::array<unsigned, NumLatencyBuckets>;
+  std::mutex LatenciesMutex;
+  llvm::StringMap<LatencyBuckets> Latencies;
+  void recordLatency(llvm::StringRef Method,
+                     std::chrono::steady_clock::duration Latency);
 
   // Most code should not deal with Transport directly.
   // MessageHandler deals with incoming messages, use call() etc for outgoing.
@@ -121,6 +121,7 @@ ClangdServer::Options::operator TUScheduler::Options() const {
   Opts.AsyncThreadsCount = AsyncThreadsCount;
   Opts.RetentionPolicy = RetentionPolicy;
   Opts.StorePreamblesInMemory = StorePreamblesInMemory;
+  Opts.DiagnoseWithStalePreamble = DiagnoseWithStalePreamble;
   Opts.UpdateDebounce = UpdateDebounce;
   return Opts;
 }
@@ -708,6 +709,18 @@ ClangdServer::getUsedBytesPerFile() const {
   return WorkScheduler.getUsedBytesPerFile();
 }
 
+ClangdServer::MemoryUsage ClangdServer::getMemoryUsage() const {
+  MemoryUsage Result;
+  TUScheduler::MemoryUsage Scheduler = WorkScheduler.getMemoryUsage();
+  Result.ASTs = Scheduler.ASTs;
+  Result.Preambles = Scheduler.Preambles;
+  if (DynamicIdx)
+    Result.DynamicIndex = DynamicIdx->estimateMemoryUsage();
+  if (BackgroundIdx)
+    Result.BackgroundIndex = BackgroundIdx->estimateMemoryUsage();
+  return Result;
+}
+
 LLVM_NODISCARD bool
 ClangdServer::blockUntilIdleForTest(llvm::Optional<double> TimeoutSeconds) {
   return WorkScheduler.blockUntilIdle(timeoutSeconds(TimeoutSeconds)) &&
@@ -99,6 +99,10 @@ public:
     /// Cached preambles are potentially large. If false, store them on disk.
     bool StorePreamblesInMemory = true;
 
+    /// Publish diagnostics from stale preambles while they are rebuilt after
+    /// header changes. See TUScheduler::Options.
+    bool DiagnoseWithStalePreamble = false;
+
     /// If true, ClangdServer builds a dynamic in-memory index for symbols in
     /// opened files and uses the index to augment code completion results.
     bool BuildDynamicSymbolIndex = false;
@@ -313,6 +317,19 @@ public:
   /// FIXME: those metrics might be useful too, we should add them.
   std::vector<std::pair<Path, std::size_t>> getUsedBytesPerFile() const;
 
+  /// Estimated memory usage of the components of the server, in bytes.
+  /// Memory required for in-flight requests is not accounted for.
+  struct MemoryUsage {
+    /// ASTs of open files that are not being used by a request.
+    std::size_t ASTs = 0;
+    /// Preambles of open files and of recently closed ones.
+    std::size_t Preambles = 0;
+    /// Symbols of open files and of the headers they include.
+    std::size_t DynamicIndex = 0;
+    std::size_t BackgroundIndex = 0;
+  };
+  MemoryUsage getMemoryUsage() const;
+
   // Blocks the main thread until the server is idle. Only for use in tests.
   // Returns false if the timeout expires.
   LLVM_NODISCARD bool
@@ -1528,6 +1528,8 @@ private:
                const std::vector<RawIdentifier> &IdentifierResults) {
     trace::Span Tracer("Merge and score results");
     std::vector<CompletionCandidate::Bundle> Bundles;
+    // The fuzzy match score of the name shared by each bundle.
+    std::vector<float> BundleNameMatch;
     llvm::DenseMap<size_t, size_t> BundleLookup;
     auto AddToBundles = [&](const CodeCompletionResult *SemaResult,
                             const Symbol *IndexResult,
@@ -1536,22 +1538,32 @@ private:
       C.SemaResult = SemaResult;
       C.IndexResult = IndexResult;
       C.IdentifierResult = IdentifierResult;
-      if (C.IndexResult) {
+      if (C.IndexResult)
         C.Name = IndexResult->Name;
-        C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
-      } else if (C.SemaResult) {
+      else if (C.SemaResult)
         C.Name = Recorder->getName(*SemaResult);
-      } else {
+      else {
         assert(IdentifierResult);
         C.Name = IdentifierResult->Name;
       }
+      // Drop candidates that don't match the filter before doing any more
+      // work on them. Bundled candidates share their name, so this doesn't
+      // affect the bundles that are kept.
+      auto NameMatch = fuzzyScore(C);
+      if (!NameMatch)
+        return;
+      if (C.IndexResult)
+        C.RankedIncludeHeaders = getRankedIncludes(*C.IndexResult);
       if (auto OverloadSet = C.overloadSet(Opts)) {
         auto Ret = BundleLookup.try_emplace(OverloadSet, Bundles.size());
-        if (Ret.second)
+        if (Ret.second) {
           Bundles.emplace_back();
+          BundleNameMatch.push_back(*NameMatch);
+        }
         Bundles[Ret.first->second].push_back(std::move(C));
       } else {
         Bundles.emplace_back();
+        BundleNameMatch.push_back(*NameMatch);
         Bundles.back().push_back(std::move(C));
       }
     };
@@ -1583,8 +1595,8 @@ private:
     // We only keep the best N results at any time, in "native" format.
     TopN<ScoredBundle, ScoredBundleGreater> Top(
         Opts.Limit == 0 ? std::numeric_limits<size_t>::max() : Opts.Limit);
-    for (auto &Bundle : Bundles)
-      addCandidate(Top, std::move(Bundle));
+    for (size_t I = 0; I < Bundles.size(); ++I)
+      addCandidate(Top, std::move(Bundles[I]), BundleNameMatch[I]);
     return std::move(Top).items();
   }
 
@@ -1597,9 +1609,10 @@ private:
     return Filter->match(C.Name);
   }
 
-  // Scores a candidate and adds it to the TopN structure.
+  // Scores a candidate and adds it to the TopN structure. \p NameMatch is the
+  // fuzzyScore() of the bundle's name.
   void addCandidate(TopN<ScoredBundle, ScoredBundleGreater> &Candidates,
-                    CompletionCandidate::Bundle Bundle) {
+                    CompletionCandidate::Bundle Bundle, float NameMatch) {
     SymbolQualitySignals Quality;
     SymbolRelevanceSignals Relevance;
     Relevance.Context = CCContextKind;
@@ -1613,10 +1626,7 @@ private:
     Relevance.ContextWords = &ContextWords;
 
     auto &First = Bundle.front();
-    if (auto FuzzyScore = fuzzyScore(First))
-      Relevance.NameMatch = *FuzzyScore;
-    else
-      return;
+    Relevance.NameMatch = NameMatch;
     SymbolOrigin Origin = SymbolOrigin::Unknown;
     bool FromIndex = false;
     for (const auto &Candidate : Bundle) {
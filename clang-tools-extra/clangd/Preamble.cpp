@@ -83,14 +83,16 @@ PreambleData::PreambleData(const ParseInputs &Inputs,
                            std::unique_ptr<PreambleFileStatusCache> StatCache,
                            CanonicalIncludes CanonIncludes)
     : Version(Inputs.Version), CompileCommand(Inputs.CompileCommand),
-      Preamble(std::move(Preamble)), Diags(std::move(Diags)),
+      Preamble(std::move(Preamble)),
+      MainFilePreamble(
+          Inputs.Contents.substr(0, this->Preamble.getBounds().Size)),
+      Diags(std::move(Diags)),
       Includes(std::move(Includes)), Macros(std::move(Macros)),
       StatCache(std::move(StatCache)), CanonIncludes(std::move(CanonIncludes)) {
 }
 
 std::shared_ptr<const PreambleData>
 buildPreamble(PathRef FileName, CompilerInvocation &CI,
-              std::shared_ptr<const PreambleData> OldPreamble,
               const ParseInputs &Inputs, bool StoreInMemory,
               PreambleParsedCallback PreambleCallback) {
   // Note that we don't need to copy the input contents, preamble can live
@@ -100,23 +102,6 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
   auto Bounds =
       ComputePreambleBounds(*CI.getLangOpts(), ContentsBuffer.get(), 0);
 
-  if (OldPreamble &&
-      compileCommandsAreEqual(Inputs.CompileCommand,
-                              OldPreamble->CompileCommand) &&
-      OldPreamble->Preamble.CanReuse(CI, ContentsBuffer.get(), Bounds,
-                                     Inputs.FS.get())) {
-    vlog("Reusing preamble version {0} for version {1} of {2}",
-         OldPreamble->Version, Inputs.Version, FileName);
-    return OldPreamble;
-  }
-  if (OldPreamble)
-    vlog("Rebuilding invalidated preamble for {0} version {1} "
-         "(previous was version {2})",
-         FileName, Inputs.Version, OldPreamble->Version);
-  else
-    vlog("Building first preamble for {0} verson {1}", FileName,
-         Inputs.Version);
-
   trace::Span Tracer("BuildPreamble");
   SPAN_ATTACH(Tracer, "File", FileName);
   StoreDiags PreambleDiagnostics;
@@ -172,5 +157,27 @@ buildPreamble(PathRef FileName, CompilerInvocation &CI,
   }
 }
 
+PreambleReuse checkPreambleReuse(PathRef FileName,
+                                 const CompilerInvocation &CI,
+                                 const ParseInputs &Inputs,
+                                 const PreambleData &Preamble) {
+  if (!compileCommandsAreEqual(Inputs.CompileCommand, Preamble.CompileCommand))
+    return PreambleReuse::Invalid;
+  auto ContentsBuffer =
+      llvm::MemoryBuffer::getMemBuffer(Inputs.Contents, FileName);
+  auto Bounds =
+      ComputePreambleBounds(*CI.getLangOpts(), ContentsBuffer.get(), 0);
+  if (Preamble.Preamble.CanReuse(CI, ContentsBuffer.get(), Bounds,
+                                 Inputs.FS.get()))
+    return PreambleReuse::Reusable;
+  PreambleBounds OldBounds = Preamble.Preamble.getBounds();
+  if (Bounds.Size != OldBounds.Size ||
+      Bounds.PreambleEndsAtStartOfLine !=
+          OldBounds.PreambleEndsAtStartOfLine ||
+      !llvm::StringRef(Inputs.Contents).startswith(Preamble.MainFilePreamble))
+    return PreambleReuse::Invalid;
+  return PreambleReuse::DependenciesChanged;
+}
+
 } // namespace clangd
 } // namespace clang
@@ -53,6 +53,8 @@ struct PreambleData {
   std::string Version;
   tooling::CompileCommand CompileCommand;
   PrecompiledPreamble Preamble;
+  // The preamble section of the main file this preamble was built from.
+  std::string MainFilePreamble;
   std::vector<Diag> Diags;
   // Processes like code completions and go-to-definitions will need #include
   // information, and their compile action skips preamble range.
@@ -71,18 +73,33 @@ using PreambleParsedCallback =
     std::function<void(ASTContext &, std::shared_ptr<clang::Preprocessor>,
                        const CanonicalIncludes &)>;
 
-/// Build a preamble for the new inputs unless an old one can be reused.
-/// If \p OldPreamble can be reused, it is returned unchanged.
-/// If \p OldPreamble is null, always builds the preamble.
+/// Build a preamble for the new inputs. Use checkPreambleReuse() first to
+/// find out whether an existing preamble can be reused instead.
 /// If \p PreambleCallback is set, it will be run on top of the AST while
-/// building the preamble. Note that if the old preamble was reused, no AST is
-/// built and, therefore, the callback will not be executed.
+/// building the preamble.
 std::shared_ptr<const PreambleData>
 buildPreamble(PathRef FileName, CompilerInvocation &CI,
-              std::shared_ptr<const PreambleData> OldPreamble,
               const ParseInputs &Inputs, bool StoreInMemory,
               PreambleParsedCallback PreambleCallback);
 
+/// Whether an existing preamble can be used for new inputs.
+enum class PreambleReuse {
+  /// The preamble is up to date.
+  Reusable,
+  /// The compile command and the preamble section of the main file are the
+  /// same, but some of the files the preamble includes have changed. The
+  /// preamble can still be used to build an approximate AST.
+  DependenciesChanged,
+  /// The preamble doesn't match the inputs.
+  Invalid,
+};
+
+/// Checks whether \p Preamble can be reused for \p Inputs. This stats all the
+/// files the preamble depends on, so callers should do it once per update.
+PreambleReuse checkPreambleReuse(PathRef FileName,
+                                 const CompilerInvocation &CI,
+                                 const ParseInputs &Inputs,
+                                 const PreambleData &Preamble);
 
 } // namespace clangd
 } // namespace clang
@@ -89,33 +89,44 @@ class TUScheduler::ASTCache {
 public:
   using Key = const ASTWorker *;
 
-  ASTCache(unsigned MaxRetainedASTs) : MaxRetainedASTs(MaxRetainedASTs) {}
+  ASTCache(unsigned MaxRetainedASTs, std::size_t MaxRetainedBytes)
+      : MaxRetainedASTs(MaxRetainedASTs), MaxRetainedBytes(MaxRetainedBytes) {}
 
   /// Returns result of getUsedBytes() for the AST cached by \p K.
   /// If no AST is cached, 0 is returned.
   std::size_t getUsedBytes(Key K) {
     std::lock_guard<std::mutex> Lock(Mut);
     auto It = findByKey(K);
-    if (It == LRU.end() || !It->second)
+    if (It == LRU.end())
       return 0;
-    return It->second->getUsedBytes();
+    return It->Bytes;
   }
 
-  /// Store the value in the pool, possibly removing the last used AST.
+  /// Store the value in the pool, possibly removing the least recently used
+  /// ASTs to stay within the count and byte limits.
   /// The value should not be in the pool when this function is called.
   void put(Key K, std::unique_ptr<ParsedAST> V) {
+    // Computing the size walks the allocators of the AST, do it before taking
+    // the lock.
+    std::size_t Bytes = V ? V->getUsedBytes() : 0;
+    std::vector<std::unique_ptr<ParsedAST>> ForCleanup;
     std::unique_lock<std::mutex> Lock(Mut);
     assert(findByKey(K) == LRU.end());
 
-    LRU.insert(LRU.begin(), {K, std::move(V)});
-    if (LRU.size() <= MaxRetainedASTs)
-      return;
-    // We're past the limit, remove the last element.
-    std::unique_ptr<ParsedAST> ForCleanup = std::move(LRU.back().second);
-    LRU.pop_back();
-    // Run the expensive destructor outside the lock.
+    LRU.insert(LRU.begin(), {K, std::move(V), Bytes});
+    TotalBytes += Bytes;
+    // Remove the last elements while we're past the limits. The byte limit
+    // never removes the element we've just added.
+    while (LRU.size() > MaxRetainedASTs ||
+           (LRU.size() > 1 && MaxRetainedBytes &&
+            TotalBytes > MaxRetainedBytes)) {
+      TotalBytes -= LRU.back().Bytes;
+      ForCleanup.push_back(std::move(LRU.back().Value));
+      LRU.pop_back();
+    }
+    // Run the expensive destructors outside the lock.
     Lock.unlock();
-    ForCleanup.reset();
+    ForCleanup.clear();
   }
 
   /// Returns the cached value for \p K, or llvm::None if the value is not in
@@ -126,7 +137,8 @@ public:
     auto Existing = findByKey(K);
     if (Existing == LRU.end())
       return None;
-    std::unique_ptr<ParsedAST> V = std::move(Existing->second);
+    std::unique_ptr<ParsedAST> V = std::move(Existing->Value);
+    TotalBytes -= Existing->Bytes;
     LRU.erase(Existing);
     // GCC 4.8 fails to compile `return V;`, as it tries to call the copy
     // constructor of unique_ptr, so we call the move ctor explicitly to avoid
@@ -135,17 +147,24 @@ public:
   }
 
 private:
-  using KVPair = std::pair<Key, std::unique_ptr<ParsedAST>>;
+  struct Entry {
+    Key K;
+    std::unique_ptr<ParsedAST> Value;
+    /// Size of Value at the time it was put into the cache.
+    std::size_t Bytes;
+  };
 
-  std::vector<KVPair>::iterator findByKey(Key K) {
-    return llvm::find_if(LRU, [K](const KVPair &P) { return P.first == K; });
+  std::vector<Entry>::iterator findByKey(Key K) {
+    return llvm::find_if(LRU, [K](const Entry &E) { return E.K == K; });
   }
 
   std::mutex Mut;
   unsigned MaxRetainedASTs;
+  std::size_t MaxRetainedBytes;
   /// Items sorted in LRU order, i.e. first item is the most recently accessed
   /// one.
-  std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
+  std::vector<Entry> LRU; /* GUARDED_BY(Mut) */
+  std::size_t TotalBytes = 0; /* GUARDED_BY(Mut) */
 };
 
 namespace {
@@ -166,7 +185,8 @@ class ASTWorker {
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
             TUScheduler::ASTCache &LRUCache, Semaphore &Barrier, bool RunSync,
             DebouncePolicy UpdateDebounce, bool StorePreamblesInMemory,
-            ParsingCallbacks &Callbacks);
+            bool DiagnoseWithStalePreamble, ParsingCallbacks &Callbacks,
+            std::shared_ptr<const PreambleData> Preamble);
 
 public:
   /// Create a new ASTWorker and return a handle to it.
@@ -174,11 +194,15 @@ public:
   /// is null, all requests will be processed on the calling thread
   /// synchronously instead. \p Barrier is acquired when processing each
   /// request, it is used to limit the number of actively running threads.
+  /// \p Preamble, if not null, is a preamble previously built for this file
+  /// that the first update will try to reuse.
   static ASTWorkerHandle
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
          TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
          Semaphore &Barrier, DebouncePolicy UpdateDebounce,
-         bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
+         bool StorePreamblesInMemory, bool DiagnoseWithStalePreamble,
+         ParsingCallbacks &Callbacks,
+         std::shared_ptr<const PreambleData> Preamble = nullptr);
   ~ASTWorker();
 
   void update(ParseInputs Inputs, WantDiagnostics);
@@ -204,6 +228,8 @@ public:
   void waitForFirstPreamble() const;
 
   std::size_t getUsedBytes() const;
+  /// Returns the size of the cached AST, or 0 if there's none.
+  std::size_t getCachedASTBytes() const;
   bool isASTCached() const;
 
 private:
@@ -253,6 +279,7 @@ private:
   const GlobalCompilationDatabase &CDB;
   /// Whether to keep the built preambles in memory or on disk.
   const bool StorePreambleInMemory;
+  const bool DiagnoseWithStalePreamble;
   /// Callback invoked when preamble or main file AST is built.
   ParsingCallbacks &Callbacks;
   /// Only accessed by the worker thread.
@@ -336,10 +363,13 @@ ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
                   TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
                   Semaphore &Barrier, DebouncePolicy UpdateDebounce,
-                  bool StorePreamblesInMemory, ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks,
-                    UpdateDebounce, StorePreamblesInMemory, Callbacks));
+                  bool StorePreamblesInMemory, bool DiagnoseWithStalePreamble,
+                  ParsingCallbacks &Callbacks,
+                  std::shared_ptr<const PreambleData> Preamble) {
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks, UpdateDebounce,
+      StorePreamblesInMemory, DiagnoseWithStalePreamble, Callbacks,
+      std::move(Preamble)));
   if (Tasks)
     Tasks->runAsync("worker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -350,13 +380,17 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
                      TUScheduler::ASTCache &LRUCache, Semaphore &Barrier,
                      bool RunSync, DebouncePolicy UpdateDebounce,
-                     bool StorePreamblesInMemory, ParsingCallbacks &Callbacks)
+                     bool StorePreamblesInMemory,
+                     bool DiagnoseWithStalePreamble,
+                     ParsingCallbacks &Callbacks,
+                     std::shared_ptr<const PreambleData> Preamble)
     : IdleASTs(LRUCache), RunSync(RunSync), UpdateDebounce(UpdateDebounce),
       FileName(FileName), CDB(CDB),
       StorePreambleInMemory(StorePreamblesInMemory),
+      DiagnoseWithStalePreamble(DiagnoseWithStalePreamble),
       Callbacks(Callbacks), Status{TUAction(TUAction::Idle, ""),
                                    TUStatus::BuildDetails()},
-      Barrier(Barrier), Done(false) {
+      Barrier(Barrier), LastBuiltPreamble(std::move(Preamble)), Done(false) {
   auto Inputs = std::make_shared<ParseInputs>();
   // Set a fallback command because compile command can be accessed before
   // `Inputs` is initialized. Other fields are only used after initialization
@@ -443,14 +477,50 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
     std::shared_ptr<const PreambleData> OldPreamble =
         Inputs.ForceRebuild ? std::shared_ptr<const PreambleData>()
                             : getPossiblyStalePreamble();
-    std::shared_ptr<const PreambleData> NewPreamble = buildPreamble(
-        FileName, *Invocation, OldPreamble, Inputs, StorePreambleInMemory,
-        [this, Version(Inputs.Version)](
-            ASTContext &Ctx, std::shared_ptr<clang::Preprocessor> PP,
-            const CanonicalIncludes &CanonIncludes) {
-          Callbacks.onPreambleAST(FileName, Version, Ctx, std::move(PP),
-                                  CanonIncludes);
-        });
+    // Checking the preamble stats all of its dependencies, so it is done once
+    // for both of the uses below.
+    PreambleReuse Reuse =
+        OldPreamble
+            ? checkPreambleReuse(FileName, *Invocation, Inputs, *OldPreamble)
+            : PreambleReuse::Invalid;
+
+    // Rebuilding a preamble invalidated by header changes may take long.
+    // Publish diagnostics based on the stale preamble first if possible.
+    if (DiagnoseWithStalePreamble && WantDiags != WantDiagnostics::No &&
+        Reuse == PreambleReuse::DependenciesChanged) {
+      vlog("Building AST for {0} version {1} with stale preamble version {2}",
+           FileName, Inputs.Version, OldPreamble->Version);
+      llvm::Optional<ParsedAST> StaleAST =
+          buildAST(FileName, std::make_unique<CompilerInvocation>(*Invocation),
+                   CompilerInvocationDiags, Inputs, OldPreamble);
+      if (StaleAST) {
+        trace::Span Span("Running main AST callback with stale preamble");
+        Callbacks.onMainAST(FileName, *StaleAST, RunPublish);
+      }
+    }
+
+    std::shared_ptr<const PreambleData> NewPreamble;
+    if (Reuse == PreambleReuse::Reusable) {
+      vlog("Reusing preamble version {0} for version {1} of {2}",
+           OldPreamble->Version, Inputs.Version, FileName);
+      NewPreamble = OldPreamble;
+    } else {
+      if (OldPreamble)
+        vlog("Rebuilding invalidated preamble for {0} version {1} "
+             "(previous was version {2})",
+             FileName, Inputs.Version, OldPreamble->Version);
+      else
+        vlog("Building first preamble for {0} verson {1}", FileName,
+             Inputs.Version);
+      NewPreamble = buildPreamble(
+          FileName, *Invocation, Inputs, StorePreambleInMemory,
+          [this, Version(Inputs.Version)](
+              ASTContext &Ctx, std::shared_ptr<clang::Preprocessor> PP,
+              const CanonicalIncludes &CanonIncludes) {
+            Callbacks.onPreambleAST(FileName, Version, Ctx, std::move(PP),
+                                    CanonIncludes);
+          });
+    }
 
     bool CanReuseAST = InputsAreTheSame && (OldPreamble == NewPreamble);
     {
@@ -647,6 +717,10 @@ std::size_t ASTWorker::getUsedBytes() const {
   return Result;
 }
 
+std::size_t ASTWorker::getCachedASTBytes() const {
+  return IdleASTs.getUsedBytes(this);
+}
+
 bool ASTWorker::isASTCached() const { return IdleASTs.getUsedBytes(this) != 0; }
 
 void ASTWorker::stop() {
@@ -899,11 +973,14 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
                          const Options &Opts,
                          std::unique_ptr<ParsingCallbacks> Callbacks)
     : CDB(CDB), StorePreamblesInMemory(Opts.StorePreamblesInMemory),
+      DiagnoseWithStalePreamble(Opts.DiagnoseWithStalePreamble),
       Callbacks(Callbacks ? move(Callbacks)
                           : std::make_unique<ParsingCallbacks>()),
       Barrier(Opts.AsyncThreadsCount),
-      IdleASTs(
-          std::make_unique<ASTCache>(Opts.RetentionPolicy.MaxRetainedASTs)),
+      IdleASTs(std::make_unique<ASTCache>(
+          Opts.RetentionPolicy.MaxRetainedASTs,
+          Opts.RetentionPolicy.MaxRetainedASTBytes)),
+      MaxRetainedPreambles(Opts.RetentionPolicy.MaxRetainedPreambles),
       UpdateDebounce(Opts.UpdateDebounce) {
   if (0 < Opts.AsyncThreadsCount) {
     PreambleTasks.emplace();
@@ -937,11 +1014,22 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
   std::unique_ptr<FileData> &FD = Files[File];
   bool NewFile = FD == nullptr;
   if (!FD) {
+    // If the file was closed recently, give the new worker the preamble we
+    // built for it. It is only reused if it is still up-to-date.
+    std::shared_ptr<const PreambleData> Preamble;
+    auto Closed = llvm::find_if(ClosedPreambles, [&](const auto &P) {
+      return P.first == File;
+    });
+    if (Closed != ClosedPreambles.end()) {
+      Preamble = std::move(Closed->second);
+      ClosedPreambles.erase(Closed);
+    }
     // Create a new worker to process the AST-related tasks.
     ASTWorkerHandle Worker = ASTWorker::create(
         File, CDB, *IdleASTs,
         WorkerThreads ? WorkerThreads.getPointer() : nullptr, Barrier,
-        UpdateDebounce, StorePreamblesInMemory, *Callbacks);
+        UpdateDebounce, StorePreamblesInMemory, DiagnoseWithStalePreamble,
+        *Callbacks, std::move(Preamble));
     FD = std::unique_ptr<FileData>(
         new FileData{Inputs.Contents, std::move(Worker)});
   } else {
@@ -952,10 +1040,21 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
 }
 
 void TUScheduler::remove(PathRef File) {
-  bool Removed = Files.erase(File);
-  if (!Removed)
+  auto It = Files.find(File);
+  if (It == Files.end()) {
     elog("Trying to remove file from TUScheduler that is not tracked: {0}",
          File);
+    return;
+  }
+  if (MaxRetainedPreambles > 0) {
+    if (auto Preamble = It->second->Worker->getPossiblyStalePreamble()) {
+      ClosedPreambles.insert(ClosedPreambles.begin(),
+                             {std::string(File), std::move(Preamble)});
+      if (ClosedPreambles.size() > MaxRetainedPreambles)
+        ClosedPreambles.pop_back();
+    }
+  }
+  Files.erase(It);
 }
 
 llvm::StringMap<std::string> TUScheduler::getAllFileContents() const {
@@ -1067,6 +1166,19 @@ TUScheduler::getUsedBytesPerFile() const {
   return Result;
 }
 
+TUScheduler::MemoryUsage TUScheduler::getMemoryUsage() const {
+  MemoryUsage Result;
+  for (auto &&PathAndFile : Files) {
+    auto &Worker = PathAndFile.second->Worker;
+    Result.ASTs += Worker->getCachedASTBytes();
+    if (auto Preamble = Worker->getPossiblyStalePreamble())
+      Result.Preambles += Preamble->Preamble.getSize();
+  }
+  for (const auto &Closed : ClosedPreambles)
+    Result.Preambles += Closed.second->Preamble.getSize();
+  return Result;
+}
+
 std::vector<Path> TUScheduler::getFilesWithCachedAST() const {
   std::vector<Path> Result;
   for (auto &&PathAndFile : Files) {
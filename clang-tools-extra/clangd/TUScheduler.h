@@ -21,6 +21,8 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include <chrono>
+#include <memory>
+#include <vector>
 
 namespace clang {
 namespace clangd {
@@ -59,6 +61,14 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// Maximum total size in bytes of the retained ASTs, as reported by
+  /// ParsedAST::getUsedBytes(). The most recently used AST is always kept, even
+  /// if it alone exceeds the budget. 0 means no limit.
+  std::size_t MaxRetainedASTBytes = 0;
+  /// Maximum number of preambles of closed files to be retained in memory.
+  /// If a closed file is opened again, its preamble is reused as long as the
+  /// compile command and the headers it includes are unchanged.
+  unsigned MaxRetainedPreambles = 3;
 };
 
 /// Clangd may wait after an update to see if another one comes along.
@@ -185,6 +195,12 @@ public:
 
     /// Determines when to keep idle ASTs in memory for future use.
     ASTRetentionPolicy RetentionPolicy;
+
+    /// If a file's preamble is invalidated only because the headers it
+    /// includes have changed, publish diagnostics from an AST built with the
+    /// stale preamble before rebuilding it. Diagnostics show up sooner while
+    /// headers are being edited, at the cost of an extra AST build.
+    bool DiagnoseWithStalePreamble = false;
   };
 
   TUScheduler(const GlobalCompilationDatabase &CDB, const Options &Opts,
@@ -195,6 +211,14 @@ public:
   /// The order of results is unspecified.
   std::vector<std::pair<Path, std::size_t>> getUsedBytesPerFile() const;
 
+  /// Estimated memory usage of the idle ASTs and the preambles, including the
+  /// preambles retained for closed files.
+  struct MemoryUsage {
+    std::size_t ASTs = 0;
+    std::size_t Preambles = 0;
+  };
+  MemoryUsage getMemoryUsage() const;
+
   /// Returns a list of files with ASTs currently stored in memory. This method
   /// is not very reliable and is only used for test. E.g., the results will not
   /// contain files that currently run something over their AST.
@@ -296,10 +320,16 @@ public:
 private:
   const GlobalCompilationDatabase &CDB;
   const bool StorePreamblesInMemory;
+  const bool DiagnoseWithStalePreamble;
   std::unique_ptr<ParsingCallbacks> Callbacks; // not nullptr
   Semaphore Barrier;
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
+  /// Preambles of recently closed files, sorted in LRU order, i.e. the first
+  /// item is the most recently closed file.
+  std::vector<std::pair<std::string, std::shared_ptr<const PreambleData>>>
+      ClosedPreambles;
+  unsigned MaxRetainedPreambles;
   // None when running tasks synchronously and non-None when running tasks
   // asynchronously.
   llvm::Optional<AsyncTaskRunner> PreambleTasks;
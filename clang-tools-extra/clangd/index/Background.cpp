@@ -208,8 +208,19 @@ BackgroundIndex::indexFileTask(tooling::CompileCommand Cmd) {
 }
 
 void BackgroundIndex::boostRelated(llvm::StringRef Path) {
-  if (isHeaderFile(Path))
-    Queue.boost(filenameWithoutExtension(Path), IndexBoostedFile);
+  if (!isHeaderFile(Path))
+    return;
+  Queue.boost(filenameWithoutExtension(Path), IndexBoostedFile);
+  // Also boost a TU we know includes the header, it may have a different name.
+  std::string DependentTU;
+  {
+    std::lock_guard<std::mutex> Lock(ShardVersionsMu);
+    auto It = DependentTUs.find(Path);
+    if (It != DependentTUs.end())
+      DependentTU = It->getValue();
+  }
+  if (!DependentTU.empty())
+    Queue.boost(filenameWithoutExtension(DependentTU), IndexBoostedFile);
 }
 
 /// Given index results from a TU, only update symbols coming from files that
@@ -329,6 +340,8 @@ void BackgroundIndex::update(
         continue;
       SV.Digest = Hash;
       SV.HadErrors = HadErrors;
+      if (Path != MainFile)
+        DependentTUs[Path] = std::string(MainFile);
 
       // This can override a newer version that is added in another thread, if
       // this thread sees the older version but finishes later. This should be
@@ -449,7 +462,8 @@ BackgroundIndex::loadProject(std::vector<std::string> MainFiles) {
   Rebuilder.startLoading();
   // Load shards for all of the mainfiles.
   const std::vector<LoadedShard> Result =
-      loadIndexShards(MainFiles, IndexStorageFactory, CDB);
+      loadIndexShards(MainFiles, IndexStorageFactory, CDB,
+                      Rebuilder.TUsBeforeFirstBuild);
   size_t LoadedShards = 0;
   {
     // Update in-memory state.
@@ -471,6 +485,8 @@ BackgroundIndex::loadProject(std::vector<std::string> MainFiles) {
       ShardVersion &SV = ShardVersions[LS.AbsolutePath];
       SV.Digest = LS.Digest;
       SV.HadErrors = LS.HadErrors;
+      if (LS.AbsolutePath != LS.DependentTU)
+        DependentTUs[LS.AbsolutePath] = LS.DependentTU;
       ++LoadedShards;
 
       IndexedSymbols.update(LS.AbsolutePath, std::move(SS), std::move(RS),
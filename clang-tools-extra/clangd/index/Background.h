@@ -187,7 +187,10 @@ private:
   FileSymbols IndexedSymbols;
   BackgroundIndexRebuilder Rebuilder;
   llvm::StringMap<ShardVersion> ShardVersions; // Key is absolute file path.
-  std::mutex ShardVersionsMu;
+  // A TU that includes each header that has been loaded or indexed, so that
+  // opening the header can boost indexing of that TU.
+  llvm::StringMap<std::string> DependentTUs; // Key is absolute file path.
+  std::mutex ShardVersionsMu; // Guards ShardVersions and DependentTUs.
 
   BackgroundIndexStorage::Factory IndexStorageFactory;
   // Tries to load shards for the MainFiles and their dependencies.
@@ -10,12 +10,15 @@
 #include "GlobalCompilationDatabase.h"
 #include "Logger.h"
 #include "Path.h"
+#include "Threading.h"
 #include "index/Background.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Path.h"
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,43 +31,80 @@ namespace {
 /// inverse dependency mapping.
 class BackgroundIndexLoader {
 public:
-  BackgroundIndexLoader(BackgroundIndexStorage::Factory &IndexStorageFactory)
-      : IndexStorageFactory(IndexStorageFactory) {}
-  /// Load the shards for \p MainFile and all of its dependencies.
-  void load(PathRef MainFile);
+  BackgroundIndexLoader(BackgroundIndexStorage::Factory &IndexStorageFactory,
+                        unsigned ThreadCount)
+      : IndexStorageFactory(IndexStorageFactory), ThreadCount(ThreadCount) {}
+  /// Load the shards for \p MainFiles and all of their dependencies.
+  void load(llvm::ArrayRef<Path> MainFiles);
 
   /// Consumes the loader and returns all shards.
   std::vector<LoadedShard> takeResult() &&;
 
 private:
-  /// Returns the Shard for \p StartSourceFile from cache or loads it from \p
-  /// Storage. Also returns paths for dependencies of \p StartSourceFile if it
-  /// wasn't cached yet.
-  std::pair<const LoadedShard &, std::vector<Path>>
-  loadShard(PathRef StartSourceFile, PathRef DependentTU);
+  /// A source file whose shard needs to be loaded and the TU it was reached
+  /// from. Both point into the keys of LoadedShards.
+  struct PendingShard {
+    PathRef SourceFile;
+    PathRef DependentTU;
+  };
+
+  /// Reads the shards for \p Pending from storage, using up to ThreadCount
+  /// threads.
+  std::vector<std::unique_ptr<IndexFileIn>>
+  readShards(llvm::ArrayRef<PendingShard> Pending);
+
+  /// Fills in the cache entry for \p P with \p Shard. Returns paths for
+  /// dependencies of \p P.SourceFile.
+  std::vector<Path> addShard(const PendingShard &P,
+                             std::unique_ptr<IndexFileIn> Shard);
 
   /// Cache for Storage lookups.
   llvm::StringMap<LoadedShard> LoadedShards;
 
   BackgroundIndexStorage::Factory &IndexStorageFactory;
+  unsigned ThreadCount;
 };
 
-std::pair<const LoadedShard &, std::vector<Path>>
-BackgroundIndexLoader::loadShard(PathRef StartSourceFile, PathRef DependentTU) {
-  auto It = LoadedShards.try_emplace(StartSourceFile);
-  LoadedShard &LS = It.first->getValue();
+std::vector<std::unique_ptr<IndexFileIn>>
+BackgroundIndexLoader::readShards(llvm::ArrayRef<PendingShard> Pending) {
+  std::vector<std::unique_ptr<IndexFileIn>> Shards(Pending.size());
+  auto ReadShard = [&](size_t I) {
+    BackgroundIndexStorage *Storage =
+        IndexStorageFactory(Pending[I].SourceFile);
+    Shards[I] = Storage->loadShard(Pending[I].SourceFile);
+  };
+  unsigned Workers = std::min<size_t>(ThreadCount, Pending.size());
+  if (Workers <= 1) {
+    for (size_t I = 0; I < Pending.size(); ++I)
+      ReadShard(I);
+    return Shards;
+  }
+
+  // Reading and deserializing shards dominates the load time. Both the storage
+  // factory and the storages are threadsafe, so do that in parallel.
+  std::atomic<size_t> NextShard(0);
+  AsyncTaskRunner Tasks;
+  for (unsigned I = 0; I < Workers; ++I)
+    Tasks.runAsync("shard-loader-" + llvm::Twine(I + 1), [&] {
+      for (size_t J; (J = NextShard++) < Pending.size();)
+        ReadShard(J);
+    });
+  Tasks.wait();
+  return Shards;
+}
+
+std::vector<Path>
+BackgroundIndexLoader::addShard(const PendingShard &P,
+                                std::unique_ptr<IndexFileIn> Shard) {
+  PathRef StartSourceFile = P.SourceFile;
+  LoadedShard &LS = LoadedShards.find(StartSourceFile)->getValue();
   std::vector<Path> Edges = {};
-  // Return the cached shard.
-  if (!It.second)
-    return {LS, Edges};
 
   LS.AbsolutePath = StartSourceFile.str();
-  LS.DependentTU = std::string(DependentTU);
-  BackgroundIndexStorage *Storage = IndexStorageFactory(LS.AbsolutePath);
-  auto Shard = Storage->loadShard(StartSourceFile);
+  LS.DependentTU = std::string(P.DependentTU);
   if (!Shard || !Shard->Sources) {
     vlog("Failed to load shard: {0}", StartSourceFile);
-    return {LS, Edges};
+    return Edges;
   }
 
   LS.Shard = std::move(Shard);
@@ -87,26 +127,31 @@ BackgroundIndexLoader::loadShard(PathRef StartSourceFile, PathRef DependentTU) {
     LS.HadErrors = IGN.Flags & IncludeGraphNode::SourceFlag::HadErrors;
   }
   assert(LS.Digest != FileDigest{{0}} && "Digest is empty?");
-  return {LS, Edges};
+  return Edges;
 }
 
-void BackgroundIndexLoader::load(PathRef MainFile) {
-  llvm::StringSet<> InQueue;
-  // Following containers points to strings inside InQueue.
-  std::queue<PathRef> ToVisit;
-  InQueue.insert(MainFile);
-  ToVisit.push(MainFile);
+void BackgroundIndexLoader::load(llvm::ArrayRef<Path> MainFiles) {
+  // Walk the include graphs of all main files breadth-first, reading all
+  // shards of a level together.
+  std::vector<PendingShard> ToVisit;
+  for (llvm::StringRef MainFile : MainFiles) {
+    assert(llvm::sys::path::is_absolute(MainFile));
+    auto It = LoadedShards.try_emplace(MainFile);
+    if (It.second)
+      ToVisit.push_back({It.first->getKey(), It.first->getKey()});
+  }
 
   while (!ToVisit.empty()) {
-    PathRef SourceFile = ToVisit.front();
-    ToVisit.pop();
-
-    auto ShardAndEdges = loadShard(SourceFile, MainFile);
-    for (PathRef Edge : ShardAndEdges.second) {
-      auto It = InQueue.insert(Edge);
-      if (It.second)
-        ToVisit.push(It.first->getKey());
+    std::vector<std::unique_ptr<IndexFileIn>> Shards = readShards(ToVisit);
+    std::vector<PendingShard> NextLevel;
+    for (size_t I = 0; I < ToVisit.size(); ++I) {
+      for (PathRef Edge : addShard(ToVisit[I], std::move(Shards[I]))) {
+        auto It = LoadedShards.try_emplace(Edge);
+        if (It.second)
+          NextLevel.push_back({It.first->getKey(), ToVisit[I].DependentTU});
+      }
     }
+    ToVisit = std::move(NextLevel);
   }
 }
 
@@ -122,12 +167,10 @@ std::vector<LoadedShard> BackgroundIndexLoader::takeResult() && {
 std::vector<LoadedShard>
 loadIndexShards(llvm::ArrayRef<Path> MainFiles,
                 BackgroundIndexStorage::Factory &IndexStorageFactory,
-                const GlobalCompilationDatabase &CDB) {
-  BackgroundIndexLoader Loader(IndexStorageFactory);
-  for (llvm::StringRef MainFile : MainFiles) {
-    assert(llvm::sys::path::is_absolute(MainFile));
-    Loader.load(MainFile);
-  }
+                const GlobalCompilationDatabase &CDB,
+                unsigned ThreadCount) {
+  BackgroundIndexLoader Loader(IndexStorageFactory, ThreadCount);
+  Loader.load(MainFiles);
   return std::move(Loader).takeResult();
 }
 
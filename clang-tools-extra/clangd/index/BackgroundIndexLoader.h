@@ -42,11 +42,13 @@ struct LoadedShard {
   std::unique_ptr<IndexFileIn> Shard;
 };
 
-/// Loads all shards for the TU \p MainFile from \p Storage.
+/// Loads all shards for the TUs \p MainFiles from \p Storage. Shards are read
+/// from storage on up to \p ThreadCount threads.
 std::vector<LoadedShard>
 loadIndexShards(llvm::ArrayRef<Path> MainFiles,
                 BackgroundIndexStorage::Factory &IndexStorageFactory,
-                const GlobalCompilationDatabase &CDB);
+                const GlobalCompilationDatabase &CDB,
+                unsigned ThreadCount = 1);
 
 } // namespace clangd
 } // namespace clang
@@ -25,10 +25,8 @@ class ChunkIterator : public Iterator {
 public:
   explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
       : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
-    if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
-    }
+    if (!Chunks.empty())
+      loadCurrentChunk();
   }
 
   bool reachedEnd() const override { return CurrentChunk == Chunks.end(); }
@@ -94,21 +92,35 @@ private:
     ++CurrentChunk;
     if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
       return;
-    DecompressedChunk = CurrentChunk->decompress();
-    CurrentID = DecompressedChunk.begin();
+    loadCurrentChunk();
   }
 
   /// Advances CurrentChunk to the chunk which might contain ID.
   void advanceToChunk(DocID ID) {
-    if ((CurrentChunk != Chunks.end() - 1) &&
-        ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
-      --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
+    auto Next = CurrentChunk + 1;
+    if (Next == Chunks.end() || Next->Head > ID)
+      return;
+    // When intersecting posting lists the target is usually close to the
+    // cursor, so gallop forward to find a range containing the last chunk with
+    // Head <= ID before binary searching it.
+    size_t Step = 1;
+    while (Step < static_cast<size_t>(Chunks.end() - Next) &&
+           Next[Step].Head <= ID) {
+      Next += Step;
+      Step *= 2;
     }
+    auto Last =
+        Next + std::min(Step, static_cast<size_t>(Chunks.end() - Next));
+    CurrentChunk =
+        std::partition_point(Next + 1, Last,
+                             [&](const Chunk &C) { return C.Head <= ID; }) -
+        1;
+    loadCurrentChunk();
+  }
+
+  void loadCurrentChunk() {
+    CurrentChunk->decompress(DecompressedChunk);
+    CurrentID = DecompressedChunk.begin();
   }
 
   const Token *Tok;
@@ -182,38 +194,33 @@ std::vector<Chunk> encodeStream(llvm::ArrayRef<DocID> Documents) {
   return std::vector<Chunk>(Result); // no move, shrink-to-fit
 }
 
-/// Reads variable length DocID from the buffer and updates the buffer size. If
-/// the stream is terminated, return None.
-llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
-  if (Bytes.front() == 0 || Bytes.empty())
-    return None;
-  DocID Result = 0;
-  bool HasNextByte = true;
-  for (size_t Length = 0; HasNextByte && !Bytes.empty(); ++Length) {
-    assert(Length <= 5 && "Malformed VByte encoding sequence.");
-    // Write meaningful bits to the correct place in the document decoding.
-    Result |= (Bytes.front() & 0x7f) << (BitsPerEncodingByte * Length);
-    if ((Bytes.front() & 0x80) == 0)
-      HasNextByte = false;
-    Bytes = Bytes.drop_front();
+} // namespace
+
+void Chunk::decompress(llvm::SmallVectorImpl<DocID> &Out) const {
+  Out.clear();
+  Out.push_back(Head);
+  DocID Current = Head;
+  // The payload is terminated by a zero byte or by its end. An encoding never
+  // crosses a chunk boundary.
+  for (size_t I = 0; I < PayloadSize && Payload[I] != 0;) {
+    DocID Delta = 0;
+    for (unsigned Shift = 0;; Shift += BitsPerEncodingByte) {
+      assert(I < PayloadSize && Shift < 32 &&
+             "Malformed VByte encoding sequence.");
+      uint8_t Byte = Payload[I++];
+      Delta |= static_cast<DocID>(Byte & 0x7f) << Shift;
+      if ((Byte & 0x80) == 0)
+        break;
+    }
+    Current += Delta;
+    Out.push_back(Current);
   }
-  return Result;
 }
 
-} // namespace
-
 llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
-  llvm::ArrayRef<uint8_t> Bytes(Payload);
-  DocID Delta;
-  for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
-    auto MaybeDelta = readVByte(Bytes);
-    if (!MaybeDelta)
-      break;
-    Delta = *MaybeDelta;
-    Result.push_back(Current + Delta);
-  }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
+  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result;
+  decompress(Result);
+  return Result;
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
@@ -290,6 +290,15 @@ opt<bool> RecoveryAST{
     Hidden,
 };
 
+opt<bool> DiagnoseWithStalePreamble{
+    "diagnose-with-stale-preamble",
+    cat(Features),
+    desc("Publish diagnostics built on the previous preamble while the "
+         "preamble is rebuilt after changes to included headers"),
+    init(false),
+    Hidden,
+};
+
 opt<unsigned> WorkerThreadsCount{
     "j",
     cat(Misc),
@@ -298,6 +307,14 @@ opt<unsigned> WorkerThreadsCount{
     init(getDefaultAsyncThreadsCount()),
 };
 
+opt<unsigned> RetainedASTMemoryMB{
+    "retained-ast-memory",
+    cat(Misc),
+    desc("Maximum memory in megabytes used by the ASTs of files that are not "
+         "being processed. 0 means no limit"),
+    init(0),
+};
+
 opt<Path> IndexFile{
     "index-file",
     cat(Misc),
@@ -638,7 +655,10 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
   }
   Opts.StaticIndex = StaticIdx.get();
   Opts.AsyncThreadsCount = WorkerThreadsCount;
+  Opts.RetentionPolicy.MaxRetainedASTBytes =
+      std::size_t(RetainedASTMemoryMB) * 1024 * 1024;
   Opts.BuildRecoveryAST = RecoveryAST;
+  Opts.DiagnoseWithStalePreamble = DiagnoseWithStalePreamble;
 
   clangd::CodeCompleteOptions CCOpts;
   CCOpts.IncludeIneligibleResults = IncludeIneligibleResults;
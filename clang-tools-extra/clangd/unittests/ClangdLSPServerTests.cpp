@@ -0,0 +1,68 @@
+//===-- ClangdLSPServerTests.cpp ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "ClangdLSPServer.h"
+#include "CodeComplete.h"
+#include "TestFS.h"
+#include "Transport.h"
+#include "refactor/Rename.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+
+namespace clang {
+namespace clangd {
+namespace {
+
+using ::testing::HasSubstr;
+
+// No fmemopen on windows or on versions of MacOS X earlier than 10.13, so we
+// can't easily run this test.
+#if !(defined(_WIN32) || (defined(__MAC_OS_X_VERSION_MIN_REQUIRED) &&          \
+                          __MAC_OS_X_VERSION_MIN_REQUIRED < 101300))
+
+// Runs a server on the given delimited input and returns what it wrote.
+std::string runServer(std::string Input) {
+  std::string OutBuf;
+  llvm::raw_string_ostream Out(OutBuf);
+  std::unique_ptr<FILE, int (*)(FILE *)> In = {
+      fmemopen(&Input[0], Input.size(), "r"), &fclose};
+  auto Transp = newJSONTransport(In.get(), Out, /*InMirror=*/nullptr,
+                                 /*Pretty=*/false, JSONStreamStyle::Delimited);
+  MockFSProvider FS;
+  ClangdLSPServer Server(*Transp, FS, CodeCompleteOptions(), RenameOptions(),
+                         /*CompileCommandsDir=*/llvm::None,
+                         /*UseDirBasedCDB=*/false,
+                         /*ForcedOffsetEncoding=*/llvm::None,
+                         ClangdServer::optsForTest());
+  EXPECT_TRUE(Server.run());
+  return Out.str();
+}
+
+TEST(ClangdLSPServerTest, LatencyHistogram) {
+  // The reply to $/latencyHistogram records its own latency, which must not
+  // deadlock, and the histogram includes the earlier initialize request.
+  std::string Output = runServer(R"(
+{"jsonrpc": "2.0", "id": 0, "method": "initialize", "params": {"capabilities": {}}}
+---
+{"jsonrpc": "2.0", "id": 1, "method": "$/latencyHistogram", "params": null}
+---
+{"jsonrpc": "2.0", "id": 2, "method": "shutdown", "params": null}
+---
+{"jsonrpc": "2.0", "method": "exit", "params": null}
+)");
+  EXPECT_THAT(Output,
+              HasSubstr(R"({"id":1,"jsonrpc":"2.0","result":{"initialize":{)"));
+  EXPECT_THAT(Output, HasSubstr(R"("count":1)"));
+}
+
+#endif
+
+} // namespace
+} // namespace clangd
+} // namespace clang
@@ -25,6 +25,7 @@
 
 using ::testing::AnyOf;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::IsEmpty;
 using ::testing::UnorderedElementsAre;
 
@@ -68,6 +69,28 @@ TEST(DexIterators, DocumentIterator) {
   EXPECT_TRUE(DocIterator->reachedEnd());
 }
 
+TEST(DexIterators, DocumentIteratorManyChunks) {
+  // Large gaps between DocIDs make every chunk hold only a few of them.
+  std::vector<DocID> IDs;
+  for (DocID I = 0; I < 1000; ++I)
+    IDs.push_back(I * 100000);
+  const PostingList L(IDs);
+  auto DocIterator = L.iterator();
+
+  // Targets at, between and just past chunk heads, near and far apart.
+  for (DocID Target : {100000U, 100001U, 500000U, 25000000U, 25000000U,
+                       25099999U, 99900000U}) {
+    DocIterator->advanceTo(Target);
+    ASSERT_FALSE(DocIterator->reachedEnd());
+    EXPECT_EQ(DocIterator->peek(), *llvm::lower_bound(IDs, Target));
+  }
+  DocIterator->advanceTo(99900001);
+  EXPECT_TRUE(DocIterator->reachedEnd());
+
+  DocIterator = L.iterator();
+  EXPECT_THAT(consumeIDs(*DocIterator), ElementsAreArray(IDs));
+}
+
 TEST(DexIterators, AndTwoLists) {
   Corpus C{10000};
   const PostingList L0({0, 5, 7, 10, 42, 320, 9000});
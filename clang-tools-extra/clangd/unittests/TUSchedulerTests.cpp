@@ -25,6 +25,7 @@
 #include "gtest/gtest.h"
 #include <algorithm>
 #include <chrono>
+#include <mutex>
 #include <utility>
 
 namespace clang {
@@ -599,6 +600,33 @@ TEST_F(TUSchedulerTests, EvictedAST) {
               UnorderedElementsAre(Foo, AnyOf(Bar, Baz)));
 }
 
+TEST_F(TUSchedulerTests, EvictedASTByMemory) {
+  auto Opts = optsForTest();
+  Opts.AsyncThreadsCount = 1;
+  Opts.RetentionPolicy.MaxRetainedASTs = 3;
+  // Any AST is bigger than this, so only the most recent one is retained.
+  Opts.RetentionPolicy.MaxRetainedASTBytes = 1;
+  TUScheduler S(CDB, Opts);
+
+  llvm::StringLiteral SourceContents = R"cpp(
+    int* a;
+    double* b = a;
+  )cpp";
+
+  auto Foo = testPath("foo.cpp");
+  auto Bar = testPath("bar.cpp");
+
+  S.update(Foo, getInputs(Foo, std::string(SourceContents)),
+           WantDiagnostics::Yes);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_THAT(S.getFilesWithCachedAST(), ElementsAre(Foo));
+
+  S.update(Bar, getInputs(Bar, std::string(SourceContents)),
+           WantDiagnostics::Yes);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_THAT(S.getFilesWithCachedAST(), ElementsAre(Bar));
+}
+
 TEST_F(TUSchedulerTests, EmptyPreamble) {
   TUScheduler S(CDB, optsForTest());
 
@@ -764,6 +792,121 @@ TEST_F(TUSchedulerTests, ForceRebuild) {
 
   ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
 }
+
+TEST_F(TUSchedulerTests, DiagnoseWithStalePreamble) {
+  auto Opts = optsForTest();
+  Opts.DiagnoseWithStalePreamble = true;
+  TUScheduler S(CDB, Opts, captureDiags());
+
+  auto Source = testPath("foo.cpp");
+  auto Header = testPath("foo.h");
+  Files[Header] = "int a;";
+  Timestamps[Header] = time_t(0);
+  auto SourceContents = R"cpp(
+      #include "foo.h"
+      int b = a;
+    )cpp";
+
+  // Returns the messages of each set of diagnostics published for the update.
+  auto DoUpdate = [&](std::string Contents) {
+    std::mutex Mutex;
+    std::vector<std::vector<std::string>> Published;
+    updateWithDiags(S, Source, Contents, WantDiagnostics::Yes,
+                    [&](std::vector<Diag> Diags) {
+                      std::vector<std::string> Messages;
+                      for (const Diag &D : Diags)
+                        Messages.push_back(D.Message);
+                      std::lock_guard<std::mutex> Lock(Mutex);
+                      Published.push_back(std::move(Messages));
+                    });
+    EXPECT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    return Published;
+  };
+  using Messages = std::vector<std::string>;
+
+  EXPECT_THAT(DoUpdate(SourceContents), ElementsAre(IsEmpty()));
+
+  // The header changed, so the diagnostics of the stale preamble come first,
+  // then the ones of the rebuilt preamble.
+  Files[Header] = "int c;";
+  Timestamps[Header] = time_t(1);
+  EXPECT_THAT(DoUpdate(SourceContents),
+              ElementsAre(IsEmpty(),
+                          Messages{"use of undeclared identifier 'a'"}));
+
+  // A change after the preamble doesn't invalidate it.
+  EXPECT_THAT(DoUpdate(std::string(SourceContents) + "int d = c;"),
+              ElementsAre(Messages{"use of undeclared identifier 'a'"}));
+
+  // A change of the preamble section invalidates it, and the old preamble is
+  // not used for diagnostics.
+  Files[testPath("bar.h")] = "int a;";
+  Timestamps[testPath("bar.h")] = time_t(0);
+  EXPECT_THAT(DoUpdate(R"cpp(
+      #include "bar.h"
+      int b = a;
+    )cpp"),
+              ElementsAre(IsEmpty()));
+}
+
+TEST_F(TUSchedulerTests, ReusePreambleOfClosedFile) {
+  class CountPreambles : public ParsingCallbacks {
+  public:
+    void onPreambleAST(PathRef Path, llvm::StringRef Version, ASTContext &Ctx,
+                       std::shared_ptr<clang::Preprocessor> PP,
+                       const CanonicalIncludes &) override {
+      ++Builds;
+    }
+    std::atomic<int> Builds{0};
+  };
+
+  auto Source = testPath("foo.cpp");
+  Files[testPath("foo.h")] = "int a;";
+  const char *SourceContents = R"cpp(
+      #include "foo.h"
+      int b = a;
+    )cpp";
+
+  for (unsigned MaxRetainedPreambles : {0u, 1u}) {
+    auto Opts = optsForTest();
+    Opts.RetentionPolicy.MaxRetainedPreambles = MaxRetainedPreambles;
+    auto Callbacks = std::make_unique<CountPreambles>();
+    auto &Builds = Callbacks->Builds;
+    TUScheduler S(CDB, Opts, std::move(Callbacks));
+
+    S.update(Source, getInputs(Source, SourceContents), WantDiagnostics::Yes);
+    ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    EXPECT_EQ(1, Builds.load());
+
+    // Reopening the file rebuilds the preamble only if it wasn't retained.
+    S.remove(Source);
+    S.update(Source, getInputs(Source, SourceContents), WantDiagnostics::Yes);
+    ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    EXPECT_EQ(MaxRetainedPreambles ? 1 : 2, Builds.load());
+  }
+}
+
+TEST_F(TUSchedulerTests, MemoryUsage) {
+  auto Opts = optsForTest();
+  Opts.RetentionPolicy.MaxRetainedPreambles = 1;
+  TUScheduler S(CDB, Opts);
+
+  auto Source = testPath("foo.cpp");
+  Files[testPath("foo.h")] = "int a;";
+  S.update(Source, getInputs(Source, "#include \"foo.h\"\nint b = a;"),
+           WantDiagnostics::Yes);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  TUScheduler::MemoryUsage Usage = S.getMemoryUsage();
+  EXPECT_GT(Usage.ASTs, 0u);
+  EXPECT_GT(Usage.Preambles, 0u);
+
+  // The preamble of the closed file is retained, its AST is not.
+  S.remove(Source);
+  Usage = S.getMemoryUsage();
+  EXPECT_EQ(Usage.ASTs, 0u);
+  EXPECT_GT(Usage.Preambles, 0u);
+}
+
 TEST_F(TUSchedulerTests, NoChangeDiags) {
   TUScheduler S(CDB, optsForTest(), captureDiags());
 
@@ -46,9 +46,12 @@ public:
   /// mismatching size of the file. If file is not minimized, the full file is
   /// read and copied into memory to ensure that it's not memory mapped to avoid
   /// running out of file descriptors.
-  static CachedFileSystemEntry createFileEntry(StringRef Filename,
-                                               llvm::vfs::FileSystem &FS,
-                                               bool Minimize = true);
+  ///
+  /// If \p PersistentCachePath is not empty, minimized contents are looked up
+  /// in and added to the on-disk cache in that directory.
+  static CachedFileSystemEntry
+  createFileEntry(StringRef Filename, llvm::vfs::FileSystem &FS,
+                  bool Minimize = true, StringRef PersistentCachePath = "");
 
   /// Create an entry that represents a directory on the filesystem.
   static CachedFileSystemEntry createDirectoryEntry(llvm::vfs::Status &&Stat);
@@ -114,7 +117,9 @@ public:
     CachedFileSystemEntry Value;
   };
 
-  DependencyScanningFilesystemSharedCache();
+  /// \param PersistentCachePath The directory of the on-disk minimized source
+  /// cache that outlives this cache, or empty to disable it.
+  DependencyScanningFilesystemSharedCache(StringRef PersistentCachePath = "");
 
   /// Returns a cache entry for the corresponding key.
   ///
@@ -122,6 +127,8 @@ public:
   /// thread safe call.
   SharedFileSystemEntry &get(StringRef Key);
 
+  StringRef getPersistentCachePath() const { return PersistentCachePath; }
+
 private:
   struct CacheShard {
     std::mutex CacheLock;
@@ -129,6 +136,7 @@ private:
   };
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
+  std::string PersistentCachePath;
 };
 
 /// A virtual file system optimized for the dependency discovery.
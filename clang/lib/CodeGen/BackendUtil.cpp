@@ -44,6 +44,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/Telemetry.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -81,6 +82,10 @@
 using namespace clang;
 using namespace llvm;
 
+#define DEBUG_TYPE "clang"
+
+TELEMETRY_COUNTER(BackendTime, "Time spent in the LLVM backend (ns)");
+
 #define HANDLE_EXTENSION(Ext)                                                  \
   llvm::PassPluginLibraryInfo get##Ext##PluginInfo();
 #include "llvm/Support/Extension.def"
@@ -1580,6 +1585,7 @@ void clang::EmitBackendOutput(DiagnosticsEngine &Diags,
                               std::unique_ptr<raw_pwrite_stream> OS) {
 
   llvm::TimeTraceScope TimeScope("Backend");
+  llvm::TelemetryTimeRegion TelemetryRegion(BackendTime);
 
   std::unique_ptr<llvm::Module> EmptyModule;
   if (!CGOpts.ThinLTOIndexFile.empty()) {
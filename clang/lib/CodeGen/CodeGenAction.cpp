@@ -340,8 +340,10 @@ namespace clang {
 
       Ctx.setDiagnosticHandler(std::move(OldDiagnosticHandler));
 
-      if (OptRecordFile)
+      if (OptRecordFile) {
+        finalizeLLVMOptimizationRemarks(Ctx);
         OptRecordFile->keep();
+      }
     }
 
     void HandleTagDeclDefinition(TagDecl *D) override {
@@ -1170,8 +1172,10 @@ void CodeGenAction::ExecuteAction() {
                       CI.getTarget().getDataLayout(), TheModule.get(), BA,
                       std::move(OS));
 
-    if (OptRecordFile)
+    if (OptRecordFile) {
+      finalizeLLVMOptimizationRemarks(Ctx);
       OptRecordFile->keep();
+    }
     return;
   }
 
@@ -3391,6 +3391,11 @@ static void RenderModulesOptions(Compilation &C, const Driver &D,
                     options::OPT_fmodules_validate_once_per_build_session);
   }
 
+  if (!Args.hasFlag(options::OPT_fmodules_force_validate_user_headers,
+                    options::OPT_fno_modules_force_validate_user_headers,
+                    true))
+    CmdArgs.push_back("-fno-modules-force-validate-user-headers");
+
   if (Args.hasFlag(options::OPT_fmodules_validate_system_headers,
                    options::OPT_fno_modules_validate_system_headers,
                    ImplicitModules))
@@ -22,12 +22,17 @@
 #include "clang/Sema/SemaConsumer.h"
 #include "clang/Sema/TemplateInstCallback.h"
 #include "llvm/Support/CrashRecoveryContext.h"
+#include "llvm/Support/Telemetry.h"
 #include "llvm/Support/TimeProfiler.h"
 #include <cstdio>
 #include <memory>
 
 using namespace clang;
 
+#define DEBUG_TYPE "clang"
+
+TELEMETRY_COUNTER(FrontendTime, "Time spent parsing the main file (ns)");
+
 namespace {
 
 /// Resets LLVM's pretty stack state so that stack traces are printed correctly
@@ -152,6 +157,7 @@ void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies) {
 
   if (HaveLexer) {
     llvm::TimeTraceScope TimeScope("Frontend");
+    llvm::TelemetryTimeRegion TelemetryRegion(FrontendTime);
     P.Initialize();
     Parser::DeclGroupPtrTy ADecl;
     for (bool AtEOF = P.ParseFirstTopLevelDecl(ADecl); !AtEOF;
@@ -2623,14 +2623,21 @@ ASTReader::ReadControlBlock(ModuleFile &F,
 
         // If we are reading a module, we will create a verification timestamp,
         // so we verify all input files.  Otherwise, verify only user input
-        // files.
+        // files, unless we were told not to for modules that were already
+        // verified during this build session.
 
+        bool ValidatedThisSession =
+            HSOpts.ModulesValidateOncePerBuildSession &&
+            F.InputFilesValidationTimestamp > HSOpts.BuildSessionTimestamp &&
+            F.Kind == MK_ImplicitModule;
         unsigned N = NumUserInputs;
         if (ValidateSystemInputs ||
             (HSOpts.ModulesValidateOncePerBuildSession &&
-             F.InputFilesValidationTimestamp <= HSOpts.BuildSessionTimestamp &&
-             F.Kind == MK_ImplicitModule))
+             !ValidatedThisSession && F.Kind == MK_ImplicitModule))
           N = NumInputs;
+        else if (ValidatedThisSession &&
+                 !HSOpts.ModulesForceValidateUserHeaders)
+          N = 0;
 
         for (unsigned I = 0; I < N; ++I) {
           InputFile IF = getInputFile(F, I+1, Complain);
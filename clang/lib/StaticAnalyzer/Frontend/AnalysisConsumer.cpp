@@ -59,6 +59,10 @@ STATISTIC(NumVisitedBlocksInAnalyzedFunctions,
           "The # of visited basic blocks in the analyzed functions.");
 STATISTIC(PercentReachableBlocks, "The % of reachable basic blocks.");
 STATISTIC(MaxCFGSize, "The maximum number of basic blocks in a function.");
+STATISTIC(NumExplodedGraphNodes,
+          "The # of exploded graph nodes left in the analyzed functions.");
+STATISTIC(MaxExplodedGraphSize,
+          "The maximum number of exploded graph nodes in a function.");
 
 //===----------------------------------------------------------------------===//
 // AnalysisConsumer declaration.
@@ -703,6 +707,9 @@ void AnalysisConsumer::RunPathSensitiveChecks(Decl *D,
   if (ExprEngineTimer)
     ExprEngineTimer->stopTimer();
 
+  NumExplodedGraphNodes += Eng.getGraph().size();
+  MaxExplodedGraphSize.updateMax(Eng.getGraph().size());
+
   if (!Mgr->options.DumpExplodedGraphTo.empty())
     Eng.DumpGraph(Mgr->options.TrimGraph, Mgr->options.DumpExplodedGraphTo);
 
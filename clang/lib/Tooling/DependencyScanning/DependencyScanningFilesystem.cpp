@@ -8,15 +8,134 @@
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 #include "clang/Lex/DependencyDirectivesSourceMinimizer.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/Threading.h"
 
 using namespace clang;
 using namespace tooling;
 using namespace dependencies;
 
+/// Minimizes \p Source and computes the skipped PP ranges that speedup skipping
+/// over inactive preprocessor blocks.
+///
+/// \returns True on error.
+static bool minimizeFile(StringRef Source,
+                         llvm::SmallString<1024> &MinimizedFileContents,
+                         PreprocessorSkippedRangeMapping &Mapping) {
+  SmallVector<minimize_source_to_dependency_directives::Token, 64> Tokens;
+  if (minimizeSourceToDependencyDirectives(Source, MinimizedFileContents,
+                                           Tokens))
+    return true;
+
+  llvm::SmallVector<minimize_source_to_dependency_directives::SkippedRange, 32>
+      SkippedRanges;
+  minimize_source_to_dependency_directives::computeSkippedRanges(Tokens,
+                                                                 SkippedRanges);
+  for (const auto &Range : SkippedRanges) {
+    if (Range.Length < 16) {
+      // Ignore small ranges as non-profitable.
+      // FIXME: This is a heuristic, its worth investigating the tradeoffs
+      // when it should be applied.
+      continue;
+    }
+    Mapping[Range.Offset] = Range.Length;
+  }
+  return false;
+}
+
+/// Entries of the persistent minimized source cache start with this string.
+/// Bump the version whenever the minimizer output or the layout changes.
+static constexpr llvm::StringLiteral PersistentEntryMagic = "CSDMIN01";
+
+/// The persistent cache is content addressed: an entry is named after the hash
+/// of the original file contents, so it never needs to be invalidated.
+static std::string getPersistentEntryPath(StringRef CachePath,
+                                          StringRef Source) {
+  llvm::SmallString<256> Path(CachePath);
+  llvm::sys::path::append(
+      Path, llvm::toHex(llvm::SHA1::hash(llvm::arrayRefFromStringRef(Source)),
+                        /*LowerCase=*/true));
+  return std::string(Path.str());
+}
+
+/// An entry consists of the magic string, the number of skipped ranges, the
+/// offset and length of each skipped range as 32-bit little-endian integers
+/// and finally the minimized contents.
+///
+/// \returns True if the entry was read successfully.
+static bool readPersistentEntry(StringRef EntryPath,
+                                llvm::SmallString<1024> &MinimizedFileContents,
+                                PreprocessorSkippedRangeMapping &Mapping) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> MaybeBuffer =
+      llvm::MemoryBuffer::getFile(EntryPath);
+  if (!MaybeBuffer)
+    return false;
+
+  using namespace llvm::support::endian;
+  StringRef Data = (*MaybeBuffer)->getBuffer();
+  if (!Data.consume_front(PersistentEntryMagic) || Data.size() < 4)
+    return false;
+  uint32_t NumRanges = read32le(Data.data());
+  Data = Data.drop_front(4);
+  if (Data.size() < uint64_t(NumRanges) * 8)
+    return false;
+  for (uint32_t I = 0; I != NumRanges; ++I)
+    Mapping[read32le(Data.data() + I * 8)] = read32le(Data.data() + I * 8 + 4);
+  Data = Data.drop_front(uint64_t(NumRanges) * 8);
+
+  MinimizedFileContents.assign(Data.begin(), Data.end());
+  // Implicitly null terminate the contents, like the minimizer does.
+  MinimizedFileContents.push_back('\0');
+  MinimizedFileContents.pop_back();
+  return true;
+}
+
+/// Writes an entry to the persistent cache. Errors are ignored, the entry is
+/// simply recomputed by the next run.
+static void
+writePersistentEntry(StringRef CachePath, StringRef EntryPath,
+                     StringRef MinimizedFileContents,
+                     const PreprocessorSkippedRangeMapping &Mapping) {
+  if (llvm::sys::fs::create_directories(CachePath))
+    return;
+
+  // Write to a temporary file and rename it, so that concurrent scans never
+  // see a partially written entry. Racing writers produce the same contents,
+  // it doesn't matter which one wins.
+  int FD;
+  llvm::SmallString<256> TempPath;
+  if (llvm::sys::fs::createUniqueFile(EntryPath + "-%%%%%%%%.tmp", FD,
+                                      TempPath))
+    return;
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    llvm::support::endian::Writer W(OS, llvm::support::little);
+    OS << PersistentEntryMagic;
+    W.write<uint32_t>(Mapping.size());
+    for (const auto &Range : Mapping) {
+      W.write<uint32_t>(Range.first);
+      W.write<uint32_t>(Range.second);
+    }
+    OS << MinimizedFileContents;
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(TempPath, EntryPath))
+    llvm::sys::fs::remove(TempPath);
+}
+
 CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
-    StringRef Filename, llvm::vfs::FileSystem &FS, bool Minimize) {
+    StringRef Filename, llvm::vfs::FileSystem &FS, bool Minimize,
+    StringRef PersistentCachePath) {
   // Load the file and its content from the file system.
   llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> MaybeFile =
       FS.openFileForRead(Filename);
@@ -33,11 +152,19 @@ CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
     return MaybeBuffer.getError();
 
   llvm::SmallString<1024> MinimizedFileContents;
-  // Minimize the file down to directives that might affect the dependencies.
+  PreprocessorSkippedRangeMapping Mapping;
   const auto &Buffer = *MaybeBuffer;
-  SmallVector<minimize_source_to_dependency_directives::Token, 64> Tokens;
-  if (!Minimize || minimizeSourceToDependencyDirectives(
-                       Buffer->getBuffer(), MinimizedFileContents, Tokens)) {
+  std::string EntryPath;
+  if (Minimize && !PersistentCachePath.empty())
+    EntryPath =
+        getPersistentEntryPath(PersistentCachePath, Buffer->getBuffer());
+  bool IsPersistent =
+      !EntryPath.empty() &&
+      readPersistentEntry(EntryPath, MinimizedFileContents, Mapping);
+  // Minimize the file down to directives that might affect the dependencies.
+  if (!IsPersistent &&
+      (!Minimize ||
+       minimizeFile(Buffer->getBuffer(), MinimizedFileContents, Mapping))) {
     // Use the original file unless requested otherwise, or
     // if the minimization failed.
     // FIXME: Propage the diagnostic if desired by the client.
@@ -51,6 +178,10 @@ CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
     return Result;
   }
 
+  if (!IsPersistent && !EntryPath.empty())
+    writePersistentEntry(PersistentCachePath, EntryPath, MinimizedFileContents,
+                         Mapping);
+
   CachedFileSystemEntry Result;
   size_t Size = MinimizedFileContents.size();
   Result.MaybeStat = llvm::vfs::Status(Stat->getName(), Stat->getUniqueID(),
@@ -70,22 +201,6 @@ CachedFileSystemEntry CachedFileSystemEntry::createFileEntry(
   // it right where the buffer ends.
   Result.Contents.pop_back();
 
-  // Compute the skipped PP ranges that speedup skipping over inactive
-  // preprocessor blocks.
-  llvm::SmallVector<minimize_source_to_dependency_directives::SkippedRange, 32>
-      SkippedRanges;
-  minimize_source_to_dependency_directives::computeSkippedRanges(Tokens,
-                                                                 SkippedRanges);
-  PreprocessorSkippedRangeMapping Mapping;
-  for (const auto &Range : SkippedRanges) {
-    if (Range.Length < 16) {
-      // Ignore small ranges as non-profitable.
-      // FIXME: This is a heuristic, its worth investigating the tradeoffs
-      // when it should be applied.
-      continue;
-    }
-    Mapping[Range.Offset] = Range.Length;
-  }
   Result.PPSkippedRangeMapping = std::move(Mapping);
 
   return Result;
@@ -100,7 +215,8 @@ CachedFileSystemEntry::createDirectoryEntry(llvm::vfs::Status &&Stat) {
 }
 
 DependencyScanningFilesystemSharedCache::
-    DependencyScanningFilesystemSharedCache() {
+    DependencyScanningFilesystemSharedCache(StringRef PersistentCachePath)
+    : PersistentCachePath(PersistentCachePath) {
   // This heuristic was chosen using a empirical testing on a
   // reasonably high core machine (iMacPro 18 cores / 36 threads). The cache
   // sharding gives a performance edge by reducing the lock contention.
@@ -185,7 +301,8 @@ DependencyScanningWorkerFilesystem::getOrCreateFileSystemEntry(
             std::move(*MaybeStatus));
       else
         CacheEntry = CachedFileSystemEntry::createFileEntry(
-            Filename, FS, !KeepOriginalSource);
+            Filename, FS, !KeepOriginalSource,
+            SharedCache.getPersistentCachePath());
     }
 
     Result = &CacheEntry;
@@ -0,0 +1,15 @@
+// RUN: %clangxx -S -ftime-trace -ftime-trace-granularity=0 -o %T/check-time-trace-constexpr %s
+// RUN: cat %T/check-time-trace-constexpr.json \
+// RUN:   | %python -c 'import json, sys; json.dump(json.loads(sys.stdin.read()), sys.stdout, sort_keys=True, indent=2)' \
+// RUN:   | FileCheck %s
+
+// CHECK-DAG: "detail": "Value"
+// CHECK-DAG: "name": "EvaluateAsInitializer"
+// CHECK-DAG: "detail": "fib"
+// CHECK-DAG: "name": "EvaluateCall"
+
+constexpr int fib(int N) { return N < 2 ? N : fib(N - 1) + fib(N - 2); }
+
+constexpr int Value = fib(10);
+
+int main() { return Value; }
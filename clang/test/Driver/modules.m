@@ -39,6 +39,12 @@
 // RUN: %clang -fno-modules-validate-system-headers -### %s 2>&1 | FileCheck -check-prefix=MODULES_VALIDATE_SYSTEM_HEADERS_NOSYSVALID %s
 // MODULES_VALIDATE_SYSTEM_HEADERS_NOSYSVALID-NOT: -fmodules-validate-system-headers
 
+// RUN: %clang -### %s 2>&1 | FileCheck -check-prefix=MODULES_FORCE_VALIDATE_USER_HEADERS_DEFAULT %s
+// MODULES_FORCE_VALIDATE_USER_HEADERS_DEFAULT-NOT: -fno-modules-force-validate-user-headers
+
+// RUN: %clang -fno-modules-force-validate-user-headers -### %s 2>&1 | FileCheck -check-prefix=MODULES_NO_FORCE_VALIDATE_USER_HEADERS %s
+// MODULES_NO_FORCE_VALIDATE_USER_HEADERS: -fno-modules-force-validate-user-headers
+
 // RUN: %clang -### %s 2>&1 | FileCheck -check-prefix=MODULES_DISABLE_DIAGNOSTIC_VALIDATION_DEFAULT %s
 // MODULES_DISABLE_DIAGNOSTIC_VALIDATION_DEFAULT-NOT: -fmodules-disable-diagnostic-validation
 
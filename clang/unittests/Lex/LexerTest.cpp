@@ -539,6 +539,18 @@ TEST_F(LexerTest, CharRangeOffByOne) {
   EXPECT_EQ(Lexer::getSourceText(CR, SourceMgr, LangOpts), "MOO"); // Was "MO".
 }
 
+TEST_F(LexerTest, LongLineComments) {
+  std::vector<Token> toks =
+      CheckLex("int a; // a line comment much longer than sixteen bytes\n"
+               "int b; // continued over an escaped newline into the \\\n"
+               "next line, which is still part of the same comment\n"
+               "int c; // ends at the end of the buffer without a newline",
+               {tok::kw_int, tok::identifier, tok::semi, tok::kw_int,
+                tok::identifier, tok::semi, tok::kw_int, tok::identifier,
+                tok::semi});
+  EXPECT_EQ(getSourceText(toks[7], toks[7]), "c");
+}
+
 TEST_F(LexerTest, FindNextToken) {
   Lex("int abcd = 0;\n"
       "int xyz = abcd;\n");
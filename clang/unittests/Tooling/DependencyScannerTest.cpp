@@ -14,8 +14,10 @@
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
@@ -203,5 +205,38 @@ TEST(DependencyScanner, ScanDepsReuseFilemanagerHasInclude) {
   EXPECT_EQ(convert_to_slash(Deps[5]), "/root/symlink.h");
 }
 
+TEST(DependencyScanner, PersistentMinimizedSourceCache) {
+  using dependencies::CachedFileSystemEntry;
+  llvm::SmallString<128> CacheDir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("scan-deps-cache", CacheDir));
+
+  llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> VFS =
+      new llvm::vfs::InMemoryFileSystem();
+  VFS->addFile("/root/header.h", 0,
+               llvm::MemoryBuffer::getMemBuffer(
+                   "#pragma once\nint x;\n#include \"other.h\"\n"));
+
+  CachedFileSystemEntry First = CachedFileSystemEntry::createFileEntry(
+      "/root/header.h", *VFS, /*Minimize=*/true, CacheDir);
+  ASSERT_TRUE(First.getContents());
+
+  std::error_code EC;
+  unsigned NumEntries = 0;
+  for (llvm::sys::fs::directory_iterator I(CacheDir, EC), E; I != E && !EC;
+       I.increment(EC))
+    ++NumEntries;
+  EXPECT_EQ(NumEntries, 1u);
+
+  CachedFileSystemEntry Second = CachedFileSystemEntry::createFileEntry(
+      "/root/header.h", *VFS, /*Minimize=*/true, CacheDir);
+  ASSERT_TRUE(Second.getContents());
+  EXPECT_EQ(*Second.getContents(), *First.getContents());
+  EXPECT_EQ(*Second.getContents(), "#pragma once\n#include \"other.h\"\n");
+  EXPECT_EQ(Second.getStatus()->getSize(), First.getStatus()->getSize());
+
+  llvm::sys::fs::remove_directories(CacheDir);
+}
+
 } // end namespace tooling
 } // end namespace clang
@@ -523,7 +523,8 @@ struct Allocator {
     }
     m->user_requested_alignment_log = user_requested_alignment_log;
 
-    m->alloc_context_id = StackDepotPut(*stack);
+    m->alloc_context_id = t ? t->malloc_storage().alloc_stack_cache.Put(*stack)
+                            : StackDepotPut(*stack);
 
     uptr size_rounded_down_to_granularity =
         RoundDownTo(size, SHADOW_GRANULARITY);
@@ -587,7 +588,8 @@ struct Allocator {
       CHECK_EQ(m->free_tid, kInvalidTid);
     AsanThread *t = GetCurrentThread();
     m->free_tid = t ? t->tid() : 0;
-    m->free_context_id = StackDepotPut(*stack);
+    m->free_context_id = t ? t->malloc_storage().free_stack_cache.Put(*stack)
+                           : StackDepotPut(*stack);
 
     Flags &fl = *flags();
     if (fl.max_free_fill_size > 0) {
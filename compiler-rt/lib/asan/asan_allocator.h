@@ -19,6 +19,7 @@
 #include "asan_interceptors.h"
 #include "sanitizer_common/sanitizer_allocator.h"
 #include "sanitizer_common/sanitizer_list.h"
+#include "sanitizer_common/sanitizer_stackdepot.h"
 
 namespace __asan {
 
@@ -194,6 +195,9 @@ using AllocatorCache = AsanAllocator::AllocatorCache;
 struct AsanThreadLocalMallocStorage {
   uptr quarantine_cache[16];
   AllocatorCache allocator_cache;
+  // The last stacks of malloc and free on this thread.
+  StackDepotLastStackCache alloc_stack_cache;
+  StackDepotLastStackCache free_stack_cache;
   void CommitBack();
  private:
   // These objects are allocated via mmap() and are zero-initialized.
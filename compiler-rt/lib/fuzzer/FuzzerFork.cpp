@@ -183,7 +183,10 @@ struct GlobalEnv {
 
     Vector<SizedFile> TempFiles, MergeCandidates;
     // Read all newly created inputs and their feature sets.
-    // Choose only those inputs that have new features.
+    // Choose only those inputs that have new features, not counting the ones
+    // already brought by a smaller candidate: every candidate is re-executed
+    // by the merge below, and jobs often rediscover the same features.
+    Set<uint32_t> CandidateFeatures;
     GetSizedFilesFromDir(Job->CorpusDir, &TempFiles);
     std::sort(TempFiles.begin(), TempFiles.end());
     for (auto &F : TempFiles) {
@@ -193,12 +196,12 @@ struct GlobalEnv {
       assert((FeatureBytes.size() % sizeof(uint32_t)) == 0);
       Vector<uint32_t> NewFeatures(FeatureBytes.size() / sizeof(uint32_t));
       memcpy(NewFeatures.data(), FeatureBytes.data(), FeatureBytes.size());
-      for (auto Ft : NewFeatures) {
-        if (!Features.count(Ft)) {
-          MergeCandidates.push_back(F);
-          break;
-        }
-      }
+      bool HasNewFeatures = false;
+      for (auto Ft : NewFeatures)
+        if (!Features.count(Ft) && CandidateFeatures.insert(Ft).second)
+          HasNewFeatures = true;
+      if (HasNewFeatures)
+        MergeCandidates.push_back(F);
     }
     // if (!FilesToAdd.empty() || Job->ExitCode != 0)
     Printf("#%zd: cov: %zd ft: %zd corp: %zd exec/s %zd "
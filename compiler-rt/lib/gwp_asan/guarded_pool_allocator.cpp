@@ -266,6 +266,20 @@ AllocationMetadata *GuardedPoolAllocator::addrToMetadata(uintptr_t Ptr) const {
   return &Metadata[State.getNearestSlot(Ptr)];
 }
 
+bool GuardedPoolAllocator::shouldSampleSlow() {
+  // NextSampleCounter == 0 means we "should regenerate the counter".
+  //                   == 1 means we "should sample this allocation".
+  // AdjustedSampleRatePlusOne is designed to intentionally underflow. This
+  // class must be valid when zero-initialised, and we wish to sample as
+  // infrequently as possible when this is the case, hence we underflow to
+  // UINT32_MAX.
+  if (ThreadLocals.NextSampleCounter == 0)
+    ThreadLocals.NextSampleCounter =
+        (getRandomUnsigned32() % (AdjustedSampleRatePlusOne - 1)) + 1;
+
+  return --ThreadLocals.NextSampleCounter == 0;
+}
+
 size_t GuardedPoolAllocator::reserveSlot() {
   // Avoid potential reuse of a slot before we have made at least a single
   // allocation in each slot. Helps with our use-after-free detection.
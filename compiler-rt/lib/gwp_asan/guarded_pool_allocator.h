@@ -71,18 +71,15 @@ public:
   void stop();
 
   // Return whether the allocation should be randomly chosen for sampling.
+  // This is called on every allocation of the supporting allocator, so only
+  // the common case of an allocation that isn't sampled is inlined: a single
+  // compare and decrement of a thread-local counter.
   GWP_ASAN_ALWAYS_INLINE bool shouldSample() {
-    // NextSampleCounter == 0 means we "should regenerate the counter".
-    //                   == 1 means we "should sample this allocation".
-    // AdjustedSampleRatePlusOne is designed to intentionally underflow. This
-    // class must be valid when zero-initialised, and we wish to sample as
-    // infrequently as possible when this is the case, hence we underflow to
-    // UINT32_MAX.
-    if (GWP_ASAN_UNLIKELY(ThreadLocals.NextSampleCounter == 0))
-      ThreadLocals.NextSampleCounter =
-          (getRandomUnsigned32() % (AdjustedSampleRatePlusOne - 1)) + 1;
-
-    return GWP_ASAN_UNLIKELY(--ThreadLocals.NextSampleCounter == 0);
+    if (GWP_ASAN_LIKELY(ThreadLocals.NextSampleCounter > 1)) {
+      --ThreadLocals.NextSampleCounter;
+      return false;
+    }
+    return shouldSampleSlow();
   }
 
   // Returns whether the provided pointer is a current sampled allocation that
@@ -149,6 +146,10 @@ private:
   // Unreserve the guarded slot.
   void freeSlot(size_t SlotIndex);
 
+  // Handles the sample counter reaching one, in which case the allocation is
+  // sampled, or zero, in which case the counter is regenerated first.
+  bool shouldSampleSlow();
+
   // Raise a SEGV and set the corresponding fields in the Allocator's State in
   // order to tell the crash handler what happened. Used when errors are
   // detected internally (Double Free, Invalid Free).
@@ -8,6 +8,8 @@
 
 #include "gwp_asan/tests/harness.h"
 
+#include <thread>
+
 TEST_F(CustomGuardedPoolAllocator, BasicAllocation) {
   InitNumSlots(1);
   void *Ptr = GPA.allocate(1);
@@ -59,3 +61,31 @@ TEST_F(CustomGuardedPoolAllocator, AllocAllSlots) {
   for (unsigned i = 0; i < kNumSlots; ++i)
     GPA.deallocate(Ptrs[i]);
 }
+
+TEST(SampleRate, SamplesAtLeastOnceEveryTwiceTheRate) {
+  gwp_asan::GuardedPoolAllocator GPA;
+  gwp_asan::options::Options Opts;
+  Opts.setDefaults();
+  Opts.SampleRate = 4;
+  Opts.InstallForkHandlers = gwp_asan::test::OnlyOnce();
+
+  // The sample counter is thread-local and set by init(), use a new thread so
+  // that neither this test nor the other tests see a counter left over by the
+  // other.
+  unsigned NumSampled = 0;
+  std::thread T([&]() {
+    GPA.init(Opts);
+    unsigned SinceLastSample = 0;
+    for (unsigned i = 0; i < 1000; ++i) {
+      if (GPA.shouldSample()) {
+        ++NumSampled;
+        SinceLastSample = 0;
+      } else {
+        EXPECT_LT(++SinceLastSample, 2u * Opts.SampleRate);
+      }
+    }
+  });
+  T.join();
+  EXPECT_GT(NumSampled, 0u);
+  GPA.uninitTestOnly();
+}
@@ -33,6 +33,11 @@ template<class SizeClassAllocator> struct SizeClassAllocator64LocalCache;
 
 // FreeArray is an array free-d chunks (stored as 4-byte offsets)
 //
+// Chunks drained by a thread cache first go to one of a few small transfer
+// caches of the size class, picked by hashing the address of the thread cache,
+// from which other thread caches refill. These have their own spin locks, so
+// most exchanges between threads don't contend on the region mutex.
+//
 // A Region looks like this:
 // UserChunk1 ... UserChunkN <gap> MetaChunkN ... MetaChunk1 FreeArray
 
@@ -98,6 +103,7 @@ class SizeClassAllocator64 {
   void ForceReleaseToOS() {
     for (uptr class_id = 1; class_id < kNumClasses; class_id++) {
       BlockingMutexLock l(&GetRegionInfo(class_id)->mutex);
+      DrainTransferCaches(class_id);
       MaybeReleaseToOS(class_id, true /*force*/);
     }
   }
@@ -110,6 +116,18 @@ class SizeClassAllocator64 {
   NOINLINE void ReturnToAllocator(AllocatorStats *stat, uptr class_id,
                                   const CompactPtrT *chunks, uptr n_chunks) {
     RegionInfo *region = GetRegionInfo(class_id);
+    TransferCache *tc = GetTransferCache(region, stat);
+    if (n_chunks <= kTransferCacheSize && tc->mutex.TryLock()) {
+      if (tc->count + n_chunks <= kTransferCacheSize) {
+        for (uptr i = 0; i < n_chunks; i++)
+          tc->chunks[tc->count + i] = chunks[i];
+        tc->count += n_chunks;
+        tc->mutex.Unlock();
+        return;
+      }
+      tc->mutex.Unlock();
+    }
+
     uptr region_beg = GetRegionBeginBySizeClass(class_id);
     CompactPtrT *free_array = GetFreeArray(region_beg);
 
@@ -136,6 +154,18 @@ class SizeClassAllocator64 {
   NOINLINE bool GetFromAllocator(AllocatorStats *stat, uptr class_id,
                                  CompactPtrT *chunks, uptr n_chunks) {
     RegionInfo *region = GetRegionInfo(class_id);
+    TransferCache *tc = GetTransferCache(region, stat);
+    if (tc->mutex.TryLock()) {
+      if (tc->count >= n_chunks) {
+        tc->count -= n_chunks;
+        for (uptr i = 0; i < n_chunks; i++)
+          chunks[i] = tc->chunks[tc->count + i];
+        tc->mutex.Unlock();
+        return true;
+      }
+      tc->mutex.Unlock();
+    }
+
     uptr region_beg = GetRegionBeginBySizeClass(class_id);
     CompactPtrT *free_array = GetFreeArray(region_beg);
 
@@ -278,13 +308,19 @@ class SizeClassAllocator64 {
   // introspection API.
   void ForceLock() {
     for (uptr i = 0; i < kNumClasses; i++) {
-      GetRegionInfo(i)->mutex.Lock();
+      RegionInfo *region = GetRegionInfo(i);
+      region->mutex.Lock();
+      for (uptr j = 0; j < kNumTransferCaches; j++)
+        region->transfer_caches[j].mutex.Lock();
     }
   }
 
   void ForceUnlock() {
     for (int i = (int)kNumClasses - 1; i >= 0; i--) {
-      GetRegionInfo(i)->mutex.Unlock();
+      RegionInfo *region = GetRegionInfo(i);
+      for (int j = (int)kNumTransferCaches - 1; j >= 0; j--)
+        region->transfer_caches[j].mutex.Unlock();
+      region->mutex.Unlock();
     }
   }
 
@@ -593,8 +629,18 @@ class SizeClassAllocator64 {
     u64 last_released_bytes;
   };
 
+  static const uptr kNumTransferCaches = 8;
+  static const uptr kTransferCacheSize = 2 * SizeClassMap::kMaxNumCachedHint;
+
+  struct ALIGNED(SANITIZER_CACHE_LINE_SIZE) TransferCache {
+    StaticSpinMutex mutex;
+    uptr count;
+    CompactPtrT chunks[kTransferCacheSize];
+  };
+
   struct ALIGNED(SANITIZER_CACHE_LINE_SIZE) RegionInfo {
     BlockingMutex mutex;
+    TransferCache transfer_caches[kNumTransferCaches];
     uptr num_freed_chunks;  // Number of elements in the freearray.
     uptr mapped_free_array;  // Bytes mapped for freearray.
     uptr allocated_user;  // Bytes allocated for user memory.
@@ -614,6 +660,39 @@ class SizeClassAllocator64 {
     return &regions[class_id];
   }
 
+  // Each thread cache has its own stats, so their address identifies the
+  // thread cache. The addresses of thread caches tend to differ only in their
+  // high bits, hence the multiplicative hash.
+  static TransferCache *GetTransferCache(RegionInfo *region,
+                                         AllocatorStats *stat) {
+    u64 h = reinterpret_cast<uptr>(stat) * 0x9E3779B97F4A7C15ULL;
+    return &region->transfer_caches[h >> 61];
+  }
+  COMPILER_CHECK(kNumTransferCaches == 8);
+
+  // Moves the chunks held by the transfer caches of the region back to its
+  // free array. region->mutex is held.
+  void DrainTransferCaches(uptr class_id) {
+    RegionInfo *region = GetRegionInfo(class_id);
+    uptr region_beg = GetRegionBeginBySizeClass(class_id);
+    CompactPtrT *free_array = GetFreeArray(region_beg);
+    for (uptr i = 0; i < kNumTransferCaches; i++) {
+      TransferCache *tc = &region->transfer_caches[i];
+      SpinMutexLock l(&tc->mutex);
+      if (!tc->count)
+        continue;
+      uptr new_num_freed_chunks = region->num_freed_chunks + tc->count;
+      if (UNLIKELY(!EnsureFreeArraySpace(region, region_beg,
+                                         new_num_freed_chunks)))
+        return;
+      for (uptr j = 0; j < tc->count; j++)
+        free_array[region->num_freed_chunks + j] = tc->chunks[j];
+      region->num_freed_chunks = new_num_freed_chunks;
+      region->stats.n_freed += tc->count;
+      tc->count = 0;
+    }
+  }
+
   uptr GetMetadataEnd(uptr region_beg) const {
     return region_beg + kRegionSize - kFreeArraySize;
   }
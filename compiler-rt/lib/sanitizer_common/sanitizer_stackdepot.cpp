@@ -103,6 +103,19 @@ StackDepotHandle StackDepotPut_WithHandle(StackTrace stack) {
   return theDepot.Put(stack);
 }
 
+u32 StackDepotLastStackCache::Put(StackTrace stack) {
+  if (id_ && stack.size == stack_.size && stack.tag == stack_.tag &&
+      stack.trace &&
+      !internal_memcmp(stack.trace, stack_.trace, stack.size * sizeof(uptr)))
+    return id_;
+  StackDepotHandle h = theDepot.Put(stack);
+  if (!h.valid())
+    return 0;
+  id_ = h.id();
+  stack_ = h.node_->load();
+  return id_;
+}
+
 StackTrace StackDepotGet(u32 id) {
   return theDepot.Get(id);
 }
@@ -39,6 +39,19 @@ StackDepotHandle StackDepotPut_WithHandle(StackTrace stack);
 // Retrieves a stored stack trace by the id.
 StackTrace StackDepotGet(u32 id);
 
+// Remembers the last stack stored through it, so that storing the same stack
+// again, e.g. for allocations made in a loop, is a plain comparison instead of
+// a hash and a lookup in the depot. Not thread-safe, every thread needs its
+// own instance. Valid in zero-initialized state.
+struct StackDepotLastStackCache {
+  u32 Put(StackTrace stack);
+
+ private:
+  u32 id_ = 0;
+  // Points into the depot, which never frees its stacks.
+  StackTrace stack_;
+};
+
 void StackDepotLockAll();
 void StackDepotUnlockAll();
 
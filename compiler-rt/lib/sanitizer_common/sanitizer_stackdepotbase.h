@@ -105,31 +105,62 @@ StackDepotBase<Node, kReservedBits, kTabSizeLog>::Put(args_type args,
   // First, try to find the existing stack.
   Node *node = find(s, args, h);
   if (node) return node->get_handle();
-  // If failed, lock, retry and insert new.
-  Node *s2 = lock(p);
-  if (s2 != s) {
-    node = find(s2, args, h);
-    if (node) {
-      unlock(p, s2);
-      return node->get_handle();
-    }
-  }
+  // If failed, create a new node and publish it by swapping it in as the head
+  // of the bucket. Lookups never lock, so inserting doesn't need to either.
+  // PersistentAlloc() memory is never freed, so a node that loses the race
+  // below is kept as a spare for the next insertion on this thread.
+  static THREADLOCAL Node *spare;
+  static THREADLOCAL uptr spare_size;
   uptr part = (h % kTabSize) / kPartSize;
   u32 id = atomic_fetch_add(&seq[part], 1, memory_order_relaxed) + 1;
-  stats.n_uniq_ids++;
   CHECK_LT(id, kMaxId);
   id |= part << kPartShift;
   CHECK_NE(id, 0);
   CHECK_EQ(id & (((u32)-1) >> kReservedBits), id);
   uptr memsz = Node::storage_size(args);
-  s = (Node *)PersistentAlloc(memsz);
-  stats.allocated += memsz;
-  s->id = id;
-  s->store(args, h);
-  s->link = s2;
-  unlock(p, s);
+  Node *s2;
+  uptr s2_size;
+  if (spare && spare_size >= memsz) {
+    s2 = spare;
+    s2_size = spare_size;
+    spare = nullptr;
+  } else {
+    s2 = (Node *)PersistentAlloc(memsz);
+    s2_size = memsz;
+    stats.allocated += memsz;
+  }
+  s2->id = id;
+  s2->store(args, h);
+  for (int i = 0;; i++) {
+    s2->link = s;
+    uptr cmp = (uptr)s;
+    if (atomic_compare_exchange_weak(p, &cmp, (uptr)s2, memory_order_release))
+      break;
+    // The bucket has changed, the stack may have been inserted concurrently.
+    // In that case the new node is not published and its id is dropped.
+    Node *s3 = (Node *)(cmp & ~1);
+    if (s3 != s) {
+      node = find(s3, args, h);
+      if (node) {
+        if (!spare || spare_size < s2_size) {
+          spare = s2;
+          spare_size = s2_size;
+        }
+        return node->get_handle();
+      }
+      s = s3;
+    }
+    // The lsb of the head is only set while LockAll() holds the table.
+    if (cmp & 1) {
+      if (i < 10)
+        proc_yield(10);
+      else
+        internal_sched_yield();
+    }
+  }
+  stats.n_uniq_ids++;
   if (inserted) *inserted = true;
-  return s->get_handle();
+  return s2->get_handle();
 }
 
 template <class Node, int kReservedBits, int kTabSizeLog>
@@ -535,6 +535,26 @@ TEST(SanitizerCommon, SizeClassAllocator64Overflow) {
 
   a.TestOnlyUnmap();
 }
+
+TEST(SanitizerCommon, SizeClassAllocator64TransferCache) {
+  Allocator64 a;
+  a.Init(kReleaseToOSIntervalNever);
+  AllocatorStats stats;
+  stats.Init();
+
+  const uptr kClassId = 10;
+  const size_t kNumChunks = 16;
+  uint32_t chunks[kNumChunks], chunks2[kNumChunks];
+  ASSERT_TRUE(a.GetFromAllocator(&stats, kClassId, chunks, kNumChunks));
+  a.ReturnToAllocator(&stats, kClassId, chunks, kNumChunks);
+  // The chunks just returned are handed back to the same thread cache.
+  ASSERT_TRUE(a.GetFromAllocator(&stats, kClassId, chunks2, kNumChunks));
+  std::sort(chunks, chunks + kNumChunks);
+  std::sort(chunks2, chunks2 + kNumChunks);
+  EXPECT_TRUE(std::equal(chunks, chunks + kNumChunks, chunks2));
+
+  a.TestOnlyUnmap();
+}
 #endif
 
 TEST(SanitizerCommon, LargeMmapAllocator) {
@@ -12,6 +12,7 @@
 #include "sanitizer_common/sanitizer_stackdepot.h"
 #include "sanitizer_common/sanitizer_internal_defs.h"
 #include "sanitizer_common/sanitizer_libc.h"
+#include "sanitizer_pthread_wrappers.h"
 #include "gtest/gtest.h"
 
 namespace __sanitizer {
@@ -64,6 +65,26 @@ TEST(SanitizerCommon, StackDepotSeveral) {
   EXPECT_NE(i1, i2);
 }
 
+TEST(SanitizerCommon, StackDepotLastStackCache) {
+  uptr array1[] = {1, 2, 3, 4, 9};
+  uptr array2[] = {1, 2, 3, 4, 9};
+  uptr array3[] = {1, 2, 3, 4, 10};
+  StackTrace s1(array1, ARRAY_SIZE(array1));
+  StackTrace s2(array2, ARRAY_SIZE(array2));
+  StackTrace s3(array3, ARRAY_SIZE(array3));
+  StackDepotLastStackCache cache;
+  u32 i1 = cache.Put(s1);
+  EXPECT_NE(i1, 0U);
+  EXPECT_EQ(i1, StackDepotPut(s1));
+  // The cache compares the contents of the stacks.
+  EXPECT_EQ(i1, cache.Put(s2));
+  u32 i3 = cache.Put(s3);
+  EXPECT_NE(i1, i3);
+  EXPECT_EQ(i3, StackDepotPut(s3));
+  EXPECT_EQ(i1, cache.Put(s1));
+  EXPECT_EQ(0U, cache.Put(StackTrace()));
+}
+
 TEST(SanitizerCommon, StackDepotReverseMap) {
   uptr array1[] = {1, 2, 3, 4, 5};
   uptr array2[] = {7, 1, 3, 0};
@@ -89,4 +110,34 @@ TEST(SanitizerCommon, StackDepotReverseMap) {
   }
 }
 
+static void *PutStackThread(void *arg) {
+  StackTrace *s = (StackTrace *)arg;
+  return (void *)(uptr)StackDepotPut(*s);
+}
+
+TEST(SanitizerCommon, StackDepotConcurrentPut) {
+  const int kThreads = 8;
+  for (uptr round = 0; round < 16; round++) {
+    uptr array[] = {11, 12, 13, 0x1000 + round};
+    StackTrace s(array, ARRAY_SIZE(array));
+    uptr n_uniq_ids = StackDepotGetStats()->n_uniq_ids;
+    pthread_t threads[kThreads];
+    for (int i = 0; i < kThreads; i++)
+      PTHREAD_CREATE(&threads[i], 0, PutStackThread, &s);
+    u32 ids[kThreads];
+    for (int i = 0; i < kThreads; i++) {
+      void *id;
+      PTHREAD_JOIN(threads[i], &id);
+      ids[i] = (u32)(uptr)id;
+    }
+    // Only the thread that wins the race publishes the stack, everybody else
+    // gets its id.
+    EXPECT_NE(0U, ids[0]);
+    for (int i = 1; i < kThreads; i++)
+      EXPECT_EQ(ids[0], ids[i]);
+    EXPECT_EQ(ids[0], StackDepotPut(s));
+    EXPECT_EQ(n_uniq_ids + 1, StackDepotGetStats()->n_uniq_ids);
+  }
+}
+
 }  // namespace __sanitizer
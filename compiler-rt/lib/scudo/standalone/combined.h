@@ -187,6 +187,7 @@ public:
   void reset() { memset(this, 0, sizeof(*this)); }
 
   void unmapTestOnly() {
+    stopBackgroundRelease();
     TSDRegistry.unmapTestOnly();
     Primary.unmapTestOnly();
 #ifdef GWP_ASAN_HOOKS
@@ -596,6 +597,45 @@ public:
     Secondary.releaseToOS();
   }
 
+  // Starts a thread that releases the free memory of the Primary and the
+  // Secondary back to the OS every IntervalMs milliseconds. Combined with a
+  // negative release_to_os_interval_ms, this takes the cost of releasing
+  // memory off the deallocation path entirely. Returns false if a thread is
+  // already running or couldn't be created. This isn't done as part of the
+  // initialization as creating a thread may require allocating memory.
+  bool startBackgroundRelease(u32 IntervalMs) {
+    if (!IntervalMs)
+      return false;
+    initThreadMaybe();
+    u32 Expected = 0;
+    if (!atomic_compare_exchange_strong(&BackgroundReleaseIntervalMs,
+                                        &Expected, IntervalMs,
+                                        memory_order_acq_rel))
+      return false;
+    if (pthread_create(&BackgroundReleaseThread, nullptr,
+                       backgroundReleaseLoop, this) != 0) {
+      atomic_store_relaxed(&BackgroundReleaseIntervalMs, 0);
+      return false;
+    }
+    return true;
+  }
+
+  // Stops the thread started by startBackgroundRelease(), if any. This waits
+  // for up to an interval for the thread to wake up and exit.
+  void stopBackgroundRelease() {
+    if (atomic_exchange(&BackgroundReleaseIntervalMs, 0U,
+                        memory_order_acq_rel) != 0)
+      pthread_join(BackgroundReleaseThread, nullptr);
+  }
+
+  // Only the forking thread survives in the child of a fork(), so a running
+  // background release thread is forgotten there rather than joined. This is
+  // meant to be called from an atfork child handler; the child can start its
+  // own thread with startBackgroundRelease().
+  void resetBackgroundReleaseInChild() {
+    atomic_store_relaxed(&BackgroundReleaseIntervalMs, 0);
+  }
+
   // Iterate over all chunks and call a callback for all busy chunks located
   // within the provided memory range. Said callback must not use this allocator
   // or a deadlock can ensue. This fits Android's malloc_iterate() needs.
@@ -716,6 +756,9 @@ private:
 
   u32 Cookie;
 
+  atomic_u32 BackgroundReleaseIntervalMs;
+  pthread_t BackgroundReleaseThread;
+
   struct {
     u8 MayReturnNull : 1;       // may_return_null
     u8 ZeroContents : 1;        // zero_contents
@@ -837,6 +880,22 @@ private:
     Quarantine.getStats(Str);
     return Str->length();
   }
+
+  static void *backgroundReleaseLoop(void *Arg) {
+    Allocator *A = reinterpret_cast<Allocator *>(Arg);
+    while (true) {
+      const u32 IntervalMs =
+          atomic_load(&A->BackgroundReleaseIntervalMs, memory_order_acquire);
+      if (!IntervalMs)
+        break;
+      sleepMilliseconds(IntervalMs);
+      if (!atomic_load(&A->BackgroundReleaseIntervalMs, memory_order_acquire))
+        break;
+      A->Primary.releaseToOS();
+      A->Secondary.releaseToOS();
+    }
+    return nullptr;
+  }
 };
 
 } // namespace scudo
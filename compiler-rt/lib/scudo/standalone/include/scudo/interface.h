@@ -20,6 +20,10 @@ __attribute__((weak)) void __scudo_deallocate_hook(void *ptr);
 
 void __scudo_print_stats(void);
 
+// Starts a thread releasing free memory back to the OS every interval_ms
+// milliseconds. Returns 0 on success.
+int __scudo_start_background_release(int interval_ms);
+
 typedef void (*iterate_callback)(uintptr_t base, size_t size, void *arg);
 
 } // extern "C"
@@ -130,6 +130,14 @@ u64 getMonotonicTime() {
          static_cast<u64>(TS.tv_nsec);
 }
 
+void sleepMilliseconds(u32 Milliseconds) {
+  timespec TS;
+  TS.tv_sec = Milliseconds / 1000;
+  TS.tv_nsec = static_cast<long>(Milliseconds % 1000) * (1000 * 1000);
+  while (nanosleep(&TS, &TS) == -1 && errno == EINTR) {
+  }
+}
+
 u32 getNumberOfCPUs() {
   cpu_set_t CPUs;
   // sched_getaffinity can fail for a variety of legitimate reasons (lack of
@@ -139,6 +147,8 @@ u32 getNumberOfCPUs() {
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+s32 getCurrentCPU() { return sched_getcpu(); }
+
 // Blocking is possibly unused if the getrandom block is not compiled in.
 bool getRandom(void *Buffer, uptr Length, UNUSED bool Blocking) {
   if (!Buffer || !Length || Length > MaxRandomLength)
@@ -16,6 +16,11 @@
 #include <thread>
 #include <vector>
 
+#if !SCUDO_FUCHSIA
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 static std::mutex Mutex;
 static std::condition_variable Cv;
 static bool Ready = false;
@@ -417,6 +422,69 @@ TEST(ScudoCombinedTest, ReleaseToOS) {
   Allocator->releaseToOS();
 }
 
+TEST(ScudoCombinedTest, BackgroundRelease) {
+  using AllocatorT = scudo::Allocator<scudo::DefaultConfig>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  Allocator->reset();
+
+  EXPECT_FALSE(Allocator->startBackgroundRelease(0U));
+  EXPECT_TRUE(Allocator->startBackgroundRelease(1U));
+  // Only one thread can be running at a time.
+  EXPECT_FALSE(Allocator->startBackgroundRelease(1U));
+
+  // Use a fresh thread, as the exclusive TSD of this one may already be bound
+  // to the allocator of a previous test.
+  std::thread T([&Allocator]() {
+    std::vector<void *> V;
+    for (scudo::uptr I = 0; I < 64U; I++)
+      V.push_back(Allocator->allocate(1U << (I % 20), Origin));
+    for (void *P : V)
+      Allocator->deallocate(P, Origin);
+  });
+  T.join();
+
+  Allocator->stopBackgroundRelease();
+  // The thread can be restarted once stopped, and is stopped on unmap.
+  EXPECT_TRUE(Allocator->startBackgroundRelease(1U));
+}
+
+// Fuchsia doesn't have fork.
+#if !SCUDO_FUCHSIA
+TEST(ScudoCombinedTest, BackgroundReleaseFork) {
+  using AllocatorT = scudo::Allocator<scudo::DefaultConfig>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  Allocator->reset();
+
+  EXPECT_TRUE(Allocator->startBackgroundRelease(1U));
+  pid_t Pid = fork();
+  EXPECT_GE(Pid, 0);
+  if (Pid == 0) {
+    // The release thread doesn't exist in the child. Once reset, a new one
+    // can be started, and stopping it doesn't join the parent's thread.
+    Allocator->resetBackgroundReleaseInChild();
+    if (!Allocator->startBackgroundRelease(1U))
+      _exit(1);
+    Allocator->stopBackgroundRelease();
+    _exit(0);
+  }
+  int Status;
+  EXPECT_EQ(waitpid(Pid, &Status, 0), Pid);
+  EXPECT_TRUE(WIFEXITED(Status));
+  EXPECT_EQ(WEXITSTATUS(Status), 0);
+  Allocator->stopBackgroundRelease();
+}
+#endif
+
 // Verify that when a region gets full, the allocator will still manage to
 // fulfill the allocation through a larger size class.
 TEST(ScudoCombinedTest, FullRegion) {
@@ -121,6 +121,18 @@ private:
 
   NOINLINE TSD<Allocator> *getTSDAndLockSlow(TSD<Allocator> *CurrentTSD) {
     if (MaxTSDCount > 1U && NumberOfTSDs > 1U) {
+      // Threads running on the same CPU can't hold a TSD at the same time
+      // unless they get preempted, so the TSD of the current CPU is the least
+      // likely to be contended. NumberOfTSDs is the number of CPUs if that's
+      // not more than MaxTSDCount, in which case each CPU gets its own TSD.
+      const s32 CPU = getCurrentCPU();
+      if (CPU >= 0) {
+        TSD<Allocator> *CPUTSD = &TSDs[static_cast<u32>(CPU) % NumberOfTSDs];
+        if (CPUTSD != CurrentTSD && CPUTSD->tryLock()) {
+          setCurrentTSD(CPUTSD);
+          return CPUTSD;
+        }
+      }
       // Use the Precedence of the current TSD as our random seed. Since we are
       // in the slow path, it means that tryLock failed, and as a result it's
       // very likely that said Precedence is non-zero.
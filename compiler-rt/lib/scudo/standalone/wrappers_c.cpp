@@ -35,4 +35,12 @@ scudo::Allocator<scudo::Config, SCUDO_PREFIX(malloc_postinit)> SCUDO_ALLOCATOR;
 
 extern "C" INTERFACE void __scudo_print_stats(void) { Allocator.printStats(); }
 
+extern "C" INTERFACE int __scudo_start_background_release(int interval_ms) {
+  if (interval_ms <= 0)
+    return -1;
+  return Allocator.startBackgroundRelease(static_cast<scudo::u32>(interval_ms))
+             ? 0
+             : -1;
+}
+
 #endif // !SCUDO_ANDROID || !_BIONIC
@@ -48,4 +48,12 @@ static scudo::Allocator<scudo::AndroidSvelteConfig,
 // TODO(kostyak): support both allocators.
 INTERFACE void __scudo_print_stats(void) { Allocator.printStats(); }
 
+INTERFACE int __scudo_start_background_release(int interval_ms) {
+  if (interval_ms <= 0)
+    return -1;
+  return Allocator.startBackgroundRelease(static_cast<scudo::u32>(interval_ms))
+             ? 0
+             : -1;
+}
+
 #endif // SCUDO_ANDROID && _BIONIC
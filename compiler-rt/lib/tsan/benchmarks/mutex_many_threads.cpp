@@ -0,0 +1,39 @@
+// Mini-benchmark for tsan: a single mutex contended by many threads.
+// Each lock acquires the mutex clock and each unlock releases into it. With
+// more releasers than the clock has dirty entries, every release that follows
+// an acquire from another thread is O(number of threads).
+//
+// Usage: mutex_many_threads [n_threads [n_iterations]]
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int n_iterations;
+pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
+long counter;
+
+void *Thread(void *arg) {
+  for (int i = 0; i < n_iterations; i++) {
+    pthread_mutex_lock(&mtx);
+    counter++;
+    pthread_mutex_unlock(&mtx);
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int n_threads = argc > 1 ? atoi(argv[1]) : 8;
+  n_iterations = argc > 2 ? atoi(argv[2]) : 1000000;
+  assert(n_threads > 0 && n_threads <= 1000);
+  printf("%s: n_threads=%d n_iterations=%d\n", __FILE__, n_threads,
+         n_iterations);
+  pthread_t *t = new pthread_t[n_threads];
+  for (int i = 0; i < n_threads; i++)
+    pthread_create(&t[i], 0, Thread, 0);
+  for (int i = 0; i < n_threads; i++)
+    pthread_join(t[i], 0);
+  assert(counter == (long)n_threads * n_iterations);
+  delete [] t;
+  return 0;
+}
@@ -368,8 +368,8 @@ void ThreadClock::UpdateCurrentThread(ClockCache *c, SyncClock *dst) const {
   dst->Unshare(c);
   CPP_STAT_INC(StatClockReleaseSlow);
   dst->elem(tid_).epoch = clk_[tid_];
-  for (uptr i = 0; i < dst->size_; i++)
-    dst->elem(i).reused = 0;
+  for (ClockElem &ce : *dst)
+    ce.reused = 0;
   dst->FlushDirty();
 }
 
@@ -602,10 +602,10 @@ void SyncClock::DebugDump(int(*printf)(const char *s, ...)) {
   printf("] reused=[");
   for (uptr i = 0; i < size_; i++)
     printf("%s%llu", i == 0 ? "" : ",", elem(i).reused);
-  printf("] release_store_tid=%d/%d dirty_tids=%d[%llu]/%d[%llu]",
-      release_store_tid_, release_store_reused_,
-      dirty_[0].tid, dirty_[0].epoch,
-      dirty_[1].tid, dirty_[1].epoch);
+  printf("] release_store_tid=%d/%d dirty_tids=",
+      release_store_tid_, release_store_reused_);
+  for (uptr i = 0; i < kDirtyTids; i++)
+    printf("%s%d[%llu]", i == 0 ? "" : "/", dirty_[i].tid, dirty_[i].epoch);
 }
 
 void SyncClock::Iter::Next() {
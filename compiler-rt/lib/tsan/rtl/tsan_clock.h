@@ -62,7 +62,10 @@ class SyncClock {
  private:
   friend class ThreadClock;
   friend class Iter;
-  static const uptr kDirtyTids = 2;
+  // Number of threads that can release to the clock in O(1) before the next
+  // O(N) flush. Mutexes are commonly released by more than a couple of
+  // threads in turn, so a few more entries pay for the extra 16 bytes.
+  static const uptr kDirtyTids = 4;
 
   struct Dirty {
     u64 epoch  : kClkBits;
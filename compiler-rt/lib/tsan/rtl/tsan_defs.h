@@ -27,6 +27,10 @@
 # define TSAN_COLLECT_STATS 0
 #endif
 
+#ifndef TSAN_SHADOW_COUNT
+# define TSAN_SHADOW_COUNT 4
+#endif
+
 #ifndef TSAN_CONTAINS_UBSAN
 # if CAN_SANITIZE_UB && !SANITIZER_GO
 #  define TSAN_CONTAINS_UBSAN 1
@@ -74,7 +78,13 @@ const unsigned kMaxTidInClock = kMaxTid;  // Go does not track freed memory.
 const uptr kShadowStackSize = 64 * 1024;
 
 // Count of shadow values in a shadow cell.
-const uptr kShadowCnt = 4;
+// A runtime built with TSAN_SHADOW_COUNT=2 uses half the shadow memory, but
+// remembers only two previous accesses to each 8 bytes of application memory,
+// so it misses more races between three or more threads.
+#if TSAN_SHADOW_COUNT != 2 && TSAN_SHADOW_COUNT != 4
+# error "TSAN_SHADOW_COUNT must be 2 or 4"
+#endif
+const uptr kShadowCnt = TSAN_SHADOW_COUNT;
 
 // That many user bytes are mapped onto a single shadow cell.
 const uptr kShadowCell = 8;
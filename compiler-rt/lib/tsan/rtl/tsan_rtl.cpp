@@ -677,7 +677,7 @@ void MemoryAccessImpl1(ThreadState *thr, uptr addr,
   // consumes almost 4K of stack. Gtest gives only 4K of stack to death test
   // threads, which is not enough for the unrolled loop.
 #if SANITIZER_DEBUG
-  for (int idx = 0; idx < 4; idx++) {
+  for (uptr idx = 0; idx < kShadowCnt; idx++) {
 #include "tsan_update_shadow_word_inl.h"
   }
 #else
@@ -689,6 +689,7 @@ void MemoryAccessImpl1(ThreadState *thr, uptr addr,
   } else {
 #include "tsan_update_shadow_word_inl.h"
   }
+#if TSAN_SHADOW_COUNT > 2
   idx = 2;
   if (stored) {
 #include "tsan_update_shadow_word_inl.h"
@@ -701,6 +702,7 @@ void MemoryAccessImpl1(ThreadState *thr, uptr addr,
   } else {
 #include "tsan_update_shadow_word_inl.h"
   }
+#endif
 #endif
 
   // we did not find any races and had already stored
@@ -708,7 +710,17 @@ void MemoryAccessImpl1(ThreadState *thr, uptr addr,
   if (LIKELY(stored))
     return;
   // choose a random candidate slot and replace it
-  StoreShadow(shadow_mem + (cur.epoch() % kShadowCnt), store_word);
+  {
+    uptr slot = cur.epoch() % kShadowCnt;
+#if TSAN_SHADOW_COUNT == 2
+    // With only two slots, rather evict an access of the current thread, or
+    // one that happens before the current access, than a concurrent one.
+    Shadow other = LoadShadow(&shadow_mem[slot ^ 1]);
+    if (Shadow::TidsAreEqual(other, cur) || HappensBefore(other, thr))
+      slot ^= 1;
+#endif
+    StoreShadow(shadow_mem + slot, store_word);
+  }
   StatInc(thr, StatShadowReplace);
   return;
  RACE:
@@ -812,7 +824,8 @@ bool ContainsSameAccessFast(u64 *s, u64 a, u64 sync_epoch, bool is_write) {
 
 ALWAYS_INLINE
 bool ContainsSameAccess(u64 *s, u64 a, u64 sync_epoch, bool is_write) {
-#if defined(__SSE3__)
+  // The vector version checks exactly 4 shadow values.
+#if defined(__SSE3__) && TSAN_SHADOW_COUNT == 4
   bool res = ContainsSameAccessFast(s, a, sync_epoch, is_write);
   // NOTE: this check can fail if the shadow is concurrently mutated
   // by other threads. But it still can be useful if you modify
@@ -829,11 +842,10 @@ void MemoryAccess(ThreadState *thr, uptr pc, uptr addr,
     int kAccessSizeLog, bool kAccessIsWrite, bool kIsAtomic) {
   u64 *shadow_mem = (u64*)MemToShadow(addr);
   DPrintf2("#%d: MemoryAccess: @%p %p size=%d"
-      " is_write=%d shadow_mem=%p {%zx, %zx, %zx, %zx}\n",
+      " is_write=%d shadow_mem=%p {%zx, %zx, ...}\n",
       (int)thr->fast_state.tid(), (void*)pc, (void*)addr,
       (int)(1 << kAccessSizeLog), kAccessIsWrite, shadow_mem,
-      (uptr)shadow_mem[0], (uptr)shadow_mem[1],
-      (uptr)shadow_mem[2], (uptr)shadow_mem[3]);
+      (uptr)shadow_mem[0], (uptr)shadow_mem[1]);
 #if SANITIZER_DEBUG
   if (!IsAppMem(addr)) {
     Printf("Access to non app mem %zx\n", addr);
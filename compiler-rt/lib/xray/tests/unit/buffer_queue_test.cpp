@@ -14,6 +14,7 @@
 #include "gtest/gtest.h"
 
 #include <atomic>
+#include <cstring>
 #include <future>
 #include <thread>
 #include <unistd.h>
@@ -106,6 +107,79 @@ TEST(BufferQueueTest, MultiThreaded) {
   F();
 }
 
+TEST(BufferQueueTest, MultiThreadedExclusiveBuffers) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 4, Success);
+  ASSERT_TRUE(Success);
+  std::atomic<int> Failures{0};
+  auto F = [&](int Id) {
+    BufferQueue::Buffer B;
+    for (int I = 0; I < 10000; ++I) {
+      if (Buffers.getBuffer(B) != BufferQueue::ErrorCode::Ok)
+        continue;
+      // No other thread may be writing to the buffer while we hold it.
+      auto *Owner = static_cast<volatile int *>(B.Data);
+      *Owner = Id;
+      std::this_thread::yield();
+      if (*Owner != Id)
+        Failures.fetch_add(1, std::memory_order_relaxed);
+      ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+    }
+  };
+  std::thread Threads[8];
+  for (int I = 0; I < 8; ++I)
+    Threads[I] = std::thread(F, I);
+  for (auto &T : Threads)
+    T.join();
+  EXPECT_EQ(Failures.load(), 0);
+
+  // All the buffers are available again.
+  BufferQueue::Buffer B[4];
+  for (auto &Buf : B)
+    ASSERT_EQ(Buffers.getBuffer(Buf), BufferQueue::ErrorCode::Ok);
+  BufferQueue::Buffer Extra;
+  EXPECT_EQ(Buffers.getBuffer(Extra), BufferQueue::ErrorCode::NotEnoughMemory);
+  for (auto &Buf : B)
+    ASSERT_EQ(Buffers.releaseBuffer(Buf), BufferQueue::ErrorCode::Ok);
+}
+
+TEST(BufferQueueTest, MultiThreadedOneBufferPerThread) {
+  // With as many buffers as threads, a getBuffer never finds the queue empty,
+  // even while a release that would refill it is still publishing its slot,
+  // and a release never finds its slot still held by a getBuffer.
+  constexpr int kThreads = 4;
+  bool Success = false;
+  BufferQueue Buffers(kSize, kThreads, Success);
+  ASSERT_TRUE(Success);
+  std::atomic<int> Failures{0};
+  auto F = [&] {
+    BufferQueue::Buffer B;
+    for (int I = 0; I < 100000; ++I) {
+      if (Buffers.getBuffer(B) != BufferQueue::ErrorCode::Ok) {
+        Failures.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      if (Buffers.releaseBuffer(B) != BufferQueue::ErrorCode::Ok)
+        Failures.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+  std::thread Threads[kThreads];
+  for (auto &T : Threads)
+    T = std::thread(F);
+  for (auto &T : Threads)
+    T.join();
+  EXPECT_EQ(Failures.load(), 0);
+
+  // No buffer was dropped.
+  BufferQueue::Buffer B[kThreads];
+  for (auto &Buf : B)
+    ASSERT_EQ(Buffers.getBuffer(Buf), BufferQueue::ErrorCode::Ok);
+  BufferQueue::Buffer Extra;
+  EXPECT_EQ(Buffers.getBuffer(Extra), BufferQueue::ErrorCode::NotEnoughMemory);
+  for (auto &Buf : B)
+    ASSERT_EQ(Buffers.releaseBuffer(Buf), BufferQueue::ErrorCode::Ok);
+}
+
 TEST(BufferQueueTest, Apply) {
   bool Success = false;
   BufferQueue Buffers(kSize, 10, Success);
@@ -230,5 +304,36 @@ TEST(BufferQueueTest, GenerationalSupportAcrossThreads) {
   ASSERT_EQ(Counter.load(std::memory_order_acquire), 0);
 }
 
+TEST(BufferQueueTest, ReinitWhileGettingAndReleasing) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 4, Success);
+  ASSERT_TRUE(Success);
+  std::atomic<bool> Done{false};
+
+  // The threads keep getting and releasing buffers while the main thread
+  // re-initializes the queue with a different number of buffers each time.
+  auto Process = [&] {
+    BufferQueue::Buffer B;
+    while (!Done.load(std::memory_order_acquire)) {
+      if (Buffers.getBuffer(B) != BufferQueue::ErrorCode::Ok)
+        continue;
+      memset(B.Data, 0, B.Size);
+      EXPECT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+    }
+  };
+  std::thread Threads[4];
+  for (auto &T : Threads)
+    T = std::thread(Process);
+
+  for (size_t I = 0; I < 100; ++I) {
+    ASSERT_EQ(Buffers.finalize(), BufferQueue::ErrorCode::Ok);
+    ASSERT_EQ(Buffers.init(kSize, 1 + I % 8), BufferQueue::ErrorCode::Ok);
+  }
+
+  Done.store(true, std::memory_order_release);
+  for (auto &T : Threads)
+    T.join();
+}
+
 } // namespace
 } // namespace __xray
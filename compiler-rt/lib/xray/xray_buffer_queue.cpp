@@ -73,8 +73,23 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   if (!finalizing())
     return BufferQueue::ErrorCode::AlreadyInitialized;
 
+  if (BC == 0)
+    return BufferQueue::ErrorCode::NotEnoughMemory;
+
+  // Wait for the getBuffer and releaseBuffer calls that may still be looking
+  // at the buffers we're about to free.
+  atomic_store(&Resetting, 1, memory_order_seq_cst);
+  auto ClearResetting = at_scope_exit(
+      [this] { atomic_store(&Resetting, 0, memory_order_release); });
+  while (atomic_load(&ActiveOps, memory_order_seq_cst) != 0)
+    internal_sched_yield();
+
   cleanupBuffers();
 
+  // Buffers handed out before this point belong to the old generation, even
+  // if we fail to allocate the new one, so releasing them just drops them.
+  atomic_fetch_add(&Generation, 1, memory_order_acq_rel);
+
   bool Success = false;
   BufferSize = BS;
   BufferCount = BC;
@@ -106,10 +121,6 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   if (Buffers == nullptr)
     return BufferQueue::ErrorCode::NotEnoughMemory;
 
-  // At this point we increment the generation number to associate the buffers
-  // to the new generation.
-  atomic_fetch_add(&Generation, 1, memory_order_acq_rel);
-
   // First, we initialize the refcount in the ControlBlock, which we treat as
   // being at the start of the BackingStore pointer.
   atomic_store(&BackingStore->RefCount, 1, memory_order_release);
@@ -132,11 +143,14 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
     Buf.ExtentsBackingStore = ExtentsBackingStore;
     Buf.Count = BufferCount;
     T.Used = false;
+    atomic_store(&T.Sequence, i + 1, memory_order_relaxed);
   }
 
-  Next = Buffers;
-  First = Buffers;
-  LiveBuffers = 0;
+  // All the buffers start out available: the first one to be handed out is at
+  // position 0, and the first one to be released goes to position
+  // BufferCount, which reuses the slot of the first buffer handed out.
+  atomic_store(&Next, 0, memory_order_relaxed);
+  atomic_store(&First, BufferCount, memory_order_relaxed);
   atomic_store(&Finalizing, 0, memory_order_release);
   Success = true;
   return BufferQueue::ErrorCode::Ok;
@@ -148,29 +162,46 @@ BufferQueue::BufferQueue(size_t B, size_t N,
       BufferCount(N),
       Mutex(),
       Finalizing{1},
+      Resetting{0},
+      ActiveOps{0},
       BackingStore(nullptr),
       ExtentsBackingStore(nullptr),
       Buffers(nullptr),
-      Next(Buffers),
-      First(Buffers),
-      LiveBuffers(0),
+      Next{0},
+      First{0},
       Generation{0} {
   Success = init(B, N) == BufferQueue::ErrorCode::Ok;
 }
 
 BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
-  if (atomic_load(&Finalizing, memory_order_acquire))
+  // Keep init() from freeing the buffers until we're done. init() only runs
+  // on a finalizing queue, so if it has started we see Finalizing below.
+  atomic_fetch_add(&ActiveOps, 1, memory_order_seq_cst);
+  auto LeaveOp = at_scope_exit(
+      [this] { atomic_fetch_sub(&ActiveOps, 1, memory_order_release); });
+  if (atomic_load(&Finalizing, memory_order_seq_cst))
     return ErrorCode::QueueFinalizing;
 
+  u64 Pos = atomic_load(&Next, memory_order_relaxed);
   BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (LiveBuffers == BufferCount)
-      return ErrorCode::NotEnoughMemory;
-    B = Next++;
-    if (Next == (Buffers + BufferCount))
-      Next = Buffers;
-    ++LiveBuffers;
+  while (true) {
+    B = &Buffers[Pos % BufferCount];
+    u64 Seq = atomic_load(&B->Sequence, memory_order_acquire);
+    if (Seq == Pos + 1) {
+      if (atomic_compare_exchange_weak(&Next, &Pos, Pos + 1,
+                                       memory_order_relaxed))
+        break;
+    } else if (Seq < Pos + 1) {
+      // The buffer that would be handed out at this position hasn't been
+      // published yet. If no release has claimed this position, all the
+      // buffers are in use; otherwise wait for the release to publish it.
+      if (atomic_load(&First, memory_order_acquire) <= Pos)
+        return ErrorCode::NotEnoughMemory;
+      internal_sched_yield();
+      Pos = atomic_load(&Next, memory_order_relaxed);
+    } else {
+      Pos = atomic_load(&Next, memory_order_relaxed);
+    }
   }
 
   incRefCount(BackingStore);
@@ -178,30 +209,59 @@ BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
   Buf = B->Buff;
   Buf.Generation = generation();
   B->Used = true;
+
+  // Let the slot be reused by the release at the position a full turn later.
+  atomic_store(&B->Sequence, Pos + BufferCount, memory_order_release);
   return ErrorCode::Ok;
 }
 
 BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
   // Check whether the buffer being referred to is within the bounds of the
   // backing store's range.
-  BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (Buf.Generation != generation() || LiveBuffers == 0) {
-      Buf = {};
-      decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
-      decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
-      return BufferQueue::ErrorCode::Ok;
-    }
+  auto DropBuffer = [&Buf] {
+    Buffer Dropped = Buf;
+    Buf = {};
+    decRefCount(Dropped.BackingStore, Dropped.Size, Dropped.Count);
+    decRefCount(Dropped.ExtentsBackingStore, kExtentsSize, Dropped.Count);
+    return BufferQueue::ErrorCode::Ok;
+  };
+
+  // Keep init() from freeing the buffers until we're done. If it's already
+  // replacing them, the buffer belongs to the generation being discarded.
+  atomic_fetch_add(&ActiveOps, 1, memory_order_seq_cst);
+  auto LeaveOp = at_scope_exit(
+      [this] { atomic_fetch_sub(&ActiveOps, 1, memory_order_release); });
+  if (atomic_load(&Resetting, memory_order_seq_cst))
+    return DropBuffer();
 
-    if (Buf.Data < &BackingStore->Data ||
-        Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
-      return BufferQueue::ErrorCode::UnrecognizedBuffer;
+  if (Buf.Generation != generation())
+    return DropBuffer();
 
-    --LiveBuffers;
-    B = First++;
-    if (First == (Buffers + BufferCount))
-      First = Buffers;
+  if (Buf.Data < &BackingStore->Data ||
+      Buf.Data > &BackingStore->Data + (BufferCount * BufferSize))
+    return BufferQueue::ErrorCode::UnrecognizedBuffer;
+
+  u64 Pos = atomic_load(&First, memory_order_relaxed);
+  BufferRep *B = nullptr;
+  while (true) {
+    B = &Buffers[Pos % BufferCount];
+    u64 Seq = atomic_load(&B->Sequence, memory_order_acquire);
+    if (Seq == Pos) {
+      if (atomic_compare_exchange_weak(&First, &Pos, Pos + 1,
+                                       memory_order_relaxed))
+        break;
+    } else if (Seq < Pos) {
+      // The slot hasn't been vacated by the getBuffer a full turn earlier yet.
+      // If every buffer has already been returned, this one can't be ours;
+      // otherwise that getBuffer has claimed its buffer but not marked the
+      // slot, so wait for it.
+      if (atomic_load(&Next, memory_order_acquire) + BufferCount <= Pos)
+        return DropBuffer();
+      internal_sched_yield();
+      Pos = atomic_load(&First, memory_order_relaxed);
+    } else {
+      Pos = atomic_load(&First, memory_order_relaxed);
+    }
   }
 
   // Now that the buffer has been released, we mark it as "used".
@@ -211,6 +271,9 @@ BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
   decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
   atomic_store(B->Buff.Extents, atomic_load(Buf.Extents, memory_order_acquire),
                memory_order_release);
+
+  // Publish the slot to the getBuffer at this position.
+  atomic_store(&B->Sequence, Pos + 1, memory_order_release);
   Buf = {};
   return ErrorCode::Ok;
 }
@@ -28,6 +28,12 @@ namespace __xray {
 /// get from or return buffers to the queue. This is one key component of the
 /// "flight data recorder" (FDR) mode to support ongoing XRay function call
 /// trace collection.
+///
+/// Getting and releasing buffers doesn't take a lock: each slot in the queue
+/// carries a sequence number which tells whether it holds a buffer that can be
+/// handed out, or is waiting for a buffer to be released into it, so threads
+/// only contend on the atomic positions at either end of the queue. Only
+/// re-initializing the queue waits for the calls in flight to finish.
 class BufferQueue {
 public:
   /// ControlBlock represents the memory layout of how we interpret the backing
@@ -71,6 +77,11 @@ public:
     // This is true if the buffer has been returned to the available queue, and
     // is considered "used" by another thread.
     bool Used = false;
+
+    // For the slot at index I, this is P + 1 when it holds the buffer to be
+    // handed out at position P (with P % BufferCount == I), and P when it is
+    // waiting for the buffer released at position P.
+    atomic_uint64_t Sequence;
   };
 
 private:
@@ -140,6 +151,12 @@ private:
   SpinMutex Mutex;
   atomic_uint8_t Finalizing;
 
+  // Set while init() replaces the buffers. getBuffer and releaseBuffer don't
+  // take the mutex, so init() waits for the calls counted in ActiveOps to
+  // finish, and calls that start in the meantime see this and back off.
+  atomic_uint8_t Resetting;
+  atomic_uint64_t ActiveOps;
+
   // The collocated ControlBlock and buffer storage.
   ControlBlock *BackingStore;
 
@@ -149,15 +166,14 @@ private:
   // A dynamically allocated array of BufferRep instances.
   BufferRep *Buffers;
 
-  // Pointer to the next buffer to be handed out.
-  BufferRep *Next;
-
-  // Pointer to the entry in the array where the next released buffer will be
-  // placed.
-  BufferRep *First;
+  // Position of the next buffer to be handed out. This only ever increases,
+  // the corresponding entry in the array is at Next % BufferCount.
+  atomic_uint64_t Next;
 
-  // Count of buffers that have been handed out through 'getBuffer'.
-  size_t LiveBuffers;
+  // Position where the next released buffer will be placed. This starts at
+  // BufferCount, so the count of buffers that have been handed out through
+  // 'getBuffer' and not released yet is Next + BufferCount - First.
+  atomic_uint64_t First;
 
   // We use a generation number to identify buffers and which generation they're
   // associated with.
@@ -0,0 +1,89 @@
+//===------------------- Single-precision e^x function --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/expf.h"
+#include "src/__support/common.h"
+#include "src/math/math_utils.h"
+
+#include <stdint.h>
+
+namespace __llvm_libc {
+
+// This is a port of the implementation in the Arm Optimized Routines, see
+// AOR_v20.02/math/expf.c. The error is at most 0.502 ULP with nearest
+// rounding.
+//
+// The computation is done in double precision with a table of powers of two
+// and a polynomial, without any data dependent branch for arguments that don't
+// overflow or underflow.
+
+static constexpr int kExp2fTableBits = 5;
+static constexpr int kExp2fTableSize = 1 << kExp2fTableBits;
+
+// tab[i] = uint(2^(i/N)) - (i << 52-BITS), used for computing 2^(k/N) for an
+// int |k| < 150 N as double(tab[k%N] + (k << 52-BITS)).
+static constexpr uint64_t kExp2fTable[kExp2fTableSize] = {
+    0x3ff0000000000000, 0x3fefd9b0d3158574, 0x3fefb5586cf9890f,
+    0x3fef9301d0125b51, 0x3fef72b83c7d517b, 0x3fef54873168b9aa,
+    0x3fef387a6e756238, 0x3fef1e9df51fdee1, 0x3fef06fe0a31b715,
+    0x3feef1a7373aa9cb, 0x3feedea64c123422, 0x3feece086061892d,
+    0x3feebfdad5362a27, 0x3feeb42b569d4f82, 0x3feeab07dd485429,
+    0x3feea47eb03a5585, 0x3feea09e667f3bcd, 0x3fee9f75e8ec5f74,
+    0x3feea11473eb0187, 0x3feea589994cce13, 0x3feeace5422aa0db,
+    0x3feeb737b0cdc5e5, 0x3feec49182a3f090, 0x3feed503b23e255d,
+    0x3feee89f995ad3ad, 0x3feeff76f2fb5e47, 0x3fef199bdd85529c,
+    0x3fef3720dcef9069, 0x3fef5818dcfba487, 0x3fef7c97337b9b5f,
+    0x3fefa4afa2a490da, 0x3fefd0765b6e4540,
+};
+
+static constexpr double kShift = 0x1.8p+52;
+static constexpr double kInvLn2N = 0x1.71547652b82fep+0 * kExp2fTableSize;
+static constexpr double kPoly[3] = {
+    0x1.c6af84b912394p-5 / kExp2fTableSize / kExp2fTableSize / kExp2fTableSize,
+    0x1.ebfce50fac4f3p-3 / kExp2fTableSize / kExp2fTableSize,
+    0x1.62e42ff0c52d6p-1 / kExp2fTableSize};
+
+float LLVM_LIBC_ENTRYPOINT(expf)(float x) {
+  uint32_t abstop = top12_bits(x) & 0x7ff;
+  if (__builtin_expect(abstop >= top12_bits(88.0f), 0)) {
+    // |x| >= 88 or x is nan.
+    if (as_uint32_bits(x) == as_uint32_bits(-__builtin_inff()))
+      return 0.0f;
+    if (abstop >= top12_bits(__builtin_inff()))
+      return x + x;
+    if (x > 0x1.62e42ep6f) // x > log(0x1p128) ~= 88.72
+      return oflowf(0);
+    if (x < -0x1.9fe368p6f) // x < log(0x1p-150) ~= -103.97
+      return uflowf(0);
+  }
+
+  // x*N/Ln2 = k + r with r in [-1/2, 1/2] and int k.
+  double xd = static_cast<double>(x);
+  double z = kInvLn2N * xd;
+
+  // Round and convert z to int, the result is in [-150*N, 128*N] and ideally
+  // nearest int is used, otherwise the magnitude of r can be bigger which
+  // gives larger approximation error.
+  double kd = z + kShift;
+  uint64_t ki = as_uint64_bits(kd);
+  kd -= kShift;
+  double r = z - kd;
+
+  // exp(x) = 2^(k/N) * 2^(r/N) ~= s * (C0*r^3 + C1*r^2 + C2*r + 1)
+  uint64_t t = kExp2fTable[ki % kExp2fTableSize];
+  t += ki << (52 - kExp2fTableBits);
+  double s = as_double(t);
+  z = kPoly[0] * r + kPoly[1];
+  double r2 = r * r;
+  double y = kPoly[2] * r + 1;
+  y = z * r2 + y;
+  y = y * s;
+  return static_cast<float>(y);
+}
+
+} // namespace __llvm_libc
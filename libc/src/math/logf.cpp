@@ -0,0 +1,94 @@
+//===------------------- Single-precision log function --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/logf.h"
+#include "src/__support/common.h"
+#include "src/math/math_utils.h"
+
+#include <stdint.h>
+
+namespace __llvm_libc {
+
+// This is a port of the implementation in the Arm Optimized Routines, see
+// AOR_v20.02/math/logf.c. The error is at most 0.818 ULP with nearest
+// rounding.
+
+static constexpr int kLogfTableBits = 4;
+static constexpr int kLogfTableSize = 1 << kLogfTableBits;
+
+// The ith subinterval of [OFF, 2*OFF] contains z and c is near its center:
+// invc is 1/c and logc is log(c).
+struct LogfTableEntry {
+  double invc, logc;
+};
+
+static constexpr LogfTableEntry kLogfTable[kLogfTableSize] = {
+    {0x1.661ec79f8f3bep+0, -0x1.57bf7808caadep-2},
+    {0x1.571ed4aaf883dp+0, -0x1.2bef0a7c06ddbp-2},
+    {0x1.49539f0f010bp+0, -0x1.01eae7f513a67p-2},
+    {0x1.3c995b0b80385p+0, -0x1.b31d8a68224e9p-3},
+    {0x1.30d190c8864a5p+0, -0x1.6574f0ac07758p-3},
+    {0x1.25e227b0b8eap+0, -0x1.1aa2bc79c81p-3},
+    {0x1.1bb4a4a1a343fp+0, -0x1.a4e76ce8c0e5ep-4},
+    {0x1.12358f08ae5bap+0, -0x1.1973c5a611cccp-4},
+    {0x1.0953f419900a7p+0, -0x1.252f438e10c1ep-5},
+    {0x1p+0, 0x0p+0},
+    {0x1.e608cfd9a47acp-1, 0x1.aa5aa5df25984p-5},
+    {0x1.ca4b31f026aap-1, 0x1.c5e53aa362eb4p-4},
+    {0x1.b2036576afce6p-1, 0x1.526e57720db08p-3},
+    {0x1.9c2d163a1aa2dp-1, 0x1.bc2860d22477p-3},
+    {0x1.886e6037841edp-1, 0x1.1058bc8a07ee1p-2},
+    {0x1.767dcf5534862p-1, 0x1.4043057b6ee09p-2},
+};
+
+static constexpr double kLn2 = 0x1.62e42fefa39efp-1;
+// The first order coefficient is 1.
+static constexpr double kPoly[3] = {
+    -0x1.00ea348b88334p-2, 0x1.5575b0be00b6ap-2, -0x1.ffffef20a4123p-2};
+static constexpr uint32_t kOff = 0x3f330000;
+
+float LLVM_LIBC_ENTRYPOINT(logf)(float x) {
+  uint32_t ix = as_uint32_bits(x);
+  // Fix sign of zero with downward rounding when x==1.
+  if (__builtin_expect(ix == 0x3f800000, 0))
+    return 0;
+  if (__builtin_expect(ix - 0x00800000 >= 0x7f800000 - 0x00800000, 0)) {
+    // x < 0x1p-126 or inf or nan.
+    if (ix * 2 == 0)
+      return divzerof(1);
+    if (ix == 0x7f800000) // log(inf) == inf.
+      return x;
+    if ((ix & 0x80000000) || ix * 2 >= 0xff000000)
+      return invalidf(x);
+    // x is subnormal, normalize it.
+    ix = as_uint32_bits(x * 0x1p23f);
+    ix -= 23 << 23;
+  }
+
+  // x = 2^k z; where z is in range [OFF,2*OFF] and exact.
+  uint32_t tmp = ix - kOff;
+  int i = (tmp >> (23 - kLogfTableBits)) % kLogfTableSize;
+  int k = static_cast<int32_t>(tmp) >> 23; // arithmetic shift
+  uint32_t iz = ix - (tmp & 0x1ffu << 23);
+  double invc = kLogfTable[i].invc;
+  double logc = kLogfTable[i].logc;
+  double z = static_cast<double>(as_float(iz));
+
+  // log(x) = log1p(z/c-1) + log(c) + k*Ln2
+  double r = z * invc - 1;
+  double y0 = logc + static_cast<double>(k) * kLn2;
+
+  // Pipelined polynomial evaluation to approximate log1p(r).
+  double r2 = r * r;
+  double y = kPoly[1] * r + kPoly[2];
+  y = kPoly[0] * r2 + y;
+  y = y * r2 + (y0 + r);
+  return static_cast<float>(y);
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,85 @@
+//===-------- Collection of utils for implementing math functions ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_MATH_UTILS_H
+#define LLVM_LIBC_SRC_MATH_MATH_UTILS_H
+
+#include "include/errno.h"
+#include "src/errno/llvmlibc_errno.h"
+
+#include <stdint.h>
+
+namespace __llvm_libc {
+
+static inline uint32_t as_uint32_bits(float x) {
+  uint32_t bits;
+  __builtin_memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+static inline uint64_t as_uint64_bits(double x) {
+  uint64_t bits;
+  __builtin_memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+static inline float as_float(uint32_t bits) {
+  float x;
+  __builtin_memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+static inline double as_double(uint64_t bits) {
+  double x;
+  __builtin_memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+// Returns the top 12 bits (sign and exponent) of the representation of `x`,
+// as if it were a double.
+static inline uint32_t top12_bits(float x) { return as_uint32_bits(x) >> 20; }
+
+// Forces the evaluation of `x`, so that the floating point exceptions it
+// raises are not optimized away.
+template <typename T> static inline T opt_barrier(T x) {
+  volatile T y = x;
+  return y;
+}
+
+template <typename T> static inline T with_errno(T x, int err) {
+  llvmlibc_errno = err;
+  return x;
+}
+
+// Returns +/-inf with the overflow exception raised.
+static inline float oflowf(uint32_t sign) {
+  float y = opt_barrier(sign ? -0x1p97f : 0x1p97f) * 0x1p97f;
+  return with_errno(y, ERANGE);
+}
+
+// Returns +/-0 with the underflow exception raised.
+static inline float uflowf(uint32_t sign) {
+  float y = opt_barrier(sign ? -0x1p-95f : 0x1p-95f) * 0x1p-95f;
+  return with_errno(y, ERANGE);
+}
+
+// Returns +/-inf with the divide-by-zero exception raised.
+static inline float divzerof(uint32_t sign) {
+  float y = opt_barrier(sign ? -1.0f : 1.0f) / 0.0f;
+  return with_errno(y, ERANGE);
+}
+
+// Returns NaN with the invalid exception raised, unless `x` is already NaN.
+static inline float invalidf(float x) {
+  float y = (x - x) / (x - x);
+  return x != x ? y : with_errno(y, EDOM);
+}
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_MATH_UTILS_H
@@ -0,0 +1,30 @@
+//===--------------- Linux implementation of aligned_alloc ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/aligned_alloc.h"
+
+#include "include/errno.h"
+#include "src/__support/common.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdlib/linux/allocator.h"
+
+namespace __llvm_libc {
+
+void *LLVM_LIBC_ENTRYPOINT(aligned_alloc)(size_t alignment, size_t size) {
+  // The alignment must be a power of two.
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    llvmlibc_errno = EINVAL;
+    return nullptr;
+  }
+  void *ptr = internal::allocator.allocate_aligned(alignment, size);
+  if (!ptr)
+    llvmlibc_errno = ENOMEM;
+  return ptr;
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,309 @@
+//===-------------- Linux implementation of the allocator -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The allocator behind malloc, free, calloc, realloc and aligned_alloc.
+//
+// Small requests are rounded up to a power of two size class. Each size class
+// has a central free list, refilled from memory mapped in large regions, and
+// a few caches sit in front of the central lists so that most allocations and
+// deallocations don't touch shared state. Large requests are mapped and
+// unmapped directly.
+//
+// The caches are not thread local: thrd_create does not set up a TLS area for
+// the new thread yet. Instead, similarly to the shared TSD registry of the
+// scudo allocator, a thread picks a cache based on its stack address and
+// falls back to the next one if that cache is in use.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_STDLIB_LINUX_ALLOCATOR_H
+#define LLVM_LIBC_SRC_STDLIB_LINUX_ALLOCATOR_H
+
+#include "include/sys/mman.h" // For MAP_*, PROT_* and size_t.
+#include "src/sys/mman/mmap.h"
+#include "src/sys/mman/munmap.h"
+
+#include <linux/param.h> // For EXEC_PAGESIZE.
+#include <stdatomic.h>
+#include <stdint.h>
+
+namespace __llvm_libc {
+namespace internal {
+
+// A test-and-set lock. The critical sections of the allocator are short, so
+// spinning is cheaper than going through a futex.
+struct SpinLock {
+  atomic_flag flag;
+
+  bool try_lock() {
+    return !atomic_flag_test_and_set_explicit(&flag, memory_order_acquire);
+  }
+  void lock() {
+    while (!try_lock())
+      ;
+  }
+  void unlock() { atomic_flag_clear_explicit(&flag, memory_order_release); }
+};
+
+// Every chunk is preceded by a header recording how to free it.
+struct alignas(16) ChunkHeader {
+  // The size class of the chunk, or kMappedClass or kAlignedClass.
+  uint32_t class_id;
+  // For mapped chunks, the size of the mapping. For aligned chunks, the
+  // offset from the start of the underlying chunk.
+  size_t value;
+};
+
+static_assert(sizeof(ChunkHeader) == 16, "unexpected chunk header size");
+
+// A free chunk, linked through its payload.
+struct FreeChunk {
+  FreeChunk *next;
+};
+
+class Allocator {
+public:
+  // Payloads are 16-byte aligned, as required for max_align_t.
+  static constexpr size_t kMinAlignment = sizeof(ChunkHeader);
+  static constexpr size_t kMinClassSize = 16;
+  static constexpr uint32_t kNumClasses = 12;
+  static constexpr size_t kMaxClassSize = kMinClassSize << (kNumClasses - 1);
+  static constexpr uint32_t kMappedClass = kNumClasses;
+  static constexpr uint32_t kAlignedClass = kNumClasses + 1;
+
+  // The number of caches in front of the central free lists.
+  static constexpr size_t kNumCaches = 8;
+  // A cache holds at most this many chunks of each size class, and moves
+  // half of them to the central free list when it is full.
+  static constexpr uint32_t kMaxCachedChunks = 64;
+  // The minimum size of a region mapped to refill a central free list.
+  static constexpr size_t kMinRegionSize = 1 << 18;
+
+  void *allocate(size_t size) {
+    if (size > kMaxClassSize)
+      return allocate_mapped(size);
+    uint32_t class_id = get_class(size);
+    Cache &cache = lock_cache();
+    FreeChunk *chunk = cache.free_lists[class_id];
+    if (chunk) {
+      cache.free_lists[class_id] = chunk->next;
+      --cache.counts[class_id];
+    } else {
+      chunk = refill(cache, class_id);
+    }
+    cache.lock.unlock();
+    return chunk;
+  }
+
+  void deallocate(void *ptr) {
+    ChunkHeader *header = get_header(ptr);
+    if (header->class_id == kAlignedClass) {
+      ptr = reinterpret_cast<char *>(ptr) - header->value;
+      header = get_header(ptr);
+    }
+    if (header->class_id == kMappedClass) {
+      __llvm_libc::munmap(header, header->value);
+      return;
+    }
+
+    uint32_t class_id = header->class_id;
+    FreeChunk *chunk = reinterpret_cast<FreeChunk *>(ptr);
+    Cache &cache = lock_cache();
+    chunk->next = cache.free_lists[class_id];
+    cache.free_lists[class_id] = chunk;
+    if (++cache.counts[class_id] > kMaxCachedChunks)
+      drain(cache, class_id, kMaxCachedChunks / 2);
+    cache.lock.unlock();
+  }
+
+  // Returns a chunk of at least `size` bytes aligned to `alignment`, which
+  // must be a power of two.
+  void *allocate_aligned(size_t alignment, size_t size) {
+    if (alignment <= kMinAlignment)
+      return allocate(size);
+    // Leave room to move the payload up to the next multiple of `alignment`
+    // past a header.
+    if (size + alignment < size)
+      return nullptr;
+    char *ptr = reinterpret_cast<char *>(allocate(size + alignment));
+    if (!ptr)
+      return nullptr;
+    uintptr_t address = reinterpret_cast<uintptr_t>(ptr) + sizeof(ChunkHeader);
+    address = (address + alignment - 1) & ~(alignment - 1);
+    char *aligned = reinterpret_cast<char *>(address);
+    ChunkHeader *header = get_header(aligned);
+    header->class_id = kAlignedClass;
+    header->value = aligned - ptr;
+    return aligned;
+  }
+
+  // Returns the number of bytes that can be used in the chunk at `ptr`.
+  static size_t usable_size(const void *ptr) {
+    const ChunkHeader *header = get_header(ptr);
+    size_t offset = 0;
+    if (header->class_id == kAlignedClass) {
+      offset = header->value;
+      header = get_header(reinterpret_cast<const char *>(ptr) - offset);
+    }
+    if (header->class_id == kMappedClass)
+      return header->value - sizeof(ChunkHeader) - offset;
+    return get_class_size(header->class_id) - offset;
+  }
+
+  // Returns whether the chunk at `ptr` was freshly mapped, and is thus known
+  // to be zero-initialized.
+  static bool is_mapped(const void *ptr) {
+    return get_header(ptr)->class_id == kMappedClass;
+  }
+
+private:
+  struct Cache {
+    SpinLock lock;
+    FreeChunk *free_lists[kNumClasses];
+    uint32_t counts[kNumClasses];
+  };
+
+  struct CentralFreeList {
+    SpinLock lock;
+    FreeChunk *free_list;
+    // The part of the last mapped region that hasn't been handed out yet.
+    char *region_begin;
+    char *region_end;
+  };
+
+  static constexpr size_t get_class_size(uint32_t class_id) {
+    return kMinClassSize << class_id;
+  }
+
+  static uint32_t get_class(size_t size) {
+    uint32_t class_id = 0;
+    while (get_class_size(class_id) < size)
+      ++class_id;
+    return class_id;
+  }
+
+  static ChunkHeader *get_header(const void *ptr) {
+    return reinterpret_cast<ChunkHeader *>(const_cast<char *>(
+               reinterpret_cast<const char *>(ptr))) -
+           1;
+  }
+
+  static size_t round_up_to_page(size_t size) {
+    return (size + EXEC_PAGESIZE - 1) & ~size_t(EXEC_PAGESIZE - 1);
+  }
+
+  static void *map(size_t size) {
+    void *ptr = __llvm_libc::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                  MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+  }
+
+  static void *allocate_mapped(size_t size) {
+    size_t map_size = round_up_to_page(size + sizeof(ChunkHeader));
+    if (map_size < size)
+      return nullptr;
+    ChunkHeader *header = reinterpret_cast<ChunkHeader *>(map(map_size));
+    if (!header)
+      return nullptr;
+    header->class_id = kMappedClass;
+    header->value = map_size;
+    return header + 1;
+  }
+
+  // Locks and returns one of the caches. Threads start from a cache picked by
+  // hashing their stack address, so that different threads tend to use
+  // different caches.
+  Cache &lock_cache() {
+    char marker;
+    uint64_t hash = (reinterpret_cast<uintptr_t>(&marker) >> 12) *
+                    0x9E3779B97F4A7C15ULL;
+    size_t index = hash >> 61;
+    static_assert(kNumCaches == 8, "the hash above yields 3 bits");
+    for (size_t i = 0; i < kNumCaches; ++i) {
+      Cache &cache = caches[(index + i) % kNumCaches];
+      if (cache.lock.try_lock())
+        return cache;
+    }
+    Cache &cache = caches[index];
+    cache.lock.lock();
+    return cache;
+  }
+
+  // Returns a chunk of the given size class from the central free list and
+  // moves a batch of chunks from it to `cache`.
+  FreeChunk *refill(Cache &cache, uint32_t class_id) {
+    CentralFreeList &central = central_lists[class_id];
+    central.lock.lock();
+    FreeChunk *result = pop_central(central, class_id);
+    for (uint32_t i = 0; result && i < kMaxCachedChunks / 2; ++i) {
+      FreeChunk *chunk = pop_central(central, class_id);
+      if (!chunk)
+        break;
+      chunk->next = cache.free_lists[class_id];
+      cache.free_lists[class_id] = chunk;
+      ++cache.counts[class_id];
+    }
+    central.lock.unlock();
+    return result;
+  }
+
+  // Precondition: the lock of `central` is held.
+  FreeChunk *pop_central(CentralFreeList &central, uint32_t class_id) {
+    if (FreeChunk *chunk = central.free_list) {
+      central.free_list = chunk->next;
+      return chunk;
+    }
+
+    size_t chunk_size = sizeof(ChunkHeader) + get_class_size(class_id);
+    if (size_t(central.region_end - central.region_begin) < chunk_size) {
+      size_t region_size = kMinRegionSize;
+      if (region_size < 8 * chunk_size)
+        region_size = round_up_to_page(8 * chunk_size);
+      // The rest of the previous region, if any, is too small to be used for
+      // this size class and is abandoned.
+      char *region = reinterpret_cast<char *>(map(region_size));
+      if (!region)
+        return nullptr;
+      central.region_begin = region;
+      central.region_end = region + region_size;
+    }
+
+    ChunkHeader *header = reinterpret_cast<ChunkHeader *>(central.region_begin);
+    central.region_begin += chunk_size;
+    header->class_id = class_id;
+    header->value = 0;
+    return reinterpret_cast<FreeChunk *>(header + 1);
+  }
+
+  // Moves `count` chunks of the given size class from `cache` to the central
+  // free list.
+  void drain(Cache &cache, uint32_t class_id, uint32_t count) {
+    CentralFreeList &central = central_lists[class_id];
+    central.lock.lock();
+    for (uint32_t i = 0; i < count; ++i) {
+      FreeChunk *chunk = cache.free_lists[class_id];
+      cache.free_lists[class_id] = chunk->next;
+      chunk->next = central.free_list;
+      central.free_list = chunk;
+    }
+    cache.counts[class_id] -= count;
+    central.lock.unlock();
+  }
+
+  Cache caches[kNumCaches];
+  CentralFreeList central_lists[kNumClasses];
+};
+
+// The allocator is zero-initialized, so it is usable before any constructor
+// runs. Being an inline variable, all the entrypoints share a single instance.
+inline Allocator allocator;
+
+} // namespace internal
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_STDLIB_LINUX_ALLOCATOR_H
@@ -0,0 +1,21 @@
+//===-------------------- Linux implementation of free --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/free.h"
+
+#include "src/__support/common.h"
+#include "src/stdlib/linux/allocator.h"
+
+namespace __llvm_libc {
+
+void LLVM_LIBC_ENTRYPOINT(free)(void *ptr) {
+  if (ptr)
+    internal::allocator.deallocate(ptr);
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,25 @@
+//===------------------- Linux implementation of malloc -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/malloc.h"
+
+#include "include/errno.h"
+#include "src/__support/common.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdlib/linux/allocator.h"
+
+namespace __llvm_libc {
+
+void *LLVM_LIBC_ENTRYPOINT(malloc)(size_t size) {
+  void *ptr = internal::allocator.allocate(size);
+  if (!ptr)
+    llvmlibc_errno = ENOMEM;
+  return ptr;
+}
+
+} // namespace __llvm_libc
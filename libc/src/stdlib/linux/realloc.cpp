@@ -0,0 +1,44 @@
+//===------------------ Linux implementation of realloc -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/realloc.h"
+
+#include "include/errno.h"
+#include "src/__support/common.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdlib/linux/allocator.h"
+#include "src/string/memcpy.h"
+
+namespace __llvm_libc {
+
+void *LLVM_LIBC_ENTRYPOINT(realloc)(void *ptr, size_t size) {
+  if (!ptr) {
+    ptr = internal::allocator.allocate(size);
+    if (!ptr)
+      llvmlibc_errno = ENOMEM;
+    return ptr;
+  }
+  if (size == 0) {
+    internal::allocator.deallocate(ptr);
+    return nullptr;
+  }
+
+  size_t old_size = internal::Allocator::usable_size(ptr);
+  if (size <= old_size)
+    return ptr;
+  void *new_ptr = internal::allocator.allocate(size);
+  if (!new_ptr) {
+    llvmlibc_errno = ENOMEM;
+    return nullptr;
+  }
+  __llvm_libc::memcpy(new_ptr, ptr, old_size);
+  internal::allocator.deallocate(ptr);
+  return new_ptr;
+}
+
+} // namespace __llvm_libc
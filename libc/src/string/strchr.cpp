@@ -0,0 +1,21 @@
+//===---------------------- Implementation of strchr ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strchr.h"
+#include "src/string/string_utils.h"
+
+#include "src/__support/common.h"
+
+namespace __llvm_libc {
+
+char *LLVM_LIBC_ENTRYPOINT(strchr)(const char *src, int c) {
+  return const_cast<char *>(
+      internal::find_first_character(src, static_cast<char>(c)));
+}
+
+} // namespace __llvm_libc
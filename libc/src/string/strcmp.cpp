@@ -0,0 +1,38 @@
+//===---------------------- Implementation of strcmp ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strcmp.h"
+#include "src/string/string_utils.h"
+
+#include "src/__support/common.h"
+
+namespace __llvm_libc {
+
+int LLVM_LIBC_ENTRYPOINT(strcmp)(const char *left, const char *right) {
+  // If both strings are at the same offset from a word boundary, we can
+  // compare them one word at a time once the first word boundary is reached.
+  if (internal::have_same_word_alignment(left, right)) {
+    while (!internal::is_word_aligned(left) && *left != '\0' &&
+           *left == *right) {
+      ++left;
+      ++right;
+    }
+    if (internal::is_word_aligned(left)) {
+      while (internal::load_word(left) == internal::load_word(right) &&
+             !internal::has_zero_byte(internal::load_word(left))) {
+        left += sizeof(internal::Word);
+        right += sizeof(internal::Word);
+      }
+    }
+  }
+  for (; *left != '\0' && *left == *right; ++left, ++right)
+    ;
+  return static_cast<unsigned char>(*left) - static_cast<unsigned char>(*right);
+}
+
+} // namespace __llvm_libc
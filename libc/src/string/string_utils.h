@@ -0,0 +1,99 @@
+//===-------------------------- String utils ------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Helpers to scan strings one word at a time.
+//
+// Reads are done one aligned word at a time. An aligned word never straddles
+// a page boundary, so reading the bytes that follow the end of a string within
+// the same word can't fault, even though they are not part of the string.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_STRING_STRING_UTILS_H
+#define LLVM_LIBC_SRC_STRING_STRING_UTILS_H
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uintptr_t
+
+namespace __llvm_libc {
+namespace internal {
+
+using Word = uintptr_t;
+
+// Returns a Word with all bytes set to `value`.
+static constexpr Word repeat_byte(unsigned char value) {
+  return (~Word(0) / 0xff) * value;
+}
+
+// Returns a non zero value iff one of the bytes of `word` is zero.
+static constexpr Word has_zero_byte(Word word) {
+  return (word - repeat_byte(0x01)) & ~word & repeat_byte(0x80);
+}
+
+// Returns whether `ptr` is aligned to a Word.
+static inline bool is_word_aligned(const char *ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % sizeof(Word) == 0;
+}
+
+// Returns whether `a` and `b` are at the same offset from a Word boundary.
+static inline bool have_same_word_alignment(const char *a, const char *b) {
+  return (reinterpret_cast<uintptr_t>(a) ^ reinterpret_cast<uintptr_t>(b)) %
+             sizeof(Word) ==
+         0;
+}
+
+// Loads the Word at `ptr`.
+// Precondition: `ptr` is aligned to a Word.
+static inline Word load_word(const char *ptr) {
+  Word word;
+  __builtin_memcpy(&word, ptr, sizeof(Word));
+  return word;
+}
+
+// Returns the length of the null terminated string `src`.
+static inline size_t string_length(const char *src) {
+  const char *ptr = src;
+  for (; !is_word_aligned(ptr); ++ptr)
+    if (*ptr == '\0')
+      return ptr - src;
+  while (!has_zero_byte(load_word(ptr)))
+    ptr += sizeof(Word);
+  while (*ptr != '\0')
+    ++ptr;
+  return ptr - src;
+}
+
+// Returns a pointer to the first occurrence of `ch` in the null terminated
+// string `src`, or nullptr if there is none. If `ch` is '\0' the result points
+// to the terminator.
+static inline const char *find_first_character(const char *src, char ch) {
+  const char *ptr = src;
+  for (; !is_word_aligned(ptr); ++ptr) {
+    if (*ptr == ch)
+      return ptr;
+    if (*ptr == '\0')
+      return nullptr;
+  }
+  const Word pattern = repeat_byte(static_cast<unsigned char>(ch));
+  for (;; ptr += sizeof(Word)) {
+    const Word word = load_word(ptr);
+    if (has_zero_byte(word) | has_zero_byte(word ^ pattern))
+      break;
+  }
+  for (;; ++ptr) {
+    if (*ptr == ch)
+      return ptr;
+    if (*ptr == '\0')
+      return nullptr;
+  }
+}
+
+} // namespace internal
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_STRING_STRING_UTILS_H
@@ -0,0 +1,27 @@
+//===--------------------- Implementation of strncmp ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strncmp.h"
+
+#include "src/__support/common.h"
+
+namespace __llvm_libc {
+
+int LLVM_LIBC_ENTRYPOINT(strncmp)(const char *left, const char *right,
+                                   size_t n) {
+  for (; n != 0; --n, ++left, ++right) {
+    if (*left != *right)
+      return static_cast<unsigned char>(*left) -
+             static_cast<unsigned char>(*right);
+    if (*left == '\0')
+      return 0;
+  }
+  return 0;
+}
+
+} // namespace __llvm_libc
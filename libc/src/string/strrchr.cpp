@@ -0,0 +1,26 @@
+//===--------------------- Implementation of strrchr ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strrchr.h"
+
+#include "src/__support/common.h"
+
+namespace __llvm_libc {
+
+char *LLVM_LIBC_ENTRYPOINT(strrchr)(const char *src, int c) {
+  const char ch = static_cast<char>(c);
+  const char *last = nullptr;
+  for (;; ++src) {
+    if (*src == ch)
+      last = src;
+    if (*src == '\0')
+      return const_cast<char *>(last);
+  }
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,62 @@
+//===------------------------- Unittests for expf -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/math/expf.h"
+#include "src/math/math_utils.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stdint.h>
+
+using __llvm_libc::as_float;
+using __llvm_libc::as_uint32_bits;
+
+static bool isNaN(float x) { return x != x; }
+
+// Returns the distance in ULPs between two finite floats of the same sign.
+static uint32_t ulpDistance(float a, float b) {
+  uint32_t x = as_uint32_bits(a), y = as_uint32_bits(b);
+  return x > y ? x - y : y - x;
+}
+
+TEST(ExpfTest, SpecialNumbers) {
+  llvmlibc_errno = 0;
+  float nan = as_float(0x7fc00000);
+  EXPECT_TRUE(isNaN(__llvm_libc::expf(nan)));
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::expf(as_float(0x7f800000))),
+            0x7f800000U);
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::expf(as_float(0xff800000))), 0U);
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::expf(0.0f)), as_uint32_bits(1.0f));
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::expf(-0.0f)), as_uint32_bits(1.0f));
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
+
+TEST(ExpfTest, Overflow) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::expf(0x1.63p6f)), 0x7f800000U);
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+}
+
+TEST(ExpfTest, Underflow) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::expf(-0x1.a0p6f)), 0U);
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+}
+
+TEST(ExpfTest, InFloatRange) {
+  constexpr uint32_t count = 1000000;
+  constexpr uint32_t step = UINT32_MAX / count;
+  for (uint32_t i = 0, v = 0; i <= count; ++i, v += step) {
+    float x = as_float(v);
+    if (isNaN(x) || x > 88.0f || x < -87.0f)
+      continue;
+    float expected = static_cast<float>(__builtin_exp(static_cast<double>(x)));
+    ASSERT_LE(ulpDistance(__llvm_libc::expf(x), expected), 1U);
+  }
+}
@@ -0,0 +1,63 @@
+//===------------------------- Unittests for logf -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/math/logf.h"
+#include "src/math/math_utils.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stdint.h>
+
+using __llvm_libc::as_float;
+using __llvm_libc::as_uint32_bits;
+
+static bool isNaN(float x) { return x != x; }
+
+// Returns the distance in ULPs between two finite floats of the same sign.
+static uint32_t ulpDistance(float a, float b) {
+  uint32_t x = as_uint32_bits(a), y = as_uint32_bits(b);
+  return x > y ? x - y : y - x;
+}
+
+TEST(LogfTest, SpecialNumbers) {
+  llvmlibc_errno = 0;
+  float nan = as_float(0x7fc00000);
+  EXPECT_TRUE(isNaN(__llvm_libc::logf(nan)));
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::logf(as_float(0x7f800000))),
+            0x7f800000U);
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::logf(1.0f)), 0U);
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
+
+TEST(LogfTest, Zero) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::logf(0.0f)), 0xff800000U);
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+  llvmlibc_errno = 0;
+  EXPECT_EQ(as_uint32_bits(__llvm_libc::logf(-0.0f)), 0xff800000U);
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+}
+
+TEST(LogfTest, Negative) {
+  llvmlibc_errno = 0;
+  float result = __llvm_libc::logf(-1.0f);
+  EXPECT_TRUE(isNaN(result));
+  EXPECT_EQ(llvmlibc_errno, EDOM);
+}
+
+TEST(LogfTest, InFloatRange) {
+  constexpr uint32_t count = 1000000;
+  constexpr uint32_t step = 0x7f800000 / count;
+  // All positive finite numbers, including subnormals.
+  for (uint32_t i = 1, v = step; i < count; ++i, v += step) {
+    float x = as_float(v);
+    float expected = static_cast<float>(__builtin_log(static_cast<double>(x)));
+    ASSERT_LE(ulpDistance(__llvm_libc::logf(x), expected), 1U);
+  }
+}
@@ -0,0 +1,166 @@
+//===------------------- Unittests for the allocator ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "include/threads.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdlib/aligned_alloc.h"
+#include "src/stdlib/calloc.h"
+#include "src/stdlib/free.h"
+#include "src/stdlib/malloc.h"
+#include "src/stdlib/realloc.h"
+#include "src/threads/thrd_create.h"
+#include "src/threads/thrd_join.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stdint.h>
+
+static bool isAligned(const void *ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(MallocTest, AllocateAndFree) {
+  for (size_t size = 0; size <= (1 << 20); size = size ? size * 2 : 1) {
+    for (size_t delta = 0; delta < 3; ++delta) {
+      char *ptr = reinterpret_cast<char *>(__llvm_libc::malloc(size + delta));
+      ASSERT_NE(ptr, (char *)nullptr);
+      ASSERT_TRUE(isAligned(ptr, 16));
+      for (size_t i = 0; i < size + delta; ++i)
+        ptr[i] = char(i);
+      for (size_t i = 0; i < size + delta; ++i)
+        ASSERT_EQ(ptr[i], char(i));
+      __llvm_libc::free(ptr);
+    }
+  }
+  __llvm_libc::free(nullptr);
+}
+
+TEST(MallocTest, ChunksDoNotOverlap) {
+  constexpr size_t count = 1000;
+  char *ptrs[count];
+  for (size_t i = 0; i < count; ++i) {
+    size_t size = 1 + i % 200;
+    ptrs[i] = reinterpret_cast<char *>(__llvm_libc::malloc(size));
+    ASSERT_NE(ptrs[i], (char *)nullptr);
+    for (size_t j = 0; j < size; ++j)
+      ptrs[i][j] = char(i);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t j = 0, size = 1 + i % 200; j < size; ++j)
+      ASSERT_EQ(ptrs[i][j], char(i));
+    __llvm_libc::free(ptrs[i]);
+  }
+}
+
+TEST(MallocTest, TooLarge) {
+  llvmlibc_errno = 0;
+  ASSERT_EQ(__llvm_libc::malloc(~size_t(0)), (void *)nullptr);
+  ASSERT_EQ(llvmlibc_errno, ENOMEM);
+}
+
+TEST(CallocTest, ZeroInitialized) {
+  static const size_t sizes[] = {1, 100, 4096, 100000};
+  for (size_t size : sizes) {
+    // Dirty some memory first so that calloc is likely to reuse it.
+    char *dirty = reinterpret_cast<char *>(__llvm_libc::malloc(size));
+    for (size_t i = 0; i < size; ++i)
+      dirty[i] = 'x';
+    __llvm_libc::free(dirty);
+
+    char *ptr = reinterpret_cast<char *>(__llvm_libc::calloc(size, 1));
+    ASSERT_NE(ptr, (char *)nullptr);
+    for (size_t i = 0; i < size; ++i)
+      ASSERT_EQ(ptr[i], '\0');
+    __llvm_libc::free(ptr);
+  }
+}
+
+TEST(CallocTest, Overflow) {
+  llvmlibc_errno = 0;
+  ASSERT_EQ(__llvm_libc::calloc(~size_t(0) / 2, 3), (void *)nullptr);
+  ASSERT_EQ(llvmlibc_errno, ENOMEM);
+}
+
+TEST(ReallocTest, PreservesContents) {
+  char *ptr = reinterpret_cast<char *>(__llvm_libc::realloc(nullptr, 10));
+  ASSERT_NE(ptr, (char *)nullptr);
+  for (size_t i = 0; i < 10; ++i)
+    ptr[i] = char(i);
+  for (size_t size = 20; size <= (1 << 18); size *= 3) {
+    ptr = reinterpret_cast<char *>(__llvm_libc::realloc(ptr, size));
+    ASSERT_NE(ptr, (char *)nullptr);
+    for (size_t i = 0; i < 10; ++i)
+      ASSERT_EQ(ptr[i], char(i));
+  }
+  ptr = reinterpret_cast<char *>(__llvm_libc::realloc(ptr, 5));
+  ASSERT_NE(ptr, (char *)nullptr);
+  for (size_t i = 0; i < 5; ++i)
+    ASSERT_EQ(ptr[i], char(i));
+  ASSERT_EQ(__llvm_libc::realloc(ptr, 0), (void *)nullptr);
+}
+
+TEST(AlignedAllocTest, Alignments) {
+  for (size_t alignment = 1; alignment <= (1 << 16); alignment *= 2) {
+    static const size_t sizes[] = {1, 100, 10000, 200000};
+    for (size_t size : sizes) {
+      char *ptr =
+          reinterpret_cast<char *>(__llvm_libc::aligned_alloc(alignment, size));
+      ASSERT_NE(ptr, (char *)nullptr);
+      ASSERT_TRUE(isAligned(ptr, alignment));
+      for (size_t i = 0; i < size; ++i)
+        ptr[i] = 'a';
+      ptr = reinterpret_cast<char *>(__llvm_libc::realloc(ptr, size * 2));
+      ASSERT_NE(ptr, (char *)nullptr);
+      for (size_t i = 0; i < size; ++i)
+        ASSERT_EQ(ptr[i], 'a');
+      __llvm_libc::free(ptr);
+    }
+  }
+}
+
+TEST(AlignedAllocTest, InvalidAlignment) {
+  llvmlibc_errno = 0;
+  ASSERT_EQ(__llvm_libc::aligned_alloc(3, 16), (void *)nullptr);
+  ASSERT_EQ(llvmlibc_errno, EINVAL);
+}
+
+static int allocateAndFree(void *arg) {
+  uintptr_t seed = reinterpret_cast<uintptr_t>(arg);
+  constexpr size_t count = 64;
+  char *ptrs[count] = {};
+  for (size_t round = 0; round < 2000; ++round) {
+    size_t i = (seed + round * 7) % count;
+    if (ptrs[i]) {
+      if (ptrs[i][0] != char(i))
+        return 1;
+      __llvm_libc::free(ptrs[i]);
+    }
+    ptrs[i] = reinterpret_cast<char *>(
+        __llvm_libc::malloc(1 + (seed * 31 + round) % 512));
+    if (!ptrs[i])
+      return 1;
+    ptrs[i][0] = char(i);
+  }
+  for (size_t i = 0; i < count; ++i)
+    __llvm_libc::free(ptrs[i]);
+  return 0;
+}
+
+TEST(MallocTest, MultipleThreads) {
+  constexpr size_t thread_count = 16;
+  thrd_t threads[thread_count];
+  for (size_t i = 0; i < thread_count; ++i)
+    ASSERT_EQ(__llvm_libc::thrd_create(&threads[i], allocateAndFree,
+                                       reinterpret_cast<void *>(i)),
+              (int)thrd_success);
+  for (size_t i = 0; i < thread_count; ++i) {
+    int retval = -1;
+    ASSERT_EQ(__llvm_libc::thrd_join(&threads[i], &retval), (int)thrd_success);
+    ASSERT_EQ(retval, 0);
+  }
+}
@@ -0,0 +1,53 @@
+//===------------------------ Unittests for strchr ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strchr.h"
+#include "utils/UnitTest/Test.h"
+
+TEST(StrChrTest, FindsFirstCharacter) {
+  char src[] = "abcdcba";
+  ASSERT_EQ(__llvm_libc::strchr(src, 'a'), src);
+  ASSERT_EQ(__llvm_libc::strchr(src, 'c'), src + 2);
+  ASSERT_EQ(__llvm_libc::strchr(src, 'd'), src + 3);
+}
+
+TEST(StrChrTest, CharacterNotFound) {
+  char src[] = "abcd";
+  ASSERT_EQ(__llvm_libc::strchr(src, 'e'), (char *)nullptr);
+  ASSERT_EQ(__llvm_libc::strchr("", 'a'), (char *)nullptr);
+}
+
+TEST(StrChrTest, FindsTerminator) {
+  char src[] = "abcd";
+  ASSERT_EQ(__llvm_libc::strchr(src, '\0'), src + 4);
+}
+
+TEST(StrChrTest, ConvertsToChar) {
+  char src[] = {'a', '\xff', '\0'};
+  ASSERT_EQ(__llvm_libc::strchr(src, 0xff), src + 1);
+  ASSERT_EQ(__llvm_libc::strchr(src, 'a' + 256), src);
+}
+
+TEST(StrChrTest, AllPositionsAndAlignments) {
+  char buffer[128];
+  for (size_t align = 0; align < 16; ++align) {
+    for (size_t length = 0; length < 100; ++length) {
+      char *const src = buffer + align;
+      for (size_t i = 0; i < length; ++i)
+        src[i] = 'a';
+      src[length] = '\0';
+      ASSERT_EQ(__llvm_libc::strchr(src, 'b'), (char *)nullptr);
+      ASSERT_EQ(__llvm_libc::strchr(src, '\0'), src + length);
+      for (size_t i = 0; i < length; ++i) {
+        src[i] = 'b';
+        ASSERT_EQ(__llvm_libc::strchr(src, 'b'), src + i);
+        src[i] = 'a';
+      }
+    }
+  }
+}
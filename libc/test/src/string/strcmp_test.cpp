@@ -0,0 +1,50 @@
+//===------------------------ Unittests for strcmp ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strcmp.h"
+#include "utils/UnitTest/Test.h"
+
+TEST(StrCmpTest, EqualStrings) {
+  ASSERT_EQ(__llvm_libc::strcmp("", ""), 0);
+  ASSERT_EQ(__llvm_libc::strcmp("abc", "abc"), 0);
+}
+
+TEST(StrCmpTest, DifferentStrings) {
+  ASSERT_LT(__llvm_libc::strcmp("abc", "abd"), 0);
+  ASSERT_GT(__llvm_libc::strcmp("abd", "abc"), 0);
+  ASSERT_LT(__llvm_libc::strcmp("ab", "abc"), 0);
+  ASSERT_GT(__llvm_libc::strcmp("abc", "ab"), 0);
+}
+
+TEST(StrCmpTest, ComparesAsUnsignedChar) {
+  ASSERT_GT(__llvm_libc::strcmp("\xff", "a"), 0);
+  ASSERT_LT(__llvm_libc::strcmp("a", "\xff"), 0);
+}
+
+TEST(StrCmpTest, AllPositionsAndAlignments) {
+  char left_buffer[128];
+  char right_buffer[128];
+  for (size_t left_align = 0; left_align < 16; ++left_align) {
+    for (size_t right_align = 0; right_align < 16; ++right_align) {
+      for (size_t length = 0; length < 40; ++length) {
+        char *const left = left_buffer + left_align;
+        char *const right = right_buffer + right_align;
+        for (size_t i = 0; i < length; ++i)
+          left[i] = right[i] = 'a' + i % 26;
+        left[length] = right[length] = '\0';
+        ASSERT_EQ(__llvm_libc::strcmp(left, right), 0);
+        for (size_t i = 0; i < length; ++i) {
+          right[i] = 'z' + 1;
+          ASSERT_LT(__llvm_libc::strcmp(left, right), 0);
+          ASSERT_GT(__llvm_libc::strcmp(right, left), 0);
+          right[i] = left[i];
+        }
+      }
+    }
+  }
+}
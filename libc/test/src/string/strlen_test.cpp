@@ -22,3 +22,16 @@ TEST(StrLenTest, AnyString) {
   size_t result = __llvm_libc::strlen(any);
   ASSERT_EQ((size_t)12, result);
 }
+
+TEST(StrLenTest, AllLengthsAndAlignments) {
+  char buffer[128];
+  for (size_t align = 0; align < 16; ++align) {
+    for (size_t length = 0; length < 100; ++length) {
+      char *const src = buffer + align;
+      for (size_t i = 0; i < length; ++i)
+        src[i] = '\x80' + i;
+      src[length] = '\0';
+      ASSERT_EQ(length, __llvm_libc::strlen(src));
+    }
+  }
+}
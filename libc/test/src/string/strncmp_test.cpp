@@ -0,0 +1,33 @@
+//===----------------------- Unittests for strncmp ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strncmp.h"
+#include "utils/UnitTest/Test.h"
+
+TEST(StrNCmpTest, EqualStrings) {
+  ASSERT_EQ(__llvm_libc::strncmp("", "", 1), 0);
+  ASSERT_EQ(__llvm_libc::strncmp("abc", "abc", 3), 0);
+  ASSERT_EQ(__llvm_libc::strncmp("abc", "abc", 10), 0);
+}
+
+TEST(StrNCmpTest, DifferenceAfterCount) {
+  ASSERT_EQ(__llvm_libc::strncmp("abc", "abd", 2), 0);
+  ASSERT_EQ(__llvm_libc::strncmp("abc", "xyz", 0), 0);
+}
+
+TEST(StrNCmpTest, DifferentStrings) {
+  ASSERT_LT(__llvm_libc::strncmp("abc", "abd", 3), 0);
+  ASSERT_GT(__llvm_libc::strncmp("abd", "abc", 3), 0);
+  ASSERT_LT(__llvm_libc::strncmp("ab", "abc", 3), 0);
+  ASSERT_GT(__llvm_libc::strncmp("abc", "ab", 3), 0);
+}
+
+TEST(StrNCmpTest, ComparesAsUnsignedChar) {
+  ASSERT_GT(__llvm_libc::strncmp("\xff", "a", 1), 0);
+  ASSERT_LT(__llvm_libc::strncmp("a", "\xff", 1), 0);
+}
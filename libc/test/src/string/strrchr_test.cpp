@@ -0,0 +1,28 @@
+//===----------------------- Unittests for strrchr ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/strrchr.h"
+#include "utils/UnitTest/Test.h"
+
+TEST(StrRChrTest, FindsLastCharacter) {
+  char src[] = "abcdcba";
+  ASSERT_EQ(__llvm_libc::strrchr(src, 'a'), src + 6);
+  ASSERT_EQ(__llvm_libc::strrchr(src, 'c'), src + 4);
+  ASSERT_EQ(__llvm_libc::strrchr(src, 'd'), src + 3);
+}
+
+TEST(StrRChrTest, CharacterNotFound) {
+  char src[] = "abcd";
+  ASSERT_EQ(__llvm_libc::strrchr(src, 'e'), (char *)nullptr);
+  ASSERT_EQ(__llvm_libc::strrchr("", 'a'), (char *)nullptr);
+}
+
+TEST(StrRChrTest, FindsTerminator) {
+  char src[] = "abcd";
+  ASSERT_EQ(__llvm_libc::strrchr(src, '\0'), src + 4);
+}
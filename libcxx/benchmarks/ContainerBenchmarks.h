@@ -135,6 +135,22 @@ static void BM_FindRehash(benchmark::State& st, Container c, GenInputs gen) {
     }
 }
 
+template <class Container, class GenInputs>
+static void BM_Erase(benchmark::State& st, Container c, GenInputs gen) {
+    auto in = gen(st.range(0));
+    const auto end = in.data() + in.size();
+    while (st.KeepRunning()) {
+        st.PauseTiming();
+        c.insert(in.begin(), in.end());
+        benchmark::DoNotOptimize(&(*c.begin()));
+        st.ResumeTiming();
+        for (auto it = in.data(); it != end; ++it) {
+            benchmark::DoNotOptimize(c.erase(*it));
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
 } // end namespace ContainerBenchmarks
 
 #endif // BENCHMARK_CONTAINER_BENCHMARKS_H
@@ -14,14 +14,19 @@
 
 namespace {
 
-enum class ValueType { Uint32, String };
-struct AllValueTypes : EnumValuesAsTuple<AllValueTypes, ValueType, 2> {
-  static constexpr const char* Names[] = {"uint32", "string"};
+enum class ValueType { Uint32, Uint64, Pair, String };
+struct AllValueTypes : EnumValuesAsTuple<AllValueTypes, ValueType, 4> {
+  static constexpr const char* Names[] = {"uint32", "uint64", "pair",
+                                          "string"};
 };
 
 template <class V>
-using Value =
-    std::conditional_t<V() == ValueType::Uint32, uint32_t, std::string>;
+using Value = std::conditional_t<
+    V() == ValueType::Uint32, uint32_t,
+    std::conditional_t<
+        V() == ValueType::Uint64, uint64_t,
+        std::conditional_t<V() == ValueType::Pair,
+                           std::pair<uint32_t, uint32_t>, std::string> > >;
 
 enum class Order {
   Random,
@@ -37,7 +42,8 @@ struct AllOrders : EnumValuesAsTuple<AllOrders, Order, 6> {
                                           "PipeOrgan",  "Heap"};
 };
 
-void fillValues(std::vector<uint32_t>& V, size_t N, Order O) {
+template <class IntT>
+void fillValues(std::vector<IntT>& V, size_t N, Order O) {
   if (O == Order::SingleElement) {
     V.resize(N, 0);
   } else {
@@ -46,6 +52,17 @@ void fillValues(std::vector<uint32_t>& V, size_t N, Order O) {
   }
 }
 
+void fillValues(std::vector<std::pair<uint32_t, uint32_t> >& V, size_t N,
+                Order O) {
+  if (O == Order::SingleElement) {
+    V.resize(N, {0, 0});
+  } else {
+    // Make the first members repeat, so that the second ones matter.
+    while (V.size() < N)
+      V.push_back({V.size() / 16, V.size()});
+  }
+}
+
 void fillValues(std::vector<std::string>& V, size_t N, Order O) {
 
   if (O == Order::SingleElement) {
@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+constexpr size_t kValues = 1 << 12;
+
+template <class T>
+std::vector<T> getValues() {
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<T> mantissa(1, 10);
+  std::uniform_int_distribution<int> exponent(-30, 30);
+  std::vector<T> values;
+  for (size_t i = 0; i < kValues; ++i)
+    values.push_back(mantissa(rng) * std::pow(T(10), T(exponent(rng))));
+  return values;
+}
+
+std::vector<std::string> getStrings() {
+  std::vector<std::string> strings;
+  for (double value : getValues<double>()) {
+    char buf[64];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value);
+    strings.emplace_back(buf, r.ptr);
+  }
+  return strings;
+}
+
+template <class T>
+void BM_ToCharsShortest(benchmark::State& st) {
+  std::vector<T> values = getValues<T>();
+  char buf[64];
+  size_t i = 0;
+  for (auto _ : st) {
+    std::to_chars_result r =
+        std::to_chars(buf, buf + sizeof(buf), values[i++ % kValues]);
+    benchmark::DoNotOptimize(r.ptr);
+  }
+}
+BENCHMARK_TEMPLATE(BM_ToCharsShortest, float);
+BENCHMARK_TEMPLATE(BM_ToCharsShortest, double);
+
+// The closest printf equivalent of the shortest round-trip format is printing
+// all the digits that might be needed.
+template <class T>
+void BM_SnprintfRoundTrip(benchmark::State& st) {
+  std::vector<T> values = getValues<T>();
+  char buf[64];
+  size_t i = 0;
+  for (auto _ : st) {
+    int n = std::snprintf(buf, sizeof(buf), "%.*g",
+                          std::numeric_limits<T>::max_digits10,
+                          values[i++ % kValues]);
+    benchmark::DoNotOptimize(n);
+  }
+}
+BENCHMARK_TEMPLATE(BM_SnprintfRoundTrip, float);
+BENCHMARK_TEMPLATE(BM_SnprintfRoundTrip, double);
+
+void BM_ToCharsPrecision(benchmark::State& st) {
+  std::vector<double> values = getValues<double>();
+  std::chars_format fmt = static_cast<std::chars_format>(st.range(0));
+  char buf[128];
+  size_t i = 0;
+  for (auto _ : st) {
+    std::to_chars_result r = std::to_chars(
+        buf, buf + sizeof(buf), values[i++ % kValues], fmt, st.range(1));
+    benchmark::DoNotOptimize(r.ptr);
+  }
+}
+
+void BM_SnprintfPrecision(benchmark::State& st) {
+  std::vector<double> values = getValues<double>();
+  const char* fmt =
+      static_cast<std::chars_format>(st.range(0)) == std::chars_format::fixed
+          ? "%.*f"
+          : "%.*e";
+  char buf[128];
+  size_t i = 0;
+  for (auto _ : st) {
+    int n = std::snprintf(buf, sizeof(buf), fmt, static_cast<int>(st.range(1)),
+                          values[i++ % kValues]);
+    benchmark::DoNotOptimize(n);
+  }
+}
+
+void precisionArgs(benchmark::internal::Benchmark* b) {
+  for (std::chars_format fmt :
+       {std::chars_format::fixed, std::chars_format::scientific})
+    for (int precision : {2, 6, 17})
+      b->Args({static_cast<int>(fmt), precision});
+}
+BENCHMARK(BM_ToCharsPrecision)->Apply(precisionArgs);
+BENCHMARK(BM_SnprintfPrecision)->Apply(precisionArgs);
+
+void BM_FromChars(benchmark::State& st) {
+  std::vector<std::string> strings = getStrings();
+  size_t i = 0;
+  for (auto _ : st) {
+    const std::string& s = strings[i++ % kValues];
+    double value;
+    std::from_chars(s.data(), s.data() + s.size(), value);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_FromChars);
+
+void BM_Strtod(benchmark::State& st) {
+  std::vector<std::string> strings = getStrings();
+  size_t i = 0;
+  for (auto _ : st) {
+    double value = std::strtod(strings[i++ % kValues].c_str(), nullptr);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_Strtod);
+
+template <class T>
+std::vector<T> getIntegers() {
+  std::mt19937_64 rng(42);
+  // Spread the values over all the digit counts instead of having almost
+  // all of them as long as possible.
+  std::uniform_int_distribution<int> bits(0, std::numeric_limits<T>::digits);
+  std::vector<T> values;
+  for (size_t i = 0; i < kValues; ++i) {
+    int n = bits(rng);
+    values.push_back(n == 0 ? T(0) : static_cast<T>(rng() >> (64 - n)));
+  }
+  return values;
+}
+
+template <class T>
+void BM_ToCharsInt(benchmark::State& st) {
+  std::vector<T> values = getIntegers<T>();
+  const int base = st.range(0);
+  char buf[72];
+  size_t i = 0;
+  for (auto _ : st) {
+    std::to_chars_result r =
+        std::to_chars(buf, buf + sizeof(buf), values[i++ % kValues], base);
+    benchmark::DoNotOptimize(r.ptr);
+  }
+}
+BENCHMARK_TEMPLATE(BM_ToCharsInt, uint32_t)->Arg(10)->Arg(16);
+BENCHMARK_TEMPLATE(BM_ToCharsInt, uint64_t)->Arg(10)->Arg(16);
+
+void BM_SnprintfInt(benchmark::State& st) {
+  std::vector<uint64_t> values = getIntegers<uint64_t>();
+  const char* fmt = st.range(0) == 16 ? "%llx" : "%llu";
+  char buf[72];
+  size_t i = 0;
+  for (auto _ : st) {
+    unsigned long long value = values[i++ % kValues];
+    int n = std::snprintf(buf, sizeof(buf), fmt, value);
+    benchmark::DoNotOptimize(n);
+  }
+}
+BENCHMARK(BM_SnprintfInt)->Arg(10)->Arg(16);
+
+std::vector<std::string> getIntegerStrings(int base) {
+  std::vector<std::string> strings;
+  for (uint64_t value : getIntegers<uint64_t>()) {
+    char buf[72];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value, base);
+    strings.emplace_back(buf, r.ptr);
+  }
+  return strings;
+}
+
+void BM_FromCharsInt(benchmark::State& st) {
+  const int base = st.range(0);
+  std::vector<std::string> strings = getIntegerStrings(base);
+  size_t i = 0;
+  for (auto _ : st) {
+    const std::string& s = strings[i++ % kValues];
+    uint64_t value;
+    std::from_chars(s.data(), s.data() + s.size(), value, base);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_FromCharsInt)->Arg(10)->Arg(16);
+
+void BM_Strtoull(benchmark::State& st) {
+  const int base = st.range(0);
+  std::vector<std::string> strings = getIntegerStrings(base);
+  size_t i = 0;
+  for (auto _ : st) {
+    unsigned long long value =
+        std::strtoull(strings[i++ % kValues].c_str(), nullptr, base);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_Strtoull)->Arg(10)->Arg(16);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -10,6 +10,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "CartesianBenchmarks.h"
 #include "benchmark/benchmark.h"
@@ -24,17 +25,19 @@ enum class FunctionType {
   MemberPointer,
   SmallTrivialFunctor,
   SmallNonTrivialFunctor,
+  MediumTrivialFunctor,
   LargeTrivialFunctor,
   LargeNonTrivialFunctor
 };
 
-struct AllFunctionTypes : EnumValuesAsTuple<AllFunctionTypes, FunctionType, 8> {
+struct AllFunctionTypes : EnumValuesAsTuple<AllFunctionTypes, FunctionType, 9> {
   static constexpr const char* Names[] = {"Null",
                                           "FuncPtr",
                                           "MemFuncPtr",
                                           "MemPtr",
                                           "SmallTrivialFunctor",
                                           "SmallNonTrivialFunctor",
+                                          "MediumTrivialFunctor",
                                           "LargeTrivialFunctor",
                                           "LargeNonTrivialFunctor"};
 };
@@ -61,6 +64,15 @@ struct SmallNonTrivialFunctor {
   ~SmallNonTrivialFunctor() {}
   int operator()(const S*) const { return 0; }
 };
+// The size of a lambda capturing a few pointers, which only fits in the buffer
+// when _LIBCPP_ABI_FUNCTION_BUFFER_SIZE makes it larger.
+struct MediumTrivialFunctor {
+  MediumTrivialFunctor() {
+      // Do not spend time initializing the captures.
+  }
+  void* captures[4];
+  int operator()(const S*) const { return 0; }
+};
 struct LargeTrivialFunctor {
   LargeTrivialFunctor() {
       // Do not spend time initializing the padding.
@@ -95,6 +107,8 @@ inline Function MakeFunction(FunctionType type, bool opaque = false) {
       return maybeOpaque(SmallTrivialFunctor{}, opaque);
     case FunctionType::SmallNonTrivialFunctor:
       return maybeOpaque(SmallNonTrivialFunctor{}, opaque);
+    case FunctionType::MediumTrivialFunctor:
+      return maybeOpaque(MediumTrivialFunctor{}, opaque);
     case FunctionType::LargeTrivialFunctor:
       return maybeOpaque(LargeTrivialFunctor{}, opaque);
     case FunctionType::LargeNonTrivialFunctor:
@@ -167,6 +181,24 @@ struct Swap {
   }
 };
 
+// Callbacks being queued: the vector moves the functions as it grows, and
+// destroys them all at the end.
+template <class FunctionType>
+struct Churn {
+  static void run(benchmark::State& state) {
+    std::vector<Function> values;
+    for (auto _ : state) {
+      for (int i = 0; i < 64; ++i)
+        values.push_back(MakeFunction(FunctionType()));
+      benchmark::DoNotOptimize(values.data());
+      values.clear();
+      values.shrink_to_fit();
+    }
+  }
+
+  static std::string name() { return "BM_Churn" + FunctionType::name(); }
+};
+
 template <class FunctionType>
 struct OperatorBool {
   static void run(benchmark::State& state) {
@@ -224,6 +256,7 @@ int main(int argc, char** argv) {
   makeCartesianProductBenchmark<Copy, AllFunctionTypes>();
   makeCartesianProductBenchmark<Move, AllFunctionTypes>();
   makeCartesianProductBenchmark<Swap, AllFunctionTypes, AllFunctionTypes>();
+  makeCartesianProductBenchmark<Churn, AllFunctionTypes>();
   makeCartesianProductBenchmark<OperatorBool, AllFunctionTypes>();
   makeCartesianProductBenchmark<Invoke, AllFunctionTypes>();
   makeCartesianProductBenchmark<InvokeInlined, AllFunctionTypes>();
@@ -57,6 +57,55 @@ static void BM_StringCtorDefault(benchmark::State &state) {
 }
 BENCHMARK(BM_StringCtorDefault);
 
+// Lengths around the short string capacity, where a string stops fitting in
+// the object itself and the same operation starts to allocate.
+static void ssoBoundaryArgs(benchmark::internal::Benchmark* b) {
+  const int64_t Cap = std::string().capacity();
+  for (int64_t Len : {Cap / 2, Cap - 1, Cap, Cap + 1, 2 * Cap})
+    b->Arg(Len);
+}
+
+static void BM_StringPushBackToLength(benchmark::State& state) {
+  const size_t Len = state.range(0);
+  for (auto _ : state) {
+    std::string S;
+    for (size_t I = 0; I < Len; ++I)
+      S.push_back('a');
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_StringPushBackToLength)->Apply(ssoBoundaryArgs);
+
+static void BM_StringAppendToLength(benchmark::State& state) {
+  const std::string Half(state.range(0) / 2, 'a');
+  const std::string Rest(state.range(0) - Half.size(), 'b');
+  for (auto _ : state) {
+    std::string S(Half);
+    S.append(Rest);
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_StringAppendToLength)->Apply(ssoBoundaryArgs);
+
+static void BM_StringConcatToLength(benchmark::State& state) {
+  const std::string Half(state.range(0) / 2, 'a');
+  const std::string Rest(state.range(0) - Half.size(), 'b');
+  for (auto _ : state) {
+    std::string S = Half + Rest;
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_StringConcatToLength)->Apply(ssoBoundaryArgs);
+
+static void BM_StringCtorPtrLen(benchmark::State& state) {
+  const std::string Src(state.range(0), 'a');
+  for (auto _ : state) {
+    std::string S(Src.data(), Src.size());
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_StringCtorPtrLen)->Apply(ssoBoundaryArgs);
+
 enum class Length { Empty, Small, Large, Huge };
 struct AllLengths : EnumValuesAsTuple<AllLengths, Length, 4> {
   static constexpr const char* Names[] = {"Empty", "Small", "Large", "Huge"};
@@ -2,6 +2,7 @@
 #include "test_macros.h"
 
 #include <sstream>
+#include <string>
 
 TEST_NOINLINE double istream_numbers();
 
@@ -37,4 +38,65 @@ static void BM_Istream_numbers(benchmark::State &state) {
 }
 
 BENCHMARK(BM_Istream_numbers)->RangeMultiplier(2)->Range(1024, 4096);
+
+static void BM_Ostream_int(benchmark::State &state) {
+  std::ostringstream s;
+  int i = -123456;
+  for (auto _ : state) {
+    s.str(std::string());
+    s << i++ << ' ' << 42 << ' ' << -7;
+    benchmark::DoNotOptimize(s.str());
+  }
+}
+BENCHMARK(BM_Ostream_int);
+
+static void BM_Ostream_double(benchmark::State &state) {
+  std::ostringstream s;
+  double d = 2.4882e-02;
+  for (auto _ : state) {
+    s.str(std::string());
+    s << d << ' ' << -9.3262e+01;
+    d += 1.0;
+    benchmark::DoNotOptimize(s.str());
+  }
+}
+BENCHMARK(BM_Ostream_double);
+
+static void BM_Ostream_string(benchmark::State &state) {
+  const std::string word(state.range(0), 'a');
+  std::ostringstream s;
+  for (auto _ : state) {
+    s.str(std::string());
+    for (int i = 0; i < 16; ++i)
+      s << word << ' ';
+    benchmark::DoNotOptimize(s.str());
+  }
+}
+BENCHMARK(BM_Ostream_string)->Arg(8)->Arg(64);
+
+static void BM_Istream_getline(benchmark::State &state) {
+  std::string text;
+  for (int i = 0; i < 64; ++i)
+    text += std::string(state.range(0), 'a') + '\n';
+  std::string line;
+  for (auto _ : state) {
+    std::istringstream s(text);
+    while (std::getline(s, line))
+      benchmark::DoNotOptimize(line.data());
+  }
+}
+BENCHMARK(BM_Istream_getline)->Arg(16)->Arg(128);
+
+static void BM_Istream_strings(benchmark::State &state) {
+  const std::string text =
+      "lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod";
+  std::string word;
+  for (auto _ : state) {
+    std::istringstream s(text);
+    while (s >> word)
+      benchmark::DoNotOptimize(word.data());
+  }
+}
+BENCHMARK(BM_Istream_strings);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "GenerateInput.h"
+
+constexpr std::size_t TestNumInputs = 1024;
+
+// The keys come from the usual generators, the mapped values are value
+// initialized since they are never looked at.
+template <class Map, class GenKeys>
+std::vector<typename Map::value_type> getMapInputs(GenKeys gen, size_t N) {
+  auto keys = gen(N);
+  std::vector<typename Map::value_type> in;
+  in.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    in.emplace_back(keys[i], typename Map::mapped_type());
+  return in;
+}
+
+template <class Map, class GenKeys>
+void BM_MapInsert(benchmark::State& st, Map m, GenKeys gen) {
+  auto in = getMapInputs<Map>(gen, st.range(0));
+  for (auto _ : st) {
+    m.clear();
+    for (const auto& v : in)
+      benchmark::DoNotOptimize(&(*m.insert(v).first));
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Map, class GenKeys>
+void BM_MapInsertReserved(benchmark::State& st, Map m, GenKeys gen) {
+  auto in = getMapInputs<Map>(gen, st.range(0));
+  for (auto _ : st) {
+    m.clear();
+    m.reserve(in.size());
+    for (const auto& v : in)
+      benchmark::DoNotOptimize(&(*m.insert(v).first));
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Map, class GenKeys>
+void BM_MapSubscript(benchmark::State& st, Map m, GenKeys gen) {
+  auto keys = gen(st.range(0));
+  for (auto _ : st) {
+    m.clear();
+    for (const auto& k : keys)
+      benchmark::DoNotOptimize(&m[k]);
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Map, class GenKeys>
+void BM_MapFind(benchmark::State& st, Map m, GenKeys gen) {
+  auto in = getMapInputs<Map>(gen, st.range(0));
+  m.insert(in.begin(), in.end());
+  benchmark::DoNotOptimize(&m);
+  for (auto _ : st) {
+    for (const auto& v : in)
+      benchmark::DoNotOptimize(&(*m.find(v.first)));
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Map, class GenKeys>
+void BM_MapFindMiss(benchmark::State& st, Map m, GenKeys gen) {
+  // Insert every other key and look up the rest.
+  auto in = getMapInputs<Map>(gen, 2 * st.range(0));
+  for (size_t i = 0; i < in.size(); i += 2)
+    m.insert(in[i]);
+  benchmark::DoNotOptimize(&m);
+  for (auto _ : st) {
+    for (size_t i = 1; i < in.size(); i += 2)
+      benchmark::DoNotOptimize(m.find(in[i].first) == m.end());
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Map, class GenKeys>
+void BM_MapErase(benchmark::State& st, Map m, GenKeys gen) {
+  auto in = getMapInputs<Map>(gen, st.range(0));
+  for (auto _ : st) {
+    st.PauseTiming();
+    m.insert(in.begin(), in.end());
+    benchmark::DoNotOptimize(&m);
+    st.ResumeTiming();
+    for (const auto& v : in)
+      benchmark::DoNotOptimize(m.erase(v.first));
+    benchmark::ClobberMemory();
+  }
+}
+
+template <class Map, class GenKeys>
+void BM_MapIterate(benchmark::State& st, Map m, GenKeys gen) {
+  auto in = getMapInputs<Map>(gen, st.range(0));
+  m.insert(in.begin(), in.end());
+  for (auto _ : st) {
+    for (auto& v : m)
+      benchmark::DoNotOptimize(&v);
+    benchmark::ClobberMemory();
+  }
+}
+
+#define MAP_BENCHMARKS(Name, Map, GenKeys)                                     \
+  BENCHMARK_CAPTURE(BM_MapInsert, Name, Map{}, GenKeys)->Arg(TestNumInputs);   \
+  BENCHMARK_CAPTURE(BM_MapInsertReserved, Name, Map{}, GenKeys)                \
+      ->Arg(TestNumInputs);                                                    \
+  BENCHMARK_CAPTURE(BM_MapSubscript, Name, Map{}, GenKeys)                     \
+      ->Arg(TestNumInputs);                                                    \
+  BENCHMARK_CAPTURE(BM_MapFind, Name, Map{}, GenKeys)->Arg(TestNumInputs);     \
+  BENCHMARK_CAPTURE(BM_MapFindMiss, Name, Map{}, GenKeys)->Arg(TestNumInputs); \
+  BENCHMARK_CAPTURE(BM_MapErase, Name, Map{}, GenKeys)->Arg(TestNumInputs);    \
+  BENCHMARK_CAPTURE(BM_MapIterate, Name, Map{}, GenKeys)->Arg(TestNumInputs)
+
+using Uint64Map = std::unordered_map<uint64_t, uint64_t>;
+using StringMap = std::unordered_map<std::string, uint64_t>;
+using StringStringMap = std::unordered_map<std::string, std::string>;
+
+MAP_BENCHMARKS(unordered_map_random_uint64, Uint64Map,
+               getRandomIntegerInputs<uint64_t>);
+MAP_BENCHMARKS(unordered_map_sorted_uint64, Uint64Map,
+               getSortedIntegerInputs<uint64_t>);
+MAP_BENCHMARKS(unordered_map_top_bits_uint64, Uint64Map,
+               getSortedTopBitsIntegerInputs<uint64_t>);
+MAP_BENCHMARKS(unordered_map_string, StringMap, getRandomStringInputs);
+MAP_BENCHMARKS(unordered_map_string_string, StringStringMap,
+               getRandomStringInputs);
+
+BENCHMARK_MAIN();
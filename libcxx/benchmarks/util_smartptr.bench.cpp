@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 
@@ -38,4 +39,30 @@ static void BM_WeakPtrIncDecRef(benchmark::State& st) {
 }
 BENCHMARK(BM_WeakPtrIncDecRef);
 
+static void BM_SharedPtrMove(benchmark::State& st) {
+  std::shared_ptr<int> sp[2] = {std::make_shared<int>(42)};
+  int i = 0;
+  while (st.KeepRunning()) {
+    sp[i ^ 1] = std::move(sp[i]);
+    benchmark::DoNotOptimize(sp);
+    i ^= 1;
+  }
+}
+BENCHMARK(BM_SharedPtrMove);
+
+// An object handed to a few owners, which then all let go of it.
+static void BM_SharedPtrChurn(benchmark::State& st) {
+  std::vector<std::shared_ptr<int> > owners;
+  owners.reserve(st.range(0));
+  while (st.KeepRunning()) {
+    auto sp = std::make_shared<int>(42);
+    for (int i = 1; i < st.range(0); ++i)
+      owners.push_back(sp);
+    owners.push_back(std::move(sp));
+    benchmark::DoNotOptimize(owners.data());
+    owners.clear();
+  }
+}
+BENCHMARK(BM_SharedPtrChurn)->Arg(1)->Arg(4)->Arg(16);
+
 BENCHMARK_MAIN();
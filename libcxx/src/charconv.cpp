@@ -7,8 +7,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "charconv"
+#include "locale"
+#include "memory"
+#include <errno.h>
+#include <float.h>
 #include <string.h>
 
+#include "include/ryu_tables.h"
+
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 namespace __itoa
@@ -157,4 +163,1352 @@ __u64toa(uint64_t value, char* buffer)
 
 }  // namespace __itoa
 
+namespace __ryu
+{
+
+// The decimal floating point number output * 10^exponent.
+struct floating_decimal
+{
+    uint64_t mantissa;
+    int32_t exponent;
+};
+
+// Returns floor(log10(2^e)) for 0 <= e <= 1650.
+inline _LIBCPP_INLINE_VISIBILITY uint32_t
+log10_pow2(int32_t e)
+{
+    return (static_cast<uint32_t>(e) * 78913) >> 18;
+}
+
+// Returns floor(log10(5^e)) for 0 <= e <= 2620.
+inline _LIBCPP_INLINE_VISIBILITY uint32_t
+log10_pow5(int32_t e)
+{
+    return (static_cast<uint32_t>(e) * 732923) >> 20;
+}
+
+// Returns the number of bits of 5^e, or 1 for e == 0, for 0 <= e <= 3528.
+inline _LIBCPP_INLINE_VISIBILITY int32_t
+pow5bits(int32_t e)
+{
+    return static_cast<int32_t>(((static_cast<uint32_t>(e) * 1217359) >> 19) + 1);
+}
+
+template <typename T>
+inline _LIBCPP_INLINE_VISIBILITY bool
+multiple_of_pow5(T value, uint32_t p)
+{
+    uint32_t count = 0;
+    while (value != 0 && value % 5 == 0)
+    {
+        value /= 5;
+        ++count;
+    }
+    return count >= p;
+}
+
+template <typename T>
+inline _LIBCPP_INLINE_VISIBILITY bool
+multiple_of_pow2(T value, uint32_t p)
+{
+    return (value & ((T(1) << p) - 1)) == 0;
+}
+
+// Returns the bits [j, j + 64) of m * mul, where mul is a 128-bit number
+// stored as {low, high} and 64 < j < 128.
+inline _LIBCPP_INLINE_VISIBILITY uint64_t
+mul_shift64(uint64_t m, const uint64_t* mul, int32_t j)
+{
+#ifndef _LIBCPP_HAS_NO_INT128
+    const __uint128_t b0 = static_cast<__uint128_t>(m) * mul[0];
+    const __uint128_t b2 = static_cast<__uint128_t>(m) * mul[1];
+    return static_cast<uint64_t>(((b0 >> 64) + b2) >> (j - 64));
+#else
+    auto umul128 = [](uint64_t a, uint64_t b, uint64_t& high) {
+        const uint64_t a_lo = static_cast<uint32_t>(a), a_hi = a >> 32;
+        const uint64_t b_lo = static_cast<uint32_t>(b), b_hi = b >> 32;
+        const uint64_t b00 = a_lo * b_lo, b01 = a_lo * b_hi;
+        const uint64_t b10 = a_hi * b_lo, b11 = a_hi * b_hi;
+        const uint64_t mid1 = b10 + (b00 >> 32);
+        const uint64_t mid2 = b01 + static_cast<uint32_t>(mid1);
+        high = b11 + (mid1 >> 32) + (mid2 >> 32);
+        return (mid2 << 32) | static_cast<uint32_t>(b00);
+    };
+    uint64_t high0, high1;
+    umul128(m, mul[0], high0);
+    const uint64_t low1 = umul128(m, mul[1], high1);
+    const uint64_t sum = high0 + low1;
+    if (sum < high0)
+        ++high1;
+    const int32_t dist = j - 64;
+    return (high1 << (64 - dist)) | (sum >> dist);
+#endif
+}
+
+// Returns the bits [shift, shift + 32) of m * factor, for 32 < shift < 96.
+inline _LIBCPP_INLINE_VISIBILITY uint32_t
+mul_shift32(uint32_t m, uint64_t factor, int32_t shift)
+{
+    const uint64_t bits0 = static_cast<uint64_t>(m) * static_cast<uint32_t>(factor);
+    const uint64_t bits1 = static_cast<uint64_t>(m) * (factor >> 32);
+    return static_cast<uint32_t>(((bits0 >> 32) + bits1) >> (shift - 32));
+}
+
+// Returns the shortest decimal number that rounds to the double with the given
+// mantissa and biased exponent bits, which must be neither zero nor an infinity
+// nor a NaN. This is Ryu's d2d.
+floating_decimal
+d2d(uint64_t ieee_mantissa, uint32_t ieee_exponent)
+{
+    const int mantissa_bits = 52;
+    const int bias = 1023;
+
+    // Step 1: Decode the floating point number, and unify normalized and
+    // subnormal cases. Subtract 2 so that the bounds computation has 2
+    // additional bits.
+    int32_t e2;
+    uint64_t m2;
+    if (ieee_exponent == 0)
+    {
+        e2 = 1 - bias - mantissa_bits - 2;
+        m2 = ieee_mantissa;
+    }
+    else
+    {
+        e2 = static_cast<int32_t>(ieee_exponent) - bias - mantissa_bits - 2;
+        m2 = (uint64_t(1) << mantissa_bits) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    // Step 2: Determine the interval of valid decimal representations,
+    // [4 * m2 - 1 - mm_shift, 4 * m2 + 2].
+    const uint64_t mv = 4 * m2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    // Step 3: Convert to a decimal power base using 128-bit arithmetic.
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    if (e2 >= 0)
+    {
+        const uint32_t q = log10_pow2(e2) - (e2 > 3);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = DOUBLE_POW5_INV_BITCOUNT + pow5bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        vr = mul_shift64(4 * m2, DOUBLE_POW5_INV_SPLIT[q], i);
+        vp = mul_shift64(4 * m2 + 2, DOUBLE_POW5_INV_SPLIT[q], i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, DOUBLE_POW5_INV_SPLIT[q], i);
+        if (q <= 21)
+        {
+            // Only one of mp, mv, and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            else
+                vp -= multiple_of_pow5(mv + 2, q);
+        }
+    }
+    else
+    {
+        const uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5bits(i) - DOUBLE_POW5_BITCOUNT;
+        const int32_t j = static_cast<int32_t>(q) - k;
+        vr = mul_shift64(4 * m2, DOUBLE_POW5_SPLIT[i], j);
+        vp = mul_shift64(4 * m2 + 2, DOUBLE_POW5_SPLIT[i], j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, DOUBLE_POW5_SPLIT[i], j);
+        if (q <= 1)
+        {
+            // {vr,vp,vm} is trailing zeros if {mv,mp,mm} has at least q
+            // trailing 0 bits. mv = 4 * m2, so it always has at least two.
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                --vp;
+        }
+        else if (q < 63)
+            vr_is_trailing_zeros = multiple_of_pow2(mv, q);
+    }
+
+    // Step 4: Find the shortest decimal representation in the interval of
+    // valid representations.
+    int32_t removed = 0;
+    uint64_t output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros)
+    {
+        // General case, which happens rarely (~0.7%).
+        uint32_t last_removed_digit = 0;
+        while (vp / 10 > vm / 10)
+        {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = static_cast<uint32_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_is_trailing_zeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = static_cast<uint32_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        // Round to even if the exact number is .....50..0.
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+        // Take vr + 1 if vr is outside the bounds or needs to be rounded up.
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) ||
+                       last_removed_digit >= 5);
+    }
+    else
+    {
+        // Specialized for the common case (~99.3%).
+        bool round_up = false;
+        if (vp / 100 > vm / 100)
+        {
+            // Remove two digits at a time.
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10)
+        {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    return {output, e10 + removed};
+}
+
+// The same as d2d, for floats. This is Ryu's f2d.
+floating_decimal
+f2d(uint32_t ieee_mantissa, uint32_t ieee_exponent)
+{
+    const int mantissa_bits = 23;
+    const int bias = 127;
+
+    int32_t e2;
+    uint32_t m2;
+    if (ieee_exponent == 0)
+    {
+        e2 = 1 - bias - mantissa_bits - 2;
+        m2 = ieee_mantissa;
+    }
+    else
+    {
+        e2 = static_cast<int32_t>(ieee_exponent) - bias - mantissa_bits - 2;
+        m2 = (uint32_t(1) << mantissa_bits) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    const uint32_t mv = 4 * m2;
+    const uint32_t mp = 4 * m2 + 2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    const uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+    uint32_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    uint32_t last_removed_digit = 0;
+    if (e2 >= 0)
+    {
+        const uint32_t q = log10_pow2(e2);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = FLOAT_POW5_INV_BITCOUNT + pow5bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        vr = mul_shift32(mv, FLOAT_POW5_INV_SPLIT[q], i);
+        vp = mul_shift32(mp, FLOAT_POW5_INV_SPLIT[q], i);
+        vm = mul_shift32(mm, FLOAT_POW5_INV_SPLIT[q], i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10)
+        {
+            // We need to know one removed digit even if we are not going to
+            // loop below.
+            const int32_t l = FLOAT_POW5_INV_BITCOUNT + pow5bits(static_cast<int32_t>(q - 1)) - 1;
+            last_removed_digit = mul_shift32(mv, FLOAT_POW5_INV_SPLIT[q - 1],
+                                             -e2 + static_cast<int32_t>(q) - 1 + l) % 10;
+        }
+        if (q <= 9)
+        {
+            // Only one of mp, mv, and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = multiple_of_pow5(mm, q);
+            else
+                vp -= multiple_of_pow5(mp, q);
+        }
+    }
+    else
+    {
+        const uint32_t q = log10_pow5(-e2);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5bits(i) - FLOAT_POW5_BITCOUNT;
+        int32_t j = static_cast<int32_t>(q) - k;
+        vr = mul_shift32(mv, FLOAT_POW5_SPLIT[i], j);
+        vp = mul_shift32(mp, FLOAT_POW5_SPLIT[i], j);
+        vm = mul_shift32(mm, FLOAT_POW5_SPLIT[i], j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10)
+        {
+            j = static_cast<int32_t>(q) - 1 - (pow5bits(i + 1) - FLOAT_POW5_BITCOUNT);
+            last_removed_digit = mul_shift32(mv, FLOAT_POW5_SPLIT[i + 1], j) % 10;
+        }
+        if (q <= 1)
+        {
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                --vp;
+        }
+        else if (q < 31)
+            vr_is_trailing_zeros = multiple_of_pow2(mv, q - 1);
+    }
+
+    int32_t removed = 0;
+    uint32_t output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros)
+    {
+        while (vp / 10 > vm / 10)
+        {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_is_trailing_zeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) ||
+                       last_removed_digit >= 5);
+    }
+    else
+    {
+        while (vp / 10 > vm / 10)
+        {
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || last_removed_digit >= 5);
+    }
+    return {output, e10 + removed};
+}
+
+}  // namespace __ryu
+
+namespace
+{
+
+struct double_traits
+{
+    using type = double;
+    using uint_type = uint64_t;
+    static constexpr int mantissa_bits = 52;
+    static constexpr int exponent_bits = 11;
+    static constexpr int bias = 1023;
+    // The number of hexadecimal digits after the point in hex notation, and
+    // the amount to shift the mantissa by to fill them.
+    static constexpr int hex_digits = 13;
+    static constexpr int hex_shift = 0;
+
+    static __ryu::floating_decimal
+    to_decimal(uint_type mantissa, uint32_t exponent)
+    {
+        return __ryu::d2d(mantissa, exponent);
+    }
+};
+
+struct float_traits
+{
+    using type = float;
+    using uint_type = uint32_t;
+    static constexpr int mantissa_bits = 23;
+    static constexpr int exponent_bits = 8;
+    static constexpr int bias = 127;
+    static constexpr int hex_digits = 6;
+    static constexpr int hex_shift = 1;
+
+    static __ryu::floating_decimal
+    to_decimal(uint_type mantissa, uint32_t exponent)
+    {
+        return __ryu::f2d(mantissa, exponent);
+    }
+};
+
+inline int
+decimal_length(uint64_t v)
+{
+    int length = 1;
+    for (; v >= 10000; v /= 10000)
+        length += 4;
+    for (; v >= 10; v /= 10)
+        ++length;
+    return length;
+}
+
+inline bool
+has_format(chars_format fmt, chars_format flag)
+{
+    return (static_cast<unsigned>(fmt) & static_cast<unsigned>(flag)) != 0;
+}
+
+// Writes the exponent of scientific notation, e.g. "e+05" or "e-123".
+to_chars_result
+write_exponent(char* first, char* last, char marker, int32_t exponent,
+               int min_digits)
+{
+    char buffer[8];
+    char* end = __itoa::__u32toa(static_cast<uint32_t>(exponent < 0 ? -exponent : exponent),
+                                 buffer);
+    int digits = static_cast<int>(end - buffer);
+    int padding = digits < min_digits ? min_digits - digits : 0;
+    if (last - first < 2 + padding + digits)
+        return {last, errc::value_too_large};
+    *first++ = marker;
+    *first++ = exponent < 0 ? '-' : '+';
+    for (; padding > 0; --padding)
+        *first++ = '0';
+    memcpy(first, buffer, digits);
+    return {first + digits, errc(0)};
+}
+
+// Returns whether the decimal digits [first, last) are all zeros.
+inline bool
+all_zeros(const char* first, const char* last)
+{
+    for (; first != last; ++first)
+        if (*first != '0')
+            return false;
+    return true;
+}
+
+// Adds one to the decimal number in [first, last), ignoring '.' characters.
+// Returns whether the number overflowed, in which case it was made all zeros.
+bool
+increment_digits(char* first, char* last)
+{
+    while (last != first)
+    {
+        char& c = *--last;
+        if (c == '.')
+            continue;
+        if (c != '9')
+        {
+            ++c;
+            return false;
+        }
+        c = '0';
+    }
+    return true;
+}
+
+// The exact decimal expansion of m2 * 2^e2, which is finite. The integer part
+// is converted eagerly, and the digits of the fraction are generated on
+// demand, nine at a time, by repeatedly multiplying it by 10^9.
+class exact_decimal
+{
+public:
+    // Enough for the 309 digits of the integer part of the largest double.
+    static constexpr int max_integer_digits = 320;
+
+    exact_decimal(uint64_t m2, int32_t e2)
+        : integer_length_(0), fraction_words_(0), fraction_low_(0),
+          pending_begin_(0), pending_end_(0)
+    {
+        if (e2 >= 0)
+            init_integer(m2, e2);
+        else
+            init_fraction(m2, -e2);
+    }
+
+    // The digits of the integer part, empty if it is zero.
+    const char*
+    integer_digits() const
+    {
+        return integer_ + max_integer_digits - integer_length_;
+    }
+    int integer_length() const { return integer_length_; }
+
+    // Returns whether all the remaining digits of the fraction are zeros.
+    bool
+    fraction_is_zero() const
+    {
+        return all_zeros(pending_ + pending_begin_, pending_ + pending_end_) &&
+               fraction_low_ == fraction_words_;
+    }
+
+    // Writes the next `count` digits of the fraction to `out`.
+    void
+    next_digits(char* out, size_t count)
+    {
+        while (count > 0)
+        {
+            if (pending_begin_ == pending_end_)
+            {
+                if (fraction_low_ == fraction_words_)
+                {
+                    memset(out, '0', count);
+                    return;
+                }
+                refill();
+            }
+            size_t n = pending_end_ - pending_begin_;
+            if (n > count)
+                n = count;
+            memcpy(out, pending_ + pending_begin_, n);
+            pending_begin_ += static_cast<int>(n);
+            out += n;
+            count -= n;
+        }
+    }
+
+    // Consumes the zeros at the start of the fraction and returns how many
+    // there were. Precondition: the fraction is not zero.
+    int32_t
+    skip_zeros()
+    {
+        int32_t count = 0;
+        for (;;)
+        {
+            if (pending_begin_ == pending_end_)
+                refill();
+            if (pending_[pending_begin_] != '0')
+                return count;
+            ++pending_begin_;
+            ++count;
+        }
+    }
+
+    // Compares the rest of the fraction, after the digits consumed so far, to
+    // one half of the last consumed digit.
+    int
+    compare_rest_to_half() const
+    {
+        if (pending_begin_ != pending_end_)
+        {
+            char d = pending_[pending_begin_];
+            if (d != '5')
+                return d < '5' ? -1 : 1;
+            bool tail_is_zero =
+                all_zeros(pending_ + pending_begin_ + 1, pending_ + pending_end_) &&
+                fraction_low_ == fraction_words_;
+            return tail_is_zero ? 0 : 1;
+        }
+        if (fraction_low_ == fraction_words_)
+            return -1;
+        uint32_t top = fraction_[fraction_words_ - 1];
+        if (top != 0x80000000)
+            return top < 0x80000000 ? -1 : 1;
+        return fraction_low_ == fraction_words_ - 1 ? 0 : 1;
+    }
+
+private:
+    void
+    init_integer(uint64_t m2, int32_t e2)
+    {
+        char* end = integer_ + max_integer_digits;
+        if (m2 == 0)
+            return;
+        if (e2 < 64 && (m2 << e2) >> e2 == m2)
+        {
+            char buffer[24];
+            int n = static_cast<int>(__itoa::__u64toa(m2 << e2, buffer) - buffer);
+            memcpy(end - n, buffer, n);
+            integer_length_ = n;
+            return;
+        }
+
+        // Convert m2 << e2 to base 10^9 by repeated division.
+        uint32_t words[max_words] = {};
+        int size = e2 / 32 + 3;
+        int shift = e2 % 32;
+        words[e2 / 32] = static_cast<uint32_t>(m2 << shift);
+        words[e2 / 32 + 1] = static_cast<uint32_t>((m2 << shift) >> 32);
+        words[e2 / 32 + 2] = shift == 0 ? 0 : static_cast<uint32_t>(m2 >> (64 - shift));
+        char* p = end;
+        while (size > 0)
+        {
+            uint64_t remainder = 0;
+            for (int i = size - 1; i >= 0; --i)
+            {
+                uint64_t current = (remainder << 32) | words[i];
+                words[i] = static_cast<uint32_t>(current / 1000000000);
+                remainder = current % 1000000000;
+            }
+            while (size > 0 && words[size - 1] == 0)
+                --size;
+            uint32_t chunk = static_cast<uint32_t>(remainder);
+            for (int i = 0; i < 9; ++i, chunk /= 10)
+                *--p = static_cast<char>('0' + chunk % 10);
+        }
+        while (*p == '0')
+            ++p;
+        integer_length_ = static_cast<int>(end - p);
+    }
+
+    void
+    init_fraction(uint64_t m2, int32_t k)
+    {
+        uint64_t fraction = m2;
+        if (k < 64)
+        {
+            init_integer(m2 >> k, 0);
+            fraction &= (uint64_t(1) << k) - 1;
+        }
+        if (fraction == 0)
+            return;
+        // Scale the fraction to a whole number of words, so that the new
+        // digits produced by a multiplication are its carry out.
+        fraction_words_ = (k + 31) / 32;
+        int shift = fraction_words_ * 32 - k;
+        memset(fraction_, 0, sizeof(fraction_));
+        fraction_[0] = static_cast<uint32_t>(fraction << shift);
+        fraction_[1] = static_cast<uint32_t>((fraction << shift) >> 32);
+        if (shift != 0)
+            fraction_[2] = static_cast<uint32_t>(fraction >> (64 - shift));
+        while (fraction_[fraction_low_] == 0)
+            ++fraction_low_;
+    }
+
+    void
+    refill()
+    {
+        uint64_t carry = 0;
+        for (int i = fraction_low_; i < fraction_words_; ++i)
+        {
+            uint64_t product = uint64_t(fraction_[i]) * 1000000000 + carry;
+            fraction_[i] = static_cast<uint32_t>(product);
+            carry = product >> 32;
+        }
+        while (fraction_low_ < fraction_words_ && fraction_[fraction_low_] == 0)
+            ++fraction_low_;
+        uint32_t chunk = static_cast<uint32_t>(carry);
+        for (int i = 8; i >= 0; --i, chunk /= 10)
+            pending_[i] = static_cast<char>('0' + chunk % 10);
+        pending_begin_ = 0;
+        pending_end_ = 9;
+    }
+
+    // Enough for a fraction of 1074 bits, rounded up to a whole word, plus
+    // the integer part of the largest double, plus three words of mantissa.
+    static constexpr int max_words = 36;
+
+    char integer_[max_integer_digits];
+    int integer_length_;
+    uint32_t fraction_[max_words];
+    int fraction_words_;
+    // The index of the lowest non-zero word of the fraction, or
+    // fraction_words_ if the fraction is zero.
+    int fraction_low_;
+    char pending_[9];
+    int pending_begin_;
+    int pending_end_;
+};
+
+// Returns whether the digits [first, last) should be rounded up to even when
+// the dropped digits compare to half of the last digit as `comparison`.
+inline bool
+should_round_up(const char* first, const char* last, int comparison)
+{
+    if (comparison != 0)
+        return comparison > 0;
+    while (last != first && *(last - 1) == '.')
+        --last;
+    return last != first && ((*(last - 1) - '0') & 1);
+}
+
+// Writes the `count` most significant digits of the exact decimal expansion
+// of m2 * 2^e2, correctly rounded, to `digits`, and returns the decimal
+// exponent of the first one.
+int32_t
+significant_digits(uint64_t m2, int32_t e2, char* digits, size_t count)
+{
+    if (m2 == 0)
+    {
+        memset(digits, '0', count);
+        return 0;
+    }
+
+    exact_decimal value(m2, e2);
+    int32_t exponent;
+    int comparison;
+    size_t n = static_cast<size_t>(value.integer_length());
+    if (n != 0)
+    {
+        exponent = static_cast<int32_t>(n) - 1;
+        const char* integer = value.integer_digits();
+        if (n >= count)
+        {
+            memcpy(digits, integer, count);
+            if (n == count)
+                comparison = value.compare_rest_to_half();
+            else if (integer[count] != '5')
+                comparison = integer[count] < '5' ? -1 : 1;
+            else
+                comparison = all_zeros(integer + count + 1, integer + n) &&
+                                     value.fraction_is_zero()
+                                 ? 0
+                                 : 1;
+        }
+        else
+        {
+            memcpy(digits, integer, n);
+            value.next_digits(digits + n, count - n);
+            comparison = value.compare_rest_to_half();
+        }
+    }
+    else
+    {
+        exponent = -value.skip_zeros() - 1;
+        value.next_digits(digits, count);
+        comparison = value.compare_rest_to_half();
+    }
+
+    if (should_round_up(digits, digits + count, comparison) &&
+        increment_digits(digits, digits + count))
+    {
+        digits[0] = '1';
+        ++exponent;
+    }
+    return exponent;
+}
+
+template <typename Traits>
+struct decomposed
+{
+    typename Traits::uint_type ieee_mantissa;
+    uint32_t ieee_exponent;
+
+    // The value is m2 * 2^e2.
+    uint64_t m2() const
+    {
+        return ieee_exponent == 0
+                   ? ieee_mantissa
+                   : (uint64_t(1) << Traits::mantissa_bits) | ieee_mantissa;
+    }
+    int32_t e2() const
+    {
+        return (ieee_exponent == 0 ? 1 : static_cast<int32_t>(ieee_exponent)) -
+               Traits::bias - Traits::mantissa_bits;
+    }
+    bool is_zero() const { return ieee_mantissa == 0 && ieee_exponent == 0; }
+};
+
+// Writes the shortest representation of the value in fixed notation.
+template <typename Traits>
+to_chars_result
+write_shortest_fixed(char* first, char* last, decomposed<Traits> value,
+                     uint64_t output, int32_t exponent, int olength)
+{
+    if (exponent >= 0 && value.e2() > 0)
+    {
+        // The value is an integer with more digits than the shortest
+        // representation needs. The digits that are zeros in the shortest
+        // representation must still be printed exactly: that is just as short
+        // and closer to the value.
+        exact_decimal exact(value.m2(), value.e2());
+        int n = exact.integer_length();
+        if (last - first < n)
+            return {last, errc::value_too_large};
+        memcpy(first, exact.integer_digits(), n);
+        return {first + n, errc(0)};
+    }
+
+    if (exponent >= 0)
+    {
+        if (last - first < olength + exponent)
+            return {last, errc::value_too_large};
+        first = __itoa::__u64toa(output, first);
+        memset(first, '0', exponent);
+        return {first + exponent, errc(0)};
+    }
+
+    int32_t fraction_digits = -exponent;
+    if (olength > fraction_digits)
+    {
+        // The decimal point is inside the digits, e.g. 123.45.
+        if (last - first < olength + 1)
+            return {last, errc::value_too_large};
+        char* end = __itoa::__u64toa(output, first);
+        char* point = end - fraction_digits;
+        memmove(point + 1, point, fraction_digits);
+        *point = '.';
+        return {end + 1, errc(0)};
+    }
+
+    // The value is less than one, e.g. 0.0012345.
+    if (last - first < 2 + fraction_digits)
+        return {last, errc::value_too_large};
+    *first++ = '0';
+    *first++ = '.';
+    memset(first, '0', fraction_digits - olength);
+    first += fraction_digits - olength;
+    return {__itoa::__u64toa(output, first), errc(0)};
+}
+
+// Writes the shortest representation of the value in scientific notation.
+to_chars_result
+write_shortest_scientific(char* first, char* last, uint64_t output,
+                          int32_t exponent, int olength)
+{
+    if (last - first < olength + (olength > 1))
+        return {last, errc::value_too_large};
+    char* end = __itoa::__u64toa(output, first + 1);
+    first[0] = first[1];
+    if (olength > 1)
+        first[1] = '.';
+    else
+        --end;
+    return write_exponent(end, last, 'e', exponent + olength - 1, 2);
+}
+
+template <typename Traits>
+to_chars_result
+to_chars_shortest(char* first, char* last, decomposed<Traits> value,
+                  chars_format fmt)
+{
+    uint64_t output = 0;
+    int32_t exponent = 0;
+    if (!value.is_zero())
+    {
+        __ryu::floating_decimal decimal =
+            Traits::to_decimal(value.ieee_mantissa, value.ieee_exponent);
+        output = decimal.mantissa;
+        exponent = decimal.exponent;
+    }
+    int olength = decimal_length(output);
+    int32_t scientific_exponent = exponent + olength - 1;
+
+    if (fmt == chars_format{})
+    {
+        // Pick the shorter of fixed and scientific notation, preferring fixed
+        // notation on ties. With the exponent of scientific notation taking
+        // four characters, this comes down to the following range.
+        int32_t lower = olength == 1 ? -3 : -(olength + 3);
+        int32_t upper = olength == 1 ? 4 : 5;
+        fmt = lower <= exponent && exponent <= upper ? chars_format::fixed
+                                                     : chars_format::scientific;
+    }
+    else if (fmt == chars_format::general)
+    {
+        // Like %g, with the precision P of 6 that printf uses when it is
+        // omitted: fixed notation if P > X >= -4, where X is the exponent of
+        // scientific notation.
+        fmt = -4 <= scientific_exponent && scientific_exponent < 6
+                  ? chars_format::fixed
+                  : chars_format::scientific;
+    }
+
+    if (fmt == chars_format::fixed)
+        return write_shortest_fixed(first, last, value, output, exponent, olength);
+    return write_shortest_scientific(first, last, output, exponent, olength);
+}
+
+template <typename Traits>
+to_chars_result
+to_chars_fixed_precision(char* first, char* last, decomposed<Traits> value,
+                         int precision)
+{
+    exact_decimal exact(value.m2(), value.e2());
+    int n = exact.integer_length();
+    ptrdiff_t total = (n == 0 ? 1 : n) + (precision > 0 ? ptrdiff_t(precision) + 1 : 0);
+    if (last - first < total)
+        return {last, errc::value_too_large};
+
+    char* p = first;
+    if (n == 0)
+        *p++ = '0';
+    memcpy(p, exact.integer_digits(), n);
+    p += n;
+    if (precision > 0)
+    {
+        *p++ = '.';
+        exact.next_digits(p, precision);
+        p += precision;
+    }
+
+    if (should_round_up(first, p, exact.compare_rest_to_half()) &&
+        increment_digits(first, p))
+    {
+        if (last - p < 1)
+            return {last, errc::value_too_large};
+        memmove(first + 1, first, p - first);
+        *first = '1';
+        ++p;
+    }
+    return {p, errc(0)};
+}
+
+template <typename Traits>
+to_chars_result
+to_chars_scientific_precision(char* first, char* last, decomposed<Traits> value,
+                              int precision)
+{
+    // The digits, a point unless the precision is zero, and at least four
+    // characters of exponent.
+    ptrdiff_t count = ptrdiff_t(precision) + 1;
+    if (last - first < count + (precision > 0) + 4)
+        return {last, errc::value_too_large};
+
+    int32_t exponent = significant_digits(value.m2(), value.e2(), first + 1,
+                                          count);
+    first[0] = first[1];
+    char* end = first + 1;
+    if (precision > 0)
+    {
+        first[1] = '.';
+        end = first + count + 1;
+    }
+    return write_exponent(end, last, 'e', exponent, 2);
+}
+
+template <typename Traits>
+to_chars_result
+to_chars_general_precision(char* first, char* last, decomposed<Traits> value,
+                           int precision)
+{
+    // Like %g: let P be the precision, or 1 if it is zero, and X the exponent
+    // of scientific notation. Use fixed notation with P - 1 - X digits after
+    // the point if P > X >= -4, and scientific notation with P - 1 digits
+    // after the point otherwise. Both round to P significant digits, after
+    // which the trailing zeros of the fraction are removed.
+    //
+    // An exact decimal expansion has at most 767 significant digits, the
+    // rest are zeros that would be removed anyway.
+    char digits[800];
+    int p = precision == 0 ? 1 : precision;
+    int count = p < 800 ? p : 800;
+    int32_t x = significant_digits(value.m2(), value.e2(), digits, count);
+    while (count > 1 && digits[count - 1] == '0')
+        --count;
+
+    if (x < -4 || x >= p)
+    {
+        if (last - first < count + (count > 1))
+            return {last, errc::value_too_large};
+        *first++ = digits[0];
+        if (count > 1)
+        {
+            *first++ = '.';
+            memcpy(first, digits + 1, count - 1);
+            first += count - 1;
+        }
+        return write_exponent(first, last, 'e', x, 2);
+    }
+
+    if (x >= 0)
+    {
+        int integer_digits = x + 1;
+        if (count < integer_digits)
+            count = integer_digits;
+        int fraction_digits = count - integer_digits;
+        if (last - first < count + (fraction_digits > 0))
+            return {last, errc::value_too_large};
+        memcpy(first, digits, integer_digits);
+        first += integer_digits;
+        if (fraction_digits > 0)
+        {
+            *first++ = '.';
+            memcpy(first, digits + integer_digits, fraction_digits);
+            first += fraction_digits;
+        }
+        return {first, errc(0)};
+    }
+
+    int leading_zeros = -x - 1;
+    if (last - first < 2 + leading_zeros + count)
+        return {last, errc::value_too_large};
+    *first++ = '0';
+    *first++ = '.';
+    memset(first, '0', leading_zeros);
+    first += leading_zeros;
+    memcpy(first, digits, count);
+    return {first + count, errc(0)};
+}
+
+template <typename Traits>
+to_chars_result
+to_chars_hex(char* first, char* last, decomposed<Traits> value, int precision)
+{
+    // The digit before the point and the hex_digits after it, as one number.
+    const int digits = Traits::hex_digits;
+    uint64_t mantissa = uint64_t(value.ieee_mantissa) << Traits::hex_shift;
+    uint64_t full = (uint64_t(value.ieee_exponent != 0) << (4 * digits)) | mantissa;
+    int32_t exponent = value.is_zero() ? 0 : value.e2() + Traits::mantissa_bits;
+
+    int fraction_digits = digits;
+    if (precision < 0)
+    {
+        // The shortest representation drops the trailing zeros.
+        while (fraction_digits > 0 && (full & 0xF) == 0)
+        {
+            full >>= 4;
+            --fraction_digits;
+        }
+    }
+    else if (precision < digits)
+    {
+        // Round to nearest, ties to even.
+        int dropped = 4 * (digits - precision);
+        uint64_t rest = full & ((uint64_t(1) << dropped) - 1);
+        uint64_t half = uint64_t(1) << (dropped - 1);
+        full >>= dropped;
+        if (rest > half || (rest == half && (full & 1)))
+            ++full;
+        fraction_digits = precision;
+    }
+    int padding = precision > digits ? precision - digits : 0;
+
+    ptrdiff_t length = 1 + (fraction_digits + padding > 0) + fraction_digits + padding;
+    if (last - first < length)
+        return {last, errc::value_too_large};
+    // The first digit may be 2 after rounding, like printf does.
+    *first++ = static_cast<char>('0' + (full >> (4 * fraction_digits)));
+    if (fraction_digits + padding > 0)
+    {
+        *first++ = '.';
+        for (int i = fraction_digits - 1; i >= 0; --i)
+            *first++ = "0123456789abcdef"[(full >> (4 * i)) & 0xF];
+        memset(first, '0', padding);
+        first += padding;
+    }
+    return write_exponent(first, last, 'p', exponent, 1);
+}
+
+template <typename Traits>
+to_chars_result
+floating_to_chars(char* first, char* last, typename Traits::type value,
+                  chars_format fmt, int precision, bool has_precision)
+{
+    using uint_type = typename Traits::uint_type;
+    uint_type bits;
+    memcpy(&bits, &value, sizeof(value));
+    const int total_bits = Traits::mantissa_bits + Traits::exponent_bits + 1;
+    decomposed<Traits> parts;
+    parts.ieee_mantissa = bits & ((uint_type(1) << Traits::mantissa_bits) - 1);
+    parts.ieee_exponent = static_cast<uint32_t>(
+        (bits >> Traits::mantissa_bits) & ((uint_type(1) << Traits::exponent_bits) - 1));
+
+    if (bits >> (total_bits - 1))
+    {
+        if (first == last)
+            return {last, errc::value_too_large};
+        *first++ = '-';
+    }
+
+    if (parts.ieee_exponent == (uint32_t(1) << Traits::exponent_bits) - 1)
+    {
+        const char* str = parts.ieee_mantissa == 0 ? "inf" : "nan";
+        if (last - first < 3)
+            return {last, errc::value_too_large};
+        memcpy(first, str, 3);
+        return {first + 3, errc(0)};
+    }
+
+    // Like in printf, a negative precision is taken as if it was omitted:
+    // hexadecimal notation is then exact, and the others use 6 digits.
+    if (fmt == chars_format::hex)
+        return to_chars_hex(first, last, parts, has_precision ? precision : -1);
+    if (!has_precision)
+        return to_chars_shortest(first, last, parts, fmt);
+    if (precision < 0)
+        precision = 6;
+    switch (fmt)
+    {
+    case chars_format::fixed:
+        return to_chars_fixed_precision(first, last, parts, precision);
+    case chars_format::scientific:
+        return to_chars_scientific_precision(first, last, parts, precision);
+    default:
+        return to_chars_general_precision(first, last, parts, precision);
+    }
+}
+
+inline bool
+starts_with_icase(const char* first, const char* last, const char* str)
+{
+    for (; *str; ++first, ++str)
+        if (first == last || (*first | 0x20) != *str)
+            return false;
+    return true;
+}
+
+inline bool
+is_digit(char c)
+{
+    return '0' <= c && c <= '9';
+}
+
+inline bool
+is_hex_digit(char c)
+{
+    return is_digit(c) || ('a' <= (c | 0x20) && (c | 0x20) <= 'f');
+}
+
+// Computes significand * 10^exponent when both the significand and the power
+// of ten are exact in _Fp, so that a single multiplication or division rounds
+// correctly. This is Clinger's fast path.
+template <typename _Fp>
+bool
+fast_path(uint64_t significand, int64_t exponent, _Fp& result)
+{
+#if FLT_EVAL_METHOD == 0
+    static const _Fp powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                 1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const int max_exponent = sizeof(_Fp) == sizeof(float) ? 10 : 22;
+    if (significand > (uint64_t(1) << numeric_limits<_Fp>::digits) ||
+        exponent < -max_exponent || exponent > max_exponent)
+        return false;
+    result = static_cast<_Fp>(significand);
+    if (exponent < 0)
+        result /= powers[-exponent];
+    else
+        result *= powers[exponent];
+    return true;
+#else
+    (void)significand;
+    (void)exponent;
+    (void)result;
+    return false;
+#endif
+}
+
+// long double has no fast path, it might have more digits than uint64_t.
+inline bool
+fast_path(uint64_t, int64_t, long double&)
+{
+    return false;
+}
+
+template <typename _Fp>
+from_chars_result
+floating_from_chars(const char* first, const char* last, _Fp& value,
+                    chars_format fmt)
+{
+    const char* p = first;
+    const bool negative = p != last && *p == '-';
+    if (negative)
+        ++p;
+
+    if (starts_with_icase(p, last, "inf"))
+    {
+        p += 3;
+        if (starts_with_icase(p, last, "inity"))
+            p += 5;
+        value = negative ? -numeric_limits<_Fp>::infinity()
+                         : numeric_limits<_Fp>::infinity();
+        return {p, errc(0)};
+    }
+    if (starts_with_icase(p, last, "nan"))
+    {
+        p += 3;
+        if (p != last && *p == '(')
+        {
+            const char* q = p + 1;
+            while (q != last && (is_digit(*q) || *q == '_' ||
+                                 ('a' <= (*q | 0x20) && (*q | 0x20) <= 'z')))
+                ++q;
+            if (q != last && *q == ')')
+                p = q + 1;
+        }
+        value = negative ? -numeric_limits<_Fp>::quiet_NaN()
+                         : numeric_limits<_Fp>::quiet_NaN();
+        return {p, errc(0)};
+    }
+
+    // Scan the significand.
+    const bool hex = fmt == chars_format::hex;
+    const char* begin = p;
+    uint64_t significand = 0;
+    int significant_digits = 0;
+    int64_t exponent_adjustment = 0;
+    bool any_digits = false;
+    bool point = false;
+    bool nonzero = false;
+    for (; p != last; ++p)
+    {
+        if (*p == '.' && !point)
+        {
+            point = true;
+            continue;
+        }
+        if (!(hex ? is_hex_digit(*p) : is_digit(*p)))
+            break;
+        any_digits = true;
+        if (*p != '0')
+            nonzero = true;
+        if (!hex && nonzero)
+        {
+            if (significant_digits < 19)
+                significand = significand * 10 + (*p - '0');
+            ++significant_digits;
+        }
+        if (point)
+            --exponent_adjustment;
+    }
+    if (!any_digits)
+        return {first, errc::invalid_argument};
+
+    // Scan the exponent, which is required in scientific notation, and not
+    // allowed in fixed notation.
+    bool has_exponent = false;
+    int64_t exponent = 0;
+    if ((hex || has_format(fmt, chars_format::scientific)) && p != last &&
+        (*p | 0x20) == (hex ? 'p' : 'e'))
+    {
+        const char* q = p + 1;
+        bool negative_exponent = false;
+        if (q != last && (*q == '+' || *q == '-'))
+            negative_exponent = *q++ == '-';
+        if (q != last && is_digit(*q))
+        {
+            for (; q != last && is_digit(*q); ++q)
+                if (exponent < 100000000)
+                    exponent = exponent * 10 + (*q - '0');
+            if (negative_exponent)
+                exponent = -exponent;
+            has_exponent = true;
+            p = q;
+        }
+    }
+    if (!hex && !has_exponent && !has_format(fmt, chars_format::fixed))
+        return {first, errc::invalid_argument};
+
+    _Fp result;
+    if (hex || significant_digits > 19 ||
+        !fast_path(significand, exponent + exponent_adjustment, result))
+    {
+        // Let the C library, in the C locale, do the hard work.
+        size_t length = static_cast<size_t>(p - begin);
+        char small_buffer[128];
+        unique_ptr<char[]> large_buffer;
+        char* buffer = small_buffer;
+        if (length + 3 > sizeof(small_buffer))
+        {
+            large_buffer.reset(new char[length + 3]);
+            buffer = large_buffer.get();
+        }
+        char* q = buffer;
+        if (hex)
+        {
+            *q++ = '0';
+            *q++ = 'x';
+        }
+        memcpy(q, begin, length);
+        q[length] = '\0';
+        char* end;
+        int saved_errno = errno;
+        result = __do_strtod<_Fp>(buffer, &end);
+        errno = saved_errno;
+    }
+
+    if (result == numeric_limits<_Fp>::infinity() || (result == 0 && nonzero))
+        return {p, errc::result_out_of_range};
+    value = negative ? -result : result;
+    return {p, errc(0)};
+}
+
+}  // namespace
+
+to_chars_result
+to_chars(char* __first, char* __last, float __value)
+{
+    return floating_to_chars<float_traits>(__first, __last, __value,
+                                           chars_format{}, 0, false);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, double __value)
+{
+    return floating_to_chars<double_traits>(__first, __last, __value,
+                                            chars_format{}, 0, false);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, float __value, chars_format __fmt)
+{
+    return floating_to_chars<float_traits>(__first, __last, __value, __fmt, 0,
+                                           false);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, double __value, chars_format __fmt)
+{
+    return floating_to_chars<double_traits>(__first, __last, __value, __fmt, 0,
+                                            false);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, float __value, chars_format __fmt,
+         int __precision)
+{
+    return floating_to_chars<float_traits>(__first, __last, __value, __fmt,
+                                           __precision, true);
+}
+
+to_chars_result
+to_chars(char* __first, char* __last, double __value, chars_format __fmt,
+         int __precision)
+{
+    return floating_to_chars<double_traits>(__first, __last, __value, __fmt,
+                                            __precision, true);
+}
+
+from_chars_result
+from_chars(const char* __first, const char* __last, float& __value,
+           chars_format __fmt)
+{
+    return floating_from_chars(__first, __last, __value, __fmt);
+}
+
+from_chars_result
+from_chars(const char* __first, const char* __last, double& __value,
+           chars_format __fmt)
+{
+    return floating_from_chars(__first, __last, __value, __fmt);
+}
+
+from_chars_result
+from_chars(const char* __first, const char* __last, long double& __value,
+           chars_format __fmt)
+{
+    return floating_from_chars(__first, __last, __value, __fmt);
+}
+
 _LIBCPP_END_NAMESPACE_STD
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <unordered_set>
+
+// Test that the unordered containers only use power of two bucket counts, and
+// still spread consecutive integers over the buckets, when
+// _LIBCPP_ABI_UNORDERED_POWER_OF_TWO_BUCKETS is defined.
+
+// MODULES_DEFINES: _LIBCPP_ABI_UNORDERED_POWER_OF_TWO_BUCKETS
+#define _LIBCPP_ABI_UNORDERED_POWER_OF_TWO_BUCKETS
+#include <unordered_set>
+#include <cassert>
+#include <cstddef>
+
+#include "test_macros.h"
+
+bool is_power_of_two(std::size_t n) { return n != 0 && !(n & (n - 1)); }
+
+int main(int, char**)
+{
+  {
+    std::unordered_set<int> s;
+    for (int i = 0; i < 1000; ++i) {
+      s.insert(i);
+      assert(is_power_of_two(s.bucket_count()));
+      assert(s.load_factor() <= s.max_load_factor());
+    }
+    for (int i = 0; i < 1000; ++i)
+      assert(*s.find(i) == i);
+  }
+  {
+    std::unordered_set<int> s;
+    s.rehash(1);
+    assert(s.bucket_count() == 1);
+    s.rehash(100);
+    assert(s.bucket_count() == 128);
+    s.reserve(200);
+    assert(s.bucket_count() == 256);
+    s.insert(1);
+    s.rehash(0);
+    assert(s.bucket_count() == 1);
+    assert(s.bucket(1) == 0);
+  }
+  {
+    // Multiples of the bucket count must not end up in a single bucket.
+    std::unordered_set<std::size_t> s;
+    s.rehash(64);
+    for (std::size_t i = 0; i < 64; ++i)
+      s.insert(i * 64);
+    assert(s.bucket_count() == 64);
+    for (std::size_t b = 0; b < s.bucket_count(); ++b)
+      assert(s.bucket_size(b) <= 4);
+  }
+
+  return 0;
+}
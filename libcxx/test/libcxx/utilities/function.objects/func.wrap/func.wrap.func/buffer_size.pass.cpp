@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// <functional>
+
+// Test that _LIBCPP_ABI_FUNCTION_BUFFER_SIZE controls which callables
+// std::function stores without allocating.
+
+// MODULES_DEFINES: _LIBCPP_ABI_FUNCTION_BUFFER_SIZE=64
+#define _LIBCPP_ABI_FUNCTION_BUFFER_SIZE 64
+#include <functional>
+#include <cassert>
+
+#include "test_macros.h"
+#include "count_new.h"
+
+template <int N>
+struct Small
+{
+    void* pointers[N];
+    int operator()() const { return N; }
+};
+
+int main(int, char**)
+{
+    static_assert(sizeof(std::function<int()>) >= 64, "");
+
+    globalMemCounter.reset();
+    {
+        std::function<int()> f = Small<6>();
+        assert(globalMemCounter.checkOutstandingNewEq(0));
+        assert(f() == 6);
+        std::function<int()> g = std::move(f);
+        assert(globalMemCounter.checkOutstandingNewEq(0));
+        assert(g() == 6);
+        std::function<int()> h = g;
+        assert(globalMemCounter.checkOutstandingNewEq(0));
+        assert(h() == 6);
+        h.swap(f);
+        assert(f() == 6);
+        assert(globalMemCounter.checkOutstandingNewEq(0));
+    }
+    {
+        std::function<int()> f = Small<32>();
+        assert(globalMemCounter.checkOutstandingNewEq(1));
+        assert(f() == 32);
+    }
+    assert(globalMemCounter.checkOutstandingNewEq(0));
+
+    return 0;
+}
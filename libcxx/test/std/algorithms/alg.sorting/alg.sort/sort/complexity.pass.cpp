@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// template<RandomAccessIterator Iter, StrictWeakOrder<auto, Iter::value_type> Compare>
+//   requires ShuffleIterator<Iter>
+//         && CopyConstructible<Compare>
+//   void
+//   sort(Iter first, Iter last, Compare comp);
+
+// Complexity: O(N log(N)) comparisons, even for input that is built to make
+// quicksort go quadratic, and for already sorted or reversed input.
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <random>
+#include <cassert>
+#include <cstddef>
+
+#include "test_macros.h"
+
+std::mt19937 randomness;
+
+int log2i(int n)
+{
+    int l = 0;
+    while (n > 1)
+    {
+        ++l;
+        n >>= 1;
+    }
+    return l;
+}
+
+struct counting_less
+{
+    int* count_;
+    explicit counting_less(int* count) : count_(count) {}
+    bool operator()(int x, int y) const
+    {
+        ++*count_;
+        return x < y;
+    }
+};
+
+// The adversary from "A Killer Adversary for Quicksort" by McIlroy: the values
+// are only decided as the sort compares them, in the way that makes the
+// pivots as bad as possible.
+struct adversary_less
+{
+    std::vector<int>* values_;
+    int* nsolid_;
+    int* candidate_;
+    int* count_;
+    int gas_;
+
+    bool operator()(int x, int y) const
+    {
+        std::vector<int>& values = *values_;
+        ++*count_;
+        if (values[x] == gas_ && values[y] == gas_)
+        {
+            if (x == *candidate_)
+                values[x] = (*nsolid_)++;
+            else
+                values[y] = (*nsolid_)++;
+        }
+        if (values[x] == gas_)
+            *candidate_ = x;
+        else if (values[y] == gas_)
+            *candidate_ = y;
+        return values[x] < values[y];
+    }
+};
+
+void test_adversary(int n)
+{
+    std::vector<int> values(n, n);
+    std::vector<int> indices(n);
+    for (int i = 0; i < n; ++i)
+        indices[i] = i;
+    int nsolid = 0;
+    int candidate = 0;
+    int count = 0;
+    adversary_less comp = {&values, &nsolid, &candidate, &count, n};
+    std::sort(indices.begin(), indices.end(), comp);
+    for (int i = 1; i < n; ++i)
+        assert(values[indices[i - 1]] <= values[indices[i]]);
+    assert(count <= 8 * n * log2i(n));
+}
+
+void test_patterns(int n)
+{
+    std::vector<int> v(n);
+    for (int i = 0; i < n; ++i)
+        v[i] = i;
+    int count = 0;
+    std::sort(v.begin(), v.end(), counting_less(&count));
+    assert(std::is_sorted(v.begin(), v.end()));
+    assert(count <= 3 * n);
+
+    std::reverse(v.begin(), v.end());
+    count = 0;
+    std::sort(v.begin(), v.end(), counting_less(&count));
+    assert(std::is_sorted(v.begin(), v.end()));
+    assert(count <= 3 * n);
+
+    std::fill(v.begin(), v.end(), 42);
+    count = 0;
+    std::sort(v.begin(), v.end(), counting_less(&count));
+    assert(count <= 3 * n);
+}
+
+// Arithmetic types with the standard comparators take a different partition
+// than everything else.
+template <class T, class Compare>
+void test_arithmetic(int n, int distinct, Compare comp)
+{
+    std::vector<T> v(n);
+    for (int i = 0; i < n; ++i)
+        v[i] = static_cast<T>(randomness() % distinct);
+    std::vector<T> expected(v);
+    std::stable_sort(expected.begin(), expected.end(), comp);
+    std::sort(v.begin(), v.end(), comp);
+    assert(v == expected);
+}
+
+template <class T>
+void test_arithmetic(int n, int distinct)
+{
+    std::vector<T> v(n);
+    for (int i = 0; i < n; ++i)
+        v[i] = static_cast<T>(randomness() % distinct);
+    std::vector<T> expected(v);
+    std::stable_sort(expected.begin(), expected.end());
+    std::sort(&v[0], &v[0] + n);
+    assert(v == expected);
+    test_arithmetic<T>(n, distinct, std::less<T>());
+    test_arithmetic<T>(n, distinct, std::greater<T>());
+}
+
+int main(int, char**)
+{
+    test_adversary(1000);
+    test_adversary(10000);
+
+    test_patterns(1000);
+    test_patterns(100000);
+
+    const int sizes[] = {31, 64, 100, 129, 500, 1000, 4096, 10007};
+    const int distincts[] = {2, 10, 1000, 1000000};
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        for (std::size_t j = 0; j < sizeof(distincts) / sizeof(distincts[0]); ++j)
+        {
+            test_arithmetic<int>(sizes[i], distincts[j]);
+            test_arithmetic<unsigned long long>(sizes[i], distincts[j]);
+            test_arithmetic<double>(sizes[i], distincts[j]);
+        }
+        test_arithmetic<unsigned char>(sizes[i], 256);
+    }
+
+  return 0;
+}
@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// The floating point overloads of from_chars are not in any released dylib.
+//
+// XFAIL: with_system_cxx_lib=macosx10.15
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// from_chars_result from_chars(const char* first, const char* last,
+//                              Floating& value,
+//                              chars_format fmt = chars_format::general);
+
+#include <charconv>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "test_macros.h"
+
+template <typename T>
+void test(const char* s, std::chars_format fmt, std::size_t consumed,
+          T expected)
+{
+    T x = T(-42);
+    std::from_chars_result r = std::from_chars(s, s + std::strlen(s), x, fmt);
+    assert(r.ec == std::errc());
+    assert(r.ptr == s + consumed);
+    assert(x == expected);
+    assert(std::signbit(x) == std::signbit(expected));
+}
+
+template <typename T>
+void test(const char* s, T expected)
+{
+    test(s, std::chars_format::general, std::strlen(s), expected);
+}
+
+template <typename T>
+void test_error(const char* s, std::chars_format fmt, std::errc ec,
+                std::size_t consumed)
+{
+    T x = T(-42);
+    std::from_chars_result r = std::from_chars(s, s + std::strlen(s), x, fmt);
+    assert(r.ec == ec);
+    assert(r.ptr == s + consumed);
+    assert(x == T(-42));
+}
+
+template <typename T>
+void test_basics()
+{
+    using std::chars_format;
+    const T inf = std::numeric_limits<T>::infinity();
+
+    test("0", T(0));
+    test("-0", -T(0));
+    test("1", T(1));
+    test("0.5", T(0.5));
+    test("-2.5e3", T(-2500));
+    test("1E2", T(100));
+    test("00012.500", T(12.5));
+    test(".25", T(0.25));
+    test("3.", T(3));
+    test("0.0001220703125", T(0.0001220703125));
+    test("125e-3", T(0.125));
+    test("625e-4", T(0.0625));
+    test("inf", inf);
+    test("-INF", -inf);
+    test("Infinity", inf);
+    test("infinite", chars_format::general, 3, inf);
+
+    // The pattern stops at the first character that cannot continue it.
+    test("1.5x", chars_format::general, 3, T(1.5));
+    test("1e", chars_format::general, 1, T(1));
+    test("1e+", chars_format::general, 1, T(1));
+    test("2.5e+1.5", chars_format::general, 6, T(25));
+    test("0x1p3", chars_format::general, 1, T(0));
+
+    // fixed does not accept an exponent, scientific requires one.
+    test("1e5", chars_format::fixed, 1, T(1));
+    test("1.25e2", chars_format::scientific, 6, T(125));
+    test_error<T>("1.25", chars_format::scientific,
+                  std::errc::invalid_argument, 0);
+
+    // hex has no 0x prefix and a binary exponent.
+    test("1p3", chars_format::hex, 3, T(8));
+    test("-1.8p-1", chars_format::hex, 7, T(-0.75));
+    test("a", chars_format::hex, 1, T(10));
+    test("0x10", chars_format::hex, 1, T(0));
+    test("1.fp", chars_format::hex, 3, T(1.9375));
+
+    test_error<T>("", chars_format::general, std::errc::invalid_argument, 0);
+    test_error<T>(".", chars_format::general, std::errc::invalid_argument, 0);
+    test_error<T>("-", chars_format::general, std::errc::invalid_argument, 0);
+    test_error<T>("e5", chars_format::general, std::errc::invalid_argument, 0);
+    test_error<T>(" 1", chars_format::general, std::errc::invalid_argument, 0);
+    // Unlike strtod, a leading '+' is not allowed.
+    test_error<T>("+1", chars_format::general, std::errc::invalid_argument, 0);
+    test_error<T>("in", chars_format::general, std::errc::invalid_argument, 0);
+
+    // Values that do not fit leave the value alone.
+    test_error<T>("1e99999", chars_format::general,
+                  std::errc::result_out_of_range, 7);
+    test_error<T>("-1e-99999", chars_format::general,
+                  std::errc::result_out_of_range, 9);
+    test_error<T>("1p99999", chars_format::hex,
+                  std::errc::result_out_of_range, 7);
+}
+
+template <typename T>
+void test_nan()
+{
+    const char* strings[] = {"nan", "-nan", "NaN", "nan()", "nan(123_abc)"};
+    for (const char* s : strings)
+    {
+        T x;
+        std::from_chars_result r = std::from_chars(s, s + std::strlen(s), x);
+        assert(r.ec == std::errc());
+        assert(r.ptr == s + std::strlen(s));
+        assert(std::isnan(x));
+        assert(std::signbit(x) == (s[0] == '-'));
+    }
+
+    // An unterminated payload is not part of the pattern.
+    const char s[] = "nan(12";
+    T x;
+    std::from_chars_result r = std::from_chars(s, s + sizeof(s) - 1, x);
+    assert(r.ec == std::errc());
+    assert(r.ptr == s + 3);
+    assert(std::isnan(x));
+}
+
+int main(int, char**)
+{
+    test_basics<float>();
+    test_basics<double>();
+    test_basics<long double>();
+    test_nan<float>();
+    test_nan<double>();
+
+    // Correctly rounded results, including the halfway cases that defeat a
+    // naive parser.
+    test("0.1", 0.1);
+    test("0.3", 0.3);
+    test("9007199254740993", 9007199254740992.0);
+    test("9007199254740995", 9007199254740996.0);
+    test("2.2250738585072011e-308", 2.2250738585072011e-308);
+    test("4.9406564584124654e-324", 5e-324);
+    test("2.4703282292062328e-324", 5e-324);
+    test("1.7976931348623157e308", 1.7976931348623157e308);
+    test("123456789012345678901234567890", 1.2345678901234568e29);
+    test("0.1", 0.1f);
+    test("16777217", 16777216.0f);
+    test("3.4028235e38", 3.4028235e38f);
+    test("1e-45", 1e-45f);
+    test_error<double>("1e400", std::chars_format::general,
+                       std::errc::result_out_of_range, 5);
+    test_error<float>("1e-50", std::chars_format::general,
+                      std::errc::result_out_of_range, 5);
+
+    return 0;
+}
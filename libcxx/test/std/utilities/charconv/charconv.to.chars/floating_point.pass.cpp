@@ -0,0 +1,258 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// The floating point overloads of to_chars are not in any released dylib.
+//
+// XFAIL: with_system_cxx_lib=macosx10.15
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// to_chars_result to_chars(char* first, char* last, Floating value);
+// to_chars_result to_chars(char* first, char* last, Floating value,
+//                          chars_format fmt);
+// to_chars_result to_chars(char* first, char* last, Floating value,
+//                          chars_format fmt, int precision);
+
+#include <charconv>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include "test_macros.h"
+
+template <typename T>
+void test(T value, const char* expected)
+{
+    char buf[400];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value);
+    assert(r.ec == std::errc());
+    assert(r.ptr - buf == static_cast<std::ptrdiff_t>(std::strlen(expected)));
+    assert(std::memcmp(buf, expected, r.ptr - buf) == 0);
+
+    // The output must fit exactly.
+    r = std::to_chars(buf, buf + std::strlen(expected), value);
+    assert(r.ec == std::errc());
+    r = std::to_chars(buf, buf + std::strlen(expected) - 1, value);
+    assert(r.ec == std::errc::value_too_large);
+    assert(r.ptr == buf + std::strlen(expected) - 1);
+}
+
+template <typename T>
+void test(T value, std::chars_format fmt, const char* expected)
+{
+    char buf[400];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value, fmt);
+    assert(r.ec == std::errc());
+    assert(r.ptr - buf == static_cast<std::ptrdiff_t>(std::strlen(expected)));
+    assert(std::memcmp(buf, expected, r.ptr - buf) == 0);
+
+    r = std::to_chars(buf, buf + std::strlen(expected) - 1, value, fmt);
+    assert(r.ec == std::errc::value_too_large);
+}
+
+template <typename T>
+void test(T value, std::chars_format fmt, int precision, const char* expected)
+{
+    char buf[400];
+    std::to_chars_result r =
+        std::to_chars(buf, buf + sizeof(buf), value, fmt, precision);
+    assert(r.ec == std::errc());
+    assert(r.ptr - buf == static_cast<std::ptrdiff_t>(std::strlen(expected)));
+    assert(std::memcmp(buf, expected, r.ptr - buf) == 0);
+
+    r = std::to_chars(buf, buf + std::strlen(expected) - 1, value, fmt,
+                      precision);
+    assert(r.ec == std::errc::value_too_large);
+}
+
+void test_shortest()
+{
+    // Fixed notation is used when it is not longer than scientific notation.
+    test(0.0, "0");
+    test(-0.0, "-0");
+    test(1.0, "1");
+    test(0.1, "0.1");
+    test(0.3, "0.3");
+    test(1.0 / 3, "0.3333333333333333");
+    test(123456.0, "123456");
+    test(1e4, "10000");
+    test(1e5, "1e+05");
+    test(120000.0, "120000");
+    test(1234567e5, "123456700000");
+    test(1234567e6, "1.234567e+12");
+    test(1e-3, "0.001");
+    test(1e-4, "1e-04");
+    test(1.5e-5, "1.5e-05");
+    test(1.2345e-4, "0.00012345");
+    test(1.2345e-5, "1.2345e-05");
+    test(1.2345e-8, "1.2345e-08");
+    test(1e23, "1e+23");
+    test(5e-324, "5e-324");
+    test(-1.7976931348623157e308, "-1.7976931348623157e+308");
+    test(2.2250738585072014e-308, "2.2250738585072014e-308");
+    // Integers that need all their digits are printed exactly.
+    test(1152921504606846976.0, "1152921504606846976");
+    test(std::numeric_limits<double>::infinity(), "inf");
+    test(-std::numeric_limits<double>::infinity(), "-inf");
+    test(std::numeric_limits<double>::quiet_NaN(), "nan");
+
+    test(0.1f, "0.1");
+    test(3.14f, "3.14");
+    test(16777216.0f, "16777216");
+    test(3.4028235e38f, "3.4028235e+38");
+    test(1e-45f, "1e-45");
+    test(1.17549435e-38f, "1.1754944e-38");
+    test(-std::numeric_limits<float>::infinity(), "-inf");
+
+    test(0.5L, "0.5");
+}
+
+void test_shortest_format()
+{
+    using std::chars_format;
+    test(0.0, chars_format::fixed, "0");
+    test(0.0, chars_format::scientific, "0e+00");
+    test(0.0, chars_format::general, "0");
+    test(0.0, chars_format::hex, "0p+0");
+
+    test(1e5, chars_format::fixed, "100000");
+    test(1e5, chars_format::general, "100000");
+    test(1e6, chars_format::general, "1e+06");
+    test(1e-4, chars_format::general, "0.0001");
+    test(1e-5, chars_format::general, "1e-05");
+    test(1e-5, chars_format::fixed, "0.00001");
+    test(123.456, chars_format::scientific, "1.23456e+02");
+    test(1e100, chars_format::scientific, "1e+100");
+    test(1e23, chars_format::fixed, "99999999999999991611392");
+    test(1e22, chars_format::fixed, "10000000000000000000000");
+    test(-2.5e-10, chars_format::fixed, "-0.00000000025");
+
+    test(1.0, chars_format::hex, "1p+0");
+    test(-0.1, chars_format::hex, "-1.999999999999ap-4");
+    test(5e-324, chars_format::hex, "0.0000000000001p-1022");
+    test(1.7976931348623157e308, chars_format::hex, "1.fffffffffffffp+1023");
+    test(0.1f, chars_format::hex, "1.99999ap-4");
+    test(1e-45f, chars_format::hex, "0.000002p-126");
+
+    test(1.5f, chars_format::scientific, "1.5e+00");
+    test(1e10f, chars_format::fixed, "10000000000");
+    test(3e10f, chars_format::fixed, "30000001024");
+}
+
+void test_precision()
+{
+    using std::chars_format;
+    test(0.0, chars_format::fixed, 0, "0");
+    test(0.0, chars_format::fixed, 3, "0.000");
+    test(0.0, chars_format::scientific, 2, "0.00e+00");
+    test(0.0, chars_format::general, 2, "0");
+    test(0.0, chars_format::hex, 2, "0.00p+0");
+
+    test(1.0 / 3, chars_format::fixed, 5, "0.33333");
+    test(2.0 / 3, chars_format::fixed, 5, "0.66667");
+    test(0.1, chars_format::fixed, 20, "0.10000000000000000555");
+    test(1e23, chars_format::fixed, 2, "99999999999999991611392.00");
+    test(5e-324, chars_format::scientific, 16, "4.9406564584124654e-324");
+    test(123.456, chars_format::scientific, 0, "1e+02");
+    test(9.5, chars_format::scientific, 0, "1e+01");
+    test(99.99, chars_format::fixed, 1, "100.0");
+
+    // Ties are rounded to even.
+    test(0.5, chars_format::fixed, 0, "0");
+    test(1.5, chars_format::fixed, 0, "2");
+    test(2.5, chars_format::fixed, 0, "2");
+    test(0.125, chars_format::fixed, 2, "0.12");
+    test(0.375, chars_format::fixed, 2, "0.38");
+    test(2.5, chars_format::scientific, 0, "2e+00");
+
+    test(123456.0, chars_format::general, 6, "123456");
+    test(1234567.0, chars_format::general, 6, "1.23457e+06");
+    test(0.0001, chars_format::general, 3, "0.0001");
+    test(0.00001234, chars_format::general, 3, "1.23e-05");
+    test(100.0, chars_format::general, 0, "1e+02");
+    test(0.5, chars_format::general, 10, "0.5");
+    test(1e20, chars_format::general, 25, "100000000000000000000");
+
+    test(1.0, chars_format::hex, 0, "1p+0");
+    test(1.5, chars_format::hex, 0, "2p+0");
+    test(1.5, chars_format::hex, 3, "1.800p+0");
+    test(0.1, chars_format::hex, 4, "1.999ap-4");
+    test(0.1, chars_format::hex, 15, "1.999999999999a00p-4");
+
+    // A negative precision is taken as if it was omitted.
+    test(1.0 / 3, chars_format::fixed, -1, "0.333333");
+    test(1.0 / 3, chars_format::hex, -1, "1.5555555555555p-2");
+
+    test(0.1f, chars_format::fixed, 10, "0.1000000015");
+    test(1e10f, chars_format::scientific, 3, "1.000e+10");
+    test(0.1f, chars_format::hex, 2, "1.9ap-4");
+
+    test(std::numeric_limits<double>::infinity(), chars_format::fixed, 5,
+         "inf");
+    test(-std::numeric_limits<float>::quiet_NaN(), chars_format::general, 5,
+         "-nan");
+}
+
+template <typename T>
+void test_roundtrip(T value)
+{
+    char buf[400];
+    const std::chars_format formats[] = {
+        std::chars_format{}, std::chars_format::fixed,
+        std::chars_format::scientific, std::chars_format::general,
+        std::chars_format::hex};
+    for (std::chars_format fmt : formats)
+    {
+        std::to_chars_result r =
+            fmt == std::chars_format{}
+                ? std::to_chars(buf, buf + sizeof(buf), value)
+                : std::to_chars(buf, buf + sizeof(buf), value, fmt);
+        assert(r.ec == std::errc());
+        T parsed;
+        std::from_chars_result p = std::from_chars(
+            buf, r.ptr, parsed,
+            fmt == std::chars_format{} ? std::chars_format::general : fmt);
+        assert(p.ec == std::errc());
+        assert(p.ptr == r.ptr);
+        assert(std::memcmp(&parsed, &value, sizeof(T)) == 0);
+    }
+}
+
+int main(int, char**)
+{
+    test_shortest();
+    test_shortest_format();
+    test_precision();
+
+    double d = 1.0;
+    float f = 1.0f;
+    for (int i = 0; i < 300; ++i)
+    {
+        test_roundtrip(d);
+        test_roundtrip(-1 / d);
+        test_roundtrip(d / 7);
+        test_roundtrip(f);
+        test_roundtrip(f / 7);
+        d *= 10.5;
+        f *= 1.25f;
+    }
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+#===----------------------------------------------------------------------===##
+#
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+#===----------------------------------------------------------------------===##
+
+"""Compare the results of two runs of the libc++ benchmarks.
+
+Each input is the JSON output of a benchmark executable, as written by
+--benchmark_out=<file> --benchmark_out_format=json. Run both builds with
+--benchmark_repetitions=N (N >= 5 or so) so that every benchmark has several
+samples; a single sample per side cannot tell a change from noise.
+
+For every benchmark present in both files, the medians are compared and a
+two-sided Mann-Whitney U test decides whether the difference is significant.
+Only significant differences larger than --threshold are reported unless
+--all is given.
+
+Example:
+  ./string.libcxx.out --benchmark_repetitions=10 \\
+      --benchmark_out=old.json --benchmark_out_format=json
+  (rebuild)
+  ./string.libcxx.out --benchmark_repetitions=10 \\
+      --benchmark_out=new.json --benchmark_out_format=json
+  compare-benchmarks.py old.json new.json --fail-on-regression
+"""
+
+import argparse
+import json
+import math
+import re
+import sys
+
+TIME_UNIT_TO_NS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def load_samples(path, metric):
+    """Returns a dict from benchmark name to the list of its samples in ns."""
+    with open(path) as f:
+        data = json.load(f)
+    samples = {}
+    for bench in data.get('benchmarks', []):
+        # Skip the mean/median/stddev entries added for repetitions, and the
+        # runs that reported an error.
+        if bench.get('run_type', 'iteration') != 'iteration':
+            continue
+        if 'aggregate_name' in bench or bench.get('error_occurred'):
+            continue
+        name = bench.get('run_name', bench['name'])
+        scale = TIME_UNIT_TO_NS[bench.get('time_unit', 'ns')]
+        samples.setdefault(name, []).append(bench[metric] * scale)
+    return samples
+
+
+def median(values):
+    s = sorted(values)
+    n = len(s)
+    if n % 2:
+        return s[n // 2]
+    return (s[n // 2 - 1] + s[n // 2]) / 2.0
+
+
+def mann_whitney_p_value(a, b):
+    """Two-sided p-value of the Mann-Whitney U test.
+
+    Uses the normal approximation with the tie correction, which is good
+    enough from about 5 samples on each side and needs nothing outside of the
+    standard library.
+    """
+    n1, n2 = len(a), len(b)
+    combined = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    # Assign average ranks to ties.
+    ranks = [0.0] * len(combined)
+    tie_term = 0.0
+    i = 0
+    while i < len(combined):
+        j = i
+        while j + 1 < len(combined) and combined[j + 1][0] == combined[i][0]:
+            j += 1
+        rank = (i + j) / 2.0 + 1
+        for k in range(i, j + 1):
+            ranks[k] = rank
+        t = j - i + 1
+        tie_term += t * t * t - t
+        i = j + 1
+    r1 = sum(r for r, (_, side) in zip(ranks, combined) if side == 0)
+    u = r1 - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    # Continuity correction towards the mean.
+    z = (abs(u - mean) - 0.5) / math.sqrt(variance)
+    if z <= 0:
+        return 1.0
+    return math.erfc(z / math.sqrt(2))
+
+
+def format_time(ns):
+    for unit, scale in (('s', 1e9), ('ms', 1e6), ('us', 1e3)):
+        if ns >= scale:
+            return '%.3f %s' % (ns / scale, unit)
+    return '%.3f ns' % ns
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('baseline', help='JSON results of the old build')
+    parser.add_argument('candidate', help='JSON results of the new build')
+    parser.add_argument('--metric', choices=['cpu_time', 'real_time'],
+                        default='cpu_time',
+                        help='Which time to compare (default: %(default)s)')
+    parser.add_argument('--alpha', type=float, default=0.05,
+                        help='Significance level (default: %(default)s)')
+    parser.add_argument('--threshold', type=float, default=2.0,
+                        help='Smallest change in percent worth reporting '
+                             '(default: %(default)s)')
+    parser.add_argument('--filter', default=None,
+                        help='Only compare benchmarks matching this regex')
+    parser.add_argument('--all', action='store_true',
+                        help='Report every benchmark, not only the changes')
+    parser.add_argument('--fail-on-regression', action='store_true',
+                        help='Exit with status 1 if anything got slower')
+    args = parser.parse_args()
+
+    old = load_samples(args.baseline, args.metric)
+    new = load_samples(args.candidate, args.metric)
+    name_filter = re.compile(args.filter) if args.filter else None
+
+    rows = []
+    regressions = 0
+    improvements = 0
+    few_samples = 0
+    for name in sorted(set(old) & set(new)):
+        if name_filter and not name_filter.search(name):
+            continue
+        a, b = old[name], new[name]
+        old_median, new_median = median(a), median(b)
+        if old_median == 0:
+            continue
+        delta = (new_median - old_median) / old_median * 100.0
+        if min(len(a), len(b)) < 2:
+            few_samples += 1
+            p = float('nan')
+            significant = False
+        else:
+            p = mann_whitney_p_value(a, b)
+            significant = p < args.alpha and abs(delta) >= args.threshold
+        if significant:
+            if delta > 0:
+                regressions += 1
+            else:
+                improvements += 1
+        if significant or args.all:
+            rows.append((name, old_median, new_median, delta, p, significant))
+
+    if rows:
+        width = max([len('Benchmark')] + [len(r[0]) for r in rows])
+        print('%-*s %14s %14s %9s %8s' % (width, 'Benchmark', 'Old', 'New',
+                                          'Delta', 'p'))
+        for name, old_median, new_median, delta, p, significant in rows:
+            print('%-*s %14s %14s %+8.2f%% %8.4f%s' % (
+                width, name, format_time(old_median), format_time(new_median),
+                delta, p, '' if significant else '  (noise)'))
+        print()
+
+    only_old = sorted(set(old) - set(new))
+    only_new = sorted(set(new) - set(old))
+    for name in only_old:
+        print('note: %s only present in %s' % (name, args.baseline))
+    for name in only_new:
+        print('note: %s only present in %s' % (name, args.candidate))
+    if few_samples:
+        print('warning: %d benchmarks have a single sample, rerun with '
+              '--benchmark_repetitions to compare them' % few_samples)
+    print('%d significant regressions, %d significant improvements' % (
+        regressions, improvements))
+
+    if args.fail_on_regression and regressions:
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -59,6 +59,7 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ScopedPrinter.h"
+#include <atomic>
 #include <memory>
 
 using namespace llvm;
@@ -111,6 +112,14 @@ public:
   /// externally.
   void addObjFile(ObjFile *file, CVIndexMap *externIndexMap = nullptr);
 
+  /// With /DEBUG:GHASH, merge the type records of all object files at once
+  /// using all threads, and remember the resulting type index maps for
+  /// mergeDebugT. The result is the same as merging the objects one by one in
+  /// order. If any object uses a type server or precompiled headers, or has a
+  /// type stream that isn't topologically sorted, this does nothing and the
+  /// objects are merged one by one.
+  void mergeTypesInParallel();
+
   /// Produce a mapping from the type and item indices used in the object
   /// file to those in the destination PDB.
   ///
@@ -184,6 +193,9 @@ private:
   /// far.
   std::map<uint32_t, CVIndexMap> precompTypeIndexMappings;
 
+  /// Type index mappings of object files computed by mergeTypesInParallel().
+  llvm::DenseMap<const ObjFile *, CVIndexMap> ghashIndexMaps;
+
   // For statistics
   uint64_t globalSymbols = 0;
   uint64_t moduleSymbols = 0;
@@ -397,7 +409,11 @@ PDBLinker::mergeDebugT(ObjFile *file, CVIndexMap *objectIndexMap) {
   }
 
   // Fill in the temporary, caller-provided ObjectIndexMap.
-  if (config->debugGHashes) {
+  auto it = ghashIndexMaps.find(file);
+  if (it != ghashIndexMaps.end()) {
+    // The types were already merged by mergeTypesInParallel().
+    objectIndexMap = &it->second;
+  } else if (config->debugGHashes) {
     ArrayRef<GloballyHashedType> hashes;
     std::vector<GloballyHashedType> ownedHashes;
     if (Optional<ArrayRef<uint8_t>> debugH = getDebugH(file))
@@ -443,6 +459,282 @@ PDBLinker::mergeDebugT(ObjFile *file, CVIndexMap *objectIndexMap) {
   return *objectIndexMap;
 }
 
+namespace {
+// A lock-free hash table used by mergeTypesInParallel() to find the first
+// occurrence of each global type hash. Each cell holds a hash and the position
+// of the earliest record with that hash seen so far, packed as
+// (file index << 32 | record index). Since an insertion can only lower the
+// position, the final contents don't depend on the order of insertions.
+//
+// A hash value of zero marks an empty cell, so callers must not insert zero.
+class GHashTable {
+public:
+  explicit GHashTable(size_t numRecords) {
+    // Keep the load factor at or below 50% so that probe sequences are short.
+    size_t capacity = PowerOf2Ceil(std::max<size_t>(numRecords * 2, 16));
+    cells.reset(new Cell[capacity]);
+    mask = capacity - 1;
+  }
+
+  void insert(uint64_t hash, uint64_t pos) {
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      Cell &c = cells[i];
+      uint64_t key = c.key.load(std::memory_order_relaxed);
+      if (key == 0 && c.key.compare_exchange_strong(key, hash,
+                                                    std::memory_order_relaxed))
+        key = hash;
+      if (key != hash)
+        continue;
+
+      uint64_t old = c.pos.load(std::memory_order_relaxed);
+      while (pos < old && !c.pos.compare_exchange_weak(
+                              old, pos, std::memory_order_relaxed))
+        ;
+      return;
+    }
+  }
+
+  // Returns the index of the cell for a hash that has been inserted.
+  size_t find(uint64_t hash) const {
+    for (size_t i = hash & mask;; i = (i + 1) & mask)
+      if (cells[i].key.load(std::memory_order_relaxed) == hash)
+        return i;
+  }
+
+  uint64_t getPos(size_t cell) const {
+    return cells[cell].pos.load(std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return mask + 1; }
+
+private:
+  struct Cell {
+    std::atomic<uint64_t> key{0};
+    std::atomic<uint64_t> pos{UINT64_MAX};
+  };
+
+  std::unique_ptr<Cell[]> cells;
+  size_t mask;
+};
+
+// The type stream of an object file being merged by mergeTypesInParallel().
+struct GHashSource {
+  ObjFile *file;
+  std::vector<CVType> records;
+  ArrayRef<GloballyHashedType> hashes;
+  std::vector<GloballyHashedType> ownedHashes;
+
+  // The hash table cell of each record.
+  std::vector<size_t> cells;
+
+  // Indices of the records that are the first occurrences of their hashes,
+  // and copies of them with type indices remapped to the output PDB.
+  std::vector<uint32_t> uniqueRecords;
+  std::vector<uint8_t> remappedData;
+  std::vector<uint32_t> remappedOffsets;
+
+  uint32_t typeBase = 0;
+  uint32_t itemBase = 0;
+};
+} // namespace
+
+static uint64_t getHashValue(GloballyHashedType h) {
+  return support::endian::read64le(h.Hash.data());
+}
+
+// Returns true if the type stream can be merged by mergeTypesInParallel(),
+// i.e. there is a non-zero hash for each record and records only refer to
+// records that precede them.
+static bool canMergeInParallel(const GHashSource &src) {
+  if (src.hashes.size() != src.records.size())
+    return false;
+
+  SmallVector<TiReference, 4> refs;
+  for (uint32_t i = 0, e = src.records.size(); i != e; ++i) {
+    const CVType &ty = src.records[i];
+    if (ty.kind() == LF_ENDPRECOMP || getHashValue(src.hashes[i]) == 0)
+      return false;
+
+    refs.clear();
+    discoverTypeIndices(ty.RecordData, refs);
+    const uint8_t *content = ty.RecordData.data() + sizeof(RecordPrefix);
+    for (const TiReference &ref : refs) {
+      if (sizeof(RecordPrefix) + ref.Offset + ref.Count * sizeof(TypeIndex) >
+          ty.RecordData.size())
+        return false;
+      for (uint32_t j = 0; j < ref.Count; ++j) {
+        TypeIndex ti(support::endian::read32le(
+            content + ref.Offset + j * sizeof(TypeIndex)));
+        if (!ti.isSimple() && ti.toArrayIndex() >= i)
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Appends a copy of a type record with its type indices remapped to Out, and
+// pads it to a multiple of 4 bytes as TypeStreamMerger does.
+static void remapTypeRecord(const CVType &ty, ArrayRef<TypeIndex> indexMap,
+                            std::vector<uint8_t> &out) {
+  size_t start = out.size();
+  size_t size = ty.RecordData.size();
+  out.insert(out.end(), ty.RecordData.begin(), ty.RecordData.end());
+
+  SmallVector<TiReference, 4> refs;
+  discoverTypeIndices(ty.RecordData, refs);
+  uint8_t *content = out.data() + start + sizeof(RecordPrefix);
+  for (const TiReference &ref : refs) {
+    for (uint32_t i = 0; i < ref.Count; ++i) {
+      uint8_t *p = content + ref.Offset + i * sizeof(TypeIndex);
+      TypeIndex ti(support::endian::read32le(p));
+      if (!ti.isSimple())
+        support::endian::write32le(p,
+                                   indexMap[ti.toArrayIndex()].getIndex());
+    }
+  }
+
+  if (size_t align = size & 3) {
+    auto *prefix = reinterpret_cast<RecordPrefix *>(out.data() + start);
+    prefix->RecordLen += 4 - align;
+    for (; align < 4; ++align)
+      out.push_back(LF_PAD4 - align);
+  }
+}
+
+// Merging type records one object at a time is inherently serial, as the
+// output type index of a record depends on all records merged before it. But
+// with global hashes, we can compute the same result in parallel: the record
+// that ends up in the output for a hash is its first occurrence in command
+// line order, and output type indices are assigned in the order of first
+// occurrences. We find first occurrences by inserting all hashes into a
+// concurrent hash table, assign type indices using the per-file numbers of
+// first occurrences, and then remap the type indices in all records in
+// parallel. Only the final copy of unique records into the type tables is
+// serial.
+void PDBLinker::mergeTypesInParallel() {
+  ScopedTimer t(typeMergingTimer);
+
+  std::vector<GHashSource> srcs;
+  for (ObjFile *file : ObjFile::instances) {
+    if (!file->debugTypesObj)
+      continue;
+    if (file->debugTypesObj->kind != TpiSource::Regular)
+      return;
+    srcs.emplace_back();
+    srcs.back().file = file;
+  }
+  if (srcs.empty())
+    return;
+
+  // Read records and hashes.
+  std::vector<uint8_t> ok(srcs.size());
+  parallelForEachN(0, srcs.size(), [&](size_t i) {
+    GHashSource &src = srcs[i];
+    CVTypeArray types;
+    BinaryStreamReader reader(src.file->debugTypes, support::little);
+    cantFail(reader.readArray(types, reader.getLength()));
+    src.records.assign(types.begin(), types.end());
+
+    if (Optional<ArrayRef<uint8_t>> debugH = getDebugH(src.file)) {
+      src.hashes = getHashesFromDebugH(*debugH);
+    } else {
+      src.ownedHashes = GloballyHashedType::hashTypes(src.records);
+      src.hashes = src.ownedHashes;
+    }
+    ok[i] = canMergeInParallel(src);
+  });
+  if (llvm::is_contained(ok, 0))
+    return;
+
+  // Find the first occurrence of each hash.
+  size_t numRecords = 0;
+  for (GHashSource &src : srcs)
+    numRecords += src.records.size();
+  GHashTable table(numRecords);
+  parallelForEachN(0, srcs.size(), [&](size_t i) {
+    ArrayRef<GloballyHashedType> hashes = srcs[i].hashes;
+    for (uint32_t j = 0, e = hashes.size(); j != e; ++j)
+      table.insert(getHashValue(hashes[j]), (uint64_t(i) << 32) | j);
+  });
+
+  // Collect the first occurrences in each file.
+  parallelForEachN(0, srcs.size(), [&](size_t i) {
+    GHashSource &src = srcs[i];
+    src.cells.resize(src.records.size());
+    for (uint32_t j = 0, e = src.records.size(); j != e; ++j) {
+      src.cells[j] = table.find(getHashValue(src.hashes[j]));
+      if (table.getPos(src.cells[j]) == ((uint64_t(i) << 32) | j))
+        src.uniqueRecords.push_back(j);
+    }
+  });
+
+  // Assign output type indices to the first occurrences. Types and items are
+  // numbered separately because they go to different streams.
+  uint32_t numTypes = 0;
+  uint32_t numItems = 0;
+  for (GHashSource &src : srcs) {
+    src.typeBase = numTypes;
+    src.itemBase = numItems;
+    for (uint32_t j : src.uniqueRecords) {
+      if (isIdRecord(src.records[j].kind()))
+        ++numItems;
+      else
+        ++numTypes;
+    }
+  }
+
+  std::vector<TypeIndex> cellIndices(table.capacity());
+  parallelForEachN(0, srcs.size(), [&](size_t i) {
+    GHashSource &src = srcs[i];
+    uint32_t nextType = src.typeBase;
+    uint32_t nextItem = src.itemBase;
+    for (uint32_t j : src.uniqueRecords)
+      cellIndices[src.cells[j]] = TypeIndex::fromArrayIndex(
+          isIdRecord(src.records[j].kind()) ? nextItem++ : nextType++);
+  });
+
+  // Build the type index maps and remap the first occurrences.
+  for (GHashSource &src : srcs)
+    ghashIndexMaps[src.file];
+  parallelForEachN(0, srcs.size(), [&](size_t i) {
+    GHashSource &src = srcs[i];
+    SmallVectorImpl<TypeIndex> &tpiMap =
+        ghashIndexMaps.find(src.file)->second.tpiMap;
+    tpiMap.resize(src.records.size());
+    for (uint32_t j = 0, e = src.records.size(); j != e; ++j)
+      tpiMap[j] = cellIndices[src.cells[j]];
+
+    src.remappedOffsets.reserve(src.uniqueRecords.size() + 1);
+    for (uint32_t j : src.uniqueRecords) {
+      src.remappedOffsets.push_back(src.remappedData.size());
+      remapTypeRecord(src.records[j], tpiMap, src.remappedData);
+    }
+    src.remappedOffsets.push_back(src.remappedData.size());
+  });
+
+  // Copy the unique records to the type tables.
+  for (GHashSource &src : srcs) {
+    for (size_t k = 0, e = src.uniqueRecords.size(); k != e; ++k) {
+      uint32_t j = src.uniqueRecords[k];
+      ArrayRef<uint8_t> data = makeArrayRef(src.remappedData)
+                                   .slice(src.remappedOffsets[k],
+                                          src.remappedOffsets[k + 1] -
+                                              src.remappedOffsets[k]);
+      GlobalTypeTableBuilder &dest = isIdRecord(src.records[j].kind())
+                                         ? tMerger.globalIDTable
+                                         : tMerger.globalTypeTable;
+      TypeIndex ti = dest.insertRecordAs(
+          src.hashes[j], data.size(), [&](MutableArrayRef<uint8_t> storage) {
+            memcpy(storage.data(), data.data(), data.size());
+            return storage;
+          });
+      (void)ti;
+      assert(ti == cellIndices[src.cells[j]]);
+    }
+  }
+}
+
 Expected<const CVIndexMap &> PDBLinker::maybeMergeTypeServerPDB(ObjFile *file) {
   Expected<llvm::pdb::NativeSession *> pdbSession = findTypeServerSource(file);
   if (!pdbSession)
@@ -1314,6 +1606,9 @@ void PDBLinker::addObjectsToPDB() {
 
   createModuleDBI(builder);
 
+  if (config->debugGHashes)
+    mergeTypesInParallel();
+
   for (ObjFile *file : ObjFile::instances)
     addObjFile(file);
 
@@ -51,6 +51,15 @@ ErrorHandler &lld::errorHandler() {
   return handler;
 }
 
+static LLVM_THREAD_LOCAL std::vector<std::string> *collectedDiags = nullptr;
+
+DiagnosticCollector::DiagnosticCollector(std::vector<std::string> &diags)
+    : prev(collectedDiags) {
+  collectedDiags = &diags;
+}
+
+DiagnosticCollector::~DiagnosticCollector() { collectedDiags = prev; }
+
 void lld::exitLld(int val) {
   // Delete any temporary file, while keeping the memory mapping open.
   if (errorHandler().outputBuffer)
@@ -166,6 +175,11 @@ void ErrorHandler::message(const Twine &msg) {
 }
 
 void ErrorHandler::warn(const Twine &msg) {
+  if (collectedDiags) {
+    collectedDiags->push_back(("warning: " + msg).str());
+    return;
+  }
+
   if (fatalWarnings) {
     error(msg);
     return;
@@ -178,6 +192,11 @@ void ErrorHandler::warn(const Twine &msg) {
 }
 
 void ErrorHandler::error(const Twine &msg) {
+  if (collectedDiags) {
+    collectedDiags->push_back(("error: " + msg).str());
+    return;
+  }
+
   // If Visual Studio-style error message mode is enabled,
   // this particular error is printed out as two errors.
   if (vsDiagnostics) {
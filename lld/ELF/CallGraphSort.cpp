@@ -44,6 +44,8 @@
 #include "OutputSections.h"
 #include "SymbolTable.h"
 #include "Symbols.h"
+#include "lld/Common/ErrorHandler.h"
+#include "llvm/ADT/SetVector.h"
 
 #include <numeric>
 
@@ -82,6 +84,8 @@ public:
   DenseMap<const InputSectionBase *, int> run();
 
 private:
+  void reportPageEstimate(const DenseMap<const InputSectionBase *, int> &order);
+
   std::vector<Cluster> clusters;
   std::vector<const InputSectionBase *> sections;
 };
@@ -257,9 +261,65 @@ DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
       }
   }
 
+  if (errorHandler().verbose)
+    reportPageEstimate(orderMap);
   return orderMap;
 }
 
+// Estimates how many pages the sections that have weights in the call graph
+// profile span before and after reordering. Each page spanned by hot code
+// costs an iTLB entry and possibly a page fault at startup.
+void CallGraphSort::reportPageEstimate(
+    const DenseMap<const InputSectionBase *, int> &order) {
+  DenseSet<const InputSectionBase *> hot;
+  SetVector<const OutputSection *> outputSections;
+  for (size_t i = 0, e = sections.size(); i != e; ++i) {
+    if (clusters[i].initialWeight == 0)
+      continue;
+    hot.insert(sections[i]);
+    if (const OutputSection *os = sections[i]->getOutputSection())
+      outputSections.insert(os);
+  }
+
+  auto countPages = [&](ArrayRef<InputSection *> secs) {
+    uint64_t off = 0;
+    uint64_t numPages = 0;
+    uint64_t lastPage = -1;
+    for (const InputSection *sec : secs) {
+      off = alignTo(off, sec->alignment);
+      uint64_t size = sec->getSize();
+      if (size && hot.count(sec)) {
+        uint64_t first = off / config->commonPageSize;
+        uint64_t last = (off + size - 1) / config->commonPageSize;
+        numPages += last - first + (first != lastPage);
+        lastPage = last;
+      }
+      off += size;
+    }
+    return numPages;
+  };
+
+  uint64_t before = 0;
+  uint64_t after = 0;
+  for (const OutputSection *os : outputSections) {
+    std::vector<InputSection *> secs = getInputSections(os);
+    before += countPages(secs);
+
+    // Ordered sections are laid out contiguously in the order of priority.
+    llvm::erase_if(secs, [&](InputSection *sec) { return !order.count(sec); });
+    llvm::stable_sort(secs, [&](InputSection *a, InputSection *b) {
+      return order.lookup(a) < order.lookup(b);
+    });
+    after += countPages(secs);
+  }
+
+  log("call graph profile: hot sections span " + Twine(before) +
+      " pages before and " + Twine(after) +
+      " pages after reordering; estimated iTLB entries and page faults "
+      "saved: " +
+      Twine(before > after ? before - after : 0));
+}
+
 // Sort sections by the profile data provided by -callgraph-profile-file
 //
 // This first builds a call graph based on the profile data then merges sections
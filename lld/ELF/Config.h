@@ -162,8 +162,10 @@ struct Configuration {
   bool hasDynSymTab;
   bool ignoreDataAddressEquality;
   bool ignoreFunctionAddressEquality;
+  bool incremental;
   bool ltoCSProfileGenerate;
   bool ltoDebugPassManager;
+  bool ltoMergeFunctions;
   bool ltoNewPassManager;
   bool ltoWholeProgramVisibility;
   bool mergeArmExidx;
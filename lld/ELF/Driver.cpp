@@ -48,7 +48,9 @@
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSwitch.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/LTO/LTO.h"
+#include "llvm/ProfileData/SampleProfReader.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/GlobPattern.h"
@@ -56,6 +58,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TarWriter.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Telemetry.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdlib>
@@ -67,6 +70,14 @@ using namespace llvm::object;
 using namespace llvm::sys;
 using namespace llvm::support;
 
+#define DEBUG_TYPE "lld"
+
+TELEMETRY_COUNTER(linkTime, "Time spent linking (ns)");
+TELEMETRY_COUNTER(parseTime, "Time spent parsing input files (ns)");
+TELEMETRY_COUNTER(ltoTime, "Time spent compiling bitcode files (ns)");
+TELEMETRY_COUNTER(writeTime, "Time spent writing the output (ns)");
+TELEMETRY_COUNTER(numInputFiles, "Number of input files");
+
 namespace lld {
 namespace elf {
 
@@ -94,6 +105,7 @@ bool link(ArrayRef<const char *> args, bool canExitEarly, raw_ostream &stdoutOS,
   bitcodeFiles.clear();
   objectFiles.clear();
   sharedFiles.clear();
+  mappedInputBuffers.clear();
 
   config = make<Configuration>();
   driver = make<LinkerDriver>();
@@ -180,8 +192,11 @@ std::vector<std::pair<MemoryBufferRef, uint64_t>> static getArchiveMembers(
           toString(std::move(err)));
 
   // Take ownership of memory buffers created for members of thin archives.
-  for (std::unique_ptr<MemoryBuffer> &mb : file->takeThinBuffers())
+  for (std::unique_ptr<MemoryBuffer> &mb : file->takeThinBuffers()) {
+    if (mb->getBufferKind() == MemoryBuffer::MemoryBuffer_MMap)
+      mappedInputBuffers.push_back(mb.get());
     make<std::unique_ptr<MemoryBuffer>>(std::move(mb));
+  }
 
   return v;
 }
@@ -784,6 +799,96 @@ static void readCallGraph(MemoryBufferRef mb) {
   }
 }
 
+// Adds the calls recorded in a function's samples to the call graph. Calls
+// in inlined functions are calls from the section they are inlined into.
+static void
+addSampleProfileCalls(const DenseMap<StringRef, InputSectionBase *> &map,
+                      InputSectionBase *from,
+                      const sampleprof::FunctionSamples &fs,
+                      DenseMap<InputSectionBase *, uint64_t> &incoming) {
+  for (const auto &body : fs.getBodySamples()) {
+    for (const auto &target : body.second.getCallTargets()) {
+      if (InputSectionBase *to = map.lookup(target.first())) {
+        config->callGraphProfile[std::make_pair(from, to)] += target.second;
+        incoming[to] += target.second;
+      }
+    }
+  }
+
+  for (const auto &callsite : fs.getCallsiteSamples())
+    for (const auto &inlined : callsite.second)
+      addSampleProfileCalls(map, from, inlined.second, incoming);
+}
+
+// Reads a sample profile, e.g. one created from perf data by
+// create_llvm_prof or one written by llvm-profdata, and adds its call graph
+// to config->callGraphProfile.
+static void readSampleProfile(StringRef path) {
+  LLVMContext ctx;
+  ErrorOr<std::unique_ptr<sampleprof::SampleProfileReader>> readerOrErr =
+      sampleprof::SampleProfileReader::create(path.str(), ctx);
+  if (std::error_code ec = readerOrErr.getError()) {
+    error("cannot open " + path + ": " + ec.message());
+    return;
+  }
+  sampleprof::SampleProfileReader &reader = **readerOrErr;
+  if (std::error_code ec = reader.read()) {
+    error(path + ": " + ec.message());
+    return;
+  }
+  if (reader.useMD5()) {
+    error(path + ": sample profiles with MD5 function names are not supported");
+    return;
+  }
+
+  // Build a map from function name to section. Profiles usually contain
+  // names without suffixes such as ".llvm.<hash>" that compilers append to
+  // local functions, so we also add names with a suffix dropped.
+  DenseMap<StringRef, InputSectionBase *> map;
+  std::vector<std::pair<StringRef, InputSectionBase *>> suffixed;
+  for (InputFile *file : objectFiles) {
+    for (Symbol *sym : file->getSymbols()) {
+      auto *d = dyn_cast<Defined>(sym);
+      if (!d || d->isSection())
+        continue;
+      auto *sec = dyn_cast_or_null<InputSectionBase>(d->section);
+      if (!sec || !sec->isLive())
+        continue;
+      map.try_emplace(d->getName(), sec);
+      if (d->getName().contains('.'))
+        suffixed.emplace_back(d->getName().split('.').first, sec);
+    }
+  }
+  for (std::pair<StringRef, InputSectionBase *> &p : suffixed)
+    map.try_emplace(p.first, p.second);
+
+  DenseMap<InputSectionBase *, uint64_t> totals;
+  DenseMap<InputSectionBase *, uint64_t> incoming;
+  for (const auto &entry : reader.getProfiles()) {
+    const sampleprof::FunctionSamples &fs = entry.second;
+    if (InputSectionBase *sec = map.lookup(fs.getName())) {
+      totals[sec] += fs.getTotalSamples();
+      addSampleProfileCalls(map, sec, fs, incoming);
+    }
+  }
+
+  // The call graph sort uses the weights of the incoming edges of a section
+  // as its weight. Add a self edge to each section whose samples are
+  // not accounted for by its callers, e.g. because it is a hot leaf function
+  // called through a pointer, so that it is laid out as hot code.
+  for (const auto &entry : reader.getProfiles()) {
+    InputSectionBase *sec = map.lookup(entry.second.getName());
+    if (!sec)
+      continue;
+    uint64_t total = totals.lookup(sec);
+    uint64_t in = incoming.lookup(sec);
+    if (total > in) {
+      config->callGraphProfile[std::make_pair(sec, sec)] += total - in;
+      incoming[sec] = total;
+    }
+  }
+}
+
 template <class ELFT> static void readCallGraphsFromObjectFiles() {
   for (auto file : objectFiles) {
     auto *obj = cast<ObjFile<ELFT>>(file);
@@ -911,11 +1016,14 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasArg(OPT_ignore_data_address_equality);
   config->ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
+  config->incremental =
+      args.hasFlag(OPT_incremental, OPT_no_incremental, false);
   config->init = args.getLastArgValue(OPT_init, "_init");
   config->ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   config->ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
   config->ltoCSProfileFile = args.getLastArgValue(OPT_lto_cs_profile_file);
   config->ltoDebugPassManager = args.hasArg(OPT_lto_debug_pass_manager);
+  config->ltoMergeFunctions = args.hasArg(OPT_lto_merge_functions);
   config->ltoNewPassManager = args.hasArg(OPT_lto_new_pass_manager);
   config->ltoNewPmPasses = args.getLastArgValue(OPT_lto_newpm_passes);
   config->ltoWholeProgramVisibility =
@@ -1107,6 +1215,9 @@ static void readConfigs(opt::InputArgList &args) {
     if (args.hasArg(OPT_call_graph_ordering_file))
       error("--symbol-ordering-file and --call-graph-order-file "
             "may not be used together");
+    if (args.hasArg(OPT_sample_profile))
+      error("--symbol-ordering-file and --sample-profile "
+            "may not be used together");
     if (Optional<MemoryBufferRef> buffer = readFile(arg->getValue())){
       config->symbolOrderingFile = getSymbolOrderingFile(*buffer);
       // Also need to disable CallGraphProfileSort to prevent
@@ -1644,6 +1755,7 @@ static Symbol *addUndefined(StringRef name) {
 // the compiler at once, it can do a whole-program optimization.
 template <class ELFT> void LinkerDriver::compileBitcodeFiles() {
   llvm::TimeTraceScope timeScope("LTO");
+  TelemetryTimeRegion telemetryRegion(ltoTime);
   // Compile bitcode files and replace bitcode symbols.
   lto.reset(new BitcodeCompiler);
   for (BitcodeFile *file : bitcodeFiles)
@@ -1776,6 +1888,7 @@ template <class ELFT> static uint32_t getAndFeatures() {
 // all linker scripts have already been parsed.
 template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   llvm::TimeTraceScope timeScope("Link", StringRef("LinkerDriver::Link"));
+  TelemetryTimeRegion telemetryRegion(linkTime);
   // If a -hash-style option was not given, set to a default value,
   // which varies depending on the target.
   if (!args.hasArg(OPT_hash_style)) {
@@ -1817,8 +1930,20 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   // appended to the Files vector.
   {
     llvm::TimeTraceScope timeScope("Parse input files");
+    TelemetryTimeRegion telemetryRegion(parseTime);
+
+    // Symbol resolution must be done serially to be deterministic, but
+    // reading and hashing symbol names doesn't depend on other files. Do
+    // that for all object files given on the command line in parallel first.
+    parallelForEach(files, [](InputFile *file) {
+      if (file->ekind == config->ekind)
+        if (auto *f = dyn_cast<ObjFile<ELFT>>(file))
+          f->initializeSymbolKeys();
+    });
+
     for (size_t i = 0; i < files.size(); ++i)
       parseFile(files[i]);
+    numInputFiles += files.size();
   }
 
   // Now that we have every file, we can decide if we will need a
@@ -2030,23 +2155,29 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   if (!config->relocatable)
     combineEhSections();
 
-  // Create output sections described by SECTIONS commands.
-  script->processSectionCommands();
-
-  // Linker scripts control how input sections are assigned to output sections.
-  // Input sections that were not handled by scripts are called "orphans", and
-  // they are assigned to output sections by the default rule. Process that.
-  script->addOrphanSections();
-
-  // Migrate InputSectionDescription::sectionBases to sections. This includes
-  // merging MergeInputSections into a single MergeSyntheticSection. From this
-  // point onwards InputSectionDescription::sections should be used instead of
-  // sectionBases.
-  for (BaseCommand *base : script->sectionCommands)
-    if (auto *sec = dyn_cast<OutputSection>(base))
-      sec->finalizeInputSections();
-  llvm::erase_if(inputSections,
-                 [](InputSectionBase *s) { return isa<MergeInputSection>(s); });
+  {
+    llvm::TimeTraceScope timeScope("Assign sections");
+
+    // Create output sections described by SECTIONS commands.
+    script->processSectionCommands();
+
+    // Linker scripts control how input sections are assigned to output
+    // sections. Input sections that were not handled by scripts are called
+    // "orphans", and they are assigned to output sections by the default rule.
+    // Process that.
+    script->addOrphanSections();
+
+    // Migrate InputSectionDescription::sectionBases to sections. This includes
+    // merging MergeInputSections into a single MergeSyntheticSection. From
+    // this point onwards InputSectionDescription::sections should be used
+    // instead of sectionBases.
+    for (BaseCommand *base : script->sectionCommands)
+      if (auto *sec = dyn_cast<OutputSection>(base))
+        sec->finalizeInputSections();
+    llvm::erase_if(inputSections, [](InputSectionBase *s) {
+      return isa<MergeInputSection>(s);
+    });
+  }
 
   // Two input sections with different output sections should not be folded.
   // ICF runs after processSectionCommands() so that we know the output sections.
@@ -2057,14 +2188,20 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
 
   // Read the callgraph now that we know what was gced or icfed
   if (config->callGraphProfileSort) {
+    llvm::TimeTraceScope timeScope("Read call graph profile");
     if (auto *arg = args.getLastArg(OPT_call_graph_ordering_file))
       if (Optional<MemoryBufferRef> buffer = readFile(arg->getValue()))
         readCallGraph(*buffer);
+    if (auto *arg = args.getLastArg(OPT_sample_profile))
+      readSampleProfile(arg->getValue());
     readCallGraphsFromObjectFiles<ELFT>();
   }
 
   // Write the result to the file.
-  writeResult<ELFT>();
+  {
+    TelemetryTimeRegion writeRegion(writeTime);
+    writeResult<ELFT>();
+  }
 }
 
 } // namespace elf
@@ -81,6 +81,7 @@
 #include "SyntheticSections.h"
 #include "Writer.h"
 #include "lld/Common/Threads.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Object/ELF.h"
@@ -121,6 +122,8 @@ private:
 
   void forEachClass(llvm::function_ref<void(size_t, size_t)> fn);
 
+  size_t getNumClasses();
+
   std::vector<InputSection *> sections;
 
   // We repeat the main loop while `Repeat` is true.
@@ -430,20 +433,68 @@ void ICF<ELFT>::forEachClass(llvm::function_ref<void(size_t, size_t)> fn) {
   ++cnt;
 }
 
+// Returns a hash value of the parts of a relocation that constantEq()
+// compares. If two relocations are constant-equal, their hash values are
+// the same.
+template <class ELFT, class RelTy>
+static hash_code hashConstantReloc(const InputSection *isec, const RelTy &rel) {
+  uint64_t addend = getAddend<ELFT>(rel);
+  hash_code hash =
+      hash_combine(uint64_t(rel.r_offset), rel.getType(config->isMips64EL));
+
+  // Relocations referring to these symbols are constant-equal only if they
+  // refer to the same symbol.
+  Symbol &sym = isec->template getFile<ELFT>()->getRelocTargetSym(rel);
+  auto *d = dyn_cast<Defined>(&sym);
+  if (!d || d->scriptDefined || d->isPreemptible)
+    return hash_combine(hash, sym.getName(), addend);
+
+  if (!d->section || isa<InputSection>(d->section))
+    return hash_combine(hash, d->value + addend);
+  // The output section is null if the section was discarded by /DISCARD/.
+  if (auto *ms = dyn_cast<MergeInputSection>(d->section))
+    return hash_combine(hash, ms->getParent());
+  return hash_combine(hash, d->section->kind());
+}
+
+// Returns a hash value of the parts of a section that equalsConstant()
+// compares. We use it as the initial equivalence class, so sections that
+// are not constant-equal rarely end up in the same class, and the
+// relocation hashes propagated by combineRelocHashes() below start from
+// the relocations' types, offsets and addends rather than just the section
+// contents.
+template <class ELFT, class RelTy>
+static uint32_t hashConstant(const InputSection *isec, ArrayRef<RelTy> rels) {
+  hash_code hash = hash_combine(xxh3_64bits(isec->data()), isec->flags,
+                                isec->getParent()->name);
+  for (const RelTy &rel : rels)
+    hash = hash_combine(hash, hashConstantReloc<ELFT>(isec, rel));
+  return hash;
+}
+
 // Combine the hashes of the sections referenced by the given section into its
-// hash.
+// hash. The hashes are combined in the order of the relocations, so that
+// sections referring to the same set of sections in a different order get
+// different hash values.
 template <class ELFT, class RelTy>
 static void combineRelocHashes(unsigned cnt, InputSection *isec,
                                ArrayRef<RelTy> rels) {
-  uint32_t hash = isec->eqClass[cnt % 2];
+  hash_code hash = isec->eqClass[cnt % 2];
   for (RelTy rel : rels) {
     Symbol &s = isec->template getFile<ELFT>()->getRelocTargetSym(rel);
     if (auto *d = dyn_cast<Defined>(&s))
       if (auto *relSec = dyn_cast_or_null<InputSection>(d->section))
-        hash += relSec->eqClass[cnt % 2];
+        hash = hash_combine(hash, relSec->eqClass[cnt % 2]);
   }
   // Set MSB to 1 to avoid collisions with non-hash IDs.
-  isec->eqClass[(cnt + 1) % 2] = hash | (1U << 31);
+  isec->eqClass[(cnt + 1) % 2] = uint32_t(hash) | (1U << 31);
+}
+
+// Returns the number of equivalence classes.
+template <class ELFT> size_t ICF<ELFT>::getNumClasses() {
+  size_t num = 0;
+  forEachClassRange(0, sections.size(), [&](size_t, size_t) { ++num; });
+  return num;
 }
 
 static void print(const Twine &s) {
@@ -466,12 +517,20 @@ template <class ELFT> void ICF<ELFT>::run() {
       sections.push_back(s);
   }
 
-  // Initially, we use hash values to partition sections.
+  // Initially, we use hash values to partition sections. A section's hash
+  // value covers its contents and relocations, and then, after each round
+  // of combineRelocHashes(), the sections it refers to transitively up to
+  // that depth. Sections that differ within that depth are separated
+  // without running the much more expensive segregate() rounds below.
+  // Each round is a single pass over relocations, so we do a few of them.
   parallelForEach(sections, [&](InputSection *s) {
-    s->eqClass[0] = xxHash64(s->data());
+    if (s->areRelocsRela)
+      s->eqClass[0] = hashConstant<ELFT>(s, s->template relas<ELFT>());
+    else
+      s->eqClass[0] = hashConstant<ELFT>(s, s->template rels<ELFT>());
   });
 
-  for (unsigned cnt = 0; cnt != 2; ++cnt) {
+  for (unsigned cnt = 0; cnt != 4; ++cnt) {
     parallelForEach(sections, [&](InputSection *s) {
       if (s->areRelocsRela)
         combineRelocHashes<ELFT>(cnt, s, s->template relas<ELFT>());
@@ -486,14 +545,26 @@ template <class ELFT> void ICF<ELFT>::run() {
     return a->eqClass[0] < b->eqClass[0];
   });
 
+  if (errorHandler().verbose)
+    log("ICF: " + Twine(sections.size()) + " sections in " +
+        Twine(getNumClasses()) + " classes after hashing");
+
   // Compare static contents and assign unique IDs for each static content.
-  forEachClass([&](size_t begin, size_t end) { segregate(begin, end, true); });
+  {
+    llvm::TimeTraceScope timeScope("ICF round", StringRef("constant"));
+    forEachClass(
+        [&](size_t begin, size_t end) { segregate(begin, end, true); });
+  }
 
   // Split groups by comparing relocations until convergence is obtained.
   do {
+    llvm::TimeTraceScope timeScope("ICF round", StringRef("variable"));
     repeat = false;
     forEachClass(
         [&](size_t begin, size_t end) { segregate(begin, end, false); });
+    if (errorHandler().verbose)
+      log("ICF: " + Twine(getNumClasses()) + " classes after iteration " +
+          Twine(cnt));
   } while (repeat);
 
   log("ICF needed " + Twine(cnt) + " iterations");
@@ -0,0 +1,211 @@
+//===- Incremental.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the --incremental option.
+//
+// In edit-compile-link loops, most of a large output file usually stays the
+// same from one link to the next. With --incremental, we record a hash value
+// of each fixed-size block of the output file in a sidecar file named
+// <output>.incr. On the next link, if the output file is still the one we
+// wrote last time and the new output has the same size, we rewrite only the
+// blocks whose hash values have changed in place, instead of writing a whole
+// new file and renaming it over the old one.
+//
+// If anything doesn't match, e.g. the sidecar file is missing or corrupted,
+// the output file was modified by someone else, or the size of the output
+// has changed, we fall back to writing the output file from scratch.
+//
+// Note that patching a file in place is not atomic, and the change is visible
+// through all hard links to the file. If the linker is interrupted while
+// patching, the modification time of the output file no longer matches the
+// one recorded in the sidecar file, so the next link writes the whole file.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Incremental.h"
+#include "Config.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Threads.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::support::endian;
+
+namespace lld {
+namespace elf {
+
+static constexpr char magic[] = "LLDINCR1";
+static constexpr size_t magicSize = sizeof(magic) - 1;
+
+// The granularity of patching. Smaller blocks mean less data to rewrite but
+// a larger sidecar file.
+static constexpr uint64_t blockSize = 64 * 1024;
+
+namespace {
+struct IncrementalState {
+  uint64_t fileSize = 0;
+  // Modification time of the output file in nanoseconds since the epoch.
+  uint64_t mtime = 0;
+  std::vector<uint64_t> hashes;
+};
+} // namespace
+
+static std::string getStatePath() {
+  return (config->outputFile + ".incr").str();
+}
+
+static Optional<uint64_t> getModificationTime(StringRef path) {
+  sys::fs::file_status st;
+  if (sys::fs::status(path, st) ||
+      st.type() != sys::fs::file_type::regular_file)
+    return None;
+  return st.getLastModificationTime().time_since_epoch().count();
+}
+
+static std::vector<uint64_t> computeHashes(ArrayRef<uint8_t> buf) {
+  std::vector<uint64_t> hashes(divideCeil(buf.size(), blockSize));
+  parallelForEachN(0, hashes.size(), [&](size_t i) {
+    uint64_t off = i * blockSize;
+    hashes[i] = xxHash64(buf.slice(off, std::min(blockSize, buf.size() - off)));
+  });
+  return hashes;
+}
+
+// A sidecar file consists of the magic string followed by the output file
+// size, the modification time, the number of blocks and the hash value of
+// each block, all stored as 64-bit little-endian integers.
+static Optional<IncrementalState> readState() {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      MemoryBuffer::getFile(getStatePath());
+  if (!mbOrErr)
+    return None;
+
+  StringRef data = (*mbOrErr)->getBuffer();
+  if (!data.consume_front(StringRef(magic, magicSize)) || data.size() < 24)
+    return None;
+
+  IncrementalState state;
+  const uint8_t *p = data.bytes_begin();
+  state.fileSize = read64le(p);
+  state.mtime = read64le(p + 8);
+  uint64_t numHashes = read64le(p + 16);
+  data = data.drop_front(24);
+  if (numHashes != divideCeil(state.fileSize, blockSize) ||
+      data.size() != numHashes * 8)
+    return None;
+
+  state.hashes.resize(numHashes);
+  p = data.bytes_begin();
+  for (uint64_t i = 0; i != numHashes; ++i)
+    state.hashes[i] = read64le(p + i * 8);
+  return state;
+}
+
+static void writeState(uint64_t fileSize, ArrayRef<uint64_t> hashes) {
+  std::string path = getStatePath();
+
+  // The output may not be a regular file, e.g. if it is /dev/null.
+  Optional<uint64_t> mtime = getModificationTime(config->outputFile);
+  if (!mtime) {
+    sys::fs::remove(path);
+    return;
+  }
+
+  std::error_code ec;
+  raw_fd_ostream os(path, ec, sys::fs::OF_None);
+  if (ec) {
+    warn("cannot open " + path + ": " + ec.message());
+    return;
+  }
+
+  os << StringRef(magic, magicSize);
+  write<uint64_t>(os, fileSize, support::little);
+  write<uint64_t>(os, *mtime, support::little);
+  write<uint64_t>(os, hashes.size(), support::little);
+  for (uint64_t hash : hashes)
+    write<uint64_t>(os, hash, support::little);
+}
+
+bool canPatchOutputFile(uint64_t fileSize) {
+  Optional<IncrementalState> state = readState();
+  return state && state->fileSize == fileSize &&
+         state->mtime == getModificationTime(config->outputFile);
+}
+
+// Rewrites the blocks of the existing output file that differ from the new
+// output. A block whose hash value is the same as the one recorded by the
+// previous link is compared byte by byte, as equal hash values don't prove
+// that the contents are equal. Returns false if the output file couldn't be
+// patched.
+static bool patchOutputFile(ArrayRef<uint8_t> buf, ArrayRef<uint64_t> hashes) {
+  Optional<IncrementalState> state = readState();
+  if (!state || state->hashes.size() != hashes.size())
+    return false;
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> oldOrErr =
+      MemoryBuffer::getFile(config->outputFile, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!oldOrErr || (*oldOrErr)->getBufferSize() != buf.size())
+    return false;
+  ArrayRef<uint8_t> old(
+      reinterpret_cast<const uint8_t *>((*oldOrErr)->getBufferStart()),
+      (*oldOrErr)->getBufferSize());
+
+  int fd;
+  if (sys::fs::openFileForReadWrite(config->outputFile, fd,
+                                    sys::fs::CD_OpenExisting, sys::fs::OF_None))
+    return false;
+
+  raw_fd_ostream os(fd, /*shouldClose=*/true);
+  for (size_t i = 0, e = hashes.size(); i != e; ++i) {
+    uint64_t off = i * blockSize;
+    uint64_t size = std::min(blockSize, buf.size() - off);
+    if (hashes[i] == state->hashes[i] &&
+        buf.slice(off, size) == old.slice(off, size))
+      continue;
+    os.pwrite(reinterpret_cast<const char *>(buf.data() + off), size, off);
+  }
+  os.flush();
+
+  // Bump the modification time even if nothing has changed so that build
+  // systems see the output as up to date.
+  sys::fs::setLastAccessAndModificationTime(fd,
+                                            std::chrono::system_clock::now());
+  os.close();
+
+  if (os.has_error()) {
+    os.clear_error();
+    return false;
+  }
+  return true;
+}
+
+void commitIncrementalOutput(FileOutputBuffer &buffer, bool patch) {
+  ArrayRef<uint8_t> buf(buffer.getBufferStart(), buffer.getBufferSize());
+  std::vector<uint64_t> hashes = computeHashes(buf);
+
+  if (!patch || !patchOutputFile(buf, hashes)) {
+    // The existing file may be in use, e.g. by a running process. Unlink it
+    // before writing a new one, as openFile() would have done.
+    if (patch)
+      sys::fs::remove(config->outputFile);
+    if (auto e = buffer.commit()) {
+      error("failed to write to the output file: " + toString(std::move(e)));
+      return;
+    }
+  }
+  writeState(buf.size(), hashes);
+}
+
+} // namespace elf
+} // namespace lld
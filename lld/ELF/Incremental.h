@@ -0,0 +1,35 @@
+//===- Incremental.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_INCREMENTAL_H
+#define LLD_ELF_INCREMENTAL_H
+
+#include "lld/Common/LLVM.h"
+
+namespace llvm {
+class FileOutputBuffer;
+}
+
+namespace lld {
+namespace elf {
+
+// Returns true if the output file of the previous --incremental link can be
+// patched in place to become the new output file of the given size. If this
+// returns true, the existing output file must be left as is until
+// commitIncrementalOutput() is called.
+bool canPatchOutputFile(uint64_t fileSize);
+
+// Writes the contents of Buffer to the output file and records the state of
+// the output file for the next --incremental link. If Patch is true, only the
+// parts of the existing output file that have changed are rewritten.
+void commitIncrementalOutput(llvm::FileOutputBuffer &buffer, bool patch);
+
+} // namespace elf
+} // namespace lld
+
+#endif
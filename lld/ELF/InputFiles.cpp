@@ -62,6 +62,7 @@ std::vector<InputFile *> objectFiles;
 std::vector<SharedFile *> sharedFiles;
 
 std::unique_ptr<TarWriter> tar;
+std::vector<MemoryBuffer *> mappedInputBuffers;
 
 static ELFKind getELFKind(MemoryBufferRef mb, StringRef archiveName) {
   unsigned char size;
@@ -117,6 +118,8 @@ Optional<MemoryBufferRef> readFile(StringRef path) {
 
   std::unique_ptr<MemoryBuffer> &mb = *mbOrErr;
   MemoryBufferRef mbref = mb->getMemBufferRef();
+  if (mb->getBufferKind() == MemoryBuffer::MemoryBuffer_MMap)
+    mappedInputBuffers.push_back(mb.get());
   make<std::unique_ptr<MemoryBuffer>>(std::move(mb)); // take MB ownership
 
   if (tar)
@@ -1040,18 +1043,34 @@ StringRef ObjFile<ELFT>::getSectionName(const Elf_Shdr &sec) {
   return CHECK(getObj().getSectionName(&sec, sectionStringTable), this);
 }
 
+template <class ELFT> void ObjFile<ELFT>::initializeSymbolKeys() {
+  ArrayRef<Elf_Sym> eSyms = this->getGlobalELFSyms<ELFT>();
+  symbolKeys.reserve(eSyms.size());
+  for (const Elf_Sym &eSym : eSyms)
+    symbolKeys.push_back(
+        SymbolTable::getKey(CHECK(eSym.getName(this->stringTable), this)));
+}
+
 // Initialize this->Symbols. this->Symbols is a parallel array as
 // its corresponding ELF symbol table.
 template <class ELFT> void ObjFile<ELFT>::initializeSymbols() {
   ArrayRef<Elf_Sym> eSyms = this->getELFSyms<ELFT>();
   this->symbols.resize(eSyms.size());
 
+  // Use the keys computed by initializeSymbolKeys() if available.
+  std::vector<CachedHashStringRef> keys = std::move(symbolKeys);
+  auto getKey = [&](size_t i) {
+    if (i >= this->firstGlobal && !keys.empty())
+      return keys[i - this->firstGlobal];
+    return SymbolTable::getKey(
+        CHECK(eSyms[i].getName(this->stringTable), this));
+  };
+
   // Our symbol table may have already been partially initialized
   // because of LazyObjFile.
   for (size_t i = 0, end = eSyms.size(); i != end; ++i)
     if (!this->symbols[i] && eSyms[i].getBinding() != STB_LOCAL)
-      this->symbols[i] =
-          symtab->insert(CHECK(eSyms[i].getName(this->stringTable), this));
+      this->symbols[i] = symtab->insert(getKey(i));
 
   // Fill this->Symbols. A symbol is either local or global.
   for (size_t i = 0, end = eSyms.size(); i != end; ++i) {
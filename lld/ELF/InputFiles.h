@@ -49,6 +49,10 @@ class Symbol;
 // to this tar archive.
 extern std::unique_ptr<llvm::TarWriter> tar;
 
+// Memory-mapped buffers of the input files. The writer uses this to release
+// the memory of input sections once they have been copied to the output.
+extern std::vector<llvm::MemoryBuffer *> mappedInputBuffers;
+
 // Opens a given file.
 llvm::Optional<MemoryBufferRef> readFile(StringRef path);
 
@@ -205,6 +209,12 @@ public:
 
   void parse(bool ignoreComdats = false);
 
+  // Computes the symbol table keys of the global symbols, which is the most
+  // expensive part of adding them to the symbol table other than the
+  // resolution itself. This doesn't touch any global state, so it can be
+  // called for different files in parallel before calling parse().
+  void initializeSymbolKeys();
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> sections,
                                  const Elf_Shdr &sec);
 
@@ -281,6 +291,11 @@ private:
   // .shstrtab contents.
   StringRef sectionStringTable;
 
+  // Symbol table keys of the global symbols computed by
+  // initializeSymbolKeys(), indexed by symbol index minus firstGlobal.
+  // Released by initializeSymbols().
+  std::vector<llvm::CachedHashStringRef> symbolKeys;
+
   // Debugging information to retrieve source file and line for error
   // reporting. Linker may find reasonable number of errors in a
   // single object file, so we cache debugging information in order to
@@ -1262,7 +1262,7 @@ void MergeInputSection::splitStrings(ArrayRef<uint8_t> data, size_t entSize) {
       fatal(toString(this) + ": string is not null terminated");
     size_t size = end + entSize;
 
-    pieces.emplace_back(off, xxHash64(s.substr(0, size)), !isAlloc);
+    pieces.emplace_back(off, xxh3_64bits(s.substr(0, size)), !isAlloc);
     s = s.substr(size);
     off += size;
   }
@@ -1277,7 +1277,7 @@ void MergeInputSection::splitNonStrings(ArrayRef<uint8_t> data,
   bool isAlloc = flags & SHF_ALLOC;
 
   for (size_t i = 0; i != size; i += entSize)
-    pieces.emplace_back(i, xxHash64(data.slice(i, entSize)), !isAlloc);
+    pieces.emplace_back(i, xxh3_64bits(data.slice(i, entSize)), !isAlloc);
 }
 
 template <class ELFT>
@@ -95,6 +95,7 @@ static lto::Config createConfig() {
 
   c.PTO.LoopVectorization = c.OptLevel > 1;
   c.PTO.SLPVectorization = c.OptLevel > 1;
+  c.PTO.MergeFunctions = config->ltoMergeFunctions;
 
   // Set up a custom pipeline if we've been asked to.
   c.OptPipeline = std::string(config->ltoNewPmPasses);
@@ -110,6 +111,7 @@ static lto::Config createConfig() {
   c.UseNewPM = config->ltoNewPassManager;
   c.DebugPassManager = config->ltoDebugPassManager;
   c.DwoDir = std::string(config->dwoDir);
+  c.ThinLinkCacheDir = std::string(config->thinLTOCacheDir);
 
   c.HasWholeProgramVisibility = config->ltoWholeProgramVisibility;
 
@@ -29,6 +29,7 @@
 #include "Target.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
+#include "lld/Common/Threads.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Object/ELF.h"
 #include "llvm/Support/TimeProfiler.h"
@@ -52,12 +53,25 @@ public:
   void moveToMain();
 
 private:
-  void enqueue(InputSectionBase *sec, uint64_t offset);
+  // What visiting sections found: the sections whose partitions may need to
+  // be updated, and the bits to set. Sections are visited in parallel, so
+  // nothing is updated until commit() runs on a single thread.
+  struct Queue {
+    SmallVector<InputSectionBase *, 0> sections;
+    SmallVector<Symbol *, 0> usedSymbols;
+    SmallVector<SectionPiece *, 0> livePieces;
+    SmallVector<SharedFile *, 0> neededFiles;
+  };
+
+  void enqueue(InputSectionBase *sec, uint64_t offset, Queue &q);
+  bool updatePartition(InputSectionBase *sec);
   void markSymbol(Symbol *sym);
+  void visit(InputSection &sec, Queue &q);
+  void commit(Queue &q, std::vector<InputSection *> &sections);
   void mark();
 
   template <class RelTy>
-  void resolveReloc(InputSectionBase &sec, RelTy &rel, bool isLSDA);
+  void resolveReloc(InputSectionBase &sec, RelTy &rel, bool isLSDA, Queue &q);
 
   template <class RelTy>
   void scanEhFrameSection(EhInputSection &eh, ArrayRef<RelTy> rels);
@@ -65,8 +79,9 @@ private:
   // The index of the partition that we are currently processing.
   unsigned partition;
 
-  // A list of sections to visit.
-  SmallVector<InputSection *, 256> queue;
+  // The sections whose partitions may need to be updated, and the bits to
+  // set, found outside of mark().
+  Queue queue;
 
   // There are normally few input sections whose names are valid C
   // identifiers, so we just store a std::vector instead of a multimap.
@@ -90,11 +105,12 @@ static uint64_t getAddend(InputSectionBase &sec,
 template <class ELFT>
 template <class RelTy>
 void MarkLive<ELFT>::resolveReloc(InputSectionBase &sec, RelTy &rel,
-                                  bool isLSDA) {
+                                  bool isLSDA, Queue &q) {
   Symbol &sym = sec.getFile<ELFT>()->getRelocTargetSym(rel);
 
   // If a symbol is referenced in a live section, it is used.
-  sym.used = true;
+  if (!sym.used)
+    q.usedSymbols.push_back(&sym);
 
   if (auto *d = dyn_cast<Defined>(&sym)) {
     auto *relSec = dyn_cast_or_null<InputSectionBase>(d->section);
@@ -106,16 +122,16 @@ void MarkLive<ELFT>::resolveReloc(InputSectionBase &sec, RelTy &rel,
       offset += getAddend<ELFT>(sec, rel);
 
     if (!isLSDA || !(relSec->flags & SHF_EXECINSTR))
-      enqueue(relSec, offset);
+      enqueue(relSec, offset, q);
     return;
   }
 
   if (auto *ss = dyn_cast<SharedSymbol>(&sym))
-    if (!ss->isWeak())
-      ss->getFile().isNeeded = true;
+    if (!ss->isWeak() && !ss->getFile().isNeeded)
+      q.neededFiles.push_back(&ss->getFile());
 
   for (InputSectionBase *sec : cNamedSections.lookup(sym.getName()))
-    enqueue(sec, 0);
+    enqueue(sec, 0, q);
 }
 
 // The .eh_frame section is an unfortunate special case.
@@ -145,7 +161,7 @@ void MarkLive<ELFT>::scanEhFrameSection(EhInputSection &eh,
     if (endian::read32<ELFT::TargetEndianness>(piece.data().data() + 4) == 0) {
       // This is a CIE, we only need to worry about the first relocation. It is
       // known to point to the personality function.
-      resolveReloc(eh, rels[firstRelI], false);
+      resolveReloc(eh, rels[firstRelI], false, queue);
       continue;
     }
 
@@ -155,7 +171,7 @@ void MarkLive<ELFT>::scanEhFrameSection(EhInputSection &eh,
     uint64_t pieceEnd = piece.inputOff + piece.size;
     for (size_t j = firstRelI, end2 = rels.size(); j < end2; ++j)
       if (rels[j].r_offset < pieceEnd)
-        resolveReloc(eh, rels[j], true);
+        resolveReloc(eh, rels[j], true, queue);
   }
 }
 
@@ -180,7 +196,8 @@ static bool isReserved(InputSectionBase *sec) {
 }
 
 template <class ELFT>
-void MarkLive<ELFT>::enqueue(InputSectionBase *sec, uint64_t offset) {
+void MarkLive<ELFT>::enqueue(InputSectionBase *sec, uint64_t offset,
+                             Queue &q) {
   // Skip over discarded sections. This in theory shouldn't happen, because
   // the ELF spec doesn't allow a relocation to point to a deduplicated
   // COMDAT section directly. Unfortunately this happens in practice (e.g.
@@ -191,25 +208,35 @@ void MarkLive<ELFT>::enqueue(InputSectionBase *sec, uint64_t offset) {
   // Usually, a whole section is marked as live or dead, but in mergeable
   // (splittable) sections, each piece of data has independent liveness bit.
   // So we explicitly tell it which offset is in use.
-  if (auto *ms = dyn_cast<MergeInputSection>(sec))
-    ms->getSectionPiece(offset)->live = true;
+  if (auto *ms = dyn_cast<MergeInputSection>(sec)) {
+    SectionPiece *piece = ms->getSectionPiece(offset);
+    if (!piece->live)
+      q.livePieces.push_back(piece);
+  }
 
-  // Set Sec->Partition to the meet (i.e. the "minimum") of Partition and
-  // Sec->Partition in the following lattice: 1 < other < 0. If Sec->Partition
-  // doesn't change, we don't need to do anything.
+  // If Sec->Partition doesn't change, we don't need to do anything.
+  // Otherwise, add the section to the queue. Sec->Partition is updated
+  // later by updatePartition().
   if (sec->partition == 1 || sec->partition == partition)
     return;
-  sec->partition = sec->partition ? 1 : partition;
+  q.sections.push_back(sec);
+}
 
-  // Add input section to the queue.
-  if (InputSection *s = dyn_cast<InputSection>(sec))
-    queue.push_back(s);
+// Set Sec->Partition to the meet (i.e. the "minimum") of Partition and
+// Sec->Partition in the following lattice: 1 < other < 0. Returns true if
+// Sec->Partition has changed.
+template <class ELFT>
+bool MarkLive<ELFT>::updatePartition(InputSectionBase *sec) {
+  if (sec->partition == 1 || sec->partition == partition)
+    return false;
+  sec->partition = sec->partition ? 1 : partition;
+  return true;
 }
 
 template <class ELFT> void MarkLive<ELFT>::markSymbol(Symbol *sym) {
   if (auto *d = dyn_cast_or_null<Defined>(sym))
     if (auto *isec = dyn_cast_or_null<InputSectionBase>(d->section))
-      enqueue(isec, d->value);
+      enqueue(isec, d->value, queue);
 }
 
 // This is the main function of the garbage collector.
@@ -260,7 +287,7 @@ template <class ELFT> void MarkLive<ELFT>::run() {
       continue;
 
     if (isReserved(sec) || script->shouldKeep(sec)) {
-      enqueue(sec, 0);
+      enqueue(sec, 0, queue);
     } else if (isValidCIdentifier(sec->name)) {
       cNamedSections[saver.save("__start_" + sec->name)].push_back(sec);
       cNamedSections[saver.save("__stop_" + sec->name)].push_back(sec);
@@ -270,25 +297,75 @@ template <class ELFT> void MarkLive<ELFT>::run() {
   mark();
 }
 
-template <class ELFT> void MarkLive<ELFT>::mark() {
-  // Mark all reachable sections.
-  while (!queue.empty()) {
-    InputSectionBase &sec = *queue.pop_back_val();
+// Adds sections referenced by a given live section to the queue.
+template <class ELFT>
+void MarkLive<ELFT>::visit(InputSection &sec, Queue &q) {
+  if (sec.areRelocsRela) {
+    for (const typename ELFT::Rela &rel : sec.template relas<ELFT>())
+      resolveReloc(sec, rel, false, q);
+  } else {
+    for (const typename ELFT::Rel &rel : sec.template rels<ELFT>())
+      resolveReloc(sec, rel, false, q);
+  }
 
-    if (sec.areRelocsRela) {
-      for (const typename ELFT::Rela &rel : sec.template relas<ELFT>())
-        resolveReloc(sec, rel, false);
-    } else {
-      for (const typename ELFT::Rel &rel : sec.template rels<ELFT>())
-        resolveReloc(sec, rel, false);
-    }
+  for (InputSectionBase *isec : sec.dependentSections)
+    enqueue(isec, 0, q);
+
+  // Mark the next group member.
+  if (sec.nextInSectionGroup)
+    enqueue(sec.nextInSectionGroup, 0, q);
+}
 
-    for (InputSectionBase *isec : sec.dependentSections)
-      enqueue(isec, 0);
+// Sets the bits that \p q collected, updates the partitions of its sections,
+// and appends the sections that have to be visited to \p sections.
+template <class ELFT>
+void MarkLive<ELFT>::commit(Queue &q, std::vector<InputSection *> &sections) {
+  for (Symbol *sym : q.usedSymbols)
+    sym->used = true;
+  for (SectionPiece *piece : q.livePieces)
+    piece->live = true;
+  for (SharedFile *file : q.neededFiles)
+    file->isNeeded = true;
+  for (InputSectionBase *sec : q.sections)
+    if (updatePartition(sec))
+      if (auto *s = dyn_cast<InputSection>(sec))
+        sections.push_back(s);
+  q = Queue();
+}
 
-    // Mark the next group member.
-    if (sec.nextInSectionGroup)
-      enqueue(sec.nextInSectionGroup, 0);
+// Mark all reachable sections.
+//
+// Programs compiled with -ffunction-sections may have millions of sections,
+// so we visit sections in parallel. We do that level by level: all sections
+// whose partitions were updated in the previous round are visited in
+// parallel, and what they refer to is collected to per-task queues. The
+// queues are committed between rounds on a single thread, in order, so the
+// result does not depend on the number of threads, and the bits that tasks
+// read are never written during a round.
+template <class ELFT> void MarkLive<ELFT>::mark() {
+  constexpr size_t chunkSize = 256;
+  std::vector<InputSection *> sections, next;
+  commit(queue, sections);
+
+  while (!sections.empty()) {
+    size_t numChunks = divideCeil(sections.size(), chunkSize);
+    if (numChunks <= 1) {
+      for (InputSection *sec : sections)
+        visit(*sec, queue);
+      commit(queue, next);
+    } else {
+      std::vector<Queue> queues(numChunks);
+      parallelForEachN(0, numChunks, [&](size_t i) {
+        size_t begin = i * chunkSize;
+        size_t end = std::min(begin + chunkSize, sections.size());
+        for (size_t j = begin; j != end; ++j)
+          visit(*sections[j], queues[i]);
+      });
+      for (Queue &q : queues)
+        commit(q, next);
+    }
+    sections.swap(next);
+    next.clear();
   }
 }
 
@@ -314,7 +391,7 @@ template <class ELFT> void MarkLive<ELFT>::moveToMain() {
       continue;
     if (symtab->find(("__start_" + sec->name).str()) ||
         symtab->find(("__stop_" + sec->name).str()))
-      enqueue(sec, 0);
+      enqueue(sec, 0, queue);
   }
 
   mark();
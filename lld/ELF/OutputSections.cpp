@@ -261,26 +261,56 @@ template <class ELFT> void OutputSection::maybeCompress() {
       !name.startswith(".debug_"))
     return;
 
-  // Create a section header.
-  zDebugHeader.resize(sizeof(Elf_Chdr));
+  // Create a section header followed by a zlib header. The zlib header
+  // specifies deflate with a 32 KiB window, and its level bits are only
+  // informational.
+  int level = config->optimize >= 2 ? 6 : 1;
+  zDebugHeader.resize(sizeof(Elf_Chdr) + 2);
   auto *hdr = reinterpret_cast<Elf_Chdr *>(zDebugHeader.data());
   hdr->ch_type = ELFCOMPRESS_ZLIB;
   hdr->ch_size = size;
   hdr->ch_addralign = alignment;
+  zDebugHeader[sizeof(Elf_Chdr)] = 0x78;
+  zDebugHeader[sizeof(Elf_Chdr) + 1] = level == 1 ? 0x01 : 0x9c;
 
   // Write section contents to a temporary buffer and compress it.
   std::vector<uint8_t> buf(size);
   writeTo<ELFT>(buf.data());
+
+  // Split the contents into shards and compress them in parallel as raw
+  // deflate data. Each non-last shard ends with a sync flush, so the shards
+  // can simply be concatenated. Restarting the compressor every 1 MiB costs
+  // very little since deflate's window is only 32 KiB.
+  //
   // We chose 1 as the default compression level because it is the fastest. If
   // -O2 is given, we use level 6 to compress debug info more by ~15%. We found
   // that level 7 to 9 doesn't make much difference (~1% more compression) while
   // they take significant amount of time (~2x), so level 6 seems enough.
-  if (Error e = zlib::compress(toStringRef(buf), compressedData,
-                               config->optimize >= 2 ? 6 : 1))
-    fatal("compress failed: " + llvm::toString(std::move(e)));
+  constexpr size_t shardSize = 1 << 20;
+  ArrayRef<uint8_t> contents(buf);
+  size_t numShards = std::max<size_t>(1, divideCeil(buf.size(), shardSize));
+  compressedShards.resize(numShards);
+  std::vector<uint32_t> checksums(numShards);
+  parallelForEachN(0, numShards, [&](size_t i) {
+    StringRef shard = toStringRef(contents.slice(
+        i * shardSize, std::min(shardSize, buf.size() - i * shardSize)));
+    if (Error e = zlib::compressRaw(shard, compressedShards[i], level,
+                                    /*Finish=*/i + 1 == numShards))
+      fatal("compress failed: " + llvm::toString(std::move(e)));
+    checksums[i] = zlib::adler32(shard);
+  });
+
+  // The zlib trailer is the Adler-32 checksum of the whole contents.
+  zDebugChecksum = checksums[0];
+  for (size_t i = 1; i < numShards; ++i)
+    zDebugChecksum = zlib::adler32Combine(
+        zDebugChecksum, checksums[i],
+        std::min(shardSize, buf.size() - i * shardSize));
 
   // Update section headers.
-  size = sizeof(Elf_Chdr) + compressedData.size();
+  size = zDebugHeader.size() + 4;
+  for (const SmallVector<char, 0> &shard : compressedShards)
+    size += shard.size();
   flags |= SHF_COMPRESSED;
 }
 
@@ -304,10 +334,19 @@ template <class ELFT> void OutputSection::writeTo(uint8_t *buf) {
   // If -compress-debug-section is specified and if this is a debug section,
   // we've already compressed section contents. If that's the case,
   // just write it down.
-  if (!compressedData.empty()) {
+  if (!compressedShards.empty()) {
     memcpy(buf, zDebugHeader.data(), zDebugHeader.size());
-    memcpy(buf + zDebugHeader.size(), compressedData.data(),
-           compressedData.size());
+    std::vector<size_t> offsets(compressedShards.size());
+    size_t off = zDebugHeader.size();
+    for (size_t i = 0, e = compressedShards.size(); i != e; ++i) {
+      offsets[i] = off;
+      off += compressedShards[i].size();
+    }
+    parallelForEachN(0, compressedShards.size(), [&](size_t i) {
+      memcpy(buf + offsets[i], compressedShards[i].data(),
+             compressedShards[i].size());
+    });
+    write32be(buf + off, zDebugChecksum);
     return;
   }
 
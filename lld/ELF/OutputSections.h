@@ -109,9 +109,12 @@ public:
   void sortCtorsDtors();
 
 private:
-  // Used for implementation of --compress-debug-sections option.
+  // Used for implementation of --compress-debug-sections option. The section
+  // contents are split into shards that are compressed in parallel. The
+  // header, the shards and the checksum form a single zlib stream.
   std::vector<uint8_t> zDebugHeader;
-  llvm::SmallVector<char, 1> compressedData;
+  std::vector<llvm::SmallVector<char, 0>> compressedShards;
+  uint32_t zDebugChecksum = 0;
 
   std::array<uint8_t, 4> getFiller();
 };
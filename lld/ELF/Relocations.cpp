@@ -52,6 +52,7 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
+#include "lld/Common/Threads.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Support/Endian.h"
@@ -1483,18 +1484,58 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
   processRelocAux<ELFT>(sec, expr, type, offset, sym, rel, addend);
 }
 
+// Handles a relocation without reading or writing any state other than the
+// relocation, its symbol and Sec itself, so that it is safe to call this
+// function for different sections concurrently.
+//
+// Only the most common case is handled here: a reference to a defined,
+// non-preemptible, non-TLS, non-ifunc symbol which is resolved at link-time.
+// Such relocations don't create GOT, PLT, copy or dynamic relocations and
+// don't depend on the relocations processed before them. Returns false if
+// the relocation needs the full treatment of scanReloc().
 template <class ELFT, class RelTy>
-static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
-  OffsetGetter getOffset(sec);
+static bool scanSimpleReloc(InputSectionBase &sec, const RelTy &rel,
+                            Relocation &out) {
+  uint32_t symIndex = rel.getSymbol(config->isMips64EL);
+  if (symIndex == 0)
+    return false;
+  Symbol &sym = sec.getFile<ELFT>()->getSymbol(symIndex);
+  if (!sym.isDefined() || sym.isPreemptible || sym.isGnuIFunc() || sym.isTls())
+    return false;
 
-  // Not all relocations end up in Sec.Relocations, but a lot do.
-  sec.relocations.reserve(rels.size());
+  // isStaticLinkTimeConstant() may report an error for a reference to an
+  // absolute symbol. Leave it to the serial pass so that diagnostics are
+  // emitted in a deterministic order.
+  if (config->isPic && isAbsoluteValue(sym))
+    return false;
 
-  for (auto i = rels.begin(), end = rels.end(); i != end;)
-    scanReloc<ELFT>(sec, getOffset, i, end);
+  RelType type = rel.getType(config->isMips64EL);
+  const uint8_t *relocatedAddr = sec.data().begin() + rel.r_offset;
+  RelExpr expr = target->getRelExpr(type, sym, relocatedAddr);
+
+  // The symbol is not preemptible, so relax the relocation in the same way
+  // as scanReloc() does.
+  if (expr == R_GOT_PC && !isAbsoluteValue(sym))
+    expr = target->adjustRelaxExpr(type, relocatedAddr, expr);
+  else if (expr != R_PPC32_PLTREL)
+    expr = fromPlt(expr);
 
-  // Sort relocations by offset for more efficient searching for
-  // R_RISCV_PCREL_HI20 and R_PPC64_ADDR64.
+  if (expr == R_NONE || needsPlt(expr) || needsGot(expr) ||
+      oneof<R_GOTPLTONLY_PC, R_GOTPLTREL, R_GOTPLT, R_TLSGD_GOTPLT,
+            R_GOTONLY_PC, R_GOTREL, R_PPC64_TOCBASE, R_PPC64_RELAX_TOC>(expr))
+    return false;
+
+  if (!isStaticLinkTimeConstant(expr, type, sym, sec, rel.r_offset))
+    return false;
+
+  int64_t addend = computeAddend<ELFT>(rel, &rel + 1, sec, expr, sym.isLocal());
+  out = {expr, type, rel.r_offset, addend, &sym};
+  return true;
+}
+
+// Sort relocations by offset for more efficient searching for
+// R_RISCV_PCREL_HI20 and R_PPC64_ADDR64.
+static void sortRelocations(InputSectionBase &sec) {
   if (config->emachine == EM_RISCV ||
       (config->emachine == EM_PPC64 && sec.name == ".toc"))
     llvm::stable_sort(sec.relocations,
@@ -1503,13 +1544,133 @@ static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
                       });
 }
 
-template <class ELFT> void scanRelocations(InputSectionBase &s) {
+template <class ELFT, class RelTy>
+static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
+  OffsetGetter getOffset(sec);
+
+  // Not all relocations end up in Sec.Relocations, but a lot do.
+  sec.relocations.reserve(rels.size());
+
+  for (auto i = rels.begin(), end = rels.end(); i != end;)
+    scanReloc<ELFT>(sec, getOffset, i, end);
+
+  sortRelocations(sec);
+}
+
+// The first, parallel half of a concurrent scan. Adds the relocations that
+// scanSimpleReloc() can handle to Sec.Relocations and records the indices of
+// the other ones in Deferred.
+//
+// Diagnostics, such as those for unknown relocation types, would come out in
+// an order that depends on scheduling. They are held back, and a relocation
+// that caused one is deferred so that the serial pass reports it again in
+// input order.
+template <class ELFT, class RelTy>
+static void prescanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels,
+                          std::vector<uint32_t> &deferred) {
+  std::vector<std::string> diags;
+  DiagnosticCollector collector(diags);
+  sec.relocations.reserve(rels.size());
+  for (size_t i = 0, e = rels.size(); i != e; ++i) {
+    Relocation r;
+    if (scanSimpleReloc<ELFT>(sec, rels[i], r) && diags.empty())
+      sec.relocations.push_back(r);
+    else
+      deferred.push_back(i);
+    diags.clear();
+  }
+}
+
+// The second, serial half of a concurrent scan. Processes the deferred
+// relocations with scanReloc() and interleaves the results with the ones
+// added by prescanRelocs(), so that Sec.Relocations ends up exactly as if
+// all relocations had been processed by scanRelocs().
+template <class ELFT, class RelTy>
+static void scanDeferredRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels,
+                               ArrayRef<uint32_t> deferred) {
+  if (!deferred.empty()) {
+    std::vector<Relocation> simple = std::move(sec.relocations);
+    sec.relocations.clear();
+    sec.relocations.reserve(rels.size());
+
+    // Returns true and pops the front of Deferred if Rel is deferred.
+    auto popDeferred = [&](const RelTy *rel) {
+      if (deferred.empty() || deferred.front() != size_t(rel - rels.begin()))
+        return false;
+      deferred = deferred.drop_front();
+      return true;
+    };
+
+    OffsetGetter getOffset(sec);
+    size_t nextSimple = 0;
+    for (auto i = rels.begin(), end = rels.end(); i != end;) {
+      auto cur = i;
+      if (popDeferred(cur)) {
+        scanReloc<ELFT>(sec, getOffset, i, end);
+      } else {
+        sec.relocations.push_back(simple[nextSimple++]);
+        ++i;
+      }
+
+      // scanReloc() may consume more than one relocation, e.g. when relaxing
+      // a TLS sequence. Drop whatever was computed for the skipped ones.
+      for (++cur; cur < i; ++cur)
+        if (!popDeferred(cur))
+          ++nextSimple;
+    }
+  }
+
+  sortRelocations(sec);
+}
+
+template <class ELFT> static void scanRelocations(InputSectionBase &s) {
   if (s.areRelocsRela)
     scanRelocs<ELFT>(s, s.relas<ELFT>());
   else
     scanRelocs<ELFT>(s, s.rels<ELFT>());
 }
 
+template <class ELFT>
+void scanRelocations(ArrayRef<InputSectionBase *> sections) {
+  // MIPS and PPC64 keep state across relocations (e.g. paired relocations or
+  // per-file TOC flags), so scan them serially.
+  if (parallel::strategy.ThreadsRequested == 1 ||
+      config->emachine == EM_MIPS || config->emachine == EM_PPC64) {
+    for (InputSectionBase *sec : sections)
+      scanRelocations<ELFT>(*sec);
+    return;
+  }
+
+  // Scan in two passes. The first pass runs in parallel and handles the
+  // relocations that don't affect anything outside of their own section,
+  // which are the vast majority. The second pass visits sections in the
+  // original order and processes the remaining relocations, which may create
+  // GOT, PLT, copy and dynamic relocations, serially. This way the output
+  // doesn't depend on the number of threads. .eh_frame sections need an
+  // OffsetGetter and are few, so they are handled entirely in the second
+  // pass.
+  std::vector<std::vector<uint32_t>> deferred(sections.size());
+  parallelForEachN(0, sections.size(), [&](size_t i) {
+    InputSectionBase &sec = *sections[i];
+    if (isa<EhInputSection>(sec))
+      return;
+    if (sec.areRelocsRela)
+      prescanRelocs<ELFT>(sec, sec.relas<ELFT>(), deferred[i]);
+    else
+      prescanRelocs<ELFT>(sec, sec.rels<ELFT>(), deferred[i]);
+  });
+
+  for (size_t i = 0, e = sections.size(); i != e; ++i) {
+    InputSectionBase &sec = *sections[i];
+    if (isa<EhInputSection>(sec))
+      scanRelocations<ELFT>(sec);
+    else if (sec.areRelocsRela)
+      scanDeferredRelocs<ELFT>(sec, sec.relas<ELFT>(), deferred[i]);
+    else
+      scanDeferredRelocs<ELFT>(sec, sec.rels<ELFT>(), deferred[i]);
+  }
+}
+
 static bool mergeCmp(const InputSection *a, const InputSection *b) {
   // std::merge requires a strict weak ordering.
   if (a->outSecOff < b->outSecOff)
@@ -2022,10 +2183,10 @@ void hexagonTLSSymbolUpdate(ArrayRef<OutputSection *> outputSections) {
       });
 }
 
-template void scanRelocations<ELF32LE>(InputSectionBase &);
-template void scanRelocations<ELF32BE>(InputSectionBase &);
-template void scanRelocations<ELF64LE>(InputSectionBase &);
-template void scanRelocations<ELF64BE>(InputSectionBase &);
+template void scanRelocations<ELF32LE>(ArrayRef<InputSectionBase *>);
+template void scanRelocations<ELF32BE>(ArrayRef<InputSectionBase *>);
+template void scanRelocations<ELF64LE>(ArrayRef<InputSectionBase *>);
+template void scanRelocations<ELF64BE>(ArrayRef<InputSectionBase *>);
 template void reportUndefinedSymbols<ELF32LE>();
 template void reportUndefinedSymbols<ELF32BE>();
 template void reportUndefinedSymbols<ELF64LE>();
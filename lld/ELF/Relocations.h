@@ -108,10 +108,15 @@ struct Relocation {
   Symbol *sym;
 };
 
+// Scans the relocations of the given sections to create GOT, PLT, copy and
+// dynamic relocations. Relocations of different sections may be scanned in
+// parallel, but the result is independent of the number of threads.
+//
 // This function writes undefined symbol diagnostics to an internal buffer.
 // Call reportUndefinedSymbols() after calling scanRelocations() to emit
 // the diagnostics.
-template <class ELFT> void scanRelocations(InputSectionBase &);
+template <class ELFT>
+void scanRelocations(ArrayRef<InputSectionBase *> sections);
 
 template <class ELFT> void reportUndefinedSymbols();
 
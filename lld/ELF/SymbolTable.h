@@ -47,6 +47,14 @@ public:
 
   Symbol *insert(StringRef name);
 
+  // Same as above, but takes a key returned by getKey(). getKey() is
+  // thread-safe, so callers may compute the keys of many symbols in parallel
+  // and then insert them serially.
+  Symbol *insert(llvm::CachedHashStringRef key);
+
+  // Returns the key under which a symbol named Name is stored.
+  static llvm::CachedHashStringRef getKey(StringRef name);
+
   Symbol *addSymbol(const Symbol &newSym);
 
   void scanVersionScript();
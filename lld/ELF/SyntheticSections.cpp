@@ -53,6 +53,7 @@ using llvm::support::endian::write64le;
 
 namespace lld {
 namespace elf {
+constexpr size_t MergeTailSection::numShards;
 constexpr size_t MergeNoTailSection::numShards;
 
 static uint64_t readUint(uint8_t *buf) {
@@ -3144,33 +3145,91 @@ void MergeSyntheticSection::addSection(MergeInputSection *ms) {
   alignment = std::max(alignment, ms->alignment);
 }
 
-MergeTailSection::MergeTailSection(StringRef name, uint32_t type,
-                                   uint64_t flags, uint32_t alignment)
-    : MergeSyntheticSection(name, type, flags, alignment),
-      builder(StringTableBuilder::RAW, alignment) {}
+void MergeTailSection::writeTo(uint8_t *buf) {
+  for (size_t i = 0; i < numShards; ++i)
+    shards[i].write(buf + shardOffsets[i]);
+  if (emptyStringOff != -1)
+    memset(buf + emptyStringOff, 0, entsize);
+}
 
-size_t MergeTailSection::getSize() const { return builder.getSize(); }
+// Like MergeNoTailSection::finalizeContents, this function is very hot,
+// and suffix-sorting strings is even more expensive than hashing them, so
+// we use multi-threading here too.
+//
+// A string S can be merged with another string T only if S is a suffix of T,
+// so S and T must end with the same character (excluding the terminating
+// null character). We shard strings by their last character and tail-merge
+// each shard in parallel. Shards are laid out in descending order of their
+// characters, which is the order in which StringTableBuilder would have
+// sorted the strings, so the result is the same as if we had added all
+// strings to a single StringTableBuilder.
+void MergeTailSection::finalizeContents() {
+  // The empty string, which consists only of a null character, is a suffix
+  // of any string. We place it separately at the end.
+  bool hasEmptyString = false;
+
+  // Distribute section pieces to shards.
+  std::vector<std::pair<MergeInputSection *, size_t>> pieces[numShards];
+  for (MergeInputSection *sec : sections) {
+    for (size_t i = 0, e = sec->pieces.size(); i != e; ++i) {
+      if (!sec->pieces[i].live)
+        continue;
+      StringRef s = sec->getData(i).val();
+      if (s.size() <= entsize) {
+        hasEmptyString = true;
+        continue;
+      }
+      size_t shardId = 255 - (uint8_t)s[s.size() - entsize - 1];
+      pieces[shardId].emplace_back(sec, i);
+    }
+  }
 
-void MergeTailSection::writeTo(uint8_t *buf) { builder.write(buf); }
+  // Tail-merge strings in each shard.
+  for (size_t i = 0; i < numShards; ++i)
+    shards.emplace_back(StringTableBuilder::RAW, alignment);
 
-void MergeTailSection::finalizeContents() {
-  // Add all string pieces to the string table builder to create section
-  // contents.
-  for (MergeInputSection *sec : sections)
-    for (size_t i = 0, e = sec->pieces.size(); i != e; ++i)
-      if (sec->pieces[i].live)
-        builder.add(sec->getData(i));
+  parallelForEachN(0, numShards, [&](size_t shardId) {
+    StringTableBuilder &builder = shards[shardId];
+    for (std::pair<MergeInputSection *, size_t> &p : pieces[shardId])
+      builder.add(p.first->getData(p.second));
+    builder.finalize();
+    for (std::pair<MergeInputSection *, size_t> &p : pieces[shardId])
+      p.first->pieces[p.second].outputOff =
+          builder.getOffset(p.first->getData(p.second));
+  });
 
-  // Fix the string table content. After this, the contents will never change.
-  builder.finalize();
+  // Compute an in-section offset for each shard.
+  size_t off = 0;
+  for (size_t i = 0; i < numShards; ++i) {
+    if (shards[i].getSize() > 0)
+      off = alignTo(off, alignment);
+    shardOffsets[i] = off;
+    off += shards[i].getSize();
+  }
 
-  // finalize() fixed tail-optimized strings, so we can now get
-  // offsets of strings. Get an offset for each string and save it
-  // to a corresponding SectionPiece for easy access.
-  for (MergeInputSection *sec : sections)
-    for (size_t i = 0, e = sec->pieces.size(); i != e; ++i)
-      if (sec->pieces[i].live)
-        sec->pieces[i].outputOff = builder.getOffset(sec->getData(i));
+  // The empty string can share the terminating null character of the last
+  // string if the offset is suitably aligned.
+  if (hasEmptyString) {
+    if (off == 0 || ((off - entsize) & (alignment - 1))) {
+      off = alignTo(off, alignment);
+      off += entsize;
+    }
+    emptyStringOff = off - entsize;
+  }
+  size = off;
+
+  // So far, section pieces have offsets from beginning of shards, but
+  // we want offsets from beginning of the whole section. Fix them.
+  parallelForEachN(0, numShards, [&](size_t shardId) {
+    for (std::pair<MergeInputSection *, size_t> &p : pieces[shardId])
+      p.first->pieces[p.second].outputOff += shardOffsets[shardId];
+  });
+  if (hasEmptyString)
+    parallelForEach(sections, [&](MergeInputSection *sec) {
+      for (size_t i = 0, e = sec->pieces.size(); i != e; ++i)
+        if (sec->pieces[i].live && sec->getData(i).size() <= entsize)
+          sec->pieces[i].outputOff = emptyStringOff;
+    });
 }
 
 void MergeNoTailSection::writeTo(uint8_t *buf) {
@@ -11,6 +11,7 @@
 #include "ARMErrataFix.h"
 #include "CallGraphSort.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "LinkerScript.h"
 #include "MapFile.h"
 #include "OutputSections.h"
@@ -75,6 +76,7 @@ private:
   void writeHeader();
   void writeSections();
   void writeSectionsBinary();
+  void writeSection(OutputSection *sec);
   void writeBuildId();
 
   std::unique_ptr<FileOutputBuffer> &buffer;
@@ -85,6 +87,9 @@ private:
 
   uint64_t fileSize;
   uint64_t sectionHeaderOff;
+
+  // True if the output file is patched in place. See Incremental.cpp.
+  bool patchExistingOutput = false;
 };
 } // anonymous namespace
 
@@ -122,10 +127,10 @@ StringRef getOutputSectionName(const InputSectionBase *s) {
   // GNU ld places text sections with prefix ".text.hot.", ".text.unlikely.",
   // ".text.startup." or ".text.exit." before others. We provide an option -z
   // keep-text-section-prefix to group such sections into separate output
-  // sections. This is more flexible. See also sortISDBySectionOrder().
+  // sections. This is more flexible. See also sortTextSectionsByPrefix().
   if (config->zKeepTextSectionPrefix)
-    for (StringRef v :
-         {".text.hot.", ".text.unlikely.", ".text.startup.", ".text.exit."})
+    for (StringRef v : {".text.hot.", ".text.unlikely.", ".text.split.",
+                        ".text.startup.", ".text.exit."})
       if (isSectionPrefix(v, s->name))
         return v.drop_back();
 
@@ -575,8 +580,11 @@ template <class ELFT> void Writer<ELFT>::run() {
   // If -compressed-debug-sections is specified, we need to compress
   // .debug_* sections. Do it right now because it changes the size of
   // output sections.
-  for (OutputSection *sec : outputSections)
-    sec->maybeCompress<ELFT>();
+  if (config->compressDebugSections) {
+    llvm::TimeTraceScope timeScope("Compress debug sections");
+    for (OutputSection *sec : outputSections)
+      sec->maybeCompress<ELFT>();
+  }
 
   if (script->hasSectionsCommand)
     script->allocateHeaders(mainPart->phdrs);
@@ -587,10 +595,13 @@ template <class ELFT> void Writer<ELFT>::run() {
   for (Partition &part : partitions)
     removeEmptyPTLoad(part.phdrs);
 
-  if (!config->oFormatBinary)
-    assignFileOffsets();
-  else
-    assignFileOffsetsBinary();
+  {
+    llvm::TimeTraceScope timeScope("Assign file offsets");
+    if (!config->oFormatBinary)
+      assignFileOffsets();
+    else
+      assignFileOffsetsBinary();
+  }
 
   for (Partition &part : partitions)
     setPhdrs(part);
@@ -616,13 +627,25 @@ template <class ELFT> void Writer<ELFT>::run() {
   if (errorCount())
     return;
 
-  if (!config->oFormatBinary) {
-    if (config->zSeparate != SeparateSegmentKind::None)
-      writeTrapInstr();
-    writeHeader();
-    writeSections();
-  } else {
-    writeSectionsBinary();
+  // Sort input buffers by address so that writeSection() can find the
+  // buffer containing an input section.
+  llvm::sort(mappedInputBuffers, [](MemoryBuffer *a, MemoryBuffer *b) {
+    return a->getBufferStart() < b->getBufferStart();
+  });
+
+  {
+    llvm::TimeTraceScope timeScope("Write sections", [&] {
+      return std::to_string(outputSections.size()) + " sections, " +
+             std::to_string(fileSize) + " bytes";
+    });
+    if (!config->oFormatBinary) {
+      if (config->zSeparate != SeparateSegmentKind::None)
+        writeTrapInstr();
+      writeHeader();
+      writeSections();
+    } else {
+      writeSectionsBinary();
+    }
   }
 
   // Backfill .note.gnu.build-id section content. This is done at last
@@ -631,7 +654,10 @@ template <class ELFT> void Writer<ELFT>::run() {
   if (errorCount())
     return;
 
-  if (auto e = buffer->commit())
+  llvm::TimeTraceScope timeScope("Commit output file");
+  if (config->incremental)
+    commitIncrementalOutput(*buffer, patchExistingOutput);
+  else if (auto e = buffer->commit())
     error("failed to write to the output file: " + toString(std::move(e)));
 }
 
@@ -1292,10 +1318,35 @@ static DenseMap<const InputSectionBase *, int> buildSectionOrder() {
   return sectionOrder;
 }
 
-// Sorts the sections in ISD according to the provided section order.
+// Returns the rank of a text section by the prefix that the compiler gives to
+// hot and cold functions.
+static int getTextSectionPrefixRank(const InputSection *isec) {
+  if (isSectionPrefix(".text.hot.", isec->name))
+    return 0;
+  if (isSectionPrefix(".text.unlikely.", isec->name))
+    return 2;
+  // Code that HotColdSplitting split out of other functions.
+  if (isSectionPrefix(".text.split.", isec->name))
+    return 3;
+  return 1;
+}
+
+// Groups the hot text sections at the start, and the unlikely and split ones
+// at the end, so that the hot code is packed in as few pages as possible. The
+// order within each group is kept.
+static void sortTextSectionsByPrefix(MutableArrayRef<InputSection *> sections) {
+  llvm::stable_sort(sections, [](const InputSection *a, const InputSection *b) {
+    return getTextSectionPrefixRank(a) < getTextSectionPrefixRank(b);
+  });
+}
+
+// Sorts the sections in ISD according to the provided section order. If
+// groupByPrefix is true, the sections that are not in the order are grouped by
+// their hot and cold prefixes first.
 static void
 sortISDBySectionOrder(InputSectionDescription *isd,
-                      const DenseMap<const InputSectionBase *, int> &order) {
+                      const DenseMap<const InputSectionBase *, int> &order,
+                      bool groupByPrefix) {
   std::vector<InputSection *> unorderedSections;
   std::vector<std::pair<InputSection *, int>> orderedSections;
   uint64_t unorderedSize = 0;
@@ -1310,6 +1361,8 @@ sortISDBySectionOrder(InputSectionDescription *isd,
     orderedSections.push_back({isec, i->second});
   }
   llvm::sort(orderedSections, llvm::less_second());
+  if (groupByPrefix)
+    sortTextSectionsByPrefix(unorderedSections);
 
   // Find an insertion point for the ordered section list in the unordered
   // section list. On targets with limited-range branches, this is the mid-point
@@ -1365,14 +1418,28 @@ static void sortSection(OutputSection *sec,
   if (name == ".init" || name == ".fini")
     return;
 
+  // Group text sections by their hot and cold prefixes, unless a linker
+  // script decides the layout. Sections in the section order are placed by
+  // sortISDBySectionOrder() instead, which puts them in the middle of the
+  // other sections on targets with range extension thunks.
+  bool groupByPrefix = name == ".text" && !script->hasSectionsCommand;
+
   // Sort input sections by priority using the list provided by
   // --symbol-ordering-file or --shuffle-sections=. This is a least significant
   // digit radix sort. The sections may be sorted stably again by a more
   // significant key.
-  if (!order.empty())
-    for (BaseCommand *b : sec->sectionCommands)
-      if (auto *isd = dyn_cast<InputSectionDescription>(b))
-        sortISDBySectionOrder(isd, order);
+  for (BaseCommand *b : sec->sectionCommands) {
+    auto *isd = dyn_cast<InputSectionDescription>(b);
+    if (!isd)
+      continue;
+    if (!order.empty())
+      sortISDBySectionOrder(isd, order, groupByPrefix);
+    else if (groupByPrefix)
+      sortTextSectionsByPrefix(isd->sections);
+  }
+
+  if (name == ".text")
+    return;
 
   // Sort input sections by section name suffixes for
   // __attribute__((init_priority(N))).
@@ -1605,6 +1672,7 @@ template <class ELFT> void Writer<ELFT>::resolveShfLinkOrder() {
 // addresses we must converge to a fixed point. We do that here. See the comment
 // in Writer<ELFT>::finalizeSections().
 template <class ELFT> void Writer<ELFT>::finalizeAddressDependentContent() {
+  llvm::TimeTraceScope timeScope("Finalize address dependent content");
   ThunkCreator tc;
   AArch64Err843419Patcher a64p;
   ARMErr657417Patcher a32p;
@@ -1616,7 +1684,11 @@ template <class ELFT> void Writer<ELFT>::finalizeAddressDependentContent() {
 
   int assignPasses = 0;
   for (;;) {
-    bool changed = target->needsThunks && tc.createThunks(outputSections);
+    bool changed = false;
+    if (target->needsThunks) {
+      llvm::TimeTraceScope timeScope("Create thunks");
+      changed = tc.createThunks(outputSections);
+    }
 
     // With Thunk Size much smaller than branch range we expect to
     // converge quickly; if we get to 10 something has gone wrong.
@@ -1713,6 +1785,7 @@ static void removeUnusedSyntheticSections() {
 
 // Create output section objects and add them to OutputSections.
 template <class ELFT> void Writer<ELFT>::finalizeSections() {
+  llvm::TimeTraceScope timeScope("Finalize sections");
   Out::preinitArray = findSection(".preinit_array");
   Out::initArray = findSection(".init_array");
   Out::finiArray = findSection(".fini_array");
@@ -1789,7 +1862,10 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
   // after processSymbolAssignments() because it needs to know whether a
   // linker-script-defined symbol is absolute.
   if (!config->relocatable) {
-    forEachRelSec(scanRelocations<ELFT>);
+    llvm::TimeTraceScope timeScope("Scan relocations");
+    std::vector<InputSectionBase *> relSecs;
+    forEachRelSec([&](InputSectionBase &s) { relSecs.push_back(&s); });
+    scanRelocations<ELFT>(relSecs);
     reportUndefinedSymbols<ELFT>();
   }
 
@@ -2649,11 +2725,16 @@ template <class ELFT> void Writer<ELFT>::openFile() {
     return;
   }
 
-  unlinkAsync(config->outputFile);
+  // If the output of the previous link can be patched, keep it and build the
+  // new contents in memory so that we can compare them with the old ones.
+  patchExistingOutput = config->incremental && canPatchOutputFile(fileSize);
+  if (!patchExistingOutput)
+    unlinkAsync(config->outputFile);
+
   unsigned flags = 0;
   if (!config->relocatable)
     flags |= FileOutputBuffer::F_executable;
-  if (!config->mmapOutputFile)
+  if (!config->mmapOutputFile || patchExistingOutput)
     flags |= FileOutputBuffer::F_no_mmap;
   Expected<std::unique_ptr<FileOutputBuffer>> bufferOrErr =
       FileOutputBuffer::create(config->outputFile, fileSize, flags);
@@ -2670,7 +2751,54 @@ template <class ELFT> void Writer<ELFT>::openFile() {
 template <class ELFT> void Writer<ELFT>::writeSectionsBinary() {
   for (OutputSection *sec : outputSections)
     if (sec->flags & SHF_ALLOC)
-      sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      writeSection(sec);
+}
+
+// Tells the OS that the pages of a memory-mapped input file holding the
+// given data are not needed anymore.
+static void releaseInputData(ArrayRef<MemoryBuffer *> buffers,
+                             ArrayRef<uint8_t> data) {
+  const char *p = reinterpret_cast<const char *>(data.data());
+  auto it = llvm::partition_point(buffers, [&](MemoryBuffer *mb) {
+    return mb->getBufferStart() <= p;
+  });
+  if (it == buffers.begin())
+    return;
+  MemoryBuffer *mb = *(it - 1);
+  if (p + data.size() <= mb->getBufferEnd())
+    mb->dontNeedIfMmapped(p - mb->getBufferStart(), data.size());
+}
+
+// Writes an output section and then releases the memory used by it.
+//
+// Once an output section is written, we rarely read it or its input sections
+// again, so there is no point in keeping the pages of the output file and the
+// input files in memory. For large outputs with lots of debug info, the
+// memory-mapped files would otherwise make up most of the linker's peak
+// memory usage. The contents are preserved; if the same data is accessed
+// again after this (e.g. to compute a build-id), it is paged back in.
+template <class ELFT> void Writer<ELFT>::writeSection(OutputSection *sec) {
+  llvm::TimeTraceScope timeScope("Write section", sec->name);
+  sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+  if (sec->type == SHT_NOBITS)
+    return;
+  buffer->dontNeed(sec->offset, sec->size);
+
+  if (mappedInputBuffers.empty())
+    return;
+  for (InputSection *isec : getInputSections(sec)) {
+    if (!isec->file || isa<SyntheticSection>(isec))
+      continue;
+    releaseInputData(mappedInputBuffers, isec->data());
+    if (isec->numRelocations) {
+      size_t relSize = isec->areRelocsRela ? sizeof(typename ELFT::Rela)
+                                           : sizeof(typename ELFT::Rel);
+      releaseInputData(
+          mappedInputBuffers,
+          makeArrayRef(static_cast<const uint8_t *>(isec->firstRelocation),
+                       isec->numRelocations * relSize));
+    }
+  }
 }
 
 static void fillTrap(uint8_t *i, uint8_t *end) {
@@ -2715,11 +2843,11 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
   // section while doing it.
   for (OutputSection *sec : outputSections)
     if (sec->type == SHT_REL || sec->type == SHT_RELA)
-      sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      writeSection(sec);
 
   for (OutputSection *sec : outputSections)
     if (sec->type != SHT_REL && sec->type != SHT_RELA)
-      sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      writeSection(sec);
 }
 
 // Split one uint8 array into small pieces of uint8 arrays.
@@ -2766,6 +2894,7 @@ template <class ELFT> void Writer<ELFT>::writeBuildId() {
   }
 
   // Compute a hash of all sections of the output file.
+  llvm::TimeTraceScope timeScope("Compute build id");
   size_t hashSize = mainPart->buildId->hashSize;
   std::vector<uint8_t> buildId(hashSize);
   llvm::ArrayRef<uint8_t> buf{Out::bufferStart, size_t(fileSize)};
@@ -2773,7 +2902,7 @@ template <class ELFT> void Writer<ELFT>::writeBuildId() {
   switch (config->buildId) {
   case BuildIdKind::Fast:
     computeHash(buildId, buf, [](uint8_t *dest, ArrayRef<uint8_t> arr) {
-      write64le(dest, xxHash64(arr));
+      write64le(dest, xxh3_64bits(arr));
     });
     break;
   case BuildIdKind::Md5:
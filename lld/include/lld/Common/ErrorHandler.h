@@ -117,6 +117,19 @@ private:
 /// Returns the default error handler.
 ErrorHandler &errorHandler();
 
+// While an instance is alive, errors and warnings reported on the current
+// thread are neither printed nor counted, but appended to the given vector.
+// Parallel loops use this to keep diagnostics out of the output until they
+// can be reported in a deterministic order.
+class DiagnosticCollector {
+public:
+  explicit DiagnosticCollector(std::vector<std::string> &diags);
+  ~DiagnosticCollector();
+
+private:
+  std::vector<std::string> *prev;
+};
+
 inline void error(const Twine &msg) { errorHandler().error(msg); }
 inline LLVM_ATTRIBUTE_NORETURN void fatal(const Twine &msg) {
   errorHandler().fatal(msg);
@@ -52,6 +52,7 @@ static std::unique_ptr<lto::LTO> createLTO() {
   c.OptLevel = config->ltoo;
   c.MAttrs = getMAttrs();
   c.CGOptLevel = args::getCGOptLevel(config->ltoo);
+  c.ThinLinkCacheDir = std::string(config->thinLTOCacheDir);
 
   if (config->relocatable)
     c.RelocModel = None;
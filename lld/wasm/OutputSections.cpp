@@ -109,9 +109,12 @@ void CodeSection::writeTo(uint8_t *buf) {
   // Write code section headers
   memcpy(buf, codeSectionHeader.data(), codeSectionHeader.size());
 
-  // Write code section bodies
-  for (const InputChunk *chunk : functions)
-    chunk->writeTo(buf);
+  // Write code section bodies. Each function has its own precomputed output
+  // offset, so they can be written and relocated in parallel. This loop is
+  // nested in the one over output sections in Writer::writeSections, and
+  // relies on nested parallel loops not being run serially.
+  parallelForEach(functions,
+                  [&](const InputChunk *chunk) { chunk->writeTo(buf); });
 }
 
 uint32_t CodeSection::getNumRelocations() const {
@@ -185,17 +188,21 @@ void DataSection::writeTo(uint8_t *buf) {
   // Write data section headers
   memcpy(buf, dataSectionHeader.data(), dataSectionHeader.size());
 
+  std::vector<const InputChunk *> chunks;
   for (const OutputSegment *segment : segments) {
     if (segment->isBss)
       continue;
     // Write data segment header
     uint8_t *segStart = buf + segment->sectionOffset;
     memcpy(segStart, segment->header.data(), segment->header.size());
-
-    // Write segment data payload
-    for (const InputChunk *chunk : segment->inputSegments)
-      chunk->writeTo(buf);
+    chunks.insert(chunks.end(), segment->inputSegments.begin(),
+                  segment->inputSegments.end());
   }
+
+  // Write segment data payloads. They are written in a single loop, as most
+  // segments only hold a few chunks.
+  parallelForEach(chunks,
+                  [&](const InputChunk *chunk) { chunk->writeTo(buf); });
 }
 
 uint32_t DataSection::getNumRelocations() const {
@@ -215,10 +215,24 @@ private:
   void SymbolIndicesToSymbolContextList(std::vector<uint32_t> &symbol_indexes,
                                         SymbolContextList &sc_list);
 
+  /// The parts of a demangled function name that the name indexes need.
+  struct FunctionNameParts {
+    ConstString base_name;
+    ConstString decl_context;
+    bool is_ctor_or_dtor = false;
+  };
+
+  /// Demangle the names of the symbols in [begin, end), store the parts of
+  /// the function names in \a parts and cache the demangled names in the
+  /// symbols. This only touches the given symbols, so disjoint ranges can be
+  /// processed in parallel.
+  void DemangleSymbolNames(uint32_t begin, uint32_t end,
+                           std::vector<FunctionNameParts> &parts);
+
   void RegisterMangledNameEntry(
-      uint32_t value, std::set<const char *> &class_contexts,
-      std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-      RichManglingContext &rmc);
+      uint32_t value, const FunctionNameParts &parts,
+      std::set<const char *> &class_contexts,
+      std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog);
 
   void RegisterBacklogEntry(const NameToIndexMap::Entry &entry,
                             const char *decl_context,
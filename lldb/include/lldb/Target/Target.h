@@ -12,6 +12,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -137,6 +138,8 @@ public:
 
   bool GetEnableNotifyAboutFixIts() const;
 
+  bool GetEnableExpressionCache() const;
+
   bool GetEnableSaveObjects() const;
 
   bool GetEnableSyntheticValue() const;
@@ -1045,6 +1048,28 @@ public:
                                const EvaluateExpressionOptions &options,
                                ValueObject *ctx_obj, Status &error);
 
+  /// Take a parsed expression out of the cache of expressions that were
+  /// evaluated before.
+  ///
+  /// \param[in] key
+  ///     The text and the parse options of the expression, see
+  ///     UserExpression::Evaluate.
+  ///
+  /// \return
+  ///     The expression or an empty pointer if there is none for \a key or it
+  ///     can't run in \a exe_ctx. The caller hands the expression back with
+  ///     CacheUserExpression once it is done with it, so that one expression
+  ///     is never executed recursively.
+  lldb::UserExpressionSP TakeCachedUserExpression(llvm::StringRef key,
+                                                  ExecutionContext &exe_ctx);
+
+  void CacheUserExpression(llvm::StringRef key,
+                           lldb::UserExpressionSP expr_sp);
+
+  /// Forget all cached expressions. Called whenever the code or the
+  /// declarations they were compiled against may have changed.
+  void ClearUserExpressionCache();
+
   // Creates a FunctionCaller for the given language, the rest of the
   // parameters have the same meaning as for the FunctionCaller constructor.
   // Since a FunctionCaller can't be
@@ -1306,6 +1331,13 @@ protected:
   PathMappingList m_image_search_paths;
   TypeSystemMap m_scratch_type_system_map;
 
+  /// Recently evaluated expressions that can run again without being parsed,
+  /// most recently used first.
+  typedef std::list<std::pair<std::string, lldb::UserExpressionSP>>
+      UserExpressionCache;
+  UserExpressionCache m_user_expression_cache;
+  std::mutex m_user_expression_cache_mutex;
+
   typedef std::map<lldb::LanguageType, lldb::REPLSP> REPLMap;
   REPLMap m_repl_map;
 
@@ -219,21 +219,59 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
       language = frame->GetLanguage();
   }
 
-  lldb::UserExpressionSP user_expression_sp(
-      target->GetUserExpressionForLanguage(expr, full_prefix, language,
-                                           desired_type, options, ctx_obj,
-                                           error));
-  if (error.Fail()) {
-    LLDB_LOG(log, "== [UserExpression::Evaluate] Getting expression: {0} ==",
-             error.AsCString());
-    return lldb::eExpressionSetupError;
+  const bool keep_expression_in_memory = true;
+  const bool generate_debug_info = options.GetGenerateDebugInfo();
+
+  // An expression that parsed before can run again in the same context
+  // without being parsed again. Leave out everything whose parse has side
+  // effects: top level code and REPL input define new declarations and "$"
+  // names may declare persistent variables.
+  std::string cache_key;
+  if (!ctx_obj && execution_policy != eExecutionPolicyTopLevel &&
+      !options.GetREPLEnabled() && target->GetEnableExpressionCache() &&
+      !expr.contains('$')) {
+    // The variables the expression can see depend on the innermost block and
+    // on the frame it was parsed for.
+    lldb::addr_t frame_addr = LLDB_INVALID_ADDRESS;
+    lldb::addr_t frame_cfa = LLDB_INVALID_ADDRESS;
+    lldb::user_id_t block_id = LLDB_INVALID_UID;
+    if (StackFrame *frame = exe_ctx.GetFramePtr()) {
+      frame_addr = frame->GetFrameCodeAddress().GetLoadAddress(target);
+      frame_cfa = frame->GetStackID().GetCallFrameAddress();
+      if (Block *block = frame->GetSymbolContext(eSymbolContextBlock).block)
+        block_id = block->GetID();
+    }
+    llvm::raw_string_ostream key_stream(cache_key);
+    key_stream << language << ':' << desired_type << ':' << execution_policy
+               << ':' << generate_debug_info << ':' << frame_addr << ':'
+               << frame_cfa << ':' << block_id << ':'
+               << target->GetEnableImportStdModule() << ':'
+               << target->GetEnableAutoImportClangModules() << ':'
+               << target->GetInjectLocalVariables(&exe_ctx) << ':'
+               << options.GetPoundLineLine() << ':';
+    if (const char *pound_line_file = options.GetPoundLineFilePath())
+      key_stream << pound_line_file;
+    key_stream << ':' << full_prefix.size() << ':' << full_prefix << expr;
+    key_stream.flush();
   }
 
-  LLDB_LOG(log, "== [UserExpression::Evaluate] Parsing expression {0} ==",
-           expr.str());
+  lldb::UserExpressionSP user_expression_sp;
+  if (!cache_key.empty())
+    user_expression_sp = target->TakeCachedUserExpression(cache_key, exe_ctx);
+  const bool reuse_expression = user_expression_sp != nullptr;
+
+  if (!reuse_expression) {
+    user_expression_sp.reset(target->GetUserExpressionForLanguage(
+        expr, full_prefix, language, desired_type, options, ctx_obj, error));
+    if (error.Fail()) {
+      LLDB_LOG(log, "== [UserExpression::Evaluate] Getting expression: {0} ==",
+               error.AsCString());
+      return lldb::eExpressionSetupError;
+    }
+  }
 
-  const bool keep_expression_in_memory = true;
-  const bool generate_debug_info = options.GetGenerateDebugInfo();
+  LLDB_LOG(log, "== [UserExpression::Evaluate] {0} expression {1} ==",
+           reuse_expression ? "Reusing" : "Parsing", expr.str());
 
   if (options.InvokeCancelCallback(lldb::eExpressionEvaluationParse)) {
     error.SetErrorString("expression interrupted by callback before parse");
@@ -245,6 +283,7 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
   DiagnosticManager diagnostic_manager;
 
   bool parse_success =
+      reuse_expression ||
       user_expression_sp->Parse(diagnostic_manager, exe_ctx, execution_policy,
                                 keep_expression_in_memory, generate_debug_info);
 
@@ -260,8 +299,10 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
   // If there is a fixed expression, try to parse it:
   if (!parse_success) {
     // Delete the expression that failed to parse before attempting to parse
-    // the next expression.
+    // the next expression. The fixed one is not cached, since it is not what
+    // the user typed.
     user_expression_sp.reset();
+    cache_key.clear();
 
     execution_results = lldb::eExpressionParseError;
     if (fixed_expression && !fixed_expression->empty() &&
@@ -314,6 +355,9 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
         error.SetExpressionError(lldb::eExpressionSetupError,
                                  "expression needed to run but couldn't");
     } else if (execution_policy == eExecutionPolicyTopLevel) {
+      // The new declarations may change what the names in the cached
+      // expressions refer to.
+      target->ClearUserExpressionCache();
       error.SetError(UserExpression::kNoResult, lldb::eErrorTypeGeneric);
       return lldb::eExpressionCompleted;
     } else {
@@ -358,6 +402,11 @@ UserExpression::Evaluate(ExecutionContext &exe_ctx,
 
           error.SetError(UserExpression::kNoResult, lldb::eErrorTypeGeneric);
         }
+
+        // Only an expression that ran to completion is known to be in a state
+        // in which it can run again.
+        if (!cache_key.empty())
+          target->CacheUserExpression(cache_key, user_expression_sp);
       }
     }
   }
@@ -31,6 +31,7 @@
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Utility/Args.h"
 #include "lldb/Utility/DataBuffer.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Endian.h"
 #include "lldb/Utility/LLDBAssert.h"
 #include "lldb/Utility/Log.h"
@@ -562,6 +563,67 @@ GetRegistersAsJSON(NativeThreadProtocol &thread) {
   return register_object;
 }
 
+namespace {
+struct ExpeditedMemory {
+  lldb::addr_t address;
+  std::vector<uint8_t> bytes;
+};
+} // namespace
+
+// Reads the saved frame pointer and return address of each frame on the frame
+// pointer chain of the thread. Sending them along with the stop spares the
+// client a memory read round trip for every frame it backtraces through,
+// which adds up quickly over a slow connection. Where the frames are not laid
+// out like this the client gets bytes it does not need, but they are still
+// the real contents of the stack.
+static std::vector<ExpeditedMemory>
+GetExpeditedStackMemory(NativeThreadProtocol &thread) {
+  // Stop somewhere, the client reads the rest of a deep stack itself.
+  const uint32_t max_frames = 64;
+
+  NativeProcessProtocol &process = thread.GetProcess();
+  const uint32_t addr_size = process.GetAddressByteSize();
+  std::vector<ExpeditedMemory> memory;
+  if (addr_size != 4 && addr_size != 8)
+    return memory;
+
+  lldb::addr_t fp = thread.GetRegisterContext().GetFP(0);
+  for (uint32_t i = 0; i < max_frames && fp != 0 && fp % addr_size == 0; ++i) {
+    ExpeditedMemory frame;
+    frame.address = fp;
+    frame.bytes.resize(2 * addr_size);
+    size_t bytes_read = 0;
+    Status error = process.ReadMemoryWithoutTrap(
+        fp, frame.bytes.data(), frame.bytes.size(), bytes_read);
+    if (error.Fail() || bytes_read != frame.bytes.size())
+      break;
+
+    lldb_private::DataExtractor data(frame.bytes.data(), frame.bytes.size(),
+                                     process.GetByteOrder(), addr_size);
+    lldb::offset_t offset = 0;
+    const lldb::addr_t next_fp = data.GetAddress(&offset);
+    memory.push_back(std::move(frame));
+    // The stack grows down, so a caller's frame is always above its callee.
+    // Anything else is not a frame pointer chain, or its end.
+    if (next_fp < fp + 2 * addr_size)
+      break;
+    fp = next_fp;
+  }
+  return memory;
+}
+
+static json::Array GetExpeditedStackMemoryAsJSON(NativeThreadProtocol &thread) {
+  json::Array memory_array;
+  for (const ExpeditedMemory &memory : GetExpeditedStackMemory(thread)) {
+    StreamString stream;
+    stream.PutBytesAsRawHex8(memory.bytes.data(), memory.bytes.size());
+    memory_array.push_back(
+        json::Object{{"address", static_cast<int64_t>(memory.address)},
+                     {"bytes", stream.GetString().str()}});
+  }
+  return memory_array;
+}
+
 static const char *GetStopReasonString(StopReason stop_reason) {
   switch (stop_reason) {
   case eStopReasonTrace:
@@ -626,6 +688,10 @@ GetJSONThreadsInfo(NativeProcessProtocol &process, bool abridged) {
       } else {
         return registers.takeError();
       }
+
+      json::Array memory = GetExpeditedStackMemoryAsJSON(*thread);
+      if (!memory.empty())
+        thread_obj.try_emplace("memory", std::move(memory));
     }
 
     thread_obj.try_emplace("tid", static_cast<int64_t>(tid));
@@ -850,6 +916,14 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
     }
   }
 
+  // Expedite the frame pointer chain of the thread that stopped, which the
+  // client is about to backtrace.
+  for (const ExpeditedMemory &memory : GetExpeditedStackMemory(*thread)) {
+    response.Printf("memory:0x%" PRIx64 "=", memory.address);
+    response.PutBytesAsRawHex8(memory.bytes.data(), memory.bytes.size());
+    response.PutChar(';');
+  }
+
   const char *reason_str = GetStopReasonString(tid_stop_info.reason);
   if (reason_str != nullptr) {
     response.Printf("reason:%s;", reason_str);
@@ -7,8 +7,32 @@
 //===----------------------------------------------------------------------===//
 
 #include "DIERef.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "llvm/Support/Format.h"
 
+void DIERef::Encode(llvm::support::endian::Writer &writer) const {
+  uint32_t header = m_dwo_num;
+  if (m_dwo_num_valid)
+    header |= 1u << 30;
+  if (m_section == DebugTypes)
+    header |= 1u << 31;
+  writer.write<uint32_t>(header);
+  writer.write<uint32_t>(m_die_offset);
+}
+
+llvm::Optional<DIERef> DIERef::Decode(const lldb_private::DataExtractor &data,
+                                      lldb::offset_t *offset_ptr) {
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 8))
+    return llvm::None;
+  const uint32_t header = data.GetU32(offset_ptr);
+  const dw_offset_t die_offset = data.GetU32(offset_ptr);
+  llvm::Optional<uint32_t> dwo_num;
+  if (header & (1u << 30))
+    dwo_num = header & ((1u << 30) - 1);
+  Section section = (header & (1u << 31)) ? DebugTypes : DebugInfo;
+  return DIERef(dwo_num, section, die_offset);
+}
+
 void llvm::format_provider<DIERef>::format(const DIERef &ref, raw_ostream &OS,
                                            StringRef Style) {
   if (ref.dwo_num())
@@ -2578,8 +2578,13 @@ void DWARFASTParserClang::ParseSingleMember(
       if (var_type) {
         if (accessibility == eAccessNone)
           accessibility = eAccessPublic;
+        // A static member is not part of the layout of the class, so its type
+        // does not need to be complete, and clang completes it through the
+        // ExternalASTSource if the member is ever used. Completing it here
+        // would pull in the definitions of every type that is only mentioned
+        // by a static member, recursively.
         TypeSystemClang::AddVariableToRecordType(
-            class_clang_type, name, var_type->GetLayoutCompilerType(),
+            class_clang_type, name, var_type->GetForwardCompilerType(),
             accessibility);
       }
       return;
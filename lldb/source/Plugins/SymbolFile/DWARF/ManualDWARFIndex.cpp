@@ -13,10 +13,18 @@
 #include "Plugins/SymbolFile/DWARF/LogChannelDWARF.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARFDwo.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Host/FileSystem.h"
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace lldb_private;
 using namespace lldb;
@@ -31,6 +39,9 @@ void ManualDWARFIndex::Index() {
   static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
   Timer scoped_timer(func_cat, "%p", static_cast<void *>(&main_dwarf));
 
+  if (LoadFromCache(main_dwarf))
+    return;
+
   DWARFDebugInfo &main_info = main_dwarf.DebugInfo();
   SymbolFileDWARFDwo *dwp_dwarf = main_dwarf.GetDwpSymbolFile().get();
   DWARFDebugInfo *dwp_info = dwp_dwarf ? &dwp_dwarf->DebugInfo() : nullptr;
@@ -101,6 +112,207 @@ void ManualDWARFIndex::Index() {
                      [&]() { finalize_fn(&IndexSet::globals); },
                      [&]() { finalize_fn(&IndexSet::types); },
                      [&]() { finalize_fn(&IndexSet::namespaces); });
+
+  SaveToCache(main_dwarf, units_to_index, dwp_dwarf);
+}
+
+// The cache file starts with a magic number and a version, followed by the
+// signature of the files the index was made from. Then comes a string table
+// with the NUL terminated names, and each of the NameToDIE maps of the IndexSet
+// in the order below, with the names stored as indexes into the string table.
+// Everything is little endian.
+static const uint32_t g_cache_magic = 0x58444c4c; // "LLDX"
+static const uint32_t g_cache_version = 1;
+
+llvm::ArrayRef<NameToDIE ManualDWARFIndex::IndexSet::*>
+ManualDWARFIndex::GetCachedMaps() {
+  static NameToDIE IndexSet::*const maps[] = {
+      &IndexSet::function_basenames,
+      &IndexSet::function_fullnames,
+      &IndexSet::function_methods,
+      &IndexSet::function_selectors,
+      &IndexSet::objc_class_selectors,
+      &IndexSet::globals,
+      &IndexSet::types,
+      &IndexSet::namespaces,
+  };
+  return maps;
+}
+
+FileSpec ManualDWARFIndex::GetCacheFile() const {
+  // Without a UUID there is no telling apart two modules with the same path.
+  // A cache built with some units left out is only good for the same set of
+  // units, which comes from another index that is not part of the
+  // signature.
+  if (!m_cache_directory || !m_units_to_avoid.empty())
+    return FileSpec();
+  const UUID &uuid = m_module.GetUUID();
+  if (!uuid.IsValid())
+    return FileSpec();
+  FileSpec cache_file = m_cache_directory;
+  cache_file.AppendPathComponent(uuid.GetAsString() + ".dwarf-index");
+  return cache_file;
+}
+
+std::string ManualDWARFIndex::GetCacheSignature(SymbolFileDWARF &dwarf) const {
+  auto to_ns = [](const llvm::sys::TimePoint<> &time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               time.time_since_epoch())
+        .count();
+  };
+  // The DWARF can live in a different file than the module, e.g. a dSYM or a
+  // separate debug file, so it needs its own modification time.
+  const llvm::sys::TimePoint<> dwarf_time =
+      FileSystem::Instance().GetModificationTime(
+          dwarf.GetObjectFile()->GetFileSpec());
+  std::string signature;
+  llvm::raw_string_ostream os(signature);
+  os << m_module.GetUUID().GetAsString() << ' '
+     << to_ns(m_module.GetModificationTime()) << ' '
+     << to_ns(m_module.GetObjectModificationTime()) << ' '
+     << to_ns(dwarf_time);
+  return os.str();
+}
+
+bool ManualDWARFIndex::LoadFromCache(SymbolFileDWARF &dwarf) {
+  FileSpec cache_file = GetCacheFile();
+  if (!cache_file)
+    return false;
+
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  // Large files are mapped in instead of read.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer_or =
+      llvm::MemoryBuffer::getFile(cache_file.GetPath(), /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!buffer_or)
+    return false;
+  llvm::MemoryBuffer &buffer = **buffer_or;
+  DataExtractor data(buffer.getBufferStart(), buffer.getBufferSize(),
+                     eByteOrderLittle, 8);
+  lldb::offset_t offset = 0;
+
+  auto reject = [&](const char *reason) {
+    LLDB_LOG(log, "ignoring DWARF index cache {0}: {1}", cache_file, reason);
+    m_set = IndexSet();
+    return false;
+  };
+
+  if (!data.ValidOffsetForDataOfSize(offset, 8) ||
+      data.GetU32(&offset) != g_cache_magic ||
+      data.GetU32(&offset) != g_cache_version)
+    return reject("unknown format");
+  const char *signature = data.GetCStr(&offset);
+  if (!signature || GetCacheSignature(dwarf) != signature)
+    return reject("built from different files");
+
+  if (!data.ValidOffsetForDataOfSize(offset, 4))
+    return reject("truncated");
+  const uint32_t num_strings = data.GetU32(&offset);
+  // Every string takes at least its terminator.
+  if (!data.ValidOffsetForDataOfSize(offset, num_strings))
+    return reject("truncated");
+  std::vector<ConstString> strings;
+  strings.reserve(num_strings);
+  for (uint32_t i = 0; i < num_strings; ++i) {
+    const char *str = data.GetCStr(&offset);
+    if (!str)
+      return reject("truncated");
+    strings.push_back(ConstString(str));
+  }
+
+  for (NameToDIE IndexSet::*map : GetCachedMaps()) {
+    if (!(m_set.*map).Decode(data, &offset, strings))
+      return reject("truncated");
+  }
+  if (offset != data.GetByteSize())
+    return reject("trailing data");
+
+  for (NameToDIE IndexSet::*map : GetCachedMaps())
+    (m_set.*map).Finalize();
+  LLDB_LOG(log, "loaded DWARF index for {0} from {1}",
+           m_module.GetFileSpec(), cache_file);
+  return true;
+}
+
+void ManualDWARFIndex::SaveToCache(SymbolFileDWARF &dwarf,
+                                   llvm::ArrayRef<DWARFUnit *> indexed_units,
+                                   SymbolFileDWARFDwo *dwp) {
+  FileSpec cache_file = GetCacheFile();
+  if (!cache_file)
+    return;
+
+  // The signature does not cover split DWARF, which can change on its own.
+  if (dwp)
+    return;
+  for (DWARFUnit *unit : indexed_units) {
+    if (unit->GetDwoSymbolFile())
+      return;
+  }
+
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  std::error_code ec =
+      llvm::sys::fs::create_directories(m_cache_directory.GetPath());
+  if (ec) {
+    LLDB_LOG(log, "cannot create DWARF index cache directory {0}: {1}",
+             m_cache_directory, ec.message());
+    return;
+  }
+
+  // Write to a temporary file and rename it into place, so that a concurrent
+  // reader never sees half a file.
+  llvm::SmallString<128> temp_path;
+  int fd;
+  ec = llvm::sys::fs::createUniqueFile(
+      cache_file.GetPath() + "-%%%%%%%%.tmp", fd, temp_path);
+  if (ec) {
+    LLDB_LOG(log, "cannot create DWARF index cache file in {0}: {1}",
+             m_cache_directory, ec.message());
+    return;
+  }
+
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    llvm::support::endian::Writer writer(os, llvm::support::little);
+    writer.write<uint32_t>(g_cache_magic);
+    writer.write<uint32_t>(g_cache_version);
+    os << GetCacheSignature(dwarf) << '\0';
+
+    llvm::DenseMap<const char *, uint32_t> string_indexes;
+    std::vector<ConstString> strings;
+    for (NameToDIE IndexSet::*map : GetCachedMaps()) {
+      (m_set.*map).ForEach([&](ConstString name, const DIERef &) {
+        if (string_indexes.try_emplace(name.GetCString(), strings.size())
+                .second)
+          strings.push_back(name);
+        return true;
+      });
+    }
+    writer.write<uint32_t>(strings.size());
+    for (ConstString str : strings)
+      os << str.GetStringRef() << '\0';
+
+    auto string_index = [&](ConstString name) {
+      return string_indexes.lookup(name.GetCString());
+    };
+    for (NameToDIE IndexSet::*map : GetCachedMaps())
+      (m_set.*map).Encode(writer, string_index);
+
+    os.close();
+    if (os.has_error()) {
+      LLDB_LOG(log, "cannot write DWARF index cache file {0}: {1}", temp_path,
+               os.error().message());
+      os.clear_error();
+      llvm::sys::fs::remove(temp_path);
+      return;
+    }
+  }
+
+  ec = llvm::sys::fs::rename(temp_path, cache_file.GetPath());
+  if (ec) {
+    LLDB_LOG(log, "cannot rename DWARF index cache file {0}: {1}", temp_path,
+             ec.message());
+    llvm::sys::fs::remove(temp_path);
+  }
 }
 
 void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, SymbolFileDWARFDwo *dwp,
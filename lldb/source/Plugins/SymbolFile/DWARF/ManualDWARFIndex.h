@@ -11,6 +11,7 @@
 
 #include "Plugins/SymbolFile/DWARF/DWARFIndex.h"
 #include "Plugins/SymbolFile/DWARF/NameToDIE.h"
+#include "lldb/Utility/FileSpec.h"
 #include "llvm/ADT/DenseSet.h"
 
 class DWARFDebugInfo;
@@ -19,10 +20,16 @@ class SymbolFileDWARFDwo;
 namespace lldb_private {
 class ManualDWARFIndex : public DWARFIndex {
 public:
+  /// \param[in] cache_directory
+  ///     If set, the index is saved to a file in this directory once it is
+  ///     built, and loaded from there instead of being built again the next
+  ///     time the same module is indexed.
   ManualDWARFIndex(Module &module, SymbolFileDWARF &dwarf,
-                   llvm::DenseSet<dw_offset_t> units_to_avoid = {})
+                   llvm::DenseSet<dw_offset_t> units_to_avoid = {},
+                   FileSpec cache_directory = {})
       : DWARFIndex(module), m_dwarf(&dwarf),
-        m_units_to_avoid(std::move(units_to_avoid)) {}
+        m_units_to_avoid(std::move(units_to_avoid)),
+        m_cache_directory(std::move(cache_directory)) {}
 
   void Preload() override { Index(); }
 
@@ -59,6 +66,19 @@ private:
   void Index();
   void IndexUnit(DWARFUnit &unit, SymbolFileDWARFDwo *dwp, IndexSet &set);
 
+  /// The maps of an IndexSet, in the order they are stored in the cache.
+  static llvm::ArrayRef<NameToDIE IndexSet::*> GetCachedMaps();
+  /// The file m_set is cached in, or an empty FileSpec if this index should
+  /// not be cached.
+  FileSpec GetCacheFile() const;
+  /// Identifies the exact files the index was built from, to catch a cache
+  /// file that has gone stale.
+  std::string GetCacheSignature(SymbolFileDWARF &dwarf) const;
+  bool LoadFromCache(SymbolFileDWARF &dwarf);
+  void SaveToCache(SymbolFileDWARF &dwarf,
+                   llvm::ArrayRef<DWARFUnit *> indexed_units,
+                   SymbolFileDWARFDwo *dwp);
+
   static void IndexUnitImpl(DWARFUnit &unit,
                             const lldb::LanguageType cu_language,
                             IndexSet &set);
@@ -68,6 +88,8 @@ private:
   SymbolFileDWARF *m_dwarf;
   /// Which dwarf units should we skip while building the index.
   llvm::DenseSet<dw_offset_t> m_units_to_avoid;
+  /// Where the index is cached, empty if caching is disabled.
+  FileSpec m_cache_directory;
 
   IndexSet m_set;
 };
@@ -10,6 +10,7 @@
 #include "DWARFUnit.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
@@ -76,3 +77,33 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+void NameToDIE::Encode(
+    llvm::support::endian::Writer &writer,
+    llvm::function_ref<uint32_t(ConstString)> string_index) const {
+  const uint32_t size = m_map.GetSize();
+  writer.write<uint32_t>(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    writer.write<uint32_t>(string_index(m_map.GetCStringAtIndexUnchecked(i)));
+    m_map.GetValueAtIndexUnchecked(i).Encode(writer);
+  }
+}
+
+bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                       llvm::ArrayRef<ConstString> strings) {
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 4))
+    return false;
+  const uint32_t size = data.GetU32(offset_ptr);
+  // Each entry takes 12 bytes, don't trust a count that cannot fit.
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, uint64_t(size) * 12))
+    return false;
+  m_map.Reserve(m_map.GetSize() + size);
+  for (uint32_t i = 0; i < size; ++i) {
+    const uint32_t str_idx = data.GetU32(offset_ptr);
+    llvm::Optional<DIERef> die_ref = DIERef::Decode(data, offset_ptr);
+    if (str_idx >= strings.size() || !die_ref)
+      return false;
+    m_map.Append(strings[str_idx], *die_ref);
+  }
+  return true;
+}
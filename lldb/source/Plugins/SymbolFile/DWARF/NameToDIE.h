@@ -15,6 +15,8 @@
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Core/dwarf.h"
 #include "lldb/lldb-defines.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 
 class DWARFUnit;
 
@@ -46,6 +48,23 @@ public:
                              const DIERef &die_ref)> const
               &callback) const;
 
+  /// Write the entries to \a writer, with each name stored as the index that
+  /// \a string_index gives it in a string table saved separately.
+  void Encode(llvm::support::endian::Writer &writer,
+              llvm::function_ref<uint32_t(lldb_private::ConstString)>
+                  string_index) const;
+
+  /// Append the entries written by Encode at \a *offset_ptr, looking the names
+  /// up in \a strings, and advance the offset past them. The map needs to be
+  /// finalized again afterwards.
+  ///
+  /// \return
+  ///     False if the data is truncated or refers to a string that does not
+  ///     exist, in which case the map may have been partially filled.
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr,
+              llvm::ArrayRef<lldb_private::ConstString> strings);
+
 protected:
   lldb_private::UniqueCStringMap<DIERef> m_map;
 };
@@ -31,6 +31,7 @@
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/Host.h"
 
+#include "lldb/Interpreter/OptionValueFileSpec.h"
 #include "lldb/Interpreter/OptionValueFileSpecList.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
 
@@ -73,6 +74,7 @@
 
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 
 #include <algorithm>
 #include <map>
@@ -140,6 +142,26 @@ public:
     return m_collection_sp->GetPropertyAtIndexAsBoolean(
         nullptr, ePropertyIgnoreIndexes, false);
   }
+
+  /// The directory to cache manual DWARF indexes in, or an empty FileSpec if
+  /// they should not be cached.
+  FileSpec GetIndexCacheDirectory() const {
+    if (!m_collection_sp->GetPropertyAtIndexAsBoolean(
+            nullptr, ePropertyIndexCache, false))
+      return FileSpec();
+    FileSpec directory =
+        m_collection_sp
+            ->GetPropertyAtIndexAsOptionValueFileSpec(nullptr, false,
+                                                      ePropertyIndexCachePath)
+            ->GetCurrentValue();
+    if (directory)
+      return directory;
+    llvm::SmallString<128> path;
+    if (!llvm::sys::path::home_directory(path))
+      return FileSpec();
+    llvm::sys::path::append(path, ".lldb", "index-cache");
+    return FileSpec(path);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -468,8 +490,9 @@ void SymbolFileDWARF::InitializeObject() {
     }
   }
 
-  m_index =
-      std::make_unique<ManualDWARFIndex>(*GetObjectFile()->GetModule(), *this);
+  m_index = std::make_unique<ManualDWARFIndex>(
+      *GetObjectFile()->GetModule(), *this, llvm::DenseSet<dw_offset_t>(),
+      GetGlobalPluginProperties()->GetIndexCacheDirectory());
 }
 
 bool SymbolFileDWARF::SupportedVersion(uint16_t version) {
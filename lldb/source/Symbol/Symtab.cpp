@@ -14,6 +14,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RichManglingContext.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
@@ -263,9 +264,19 @@ void Symtab::InitNameIndexes() {
     std::vector<std::pair<NameToIndexMap::Entry, const char *>> backlog;
     backlog.reserve(num_symbols / 2);
 
-    // Instantiation of the demangler is expensive, so better use a single one
-    // for all entries during batch processing.
-    RichManglingContext rmc;
+    // Demangling is by far the most expensive part, so do it for all symbols
+    // in parallel first. Building the maps below depends on the order of the
+    // symbols and stays serial, but it only needs the cached results.
+    std::vector<FunctionNameParts> function_name_parts(num_symbols);
+    const uint32_t batch_size = 4096;
+    const uint32_t num_batches = (num_symbols + batch_size - 1) / batch_size;
+    TaskMapOverInt(0, num_batches, [&](size_t batch) {
+      const uint32_t begin = batch * batch_size;
+      DemangleSymbolNames(begin, std::min<uint32_t>(begin + batch_size,
+                                                    num_symbols),
+                          function_name_parts);
+    });
+
     for (uint32_t value = 0; value < num_symbols; ++value) {
       Symbol *symbol = &m_symbols[value];
 
@@ -290,11 +301,9 @@ void Symtab::InitNameIndexes() {
           m_name_to_index.Append(stripped, value);
         }
 
-        const SymbolType type = symbol->GetType();
-        if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
-          if (mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name))
-            RegisterMangledNameEntry(value, class_contexts, backlog, rmc);
-        }
+        if (function_name_parts[value].base_name)
+          RegisterMangledNameEntry(value, function_name_parts[value],
+                                   class_contexts, backlog);
       }
 
       // Symbol name strings that didn't match a Mangled::ManglingScheme, are
@@ -338,24 +347,53 @@ void Symtab::InitNameIndexes() {
   }
 }
 
-void Symtab::RegisterMangledNameEntry(
-    uint32_t value, std::set<const char *> &class_contexts,
-    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-    RichManglingContext &rmc) {
-  // Only register functions that have a base name.
-  rmc.ParseFunctionBaseName();
-  llvm::StringRef base_name = rmc.GetBufferRef();
-  if (base_name.empty())
-    return;
+void Symtab::DemangleSymbolNames(uint32_t begin, uint32_t end,
+                                 std::vector<FunctionNameParts> &parts) {
+  // Instantiation of the demangler is expensive, so better use a single one
+  // for all entries of the batch.
+  RichManglingContext rmc;
+  for (uint32_t value = begin; value < end; ++value) {
+    Symbol &symbol = m_symbols[value];
+    if (symbol.IsTrampoline())
+      continue;
+
+    Mangled &mangled = symbol.GetMangled();
+    if (!mangled.GetMangledName())
+      continue;
+
+    const SymbolType type = symbol.GetType();
+    if (type != eSymbolTypeCode && type != eSymbolTypeResolver) {
+      // Not a function, but InitNameIndexes still wants the demangled name.
+      mangled.GetDemangledName();
+      continue;
+    }
 
-  // The base name will be our entry's name.
-  NameToIndexMap::Entry entry(ConstString(base_name), value);
+    if (!mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name))
+      continue;
 
-  rmc.ParseFunctionDeclContextName();
-  llvm::StringRef decl_context = rmc.GetBufferRef();
+    // Only register functions that have a base name.
+    rmc.ParseFunctionBaseName();
+    llvm::StringRef base_name = rmc.GetBufferRef();
+    if (base_name.empty())
+      continue;
+
+    FunctionNameParts &result = parts[value];
+    result.base_name = ConstString(base_name);
+    rmc.ParseFunctionDeclContextName();
+    result.decl_context = ConstString(rmc.GetBufferRef());
+    result.is_ctor_or_dtor = rmc.IsCtorOrDtor();
+  }
+}
+
+void Symtab::RegisterMangledNameEntry(
+    uint32_t value, const FunctionNameParts &parts,
+    std::set<const char *> &class_contexts,
+    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog) {
+  // The base name will be our entry's name.
+  NameToIndexMap::Entry entry(parts.base_name, value);
 
   // Register functions with no context.
-  if (decl_context.empty()) {
+  if (!parts.decl_context) {
     // This has to be a basename
     m_basename_to_index.Append(entry);
     // If there is no context (no namespaces or class scopes that come before
@@ -364,14 +402,13 @@ void Symtab::RegisterMangledNameEntry(
     return;
   }
 
-  // Make sure we have a pool-string pointer and see if we already know the
-  // context name.
-  const char *decl_context_ccstr = ConstString(decl_context).GetCString();
+  // See if we already know the context name.
+  const char *decl_context_ccstr = parts.decl_context.GetCString();
   auto it = class_contexts.find(decl_context_ccstr);
 
   // Register constructors and destructors. They are methods and create
   // declaration contexts.
-  if (rmc.IsCtorOrDtor()) {
+  if (parts.is_ctor_or_dtor) {
     m_method_to_index.Append(entry);
     if (it == class_contexts.end())
       class_contexts.insert(it, decl_context_ccstr);
@@ -168,6 +168,7 @@ void Target::CleanupProcess() {
   // Do any cleanup of the target we need to do between process instances.
   // NB It is better to do this before destroying the process in case the
   // clean up needs some help from the process.
+  ClearUserExpressionCache();
   m_breakpoint_list.ClearAllBreakpointSites();
   m_internal_breakpoint_list.ClearAllBreakpointSites();
   // Disable watchpoints just on the debugger side.
@@ -1379,6 +1380,7 @@ void Target::ClearModules(bool delete_locations) {
   ModulesDidUnload(m_images, delete_locations);
   m_section_load_history.Clear();
   m_images.Clear();
+  ClearUserExpressionCache();
   m_scratch_type_system_map.Clear();
 }
 
@@ -1386,6 +1388,7 @@ void Target::DidExec() {
   // When a process exec's we need to know about it so we can do some cleanup.
   m_breakpoint_list.RemoveInvalidLocations(m_arch.GetSpec());
   m_internal_breakpoint_list.RemoveInvalidLocations(m_arch.GetSpec());
+  ClearUserExpressionCache();
 }
 
 void Target::SetExecutableModule(ModuleSP &executable_sp,
@@ -1609,6 +1612,8 @@ void Target::NotifyModulesRemoved(lldb_private::ModuleList &module_list) {
 void Target::ModulesDidLoad(ModuleList &module_list) {
   const size_t num_images = module_list.GetSize();
   if (m_valid && num_images) {
+    // New code may change what the names in an expression refer to.
+    ClearUserExpressionCache();
     for (size_t idx = 0; idx < num_images; ++idx) {
       ModuleSP module_sp(module_list.GetModuleAtIndex(idx));
       LoadScriptingResourceForModule(module_sp, this);
@@ -1640,6 +1645,7 @@ void Target::SymbolsDidLoad(ModuleList &module_list) {
 
 void Target::ModulesDidUnload(ModuleList &module_list, bool delete_locations) {
   if (m_valid && module_list.GetSize()) {
+    ClearUserExpressionCache();
     UnloadModuleSections(module_list);
     m_breakpoint_list.UpdateBreakpoints(module_list, false, delete_locations);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, false,
@@ -2213,6 +2219,46 @@ UserExpression *Target::GetUserExpressionForLanguage(
   return user_expr;
 }
 
+lldb::UserExpressionSP
+Target::TakeCachedUserExpression(llvm::StringRef key,
+                                 ExecutionContext &exe_ctx) {
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  for (auto pos = m_user_expression_cache.begin(),
+            end = m_user_expression_cache.end();
+       pos != end; ++pos) {
+    if (pos->first != key)
+      continue;
+    lldb::UserExpressionSP expr_sp = std::move(pos->second);
+    m_user_expression_cache.erase(pos);
+    if (!expr_sp->MatchesContext(exe_ctx))
+      return lldb::UserExpressionSP();
+    return expr_sp;
+  }
+  return lldb::UserExpressionSP();
+}
+
+void Target::CacheUserExpression(llvm::StringRef key,
+                                 lldb::UserExpressionSP expr_sp) {
+  // Formatters and scripts tend to evaluate a handful of expressions over and
+  // over, so a short list is enough and cheap to search.
+  const size_t max_cached_expressions = 64;
+
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  m_user_expression_cache.emplace_front(std::string(key), std::move(expr_sp));
+  if (m_user_expression_cache.size() > max_cached_expressions)
+    m_user_expression_cache.pop_back();
+}
+
+void Target::ClearUserExpressionCache() {
+  // Destroy the expressions outside of the lock, they may call back into the
+  // target.
+  UserExpressionCache cache;
+  {
+    std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+    cache.swap(m_user_expression_cache);
+  }
+}
+
 FunctionCaller *Target::GetFunctionCallerForLanguage(
     lldb::LanguageType language, const CompilerType &return_type,
     const Address &function_address, const ValueList &arg_value_list,
@@ -3746,6 +3792,12 @@ bool TargetProperties::GetEnableNotifyAboutFixIts() const {
       nullptr, idx, g_target_properties[idx].default_uint_value != 0);
 }
 
+bool TargetProperties::GetEnableExpressionCache() const {
+  const uint32_t idx = ePropertyExpressionCache;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_target_properties[idx].default_uint_value != 0);
+}
+
 bool TargetProperties::GetEnableSaveObjects() const {
   const uint32_t idx = ePropertySaveObjects;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
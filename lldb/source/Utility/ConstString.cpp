@@ -13,7 +13,6 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/iterator.h"
 #include "llvm/Support/Allocator.h"
-#include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatProviders.h"
 #include "llvm/Support/RWMutex.h"
 #include "llvm/Support/Threading.h"
@@ -100,11 +99,13 @@ public:
 
   const char *GetConstCStringWithStringRef(const llvm::StringRef &string_ref) {
     if (string_ref.data()) {
-      const uint8_t h = hash(string_ref);
+      // Hash the string once for picking the pool and for both lookups in it.
+      const uint32_t string_hash = StringPool::hash(string_ref);
+      const uint8_t h = hash(string_hash);
 
       {
         llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-        auto it = m_string_pools[h].m_string_map.find(string_ref);
+        auto it = m_string_pools[h].m_string_map.find(string_ref, string_hash);
         if (it != m_string_pools[h].m_string_map.end())
           return it->getKeyData();
       }
@@ -112,7 +113,7 @@ public:
       llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
       StringPoolEntryType &entry =
           *m_string_pools[h]
-               .m_string_map.insert(std::make_pair(string_ref, nullptr))
+               .m_string_map.try_emplace_with_hash(string_ref, string_hash)
                .first;
       return entry.getKeyData();
     }
@@ -125,12 +126,14 @@ public:
     const char *demangled_ccstr = nullptr;
 
     {
-      const uint8_t h = hash(demangled);
+      const uint32_t demangled_hash = StringPool::hash(demangled);
+      const uint8_t h = hash(demangled_hash);
       llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
 
       // Make or update string pool entry with the mangled counterpart
       StringPool &map = m_string_pools[h].m_string_map;
-      StringPoolEntryType &entry = *map.try_emplace(demangled).first;
+      StringPoolEntryType &entry =
+          *map.try_emplace_with_hash(demangled, demangled_hash).first;
 
       entry.second = mangled_ccstr;
 
@@ -173,7 +176,11 @@ public:
 
 protected:
   uint8_t hash(const llvm::StringRef &s) const {
-    uint32_t h = llvm::djbHash(s);
+    return hash(StringPool::hash(s));
+  }
+
+  /// Pick the pool from the hash value that the StringMap of the pool uses.
+  uint8_t hash(uint32_t h) const {
     return ((h >> 24) ^ (h >> 16) ^ (h >> 8) ^ h) & 0xff;
   }
 
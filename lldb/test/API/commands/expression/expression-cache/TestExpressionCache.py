@@ -0,0 +1,43 @@
+"""
+Test that an expression evaluated again in a different frame or block is not
+answered by the parse cached for another context.
+"""
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class ExpressionCacheTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def test_recursive_frames(self):
+        """The same expression gets each frame's own variables."""
+        self.build()
+        lldbutil.run_to_source_breakpoint(self, "// break in recurse",
+                                          lldb.SBFileSpec("main.cpp"))
+        thread = self.dbg.GetSelectedTarget().GetProcess().GetSelectedThread()
+        # Every recursive frame stopped in the same function; evaluate the
+        # same text in each of them, twice, so that the second round could
+        # be answered from the cache.
+        for _ in range(2):
+            for depth in range(3):
+                frame = thread.GetFrameAtIndex(depth)
+                self.assertIn("recurse", frame.GetFunctionName())
+                value = frame.EvaluateExpression("local")
+                self.assertTrue(value.GetError().Success())
+                self.assertEqual(value.GetValueAsSigned(), depth * 10)
+
+    def test_nested_blocks(self):
+        """A variable shadowed in an inner block resolves per block."""
+        self.build()
+        target, process, _, _ = lldbutil.run_to_source_breakpoint(
+            self, "// break in inner block", lldb.SBFileSpec("main.cpp"))
+        self.expect_expr("value", result_type="int", result_value="101")
+
+        bkpt = target.BreakpointCreateBySourceRegex("// break in outer block",
+                                                    lldb.SBFileSpec("main.cpp"))
+        lldbutil.continue_to_breakpoint(process, bkpt)
+        self.expect_expr("value", result_type="int", result_value="1")
@@ -0,0 +1,21 @@
+int recurse(int n) {
+  int local = n * 10;
+  if (n == 0)
+    return local; // break in recurse
+  return recurse(n - 1) + local;
+}
+
+int shadow(int x) {
+  int value = x;
+  {
+    int value = x + 100;
+    x += value; // break in inner block
+  }
+  return x + value; // break in outer block
+}
+
+int main() {
+  int result = recurse(2);
+  result += shadow(1);
+  return result;
+}
@@ -0,0 +1,36 @@
+"""
+Test that completing a class does not complete the types of its static data
+members, and that they are still completed once something uses them.
+"""
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class StaticMemberTypeCompletionTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def dump_ast(self):
+        self.runCmd("target modules dump ast")
+        return self.res.GetOutput()
+
+    def test(self):
+        self.build()
+        lldbutil.run_to_source_breakpoint(self, "// break here",
+                                          lldb.SBFileSpec("main.cpp"))
+
+        # Printing outer completes Outer, but not the type of its static
+        # member.
+        self.expect("frame variable outer", substrs=["field = 1"])
+        ast = self.dump_ast()
+        self.assertIn("static_member", ast)
+        self.assertIn("OnlyUsedByStatic", ast)
+        self.assertNotIn("member_of_static_type", ast)
+
+        # Using the static member completes its type.
+        self.expect("expression Outer::static_member.member_of_static_type",
+                    substrs=["42"])
+        self.assertIn("member_of_static_type", self.dump_ast())
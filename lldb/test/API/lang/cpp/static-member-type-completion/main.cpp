@@ -0,0 +1,17 @@
+// This type is only referenced by a static data member of Outer, so nothing
+// that only looks at Outer needs its definition.
+struct OnlyUsedByStatic {
+  int member_of_static_type = 42;
+};
+
+struct Outer {
+  static OnlyUsedByStatic static_member;
+  int field = 1;
+};
+
+OnlyUsedByStatic Outer::static_member;
+
+int main() {
+  Outer outer;
+  return outer.field - 1; // break here
+}
@@ -0,0 +1,78 @@
+# This test makes sure that lldb-server sends the frame records on the frame
+# pointer chain of a stopped thread along with the stop reply.
+
+import re
+
+import gdbremote_testcase
+import lldbgdbserverutils
+from lldbsuite.support import seven
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemoteExpeditedMemory(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def read_memory(self, address, size):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $m{0:x},{1:x}#00".format(address, size),
+             {"direction": "send", "regex": r"^\$(.+)#[0-9a-fA-F]{2}$",
+              "capture": {1: "read_contents"}}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context.get("read_contents")
+
+    @llgs_test
+    @skipUnlessPlatform(["linux", "android"])
+    @skipIf(archs=no_match(["i386", "x86_64", "aarch64"]))
+    def test_stop_reply_contains_frame_records(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        procs = self.prep_debug_monitor_and_inferior()
+        self.test_sequence.add_log_lines([
+            "read packet: $c#63",
+            {"direction": "send",
+             "regex": r"^\$T([0-9a-fA-F]{2})([^#]+)#[0-9a-fA-F]{2}$",
+             "capture": {1: "stop_signo", 2: "key_vals_text"}},
+        ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        key_vals_text = context.get("key_vals_text")
+
+        records = [(int(address, 16), contents) for (address, contents) in
+                   re.findall(r"memory:0x([0-9a-fA-F]+)=([0-9a-fA-F]+);",
+                              key_vals_text)]
+        # The four frames of recurse() and main() all have frame records.
+        self.assertTrue(len(records) >= 5, key_vals_text)
+
+        # The chain starts at the frame pointer of the stopped thread.
+        expedited_registers = self.extract_registers_from_stop_notification(
+            key_vals_text)
+        reg_infos = self.gather_register_infos()
+        fp_info = self.find_generic_register_with_name(reg_infos, "fp")
+        self.assertIsNotNone(fp_info)
+        endian = self.get_target_byte_order()
+        fp = lldbgdbserverutils.unpack_register_hex_unsigned(
+            endian, expedited_registers[fp_info["lldb_register_index"]])
+        self.assertEqual(records[0][0], fp)
+
+        # Each record holds the saved frame pointer, which is the address of
+        # the next record, and the return address.
+        ptr_size = len(records[0][1]) // 4
+        for (address, contents), (next_address, _) in zip(records,
+                                                          records[1:]):
+            self.assertEqual(len(contents), 4 * ptr_size)
+            saved_fp = lldbgdbserverutils.unpack_register_hex_unsigned(
+                endian, contents[:2 * ptr_size])
+            self.assertEqual(saved_fp, next_address)
+            self.assertTrue(next_address > address)
+
+        # The records are the real contents of the stack.
+        for address, contents in records:
+            self.assertEqual(
+                seven.unhexlify(self.read_memory(address, len(contents) // 2)),
+                seven.unhexlify(contents))
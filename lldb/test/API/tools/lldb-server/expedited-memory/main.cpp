@@ -0,0 +1,8 @@
+// Stops a few frames deep, in code built with frame pointers.
+__attribute__((noinline)) int recurse(int depth) {
+  if (depth == 0)
+    __builtin_trap();
+  return recurse(depth - 1) + 1;
+}
+
+int main() { return recurse(4); }
@@ -0,0 +1,102 @@
+//===-- NameToDIETests.cpp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/SymbolFile/DWARF/NameToDIE.h"
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+struct EncodedNameToDIE {
+  std::string bytes;
+  std::vector<ConstString> strings;
+};
+} // namespace
+
+static EncodedNameToDIE Encode(const NameToDIE &map) {
+  EncodedNameToDIE result;
+  llvm::DenseMap<const char *, uint32_t> indexes;
+  llvm::raw_string_ostream os(result.bytes);
+  llvm::support::endian::Writer writer(os, llvm::support::little);
+  map.Encode(writer, [&](ConstString name) {
+    auto insertion = indexes.try_emplace(name.GetCString(),
+                                         result.strings.size());
+    if (insertion.second)
+      result.strings.push_back(name);
+    return insertion.first->second;
+  });
+  os.flush();
+  return result;
+}
+
+TEST(NameToDIETest, EncodeDecode) {
+  const DIERef foo_ref(llvm::None, DIERef::DebugInfo, 0x10);
+  const DIERef dwo_ref(7, DIERef::DebugInfo, 0x12345678);
+  const DIERef type_ref(llvm::None, DIERef::DebugTypes, 0x20);
+  NameToDIE map;
+  map.Insert(ConstString("foo"), foo_ref);
+  map.Insert(ConstString("bar"), dwo_ref);
+  map.Insert(ConstString("foo"), type_ref);
+  map.Finalize();
+
+  EncodedNameToDIE encoded = Encode(map);
+  EXPECT_EQ(2u, encoded.strings.size());
+
+  DataExtractor data(encoded.bytes.data(), encoded.bytes.size(),
+                     eByteOrderLittle, 8);
+  lldb::offset_t offset = 0;
+  NameToDIE decoded;
+  ASSERT_TRUE(decoded.Decode(data, &offset, encoded.strings));
+  EXPECT_EQ(encoded.bytes.size(), offset);
+  decoded.Finalize();
+
+  DIEArray foo;
+  decoded.Find(ConstString("foo"), foo);
+  ASSERT_EQ(2u, foo.size());
+  llvm::sort(foo);
+  EXPECT_EQ(llvm::None, foo[0].dwo_num());
+  EXPECT_EQ(DIERef::DebugInfo, foo[0].section());
+  EXPECT_EQ(0x10u, foo[0].die_offset());
+  EXPECT_EQ(DIERef::DebugTypes, foo[1].section());
+  EXPECT_EQ(0x20u, foo[1].die_offset());
+
+  DIEArray bar;
+  decoded.Find(ConstString("bar"), bar);
+  ASSERT_EQ(1u, bar.size());
+  EXPECT_EQ(llvm::Optional<uint32_t>(7), bar[0].dwo_num());
+  EXPECT_EQ(0x12345678u, bar[0].die_offset());
+}
+
+TEST(NameToDIETest, DecodeTruncated) {
+  NameToDIE map;
+  map.Insert(ConstString("foo"), DIERef(llvm::None, DIERef::DebugInfo, 1));
+  map.Insert(ConstString("bar"), DIERef(llvm::None, DIERef::DebugInfo, 2));
+  map.Finalize();
+  EncodedNameToDIE encoded = Encode(map);
+
+  for (size_t size = 0; size < encoded.bytes.size(); ++size) {
+    DataExtractor data(encoded.bytes.data(), size, eByteOrderLittle, 8);
+    lldb::offset_t offset = 0;
+    NameToDIE decoded;
+    EXPECT_FALSE(decoded.Decode(data, &offset, encoded.strings)) << size;
+  }
+
+  // A string index past the end of the string table.
+  DataExtractor data(encoded.bytes.data(), encoded.bytes.size(),
+                     eByteOrderLittle, 8);
+  lldb::offset_t offset = 0;
+  NameToDIE decoded;
+  EXPECT_FALSE(decoded.Decode(data, &offset,
+                              llvm::makeArrayRef(encoded.strings).take_front()));
+}
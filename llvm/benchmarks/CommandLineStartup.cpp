@@ -0,0 +1,72 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// A tool built on libLLVM constructs thousands of global cl::opts before main
+// runs, and registers them with the command line parser. These benchmarks
+// construct that many options the way static initialization does, and measure
+// the time until main would be entered and until the command line has been
+// parsed and the first output can be written.
+
+static const std::vector<std::string> &getOptionNames(size_t N) {
+  static std::vector<std::string> Names;
+  for (size_t I = Names.size(); I < N; ++I)
+    Names.push_back("startup-bench-option-" + std::to_string(I));
+  return Names;
+}
+
+static std::vector<std::unique_ptr<cl::opt<unsigned>>>
+constructOptions(size_t N) {
+  const std::vector<std::string> &Names = getOptionNames(N);
+  std::vector<std::unique_ptr<cl::opt<unsigned>>> Options;
+  Options.reserve(N);
+  for (size_t I = 0; I != N; ++I)
+    Options.push_back(std::make_unique<cl::opt<unsigned>>(
+        StringRef(Names[I]), cl::desc("Benchmark option"), cl::init(0),
+        cl::Hidden));
+  return Options;
+}
+
+static void destroyOptions(
+    std::vector<std::unique_ptr<cl::opt<unsigned>>> &Options) {
+  // Forget about the options before they go away.
+  cl::ResetCommandLineParser();
+  Options.clear();
+}
+
+static void BM_TimeToMain(benchmark::State &State) {
+  for (auto _ : State) {
+    auto Options = constructOptions(State.range(0));
+    benchmark::DoNotOptimize(Options.data());
+    State.PauseTiming();
+    destroyOptions(Options);
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+static void BM_TimeToFirstOutput(benchmark::State &State) {
+  const std::string LastName = getOptionNames(State.range(0)).back();
+  const std::string Arg = "-" + LastName + "=1";
+  const char *Argv[] = {"startup-bench", Arg.c_str()};
+  for (auto _ : State) {
+    auto Options = constructOptions(State.range(0));
+    cl::ParseCommandLineOptions(array_lengthof(Argv), Argv);
+    nulls() << Options.back()->getValue() << '\n';
+    State.PauseTiming();
+    destroyOptions(Options);
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+BENCHMARK(BM_TimeToMain)->Range(64, 1 << 14);
+BENCHMARK(BM_TimeToFirstOutput)->Range(64, 1 << 14);
+
+BENCHMARK_MAIN();
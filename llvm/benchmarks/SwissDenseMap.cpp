@@ -0,0 +1,122 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SwissDenseMap.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace llvm;
+
+// Integer keys are random, pointer keys point into one array like the
+// addresses of objects allocated together would.
+template <typename KeyT> static std::vector<KeyT> getKeys(size_t N);
+
+template <> std::vector<uint64_t> getKeys<uint64_t>(size_t N) {
+  std::mt19937_64 Rng(42);
+  std::vector<uint64_t> Keys(N);
+  for (uint64_t &Key : Keys)
+    // Stay clear of the DenseMapInfo empty and tombstone keys.
+    Key = Rng() >> 2;
+  return Keys;
+}
+
+template <> std::vector<int *> getKeys<int *>(size_t N) {
+  static std::unique_ptr<int[]> Storage;
+  static size_t StorageSize = 0;
+  if (StorageSize < N) {
+    Storage.reset(new int[N]);
+    StorageSize = N;
+  }
+  std::vector<int *> Keys(N);
+  for (size_t I = 0; I != N; ++I)
+    Keys[I] = &Storage[I];
+  std::shuffle(Keys.begin(), Keys.end(), std::mt19937(42));
+  return Keys;
+}
+
+template <typename MapT> static void BM_Insert(benchmark::State &State) {
+  using KeyT = typename MapT::key_type;
+  auto Keys = getKeys<KeyT>(State.range(0));
+  for (auto _ : State) {
+    MapT Map;
+    for (KeyT Key : Keys)
+      benchmark::DoNotOptimize(&Map[Key]);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+template <typename MapT> static void BM_FindHit(benchmark::State &State) {
+  using KeyT = typename MapT::key_type;
+  auto Keys = getKeys<KeyT>(State.range(0));
+  MapT Map;
+  for (KeyT Key : Keys)
+    Map[Key] = 0;
+  for (auto _ : State)
+    for (KeyT Key : Keys)
+      benchmark::DoNotOptimize(Map.find(Key));
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+
+template <typename MapT> static void BM_FindMiss(benchmark::State &State) {
+  // Insert the first half of the keys and look up the second half.
+  using KeyT = typename MapT::key_type;
+  auto Keys = getKeys<KeyT>(2 * State.range(0));
+  size_t Half = Keys.size() / 2;
+  MapT Map;
+  for (size_t I = 0; I != Half; ++I)
+    Map[Keys[I]] = 0;
+  for (auto _ : State)
+    for (size_t I = Half; I != Keys.size(); ++I)
+      benchmark::DoNotOptimize(Map.count(Keys[I]));
+  State.SetItemsProcessed(State.iterations() * Half);
+}
+
+template <typename MapT> static void BM_InsertErase(benchmark::State &State) {
+  // Keep the map at a steady size, which is how worklists and caches keyed
+  // by pointers tend to use their maps.
+  using KeyT = typename MapT::key_type;
+  auto Keys = getKeys<KeyT>(2 * State.range(0));
+  size_t Half = Keys.size() / 2;
+  MapT Map;
+  for (size_t I = 0; I != Half; ++I)
+    Map[Keys[I]] = 0;
+  for (auto _ : State) {
+    for (size_t I = 0; I != Half; ++I) {
+      Map.erase(Keys[I]);
+      Map[Keys[I + Half]] = 0;
+    }
+    for (size_t I = 0; I != Half; ++I) {
+      Map.erase(Keys[I + Half]);
+      Map[Keys[I]] = 0;
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * 2 * Keys.size());
+}
+
+template <typename KeyT> using DenseMapOf = DenseMap<KeyT, unsigned>;
+template <typename KeyT> using SwissDenseMapOf = SwissDenseMap<KeyT, unsigned>;
+
+#define MAP_BENCHMARKS(KeyT)                                                   \
+  BENCHMARK_TEMPLATE(BM_Insert, DenseMapOf<KeyT>)                              \
+      ->Range(16, 1 << 20);                                                    \
+  BENCHMARK_TEMPLATE(BM_Insert, SwissDenseMapOf<KeyT>)                         \
+      ->Range(16, 1 << 20);                                                    \
+  BENCHMARK_TEMPLATE(BM_FindHit, DenseMapOf<KeyT>)                             \
+      ->Range(16, 1 << 20);                                                    \
+  BENCHMARK_TEMPLATE(BM_FindHit, SwissDenseMapOf<KeyT>)                        \
+      ->Range(16, 1 << 20);                                                    \
+  BENCHMARK_TEMPLATE(BM_FindMiss, DenseMapOf<KeyT>)                            \
+      ->Range(16, 1 << 20);                                                    \
+  BENCHMARK_TEMPLATE(BM_FindMiss, SwissDenseMapOf<KeyT>)                       \
+      ->Range(16, 1 << 20);                                                    \
+  BENCHMARK_TEMPLATE(BM_InsertErase, DenseMapOf<KeyT>)                         \
+      ->Range(16, 1 << 20);                                                    \
+  BENCHMARK_TEMPLATE(BM_InsertErase, SwissDenseMapOf<KeyT>)                    \
+      ->Range(16, 1 << 20)
+
+MAP_BENCHMARKS(uint64_t);
+MAP_BENCHMARKS(int *);
+
+BENCHMARK_MAIN();
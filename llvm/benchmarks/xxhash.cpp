@@ -0,0 +1,51 @@
+#include "benchmark/benchmark.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/xxhash.h"
+#include <cstdint>
+#include <vector>
+
+using namespace llvm;
+
+static std::vector<uint8_t> getInput(size_t Size) {
+  std::vector<uint8_t> Data(Size);
+  uint64_t X = 0;
+  for (uint8_t &B : Data) {
+    X = X * 6364136223846793005ULL + 1442695040888963407ULL;
+    B = uint8_t(X >> 56);
+  }
+  return Data;
+}
+
+template <typename HashFn>
+static void hashBenchmark(benchmark::State &State, HashFn Hash) {
+  std::vector<uint8_t> Data = getInput(State.range(0));
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Hash(ArrayRef<uint8_t>(Data)));
+  State.SetBytesProcessed(State.iterations() * Data.size());
+}
+
+static void BM_xxHash64(benchmark::State &State) {
+  hashBenchmark(State, [](ArrayRef<uint8_t> D) { return xxHash64(D); });
+}
+static void BM_xxh3_64bits(benchmark::State &State) {
+  hashBenchmark(State, [](ArrayRef<uint8_t> D) { return xxh3_64bits(D); });
+}
+static void BM_xxh3_128bits(benchmark::State &State) {
+  hashBenchmark(State, [](ArrayRef<uint8_t> D) { return xxh3_128bits(D); });
+}
+static void BM_MD5(benchmark::State &State) {
+  hashBenchmark(State, [](ArrayRef<uint8_t> D) { return MD5::hash(D); });
+}
+static void BM_SHA1(benchmark::State &State) {
+  hashBenchmark(State, [](ArrayRef<uint8_t> D) { return SHA1::hash(D); });
+}
+
+// Short strings as in string merging, up to the chunks hashed for build ids.
+BENCHMARK(BM_xxHash64)->RangeMultiplier(4)->Range(4, 1 << 20);
+BENCHMARK(BM_xxh3_64bits)->RangeMultiplier(4)->Range(4, 1 << 20);
+BENCHMARK(BM_xxh3_128bits)->RangeMultiplier(4)->Range(4, 1 << 20);
+BENCHMARK(BM_MD5)->RangeMultiplier(4)->Range(4, 1 << 20);
+BENCHMARK(BM_SHA1)->RangeMultiplier(4)->Range(4, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,588 @@
+//===- llvm/ADT/SwissDenseMap.h - Group probed hash table -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the SwissDenseMap class, an open addressing hash table in
+// the style of the "Swiss tables" that supports the commonly used subset of
+// the DenseMap interface.
+//
+// Next to the buckets, the table keeps one control byte per bucket that says
+// whether the bucket is empty, erased or full and, for full buckets, holds 7
+// bits of the hash of its key. A lookup loads the control bytes of a group of
+// 16 buckets at once, compares them against the hash bits with SIMD
+// instructions where available, and only compares keys for the few buckets
+// that match. A lookup for a missing key usually stops at the first group.
+//
+// This makes SwissDenseMap faster than DenseMap for large maps and for maps
+// with many failed lookups, in particular with pointer and integer keys. Since
+// the control bytes track which buckets are in use, SwissDenseMap does not
+// need the empty and tombstone keys of DenseMapInfo; it only uses its
+// getHashValue and isEqual functions.
+//
+// Like with DenseMap, inserting into the map invalidates all iterators and
+// the iteration order is unspecified.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_SWISSDENSEMAP_H
+#define LLVM_ADT_SWISSDENSEMAP_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/EpochTracker.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LLVM_SWISSDENSEMAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace llvm {
+
+namespace detail {
+
+/// The control bytes of SwissDenseMap and the operations on a group of them.
+/// A full bucket has the 7 hash bits as its (non-negative) control byte.
+struct SwissGroup {
+  static constexpr int8_t Empty = -128;
+  static constexpr int8_t Deleted = -2;
+  /// Marks the end of the control bytes for iterators.
+  static constexpr int8_t Sentinel = -1;
+
+  static constexpr unsigned Width = 16;
+
+  /// Return a bit mask of the buckets in the group at \p Ctrl whose control
+  /// byte is \p Byte.
+  static uint32_t match(const int8_t *Ctrl, int8_t Byte) {
+#ifdef LLVM_SWISSDENSEMAP_SSE2
+    __m128i Group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Ctrl));
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(Byte), Group)));
+#else
+    uint32_t Mask = 0;
+    for (unsigned I = 0; I != Width; ++I)
+      if (Ctrl[I] == Byte)
+        Mask |= 1u << I;
+    return Mask;
+#endif
+  }
+
+  /// Return a bit mask of the empty and the deleted buckets in the group at
+  /// \p Ctrl.
+  static uint32_t matchEmptyOrDeleted(const int8_t *Ctrl) {
+#ifdef LLVM_SWISSDENSEMAP_SSE2
+    __m128i Group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Ctrl));
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(Sentinel), Group)));
+#else
+    uint32_t Mask = 0;
+    for (unsigned I = 0; I != Width; ++I)
+      if (Ctrl[I] < Sentinel)
+        Mask |= 1u << I;
+    return Mask;
+#endif
+  }
+};
+
+} // end namespace detail
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, bool IsConst>
+class SwissDenseMapIterator;
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>>
+class SwissDenseMap : public DebugEpochBase {
+  using Group = detail::SwissGroup;
+
+public:
+  using size_type = unsigned;
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = detail::DenseMapPair<KeyT, ValueT>;
+
+  using iterator = SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, false>;
+  using const_iterator = SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, true>;
+
+  explicit SwissDenseMap(unsigned InitialReserve = 0) {
+    if (InitialReserve)
+      allocateBuckets(getMinCapacityForEntries(InitialReserve));
+  }
+
+  SwissDenseMap(const SwissDenseMap &Other) : DebugEpochBase() {
+    copyFrom(Other);
+  }
+
+  SwissDenseMap(SwissDenseMap &&Other) : DebugEpochBase() { swap(Other); }
+
+  template <typename InputIt>
+  SwissDenseMap(const InputIt &I, const InputIt &E) {
+    insert(I, E);
+  }
+
+  SwissDenseMap(std::initializer_list<value_type> Vals) {
+    reserve(Vals.size());
+    insert(Vals.begin(), Vals.end());
+  }
+
+  ~SwissDenseMap() {
+    destroyAll();
+    deallocateBuckets();
+  }
+
+  SwissDenseMap &operator=(const SwissDenseMap &Other) {
+    if (&Other != this) {
+      destroyAll();
+      deallocateBuckets();
+      copyFrom(Other);
+    }
+    return *this;
+  }
+
+  SwissDenseMap &operator=(SwissDenseMap &&Other) {
+    destroyAll();
+    deallocateBuckets();
+    Ctrl = nullptr;
+    Buckets = nullptr;
+    NumBuckets = NumEntries = NumDeleted = 0;
+    swap(Other);
+    return *this;
+  }
+
+  void swap(SwissDenseMap &Other) {
+    this->incrementEpoch();
+    Other.incrementEpoch();
+    std::swap(Ctrl, Other.Ctrl);
+    std::swap(Buckets, Other.Buckets);
+    std::swap(NumBuckets, Other.NumBuckets);
+    std::swap(NumEntries, Other.NumEntries);
+    std::swap(NumDeleted, Other.NumDeleted);
+  }
+
+  LLVM_NODISCARD bool empty() const { return NumEntries == 0; }
+  unsigned size() const { return NumEntries; }
+
+  /// Grow the map so that it can contain at least \p NumEntries items before
+  /// resizing again.
+  void reserve(size_type NumEntries) {
+    unsigned NewNumBuckets = getMinCapacityForEntries(NumEntries);
+    if (NewNumBuckets > NumBuckets)
+      rehash(NewNumBuckets);
+  }
+
+  void clear() {
+    this->incrementEpoch();
+    if (NumEntries == 0 && NumDeleted == 0)
+      return;
+    destroyAll();
+    std::memset(Ctrl, Group::Empty, NumBuckets);
+    NumEntries = NumDeleted = 0;
+  }
+
+  iterator begin() { return makeBegin<iterator>(Ctrl, Buckets); }
+  iterator end() { return makeEnd<iterator>(Ctrl, Buckets); }
+  const_iterator begin() const {
+    return makeBegin<const_iterator>(Ctrl, Buckets);
+  }
+  const_iterator end() const {
+    return makeEnd<const_iterator>(Ctrl, Buckets);
+  }
+
+  /// Return 1 if the specified key is in the map, 0 otherwise.
+  size_type count(const KeyT &Key) const {
+    return findBucket(Key) != NumBuckets ? 1 : 0;
+  }
+
+  iterator find(const KeyT &Key) {
+    unsigned I = findBucket(Key);
+    return I == NumBuckets ? end() : makeIterator<iterator>(I);
+  }
+  const_iterator find(const KeyT &Key) const {
+    unsigned I = findBucket(Key);
+    return I == NumBuckets ? end() : makeIterator<const_iterator>(I);
+  }
+
+  /// Return the entry for the specified key, or a default constructed value
+  /// if no such entry exists.
+  ValueT lookup(const KeyT &Key) const {
+    unsigned I = findBucket(Key);
+    return I == NumBuckets ? ValueT() : Buckets[I].getSecond();
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(const std::pair<KeyT, ValueT> &KV) {
+    return try_emplace(KV.first, KV.second);
+  }
+
+  std::pair<iterator, bool> insert(std::pair<KeyT, ValueT> &&KV) {
+    return try_emplace(std::move(KV.first), std::move(KV.second));
+  }
+
+  /// Insert a range of pairs into the map.
+  template <typename InputIt> void insert(InputIt I, InputIt E) {
+    for (; I != E; ++I)
+      insert(*I);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename KeyArgT, typename... Ts>
+  std::pair<iterator, bool> try_emplace(KeyArgT &&Key, Ts &&... Args) {
+    uint64_t Hash = getHash(Key);
+    unsigned I = findBucket(Key, Hash);
+    if (I != NumBuckets)
+      return std::make_pair(makeIterator<iterator>(I), false);
+
+    I = insertIntoFreeBucket(Hash);
+    value_type &Bucket = Buckets[I];
+    ::new (&Bucket.getFirst()) KeyT(std::forward<KeyArgT>(Key));
+    ::new (&Bucket.getSecond()) ValueT(std::forward<Ts>(Args)...);
+    return std::make_pair(makeIterator<iterator>(I), true);
+  }
+
+  ValueT &operator[](const KeyT &Key) { return try_emplace(Key).first->second; }
+
+  ValueT &operator[](KeyT &&Key) {
+    return try_emplace(std::move(Key)).first->second;
+  }
+
+  bool erase(const KeyT &Key) {
+    unsigned I = findBucket(Key);
+    if (I == NumBuckets)
+      return false;
+    eraseBucket(I);
+    return true;
+  }
+
+  void erase(iterator I) {
+    assert(I != end() && "Erasing the end iterator");
+    eraseBucket(I.Ptr - Buckets);
+  }
+
+  /// Return the approximate size (in bytes) of the actual map.
+  size_t getMemorySize() const {
+    return NumBuckets ? getAllocationSize(NumBuckets) : 0;
+  }
+
+private:
+  int8_t *Ctrl = nullptr;
+  value_type *Buckets = nullptr;
+  unsigned NumBuckets = 0;
+  unsigned NumEntries = 0;
+  unsigned NumDeleted = 0;
+
+  /// Mix the bits of the DenseMapInfo hash, which is often weak (pointers
+  /// are just shifted, integers multiplied by 37), so that both the group
+  /// index and the 7 bits in the control byte are well distributed.
+  static uint64_t getHash(const KeyT &Key) {
+    return static_cast<uint64_t>(KeyInfoT::getHashValue(Key)) *
+           0x9E3779B97F4A7C15ULL;
+  }
+
+  /// The 7 bits of \p Hash that go into the control byte.
+  static int8_t getControlByte(uint64_t Hash) {
+    return static_cast<int8_t>(Hash >> 57);
+  }
+
+  /// The group at which the probe sequence for \p Hash starts.
+  unsigned getFirstGroup(uint64_t Hash) const {
+    return static_cast<unsigned>(Hash >> 32) & (NumBuckets / Group::Width - 1);
+  }
+
+  /// Return the number of entries the table can hold with \p NumBuckets
+  /// buckets. At least one empty bucket always remains, which ends every
+  /// probe sequence.
+  static unsigned getMaxLoad(unsigned NumBuckets) {
+    return NumBuckets - NumBuckets / 8;
+  }
+
+  static unsigned getMinCapacityForEntries(unsigned NumEntries) {
+    if (NumEntries == 0)
+      return 0;
+    unsigned NumBuckets = Group::Width;
+    while (getMaxLoad(NumBuckets) < NumEntries)
+      NumBuckets *= 2;
+    return NumBuckets;
+  }
+
+  /// The buckets and the control bytes share one allocation. There is one
+  /// control byte per bucket plus a sentinel for the iterators.
+  static size_t getAllocationSize(unsigned NumBuckets) {
+    return sizeof(value_type) * NumBuckets + NumBuckets + 1;
+  }
+
+  unsigned findBucket(const KeyT &Key) const {
+    return NumBuckets ? findBucket(Key, getHash(Key)) : 0;
+  }
+
+  /// Return the index of the bucket for \p Key, or NumBuckets if the key is
+  /// not in the map.
+  unsigned findBucket(const KeyT &Key, uint64_t Hash) const {
+    if (NumBuckets == 0)
+      return 0;
+    const unsigned GroupMask = NumBuckets / Group::Width - 1;
+    const int8_t Byte = getControlByte(Hash);
+    unsigned G = getFirstGroup(Hash);
+    // Probe the groups in triangular order, which visits all of them since
+    // the number of groups is a power of two.
+    for (unsigned Probe = 1;; ++Probe) {
+      const unsigned First = G * Group::Width;
+      for (uint32_t Mask = Group::match(Ctrl + First, Byte); Mask;
+           Mask &= Mask - 1) {
+        unsigned I = First + countTrailingZeros(Mask);
+        if (LLVM_LIKELY(KeyInfoT::isEqual(Buckets[I].getFirst(), Key)))
+          return I;
+      }
+      if (LLVM_LIKELY(Group::match(Ctrl + First, Group::Empty)))
+        return NumBuckets;
+      G = (G + Probe) & GroupMask;
+    }
+  }
+
+  /// Return the first empty or deleted bucket in the probe sequence of
+  /// \p Hash.
+  unsigned findFreeBucket(uint64_t Hash) const {
+    const unsigned GroupMask = NumBuckets / Group::Width - 1;
+    unsigned G = getFirstGroup(Hash);
+    for (unsigned Probe = 1;; ++Probe) {
+      const unsigned First = G * Group::Width;
+      if (uint32_t Mask = Group::matchEmptyOrDeleted(Ctrl + First))
+        return First + countTrailingZeros(Mask);
+      G = (G + Probe) & GroupMask;
+    }
+  }
+
+  /// Claim a bucket for a new entry with \p Hash, growing the table if
+  /// needed, and return its index. The caller constructs the entry.
+  unsigned insertIntoFreeBucket(uint64_t Hash) {
+    this->incrementEpoch();
+    if (LLVM_UNLIKELY(NumEntries + NumDeleted + 1 > getMaxLoad(NumBuckets))) {
+      // Only grow if the table is really getting full, otherwise rehashing
+      // in place is enough to get rid of the deleted buckets.
+      if (NumEntries + 1 > getMaxLoad(NumBuckets) / 2)
+        rehash(NumBuckets ? NumBuckets * 2 : unsigned(Group::Width));
+      else
+        rehash(NumBuckets);
+    }
+    unsigned I = findFreeBucket(Hash);
+    if (Ctrl[I] == Group::Deleted)
+      --NumDeleted;
+    Ctrl[I] = getControlByte(Hash);
+    ++NumEntries;
+    return I;
+  }
+
+  void eraseBucket(unsigned I) {
+    Buckets[I].getSecond().~ValueT();
+    Buckets[I].getFirst().~KeyT();
+    --NumEntries;
+    // Lookups stop at a group with an empty bucket. If the group of the
+    // bucket already has one, making another one empty can't cut short the
+    // probe sequence of the keys after it.
+    const int8_t *GroupCtrl = Ctrl + I / Group::Width * Group::Width;
+    if (Group::match(GroupCtrl, Group::Empty)) {
+      Ctrl[I] = Group::Empty;
+    } else {
+      Ctrl[I] = Group::Deleted;
+      ++NumDeleted;
+    }
+  }
+
+  void allocateBuckets(unsigned Num) {
+    assert(Num % Group::Width == 0 && isPowerOf2_32(Num) &&
+           "Invalid number of buckets");
+    size_t BucketBytes = sizeof(value_type) * Num;
+    char *Mem = static_cast<char *>(
+        allocate_buffer(getAllocationSize(Num), alignof(value_type)));
+    Buckets = reinterpret_cast<value_type *>(Mem);
+    Ctrl = reinterpret_cast<int8_t *>(Mem + BucketBytes);
+    std::memset(Ctrl, Group::Empty, Num);
+    Ctrl[Num] = Group::Sentinel;
+    NumBuckets = Num;
+  }
+
+  void deallocateBuckets() {
+    if (NumBuckets)
+      deallocate_buffer(Buckets, getAllocationSize(NumBuckets),
+                        alignof(value_type));
+  }
+
+  void destroyAll() {
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (Ctrl[I] < 0)
+        continue;
+      Buckets[I].getSecond().~ValueT();
+      Buckets[I].getFirst().~KeyT();
+    }
+  }
+
+  void rehash(unsigned NewNumBuckets) {
+    int8_t *OldCtrl = Ctrl;
+    value_type *OldBuckets = Buckets;
+    unsigned OldNumBuckets = NumBuckets;
+
+    allocateBuckets(NewNumBuckets);
+    NumDeleted = 0;
+    for (unsigned I = 0; I != OldNumBuckets; ++I) {
+      if (OldCtrl[I] < 0)
+        continue;
+      value_type &Old = OldBuckets[I];
+      uint64_t Hash = getHash(Old.getFirst());
+      unsigned J = findFreeBucket(Hash);
+      Ctrl[J] = getControlByte(Hash);
+      ::new (&Buckets[J].getFirst()) KeyT(std::move(Old.getFirst()));
+      ::new (&Buckets[J].getSecond()) ValueT(std::move(Old.getSecond()));
+      Old.getSecond().~ValueT();
+      Old.getFirst().~KeyT();
+    }
+
+    if (OldNumBuckets)
+      deallocate_buffer(OldBuckets, getAllocationSize(OldNumBuckets),
+                        alignof(value_type));
+  }
+
+  void copyFrom(const SwissDenseMap &Other) {
+    Ctrl = nullptr;
+    Buckets = nullptr;
+    NumBuckets = NumEntries = NumDeleted = 0;
+    if (!Other.NumBuckets)
+      return;
+    // With the same number of buckets, every entry can stay where it is.
+    allocateBuckets(Other.NumBuckets);
+    std::memcpy(Ctrl, Other.Ctrl, NumBuckets);
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (Ctrl[I] < 0)
+        continue;
+      ::new (&Buckets[I].getFirst()) KeyT(Other.Buckets[I].getFirst());
+      ::new (&Buckets[I].getSecond()) ValueT(Other.Buckets[I].getSecond());
+    }
+    NumEntries = Other.NumEntries;
+    NumDeleted = Other.NumDeleted;
+  }
+
+  template <typename IteratorT> IteratorT makeIterator(unsigned I) const {
+    return IteratorT(Buckets + I, Ctrl + I, *this, true);
+  }
+
+  template <typename IteratorT>
+  IteratorT makeBegin(int8_t *CtrlBegin, value_type *BucketsBegin) const {
+    if (empty())
+      return makeEnd<IteratorT>(CtrlBegin, BucketsBegin);
+    return IteratorT(BucketsBegin, CtrlBegin, *this);
+  }
+
+  template <typename IteratorT>
+  IteratorT makeEnd(int8_t *CtrlBegin, value_type *BucketsBegin) const {
+    return IteratorT(BucketsBegin + NumBuckets, CtrlBegin + NumBuckets, *this,
+                     true);
+  }
+
+  friend class SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, false>;
+  friend class SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, true>;
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, bool IsConst>
+class SwissDenseMapIterator : DebugEpochBase::HandleBase {
+  friend class SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, true>;
+  friend class SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, false>;
+  friend class SwissDenseMap<KeyT, ValueT, KeyInfoT>;
+
+  using Bucket = detail::DenseMapPair<KeyT, ValueT>;
+
+public:
+  using difference_type = ptrdiff_t;
+  using value_type =
+      typename std::conditional<IsConst, const Bucket, Bucket>::type;
+  using pointer = value_type *;
+  using reference = value_type &;
+  using iterator_category = std::forward_iterator_tag;
+
+private:
+  pointer Ptr = nullptr;
+  const int8_t *Ctrl = nullptr;
+
+public:
+  SwissDenseMapIterator() = default;
+
+  SwissDenseMapIterator(pointer Pos, const int8_t *CtrlPos,
+                        const DebugEpochBase &Epoch, bool NoAdvance = false)
+      : DebugEpochBase::HandleBase(&Epoch), Ptr(Pos), Ctrl(CtrlPos) {
+    assert(isHandleInSync() && "invalid construction!");
+    if (!NoAdvance)
+      skipFreeBuckets();
+  }
+
+  // Converting ctor from non-const iterators to const iterators. SFINAE'd out
+  // for const iterator destinations so it doesn't end up as a user defined
+  // copy constructor.
+  template <bool IsConstSrc,
+            typename = std::enable_if_t<!IsConstSrc && IsConst>>
+  SwissDenseMapIterator(
+      const SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, IsConstSrc> &I)
+      : DebugEpochBase::HandleBase(I), Ptr(I.Ptr), Ctrl(I.Ctrl) {}
+
+  reference operator*() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    return *Ptr;
+  }
+  pointer operator->() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    return Ptr;
+  }
+
+  bool operator==(const SwissDenseMapIterator &RHS) const {
+    assert((!Ptr || isHandleInSync()) && "handle not in sync!");
+    assert((!RHS.Ptr || RHS.isHandleInSync()) && "handle not in sync!");
+    assert(getEpochAddress() == RHS.getEpochAddress() &&
+           "comparing incomparable iterators!");
+    return Ptr == RHS.Ptr;
+  }
+  bool operator!=(const SwissDenseMapIterator &RHS) const {
+    return !(*this == RHS);
+  }
+
+  SwissDenseMapIterator &operator++() { // Preincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    ++Ptr;
+    ++Ctrl;
+    skipFreeBuckets();
+    return *this;
+  }
+  SwissDenseMapIterator operator++(int) { // Postincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    SwissDenseMapIterator Tmp = *this;
+    ++*this;
+    return Tmp;
+  }
+
+private:
+  void skipFreeBuckets() {
+    // Full buckets have a non-negative control byte. The sentinel after the
+    // last bucket stops the loop at the end iterator.
+    while (*Ctrl < detail::SwissGroup::Sentinel) {
+      ++Ptr;
+      ++Ctrl;
+    }
+  }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_SWISSDENSEMAP_H
@@ -1045,6 +1045,22 @@ public:
   virtual MemoryAccess *getClobberingMemoryAccess(MemoryAccess *,
                                                   const MemoryLocation &) = 0;
 
+  /// Same as the overloads above, but makes at most \p UpwardWalkLimit alias
+  /// queries, and decrements \p UpwardWalkLimit by the number of queries made.
+  /// When the limit is reached, this returns the access at which the walk
+  /// stopped. That access may clobber the location, but isn't known to, so
+  /// callers must treat the result as conservative. The limit can be shared
+  /// across several queries to bound the total work of a transformation.
+  virtual MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA,
+                                                  unsigned &UpwardWalkLimit) {
+    return getClobberingMemoryAccess(MA);
+  }
+  virtual MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA,
+                                                  const MemoryLocation &Loc,
+                                                  unsigned &UpwardWalkLimit) {
+    return getClobberingMemoryAccess(MA, Loc);
+  }
+
   /// Given a memory access, invalidate anything this walker knows about
   /// that access.
   /// This API is used by walkers that store information to perform basic cache
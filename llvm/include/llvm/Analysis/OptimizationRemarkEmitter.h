@@ -58,6 +58,7 @@ public:
   OptimizationRemarkEmitter &operator=(OptimizationRemarkEmitter &&RHS) {
     F = RHS.F;
     BFI = RHS.BFI;
+    MaxHotness = None;
     return *this;
   }
 
@@ -77,8 +78,12 @@ public:
     // remarks enabled. We can't currently check whether remarks are requested
     // for the calling pass since that requires actually building the remark.
 
-    if (F->getContext().getLLVMRemarkStreamer() ||
-        F->getContext().getDiagHandlerPtr()->isAnyRemarkEnabled()) {
+    //
+    // Similarly, skip building it if no block of the function is hot enough to
+    // meet the hotness threshold.
+    if ((F->getContext().getLLVMRemarkStreamer() ||
+         F->getContext().getDiagHandlerPtr()->isAnyRemarkEnabled()) &&
+        mayMeetHotnessThreshold()) {
       auto R = RemarkBuilder();
       emit((DiagnosticInfoOptimizationBase &)R);
     }
@@ -104,6 +109,9 @@ private:
   /// If we generate BFI on demand, we need to free it when ORE is freed.
   std::unique_ptr<BlockFrequencyInfo> OwnedBFI;
 
+  /// The largest profile count of a block in F, computed on demand.
+  Optional<uint64_t> MaxHotness;
+
   /// Compute hotness from IR value (currently assumed to be a block) if PGO is
   /// available.
   Optional<uint64_t> computeHotness(const Value *V);
@@ -111,6 +119,11 @@ private:
   /// Similar but use value from \p OptDiag and update hotness there.
   void computeHotness(DiagnosticInfoIROptimization &OptDiag);
 
+  /// Return false if no remark about F can meet the hotness threshold, which
+  /// is cheaper to find out than building the remark and computing its own
+  /// hotness.
+  bool mayMeetHotnessThreshold();
+
   /// Only allow verbose messages if we know we're filtering by hotness
   /// (BFI is only set in this case).
   bool shouldEmitVerbose() { return BFI != nullptr; }
@@ -1362,6 +1362,11 @@ private:
     /// subexpression.
     bool hasOperand(const SCEV *S, ScalarEvolution *SE) const;
 
+    /// Return true if any backedge taken count expressions refer to any of the
+    /// given subexpressions.
+    bool hasAnyOperand(const SmallPtrSetImpl<const SCEV *> &Ops,
+                       ScalarEvolution *SE) const;
+
     /// Invalidate this result and free associated memory.
     void clear();
   };
@@ -1773,6 +1778,14 @@ private:
   /// Drop memoized information computed for S.
   void forgetMemoizedResults(const SCEV *S);
 
+  /// Drop memoized information computed for all of \p SCEVs. This walks the
+  /// backedge taken counts once for all of them, so it should be preferred
+  /// over forgetting each SCEV on its own.
+  void forgetMemoizedResults(ArrayRef<const SCEV *> SCEVs);
+
+  /// Drop the memoized information that is keyed on S alone.
+  void forgetMemoizedResultsImpl(const SCEV *S);
+
   /// Return an existing SCEV for V if there is one, otherwise return nullptr.
   const SCEV *getExistingSCEV(Value *V);
 
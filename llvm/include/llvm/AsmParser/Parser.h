@@ -123,6 +123,18 @@ std::unique_ptr<Module> parseAssembly(MemoryBufferRef F, SMDiagnostic &Err,
                                       bool UpgradeDebugInfo = true,
                                       StringRef DataLayoutString = "");
 
+/// Parse LLVM Assembly from a MemoryBuffer, but only parse the body of each
+/// function when it is materialized, like getOwningLazyBitcodeModule does for
+/// bitcode. Errors in a function body are reported when it is materialized.
+/// Modules with use-list order directives are parsed in full.
+/// \param Buffer The MemoryBuffer containing assembly, which the returned
+///               module keeps alive.
+/// \param Err Error result info.
+/// \param Context Context in which to allocate globals info.
+std::unique_ptr<Module>
+parseAssemblyLazily(std::unique_ptr<MemoryBuffer> Buffer, SMDiagnostic &Err,
+                    LLVMContext &Context);
+
 /// Parse LLVM Assembly including the summary index from a MemoryBuffer.
 ///
 /// \param F The MemoryBuffer containing assembly with summary
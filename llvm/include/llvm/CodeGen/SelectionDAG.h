@@ -506,8 +506,9 @@ public:
   /// This iterates over the nodes in the SelectionDAG, folding
   /// certain types of nodes together, or eliminating superfluous nodes.  The
   /// Level argument controls whether Combine is allowed to produce nodes and
-  /// types that are illegal on the target.
-  void Combine(CombineLevel Level, AAResults *AA,
+  /// types that are illegal on the target. Returns false if the combiner
+  /// gave up early to bound its compile time.
+  bool Combine(CombineLevel Level, AAResults *AA,
                CodeGenOpt::Level OptLevel);
 
   /// This transforms the SelectionDAG into a SelectionDAG that
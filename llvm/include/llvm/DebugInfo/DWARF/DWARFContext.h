@@ -40,6 +40,7 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 
 namespace llvm {
 
@@ -91,6 +92,26 @@ class DWARFContext : public DIContext {
       WithColor::defaultErrorHandler;
   std::function<void(Error)> WarningHandler = WithColor::defaultWarningHandler;
 
+  /// If set, the lazily parsed state below is initialized under these locks,
+  /// so that this context can be queried from several threads at once.
+  bool ThreadSafe = false;
+  /// Guards NormalUnits, DWOUnits, MaxVersion, CUIndex and TUIndex.
+  std::recursive_mutex UnitsMutex;
+  /// Guards Abbrev, AbbrevDWO and the declaration sets they cache.
+  std::mutex AbbrevMutex;
+  /// Guards Aranges.
+  std::mutex ArangesMutex;
+  /// Guards Line and the line tables it caches.
+  std::mutex LineMutex;
+  /// Guards DWOFiles, DWP and CheckedForDWP.
+  std::mutex DWOFilesMutex;
+
+  template <typename MutexT> std::unique_lock<MutexT> lock(MutexT &M) {
+    if (!ThreadSafe)
+      return std::unique_lock<MutexT>();
+    return std::unique_lock<MutexT>(M);
+  }
+
   /// Read compile units from the debug_info section (if necessary)
   /// and type units from the debug_types sections (if necessary)
   /// and store them in NormalUnits.
@@ -128,6 +149,20 @@ public:
 
   const DWARFObject &getDWARFObj() const { return *DObj; }
 
+  /// Allow this context, and the contexts of the DWO files it loads, to be
+  /// queried from several threads at once. The units, their DIEs, address
+  /// maps and line tables, and the address ranges are still parsed lazily,
+  /// but each only once. The DIEs of a unit are extracted all at once and are
+  /// never cleared, so that DWARFDie handles stay valid. Other sections have
+  /// to be parsed before the context is shared. Must be called before the
+  /// context is queried.
+  void setThreadSafe(bool Enable = true) { ThreadSafe = Enable; }
+  bool isThreadSafe() const { return ThreadSafe; }
+
+  /// Returns a lock that must be held while looking up abbreviation
+  /// declaration sets, if this context is thread safe.
+  std::unique_lock<std::mutex> lockAbbreviations() { return lock(AbbrevMutex); }
+
   static bool classof(const DIContext *DICtx) {
     return DICtx->getKind() == CK_DWARF;
   }
@@ -31,6 +31,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -238,6 +239,12 @@ class DWARFUnit {
 
   std::shared_ptr<DWARFUnit> DWO;
 
+  /// Guards Abbrevs, DieArray, AddrDieMap, DWO and the unit attributes taken
+  /// from the unit DIE if the context is thread safe.
+  mutable std::recursive_mutex Mutex;
+
+  std::unique_lock<std::recursive_mutex> lock() const;
+
   uint32_t getDIEIndex(const DWARFDebugInfoEntry *Die) {
     auto First = DieArray.data();
     assert(Die >= First && Die < First + DieArray.size());
@@ -158,6 +158,13 @@ private:
   /// \returns The number of errors that occurred during verification.
   unsigned verifyUnitContents(DWARFUnit &Unit);
 
+  /// Verify the contents of \p Units in parallel. The output for each unit
+  /// is buffered and printed in the order of \p Units, and the references
+  /// they contain are collected for verifyDebugInfoReferences().
+  ///
+  /// \returns The number of errors that occurred during verification.
+  unsigned verifyUnitContentsInParallel(ArrayRef<DWARFUnit *> Units);
+
   /// Verifies the unit headers and contents in a .debug_info or .debug_types
   /// section.
   ///
@@ -137,6 +137,8 @@ public:
 
   Error commit() override;
 
+  void dontNeed(uint32_t Offset, uint32_t Size) override;
+
   const MSFStreamLayout &getStreamLayout() const {
     return ReadInterface.getStreamLayout();
   }
@@ -13,13 +13,17 @@
 #include "llvm/DebugInfo/CodeView/TypeDeserializer.h"
 #include "llvm/DebugInfo/CodeView/TypeIndex.h"
 #include "llvm/DebugInfo/CodeView/TypeRecord.h"
+#include "llvm/DebugInfo/PDB/IPDBSourceFile.h"
+#include "llvm/DebugInfo/PDB/Native/ModuleDebugStream.h"
 #include "llvm/DebugInfo/PDB/Native/NativeRawSymbol.h"
+#include "llvm/DebugInfo/PDB/Native/NativeSourceFile.h"
 
 #include <memory>
 #include <vector>
 
 namespace llvm {
 namespace pdb {
+class DbiModuleDescriptor;
 class DbiStream;
 class PDBFile;
 
@@ -51,6 +55,61 @@ class SymbolCache {
   /// Map from global symbol offset to SymIndexId.
   DenseMap<uint32_t, SymIndexId> GlobalOffsetToSymbolId;
 
+  // The address ranges below are all given as a section index and an offset
+  // into that section, and are sorted by address.
+
+  /// A function, from an S_*PROC32 record of a module symbol stream.
+  struct FunctionRange {
+    uint32_t Section;
+    uint32_t Offset;
+    uint32_t Length;
+    uint32_t Modi;
+    uint32_t RecordOffset;
+  };
+
+  /// A section contribution of a compiland.
+  struct ContribRange {
+    uint32_t Section;
+    uint32_t Offset;
+    uint32_t Length;
+    uint32_t Modi;
+  };
+
+  /// A row of a module line table. A row ends where the next row of its
+  /// function starts.
+  struct LineRange {
+    uint32_t Section;
+    uint32_t Offset;
+    uint32_t Length;
+    uint32_t LineData;
+    uint16_t ColumnStart;
+    uint16_t ColumnEnd;
+    uint32_t Modi;
+    uint32_t ChecksumOffset;
+  };
+
+  /// The address index. It is built on the first lookup by address, with the
+  /// module streams read in parallel.
+  bool AddressIndexBuilt = false;
+  std::vector<FunctionRange> Functions;
+  std::vector<ContribRange> Contribs;
+  std::vector<LineRange> Lines;
+
+  /// Map from (compiland index, symbol record offset) of a function to the
+  /// SymIndexId of its symbol.
+  DenseMap<std::pair<uint32_t, uint32_t>, SymIndexId> FunctionToSymbolId;
+
+  /// Source files of the line tables, indexed by source file id. Id 0 is
+  /// reserved for the invalid file.
+  std::vector<std::unique_ptr<NativeSourceFile>> SourceFiles;
+
+  /// Map from (compiland index, file checksum offset) to source file id.
+  DenseMap<std::pair<uint32_t, uint32_t>, uint32_t> ChecksumToFileId;
+
+  /// Map from the string table offset of a file name to source file id, so
+  /// that a file has the same id in every compiland.
+  DenseMap<uint32_t, uint32_t> FileNameToFileId;
+
   SymIndexId createSymbolPlaceholder() {
     SymIndexId Id = Cache.size();
     Cache.push_back(nullptr);
@@ -77,6 +136,15 @@ class SymbolCache {
   SymIndexId createSimpleType(codeview::TypeIndex TI,
                               codeview::ModifierOptions Mods);
 
+  void buildAddressIndex();
+  static void indexModule(const PDBFile &File, const DbiModuleDescriptor &Mod,
+                          uint32_t Modi, std::vector<FunctionRange> &Functions,
+                          std::vector<LineRange> &Lines);
+
+  Expected<ModuleDebugStreamRef> getModuleDebugStream(uint32_t Index) const;
+  SymIndexId getOrCreateFunctionSymbol(const FunctionRange &Function);
+  uint32_t getOrCreateSourceFile(uint32_t Modi, uint32_t ChecksumOffset);
+
 public:
   SymbolCache(NativeSession &Session, DbiStream *Dbi);
 
@@ -130,6 +198,13 @@ public:
   std::unique_ptr<PDBSymbolCompiland> getOrCreateCompiland(uint32_t Index);
   uint32_t getNumCompilands() const;
 
+  std::unique_ptr<PDBSymbol> findSymbolBySectOffset(uint32_t Sect,
+                                                    uint32_t Offset,
+                                                    PDB_SymType Type);
+  std::unique_ptr<IPDBEnumLineNumbers>
+  findLineNumbersBySectOffset(uint32_t Sect, uint32_t Offset, uint32_t Length);
+  std::unique_ptr<IPDBSourceFile> getSourceFileById(uint32_t FileId) const;
+
   std::unique_ptr<PDBSymbol> getSymbolById(SymIndexId SymbolId) const;
 
   NativeRawSymbol &getNativeSymbolById(SymIndexId SymbolId) const;
@@ -20,6 +20,7 @@
 #include "llvm/Support/Error.h"
 #include <algorithm>
 #include <cstdint>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -48,6 +49,9 @@ public:
     std::string FallbackDebugPath;
     std::string DWPName;
     std::vector<std::string> DebugFileDirectory;
+    /// If nonzero, the approximate total size in bytes of the binaries kept
+    /// open. The least recently used modules are closed to stay below it.
+    uint64_t MaxCacheSize = 0;
   };
 
   LLVMSymbolizer() = default;
@@ -116,6 +120,18 @@ private:
   Expected<ObjectFile *> getOrCreateObject(const std::string &Path,
                                           const std::string &ArchName);
 
+  /// Start tracking a module created by getOrCreateModuleInfo() for
+  /// Opts.MaxCacheSize, and close the least recently used modules if the
+  /// cache has grown too large.
+  void cacheModule(const std::string &ModuleName, ObjectPair Objects);
+
+  /// Close a module, and the objects it was created from unless another
+  /// module still uses them.
+  void evictModule(StringRef ModuleName);
+
+  /// Remove all cached references to an object that no module uses.
+  void closeObject(const ObjectFile *Obj);
+
   std::map<std::string, std::unique_ptr<SymbolizableModule>, std::less<>>
       Modules;
 
@@ -131,6 +147,21 @@ private:
   std::map<std::pair<std::string, std::string>, std::unique_ptr<ObjectFile>>
       ObjectForUBPathAndArch;
 
+  struct CachedModule {
+    ObjectPair Objects;
+    uint64_t Size;
+    std::list<std::string>::iterator LRUPos;
+  };
+
+  /// Modules tracked for Opts.MaxCacheSize.
+  std::map<std::string, CachedModule, std::less<>> CachedModules;
+
+  /// Names of the tracked modules, least recently used first.
+  std::list<std::string> LRUModules;
+
+  /// Total size of the tracked modules.
+  uint64_t CacheSize = 0;
+
   Options Opts;
 };
 
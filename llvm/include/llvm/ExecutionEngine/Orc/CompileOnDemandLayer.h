@@ -99,6 +99,11 @@ public:
   /// called by the JIT when a definition added via the add method is requested.
   void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
 
+  /// Redirects the stub for the function Name, whose body was emitted into
+  /// the implementation dylib ImplD, to NewAddr. This can be used to replace
+  /// the body of a function that has already been compiled.
+  Error updateStub(JITDylib &ImplD, StringRef Name, JITTargetAddress NewAddr);
+
 private:
   struct PerDylibResources {
   public:
@@ -86,6 +86,17 @@ enum class SymbolLookupFlags { RequiredSymbol, WeaklyReferencedSymbol };
 ///          representing static archives should not pull in new definitions).
 enum class LookupKind { Static, DLSym };
 
+/// Describes how urgently the materializers triggered by a lookup are needed.
+/// The priority is passed to the materialization dispatch function, which may
+/// use it to order the work it has been given.
+///
+/// Normal -- Some client is (or will be) waiting for the result.
+///
+/// Speculative -- Nothing is waiting for the result yet (e.g. the lookup was
+///                made by a Speculator), so the work should only run when
+///                there is nothing more urgent to do.
+enum class MaterializationPriority { Speculative, Normal };
+
 /// A list of (JITDylib*, JITDylibLookupFlags) pairs to be used as a search
 /// order during symbol lookup.
 using JITDylibSearchOrder =
@@ -1094,6 +1105,18 @@ public:
   using DispatchMaterializationFunction = std::function<void(
       JITDylib &JD, std::unique_ptr<MaterializationUnit> MU)>;
 
+  /// For dispatching MaterializationUnit::materialize calls, taking the
+  /// priority of the lookup that triggered them into account.
+  using PrioritizedDispatchMaterializationFunction = std::function<void(
+      JITDylib &JD, std::unique_ptr<MaterializationUnit> MU,
+      MaterializationPriority Priority)>;
+
+  /// For raising the priority of materialization that has already been
+  /// dispatched. Called with the symbols of a JITDylib that a lookup with
+  /// Normal priority is waiting for.
+  using PromoteMaterializationFunction =
+      std::function<void(JITDylib &JD, const SymbolNameSet &Symbols)>;
+
   /// Construct an ExecutionSession.
   ///
   /// SymbolStringPools may be shared between ExecutionSessions.
@@ -1168,10 +1191,33 @@ public:
   /// Set the materialization dispatch function.
   ExecutionSession &setDispatchMaterialization(
       DispatchMaterializationFunction DispatchMaterialization) {
+    this->DispatchMaterialization =
+        [DispatchMaterialization = std::move(DispatchMaterialization)](
+            JITDylib &JD, std::unique_ptr<MaterializationUnit> MU,
+            MaterializationPriority) {
+          DispatchMaterialization(JD, std::move(MU));
+        };
+    return *this;
+  }
+
+  /// Set a materialization dispatch function that is told the priority of
+  /// each unit of work.
+  ExecutionSession &setPrioritizedDispatchMaterialization(
+      PrioritizedDispatchMaterializationFunction DispatchMaterialization) {
     this->DispatchMaterialization = std::move(DispatchMaterialization);
     return *this;
   }
 
+  /// Set the function that is told when a lookup with Normal priority waits
+  /// for symbols whose materializer was dispatched earlier, maybe with
+  /// Speculative priority, so that a prioritized dispatcher can move that
+  /// work ahead.
+  ExecutionSession &setPromoteMaterialization(
+      PromoteMaterializationFunction PromoteMaterialization) {
+    this->PromoteMaterialization = std::move(PromoteMaterialization);
+    return *this;
+  }
+
   void legacyFailQuery(AsynchronousSymbolQuery &Q, Error Err);
 
   using LegacyAsyncLookupFunction = std::function<SymbolNameSet(
@@ -1203,10 +1249,15 @@ public:
   /// dependenant symbols for this query (e.g. it is being made by a top level
   /// client to get an address to call) then the value NoDependenciesToRegister
   /// can be used.
+  ///
+  /// Any materializers triggered by this lookup are dispatched with the given
+  /// Priority.
   void lookup(LookupKind K, const JITDylibSearchOrder &SearchOrder,
               SymbolLookupSet Symbols, SymbolState RequiredState,
               SymbolsResolvedCallback NotifyComplete,
-              RegisterDependenciesFunction RegisterDependencies);
+              RegisterDependenciesFunction RegisterDependencies,
+              MaterializationPriority Priority =
+                  MaterializationPriority::Normal);
 
   /// Blocking version of lookup above. Returns the resolved symbol map.
   /// If WaitUntilReady is true (the default), will not return until all
@@ -1244,11 +1295,12 @@ public:
          SymbolState RequiredState = SymbolState::Ready);
 
   /// Materialize the given unit.
-  void dispatchMaterialization(JITDylib &JD,
-                               std::unique_ptr<MaterializationUnit> MU) {
+  void dispatchMaterialization(
+      JITDylib &JD, std::unique_ptr<MaterializationUnit> MU,
+      MaterializationPriority Priority = MaterializationPriority::Normal) {
     assert(MU && "MU must be non-null");
     DEBUG_WITH_TYPE("orc", dumpDispatchInfo(JD, *MU));
-    DispatchMaterialization(JD, std::move(MU));
+    DispatchMaterialization(JD, std::move(MU), Priority);
   }
 
   /// Dump the state of all the JITDylibs in this session.
@@ -1259,9 +1311,9 @@ private:
     logAllUnhandledErrors(std::move(Err), errs(), "JIT session error: ");
   }
 
-  static void
-  materializeOnCurrentThread(JITDylib &JD,
-                             std::unique_ptr<MaterializationUnit> MU) {
+  static void materializeOnCurrentThread(
+      JITDylib &JD, std::unique_ptr<MaterializationUnit> MU,
+      MaterializationPriority Priority) {
     MU->doMaterialize(JD);
   }
 
@@ -1276,16 +1328,21 @@ private:
   std::unique_ptr<Platform> P;
   VModuleKey LastKey = 0;
   ErrorReporter ReportError = logErrorsToStdErr;
-  DispatchMaterializationFunction DispatchMaterialization =
+  PrioritizedDispatchMaterializationFunction DispatchMaterialization =
       materializeOnCurrentThread;
+  PromoteMaterializationFunction PromoteMaterialization;
 
   std::vector<std::unique_ptr<JITDylib>> JDs;
 
   // FIXME: Remove this (and runOutstandingMUs) once the linking layer works
   //        with callbacks from asynchronous queries.
+  struct OutstandingMU {
+    JITDylib *JD;
+    std::unique_ptr<MaterializationUnit> MU;
+    MaterializationPriority Priority;
+  };
   mutable std::recursive_mutex OutstandingMUsMutex;
-  std::vector<std::pair<JITDylib *, std::unique_ptr<MaterializationUnit>>>
-      OutstandingMUs;
+  std::vector<OutstandingMU> OutstandingMUs;
 };
 
 template <typename GeneratorT>
@@ -20,9 +20,12 @@
 #include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/ObjectTransformLayer.h"
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ThreadPool.h"
+#include <deque>
+#include <mutex>
 
 namespace llvm {
 namespace orc {
@@ -171,7 +174,8 @@ protected:
   createObjectLinkingLayer(LLJITBuilderState &S, ExecutionSession &ES);
 
   static Expected<std::unique_ptr<IRCompileLayer::IRCompiler>>
-  createCompileFunction(LLJITBuilderState &S, JITTargetMachineBuilder JTMB);
+  createCompileFunction(LLJITBuilderState &S, JITTargetMachineBuilder JTMB,
+                        ObjectCache *ObjCache);
 
   /// Create an LLJIT instance with a single compile thread.
   LLJIT(LLJITBuilderState &S, Error &Err);
@@ -182,6 +186,12 @@ protected:
 
   void recordCtorDtors(Module &M);
 
+  void dispatchToCompileThreads(JITDylib &JD,
+                                std::unique_ptr<MaterializationUnit> MU,
+                                MaterializationPriority Priority);
+
+  void promotePendingMUs(JITDylib &JD, const SymbolNameSet &Symbols);
+
   std::unique_ptr<ExecutionSession> ES;
   std::unique_ptr<PlatformSupport> PS;
 
@@ -191,8 +201,16 @@ protected:
   Triple TT;
   std::unique_ptr<ThreadPool> CompileThreads;
 
+  // Work waiting for a compile thread, by priority. Each compile task runs
+  // the most urgent pending unit rather than the one it was queued for.
+  std::mutex PendingMUsMutex;
+  using PendingMU = std::pair<JITDylib *, std::unique_ptr<MaterializationUnit>>;
+  std::deque<PendingMU> NormalPendingMUs;
+  std::deque<PendingMU> SpeculativePendingMUs;
+
   std::unique_ptr<ObjectLayer> ObjLinkingLayer;
   ObjectTransformLayer ObjTransformLayer;
+  std::unique_ptr<OnDiskObjectCache> ObjCache;
   std::unique_ptr<IRCompileLayer> CompileLayer;
   std::unique_ptr<IRTransformLayer> TransformLayer;
   std::unique_ptr<IRTransformLayer> InitHelperTransformLayer;
@@ -246,6 +264,8 @@ public:
   CompileFunctionCreator CreateCompileFunction;
   PlatformSetupFunction SetUpPlatform;
   unsigned NumCompileThreads = 0;
+  std::string ObjectCacheDir;
+  CachePruningPolicy ObjectCachePruningPolicy;
 
   /// Called prior to JIT class construcion to fix up defaults.
   Error prepareForConstruction();
@@ -305,6 +325,22 @@ public:
     return impl();
   }
 
+  /// Cache the objects compiled by the JIT in the directory Dir.
+  ///
+  /// Objects are keyed by the contents of each module and by the target
+  /// configuration, so later instances (including ones in other processes)
+  /// load previously compiled modules instead of compiling them again. The
+  /// directory is pruned according to Policy when the instance is created.
+  ///
+  /// The cache is only used by the default compile function, i.e. if
+  /// setCompileFunctionCreator is not called.
+  SetterImpl &setObjectCacheDirectory(
+      std::string Dir, CachePruningPolicy Policy = CachePruningPolicy()) {
+    impl().ObjectCacheDir = std::move(Dir);
+    impl().ObjectCachePruningPolicy = std::move(Policy);
+    return impl();
+  }
+
   /// Set up an PlatformSetupFunction.
   ///
   /// If this method is not called then setUpGenericLLVMIRPlatform
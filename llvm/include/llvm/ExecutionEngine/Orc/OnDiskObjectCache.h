@@ -0,0 +1,69 @@
+//===- OnDiskObjectCache.h - Content-addressed object cache -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps compiled objects in a directory on disk.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Error.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+class JITTargetMachineBuilder;
+
+/// An ObjectCache that stores objects in a directory, under a key computed
+/// from the contents of each module and from the target configuration used
+/// to compile it. A module that has been compiled once, by this process or
+/// by any other process using the same directory, is loaded from the cache
+/// instead of being compiled again.
+///
+/// Entries are written to a temporary file and renamed into place, so the
+/// directory may be shared by concurrently running processes.
+class OnDiskObjectCache : public ObjectCache {
+public:
+  /// Create a cache in CacheDir for objects compiled with the configuration
+  /// described by JTMB. The directory is created if it does not exist.
+  static Expected<std::unique_ptr<OnDiskObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB);
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+  /// Remove entries from the cache directory according to Policy. Returns
+  /// false if the directory could not be pruned.
+  bool prune(const CachePruningPolicy &Policy);
+
+private:
+  OnDiskObjectCache(std::string CacheDir, std::string TargetKey);
+
+  std::string getEntryPath(const Module &M) const;
+
+  std::string CacheDir;
+  std::string TargetKey;
+
+  // Code generation may modify a module, so the key of a module that was not
+  // found is computed before it is compiled and remembered until its object
+  // is available.
+  std::mutex PendingEntryPathsMutex;
+  DenseMap<const Module *, std::string> PendingEntryPaths;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
@@ -291,18 +291,29 @@ public:
       if (RemoteSegmentAddr) {
         assert(!Allocs.empty() && "No sections in allocated segment");
 
+        // The allocs are laid out contiguously (modulo alignment padding) in
+        // the remote segment, so gather them into a single buffer and send it
+        // with one WriteMem call rather than making a round trip per section.
+        JITTargetAddress SegmentStart = Allocs.front().getRemoteAddress();
+        JITTargetAddress SegmentEnd =
+            Allocs.back().getRemoteAddress() + Allocs.back().getSize();
+        std::vector<char> Contents(SegmentEnd - SegmentStart, 0);
         for (auto &Alloc : Allocs) {
           LLVM_DEBUG(dbgs() << "  copying section: "
                             << static_cast<void *>(Alloc.getLocalAddress())
                             << " -> "
                             << format("0x%016" PRIx64, Alloc.getRemoteAddress())
                             << " (" << Alloc.getSize() << " bytes)\n";);
-
-          if (Client.writeMem(Alloc.getRemoteAddress(), Alloc.getLocalAddress(),
-                              Alloc.getSize()))
-            return true;
+          assert(Alloc.getRemoteAddress() >= SegmentStart &&
+                 Alloc.getRemoteAddress() + Alloc.getSize() <= SegmentEnd &&
+                 "Alloc outside of its segment");
+          memcpy(Contents.data() + (Alloc.getRemoteAddress() - SegmentStart),
+                 Alloc.getLocalAddress(), Alloc.getSize());
         }
 
+        if (Client.writeMem(SegmentStart, Contents.data(), Contents.size()))
+          return true;
+
         LLVM_DEBUG(dbgs() << "  setting "
                           << (Permissions & sys::Memory::MF_READ ? 'R' : '-')
                           << (Permissions & sys::Memory::MF_WRITE ? 'W' : '-')
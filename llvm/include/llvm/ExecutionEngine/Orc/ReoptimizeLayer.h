@@ -0,0 +1,94 @@
+//===- ReoptimizeLayer.h - Re-optimize hot code -----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Contains the definition of a layer that counts calls to the code it emits
+// and re-optimizes hot modules in the background.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_REOPTIMIZELAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_REOPTIMIZELAYER_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/ExecutionEngine/Orc/Mangling.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/Support/ThreadPool.h"
+#include <functional>
+#include <mutex>
+
+namespace llvm {
+namespace orc {
+
+/// A layer for tiered compilation.
+///
+/// Each module emitted through this layer is instrumented with a call
+/// counter, and a copy of the uninstrumented module is kept. Once the
+/// functions of a module have been called CallThreshold times in total, the
+/// copy is passed to the Optimize function and added to the base layer on a
+/// background thread. The stubs of the module's functions are then redirected
+/// to the re-optimized code. The base layer is typically an IRCompileLayer
+/// that compiles quickly (e.g. at CodeGenOpt::None), with Optimize running an
+/// aggressive pass pipeline.
+///
+/// This layer must sit between a CompileOnDemandLayer and its base layer: the
+/// stubs that are redirected are the ones the CompileOnDemandLayer created.
+/// Modules that define global variables or aliases, whose definitions can't
+/// be duplicated, are emitted without instrumentation.
+///
+/// Instrumented code calls into the runtime defined by
+/// addReoptimizationRuntime, which must have been called for a JITDylib that
+/// the emitted code can see.
+class ReoptimizeLayer : public IRLayer {
+public:
+  /// Optimizes a module before it is recompiled.
+  using OptimizeFunction =
+      std::function<Expected<ThreadSafeModule>(ThreadSafeModule)>;
+
+  ReoptimizeLayer(ExecutionSession &ES, IRLayer &BaseLayer,
+                  CompileOnDemandLayer &CODLayer, OptimizeFunction Optimize,
+                  uint64_t CallThreshold = 1000);
+
+  /// Define the symbols called by instrumented code (__orc_reoptimizer and
+  /// __orc_reoptimize) in the given JITDylib.
+  Error addReoptimizationRuntime(JITDylib &JD, MangleAndInterner &Mangle);
+
+  void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
+
+private:
+  struct ReoptimizationCandidate {
+    JITDylib *ImplD = nullptr;
+    ThreadSafeModule TSM;
+  };
+
+  static bool canReoptimize(const Module &M);
+  void instrument(Module &M, uint64_t ModuleId);
+
+  static void reoptimizeEntryPoint(ReoptimizeLayer *L, uint64_t ModuleId);
+  Error reoptimize(uint64_t ModuleId);
+
+  IRLayer &BaseLayer;
+  CompileOnDemandLayer &CODLayer;
+  OptimizeFunction Optimize;
+  uint64_t CallThreshold;
+
+  std::mutex CandidatesMutex;
+  uint64_t NextModuleId = 0;
+  DenseMap<uint64_t, ReoptimizationCandidate> Candidates;
+
+  // Declared last so that pending re-optimizations finish before the rest of
+  // the layer is destroyed.
+  ThreadPool ReoptimizeThread;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_REOPTIMIZELAYER_H
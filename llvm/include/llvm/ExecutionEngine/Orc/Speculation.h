@@ -121,7 +121,7 @@ private:
             if (auto Err = Result.takeError())
               ES.reportError(std::move(Err));
           },
-          NoDependenciesToRegister);
+          NoDependenciesToRegister, MaterializationPriority::Speculative);
   }
 
 public:
@@ -90,6 +90,11 @@ Error setupLLVMOptimizationRemarks(LLVMContext &Context, raw_ostream &OS,
                                    bool RemarksWithHotness,
                                    unsigned RemarksHotnessThreshold = 0);
 
+/// Emit the remarks that the main remark streamer of \p Context holds back in
+/// aggregation mode. This needs to be called before the remark file is closed
+/// by clients that don't run the AsmPrinter, which does it on its own.
+void finalizeLLVMOptimizationRemarks(LLVMContext &Context);
+
 } // end namespace llvm
 
 #endif // LLVM_IR_LLVMREMARKSTREAMER_H
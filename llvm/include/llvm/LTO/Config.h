@@ -33,6 +33,42 @@ class raw_pwrite_stream;
 
 namespace lto {
 
+/// Statistics about an LTO backend task, which are passed to
+/// Config::BackendStatsHook when the task finishes. Times are wall-clock times
+/// in seconds.
+struct BackendStats {
+  /// The task ID, see Config for the meaning of tasks.
+  unsigned Task = 0;
+
+  /// The identifier of the module compiled by the task.
+  std::string ModuleID;
+
+  /// Time spent parsing and materializing the module's bitcode.
+  double ReadBitcodeTime = 0;
+
+  /// Time spent importing functions from other modules (ThinLTO-specific).
+  double ImportTime = 0;
+
+  /// Time spent in the middle-end optimizer.
+  double OptTime = 0;
+
+  /// Time spent in code generation, including splitting the module for
+  /// parallel code generation.
+  double CodeGenTime = 0;
+
+  /// Time spent computing the cache key and looking up the cache
+  /// (ThinLTO-specific).
+  double CacheLookupTime = 0;
+
+  /// The cache key of the task's object file, or empty if caching is disabled
+  /// for the task.
+  std::string CacheKey;
+
+  /// Whether the object file was found in the cache, in which case no other
+  /// work was done for the task.
+  bool CacheHit = false;
+};
+
 /// LTO configuration. A linker can configure LTO by setting fields in this data
 /// structure and passing it to the lto::LTO constructor.
 struct Config {
@@ -124,6 +160,12 @@ struct Config {
   /// Statistics output file path.
   std::string StatsFile;
 
+  /// If this field is set, the results of the cross-module import analysis
+  /// done by the thin link are cached in this directory, keyed by a hash of
+  /// the combined summary index, so that a link whose inputs haven't changed
+  /// can skip the analysis.
+  std::string ThinLinkCacheDir;
+
   /// Time trace enabled.
   bool TimeTraceEnabled = false;
 
@@ -204,6 +246,12 @@ struct Config {
       const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols)>;
   CombinedIndexHookFn CombinedIndexHook;
 
+  /// A backend stats hook is called once for each backend task that runs in
+  /// this process when the task finishes, including tasks whose object file is
+  /// found in the cache. It may be called concurrently from multiple threads.
+  using BackendStatsHookFn = std::function<void(const BackendStats &)>;
+  BackendStatsHookFn BackendStatsHook;
+
   /// This is a convenience function that configures this Config object to write
   /// temporary files named after the given OutputFileName for each of the LTO
   /// phases to disk. A client can use this function to implement -save-temps.
@@ -95,6 +95,18 @@ setupLLVMOptimizationRemarks(LLVMContext &Context, StringRef RemarksFilename,
 Expected<std::unique_ptr<ToolOutputFile>>
 setupStatsFile(StringRef StatsFilename);
 
+/// Returns an estimate of the cost of running the ThinLTO backend for a
+/// module, in units of IR instructions. This is the number of instructions in
+/// the functions defined by the module plus the number of instructions in the
+/// functions imported into it, as recorded in the summaries in \p Index.
+/// Backend jobs are started in order of decreasing cost so that a large module
+/// started last doesn't extend the critical path of the link; distributed
+/// build systems can use the same estimate to schedule their jobs.
+uint64_t
+estimateThinLTOBackendCost(const ModuleSummaryIndex &Index,
+                           const GVSummaryMapTy &DefinedGlobals,
+                           const FunctionImporter::ImportMapTy &ImportList);
+
 class LTO;
 struct SymbolResolution;
 class ThinBackendProc;
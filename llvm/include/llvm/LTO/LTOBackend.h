@@ -23,6 +23,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/Transforms/IPO/FunctionImport.h"
+#include <chrono>
 
 namespace llvm {
 
@@ -33,18 +34,42 @@ class Target;
 
 namespace lto {
 
+/// Adds the wall-clock time elapsed during its lifetime to the given field of
+/// a BackendStats object, if the object is not null.
+class BackendStatsTimer {
+  double *Seconds;
+  std::chrono::steady_clock::time_point Start;
+
+public:
+  BackendStatsTimer(BackendStats *Stats, double BackendStats::*Field)
+      : Seconds(Stats ? &(Stats->*Field) : nullptr),
+        Start(std::chrono::steady_clock::now()) {}
+  BackendStatsTimer(const BackendStatsTimer &) = delete;
+  BackendStatsTimer &operator=(const BackendStatsTimer &) = delete;
+  ~BackendStatsTimer() {
+    if (Seconds)
+      *Seconds += std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - Start)
+                      .count();
+  }
+};
+
 /// Runs a regular LTO backend. The regular LTO backend can also act as the
 /// regular LTO phase of ThinLTO, which may need to access the combined index.
 Error backend(const Config &C, AddStreamFn AddStream,
               unsigned ParallelCodeGenParallelismLevel,
               std::unique_ptr<Module> M, ModuleSummaryIndex &CombinedIndex);
 
-/// Runs a ThinLTO backend.
+/// Runs a ThinLTO backend. \p Mod may have been loaded lazily, in which case
+/// the bodies of functions that are dead according to \p CombinedIndex are
+/// dropped without being materialized. If \p Stats is not null, the time spent
+/// in each phase of the backend is added to it.
 Error thinBackend(const Config &C, unsigned Task, AddStreamFn AddStream,
                   Module &M, const ModuleSummaryIndex &CombinedIndex,
                   const FunctionImporter::ImportMapTy &ImportList,
                   const GVSummaryMapTy &DefinedGlobals,
-                  MapVector<StringRef, BitcodeModule> &ModuleMap);
+                  MapVector<StringRef, BitcodeModule> &ModuleMap,
+                  BackendStats *Stats = nullptr);
 
 Error finalizeOptimizationRemarks(
     std::unique_ptr<ToolOutputFile> DiagOutputFile);
@@ -187,8 +187,10 @@ private:
   bool layoutOnce(MCAsmLayout &Layout);
 
   /// Perform one layout iteration of the given section and return true
-  /// if any offsets were adjusted.
-  bool layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec);
+  /// if another iteration is needed. \p WasRelaxed is set if any offsets
+  /// were adjusted.
+  bool layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec,
+                         bool &WasRelaxed);
 
   /// Perform relaxation on a single fragment - returns true if the fragment
   /// changes as a result of relaxation.
@@ -255,6 +255,18 @@ protected:
   const Elf_Shdr *DotSymtabSec = nullptr; // Symbol table section.
   ArrayRef<Elf_Word> ShndxTable;
 
+  // The section indices and string tables of DotSymtabSec and DotDynSymSec,
+  // looked up once so that getSymbolName doesn't have to find and validate
+  // the string table again for every symbol. The index is 0 if the string
+  // table couldn't be read, in which case getSymbolName reports the error.
+  uint32_t DotSymtabIndex = 0;
+  uint32_t DotDynSymIndex = 0;
+  StringRef DotSymtabStrTab;
+  StringRef DotDynSymStrTab;
+
+  void cacheSymbolStringTable(const Elf_Shdr *SymTab, uint32_t &Index,
+                              StringRef &StrTab);
+
   void moveSymbolNext(DataRefImpl &Symb) const override;
   Expected<StringRef> getSymbolName(DataRefImpl Symb) const override;
   Expected<uint64_t> getSymbolAddress(DataRefImpl Symb) const override;
@@ -457,18 +469,26 @@ void ELFObjectFile<ELFT>::moveSymbolNext(DataRefImpl &Sym) const {
 template <class ELFT>
 Expected<StringRef> ELFObjectFile<ELFT>::getSymbolName(DataRefImpl Sym) const {
   const Elf_Sym *ESym = getSymbol(Sym);
-  auto SymTabOrErr = EF.getSection(Sym.d.a);
-  if (!SymTabOrErr)
-    return SymTabOrErr.takeError();
-  const Elf_Shdr *SymTableSec = *SymTabOrErr;
-  auto StrTabOrErr = EF.getSection(SymTableSec->sh_link);
-  if (!StrTabOrErr)
-    return StrTabOrErr.takeError();
-  const Elf_Shdr *StringTableSec = *StrTabOrErr;
-  auto SymStrTabOrErr = EF.getStringTable(StringTableSec);
-  if (!SymStrTabOrErr)
-    return SymStrTabOrErr.takeError();
-  Expected<StringRef> Name = ESym->getName(*SymStrTabOrErr);
+  StringRef SymStrTab;
+  if (DotSymtabIndex && Sym.d.a == DotSymtabIndex) {
+    SymStrTab = DotSymtabStrTab;
+  } else if (DotDynSymIndex && Sym.d.a == DotDynSymIndex) {
+    SymStrTab = DotDynSymStrTab;
+  } else {
+    auto SymTabOrErr = EF.getSection(Sym.d.a);
+    if (!SymTabOrErr)
+      return SymTabOrErr.takeError();
+    const Elf_Shdr *SymTableSec = *SymTabOrErr;
+    auto StrTabOrErr = EF.getSection(SymTableSec->sh_link);
+    if (!StrTabOrErr)
+      return StrTabOrErr.takeError();
+    const Elf_Shdr *StringTableSec = *StrTabOrErr;
+    auto SymStrTabOrErr = EF.getStringTable(StringTableSec);
+    if (!SymStrTabOrErr)
+      return SymStrTabOrErr.takeError();
+    SymStrTab = *SymStrTabOrErr;
+  }
+  Expected<StringRef> Name = ESym->getName(SymStrTab);
   if (Name && !Name->empty())
     return Name;
 
@@ -1001,7 +1021,25 @@ ELFObjectFile<ELFT>::ELFObjectFile(MemoryBufferRef Object, ELFFile<ELFT> EF,
           getELFType(ELFT::TargetEndianness == support::little, ELFT::Is64Bits),
           Object),
       EF(EF), DotDynSymSec(DotDynSymSec), DotSymtabSec(DotSymtabSec),
-      ShndxTable(ShndxTable) {}
+      ShndxTable(ShndxTable) {
+  cacheSymbolStringTable(DotSymtabSec, DotSymtabIndex, DotSymtabStrTab);
+  cacheSymbolStringTable(DotDynSymSec, DotDynSymIndex, DotDynSymStrTab);
+}
+
+template <class ELFT>
+void ELFObjectFile<ELFT>::cacheSymbolStringTable(const Elf_Shdr *SymTab,
+                                                 uint32_t &Index,
+                                                 StringRef &StrTab) {
+  if (!SymTab)
+    return;
+  Expected<StringRef> StrTabOrErr = EF.getStringTableForSymtab(*SymTab);
+  if (!StrTabOrErr) {
+    consumeError(StrTabOrErr.takeError());
+    return;
+  }
+  StrTab = *StrTabOrErr;
+  Index = toDRI(SymTab, 0).d.a;
+}
 
 template <class ELFT>
 ELFObjectFile<ELFT>::ELFObjectFile(ELFObjectFile<ELFT> &&Other)
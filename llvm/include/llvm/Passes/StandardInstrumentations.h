@@ -15,15 +15,20 @@
 #ifndef LLVM_PASSES_STANDARDINSTRUMENTATIONS_H
 #define LLVM_PASSES_STANDARDINSTRUMENTATIONS_H
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/PassInstrumentation.h"
 #include "llvm/IR/PassTimingInfo.h"
+#include "llvm/Support/Timer.h"
 
+#include <map>
 #include <string>
 #include <utility>
 
 namespace llvm {
 
+class Function;
 class Module;
 
 /// Instrumentation to print IR before/after passes.
@@ -53,11 +58,65 @@ private:
   bool StoreModuleDesc = false;
 };
 
+/// Instrumentation to report analyses that are computed again for an IR unit
+/// after being invalidated, together with the time spent recomputing them.
+///
+/// Each recomputation is attributed to the last pass that ran before it,
+/// which is usually the pass that did not preserve the analysis.
+class AnalysisRecomputeInstrumentation {
+public:
+  AnalysisRecomputeInstrumentation();
+  explicit AnalysisRecomputeInstrumentation(bool Enabled);
+  ~AnalysisRecomputeInstrumentation();
+
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+
+  /// Prints the recomputations, the most expensive first.
+  void print(raw_ostream &OS) const;
+
+private:
+  bool runBeforePass(StringRef PassID, Any IR);
+  void runAfterPass(StringRef PassID, Any IR);
+  void runAfterPassInvalidated(StringRef PassID);
+  const void *popPass(StringRef PassID);
+  void runBeforeAnalysis(StringRef AnalysisID, Any IR);
+  void runAfterAnalysis(StringRef AnalysisID);
+  void setLastPass(StringRef PassID);
+  void forgetDeletedFunctions(const Module &M);
+
+  struct RecomputeInfo {
+    unsigned Count = 0;
+    double WallTime = 0;
+  };
+
+  struct IRUnitInfo {
+    /// The function that a function or loop belongs to.
+    const Function *Parent = nullptr;
+    /// The analyses that have already been computed.
+    SmallVector<StringRef, 4> Analyses;
+  };
+
+  /// The passes that are running, with the IR unit they run on.
+  SmallVector<std::pair<StringRef, const void *>, 4> RunningPasses;
+  /// The analyses in the process of being computed, with the start time of
+  /// the recomputations.
+  SmallVector<std::pair<StringRef, Optional<TimeRecord>>, 4> RunningAnalyses;
+  /// The IR units that analyses have been computed for. Units are keyed by
+  /// address, so they are forgotten once deleted, before the address can be
+  /// reused.
+  DenseMap<const void *, IRUnitInfo> Computed;
+  /// Recomputations by (analysis, last pass).
+  std::map<std::pair<StringRef, StringRef>, RecomputeInfo> Recomputes;
+  StringRef LastPassID;
+  bool Enabled;
+};
+
 /// This class provides an interface to register all the standard pass
 /// instrumentations and manages their state (if any).
 class StandardInstrumentations {
   PrintIRInstrumentation PrintIR;
   TimePassesHandler TimePasses;
+  AnalysisRecomputeInstrumentation AnalysisRecomputes;
 
 public:
   StandardInstrumentations() = default;
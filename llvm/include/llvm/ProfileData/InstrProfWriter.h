@@ -56,7 +56,8 @@ public:
     addRecord(std::move(I), 1, Warn);
   }
 
-  /// Merge existing function counts from the given writer.
+  /// Merge existing function counts from the given writer. The records of
+  /// \p IPW are released as they are merged.
   void mergeRecordsFromWriter(InstrProfWriter &&IPW,
                               function_ref<void(Error)> Warn);
 
@@ -31,11 +31,16 @@
 #define LLVM_REMARKS_REMARKSTREAMER_H
 
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Remarks/Remark.h"
 #include "llvm/Remarks/RemarkSerializer.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/raw_ostream.h"
+#include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 
 namespace llvm {
 namespace remarks {
@@ -46,6 +51,23 @@ class RemarkStreamer final {
   std::unique_ptr<remarks::RemarkSerializer> RemarkSerializer;
   /// The filename that the remark diagnostics are emitted to.
   const Optional<std::string> Filename;
+  /// Only one in every SampleRate remarks of each pass is emitted.
+  unsigned SampleRate;
+  /// The number of remarks each pass has asked to emit so far.
+  StringMap<unsigned> SampleCounters;
+  /// If set, remarks are counted instead of emitted, and a summary is emitted
+  /// by finalize().
+  bool Aggregate;
+
+  /// The remarks counted so far in aggregation mode, keyed by type, pass,
+  /// remark name and function.
+  struct AggregatedRemark {
+    uint64_t Count = 0;
+    Optional<uint64_t> Hotness;
+  };
+  using AggregateKey =
+      std::tuple<remarks::Type, std::string, std::string, std::string>;
+  std::map<AggregateKey, AggregatedRemark> AggregatedRemarks;
 
 public:
   RemarkStreamer(std::unique_ptr<remarks::RemarkSerializer> RemarkSerializer,
@@ -66,6 +88,23 @@ public:
   bool matchesFilter(StringRef Str);
   /// Check if the remarks also need to have associated metadata in a section.
   bool needsSection() const;
+
+  /// Emit only one in every \p Rate remarks of each pass. The default rate
+  /// of 1 emits all the remarks.
+  void setSampleRate(unsigned Rate);
+  /// Count the remarks per type, pass, remark name and function instead of
+  /// emitting them one by one. The counts are emitted by finalize().
+  void setAggregate(bool Enable) { Aggregate = Enable; }
+  bool isAggregating() const { return Aggregate; }
+  /// Account for a remark of \p PassName, and return true if it is part of
+  /// the sample. This is meant to be checked before building the remark.
+  bool isSampled(StringRef PassName);
+  /// Emit \p R through the serializer, or count it in aggregation mode.
+  void emit(const Remark &R);
+  /// Emit the remarks counted in aggregation mode. This has to be called
+  /// before the remark metadata is serialized, and can be called more than
+  /// once.
+  void finalize();
 };
 } // end namespace remarks
 } // end namespace llvm
@@ -221,6 +221,10 @@ private:
       return Error::success();
     }
 
+    void dontNeed(uint32_t Offset, uint32_t Size) override {
+      FileBuffer->dontNeed(Offset, Size);
+    }
+
     /// Returns a pointer to the start of the buffer.
     uint8_t *getBufferStart() const { return FileBuffer->getBufferStart(); }
 
@@ -258,6 +262,10 @@ public:
 
   Error commit() override { return Impl.commit(); }
 
+  void dontNeed(uint32_t Offset, uint32_t Size) override {
+    Impl.dontNeed(Offset, Size);
+  }
+
   /// Returns a pointer to the start of the buffer.
   uint8_t *getBufferStart() const { return Impl.getBufferStart(); }
 
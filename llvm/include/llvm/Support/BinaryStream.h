@@ -82,6 +82,11 @@ public:
   /// For buffered streams, commits changes to the backing store.
   virtual Error commit() = 0;
 
+  /// Hints that the given bytes have been written and won't be accessed again
+  /// soon, so that the memory holding them can be released. The contents of
+  /// the stream are not changed.
+  virtual void dontNeed(uint32_t Offset, uint32_t Size) {}
+
   /// Return the properties of this stream.
   BinaryStreamFlags getFlags() const override { return BSF_Write; }
 
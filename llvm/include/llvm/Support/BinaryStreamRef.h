@@ -267,6 +267,9 @@ public:
 
   /// For buffered streams, commits changes to the backing store.
   Error commit();
+
+  /// Hints that the given bytes of this stream won't be accessed again soon.
+  void dontNeed(uint32_t Offset, uint32_t Size) const;
 };
 
 } // end namespace llvm
@@ -41,6 +41,21 @@ Error uncompress(StringRef InputBuffer,
 
 uint32_t crc32(StringRef Buffer);
 
+/// Compresses \p InputBuffer into raw deflate data, i.e. without the zlib
+/// header and trailer. If \p Finish is false, the output ends with a sync
+/// flush instead of a final block, so that the outputs for consecutive pieces
+/// of an input can be concatenated to form a single deflate stream.
+Error compressRaw(StringRef InputBuffer,
+                  SmallVectorImpl<char> &CompressedBuffer, int Level,
+                  bool Finish);
+
+/// Returns the Adler-32 checksum of \p Buffer, as used in zlib trailers.
+uint32_t adler32(StringRef Buffer);
+
+/// Returns the Adler-32 checksum of the concatenation of two buffers given
+/// their checksums and the size of the second buffer.
+uint32_t adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Size2);
+
 }  // End of namespace zlib
 
 } // End of namespace llvm
@@ -78,6 +78,12 @@ public:
   /// but keeps the memory mapping alive.
   virtual void discard() {}
 
+  /// Tells the operating system that the given range of the buffer, which has
+  /// already been written, won't be accessed for a while, so that the memory
+  /// backing it can be reclaimed. The contents of the buffer are preserved.
+  /// This is a no-op unless the buffer is a memory-mapped file.
+  virtual void dontNeed(size_t Offset, size_t Length) {}
+
 protected:
   FileOutputBuffer(StringRef Path) : FinalPath(Path) {}
 
@@ -1194,6 +1194,14 @@ public:
   /// behavior.
   const char *const_data() const;
 
+  /// Tell the operating system that the pages lying entirely within the range
+  /// [Offset, Offset + Length) of the mapping won't be accessed in the near
+  /// future, so that they can be dropped from the working set of the process.
+  /// The contents of the mapping are not affected; the pages are read back
+  /// from the file when they are accessed again. Does nothing for priv
+  /// mappings, whose modified pages would be lost.
+  void dontNeed(size_t Offset, size_t Length);
+
   /// \returns The minimum alignment offset must be.
   static int alignment();
 };
@@ -76,6 +76,12 @@ public:
   /// from.
   virtual StringRef getBufferIdentifier() const { return "Unknown buffer"; }
 
+  /// For a memory-mapped buffer, tell the operating system that the pages
+  /// lying entirely within [Offset, Offset + Length) of the buffer won't be
+  /// needed for a while. See sys::fs::mapped_file_region::dontNeed(). This
+  /// is a no-op for buffers that are not memory-mapped.
+  virtual void dontNeedIfMmapped(size_t Offset, size_t Length) {}
+
   /// Open the specified file as a MemoryBuffer, returning a new MemoryBuffer
   /// if successful, otherwise returning null. If FileSize is specified, this
   /// means that the client knows that the file exists and that it has the
@@ -63,23 +63,31 @@ public:
       Cond.notify_all();
   }
 
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
+
   void sync() const {
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
   }
 };
 
+/// A set of tasks that run on the default executor. Task groups may nest: a
+/// thread that waits for a group runs the pending tasks of that group itself
+/// instead of blocking, so nested groups run in parallel without running out
+/// of threads.
 class TaskGroup {
   Latch L;
-  bool Parallel;
 
 public:
-  TaskGroup();
   ~TaskGroup();
 
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  /// Wait until all tasks spawned so far have finished.
+  void sync() const;
 };
 
 const ptrdiff_t MinParallelSize = 1024;
@@ -0,0 +1,128 @@
+//===-- llvm/Support/Telemetry.h - Always-on compile-time counters -*- C++ -*-//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines TelemetryCounter, a counter that is cheap enough to be
+// bumped unconditionally in release builds. Unlike Statistic, which needs an
+// asserts build and -stats, and Timer, which needs -time-passes, telemetry
+// counters are always collected and can be exported as JSON without any
+// command line option:
+//
+//   LLVM_TELEMETRY_FILE=/tmp/telemetry.json clang -c foo.c
+//
+// appends one JSON object per process to the named file when llvm_shutdown is
+// called, which is what the tools using InitLLVM do on exit.
+//
+// Each thread accumulates into its own block of counter slots, so bumping a
+// counter never contends with other threads; the blocks are only summed when
+// the values are read.
+//
+// Counters are declared like statistics:
+//
+//   TELEMETRY_COUNTER(NumFunctionsCompiled, "Number of functions compiled");
+//   TELEMETRY_COUNTER(CodeGenTime, "Time spent in code generation (ns)");
+//
+//   ++NumFunctionsCompiled;
+//   {
+//     TelemetryTimeRegion T(CodeGenTime);
+//     ...
+//   }
+//
+// NOTE: Telemetry counters *must* be declared as global variables.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_TELEMETRY_H
+#define LLVM_SUPPORT_TELEMETRY_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace llvm {
+
+class raw_ostream;
+
+class TelemetryCounter {
+public:
+  const char *Group;
+  const char *Name;
+  const char *Desc;
+
+  /// One more than the slot this counter accumulates into, or zero until the
+  /// counter is registered by its first update.
+  std::atomic<unsigned> Slot;
+
+  TelemetryCounter(const char *Group, const char *Name, const char *Desc)
+      : Group(Group), Name(Name), Desc(Desc), Slot(0) {}
+
+  const char *getGroup() const { return Group; }
+  const char *getName() const { return Name; }
+  const char *getDesc() const { return Desc; }
+
+  /// Add \p V to the calling thread's share of this counter.
+  void add(uint64_t V);
+
+  /// Return the sum of the updates made by all threads so far.
+  uint64_t getValue() const;
+
+  TelemetryCounter &operator++() {
+    add(1);
+    return *this;
+  }
+
+  TelemetryCounter &operator+=(uint64_t V) {
+    add(V);
+    return *this;
+  }
+};
+
+/// Adds the wall time spent in its scope, in nanoseconds, to a counter.
+class TelemetryTimeRegion {
+  TelemetryCounter &Counter;
+  std::chrono::steady_clock::time_point Start;
+
+public:
+  explicit TelemetryTimeRegion(TelemetryCounter &Counter)
+      : Counter(Counter), Start(std::chrono::steady_clock::now()) {}
+  TelemetryTimeRegion(const TelemetryTimeRegion &) = delete;
+  TelemetryTimeRegion &operator=(const TelemetryTimeRegion &) = delete;
+
+  ~TelemetryTimeRegion() {
+    auto Elapsed = std::chrono::steady_clock::now() - Start;
+    Counter.add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count());
+  }
+};
+
+// TELEMETRY_COUNTER - A macro to define a telemetry counter. Like STATISTIC,
+// it uses the DEBUG_TYPE of the file as the counter's group.
+#define TELEMETRY_COUNTER(VARNAME, DESC)                                       \
+  static llvm::TelemetryCounter VARNAME = {DEBUG_TYPE, #VARNAME, DESC}
+
+/// Print the counters that have been updated as a single-line JSON object:
+///
+///   {"tool":"clang","pid":1234,"counters":{"group.Name":42,...}}
+///
+/// The "tool" member is omitted if no tool name has been set.
+void PrintTelemetryJSON(raw_ostream &OS);
+
+/// Append the counters to the file named by the LLVM_TELEMETRY_FILE
+/// environment variable, if it is set. This is done automatically by
+/// llvm_shutdown; call it directly only from programs that do not shut down
+/// LLVM that way.
+void WriteTelemetryFile();
+
+/// Set the name reported as "tool" in the exported counters. InitLLVM sets it
+/// to the file name of argv[0].
+void SetTelemetryToolName(StringRef ToolName);
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_TELEMETRY_H
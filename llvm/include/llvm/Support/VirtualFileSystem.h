@@ -17,7 +17,9 @@
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Chrono.h"
@@ -25,10 +27,12 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <system_error>
@@ -404,6 +408,51 @@ private:
   virtual void anchor();
 };
 
+/// A file system that caches the results of \p status calls, including the
+/// failed ones, of the file system it wraps.
+///
+/// Compilers query the same header search paths over and over, and most of
+/// these lookups fail. With this layer, every path costs at most one stat,
+/// and opening a file known not to exist costs none. It assumes that the
+/// underlying file system does not change while the cache is used, so tools
+/// that modify files, or watch them for changes, need to call \p invalidate
+/// or \p invalidateAll. The cache is thread safe and can be shared with
+/// several workers.
+class StatCachingFileSystem : public ProxyFileSystem {
+public:
+  explicit StatCachingFileSystem(IntrusiveRefCntPtr<FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  llvm::ErrorOr<Status> status(const Twine &Path) override;
+  llvm::ErrorOr<std::unique_ptr<File>>
+  openFileForRead(const Twine &Path) override;
+
+  /// Forget what is known about \p Path, e.g. after it has been written.
+  void invalidate(const Twine &Path);
+
+  /// Forget everything.
+  void invalidateAll();
+
+  /// The number of \p status and \p openFileForRead calls answered from the
+  /// cache without going to the underlying file system.
+  unsigned getNumCacheHits() const { return NumCacheHits; }
+
+private:
+  /// Returns the key of \p Path in the cache, or an empty string for paths
+  /// that can't be made absolute, which are not cached.
+  SmallString<256> getCacheKey(const Twine &Path) const;
+
+  /// Whether \p EC says that the path does not exist, which will stay true
+  /// until the file system changes.
+  static bool isCacheableError(std::error_code EC);
+
+  void insert(StringRef Key, const llvm::ErrorOr<Status> &Entry);
+
+  mutable std::mutex CacheLock;
+  StringMap<llvm::ErrorOr<Status>> Cache;
+  std::atomic<unsigned> NumCacheHits{0};
+};
+
 namespace detail {
 
 class InMemoryDirectory;
@@ -333,6 +333,16 @@ protected:
   /// Return an efficient buffer size for the underlying output mechanism.
   virtual size_t preferred_buffer_size() const;
 
+  /// Write the \p BufferSize bytes at \p BufferPtr followed by the \p Size
+  /// bytes at \p Ptr to the underlying stream. This is used when a write that
+  /// is larger than the buffer finds the buffer non-empty, so that the buffered
+  /// bytes do not have to be topped up and flushed separately. The default
+  /// implementation calls write_impl for each piece.
+  ///
+  /// \invariant { BufferSize > 0 && Size > 0 }
+  virtual void write_vectored_impl(const char *BufferPtr, size_t BufferSize,
+                                   const char *Ptr, size_t Size);
+
   /// Return the beginning of the current stream buffer, or 0 if the stream is
   /// unbuffered.
   const char *getBufferStart() const { return OutBufStart; }
@@ -413,6 +423,10 @@ class raw_fd_ostream : public raw_pwrite_stream {
   /// See raw_ostream::write_impl.
   void write_impl(const char *Ptr, size_t Size) override;
 
+  /// See raw_ostream::write_vectored_impl.
+  void write_vectored_impl(const char *BufferPtr, size_t BufferSize,
+                           const char *Ptr, size_t Size) override;
+
   void pwrite_impl(const char *Ptr, size_t Size, uint64_t Offset) override;
 
   /// Return the current position within the stream, not counting the bytes
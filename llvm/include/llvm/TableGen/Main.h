@@ -13,6 +13,10 @@
 #ifndef LLVM_TABLEGEN_MAIN_H
 #define LLVM_TABLEGEN_MAIN_H
 
+#include "llvm/ADT/ArrayRef.h"
+#include <functional>
+#include <string>
+
 namespace llvm {
 
 class raw_ostream;
@@ -24,6 +28,23 @@ using TableGenMainFn = bool (raw_ostream &OS, RecordKeeper &Records);
 
 int TableGenMain(char *argv0, TableGenMainFn *MainFn);
 
+/// One of the files written by a TableGenMain invocation with several outputs.
+struct TableGenOutput {
+  /// The file to write, or "-" for stdout.
+  std::string Filename;
+  /// The name of the backend, used for -time-phases.
+  std::string Name;
+  /// Perform the action using Records, and write output to OS.
+  /// Returns true on error, false otherwise.
+  std::function<TableGenMainFn> MainFn;
+};
+
+/// Parse the input once and run a backend for each of \p Outputs, so that a
+/// build producing several files from the same input only pays for parsing
+/// once. The -o option is ignored, -write-if-changed applies to each output,
+/// and the -d dependency file lists all of the outputs as its targets.
+int TableGenMain(char *argv0, ArrayRef<TableGenOutput> Outputs);
+
 } // end namespace llvm
 
 #endif // LLVM_TABLEGEN_MAIN_H
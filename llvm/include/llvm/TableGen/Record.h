@@ -24,6 +24,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/SMLoc.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/TrailingObjects.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -32,6 +33,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -1705,6 +1707,25 @@ class RecordKeeper {
   std::map<std::string, Init *, std::less<>> ExtraGlobals;
   unsigned AnonCounter = 0;
 
+  // Backends ask for the definitions of the same classes over and over, and
+  // every query walks all of the defs. Remember the answers until the next
+  // def is added.
+  mutable std::map<std::string, std::vector<Record *>, std::less<>>
+      ClassRecordsMap;
+
+  // The in-place rewrites of the records that backends have made. Several
+  // backends may run on the same records, and each rewrite must only be made
+  // once.
+  std::set<std::string, std::less<>> AppliedRewrites;
+
+  // Phase timing for -time-phases. Resolution happens while parsing, so it
+  // is reported in a group of its own. The timers are declared after their
+  // groups, so that they are destroyed first.
+  std::unique_ptr<TimerGroup> TimingGroup;
+  std::unique_ptr<TimerGroup> ResolveTimingGroup;
+  std::vector<std::unique_ptr<Timer>> PhaseTimers;
+  std::unique_ptr<Timer> ResolveTimer;
+
 public:
   const RecordMap &getClasses() const { return Classes; }
   const RecordMap &getDefs() const { return Defs; }
@@ -1738,6 +1759,7 @@ public:
                                           std::move(R))).second;
     (void)Ins;
     assert(Ins && "Record already exists");
+    ClassRecordsMap.clear();
   }
 
   void addExtraGlobal(StringRef Name, Init *I) {
@@ -1749,6 +1771,32 @@ public:
 
   Init *getNewAnonymousName();
 
+  /// Note that the backend rewrite \p Name is about to be made to the
+  /// records. Returns false if it has been made already by another backend
+  /// run on the same records.
+  bool startRewrite(StringRef Name) {
+    return AppliedRewrites.insert(std::string(Name)).second;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Phase timing.
+
+  /// Start collecting the times reported by -time-phases.
+  void startPhaseTiming();
+
+  /// Start timing the phase \p Name, stopping the previous phase.
+  void startTimer(StringRef Name);
+
+  /// Stop timing the current phase.
+  void stopTimer();
+
+  /// Print the phase times and stop collecting them.
+  void stopPhaseTiming();
+
+  /// Return the timer that accumulates the time spent resolving the fields
+  /// of new definitions, or null if phase timing is off.
+  Timer *getResolveTimer() const { return ResolveTimer.get(); }
+
   //===--------------------------------------------------------------------===//
   // High-level helper methods, useful for tablegen backends...
 
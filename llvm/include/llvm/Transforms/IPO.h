@@ -212,8 +212,14 @@ ModulePass *createMergeFunctionsPass();
 
 //===----------------------------------------------------------------------===//
 /// createHotColdSplittingPass - This pass outlines cold blocks into a separate
-/// function(s).
-ModulePass *createHotColdSplittingPass();
+/// function(s). With \p RequireProfileSummary set, modules without a profile
+/// summary are left alone.
+ModulePass *createHotColdSplittingPass(bool RequireProfileSummary = false);
+
+//===----------------------------------------------------------------------===//
+/// createHotFunctionMultiVersioningPass - This pass clones hot functions for
+/// CPUs with wider vector units, and dispatches between them with an ifunc.
+ModulePass *createHotFunctionMultiVersioningPass();
 
 //===----------------------------------------------------------------------===//
 /// createPartialInliningPass - This pass inlines parts of functions.
@@ -0,0 +1,54 @@
+//===- FunctionCache.h - Cache function pipeline results --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass runs a function pass pipeline over every function in a module, and
+// caches the optimized body of each function on disk. When a later run sees a
+// function that has not changed since, the cached body is spliced back instead
+// of running the pipeline again.
+//
+// A function is keyed by a hash of the function together with the
+// declarations it refers to, the initializers of the constants it may load
+// from, the data layout, triple and module flags, and a string that the
+// client uses to describe the pipeline and the target options. Function
+// passes must not look at other function bodies or at module analyses that
+// are not part of this key.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_IPO_FUNCTIONCACHE_H
+#define LLVM_TRANSFORMS_IPO_FUNCTIONCACHE_H
+
+#include "llvm/IR/PassManager.h"
+#include <string>
+
+namespace llvm {
+
+class Module;
+
+/// Pass that runs a function pass pipeline, reusing its results for functions
+/// that are in the cache directory.
+class FunctionCachePass : public PassInfoMixin<FunctionCachePass> {
+public:
+  /// Runs \p FPM on the functions that are not in \p CacheDir. \p PipelineKey
+  /// must change whenever the output of \p FPM may change for the same input.
+  FunctionCachePass(FunctionPassManager FPM, std::string CacheDir,
+                    std::string PipelineKey)
+      : FPM(std::move(FPM)), CacheDir(std::move(CacheDir)),
+        PipelineKey(std::move(PipelineKey)) {}
+
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+
+private:
+  FunctionPassManager FPM;
+  std::string CacheDir;
+  std::string PipelineKey;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_TRANSFORMS_IPO_FUNCTIONCACHE_H
@@ -143,6 +143,11 @@ void ComputeCrossModuleImport(
     StringMap<FunctionImporter::ImportMapTy> &ImportLists,
     StringMap<FunctionImporter::ExportSetTy> &ExportLists);
 
+/// Returns a string that identifies the values of the command line options
+/// that ComputeCrossModuleImport depends on, for the keys of caches of its
+/// results.
+std::string getCrossModuleImportOptionsKey();
+
 /// Compute all the imports for the given module using the Index.
 ///
 /// \p ImportList will be populated with a map that can be passed to
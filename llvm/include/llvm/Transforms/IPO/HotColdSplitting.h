@@ -49,7 +49,8 @@ private:
                               DominatorTree &DT, BlockFrequencyInfo *BFI,
                               TargetTransformInfo &TTI,
                               OptimizationRemarkEmitter &ORE,
-                              AssumptionCache *AC, unsigned Count);
+                              AssumptionCache *AC, unsigned Count,
+                              bool IsHotFunction);
   ProfileSummaryInfo *PSI;
   function_ref<BlockFrequencyInfo *(Function &)> GetBFI;
   function_ref<TargetTransformInfo &(Function &)> GetTTI;
@@ -58,9 +59,18 @@ private:
 };
 
 /// Pass to outline cold regions.
+///
+/// With \p RequireProfileSummary set the pass leaves modules without a profile
+/// summary alone, so it can be scheduled by default and only take effect on
+/// modules that were optimized with a profile.
 class HotColdSplittingPass : public PassInfoMixin<HotColdSplittingPass> {
 public:
+  explicit HotColdSplittingPass(bool RequireProfileSummary = false)
+      : RequireProfileSummary(RequireProfileSummary) {}
   PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+
+private:
+  bool RequireProfileSummary;
 };
 
 } // end namespace llvm
@@ -0,0 +1,32 @@
+//===- HotFunctionMultiVersioning.h - Multiversion hot code -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass clones the hottest functions with loops for CPUs with wider vector
+// units, and selects the version to run when the program is loaded.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_IPO_HOTFUNCTIONMULTIVERSIONING_H
+#define LLVM_TRANSFORMS_IPO_HOTFUNCTIONMULTIVERSIONING_H
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class Module;
+
+/// Pass to multiversion hot functions for wider vector units.
+class HotFunctionMultiVersioningPass
+    : public PassInfoMixin<HotFunctionMultiVersioningPass> {
+public:
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+};
+
+} // end namespace llvm
+
+#endif // LLVM_TRANSFORMS_IPO_HOTFUNCTIONMULTIVERSIONING_H
@@ -216,6 +216,7 @@ private:
   void addLTOOptimizationPasses(legacy::PassManagerBase &PM);
   void addLateLTOOptimizationPasses(legacy::PassManagerBase &PM);
   void addPGOInstrPasses(legacy::PassManagerBase &MPM, bool IsCS);
+  void addHotColdSplittingPass(legacy::PassManagerBase &PM) const;
   void addFunctionSimplificationPasses(legacy::PassManagerBase &MPM);
 
 public:
@@ -68,6 +68,10 @@ private:
   // vector of counter load/store pairs to be register promoted.
   std::vector<LoadStorePair> PromotionCandidates;
 
+  // The load of the counter bias in the entry block of the function being
+  // lowered, when runtime counter relocation is enabled.
+  LoadInst *CounterBiasLoad = nullptr;
+
   // The start value of precise value profile range for memory intrinsic sizes.
   int64_t MemOPSizeRangeStart;
   // The end value of precise value profile range for memory intrinsic sizes.
@@ -101,8 +101,12 @@ public:
 
   /// Hash a function. Equivalent functions will have the same hash, and unequal
   /// functions will have different hashes with high probability.
+  ///
+  /// By default functions that only differ in their constants and call targets
+  /// hash alike. If \p HashConstants is true, integer constants are hashed as
+  /// well, which is only useful to find functions that are equal.
   using FunctionHash = uint64_t;
-  static FunctionHash functionHash(Function &);
+  static FunctionHash functionHash(Function &, bool HashConstants = false);
 
 protected:
   /// Start the comparison.
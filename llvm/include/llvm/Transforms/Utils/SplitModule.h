@@ -25,6 +25,12 @@ class Module;
 /// Splits the module M into N linkable partitions. The function ModuleCallback
 /// is called N times passing each individual partition as the MPart argument.
 ///
+/// If ClusterByAffinity is true, functions that call each other, especially
+/// frequently according to the profile, are kept in the same partition where
+/// possible, and partitions are balanced by the estimated cost of generating
+/// code for them. Otherwise, globals are distributed by the hash of their
+/// names.
+///
 /// FIXME: This function does not deal with the somewhat subtle symbol
 /// visibility issues around module splitting, including (but not limited to):
 ///
@@ -35,7 +41,7 @@ class Module;
 void SplitModule(
     std::unique_ptr<Module> M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
-    bool PreserveLocals = false);
+    bool PreserveLocals = false, bool ClusterByAffinity = false);
 
 } // end namespace llvm
 
@@ -84,6 +84,11 @@ STATISTIC(SearchLimitReached, "Number of times the limit to "
                               "decompose GEPs is reached");
 STATISTIC(SearchTimes, "Number of times a GEP is decomposed");
 
+/// CacheHits / CacheMisses show how often alias queries are answered from the
+/// AAQueryInfo cache. Queries made through BatchAAResults share one cache.
+STATISTIC(CacheHits, "Number of alias queries answered from the cache");
+STATISTIC(CacheMisses, "Number of alias queries not found in the cache");
+
 /// Cutoff after which to stop analysing a set of phi nodes potentially involved
 /// in a cycle. Because we are analysing 'through' phi nodes, we need to be
 /// careful with value equivalence. We use reachability to make sure a value
@@ -847,12 +852,18 @@ AliasResult BasicAAResult::alias(const MemoryLocation &LocA,
   // through this once, so just return the cached results. Notably, when this
   // happens, we don't clear the cache.
   auto CacheIt = AAQI.AliasCache.find(AAQueryInfo::LocPair(LocA, LocB));
-  if (CacheIt != AAQI.AliasCache.end())
+  if (CacheIt != AAQI.AliasCache.end()) {
+    ++CacheHits;
     return CacheIt->second;
+  }
 
   CacheIt = AAQI.AliasCache.find(AAQueryInfo::LocPair(LocB, LocA));
-  if (CacheIt != AAQI.AliasCache.end())
+  if (CacheIt != AAQI.AliasCache.end()) {
+    ++CacheHits;
     return CacheIt->second;
+  }
+
+  ++CacheMisses;
 
   AliasResult Alias = aliasCheck(LocA.Ptr, LocA.Size, LocA.AATags, LocB.Ptr,
                                  LocB.Size, LocB.AATags, AAQI);
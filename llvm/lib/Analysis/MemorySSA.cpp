@@ -1021,12 +1021,13 @@ public:
 
   using MemorySSAWalker::getClobberingMemoryAccess;
 
-  MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA, unsigned &UWL) {
+  MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA,
+                                          unsigned &UWL) override {
     return Walker->getClobberingMemoryAccessBase(MA, UWL, false);
   }
   MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA,
                                           const MemoryLocation &Loc,
-                                          unsigned &UWL) {
+                                          unsigned &UWL) override {
     return Walker->getClobberingMemoryAccessBase(MA, Loc, UWL);
   }
 
@@ -1057,12 +1058,13 @@ public:
 
   using MemorySSAWalker::getClobberingMemoryAccess;
 
-  MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA, unsigned &UWL) {
+  MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA,
+                                          unsigned &UWL) override {
     return Walker->getClobberingMemoryAccessBase(MA, UWL, true);
   }
   MemoryAccess *getClobberingMemoryAccess(MemoryAccess *MA,
                                           const MemoryLocation &Loc,
-                                          unsigned &UWL) {
+                                          unsigned &UWL) override {
     return Walker->getClobberingMemoryAccessBase(MA, Loc, UWL);
   }
 
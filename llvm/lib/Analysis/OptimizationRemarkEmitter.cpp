@@ -51,6 +51,7 @@ bool OptimizationRemarkEmitter::invalidate(
     OwnedBFI.reset();
     BFI = nullptr;
   }
+  MaxHotness = None;
   // This analysis has no state and so can be trivially preserved but it needs
   // a fresh view of BFI if it was constructed with one.
   if (BFI && Inv.invalidate<BlockFrequencyAnalysis>(F, PA))
@@ -74,6 +75,26 @@ void OptimizationRemarkEmitter::computeHotness(
     OptDiag.setHotness(computeHotness(V));
 }
 
+bool OptimizationRemarkEmitter::mayMeetHotnessThreshold() {
+  uint64_t Threshold = F->getContext().getDiagnosticsHotnessThreshold();
+  if (!Threshold)
+    return true;
+  // Without a profile, no remark has a hotness.
+  if (!BFI)
+    return false;
+
+  // The maximum is cached until the analysis is invalidated. Blocks created in
+  // the meantime either have no profile count or take it from the blocks they
+  // were split from.
+  if (!MaxHotness) {
+    MaxHotness = 0;
+    for (const BasicBlock &BB : *F)
+      MaxHotness = std::max(*MaxHotness,
+                            BFI->getBlockProfileCount(&BB).getValueOr(0));
+  }
+  return *MaxHotness >= Threshold;
+}
+
 void OptimizationRemarkEmitter::emit(
     DiagnosticInfoOptimizationBase &OptDiagBase) {
   auto &OptDiag = cast<DiagnosticInfoIROptimization>(OptDiagBase);
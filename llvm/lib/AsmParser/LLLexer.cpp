@@ -13,6 +13,7 @@
 #include "LLLexer.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/IR/DerivedTypes.h"
@@ -139,8 +140,7 @@ static void UnEscapeLexed(std::string &Str) {
 
 /// isLabelChar - Return true for [-a-zA-Z$._0-9].
 static bool isLabelChar(char C) {
-  return isalnum(static_cast<unsigned char>(C)) || C == '-' || C == '$' ||
-         C == '.' || C == '_';
+  return isAlnum(C) || C == '-' || C == '$' || C == '.' || C == '_';
 }
 
 /// isLabelTail - Return true if this pointer points to a valid end of a label.
@@ -187,7 +187,7 @@ lltok::Kind LLLexer::LexToken() {
     switch (CurChar) {
     default:
       // Handle letters: [a-zA-Z_]
-      if (isalpha(static_cast<unsigned char>(CurChar)) || CurChar == '_')
+      if (isAlpha(CurChar) || CurChar == '_')
         return LexIdentifier();
 
       return lltok::Error;
@@ -251,6 +251,39 @@ void LLLexer::SkipLineComment() {
   }
 }
 
+bool LLLexer::SkipBracedBlock() {
+  const char *Start = CurPtr - 1;
+  assert(*Start == '{' && "expected to be just past a '{'");
+  unsigned Depth = 1;
+  while (true) {
+    switch (getNextChar()) {
+    case EOF:
+      return Error(SMLoc::getFromPointer(Start), "unterminated '{'");
+    case '{':
+      ++Depth;
+      break;
+    case '}':
+      if (--Depth == 0)
+        return false;
+      break;
+    case ';':
+      SkipLineComment();
+      break;
+    case '"':
+      // Names, labels and string constants are all quoted, and can not
+      // contain a quote.
+      while (true) {
+        int CurChar = getNextChar();
+        if (CurChar == EOF)
+          return Error(SMLoc::getFromPointer(Start), "unterminated '{'");
+        if (CurChar == '"')
+          break;
+      }
+      break;
+    }
+  }
+}
+
 /// Lex all tokens that start with an @ character.
 ///   GlobalVar   @\"[^\"]*\"
 ///   GlobalVar   @[-a-zA-Z$._][-a-zA-Z$._0-9]*
@@ -317,13 +350,10 @@ lltok::Kind LLLexer::ReadString(lltok::Kind kind) {
 /// ReadVarName - Read the rest of a token containing a variable name.
 bool LLLexer::ReadVarName() {
   const char *NameStart = CurPtr;
-  if (isalpha(static_cast<unsigned char>(CurPtr[0])) ||
-      CurPtr[0] == '-' || CurPtr[0] == '$' ||
+  if (isAlpha(CurPtr[0]) || CurPtr[0] == '-' || CurPtr[0] == '$' ||
       CurPtr[0] == '.' || CurPtr[0] == '_') {
     ++CurPtr;
-    while (isalnum(static_cast<unsigned char>(CurPtr[0])) ||
-           CurPtr[0] == '-' || CurPtr[0] == '$' ||
-           CurPtr[0] == '.' || CurPtr[0] == '_')
+    while (isLabelChar(CurPtr[0]))
       ++CurPtr;
 
     StrVal.assign(NameStart, CurPtr);
@@ -335,10 +365,10 @@ bool LLLexer::ReadVarName() {
 // Lex an ID: [0-9]+. On success, the ID is stored in UIntVal and Token is
 // returned, otherwise the Error token is returned.
 lltok::Kind LLLexer::LexUIntID(lltok::Kind Token) {
-  if (!isdigit(static_cast<unsigned char>(CurPtr[0])))
+  if (!isDigit(CurPtr[0]))
     return lltok::Error;
 
-  for (++CurPtr; isdigit(static_cast<unsigned char>(CurPtr[0])); ++CurPtr)
+  for (++CurPtr; isDigit(CurPtr[0]); ++CurPtr)
     /*empty*/;
 
   uint64_t Val = atoull(TokStart + 1, CurPtr);
@@ -414,12 +444,10 @@ lltok::Kind LLLexer::LexQuote() {
 ///    !
 lltok::Kind LLLexer::LexExclaim() {
   // Lex a metadata name as a MetadataVar.
-  if (isalpha(static_cast<unsigned char>(CurPtr[0])) ||
-      CurPtr[0] == '-' || CurPtr[0] == '$' ||
+  if (isAlpha(CurPtr[0]) || CurPtr[0] == '-' || CurPtr[0] == '$' ||
       CurPtr[0] == '.' || CurPtr[0] == '_' || CurPtr[0] == '\\') {
     ++CurPtr;
-    while (isalnum(static_cast<unsigned char>(CurPtr[0])) ||
-           CurPtr[0] == '-' || CurPtr[0] == '$' ||
+    while (isAlnum(CurPtr[0]) || CurPtr[0] == '-' || CurPtr[0] == '$' ||
            CurPtr[0] == '.' || CurPtr[0] == '_' || CurPtr[0] == '\\')
       ++CurPtr;
 
@@ -444,58 +472,19 @@ lltok::Kind LLLexer::LexHash() {
   return LexUIntID(lltok::AttrGrpID);
 }
 
-/// Lex a label, integer type, keyword, or hexadecimal integer constant.
-///    Label           [-a-zA-Z$._0-9]+:
-///    IntegerType     i[0-9]+
-///    Keyword         sdiv, float, ...
-///    HexIntConstant  [us]0x[0-9A-Fa-f]+
-lltok::Kind LLLexer::LexIdentifier() {
-  const char *StartChar = CurPtr;
-  const char *IntEnd = CurPtr[-1] == 'i' ? nullptr : StartChar;
-  const char *KeywordEnd = nullptr;
-
-  for (; isLabelChar(*CurPtr); ++CurPtr) {
-    // If we decide this is an integer, remember the end of the sequence.
-    if (!IntEnd && !isdigit(static_cast<unsigned char>(*CurPtr)))
-      IntEnd = CurPtr;
-    if (!KeywordEnd && !isalnum(static_cast<unsigned char>(*CurPtr)) &&
-        *CurPtr != '_')
-      KeywordEnd = CurPtr;
-  }
-
-  // If we stopped due to a colon, unless we were directed to ignore it,
-  // this really is a label.
-  if (!IgnoreColonInIdentifiers && *CurPtr == ':') {
-    StrVal.assign(StartChar-1, CurPtr++);
-    return lltok::LabelStr;
-  }
-
-  // Otherwise, this wasn't a label.  If this was valid as an integer type,
-  // return it.
-  if (!IntEnd) IntEnd = CurPtr;
-  if (IntEnd != StartChar) {
-    CurPtr = IntEnd;
-    uint64_t NumBits = atoull(StartChar, CurPtr);
-    if (NumBits < IntegerType::MIN_INT_BITS ||
-        NumBits > IntegerType::MAX_INT_BITS) {
-      Error("bitwidth for integer type out of range!");
-      return lltok::Error;
-    }
-    TyVal = IntegerType::get(Context, NumBits);
-    return lltok::Type;
-  }
-
-  // Otherwise, this was a letter sequence.  See which keyword this is.
-  if (!KeywordEnd) KeywordEnd = CurPtr;
-  CurPtr = KeywordEnd;
-  --StartChar;
-  StringRef Keyword(StartChar, CurPtr - StartChar);
+namespace {
+/// The token a keyword lexes to. Value is the opcode of an instruction keyword
+/// or the type ID of a type keyword, and zero for other keywords.
+struct KeywordInfo {
+  lltok::Kind Kind;
+  unsigned Value;
+};
+} // end anonymous namespace
 
-#define KEYWORD(STR)                                                           \
-  do {                                                                         \
-    if (Keyword == #STR)                                                       \
-      return lltok::kw_##STR;                                                  \
-  } while (false)
+/// addKeywords - Add the keywords that LexIdentifier recognizes to \p Keywords.
+/// When a keyword is listed twice, the first entry wins.
+static void addKeywords(StringMap<KeywordInfo> &Keywords) {
+#define KEYWORD(STR) Keywords.insert({#STR, {lltok::kw_##STR, 0}})
 
   KEYWORD(true);    KEYWORD(false);
   KEYWORD(declare); KEYWORD(define);
@@ -809,35 +798,25 @@ lltok::Kind LLLexer::LexIdentifier() {
 
   // Keywords for types.
 #define TYPEKEYWORD(STR, LLVMTY)                                               \
-  do {                                                                         \
-    if (Keyword == STR) {                                                      \
-      TyVal = LLVMTY;                                                          \
-      return lltok::Type;                                                      \
-    }                                                                          \
-  } while (false)
-
-  TYPEKEYWORD("void",      Type::getVoidTy(Context));
-  TYPEKEYWORD("half",      Type::getHalfTy(Context));
-  TYPEKEYWORD("float",     Type::getFloatTy(Context));
-  TYPEKEYWORD("double",    Type::getDoubleTy(Context));
-  TYPEKEYWORD("x86_fp80",  Type::getX86_FP80Ty(Context));
-  TYPEKEYWORD("fp128",     Type::getFP128Ty(Context));
-  TYPEKEYWORD("ppc_fp128", Type::getPPC_FP128Ty(Context));
-  TYPEKEYWORD("label",     Type::getLabelTy(Context));
-  TYPEKEYWORD("metadata",  Type::getMetadataTy(Context));
-  TYPEKEYWORD("x86_mmx",   Type::getX86_MMXTy(Context));
-  TYPEKEYWORD("token",     Type::getTokenTy(Context));
+  Keywords.insert({STR, {lltok::Type, Type::LLVMTY}})
+
+  TYPEKEYWORD("void",      VoidTyID);
+  TYPEKEYWORD("half",      HalfTyID);
+  TYPEKEYWORD("float",     FloatTyID);
+  TYPEKEYWORD("double",    DoubleTyID);
+  TYPEKEYWORD("x86_fp80",  X86_FP80TyID);
+  TYPEKEYWORD("fp128",     FP128TyID);
+  TYPEKEYWORD("ppc_fp128", PPC_FP128TyID);
+  TYPEKEYWORD("label",     LabelTyID);
+  TYPEKEYWORD("metadata",  MetadataTyID);
+  TYPEKEYWORD("x86_mmx",   X86_MMXTyID);
+  TYPEKEYWORD("token",     TokenTyID);
 
 #undef TYPEKEYWORD
 
   // Keywords for instructions.
 #define INSTKEYWORD(STR, Enum)                                                 \
-  do {                                                                         \
-    if (Keyword == #STR) {                                                     \
-      UIntVal = Instruction::Enum;                                             \
-      return lltok::kw_##STR;                                                  \
-    }                                                                          \
-  } while (false)
+  Keywords.insert({#STR, {lltok::kw_##STR, Instruction::Enum}})
 
   INSTKEYWORD(fneg,  FNeg);
 
@@ -899,6 +878,103 @@ lltok::Kind LLLexer::LexIdentifier() {
   INSTKEYWORD(freeze,       Freeze);
 
 #undef INSTKEYWORD
+}
+
+/// getKeywords - Return the table of keywords that LexIdentifier recognizes.
+/// Looking a keyword up is much cheaper than comparing it against each of the
+/// several hundred keywords in turn.
+static const StringMap<KeywordInfo> &getKeywords() {
+  static const StringMap<KeywordInfo> Keywords = [] {
+    StringMap<KeywordInfo> Table;
+    addKeywords(Table);
+    return Table;
+  }();
+  return Keywords;
+}
+
+/// getDecimalAPSInt - Return the same value as APSInt(Str) for the decimal
+/// integer \p Str, without going through APInt's string parsing for the
+/// literals that fit in 64 bits.
+static APSInt getDecimalAPSInt(StringRef Str) {
+  bool IsNegative = Str[0] == '-';
+  StringRef Digits = Str.drop_front(IsNegative);
+  if (Digits.size() > 18)
+    return APSInt(Str);
+
+  uint64_t Val = 0;
+  for (char C : Digits)
+    Val = Val * 10 + (C - '0');
+
+  // Match the width and truncation of APSInt(StringRef).
+  unsigned NumBits = ((Str.size() * 64) / 19) + 2;
+  APInt Tmp(NumBits, IsNegative ? -Val : Val, /*isSigned=*/true);
+  if (IsNegative) {
+    unsigned MinBits = Tmp.getMinSignedBits();
+    if (MinBits > 0 && MinBits < NumBits)
+      Tmp = Tmp.trunc(MinBits);
+    return APSInt(Tmp, /*isUnsigned=*/false);
+  }
+  unsigned ActiveBits = Tmp.getActiveBits();
+  if (ActiveBits > 0 && ActiveBits < NumBits)
+    Tmp = Tmp.trunc(ActiveBits);
+  return APSInt(Tmp, /*isUnsigned=*/true);
+}
+
+/// Lex a label, integer type, keyword, or hexadecimal integer constant.
+///    Label           [-a-zA-Z$._0-9]+:
+///    IntegerType     i[0-9]+
+///    Keyword         sdiv, float, ...
+///    HexIntConstant  [us]0x[0-9A-Fa-f]+
+lltok::Kind LLLexer::LexIdentifier() {
+  const char *StartChar = CurPtr;
+  const char *IntEnd = CurPtr[-1] == 'i' ? nullptr : StartChar;
+  const char *KeywordEnd = nullptr;
+
+  for (; isLabelChar(*CurPtr); ++CurPtr) {
+    // If we decide this is an integer, remember the end of the sequence.
+    if (!IntEnd && !isDigit(*CurPtr))
+      IntEnd = CurPtr;
+    if (!KeywordEnd && !isAlnum(*CurPtr) && *CurPtr != '_')
+      KeywordEnd = CurPtr;
+  }
+
+  // If we stopped due to a colon, unless we were directed to ignore it,
+  // this really is a label.
+  if (!IgnoreColonInIdentifiers && *CurPtr == ':') {
+    StrVal.assign(StartChar-1, CurPtr++);
+    return lltok::LabelStr;
+  }
+
+  // Otherwise, this wasn't a label.  If this was valid as an integer type,
+  // return it.
+  if (!IntEnd) IntEnd = CurPtr;
+  if (IntEnd != StartChar) {
+    CurPtr = IntEnd;
+    uint64_t NumBits = atoull(StartChar, CurPtr);
+    if (NumBits < IntegerType::MIN_INT_BITS ||
+        NumBits > IntegerType::MAX_INT_BITS) {
+      Error("bitwidth for integer type out of range!");
+      return lltok::Error;
+    }
+    TyVal = IntegerType::get(Context, NumBits);
+    return lltok::Type;
+  }
+
+  // Otherwise, this was a letter sequence.  See which keyword this is.
+  if (!KeywordEnd) KeywordEnd = CurPtr;
+  CurPtr = KeywordEnd;
+  --StartChar;
+  StringRef Keyword(StartChar, CurPtr - StartChar);
+
+  auto KW = getKeywords().find(Keyword);
+  if (KW != getKeywords().end()) {
+    const KeywordInfo &Info = KW->second;
+    if (Info.Kind == lltok::Type)
+      TyVal = Type::getPrimitiveType(Context, Type::TypeID(Info.Value));
+    else if (Info.Value)
+      UIntVal = Info.Value;
+    return Info.Kind;
+  }
 
 #define DWKEYWORD(TYPE, TOKEN)                                                 \
   do {                                                                         \
@@ -1047,8 +1123,7 @@ lltok::Kind LLLexer::Lex0x() {
 ///    HexPPC128Constant 0xM[0-9A-Fa-f]+
 lltok::Kind LLLexer::LexDigitOrNegative() {
   // If the letter after the negative is not a number, this is probably a label.
-  if (!isdigit(static_cast<unsigned char>(TokStart[0])) &&
-      !isdigit(static_cast<unsigned char>(CurPtr[0]))) {
+  if (!isDigit(TokStart[0]) && !isDigit(CurPtr[0])) {
     // Okay, this is not a number after the -, it's probably a label.
     if (const char *End = isLabelTail(CurPtr)) {
       StrVal.assign(TokStart, End-1);
@@ -1062,11 +1137,11 @@ lltok::Kind LLLexer::LexDigitOrNegative() {
   // At this point, it is either a label, int or fp constant.
 
   // Skip digits, we have at least one.
-  for (; isdigit(static_cast<unsigned char>(CurPtr[0])); ++CurPtr)
+  for (; isDigit(CurPtr[0]); ++CurPtr)
     /*empty*/;
 
   // Check if this is a fully-numeric label:
-  if (isdigit(TokStart[0]) && CurPtr[0] == ':') {
+  if (isDigit(TokStart[0]) && CurPtr[0] == ':') {
     uint64_t Val = atoull(TokStart, CurPtr);
     ++CurPtr; // Skip the colon.
     if ((unsigned)Val != Val)
@@ -1089,21 +1164,21 @@ lltok::Kind LLLexer::LexDigitOrNegative() {
   if (CurPtr[0] != '.') {
     if (TokStart[0] == '0' && TokStart[1] == 'x')
       return Lex0x();
-    APSIntVal = APSInt(StringRef(TokStart, CurPtr - TokStart));
+    APSIntVal = getDecimalAPSInt(StringRef(TokStart, CurPtr - TokStart));
     return lltok::APSInt;
   }
 
   ++CurPtr;
 
   // Skip over [0-9]*([eE][-+]?[0-9]+)?
-  while (isdigit(static_cast<unsigned char>(CurPtr[0]))) ++CurPtr;
+  while (isDigit(CurPtr[0])) ++CurPtr;
 
   if (CurPtr[0] == 'e' || CurPtr[0] == 'E') {
-    if (isdigit(static_cast<unsigned char>(CurPtr[1])) ||
+    if (isDigit(CurPtr[1]) ||
         ((CurPtr[1] == '-' || CurPtr[1] == '+') &&
-          isdigit(static_cast<unsigned char>(CurPtr[2])))) {
+          isDigit(CurPtr[2]))) {
       CurPtr += 2;
-      while (isdigit(static_cast<unsigned char>(CurPtr[0]))) ++CurPtr;
+      while (isDigit(CurPtr[0])) ++CurPtr;
     }
   }
 
@@ -1117,11 +1192,11 @@ lltok::Kind LLLexer::LexDigitOrNegative() {
 lltok::Kind LLLexer::LexPositive() {
   // If the letter after the negative is a number, this is probably not a
   // label.
-  if (!isdigit(static_cast<unsigned char>(CurPtr[0])))
+  if (!isDigit(CurPtr[0]))
     return lltok::Error;
 
   // Skip digits.
-  for (++CurPtr; isdigit(static_cast<unsigned char>(CurPtr[0])); ++CurPtr)
+  for (++CurPtr; isDigit(CurPtr[0]); ++CurPtr)
     /*empty*/;
 
   // At this point, we need a '.'.
@@ -1133,14 +1208,14 @@ lltok::Kind LLLexer::LexPositive() {
   ++CurPtr;
 
   // Skip over [0-9]*([eE][-+]?[0-9]+)?
-  while (isdigit(static_cast<unsigned char>(CurPtr[0]))) ++CurPtr;
+  while (isDigit(CurPtr[0])) ++CurPtr;
 
   if (CurPtr[0] == 'e' || CurPtr[0] == 'E') {
-    if (isdigit(static_cast<unsigned char>(CurPtr[1])) ||
+    if (isDigit(CurPtr[1]) ||
         ((CurPtr[1] == '-' || CurPtr[1] == '+') &&
-        isdigit(static_cast<unsigned char>(CurPtr[2])))) {
+        isDigit(CurPtr[2]))) {
       CurPtr += 2;
-      while (isdigit(static_cast<unsigned char>(CurPtr[0]))) ++CurPtr;
+      while (isDigit(CurPtr[0])) ++CurPtr;
     }
   }
 
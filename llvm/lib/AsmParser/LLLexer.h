@@ -55,6 +55,9 @@ namespace llvm {
 
     typedef SMLoc LocTy;
     LocTy getLoc() const { return SMLoc::getFromPointer(TokStart); }
+    /// Continue lexing from \p Loc, which must be the start of a token that
+    /// was lexed earlier.
+    void setLoc(LocTy Loc) { CurPtr = Loc.getPointer(); }
     lltok::Kind getKind() const { return CurKind; }
     const std::string &getStrVal() const { return StrVal; }
     Type *getTyVal() const { return TyVal; }
@@ -66,6 +69,11 @@ namespace llvm {
       IgnoreColonInIdentifiers = val;
     }
 
+    /// Skip to just past the '}' matching the '{' that was just lexed, without
+    /// lexing the tokens in between. The next call to Lex returns the token
+    /// after the '}'. Returns true on error.
+    bool SkipBracedBlock();
+
     bool Error(LocTy ErrorLoc, const Twine &Msg) const;
     bool Error(const Twine &Msg) const { return Error(getLoc(), Msg); }
 
@@ -74,6 +74,58 @@ bool LLParser::Run() {
          ValidateEndOfIndex();
 }
 
+bool LLParser::materializeFunction(Function &F) {
+  // A client may have deleted the body without materializing it.
+  if (!F.isMaterializable() || !DeferredFunctionBodies.count(&F))
+    return false;
+  if (ParseDeferredFunctionBody(F) || ParseDeferredBlockAddressTargets())
+    return true;
+
+  ResolveForwardRefAttrGroups();
+  if (ValidateForwardReferences())
+    return true;
+  UpgradeTBAATags();
+  UpgradeMaterializedIntrinsicCalls();
+  return false;
+}
+
+bool LLParser::materializeAllFunctions() {
+  for (Function &F : *M)
+    if (materializeFunction(F))
+      return true;
+
+  // Now that no body refers to the old intrinsics, remove them.
+  for (auto &I : UpgradedIntrinsics) {
+    if (!I.first->use_empty())
+      I.first->replaceAllUsesWith(I.second);
+    I.first->eraseFromParent();
+  }
+  UpgradedIntrinsics.clear();
+  UpgradedIntrinsicNames.clear();
+  for (auto &I : RemangledIntrinsics) {
+    I.first->replaceAllUsesWith(I.second);
+    I.first->eraseFromParent();
+  }
+  RemangledIntrinsics.clear();
+
+  if (LazyFunctionBodies && UpgradeDebugInfo)
+    llvm::UpgradeDebugInfo(*M);
+  LazyFunctionBodies = false;
+  return false;
+}
+
+std::vector<StructType *> LLParser::getIdentifiedStructTypes() const {
+  std::vector<StructType *> Types;
+  for (const auto &I : NamedTypes)
+    if (auto *STy = dyn_cast<StructType>(I.second.first))
+      Types.push_back(STy);
+  for (const auto &I : NumberedTypes)
+    if (auto *STy = dyn_cast<StructType>(I.second.first))
+      if (!STy->isLiteral())
+        Types.push_back(STy);
+  return Types;
+}
+
 bool LLParser::parseStandaloneConstantValue(Constant *&C,
                                             const SlotMapping *Slots) {
   restoreParsingState(Slots);
@@ -121,6 +173,81 @@ void LLParser::restoreParsingState(const SlotMapping *Slots) {
 bool LLParser::ValidateEndOfModule() {
   if (!M)
     return false;
+  // The bodies that are referenced by blockaddress constants have to be parsed
+  // now, to replace the placeholders.
+  if (LazyFunctionBodies && ParseDeferredBlockAddressTargets())
+    return true;
+
+  ResolveForwardRefAttrGroups();
+  if (ValidateForwardReferences())
+    return true;
+
+  // Resolve metadata cycles.
+  for (auto &N : NumberedMetadata) {
+    if (N.second && !N.second->isResolved())
+      N.second->resolveCycles();
+  }
+
+  UpgradeTBAATags();
+
+  if (LazyFunctionBodies) {
+    // Calls in bodies that have not been parsed yet refer to the old
+    // intrinsics, so keep them until all bodies are. This follows the lazy
+    // bitcode reader.
+    for (Function &F : *M) {
+      std::string Name = std::string(F.getName());
+      Function *NewFn;
+      if (UpgradeIntrinsicFunction(&F, NewFn)) {
+        UpgradedIntrinsics[&F] = NewFn;
+        if (F.getName() != Name)
+          UpgradedIntrinsicNames[Name] = &F;
+      } else if (auto Remangled = Intrinsic::remangleIntrinsicFunction(&F))
+        RemangledIntrinsics[&F] = Remangled.getValue();
+    }
+    UpgradeMaterializedIntrinsicCalls();
+  } else {
+    // Look for intrinsic functions and CallInst that need to be upgraded
+    for (Module::iterator FI = M->begin(), FE = M->end(); FI != FE; )
+      UpgradeCallsToIntrinsic(&*FI++); // must be post-increment, as we remove
+
+    // Some types could be renamed during loading if several modules are
+    // loaded in the same LLVMContext (LTO scenario). In this case we should
+    // remangle intrinsics names as well.
+    for (Module::iterator FI = M->begin(), FE = M->end(); FI != FE; ) {
+      Function *F = &*FI++;
+      if (auto Remangled = Intrinsic::remangleIntrinsicFunction(F)) {
+        F->replaceAllUsesWith(Remangled.getValue());
+        F->eraseFromParent();
+      }
+    }
+
+    // With lazy bodies this runs the verifier, so it waits for
+    // materializeAllFunctions.
+    if (UpgradeDebugInfo)
+      llvm::UpgradeDebugInfo(*M);
+  }
+
+  UpgradeModuleFlags(*M);
+  UpgradeSectionAttributes(*M);
+
+  if (!Slots)
+    return false;
+  // Initialize the slot mapping.
+  // Because by this point we've parsed and validated everything, we can "steal"
+  // the mapping from LLParser as it doesn't need it anymore.
+  Slots->GlobalValues = std::move(NumberedVals);
+  Slots->MetadataNodes = std::move(NumberedMetadata);
+  for (const auto &I : NamedTypes)
+    Slots->NamedTypes.insert(std::make_pair(I.getKey(), I.second.first));
+  for (const auto &I : NumberedTypes)
+    Slots->Types.insert(std::make_pair(I.first, I.second.first));
+
+  return false;
+}
+
+/// ResolveForwardRefAttrGroups - Apply the attribute groups that were
+/// referenced before they were defined.
+void LLParser::ResolveForwardRefAttrGroups() {
   // Handle any function attribute group forward references.
   for (const auto &RAG : ForwardRefAttrGroups) {
     Value *V = RAG.first;
@@ -179,7 +306,12 @@ bool LLParser::ValidateEndOfModule() {
       llvm_unreachable("invalid object with forward attribute group reference");
     }
   }
+  ForwardRefAttrGroups.clear();
+}
 
+/// ValidateForwardReferences - Check that everything that was referenced has
+/// been defined.
+bool LLParser::ValidateForwardReferences() {
   // If there are entries in ForwardRefBlockAddresses at this point, the
   // function was never defined.
   if (!ForwardRefBlockAddresses.empty())
@@ -217,12 +349,10 @@ bool LLParser::ValidateEndOfModule() {
                  "use of undefined metadata '!" +
                  Twine(ForwardRefMDNodes.begin()->first) + "'");
 
-  // Resolve metadata cycles.
-  for (auto &N : NumberedMetadata) {
-    if (N.second && !N.second->isResolved())
-      N.second->resolveCycles();
-  }
+  return false;
+}
 
+void LLParser::UpgradeTBAATags() {
   for (auto *Inst : InstsWithTBAATag) {
     MDNode *MD = Inst->getMetadata(LLVMContext::MD_tbaa);
     assert(MD && "UpgradeInstWithTBAATag should have a TBAA tag");
@@ -230,41 +360,29 @@ bool LLParser::ValidateEndOfModule() {
     if (MD != UpgradedMD)
       Inst->setMetadata(LLVMContext::MD_tbaa, UpgradedMD);
   }
+  InstsWithTBAATag.clear();
+}
 
-  // Look for intrinsic functions and CallInst that need to be upgraded
-  for (Module::iterator FI = M->begin(), FE = M->end(); FI != FE; )
-    UpgradeCallsToIntrinsic(&*FI++); // must be post-increment, as we remove
-
-  // Some types could be renamed during loading if several modules are
-  // loaded in the same LLVMContext (LTO scenario). In this case we should
-  // remangle intrinsics names as well.
-  for (Module::iterator FI = M->begin(), FE = M->end(); FI != FE; ) {
-    Function *F = &*FI++;
-    if (auto Remangled = Intrinsic::remangleIntrinsicFunction(F)) {
-      F->replaceAllUsesWith(Remangled.getValue());
-      F->eraseFromParent();
+/// UpgradeMaterializedIntrinsicCalls - Upgrade the calls to old intrinsics in
+/// the function bodies that have been parsed.
+void LLParser::UpgradeMaterializedIntrinsicCalls() {
+  for (auto &I : UpgradedIntrinsics) {
+    for (auto UI = I.first->materialized_user_begin(), UE = I.first->user_end();
+         UI != UE;) {
+      User *U = *UI++;
+      if (CallInst *CI = dyn_cast<CallInst>(U))
+        UpgradeIntrinsicCall(CI, I.second);
     }
   }
 
-  if (UpgradeDebugInfo)
-    llvm::UpgradeDebugInfo(*M);
-
-  UpgradeModuleFlags(*M);
-  UpgradeSectionAttributes(*M);
-
-  if (!Slots)
-    return false;
-  // Initialize the slot mapping.
-  // Because by this point we've parsed and validated everything, we can "steal"
-  // the mapping from LLParser as it doesn't need it anymore.
-  Slots->GlobalValues = std::move(NumberedVals);
-  Slots->MetadataNodes = std::move(NumberedMetadata);
-  for (const auto &I : NamedTypes)
-    Slots->NamedTypes.insert(std::make_pair(I.getKey(), I.second.first));
-  for (const auto &I : NumberedTypes)
-    Slots->Types.insert(std::make_pair(I.first, I.second.first));
-
-  return false;
+  for (auto &I : RemangledIntrinsics) {
+    for (auto UI = I.first->materialized_use_begin(), UE = I.first->use_end();
+         UI != UE;) {
+      Use &U = *UI++;
+      if (isa<Instruction>(U.getUser()))
+        U.set(I.second);
+    }
+  }
 }
 
 /// Do final validity and sanity checks at the end of the index.
@@ -316,6 +434,13 @@ bool LLParser::ParseTopLevelEntities() {
     }
   }
   while (true) {
+    // Use-list orders refer to the values in function bodies, so every body
+    // has to be parsed from here on.
+    if (LazyFunctionBodies && (Lex.getKind() == lltok::kw_uselistorder ||
+                               Lex.getKind() == lltok::kw_uselistorder_bb))
+      if (ParseDeferredFunctionBodies())
+        return true;
+
     switch (Lex.getKind()) {
     default:         return TokError("expected top-level entity");
     case lltok::Eof: return false;
@@ -1413,6 +1538,14 @@ GlobalValue *LLParser::GetGlobalVal(const std::string &Name, Type *Ty,
   GlobalValue *Val =
     cast_or_null<GlobalValue>(M->getValueSymbolTable().lookup(Name));
 
+  // Deferred bodies refer to the intrinsics that were upgraded since by their
+  // old names.
+  if (!UpgradedIntrinsicNames.empty()) {
+    auto I = UpgradedIntrinsicNames.find(Name);
+    if (I != UpgradedIntrinsicNames.end())
+      Val = I->second;
+  }
+
   // If this is a forward reference for the value, see if we already created a
   // forward ref record.
   if (!Val) {
@@ -3268,6 +3401,9 @@ bool LLParser::ParseValID(ValID &ID, PerFunctionState *PFS) {
       F = cast<Function>(GV);
       if (F->isDeclaration())
         return Error(Fn.Loc, "cannot take blockaddress inside a declaration");
+      // If the body has not been parsed yet, resolve the block when it is.
+      if (DeferredFunctionBodies.count(F))
+        F = nullptr;
     }
 
     if (!F) {
@@ -5595,11 +5731,100 @@ bool LLParser::PerFunctionState::resolveForwardRefBlockAddresses() {
 bool LLParser::ParseFunctionBody(Function &Fn) {
   if (Lex.getKind() != lltok::lbrace)
     return TokError("expected '{' in function body");
-  Lex.Lex();  // eat the {.
 
   int FunctionNumber = -1;
   if (!Fn.hasName()) FunctionNumber = NumberedVals.size()-1;
 
+  if (!LazyFunctionBodies)
+    return ParseFunctionBodyContents(Fn, FunctionNumber);
+
+  // Remember where the body is, and skip over it.
+  DeferredFunctionBody &Body = DeferredFunctionBodies[&Fn];
+  Body.Start = Lex.getLoc();
+  Body.FunctionNumber = FunctionNumber;
+  SmallVector<std::pair<unsigned, MDNode *>, 2> MDs;
+  Fn.getAllMetadata(MDs);
+  for (const auto &MD : MDs)
+    Body.Attachments.emplace_back(MD.first, MD.second);
+  Fn.clearMetadata();
+  Fn.setIsMaterializable(true);
+
+  if (Lex.SkipBracedBlock())
+    return true;
+  Lex.Lex();
+
+  // Use-list orders in the body need every use to be parsed. Finding the word
+  // in a name or string only means the module is parsed in full.
+  StringRef Text(Body.Start.getPointer(),
+                 Lex.getLoc().getPointer() - Body.Start.getPointer());
+  if (Text.contains("uselistorder"))
+    return ParseDeferredFunctionBodies();
+  return false;
+}
+
+/// ParseDeferredFunctionBody - Parse the body of \p Fn that was skipped by
+/// ParseFunctionBody.
+bool LLParser::ParseDeferredFunctionBody(Function &Fn) {
+  auto It = DeferredFunctionBodies.find(&Fn);
+  assert(It != DeferredFunctionBodies.end() && "body was not deferred");
+  DeferredFunctionBody Body = std::move(It->second);
+  DeferredFunctionBodies.erase(It);
+
+  for (const auto &MD : Body.Attachments)
+    Fn.addMetadata(MD.first, *MD.second);
+  Fn.setIsMaterializable(false);
+
+  Lex.setLoc(Body.Start);
+  Lex.Lex();
+  return ParseFunctionBodyContents(Fn, Body.FunctionNumber);
+}
+
+/// ParseDeferredFunctionBodies - Parse all bodies that have been deferred so
+/// far, in module order, and stop deferring bodies.
+bool LLParser::ParseDeferredFunctionBodies() {
+  LocTy Loc = Lex.getLoc();
+  for (Function &F : *M)
+    if (DeferredFunctionBodies.count(&F) && ParseDeferredFunctionBody(F))
+      return true;
+  LazyFunctionBodies = false;
+
+  Lex.setLoc(Loc);
+  Lex.Lex();
+  return false;
+}
+
+/// ParseDeferredBlockAddressTargets - Parse the deferred bodies that
+/// blockaddress constants refer to.
+bool LLParser::ParseDeferredBlockAddressTargets() {
+  while (true) {
+    Function *Target = nullptr;
+    for (const auto &Ref : ForwardRefBlockAddresses) {
+      const ValID &Fn = Ref.first;
+      GlobalValue *GV = nullptr;
+      if (Fn.Kind == ValID::t_GlobalID) {
+        if (Fn.UIntVal < NumberedVals.size())
+          GV = NumberedVals[Fn.UIntVal];
+      } else {
+        GV = M->getNamedValue(Fn.StrVal);
+      }
+      auto *F = dyn_cast_or_null<Function>(GV);
+      if (F && F->isMaterializable() && DeferredFunctionBodies.count(F)) {
+        Target = F;
+        break;
+      }
+    }
+    // Anything left refers to a function that is not defined, which
+    // ValidateForwardReferences reports.
+    if (!Target)
+      return false;
+    if (ParseDeferredFunctionBody(*Target))
+      return true;
+  }
+}
+
+bool LLParser::ParseFunctionBodyContents(Function &Fn, int FunctionNumber) {
+  Lex.Lex();  // eat the {.
+
   PerFunctionState PFS(*this, Fn, FunctionNumber);
 
   // Resolve block addresses and allow basic blocks to be forward-declared
@@ -14,6 +14,7 @@
 #define LLVM_LIB_ASMPARSER_LLPARSER_H
 
 #include "LLLexer.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Attributes.h"
@@ -21,6 +22,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ModuleSummaryIndex.h"
 #include "llvm/IR/Operator.h"
+#include "llvm/IR/TrackingMDRef.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/ValueHandle.h"
 #include <map>
@@ -163,27 +165,62 @@ namespace llvm {
     /// DataLayout string to override that in LLVM assembly.
     StringRef DataLayoutStr;
 
+    /// When set, function bodies are skipped and only parsed when their
+    /// function is materialized.
+    bool LazyFunctionBodies;
+
+    /// Where to find the body of a function that has not been parsed yet.
+    struct DeferredFunctionBody {
+      /// The '{' that starts the body.
+      LocTy Start;
+      int FunctionNumber;
+      /// The metadata attached to the function, which the verifier does not
+      /// allow on a function that has not been materialized.
+      SmallVector<std::pair<unsigned, TrackingMDNodeRef>, 2> Attachments;
+    };
+    DenseMap<Function *, DeferredFunctionBody> DeferredFunctionBodies;
+
+    /// Intrinsics that need to be upgraded, and their replacements. Calls in
+    /// lazily parsed bodies are upgraded as they are parsed, and the old
+    /// declarations are removed once all bodies are.
+    DenseMap<Function *, Function *> UpgradedIntrinsics;
+    DenseMap<Function *, Function *> RemangledIntrinsics;
+    /// The names that upgraded intrinsics had, which deferred bodies use.
+    StringMap<Function *> UpgradedIntrinsicNames;
+
     std::string SourceFileName;
 
   public:
     LLParser(StringRef F, SourceMgr &SM, SMDiagnostic &Err, Module *M,
              ModuleSummaryIndex *Index, LLVMContext &Context,
              SlotMapping *Slots = nullptr, bool UpgradeDebugInfo = true,
-             StringRef DataLayoutString = "")
+             StringRef DataLayoutString = "", bool LazyFunctionBodies = false)
         : Context(Context), Lex(F, SM, Err, Context), M(M), Index(Index),
           Slots(Slots), BlockAddressPFS(nullptr),
-          UpgradeDebugInfo(UpgradeDebugInfo), DataLayoutStr(DataLayoutString) {
+          UpgradeDebugInfo(UpgradeDebugInfo), DataLayoutStr(DataLayoutString),
+          LazyFunctionBodies(LazyFunctionBodies) {
+      assert((!LazyFunctionBodies || !Slots) &&
+             "slot mappings need the whole module to be parsed");
       if (!DataLayoutStr.empty())
         M->setDataLayout(DataLayoutStr);
     }
     bool Run();
 
+    /// Parse the body of \p F, if it was deferred. Returns true on error.
+    bool materializeFunction(Function &F);
+    /// Parse all deferred function bodies, and finish upgrading the module.
+    /// Returns true on error.
+    bool materializeAllFunctions();
+
+    std::vector<StructType *> getIdentifiedStructTypes() const;
+
     bool parseStandaloneConstantValue(Constant *&C, const SlotMapping *Slots);
 
     bool parseTypeAtBeginning(Type *&Ty, unsigned &Read,
                               const SlotMapping *Slots);
 
     LLVMContext &getContext() { return Context; }
+    Module &getModule() { return *M; }
 
   private:
 
@@ -307,6 +344,10 @@ namespace llvm {
     // Top-Level Entities
     bool ParseTopLevelEntities();
     bool ValidateEndOfModule();
+    void ResolveForwardRefAttrGroups();
+    bool ValidateForwardReferences();
+    void UpgradeTBAATags();
+    void UpgradeMaterializedIntrinsicCalls();
     bool ValidateEndOfIndex();
     bool ParseTargetDefinition();
     bool ParseModuleAsm();
@@ -552,6 +593,10 @@ namespace llvm {
     bool ParseArgumentList(SmallVectorImpl<ArgInfo> &ArgList, bool &isVarArg);
     bool ParseFunctionHeader(Function *&Fn, bool isDefine);
     bool ParseFunctionBody(Function &Fn);
+    bool ParseFunctionBodyContents(Function &Fn, int FunctionNumber);
+    bool ParseDeferredFunctionBody(Function &Fn);
+    bool ParseDeferredFunctionBodies();
+    bool ParseDeferredBlockAddressTargets();
     bool ParseBasicBlock(PerFunctionState &PFS);
 
     enum TailCallType { TCT_None, TCT_Tail, TCT_MustTail };
@@ -13,8 +13,11 @@
 #include "llvm/AsmParser/Parser.h"
 #include "LLParser.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/DebugInfo.h"
+#include "llvm/IR/GVMaterializer.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ModuleSummaryIndex.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
@@ -51,6 +54,82 @@ llvm::parseAssembly(MemoryBufferRef F, SMDiagnostic &Err, LLVMContext &Context,
   return M;
 }
 
+namespace {
+/// Parses the function bodies that parseAssemblyLazily skipped.
+class LLMaterializer : public GVMaterializer {
+  SourceMgr SM;
+  SMDiagnostic Diag;
+  LLParser Parser;
+  bool StripDebugInfo = false;
+
+  Error takeDiagnostic() {
+    std::string Msg;
+    raw_string_ostream OS(Msg);
+    Diag.print(nullptr, OS, /*ShowColors=*/false);
+    return make_error<StringError>(OS.str(), inconvertibleErrorCode());
+  }
+
+public:
+  LLMaterializer(std::unique_ptr<MemoryBuffer> Buffer, Module &M)
+      : Parser(Buffer->getBuffer(), SM, Diag, &M, nullptr, M.getContext(),
+               /*Slots=*/nullptr, /*UpgradeDebugInfo=*/true,
+               /*DataLayoutString=*/"", /*LazyFunctionBodies=*/true) {
+    SM.AddNewSourceBuffer(std::move(Buffer), SMLoc());
+  }
+
+  /// Parses the module up to the function bodies. Returns true on error, with
+  /// the diagnostic in \p Err.
+  bool run(SMDiagnostic &Err) {
+    if (!Parser.Run())
+      return false;
+    Err = Diag;
+    return true;
+  }
+
+  Error materialize(GlobalValue *GV) override {
+    auto *F = dyn_cast<Function>(GV);
+    if (!F || !F->isMaterializable())
+      return Error::success();
+    if (Parser.materializeFunction(*F))
+      return takeDiagnostic();
+    if (StripDebugInfo)
+      stripDebugInfo(*F);
+    return Error::success();
+  }
+
+  Error materializeModule() override {
+    for (Function &F : Parser.getModule())
+      if (Error Err = materialize(&F))
+        return Err;
+    if (Parser.materializeAllFunctions())
+      return takeDiagnostic();
+    return Error::success();
+  }
+
+  Error materializeMetadata() override { return Error::success(); }
+
+  void setStripDebugInfo() override { StripDebugInfo = true; }
+
+  std::vector<StructType *> getIdentifiedStructTypes() const override {
+    return Parser.getIdentifiedStructTypes();
+  }
+};
+} // end anonymous namespace
+
+std::unique_ptr<Module>
+llvm::parseAssemblyLazily(std::unique_ptr<MemoryBuffer> Buffer,
+                          SMDiagnostic &Err, LLVMContext &Context) {
+  std::unique_ptr<Module> M =
+      std::make_unique<Module>(Buffer->getBufferIdentifier(), Context);
+  // Use-list order directives need the module to look materialized while it
+  // is parsed, so only install the materializer afterwards.
+  auto Materializer = std::make_unique<LLMaterializer>(std::move(Buffer), *M);
+  if (Materializer->run(Err))
+    return nullptr;
+  M->setMaterializer(Materializer.release());
+  return M;
+}
+
 std::unique_ptr<Module>
 llvm::parseAssemblyFile(StringRef Filename, SMDiagnostic &Err,
                         LLVMContext &Context, SlotMapping *Slots,
@@ -1494,8 +1494,12 @@ bool AsmPrinter::doFinalization(Module &M) {
   // Emit the remarks section contents.
   // FIXME: Figure out when is the safest time to emit this section. It should
   // not come after debug info.
-  if (remarks::RemarkStreamer *RS = M.getContext().getMainRemarkStreamer())
+  if (remarks::RemarkStreamer *RS = M.getContext().getMainRemarkStreamer()) {
+    // Flush the aggregated remarks first, so that they are part of the
+    // metadata emitted in the section.
+    RS->finalize();
     emitRemarksSection(*RS);
+  }
 
   const TargetLoweringObjectFile &TLOF = getObjFileLowering();
 
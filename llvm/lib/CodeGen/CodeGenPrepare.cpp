@@ -441,7 +441,9 @@ bool CodeGenPrepare::runOnFunction(Function &F) {
   BFI.reset(new BlockFrequencyInfo(F, *BPI, *LI));
   PSI = &getAnalysis<ProfileSummaryInfoWrapperPass>().getPSI();
   OptSize = F.hasOptSize();
-  if (ProfileGuidedSectionPrefix) {
+  // Keep the prefix of functions that were already placed, e.g. the cold code
+  // split out by HotColdSplitting.
+  if (ProfileGuidedSectionPrefix && !F.getSectionPrefix()) {
     if (PSI->isFunctionHotInCallGraph(&F, *BFI))
       F.setSectionPrefix(".hot");
     else if (PSI->isFunctionColdInCallGraph(&F, *BFI))
@@ -12,6 +12,7 @@
 
 #include "llvm/CodeGen/GlobalISel/Combiner.h"
 #include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/CodeGen/GlobalISel/CSEInfo.h"
 #include "llvm/CodeGen/GlobalISel/CombinerInfo.h"
 #include "llvm/CodeGen/GlobalISel/CSEMIRBuilder.h"
@@ -21,12 +22,26 @@
 #include "llvm/CodeGen/GlobalISel/Utils.h"
 #include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 
 #define DEBUG_TYPE "gi-combiner"
 
 using namespace llvm;
 
+STATISTIC(NumIterations, "Number of times the combiner visited a function");
+STATISTIC(NumIterationLimitHits,
+          "Number of functions that hit the combiner iteration limit");
+
+// Changed instructions are revisited through the worklist, so the extra
+// rounds over the whole function rarely find anything new but cost as much
+// as the first one.
+static cl::opt<unsigned>
+    MaxIterations("gicombiner-max-iterations", cl::Hidden, cl::init(0),
+                  cl::desc("Maximum number of times the combiner visits "
+                           "every instruction of a function (0 = until "
+                           "nothing changes)"));
+
 namespace llvm {
 cl::OptionCategory GICombinerOptionCategory(
     "GlobalISel Combiner",
@@ -116,9 +131,17 @@ bool Combiner::combineMachineInstrs(MachineFunction &MF,
 
   bool MFChanged = false;
   bool Changed;
+  unsigned Iteration = 0;
   MachineIRBuilder &B = *Builder.get();
 
   do {
+    if (MaxIterations && Iteration++ == MaxIterations) {
+      LLVM_DEBUG(dbgs() << "Combiner reached the iteration limit\n");
+      ++NumIterationLimitHits;
+      break;
+    }
+    ++NumIterations;
+
     // Collect all instructions. Do a post order traversal for basic blocks and
     // insert with list bottom up, so while we pop_back_val, we'll traverse top
     // down RPOT.
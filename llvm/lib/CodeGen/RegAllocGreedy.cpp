@@ -84,6 +84,10 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumRegionSplitsSkipped,
+          "Number of region splits skipped to bound compile time");
+STATISTIC(NumHugeFunctions,
+          "Number of functions allocated without region splitting");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -136,6 +140,16 @@ static cl::opt<bool> ConsiderLocalIntervalCost(
              "candidate when choosing the best split candidate."),
     cl::init(false));
 
+static cl::opt<unsigned> RegionSplitMaxBlocks(
+    "greedy-region-split-max-blocks", cl::Hidden, cl::init(0),
+    cl::desc("Do not try region splitting for live ranges spanning more than "
+             "this many blocks (0 = no limit)"));
+
+static cl::opt<unsigned> HugeFunctionVirtRegs(
+    "greedy-huge-function-vregs", cl::Hidden, cl::init(0),
+    cl::desc("Do not try region splitting in functions with more than this "
+             "many virtual registers (0 = no limit)"));
+
 static RegisterRegAlloc greedyRegAlloc("greedy", "greedy register allocator",
                                        createGreedyRegisterAllocator);
 
@@ -402,6 +416,10 @@ class RAGreedy : public MachineFunctionPass,
   /// by a split candidate when choosing the best split candidate.
   bool EnableAdvancedRASplitCost;
 
+  /// Whether the function is too large for region splitting. See
+  /// -greedy-huge-function-vregs.
+  bool IsHugeFunction;
+
   /// Set of broken hints that may be reconciled later because of eviction.
   SmallSetVector<LiveInterval *, 8> SetOfBrokenHints;
 
@@ -2475,11 +2493,22 @@ unsigned RAGreedy::trySplit(LiveInterval &VirtReg, AllocationOrder &Order,
 
   // First try to split around a region spanning multiple blocks. RS_Split2
   // ranges already made dubious progress with region splitting, so they go
-  // straight to single block splitting.
+  // straight to single block splitting. Region splitting is also the most
+  // expensive part of allocating huge functions and ranges, so it can be
+  // skipped for them.
+  bool SkipRegionSplit =
+      IsHugeFunction ||
+      (RegionSplitMaxBlocks &&
+       SA->getUseBlocks().size() + SA->getNumThroughBlocks() >
+           RegionSplitMaxBlocks);
   if (getStage(VirtReg) < RS_Split2) {
-    unsigned PhysReg = tryRegionSplit(VirtReg, Order, NewVRegs);
-    if (PhysReg || !NewVRegs.empty())
-      return PhysReg;
+    if (SkipRegionSplit) {
+      ++NumRegionSplitsSkipped;
+    } else {
+      unsigned PhysReg = tryRegionSplit(VirtReg, Order, NewVRegs);
+      if (PhysReg || !NewVRegs.empty())
+        return PhysReg;
+    }
   }
 
   // Then isolate blocks.
@@ -3215,6 +3244,11 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   if (VerifyEnabled)
     MF->verify(this, "Before greedy register allocator");
 
+  unsigned NumVirtRegs = mf.getRegInfo().getNumVirtRegs();
+  IsHugeFunction = HugeFunctionVirtRegs && NumVirtRegs > HugeFunctionVirtRegs;
+  if (IsHugeFunction)
+    ++NumHugeFunctions;
+
   RegAllocBase::init(getAnalysis<VirtRegMap>(),
                      getAnalysis<LiveIntervals>(),
                      getAnalysis<LiveRegMatrix>());
@@ -3222,6 +3256,10 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   MBFI = &getAnalysis<MachineBlockFrequencyInfo>();
   DomTree = &getAnalysis<MachineDominatorTree>();
   ORE = &getAnalysis<MachineOptimizationRemarkEmitterPass>().getORE();
+  bool ReportTime = ORE->allowExtraAnalysis(DEBUG_TYPE);
+  TimeRecord StartTime;
+  if (ReportTime)
+    StartTime = TimeRecord::getCurrentTime(/*Start=*/true);
   SpillerInstance.reset(createInlineSpiller(*this, *MF, *VRM));
   Loops = &getAnalysis<MachineLoopInfo>();
   Bundles = &getAnalysis<EdgeBundles>();
@@ -3250,6 +3288,23 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   postOptimization();
   reportNumberOfSplillsReloads();
 
+  if (ReportTime) {
+    double Seconds = TimeRecord::getCurrentTime(/*Start=*/false).getWallTime() -
+                     StartTime.getWallTime();
+    ORE->emit([&]() {
+      using namespace ore;
+      MachineOptimizationRemarkAnalysis R(DEBUG_TYPE, "AllocationTime",
+                                          MF->getFunction().getSubprogram(),
+                                          &MF->front());
+      R << "allocated " << NV("NumVirtRegs", NumVirtRegs)
+        << " virtual registers in " << NV("WallTime", float(Seconds))
+        << " seconds";
+      if (IsHugeFunction)
+        R << " without region splitting";
+      return R;
+    });
+  }
+
   releaseMemory();
   return true;
 }
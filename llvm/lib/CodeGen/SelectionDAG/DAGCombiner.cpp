@@ -84,6 +84,7 @@ STATISTIC(OpsNarrowed     , "Number of load/op/store narrowed");
 STATISTIC(LdStFP2Int      , "Number of fp load/store pairs transformed to int");
 STATISTIC(SlicedLoads, "Number of load sliced");
 STATISTIC(NumFPLogicOpsConv, "Number of logic ops converted to fp ops");
+STATISTIC(NumBudgetExceeded, "Number of combines stopped by the budget");
 
 static cl::opt<bool>
 CombinerGlobalAA("combiner-global-alias-analysis", cl::Hidden,
@@ -125,6 +126,11 @@ static cl::opt<unsigned> StoreMergeDependenceLimit(
     cl::desc("Limit the number of times for the same StoreNode and RootNode "
              "to bail out in store merging dependence check"));
 
+static cl::opt<unsigned> CombinerIterationsPerNode(
+    "combiner-iterations-per-node", cl::Hidden, cl::init(0),
+    cl::desc("Stop combining a DAG after visiting this many worklist entries "
+             "per node of the initial DAG (0 = no limit)"));
+
 namespace {
 
   class DAGCombiner {
@@ -698,8 +704,10 @@ namespace {
     }
 
   public:
-    /// Runs the dag combiner on all nodes in the work list
-    void Run(CombineLevel AtLevel);
+    /// Runs the dag combiner on all nodes in the work list. Returns false if
+    /// combining stopped early because the budget given by
+    /// -combiner-iterations-per-node was exhausted.
+    bool Run(CombineLevel AtLevel);
 
     SelectionDAG &getDAG() const { return DAG; }
 
@@ -1418,7 +1426,7 @@ bool DAGCombiner::recursivelyDeleteUnusedNodes(SDNode *N) {
 //  Main DAG Combiner implementation
 //===----------------------------------------------------------------------===//
 
-void DAGCombiner::Run(CombineLevel AtLevel) {
+bool DAGCombiner::Run(CombineLevel AtLevel) {
   // set the instance variables, so that the various visit routines may use it.
   Level = AtLevel;
   LegalDAG = Level >= AfterLegalizeDAG;
@@ -1431,6 +1439,13 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
   for (SDNode &Node : DAG.allnodes())
     AddToWorklist(&Node);
 
+  // Once the budget is exhausted, the worklist is still drained so that any
+  // node created by an earlier combine gets legalized, but nothing else is
+  // combined.
+  uint64_t Budget = uint64_t(CombinerIterationsPerNode) * DAG.allnodes_size();
+  uint64_t Iterations = 0;
+  bool OverBudget = false;
+
   // Create a dummy node (which is not added to allnodes), that adds a reference
   // to the root node, preventing it from being deleted, and tracking any
   // changes of the root.
@@ -1459,6 +1474,15 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
         continue;
     }
 
+    if (!OverBudget && Budget && ++Iterations > Budget) {
+      LLVM_DEBUG(dbgs() << "\nCombine budget of " << Budget
+                        << " iterations exhausted\n");
+      ++NumBudgetExceeded;
+      OverBudget = true;
+    }
+    if (OverBudget)
+      continue;
+
     LLVM_DEBUG(dbgs() << "\nCombining: "; N->dump(&DAG));
 
     // Add any operands of the new node which have not yet been combined to the
@@ -1511,6 +1535,7 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
   // If the root changed (e.g. it was a dead load, update the root).
   DAG.setRoot(Dummy.getValue());
   DAG.RemoveDeadNodes();
+  return !OverBudget;
 }
 
 SDValue DAGCombiner::visit(SDNode *N) {
@@ -21691,8 +21716,8 @@ bool DAGCombiner::findBetterNeighborChains(StoreSDNode *St) {
 }
 
 /// This is the entry point for the file.
-void SelectionDAG::Combine(CombineLevel Level, AliasAnalysis *AA,
+bool SelectionDAG::Combine(CombineLevel Level, AliasAnalysis *AA,
                            CodeGenOpt::Level OptLevel) {
   /// This is the main entry point to this class.
-  DAGCombiner(*this, AA, OptLevel).Run(Level);
+  return DAGCombiner(*this, AA, OptLevel).Run(Level);
 }
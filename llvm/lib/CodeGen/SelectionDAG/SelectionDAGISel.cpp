@@ -119,6 +119,8 @@ STATISTIC(NumDAGIselRetries,"Number of times dag isel has to try another path");
 STATISTIC(NumEntryBlocks, "Number of entry blocks encountered");
 STATISTIC(NumFastIselFailLowerArguments,
           "Number of entry blocks where fast isel failed to lower arguments");
+STATISTIC(NumLargeBlocksSourceSched,
+          "Number of blocks scheduled in source order because of their size");
 
 static cl::opt<int> EnableFastISelAbort(
     "fast-isel-abort", cl::Hidden,
@@ -133,6 +135,11 @@ static cl::opt<bool> EnableFastISelFallbackReport(
     cl::desc("Emit a diagnostic when \"fast\" instruction selection "
              "falls back to SelectionDAG."));
 
+static cl::opt<unsigned> LargeBlockSchedThreshold(
+    "sched-large-block-threshold", cl::Hidden, cl::init(0),
+    cl::desc("Schedule the DAGs of blocks with more than this many nodes in "
+             "source order to bound compile time (0 = no limit)"));
+
 static cl::opt<bool>
 UseMBPI("use-mbpi",
         cl::desc("use Machine Branch Probability Info"),
@@ -713,6 +720,21 @@ static void reportFastISelFailure(MachineFunction &MF,
   ORE.emit(R);
 }
 
+/// Emits a remark for a block on which instruction selection gave up some
+/// optimization to bound its compile time.
+static void reportCompileTimeLimit(OptimizationRemarkEmitter &ORE,
+                                   const MachineBasicBlock &MBB,
+                                   StringRef RemarkName, StringRef Msg,
+                                   size_t NumNodes) {
+  const BasicBlock *BB = MBB.getBasicBlock();
+  if (!BB)
+    return;
+  OptimizationRemarkMissed R("sdagisel", RemarkName, DebugLoc(), BB);
+  R << Msg << " in a block with " << ore::NV("NumNodes", NumNodes)
+    << " nodes (in function: " << MBB.getParent()->getName() << ")";
+  ORE.emit(R);
+}
+
 void SelectionDAGISel::SelectBasicBlock(BasicBlock::const_iterator Begin,
                                         BasicBlock::const_iterator End,
                                         bool &HadTailCall) {
@@ -783,6 +805,9 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
       getAnalysis<TargetTransformInfoWrapperPass>().getTTI(*FuncInfo->Fn);
 #endif
 
+  // Whether none of the DAG combines ran out of budget.
+  bool CombinedFully = true;
+
   // Pre-type legalization allow creation of any node types.
   CurDAG->NewNodesMustHaveLegalTypes = false;
 
@@ -812,7 +837,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   {
     NamedRegionTimer T("combine1", "DAG Combining 1", GroupName,
                        GroupDescription, TimePassesIsEnabled);
-    CurDAG->Combine(BeforeLegalizeTypes, AA, OptLevel);
+    CombinedFully &= CurDAG->Combine(BeforeLegalizeTypes, AA, OptLevel);
   }
 
 #ifndef NDEBUG
@@ -858,7 +883,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     {
       NamedRegionTimer T("combine_lt", "DAG Combining after legalize types",
                          GroupName, GroupDescription, TimePassesIsEnabled);
-      CurDAG->Combine(AfterLegalizeTypes, AA, OptLevel);
+      CombinedFully &= CurDAG->Combine(AfterLegalizeTypes, AA, OptLevel);
     }
 
 #ifndef NDEBUG
@@ -902,7 +927,7 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
     {
       NamedRegionTimer T("combine_lv", "DAG Combining after legalize vectors",
                          GroupName, GroupDescription, TimePassesIsEnabled);
-      CurDAG->Combine(AfterLegalizeVectorOps, AA, OptLevel);
+      CombinedFully &= CurDAG->Combine(AfterLegalizeVectorOps, AA, OptLevel);
     }
 
     LLVM_DEBUG(dbgs() << "Optimized vector-legalized selection DAG: "
@@ -942,9 +967,14 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   {
     NamedRegionTimer T("combine2", "DAG Combining 2", GroupName,
                        GroupDescription, TimePassesIsEnabled);
-    CurDAG->Combine(AfterLegalizeDAG, AA, OptLevel);
+    CombinedFully &= CurDAG->Combine(AfterLegalizeDAG, AA, OptLevel);
   }
 
+  if (!CombinedFully)
+    reportCompileTimeLimit(*ORE, *FuncInfo->MBB, "CombineBudgetExceeded",
+                           "DAG combining stopped early",
+                           CurDAG->allnodes_size());
+
 #ifndef NDEBUG
   if (TTI.hasBranchDivergence())
     CurDAG->VerifyDAGDiverence();
@@ -1977,9 +2007,21 @@ SelectionDAGISel::FinishBasicBlock() {
 
 /// Create the scheduler. If a specific scheduler was specified
 /// via the SchedulerRegistry, use it, otherwise select the
-/// one preferred by the target.
+/// one preferred by the target, or the source order scheduler for blocks
+/// larger than -sched-large-block-threshold.
 ///
 ScheduleDAGSDNodes *SelectionDAGISel::CreateScheduler() {
+  // Huge blocks, typically in machine-generated code, can take the
+  // heuristic schedulers seconds. Unless a scheduler was explicitly
+  // requested, schedule them in source order as at -O0.
+  if (LargeBlockSchedThreshold && !ISHeuristic.getNumOccurrences() &&
+      CurDAG->allnodes_size() > LargeBlockSchedThreshold) {
+    ++NumLargeBlocksSourceSched;
+    reportCompileTimeLimit(*ORE, *FuncInfo->MBB, "LargeBlockScheduling",
+                           "scheduled in source order",
+                           CurDAG->allnodes_size());
+    return createSourceListDAGScheduler(this, OptLevel);
+  }
   return ISHeuristic(this, OptLevel);
 }
 
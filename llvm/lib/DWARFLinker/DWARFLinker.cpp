@@ -2280,6 +2280,24 @@ bool DWARFLinker::link() {
       Options.TheAccelTableKind = AccelTableKind::Apple;
   }
 
+  // Extracting the DIEs of an object file doesn't depend on any other object
+  // file, so do it for all of them in parallel before module references are
+  // registered in serial below.
+  if (Options.Threads != 1) {
+    ThreadPool Pool(hardware_concurrency(Options.Threads));
+    for (LinkContext &OptContext : ObjectContexts) {
+      if (!OptContext.File.Dwarf ||
+          (LLVM_LIKELY(!Options.Update) &&
+           !OptContext.File.Addresses->hasValidRelocs()))
+        continue;
+      Pool.async([&OptContext]() {
+        for (const auto &CU : OptContext.File.Dwarf->compile_units())
+          CU->getUnitDIE(false);
+      });
+    }
+    Pool.wait();
+  }
+
   for (LinkContext &OptContext : ObjectContexts) {
     if (Options.Verbose) {
       if (DwarfLinkerClientID == DwarfLinkerClient::Dsymutil)
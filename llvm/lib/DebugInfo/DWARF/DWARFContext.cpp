@@ -697,6 +697,7 @@ void DWARFContext::dump(
 }
 
 DWARFCompileUnit *DWARFContext::getDWOCompileUnitForHash(uint64_t Hash) {
+  auto Lock = lock(UnitsMutex);
   parseDWOUnits(LazyParse);
 
   if (const auto &CUI = getCUIndex()) {
@@ -711,6 +712,9 @@ DWARFCompileUnit *DWARFContext::getDWOCompileUnitForHash(uint64_t Hash) {
   // built/cached lookup table could be used in that case to improve repeated
   // lookups of different CUs in the DWO.
   for (const auto &DWOCU : dwo_compile_units()) {
+    // Another thread may be setting the DWO ID while extracting the unit DIE.
+    if (ThreadSafe)
+      DWOCU->getUnitDIE();
     // Might not have parsed DWO ID yet.
     if (!DWOCU->getDWOId()) {
       if (Optional<uint64_t> DWOId =
@@ -747,6 +751,7 @@ bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts) {
 }
 
 const DWARFUnitIndex &DWARFContext::getCUIndex() {
+  auto Lock = lock(UnitsMutex);
   if (CUIndex)
     return *CUIndex;
 
@@ -758,6 +763,7 @@ const DWARFUnitIndex &DWARFContext::getCUIndex() {
 }
 
 const DWARFUnitIndex &DWARFContext::getTUIndex() {
+  auto Lock = lock(UnitsMutex);
   if (TUIndex)
     return *TUIndex;
 
@@ -779,6 +785,7 @@ DWARFGdbIndex &DWARFContext::getGdbIndex() {
 }
 
 const DWARFDebugAbbrev *DWARFContext::getDebugAbbrev() {
+  auto Lock = lock(AbbrevMutex);
   if (Abbrev)
     return Abbrev.get();
 
@@ -790,6 +797,7 @@ const DWARFDebugAbbrev *DWARFContext::getDebugAbbrev() {
 }
 
 const DWARFDebugAbbrev *DWARFContext::getDebugAbbrevDWO() {
+  auto Lock = lock(AbbrevMutex);
   if (AbbrevDWO)
     return AbbrevDWO.get();
 
@@ -814,6 +822,7 @@ const DWARFDebugLoc *DWARFContext::getDebugLoc() {
 }
 
 const DWARFDebugAranges *DWARFContext::getDebugAranges() {
+  auto Lock = lock(ArangesMutex);
   if (Aranges)
     return Aranges.get();
 
@@ -924,6 +933,7 @@ DWARFContext::getLineTableForUnit(DWARFUnit *U) {
 
 Expected<const DWARFDebugLine::LineTable *> DWARFContext::getLineTableForUnit(
     DWARFUnit *U, function_ref<void(Error)> RecoverableErrorHandler) {
+  auto Lock = lock(LineMutex);
   if (!Line)
     Line.reset(new DWARFDebugLine);
 
@@ -952,6 +962,7 @@ Expected<const DWARFDebugLine::LineTable *> DWARFContext::getLineTableForUnit(
 }
 
 void DWARFContext::parseNormalUnits() {
+  auto Lock = lock(UnitsMutex);
   if (!NormalUnits.empty())
     return;
   DObj->forEachInfoSections([&](const DWARFSection &S) {
@@ -964,6 +975,7 @@ void DWARFContext::parseNormalUnits() {
 }
 
 void DWARFContext::parseDWOUnits(bool Lazy) {
+  auto Lock = lock(UnitsMutex);
   if (!DWOUnits.empty())
     return;
   DObj->forEachInfoDWOSections([&](const DWARFSection &S) {
@@ -1340,6 +1352,7 @@ DWARFContext::getInliningInfoForAddress(object::SectionedAddress Address,
 
 std::shared_ptr<DWARFContext>
 DWARFContext::getDWOContext(StringRef AbsolutePath) {
+  auto Lock = lock(DWOFilesMutex);
   if (auto S = DWP.lock()) {
     DWARFContext *Ctxt = S->Context.get();
     return std::shared_ptr<DWARFContext>(std::move(S), Ctxt);
@@ -1382,6 +1395,7 @@ DWARFContext::getDWOContext(StringRef AbsolutePath) {
   auto S = std::make_shared<DWOFile>();
   S->File = std::move(Obj.get());
   S->Context = DWARFContext::create(*S->File.getBinary());
+  S->Context->setThreadSafe(ThreadSafe);
   *Entry = S;
   auto *Ctxt = S->Context.get();
   return std::shared_ptr<DWARFContext>(std::move(S), Ctxt);
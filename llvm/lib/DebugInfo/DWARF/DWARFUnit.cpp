@@ -431,12 +431,24 @@ void DWARFUnit::extractDIEsToVector(
                           getOffset(), DIEOffset));
 }
 
+std::unique_lock<std::recursive_mutex> DWARFUnit::lock() const {
+  if (!Context.isThreadSafe())
+    return std::unique_lock<std::recursive_mutex>();
+  return std::unique_lock<std::recursive_mutex>(Mutex);
+}
+
 void DWARFUnit::extractDIEsIfNeeded(bool CUDieOnly) {
   if (Error e = tryExtractDIEsIfNeeded(CUDieOnly))
     Context.getRecoverableErrorHandler()(std::move(e));
 }
 
 Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
+  auto Lock = lock();
+  // Appending the rest of the DIEs would move the unit DIE, which other
+  // threads may be looking at.
+  if (Context.isThreadSafe())
+    CUDieOnly = false;
+
   if ((CUDieOnly && !DieArray.empty()) ||
       DieArray.size() > 1)
     return Error::success(); // Already parsed.
@@ -554,6 +566,7 @@ Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
 }
 
 bool DWARFUnit::parseDWO() {
+  auto Lock = lock();
   if (IsDWO)
     return false;
   if (DWO.get())
@@ -610,6 +623,9 @@ bool DWARFUnit::parseDWO() {
 }
 
 void DWARFUnit::clearDIEs(bool KeepCUDie) {
+  // Other threads may still refer to the DIEs.
+  if (Context.isThreadSafe())
+    return;
   if (DieArray.size() > (unsigned)KeepCUDie) {
     DieArray.resize((unsigned)KeepCUDie);
     DieArray.shrink_to_fit();
@@ -720,6 +736,7 @@ void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
 }
 
 DWARFDie DWARFUnit::getSubroutineForAddress(uint64_t Address) {
+  auto Lock = lock();
   extractDIEsIfNeeded(false);
   if (AddrDieMap.empty())
     updateAddressDieMap(getUnitDIE());
@@ -848,12 +865,16 @@ DWARFDie DWARFUnit::getLastChild(const DWARFDebugInfoEntry *Die) {
 }
 
 const DWARFAbbreviationDeclarationSet *DWARFUnit::getAbbreviations() const {
-  if (!Abbrevs)
+  auto Lock = lock();
+  if (!Abbrevs) {
+    auto AbbrevLock = Context.lockAbbreviations();
     Abbrevs = Abbrev->getAbbreviationDeclarationSet(Header.getAbbrOffset());
+  }
   return Abbrevs;
 }
 
 llvm::Optional<object::SectionedAddress> DWARFUnit::getBaseAddress() {
+  auto Lock = lock();
   if (BaseAddr)
     return BaseAddr;
 
@@ -16,6 +16,7 @@
 #include "llvm/DebugInfo/DWARF/DWARFSection.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -208,6 +209,35 @@ unsigned DWARFVerifier::verifyUnitContents(DWARFUnit &Unit) {
   return NumUnitErrors;
 }
 
+unsigned
+DWARFVerifier::verifyUnitContentsInParallel(ArrayRef<DWARFUnit *> Units) {
+  struct UnitResult {
+    std::string Output;
+    unsigned NumErrors = 0;
+    std::map<uint64_t, std::set<uint64_t>> ReferenceToDIEOffsets;
+  };
+  std::vector<UnitResult> Results(Units.size());
+  parallel::for_each_n(parallel::par, size_t(0), Units.size(), [&](size_t I) {
+    UnitResult &Result = Results[I];
+    raw_string_ostream UnitOS(Result.Output);
+    DWARFVerifier UnitVerifier(UnitOS, DCtx, DumpOpts);
+    Result.NumErrors = UnitVerifier.verifyUnitContents(*Units[I]);
+    UnitOS.flush();
+    Result.ReferenceToDIEOffsets =
+        std::move(UnitVerifier.ReferenceToDIEOffsets);
+  });
+
+  unsigned NumErrors = 0;
+  for (UnitResult &Result : Results) {
+    OS << Result.Output;
+    NumErrors += Result.NumErrors;
+    for (auto &Pair : Result.ReferenceToDIEOffsets)
+      ReferenceToDIEOffsets[Pair.first].insert(Pair.second.begin(),
+                                               Pair.second.end());
+  }
+  return NumErrors;
+}
+
 unsigned DWARFVerifier::verifyDebugInfoCallSite(const DWARFDie &Die) {
   if (Die.getTag() != DW_TAG_call_site && Die.getTag() != DW_TAG_GNU_call_site)
     return 0;
@@ -288,6 +318,9 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
   bool hasDIE = DebugInfoData.isValidOffset(Offset);
   DWARFUnitVector TypeUnitVector;
   DWARFUnitVector CompileUnitVector;
+  // If the context can be queried concurrently, the units are verified in
+  // parallel once the whole header chain has been verified.
+  SmallVector<DWARFUnit *, 0> UnitsToVerify;
   while (hasDIE) {
     OffsetStart = Offset;
     if (!verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
@@ -326,7 +359,10 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
       }
       default: { llvm_unreachable("Invalid UnitType."); }
       }
-      NumDebugInfoErrors += verifyUnitContents(*Unit);
+      if (DCtx.isThreadSafe())
+        UnitsToVerify.push_back(Unit);
+      else
+        NumDebugInfoErrors += verifyUnitContents(*Unit);
     }
     hasDIE = DebugInfoData.isValidOffset(Offset);
     ++UnitIdx;
@@ -337,6 +373,7 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
   }
   if (!isHeaderChainValid)
     ++NumDebugInfoErrors;
+  NumDebugInfoErrors += verifyUnitContentsInParallel(UnitsToVerify);
   NumDebugInfoErrors += verifyDebugInfoReferences();
   return NumDebugInfoErrors;
 }
@@ -10,6 +10,7 @@
 #include "llvm/DebugInfo/GSYM/Header.h"
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
@@ -168,8 +169,9 @@ llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
                              "already finalized");
   Finalized = true;
 
-  // Sort function infos so we can emit sorted functions.
-  llvm::sort(Funcs.begin(), Funcs.end());
+  // Sort function infos so we can emit sorted functions. Large binaries can
+  // have millions of them, so sort in parallel.
+  parallel::sort(parallel::par, Funcs.begin(), Funcs.end());
 
   // Don't let the string table indexes change by finalizing in order.
   StrTab.finalizeInOrder();
@@ -194,56 +196,53 @@ llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
   // Note that in case of (b), we cannot include Y in the result because then
   // we wouldn't find any function for range (end of Y, end of X)
   // with binary search
+  //
+  // Entries are removed by compacting the sorted vector in place, as erasing
+  // them one at a time would be quadratic in the number of functions.
   auto NumBefore = Funcs.size();
-  auto Curr = Funcs.begin();
-  auto Prev = Funcs.end();
-  while (Curr != Funcs.end()) {
-    // Can't check for overlaps or same address ranges if we don't have a
-    // previous entry
-    if (Prev != Funcs.end()) {
-      if (Prev->Range.intersects(Curr->Range)) {
-        // Overlapping address ranges.
-        if (Prev->Range == Curr->Range) {
-          // Same address range. Check if one is from debug info and the other
-          // is from a symbol table. If so, then keep the one with debug info.
-          // Our sorting guarantees that entries with matching address ranges
-          // that have debug info are last in the sort.
-          if (*Prev == *Curr) {
-            // FunctionInfo entries match exactly (range, lines, inlines)
-            OS << "warning: duplicate function info entries for range: "
-               << Curr->Range << '\n';
-            Curr = Funcs.erase(Prev);
-          } else {
-            if (!Prev->hasRichInfo() && Curr->hasRichInfo()) {
-              // Same address range, one with no debug info (symbol) and the
-              // next with debug info. Keep the latter.
-              Curr = Funcs.erase(Prev);
-            } else {
-              OS << "warning: same address range contains different debug "
-                 << "info. Removing:\n"
-                 << *Prev << "\nIn favor of this one:\n"
-                 << *Curr << "\n";
-              Curr = Funcs.erase(Prev);
-            }
-          }
-        } else {
-          // print warnings about overlaps
-          OS << "warning: function ranges overlap:\n"
-             << *Prev << "\n"
-             << *Curr << "\n";
+  size_t Prev = 0;
+  for (size_t Curr = 1, E = Funcs.size(); Curr < E; ++Curr) {
+    bool RemovePrev = false;
+    if (Funcs[Prev].Range.intersects(Funcs[Curr].Range)) {
+      // Overlapping address ranges.
+      if (Funcs[Prev].Range == Funcs[Curr].Range) {
+        // Same address range. Check if one is from debug info and the other
+        // is from a symbol table. If so, then keep the one with debug info.
+        // Our sorting guarantees that entries with matching address ranges
+        // that have debug info are last in the sort.
+        if (Funcs[Prev] == Funcs[Curr]) {
+          // FunctionInfo entries match exactly (range, lines, inlines)
+          OS << "warning: duplicate function info entries for range: "
+             << Funcs[Curr].Range << '\n';
+        } else if (Funcs[Prev].hasRichInfo() || !Funcs[Curr].hasRichInfo()) {
+          OS << "warning: same address range contains different debug "
+             << "info. Removing:\n"
+             << Funcs[Prev] << "\nIn favor of this one:\n"
+             << Funcs[Curr] << "\n";
         }
-      } else if (Prev->Range.size() == 0 &&
-                 Curr->Range.contains(Prev->Range.Start)) {
-        OS << "warning: removing symbol:\n"
-           << *Prev << "\nKeeping:\n"
-           << *Curr << "\n";
-        Curr = Funcs.erase(Prev);
+        // Otherwise one has no debug info (symbol) and the next one has
+        // debug info. Keep the latter.
+        RemovePrev = true;
+      } else {
+        // print warnings about overlaps
+        OS << "warning: function ranges overlap:\n"
+           << Funcs[Prev] << "\n"
+           << Funcs[Curr] << "\n";
       }
+    } else if (Funcs[Prev].Range.size() == 0 &&
+               Funcs[Curr].Range.contains(Funcs[Prev].Range.Start)) {
+      OS << "warning: removing symbol:\n"
+         << Funcs[Prev] << "\nKeeping:\n"
+         << Funcs[Curr] << "\n";
+      RemovePrev = true;
     }
-    if (Curr == Funcs.end())
-      break;
-    Prev = Curr++;
+    if (!RemovePrev)
+      ++Prev;
+    if (Prev != Curr)
+      Funcs[Prev] = std::move(Funcs[Curr]);
   }
+  if (!Funcs.empty())
+    Funcs.erase(Funcs.begin() + Prev + 1, Funcs.end());
 
   // If our last function info entry doesn't have a size and if we have valid
   // text ranges, we should set the size of the last entry since any search for
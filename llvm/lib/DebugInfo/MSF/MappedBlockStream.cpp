@@ -419,3 +419,30 @@ Error WritableMappedBlockStream::writeBytes(uint32_t Offset,
 }
 
 Error WritableMappedBlockStream::commit() { return WriteInterface.commit(); }
+
+void WritableMappedBlockStream::dontNeed(uint32_t Offset, uint32_t Size) {
+  if (Offset >= getLength())
+    return;
+  uint32_t End = Offset + std::min(Size, getLength() - Offset);
+
+  // Forward the hint for each run of contiguous blocks at once.
+  uint32_t RunStart = 0;
+  uint32_t RunEnd = 0;
+  while (Offset < End) {
+    uint32_t BlockNum = Offset / getBlockSize();
+    uint32_t OffsetInBlock = Offset % getBlockSize();
+    uint32_t Len = std::min(End - Offset, getBlockSize() - OffsetInBlock);
+    uint32_t MsfOffset =
+        blockToOffset(getStreamLayout().Blocks[BlockNum], getBlockSize()) +
+        OffsetInBlock;
+    if (MsfOffset != RunEnd) {
+      if (RunStart != RunEnd)
+        WriteInterface.dontNeed(RunStart, RunEnd - RunStart);
+      RunStart = MsfOffset;
+    }
+    RunEnd = MsfOffset + Len;
+    Offset += Len;
+  }
+  if (RunStart != RunEnd)
+    WriteInterface.dontNeed(RunStart, RunEnd - RunStart);
+}
@@ -173,6 +173,10 @@ Error DbiModuleDescriptorBuilder::commit(BinaryStreamWriter &ModiWriter,
       return EC;
     if (SymbolWriter.bytesRemaining() > 0)
       return make_error<RawError>(raw_error_code::stream_too_long);
+
+    // The module stream is complete. Release the memory holding it so that
+    // the output doesn't have to stay resident until the PDB is committed.
+    NS->dontNeed(0, NS->getLength());
   }
   return Error::success();
 }
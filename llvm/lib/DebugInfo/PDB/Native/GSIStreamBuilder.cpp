@@ -370,9 +370,12 @@ Error GSIStreamBuilder::commit(const msf::MSFLayout &Layout,
 
   if (auto EC = commitSymbolRecordStream(*PRS))
     return EC;
+  PRS->dontNeed(0, PRS->getLength());
   if (auto EC = commitGlobalsHashStream(*GS))
     return EC;
+  GS->dontNeed(0, GS->getLength());
   if (auto EC = commitPublicsHashStream(*PS))
     return EC;
+  PS->dontNeed(0, PS->getLength());
   return Error::success();
 }
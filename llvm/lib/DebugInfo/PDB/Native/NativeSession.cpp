@@ -12,6 +12,7 @@
 #include "llvm/DebugInfo/CodeView/TypeIndex.h"
 #include "llvm/DebugInfo/PDB/IPDBEnumChildren.h"
 #include "llvm/DebugInfo/PDB/IPDBSourceFile.h"
+#include "llvm/DebugInfo/PDB/Native/DbiStream.h"
 #include "llvm/DebugInfo/PDB/Native/NativeCompilandSymbol.h"
 #include "llvm/DebugInfo/PDB/Native/NativeEnumInjectedSources.h"
 #include "llvm/DebugInfo/PDB/Native/NativeEnumTypes.h"
@@ -25,6 +26,7 @@
 #include "llvm/DebugInfo/PDB/PDBSymbolCompiland.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolExe.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolTypeEnum.h"
+#include "llvm/Object/COFF.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/BinaryByteStream.h"
 #include "llvm/Support/Error.h"
@@ -80,9 +82,12 @@ Error NativeSession::createFromExe(StringRef Path,
   return make_error<RawError>(raw_error_code::feature_unsupported);
 }
 
-uint64_t NativeSession::getLoadAddress() const { return 0; }
+uint64_t NativeSession::getLoadAddress() const { return LoadAddress; }
 
-bool NativeSession::setLoadAddress(uint64_t Address) { return false; }
+bool NativeSession::setLoadAddress(uint64_t Address) {
+  LoadAddress = Address;
+  return true;
+}
 
 std::unique_ptr<PDBSymbolExe> NativeSession::getGlobalScope() {
   return PDBSymbol::createAs<PDBSymbolExe>(*this, getNativeGlobalScope());
@@ -95,28 +100,71 @@ NativeSession::getSymbolById(SymIndexId SymbolId) const {
 
 bool NativeSession::addressForVA(uint64_t VA, uint32_t &Section,
                                  uint32_t &Offset) const {
-  return false;
+  if (VA < LoadAddress || VA - LoadAddress > UINT32_MAX)
+    return false;
+  return addressForRVA(VA - LoadAddress, Section, Offset);
 }
 
-bool NativeSession::addressForRVA(uint32_t VA, uint32_t &Section,
+bool NativeSession::addressForRVA(uint32_t RVA, uint32_t &Section,
                                   uint32_t &Offset) const {
+  DbiStream *Dbi = getDbiStreamPtr(*Pdb);
+  if (!Dbi)
+    return false;
+
+  // Section numbers are 1-based.
+  FixedStreamArray<object::coff_section> Headers = Dbi->getSectionHeaders();
+  for (uint32_t I = 0, E = Headers.size(); I != E; ++I) {
+    const object::coff_section &Header = Headers[I];
+    uint32_t Size =
+        std::max<uint32_t>(Header.VirtualSize, Header.SizeOfRawData);
+    if (RVA >= Header.VirtualAddress && RVA - Header.VirtualAddress < Size) {
+      Section = I + 1;
+      Offset = RVA - Header.VirtualAddress;
+      return true;
+    }
+  }
   return false;
 }
 
+uint32_t NativeSession::getRVAFromSectOffset(uint32_t Section,
+                                             uint32_t Offset) const {
+  DbiStream *Dbi = getDbiStreamPtr(*Pdb);
+  if (!Dbi)
+    return 0;
+
+  FixedStreamArray<object::coff_section> Headers = Dbi->getSectionHeaders();
+  if (Section == 0 || Section > Headers.size())
+    return 0;
+  return Headers[Section - 1].VirtualAddress + Offset;
+}
+
+uint64_t NativeSession::getVAFromSectOffset(uint32_t Section,
+                                            uint32_t Offset) const {
+  return LoadAddress + getRVAFromSectOffset(Section, Offset);
+}
+
 std::unique_ptr<PDBSymbol>
 NativeSession::findSymbolByAddress(uint64_t Address, PDB_SymType Type) const {
-  return nullptr;
+  uint32_t Section, Offset;
+  if (!addressForVA(Address, Section, Offset))
+    return nullptr;
+  return findSymbolBySectOffset(Section, Offset, Type);
 }
 
 std::unique_ptr<PDBSymbol>
 NativeSession::findSymbolByRVA(uint32_t RVA, PDB_SymType Type) const {
-  return nullptr;
+  uint32_t Section, Offset;
+  if (!addressForRVA(RVA, Section, Offset))
+    return nullptr;
+  return findSymbolBySectOffset(Section, Offset, Type);
 }
 
 std::unique_ptr<PDBSymbol>
 NativeSession::findSymbolBySectOffset(uint32_t Sect, uint32_t Offset,
                                       PDB_SymType Type) const {
-  return nullptr;
+  // Like getNativeGlobalScope(), lookups create and cache symbols.
+  return const_cast<NativeSession &>(*this).Cache.findSymbolBySectOffset(
+      Sect, Offset, Type);
 }
 
 std::unique_ptr<IPDBEnumLineNumbers>
@@ -128,18 +176,25 @@ NativeSession::findLineNumbers(const PDBSymbolCompiland &Compiland,
 std::unique_ptr<IPDBEnumLineNumbers>
 NativeSession::findLineNumbersByAddress(uint64_t Address,
                                         uint32_t Length) const {
-  return nullptr;
+  uint32_t Section, Offset;
+  if (!addressForVA(Address, Section, Offset))
+    return nullptr;
+  return findLineNumbersBySectOffset(Section, Offset, Length);
 }
 
 std::unique_ptr<IPDBEnumLineNumbers>
 NativeSession::findLineNumbersByRVA(uint32_t RVA, uint32_t Length) const {
-  return nullptr;
+  uint32_t Section, Offset;
+  if (!addressForRVA(RVA, Section, Offset))
+    return nullptr;
+  return findLineNumbersBySectOffset(Section, Offset, Length);
 }
 
 std::unique_ptr<IPDBEnumLineNumbers>
 NativeSession::findLineNumbersBySectOffset(uint32_t Section, uint32_t Offset,
                                            uint32_t Length) const {
-  return nullptr;
+  return const_cast<NativeSession &>(*this).Cache.findLineNumbersBySectOffset(
+      Section, Offset, Length);
 }
 
 std::unique_ptr<IPDBEnumSourceFiles>
@@ -179,7 +234,7 @@ std::unique_ptr<IPDBEnumSourceFiles> NativeSession::getSourceFilesForCompiland(
 
 std::unique_ptr<IPDBSourceFile>
 NativeSession::getSourceFileById(uint32_t FileId) const {
-  return nullptr;
+  return Cache.getSourceFileById(FileId);
 }
 
 std::unique_ptr<IPDBEnumDataStreams> NativeSession::getDebugStreams() const {
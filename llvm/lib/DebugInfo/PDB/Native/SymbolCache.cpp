@@ -1,13 +1,19 @@
 #include "llvm/DebugInfo/PDB/Native/SymbolCache.h"
 
+#include "llvm/DebugInfo/CodeView/DebugLinesSubsection.h"
 #include "llvm/DebugInfo/CodeView/SymbolDeserializer.h"
 #include "llvm/DebugInfo/CodeView/TypeDeserializer.h"
 #include "llvm/DebugInfo/CodeView/TypeRecordHelpers.h"
+#include "llvm/DebugInfo/MSF/MappedBlockStream.h"
+#include "llvm/DebugInfo/PDB/Native/DbiModuleList.h"
 #include "llvm/DebugInfo/PDB/Native/DbiStream.h"
 #include "llvm/DebugInfo/PDB/Native/GlobalsStream.h"
+#include "llvm/DebugInfo/PDB/Native/ISectionContribVisitor.h"
 #include "llvm/DebugInfo/PDB/Native/NativeCompilandSymbol.h"
 #include "llvm/DebugInfo/PDB/Native/NativeEnumGlobals.h"
+#include "llvm/DebugInfo/PDB/Native/NativeEnumLineNumbers.h"
 #include "llvm/DebugInfo/PDB/Native/NativeEnumTypes.h"
+#include "llvm/DebugInfo/PDB/Native/NativeFunctionSymbol.h"
 #include "llvm/DebugInfo/PDB/Native/NativeRawSymbol.h"
 #include "llvm/DebugInfo/PDB/Native/NativeSession.h"
 #include "llvm/DebugInfo/PDB/Native/NativeTypeArray.h"
@@ -19,14 +25,19 @@
 #include "llvm/DebugInfo/PDB/Native/NativeTypeUDT.h"
 #include "llvm/DebugInfo/PDB/Native/NativeTypeVTShape.h"
 #include "llvm/DebugInfo/PDB/Native/PDBFile.h"
+#include "llvm/DebugInfo/PDB/Native/RawError.h"
 #include "llvm/DebugInfo/PDB/Native/SymbolStream.h"
 #include "llvm/DebugInfo/PDB/Native/TpiStream.h"
 #include "llvm/DebugInfo/PDB/PDBSymbol.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolCompiland.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolTypeEnum.h"
+#include "llvm/Support/Parallel.h"
+
+#include <tuple>
 
 using namespace llvm;
 using namespace llvm::codeview;
+using namespace llvm::msf;
 using namespace llvm::pdb;
 
 // Maps codeview::SimpleTypeKind of a built-in type to the parameters necessary
@@ -65,6 +76,7 @@ SymbolCache::SymbolCache(NativeSession &Session, DbiStream *Dbi)
     : Session(Session), Dbi(Dbi) {
   // Id 0 is reserved for the invalid symbol.
   Cache.push_back(nullptr);
+  SourceFiles.push_back(nullptr);
 
   if (Dbi)
     Compilands.resize(Dbi->modules().getModuleCount());
@@ -297,3 +309,332 @@ SymbolCache::getOrCreateCompiland(uint32_t Index) {
 
   return Session.getConcreteSymbolById<PDBSymbolCompiland>(Compilands[Index]);
 }
+
+// Returns the first range in the address sorted \p Ranges that starts after
+// Sect:Offset.
+template <typename RangeT>
+static typename std::vector<RangeT>::const_iterator
+upperBoundByAddress(const std::vector<RangeT> &Ranges, uint32_t Sect,
+                    uint32_t Offset) {
+  return llvm::upper_bound(
+      Ranges, std::make_pair(Sect, Offset),
+      [](const std::pair<uint32_t, uint32_t> &Addr, const RangeT &R) {
+        return Addr < std::make_pair(R.Section, R.Offset);
+      });
+}
+
+// Returns the range in the address sorted \p Ranges that contains
+// Sect:Offset, or null if there is none.
+template <typename RangeT>
+static const RangeT *findRangeByAddress(const std::vector<RangeT> &Ranges,
+                                        uint32_t Sect, uint32_t Offset) {
+  auto It = upperBoundByAddress(Ranges, Sect, Offset);
+  if (It == Ranges.begin())
+    return nullptr;
+  --It;
+  if (It->Section != Sect || Offset - It->Offset >= It->Length)
+    return nullptr;
+  return &*It;
+}
+
+void SymbolCache::indexModule(const PDBFile &File,
+                              const DbiModuleDescriptor &Mod, uint32_t Modi,
+                              std::vector<FunctionRange> &Functions,
+                              std::vector<LineRange> &Lines) {
+  uint16_t StreamIndex = Mod.getModuleStreamIndex();
+  if (StreamIndex == kInvalidStreamIndex ||
+      StreamIndex >= File.getNumStreams())
+    return;
+
+  // This runs on a worker thread. The allocator of the PDBFile is not thread
+  // safe, so the stream gets an allocator of its own. Nothing read through it
+  // is kept once the module is indexed.
+  BumpPtrAllocator Allocator;
+  ModuleDebugStreamRef ModS(
+      Mod, MappedBlockStream::createIndexedStream(
+               File.getMsfLayout(), File.getMsfBuffer(), StreamIndex,
+               Allocator));
+  if (Error E = ModS.reload()) {
+    consumeError(std::move(E));
+    return;
+  }
+
+  const CVSymbolArray &Symbols = ModS.getSymbolArray();
+  for (auto It = Symbols.begin(), End = Symbols.end(); It != End; ++It) {
+    switch (It->kind()) {
+    case S_GPROC32:
+    case S_LPROC32:
+    case S_GPROC32_ID:
+    case S_LPROC32_ID:
+    case S_LPROC32_DPC:
+    case S_LPROC32_DPC_ID: {
+      Expected<ProcSym> Sym = SymbolDeserializer::deserializeAs<ProcSym>(*It);
+      if (!Sym) {
+        consumeError(Sym.takeError());
+        continue;
+      }
+      if (Sym->Segment == 0 || Sym->CodeSize == 0)
+        continue;
+      Functions.push_back(
+          {Sym->Segment, Sym->CodeOffset, Sym->CodeSize, Modi, It.offset()});
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  for (const DebugSubsectionRecord &SS : ModS.subsections()) {
+    if (SS.kind() != DebugSubsectionKind::Lines)
+      continue;
+    DebugLinesSubsectionRef LineTable;
+    if (Error E =
+            LineTable.initialize(BinaryStreamReader(SS.getRecordData()))) {
+      consumeError(std::move(E));
+      continue;
+    }
+
+    const LineFragmentHeader *Header = LineTable.header();
+    size_t First = Lines.size();
+    for (const LineColumnEntry &Block : LineTable) {
+      for (uint32_t I = 0, E = Block.LineNumbers.size(); I != E; ++I) {
+        const LineNumberEntry &Entry = Block.LineNumbers[I];
+        LineRange Row = {Header->RelocSegment,
+                         Header->RelocOffset + Entry.Offset,
+                         0,
+                         Entry.Flags,
+                         0,
+                         0,
+                         Modi,
+                         Block.NameIndex};
+        if (LineTable.hasColumnInfo() && I < Block.Columns.size()) {
+          Row.ColumnStart = Block.Columns[I].StartColumn;
+          Row.ColumnEnd = Block.Columns[I].EndColumn;
+        }
+        Lines.push_back(Row);
+      }
+    }
+
+    // Each row runs up to the next one, and the last one up to the end of the
+    // fragment.
+    MutableArrayRef<LineRange> Rows =
+        MutableArrayRef<LineRange>(Lines).drop_front(First);
+    llvm::stable_sort(Rows, [](const LineRange &A, const LineRange &B) {
+      return A.Offset < B.Offset;
+    });
+    uint32_t FragmentEnd = Header->RelocOffset + Header->CodeSize;
+    for (size_t I = 0, E = Rows.size(); I != E; ++I) {
+      uint32_t RowEnd = I + 1 == E ? FragmentEnd : Rows[I + 1].Offset;
+      Rows[I].Length = RowEnd > Rows[I].Offset ? RowEnd - Rows[I].Offset : 0;
+    }
+    // A row followed by one at the same offset covers no code. Dropping these
+    // leaves one row per offset, so the order of the sorted index does not
+    // depend on how the sort breaks ties.
+    Lines.erase(
+        std::remove_if(Lines.begin() + First, Lines.end(),
+                       [](const LineRange &R) { return R.Length == 0; }),
+        Lines.end());
+  }
+}
+
+void SymbolCache::buildAddressIndex() {
+  AddressIndexBuilt = true;
+  if (!Dbi)
+    return;
+
+  class ContribVisitor : public ISectionContribVisitor {
+  public:
+    explicit ContribVisitor(std::vector<ContribRange> &Contribs)
+        : Contribs(Contribs) {}
+
+    void visit(const SectionContrib &C) override {
+      if (C.Size > 0)
+        Contribs.push_back({C.ISect, static_cast<uint32_t>(C.Off),
+                            static_cast<uint32_t>(C.Size), C.Imod});
+    }
+    void visit(const SectionContrib2 &C) override { visit(C.Base); }
+
+  private:
+    std::vector<ContribRange> &Contribs;
+  };
+
+  ContribVisitor Visitor(Contribs);
+  Dbi->visitSectionContributions(Visitor);
+
+  // The module descriptors are read here, as reading the DBI stream is not
+  // thread safe. The module streams are then indexed in parallel.
+  const DbiModuleList &Modules = Dbi->modules();
+  uint32_t NumModules = Modules.getModuleCount();
+  std::vector<DbiModuleDescriptor> Descriptors;
+  Descriptors.reserve(NumModules);
+  for (uint32_t I = 0; I < NumModules; ++I)
+    Descriptors.push_back(Modules.getModuleDescriptor(I));
+
+  const PDBFile &File = Session.getPDBFile();
+  std::vector<std::vector<FunctionRange>> ModuleFunctions(NumModules);
+  std::vector<std::vector<LineRange>> ModuleLines(NumModules);
+  parallel::for_each_n(parallel::par, size_t(0), size_t(NumModules),
+                       [&](size_t I) {
+                         indexModule(File, Descriptors[I], I,
+                                     ModuleFunctions[I], ModuleLines[I]);
+                       });
+
+  for (std::vector<FunctionRange> &V : ModuleFunctions)
+    Functions.insert(Functions.end(), V.begin(), V.end());
+  for (std::vector<LineRange> &V : ModuleLines)
+    Lines.insert(Lines.end(), V.begin(), V.end());
+
+  // Ties are broken by the compiland and the rest of the entry, so that the
+  // index does not depend on the order in which the threads finish. A module
+  // may have line fragments for the same code in more than one file.
+  parallel::sort(parallel::par, Functions.begin(), Functions.end(),
+                 [](const FunctionRange &A, const FunctionRange &B) {
+                   return std::tie(A.Section, A.Offset, A.Modi,
+                                   A.RecordOffset) <
+                          std::tie(B.Section, B.Offset, B.Modi,
+                                   B.RecordOffset);
+                 });
+  parallel::sort(parallel::par, Lines.begin(), Lines.end(),
+                 [](const LineRange &A, const LineRange &B) {
+                   return std::tie(A.Section, A.Offset, A.Modi,
+                                   A.ChecksumOffset, A.LineData, A.Length,
+                                   A.ColumnStart, A.ColumnEnd) <
+                          std::tie(B.Section, B.Offset, B.Modi,
+                                   B.ChecksumOffset, B.LineData, B.Length,
+                                   B.ColumnStart, B.ColumnEnd);
+                 });
+  llvm::stable_sort(Contribs, [](const ContribRange &A, const ContribRange &B) {
+    return std::tie(A.Section, A.Offset) < std::tie(B.Section, B.Offset);
+  });
+}
+
+Expected<ModuleDebugStreamRef>
+SymbolCache::getModuleDebugStream(uint32_t Index) const {
+  assert(Dbi && "Dbi stream not present");
+
+  DbiModuleDescriptor Modi = Dbi->modules().getModuleDescriptor(Index);
+
+  uint16_t ModiStream = Modi.getModuleStreamIndex();
+  if (ModiStream == kInvalidStreamIndex)
+    return make_error<RawError>(raw_error_code::no_stream,
+                                "Module stream not present");
+
+  std::unique_ptr<MappedBlockStream> ModStreamData =
+      Session.getPDBFile().createIndexedStream(ModiStream);
+
+  ModuleDebugStreamRef ModS(Modi, std::move(ModStreamData));
+  if (auto EC = ModS.reload())
+    return std::move(EC);
+
+  return std::move(ModS);
+}
+
+SymIndexId SymbolCache::getOrCreateFunctionSymbol(const FunctionRange &F) {
+  auto Iter = FunctionToSymbolId.find({F.Modi, F.RecordOffset});
+  if (Iter != FunctionToSymbolId.end())
+    return Iter->second;
+
+  Expected<ModuleDebugStreamRef> ModS = getModuleDebugStream(F.Modi);
+  if (!ModS) {
+    consumeError(ModS.takeError());
+    return 0;
+  }
+
+  CVSymbol CVS = ModS->readSymbolAtOffset(F.RecordOffset);
+  Expected<ProcSym> Sym = SymbolDeserializer::deserializeAs<ProcSym>(CVS);
+  if (!Sym) {
+    consumeError(Sym.takeError());
+    return 0;
+  }
+
+  SymIndexId Id = createSymbol<NativeFunctionSymbol>(*Sym, F.Modi);
+  FunctionToSymbolId[{F.Modi, F.RecordOffset}] = Id;
+  return Id;
+}
+
+uint32_t SymbolCache::getOrCreateSourceFile(uint32_t Modi,
+                                            uint32_t ChecksumOffset) {
+  auto Iter = ChecksumToFileId.find({Modi, ChecksumOffset});
+  if (Iter != ChecksumToFileId.end())
+    return Iter->second;
+
+  uint32_t FileId = 0;
+  Expected<ModuleDebugStreamRef> ModS = getModuleDebugStream(Modi);
+  if (ModS) {
+    auto Checksums = ModS->findChecksumsSubsection();
+    if (Checksums) {
+      auto Entry = Checksums->getArray().at(ChecksumOffset);
+      if (Entry != Checksums->getArray().end()) {
+        auto Result =
+            FileNameToFileId.try_emplace(Entry->FileNameOffset, 0);
+        if (Result.second) {
+          Result.first->second = SourceFiles.size();
+          SourceFiles.push_back(std::make_unique<NativeSourceFile>(
+              Session, SourceFiles.size(), *Entry));
+        }
+        FileId = Result.first->second;
+      }
+    } else {
+      consumeError(Checksums.takeError());
+    }
+  } else {
+    consumeError(ModS.takeError());
+  }
+
+  ChecksumToFileId[{Modi, ChecksumOffset}] = FileId;
+  return FileId;
+}
+
+std::unique_ptr<PDBSymbol>
+SymbolCache::findSymbolBySectOffset(uint32_t Sect, uint32_t Offset,
+                                    PDB_SymType Type) {
+  if (!AddressIndexBuilt)
+    buildAddressIndex();
+
+  if (Type == PDB_SymType::Function || Type == PDB_SymType::None)
+    if (const FunctionRange *F = findRangeByAddress(Functions, Sect, Offset))
+      if (SymIndexId Id = getOrCreateFunctionSymbol(*F))
+        return getSymbolById(Id);
+
+  if (Type == PDB_SymType::Compiland || Type == PDB_SymType::None)
+    if (const ContribRange *C = findRangeByAddress(Contribs, Sect, Offset))
+      return getOrCreateCompiland(C->Modi);
+
+  return nullptr;
+}
+
+std::unique_ptr<IPDBEnumLineNumbers>
+SymbolCache::findLineNumbersBySectOffset(uint32_t Sect, uint32_t Offset,
+                                         uint32_t Length) {
+  if (!AddressIndexBuilt)
+    buildAddressIndex();
+
+  // Find the rows that overlap [Offset, Offset + Length), starting with the
+  // one that contains Offset, if any.
+  uint64_t End = uint64_t(Offset) + std::max(Length, 1u);
+  auto It = upperBoundByAddress(Lines, Sect, Offset);
+  if (It != Lines.begin()) {
+    auto Prev = std::prev(It);
+    if (Prev->Section == Sect && Offset - Prev->Offset < Prev->Length)
+      It = Prev;
+  }
+
+  std::vector<NativeLineNumber> Result;
+  for (; It != Lines.end() && It->Section == Sect && It->Offset < End; ++It) {
+    uint32_t FileId = getOrCreateSourceFile(It->Modi, It->ChecksumOffset);
+    auto Compiland = getOrCreateCompiland(It->Modi);
+    Result.emplace_back(Session, LineInfo(It->LineData), It->ColumnStart,
+                        It->ColumnEnd, It->Section, It->Offset, It->Length,
+                        FileId, Compiland ? Compiland->getSymIndexId() : 0);
+  }
+  return std::make_unique<NativeEnumLineNumbers>(std::move(Result));
+}
+
+std::unique_ptr<IPDBSourceFile>
+SymbolCache::getSourceFileById(uint32_t FileId) const {
+  // Id 0 is reserved.
+  if (FileId == 0 || FileId >= SourceFiles.size())
+    return nullptr;
+
+  return std::make_unique<NativeSourceFile>(*SourceFiles[FileId]);
+}
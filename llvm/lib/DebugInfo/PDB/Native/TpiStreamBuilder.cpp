@@ -164,6 +164,7 @@ Error TpiStreamBuilder::commit(const msf::MSFLayout &Layout,
     if (auto EC = Writer.writeBytes(Rec))
       return EC;
   }
+  InfoS->dontNeed(0, InfoS->getLength());
 
   if (HashStreamIndex != kInvalidStreamIndex) {
     auto HVS = WritableMappedBlockStream::createIndexedStream(
@@ -178,6 +179,7 @@ Error TpiStreamBuilder::commit(const msf::MSFLayout &Layout,
       if (auto EC = HW.writeObject(IndexOffset))
         return EC;
     }
+    HVS->dontNeed(0, HVS->getLength());
   }
 
   return Error::success();
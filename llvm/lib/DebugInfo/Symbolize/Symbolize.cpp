@@ -169,6 +169,77 @@ void LLVMSymbolizer::flush() {
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
+  CachedModules.clear();
+  LRUModules.clear();
+  CacheSize = 0;
+}
+
+void LLVMSymbolizer::cacheModule(const std::string &ModuleName,
+                                 ObjectPair Objects) {
+  // The sizes of the binaries stand in for the memory used by the module.
+  // Objects shared by several modules are counted once for each of them.
+  uint64_t Size = Objects.first->getData().size();
+  if (Objects.second != Objects.first)
+    Size += Objects.second->getData().size();
+
+  LRUModules.push_back(ModuleName);
+  CachedModules[ModuleName] = {Objects, Size, std::prev(LRUModules.end())};
+  CacheSize += Size;
+
+  // Never close the module that was just opened.
+  while (CacheSize > Opts.MaxCacheSize && LRUModules.size() > 1)
+    evictModule(LRUModules.front());
+}
+
+void LLVMSymbolizer::evictModule(StringRef ModuleName) {
+  auto I = CachedModules.find(ModuleName);
+  assert(I != CachedModules.end() && "evicting an untracked module");
+  ObjectPair Objects = I->second.Objects;
+  CacheSize -= I->second.Size;
+  LRUModules.erase(I->second.LRUPos);
+  CachedModules.erase(I);
+  Modules.erase(Modules.find(ModuleName));
+
+  for (const ObjectFile *Obj : {Objects.first, Objects.second}) {
+    bool InUse = any_of(CachedModules, [&](const auto &Entry) {
+      return Entry.second.Objects.first == Obj ||
+             Entry.second.Objects.second == Obj;
+    });
+    if (!InUse)
+      closeObject(Obj);
+  }
+}
+
+void LLVMSymbolizer::closeObject(const ObjectFile *Obj) {
+  for (auto I = ObjectPairForPathArch.begin();
+       I != ObjectPairForPathArch.end();) {
+    if (I->second.first == Obj || I->second.second == Obj)
+      I = ObjectPairForPathArch.erase(I);
+    else
+      ++I;
+  }
+
+  // An object is either a binary of its own or a slice of a universal binary.
+  // Close the universal binary along with its last open slice.
+  for (auto I = BinaryForPath.begin(); I != BinaryForPath.end(); ++I) {
+    if (I->second.getBinary() == Obj) {
+      BinaryForPath.erase(I);
+      return;
+    }
+  }
+  for (auto I = ObjectForUBPathAndArch.begin();
+       I != ObjectForUBPathAndArch.end(); ++I) {
+    if (I->second.get() != Obj)
+      continue;
+    std::string Path = I->first.first;
+    ObjectForUBPathAndArch.erase(I);
+    bool HasOpenSlices = any_of(ObjectForUBPathAndArch, [&](const auto &Entry) {
+      return Entry.first.first == Path && Entry.second;
+    });
+    if (!HasOpenSlices)
+      BinaryForPath.erase(Path);
+    return;
+  }
 }
 
 namespace {
@@ -523,8 +594,12 @@ LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   auto I = Modules.find(ModuleName);
-  if (I != Modules.end())
+  if (I != Modules.end()) {
+    auto CachedI = CachedModules.find(ModuleName);
+    if (CachedI != CachedModules.end())
+      LRUModules.splice(LRUModules.end(), LRUModules, CachedI->second.LRUPos);
     return I->second.get();
+  }
 
   std::string BinaryName = ModuleName;
   std::string ArchName = Opts.DefaultArch;
@@ -566,7 +641,11 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   }
   if (!Context)
     Context = DWARFContext::create(*Objects.second, nullptr, Opts.DWPName);
-  return createModuleInfo(Objects.first, std::move(Context), ModuleName);
+  Expected<SymbolizableModule *> InfoOrErr =
+      createModuleInfo(Objects.first, std::move(Context), ModuleName);
+  if (Opts.MaxCacheSize && InfoOrErr && *InfoOrErr)
+    cacheModule(ModuleName, Objects);
+  return InfoOrErr;
 }
 
 namespace {
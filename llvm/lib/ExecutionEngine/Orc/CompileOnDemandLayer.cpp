@@ -173,8 +173,25 @@ void CompileOnDemandLayer::emit(MaterializationResponsibility R,
                             std::move(Callables), AliaseeImpls));
 }
 
+Error CompileOnDemandLayer::updateStub(JITDylib &ImplD, StringRef Name,
+                                       JITTargetAddress NewAddr) {
+  std::lock_guard<std::mutex> Lock(CODLayerMutex);
+  for (auto &KV : DylibResources) {
+    if (&KV.second.getImplDylib() != &ImplD)
+      continue;
+    auto &ISMgr = KV.second.getISManager();
+    if (!ISMgr.findStub(Name, false))
+      break;
+    return ISMgr.updatePointer(Name, NewAddr);
+  }
+  return make_error<StringError>("No stub for " + Name + " in " +
+                                     ImplD.getName(),
+                                 inconvertibleErrorCode());
+}
+
 CompileOnDemandLayer::PerDylibResources &
 CompileOnDemandLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(CODLayerMutex);
   auto I = DylibResources.find(&TargetD);
   if (I == DylibResources.end()) {
     auto &ImplD =
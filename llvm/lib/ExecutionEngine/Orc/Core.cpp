@@ -1450,7 +1450,8 @@ JITDylib::legacyLookup(std::shared_ptr<AsynchronousSymbolQuery> Q,
   {
     std::lock_guard<std::recursive_mutex> Lock(ES.OutstandingMUsMutex);
     for (auto &MU : MUs)
-      ES.OutstandingMUs.push_back(make_pair(this, std::move(MU)));
+      ES.OutstandingMUs.push_back(
+          {this, std::move(MU), MaterializationPriority::Normal});
   }
   ES.runOutstandingMUs();
 
@@ -1883,7 +1884,8 @@ void ExecutionSession::lookup(
     LookupKind K, const JITDylibSearchOrder &SearchOrder,
     SymbolLookupSet Symbols, SymbolState RequiredState,
     SymbolsResolvedCallback NotifyComplete,
-    RegisterDependenciesFunction RegisterDependencies) {
+    RegisterDependenciesFunction RegisterDependencies,
+    MaterializationPriority Priority) {
 
   LLVM_DEBUG({
     runSessionLocked([&]() {
@@ -1902,6 +1904,7 @@ void ExecutionSession::lookup(
   auto Q = std::make_shared<AsynchronousSymbolQuery>(Unresolved, RequiredState,
                                                      std::move(NotifyComplete));
   bool QueryComplete = false;
+  SymbolDependenceMap WaitingOn;
 
   auto LodgingErr = runSessionLocked([&]() -> Error {
     auto LodgeQuery = [&]() -> Error {
@@ -1954,6 +1957,12 @@ void ExecutionSession::lookup(
     // lock.
     QueryComplete = Q->isComplete();
 
+    // Remember what the query waits for, in case some of it was queued by a
+    // speculative lookup.
+    if (!QueryComplete && PromoteMaterialization &&
+        Priority == MaterializationPriority::Normal)
+      WaitingOn = Q->QueryRegistrations;
+
     // Call the register dependencies function.
     if (RegisterDependencies && !Q->QueryRegistrations.empty())
       RegisterDependencies(Q->QueryRegistrations);
@@ -1969,13 +1978,16 @@ void ExecutionSession::lookup(
   if (QueryComplete)
     Q->handleComplete();
 
+  for (auto &KV : WaitingOn)
+    PromoteMaterialization(*KV.first, KV.second);
+
   // Move the MUs to the OutstandingMUs list, then materialize.
   {
     std::lock_guard<std::recursive_mutex> Lock(OutstandingMUsMutex);
 
     for (auto &KV : CollectedMUsMap)
       for (auto &MU : KV.second)
-        OutstandingMUs.push_back(std::make_pair(KV.first, std::move(MU)));
+        OutstandingMUs.push_back({KV.first, std::move(MU), Priority});
   }
 
   runOutstandingMUs();
@@ -2070,20 +2082,19 @@ void ExecutionSession::dump(raw_ostream &OS) {
 
 void ExecutionSession::runOutstandingMUs() {
   while (1) {
-    std::pair<JITDylib *, std::unique_ptr<MaterializationUnit>> JITDylibAndMU;
+    OutstandingMU Next = {nullptr, nullptr, MaterializationPriority::Normal};
 
     {
       std::lock_guard<std::recursive_mutex> Lock(OutstandingMUsMutex);
       if (!OutstandingMUs.empty()) {
-        JITDylibAndMU = std::move(OutstandingMUs.back());
+        Next = std::move(OutstandingMUs.back());
         OutstandingMUs.pop_back();
       }
     }
 
-    if (JITDylibAndMU.first) {
-      assert(JITDylibAndMU.second && "JITDylib, but no MU?");
-      dispatchMaterialization(*JITDylibAndMU.first,
-                              std::move(JITDylibAndMU.second));
+    if (Next.JD) {
+      assert(Next.MU && "JITDylib, but no MU?");
+      dispatchMaterialization(*Next.JD, std::move(Next.MU), Next.Priority);
     } else
       break;
   }
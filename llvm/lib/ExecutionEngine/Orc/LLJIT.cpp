@@ -1019,7 +1019,8 @@ LLJIT::createObjectLinkingLayer(LLJITBuilderState &S, ExecutionSession &ES) {
 
 Expected<std::unique_ptr<IRCompileLayer::IRCompiler>>
 LLJIT::createCompileFunction(LLJITBuilderState &S,
-                             JITTargetMachineBuilder JTMB) {
+                             JITTargetMachineBuilder JTMB,
+                             ObjectCache *ObjCache) {
 
   /// If there is a custom compile function creator set then use it.
   if (S.CreateCompileFunction)
@@ -1028,13 +1029,13 @@ LLJIT::createCompileFunction(LLJITBuilderState &S,
   // Otherwise default to creating a SimpleCompiler, or ConcurrentIRCompiler,
   // depending on the number of threads requested.
   if (S.NumCompileThreads > 0)
-    return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB));
+    return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB), ObjCache);
 
   auto TM = JTMB.createTargetMachine();
   if (!TM)
     return TM.takeError();
 
-  return std::make_unique<TMOwningSimpleCompiler>(std::move(*TM));
+  return std::make_unique<TMOwningSimpleCompiler>(std::move(*TM), ObjCache);
 }
 
 LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
@@ -1061,8 +1062,19 @@ LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
     return;
   }
 
+  if (!S.ObjectCacheDir.empty()) {
+    auto ObjCacheOrErr = OnDiskObjectCache::Create(S.ObjectCacheDir, *S.JTMB);
+    if (!ObjCacheOrErr) {
+      Err = ObjCacheOrErr.takeError();
+      return;
+    }
+    ObjCache = std::move(*ObjCacheOrErr);
+    ObjCache->prune(S.ObjectCachePruningPolicy);
+  }
+
   {
-    auto CompileFunction = createCompileFunction(S, std::move(*S.JTMB));
+    auto CompileFunction =
+        createCompileFunction(S, std::move(*S.JTMB), ObjCache.get());
     if (!CompileFunction) {
       Err = CompileFunction.takeError();
       return;
@@ -1078,12 +1090,14 @@ LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
     InitHelperTransformLayer->setCloneToNewContextOnEmit(true);
     CompileThreads =
         std::make_unique<ThreadPool>(hardware_concurrency(S.NumCompileThreads));
-    ES->setDispatchMaterialization(
-        [this](JITDylib &JD, std::unique_ptr<MaterializationUnit> MU) {
-          // FIXME: Switch to move capture once we have c++14.
-          auto SharedMU = std::shared_ptr<MaterializationUnit>(std::move(MU));
-          auto Work = [SharedMU, &JD]() { SharedMU->doMaterialize(JD); };
-          CompileThreads->async(std::move(Work));
+    ES->setPrioritizedDispatchMaterialization(
+        [this](JITDylib &JD, std::unique_ptr<MaterializationUnit> MU,
+               MaterializationPriority Priority) {
+          dispatchToCompileThreads(JD, std::move(MU), Priority);
+        });
+    ES->setPromoteMaterialization(
+        [this](JITDylib &JD, const SymbolNameSet &Symbols) {
+          promotePendingMUs(JD, Symbols);
         });
   }
 
@@ -1102,6 +1116,55 @@ std::string LLJIT::mangle(StringRef UnmangledName) {
   return MangledName;
 }
 
+void LLJIT::dispatchToCompileThreads(JITDylib &JD,
+                                     std::unique_ptr<MaterializationUnit> MU,
+                                     MaterializationPriority Priority) {
+  {
+    std::lock_guard<std::mutex> Lock(PendingMUsMutex);
+    auto &Pending = Priority == MaterializationPriority::Speculative
+                        ? SpeculativePendingMUs
+                        : NormalPendingMUs;
+    Pending.push_back(std::make_pair(&JD, std::move(MU)));
+  }
+
+  // There is exactly one task per pending unit, but a task materializes
+  // whichever unit is most urgent when it starts. Speculative work queued
+  // earlier therefore never delays work that some lookup is waiting on.
+  CompileThreads->async([this]() {
+    PendingMU Next;
+    {
+      std::lock_guard<std::mutex> Lock(PendingMUsMutex);
+      auto &Pending =
+          NormalPendingMUs.empty() ? SpeculativePendingMUs : NormalPendingMUs;
+      assert(!Pending.empty() && "More compile tasks than pending units");
+      Next = std::move(Pending.front());
+      Pending.pop_front();
+    }
+    Next.second->doMaterialize(*Next.first);
+  });
+}
+
+void LLJIT::promotePendingMUs(JITDylib &JD, const SymbolNameSet &Symbols) {
+  // Move the speculative units that provide any of the symbols to the back of
+  // the normal queue, so that the lookup waiting for them doesn't wait for all
+  // the other speculative work too.
+  std::lock_guard<std::mutex> Lock(PendingMUsMutex);
+  auto IsWanted = [&](const PendingMU &P) {
+    if (P.first != &JD)
+      return false;
+    for (auto &KV : P.second->getSymbols())
+      if (Symbols.count(KV.first))
+        return true;
+    return false;
+  };
+  auto It = std::stable_partition(
+      SpeculativePendingMUs.begin(), SpeculativePendingMUs.end(),
+      [&](const PendingMU &P) { return !IsWanted(P); });
+  std::move(It, SpeculativePendingMUs.end(),
+            std::back_inserter(NormalPendingMUs));
+  SpeculativePendingMUs.erase(It, SpeculativePendingMUs.end());
+}
+
 Error LLJIT::applyDataLayout(Module &M) {
   if (M.getDataLayout().isDefault())
     M.setDataLayout(DL);
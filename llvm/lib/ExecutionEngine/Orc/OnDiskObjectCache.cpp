@@ -0,0 +1,170 @@
+//===----- OnDiskObjectCache.cpp - Content-addressed object cache ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace orc {
+
+static void writeDenormalMode(raw_ostream &OS, DenormalMode Mode) {
+  OS << static_cast<int>(Mode.Output) << ',' << static_cast<int>(Mode.Input)
+     << '\0';
+}
+
+// Describes everything besides the module itself that affects the object
+// produced for it: the whole target configuration, including every
+// TargetOptions and MCTargetOptions field.
+static std::string getTargetKey(const JITTargetMachineBuilder &JTMB) {
+  std::string Key;
+  raw_string_ostream OS(Key);
+  OS << JTMB.getTargetTriple().str() << '\0' << JTMB.getCPU() << '\0'
+     << JTMB.getFeatures().getString() << '\0'
+     << static_cast<int>(JTMB.getCodeGenOptLevel()) << '\0';
+  if (auto &RM = JTMB.getRelocationModel())
+    OS << static_cast<int>(*RM);
+  OS << '\0';
+  if (auto &CM = JTMB.getCodeModel())
+    OS << static_cast<int>(*CM);
+  OS << '\0';
+
+  const TargetOptions &Opts = JTMB.getOptions();
+  OS << Opts.PrintMachineCode << Opts.UnsafeFPMath << Opts.NoInfsFPMath
+     << Opts.NoNaNsFPMath << Opts.NoTrappingFPMath << Opts.NoSignedZerosFPMath
+     << Opts.HonorSignDependentRoundingFPMathOption << Opts.NoZerosInBSS
+     << Opts.GuaranteedTailCallOpt << Opts.StackSymbolOrdering
+     << Opts.EnableFastISel << Opts.EnableGlobalISel << Opts.UseInitArray
+     << Opts.DisableIntegratedAS << Opts.RelaxELFRelocations
+     << Opts.FunctionSections << Opts.DataSections << Opts.UniqueSectionNames
+     << Opts.UniqueBBSectionNames << Opts.TrapUnreachable
+     << Opts.NoTrapAfterNoreturn << Opts.EmulatedTLS
+     << Opts.ExplicitEmulatedTLS << Opts.EnableIPRA
+     << Opts.EmitStackSizeSection << Opts.EnableMachineOutliner
+     << Opts.SupportsDefaultOutlining << Opts.EmitAddrsig
+     << Opts.EmitCallSiteInfo << Opts.SupportsDebugEntryValues
+     << Opts.EnableDebugEntryValues << Opts.ForceDwarfFrameSection << '\0'
+     << Opts.StackAlignmentOverride << '\0' << Opts.TLSSize << '\0'
+     << static_cast<int>(Opts.GlobalISelAbort) << '\0'
+     << static_cast<int>(Opts.CompressDebugSections) << '\0'
+     << static_cast<int>(Opts.BBSections) << '\0';
+  if (Opts.BBSectionsFuncListBuf)
+    OS << Opts.BBSectionsFuncListBuf->getBuffer();
+  OS << '\0' << static_cast<int>(Opts.FloatABIType) << '\0'
+     << static_cast<int>(Opts.AllowFPOpFusion) << '\0'
+     << static_cast<int>(Opts.ThreadModel) << '\0'
+     << static_cast<int>(Opts.EABIVersion) << '\0'
+     << static_cast<int>(Opts.DebuggerTuning) << '\0'
+     << static_cast<int>(Opts.ExceptionModel) << '\0';
+  writeDenormalMode(OS, Opts.getRawFPDenormalMode());
+  writeDenormalMode(OS, Opts.getRawFP32DenormalMode());
+
+  const MCTargetOptions &MCOpts = Opts.MCOptions;
+  OS << MCOpts.MCRelaxAll << MCOpts.MCNoExecStack << MCOpts.MCFatalWarnings
+     << MCOpts.MCNoWarn << MCOpts.MCNoDeprecatedWarn
+     << MCOpts.MCSaveTempLabels << MCOpts.MCUseDwarfDirectory
+     << MCOpts.MCIncrementalLinkerCompatible << MCOpts.ShowMCEncoding
+     << MCOpts.ShowMCInst << MCOpts.AsmVerbose << MCOpts.PreserveAsmComments
+     << '\0' << MCOpts.DwarfVersion << '\0' << MCOpts.ABIName << '\0'
+     << MCOpts.AssemblyLanguage << '\0' << MCOpts.SplitDwarfFile << '\0';
+  for (const std::string &Path : MCOpts.IASSearchPaths)
+    OS << Path << '\0';
+  return OS.str();
+}
+
+Expected<std::unique_ptr<OnDiskObjectCache>>
+OnDiskObjectCache::Create(StringRef CacheDir,
+                          const JITTargetMachineBuilder &JTMB) {
+  if (auto EC = sys::fs::create_directories(CacheDir))
+    return createFileError(CacheDir, EC);
+  return std::unique_ptr<OnDiskObjectCache>(
+      new OnDiskObjectCache(CacheDir.str(), getTargetKey(JTMB)));
+}
+
+OnDiskObjectCache::OnDiskObjectCache(std::string CacheDir,
+                                     std::string TargetKey)
+    : CacheDir(std::move(CacheDir)), TargetKey(std::move(TargetKey)) {}
+
+std::string OnDiskObjectCache::getEntryPath(const Module &M) const {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(M, OS);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(TargetKey);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+
+  // Use the file name prefix that pruneCache recognizes.
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, "llvmcache-" + toHex(Hasher.result()));
+  return std::string(Path.str());
+}
+
+std::unique_ptr<MemoryBuffer> OnDiskObjectCache::getObject(const Module *M) {
+  std::string Path = getEntryPath(*M);
+  if (auto ObjBuffer =
+          MemoryBuffer::getFile(Path, -1, /*RequiresNullTerminator=*/false))
+    return std::move(*ObjBuffer);
+
+  std::lock_guard<std::mutex> Lock(PendingEntryPathsMutex);
+  PendingEntryPaths[M] = std::move(Path);
+  return nullptr;
+}
+
+void OnDiskObjectCache::notifyObjectCompiled(const Module *M,
+                                             MemoryBufferRef Obj) {
+  std::string Path;
+  {
+    std::lock_guard<std::mutex> Lock(PendingEntryPathsMutex);
+    auto I = PendingEntryPaths.find(M);
+    if (I == PendingEntryPaths.end())
+      return;
+    Path = std::move(I->second);
+    PendingEntryPaths.erase(I);
+  }
+
+  // Write the object to a temporary file first so that no other process ever
+  // sees a partially written entry. The temporary file is removed if anything
+  // goes wrong, including a signal. Failing to write an entry is not an
+  // error: the module will just be compiled again next time.
+  Expected<sys::fs::TempFile> Temp =
+      sys::fs::TempFile::create(CacheDir + "/Orc-%%%%%%.tmp.o",
+                                sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    OS << Obj.getBuffer();
+    OS.flush();
+    if (OS.has_error()) {
+      OS.clear_error();
+      consumeError(Temp->discard());
+      return;
+    }
+  }
+  // keep() removes the temporary file itself if it cannot be renamed.
+  consumeError(Temp->keep(Path));
+}
+
+bool OnDiskObjectCache::prune(const CachePruningPolicy &Policy) {
+  return pruneCache(CacheDir, Policy);
+}
+
+} // end namespace orc
+} // end namespace llvm
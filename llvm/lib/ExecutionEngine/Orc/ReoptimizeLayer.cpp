@@ -0,0 +1,206 @@
+//===------ ReoptimizeLayer.cpp - Re-optimize hot code in the background --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/ReoptimizeLayer.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+ReoptimizeLayer::ReoptimizeLayer(ExecutionSession &ES, IRLayer &BaseLayer,
+                                 CompileOnDemandLayer &CODLayer,
+                                 OptimizeFunction Optimize,
+                                 uint64_t CallThreshold)
+    : IRLayer(ES, BaseLayer.getManglingOptions()), BaseLayer(BaseLayer),
+      CODLayer(CODLayer), Optimize(std::move(Optimize)),
+      CallThreshold(CallThreshold), ReoptimizeThread(hardware_concurrency(1)) {
+  assert(CallThreshold > 0 && "CallThreshold must be non-zero");
+}
+
+void ReoptimizeLayer::reoptimizeEntryPoint(ReoptimizeLayer *L,
+                                           uint64_t ModuleId) {
+  assert(L && "Null address received in __orc_reoptimize");
+  L->ReoptimizeThread.async([L, ModuleId]() {
+    if (auto Err = L->reoptimize(ModuleId))
+      L->getExecutionSession().reportError(std::move(Err));
+  });
+}
+
+Error ReoptimizeLayer::addReoptimizationRuntime(JITDylib &JD,
+                                                MangleAndInterner &Mangle) {
+  JITEvaluatedSymbol ThisPtr(pointerToJITTargetAddress(this),
+                             JITSymbolFlags::Exported);
+  JITEvaluatedSymbol ReoptimizeEntryPtr(
+      pointerToJITTargetAddress(&reoptimizeEntryPoint),
+      JITSymbolFlags::Exported);
+  return JD.define(absoluteSymbols({
+      {Mangle("__orc_reoptimizer"), ThisPtr},          // Data Symbol
+      {Mangle("__orc_reoptimize"), ReoptimizeEntryPtr} // Callable Symbol
+  }));
+}
+
+bool ReoptimizeLayer::canReoptimize(const Module &M) {
+  if (!M.alias_empty() || !M.ifunc_empty())
+    return false;
+  for (auto &GV : M.globals())
+    if (!GV.isDeclaration())
+      return false;
+
+  bool HasFunctions = false;
+  for (auto &F : M.functions()) {
+    if (F.isDeclaration())
+      continue;
+    // Only functions with external linkage can have a stub.
+    if (F.hasLocalLinkage())
+      return false;
+    HasFunctions = true;
+  }
+  return HasFunctions;
+}
+
+void ReoptimizeLayer::instrument(Module &M, uint64_t ModuleId) {
+  auto &Ctx = M.getContext();
+  auto *Int64Ty = Type::getInt64Ty(Ctx);
+  auto *ReoptimizerTy = StructType::create(Ctx, "Class.ReoptimizeLayer");
+  auto *RuntimeCallTy = FunctionType::get(
+      Type::getVoidTy(Ctx), {ReoptimizerTy->getPointerTo(), Int64Ty}, false);
+  auto *RuntimeCall = Function::Create(
+      RuntimeCallTy, GlobalValue::ExternalLinkage, "__orc_reoptimize", &M);
+  auto *ReoptimizerAddr =
+      new GlobalVariable(M, ReoptimizerTy, false, GlobalValue::ExternalLinkage,
+                         nullptr, "__orc_reoptimizer");
+
+  // All functions of the module share one counter, since the whole module is
+  // re-optimized at once.
+  auto *Counter = new GlobalVariable(M, Int64Ty, false,
+                                     GlobalValue::InternalLinkage,
+                                     ConstantInt::get(Int64Ty, 0),
+                                     "__orc_reoptimize.counter");
+  Counter->setAlignment(Align(8));
+
+  IRBuilder<> Builder(Ctx);
+  for (auto &F : M.functions()) {
+    if (F.isDeclaration() || &F == RuntimeCall)
+      continue;
+
+    BasicBlock &ProgramEntry = F.getEntryBlock();
+    BasicBlock *ReoptimizeBlock =
+        BasicBlock::Create(Ctx, "__orc_reoptimize.block", &F, &ProgramEntry);
+    BasicBlock *CountBlock = BasicBlock::Create(
+        Ctx, "__orc_reoptimize.count.block", &F, ReoptimizeBlock);
+    assert(CountBlock == &F.getEntryBlock() && "CountBlock not updated?");
+
+    // The counter is only ever compared for equality, so exactly one call
+    // (the one that makes the counter reach the threshold) triggers the
+    // re-optimization.
+    Builder.SetInsertPoint(CountBlock);
+    auto *OldCount =
+        Builder.CreateAtomicRMW(AtomicRMWInst::Add, Counter,
+                                ConstantInt::get(Int64Ty, 1),
+                                AtomicOrdering::Monotonic);
+    auto *IsHot = Builder.CreateICmpEQ(
+        OldCount, ConstantInt::get(Int64Ty, CallThreshold - 1), "is.hot");
+    Builder.CreateCondBr(IsHot, ReoptimizeBlock, &ProgramEntry);
+
+    Builder.SetInsertPoint(ReoptimizeBlock);
+    Builder.CreateCall(RuntimeCallTy, RuntimeCall,
+                       {ReoptimizerAddr, ConstantInt::get(Int64Ty, ModuleId)});
+    Builder.CreateBr(&ProgramEntry);
+  }
+
+  assert(!verifyModule(M) && "Reoptimization instrumentation breaks IR?");
+}
+
+void ReoptimizeLayer::emit(MaterializationResponsibility R,
+                           ThreadSafeModule TSM) {
+  assert(TSM && "Null module");
+
+  if (!TSM.withModuleDo([](Module &M) { return canReoptimize(M); })) {
+    BaseLayer.emit(std::move(R), std::move(TSM));
+    return;
+  }
+
+  // Keep an uninstrumented copy of the module for re-optimization.
+  uint64_t ModuleId;
+  {
+    std::lock_guard<std::mutex> Lock(CandidatesMutex);
+    ModuleId = NextModuleId++;
+    auto &C = Candidates[ModuleId];
+    C.ImplD = &R.getTargetJITDylib();
+    C.TSM = cloneToNewContext(TSM);
+  }
+
+  TSM.withModuleDo([&](Module &M) { instrument(M, ModuleId); });
+  BaseLayer.emit(std::move(R), std::move(TSM));
+}
+
+Error ReoptimizeLayer::reoptimize(uint64_t ModuleId) {
+  ReoptimizationCandidate C;
+  {
+    std::lock_guard<std::mutex> Lock(CandidatesMutex);
+    auto I = Candidates.find(ModuleId);
+    if (I == Candidates.end())
+      return Error::success();
+    C = std::move(I->second);
+    Candidates.erase(I);
+  }
+
+  auto &ES = getExecutionSession();
+
+  // Rename the functions so that the re-optimized code can live alongside the
+  // code that is running now, and remember which stub each of them replaces.
+  std::vector<std::pair<SymbolStringPtr, SymbolStringPtr>> StubsToUpdate;
+  C.TSM.withModuleDo([&](Module &M) {
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    for (auto &F : M.functions()) {
+      if (F.isDeclaration())
+        continue;
+      auto StubName = Mangle(F.getName());
+      F.setName(F.getName() + ".reoptimized");
+      F.setLinkage(GlobalValue::ExternalLinkage);
+      F.setComdat(nullptr);
+      StubsToUpdate.push_back(std::make_pair(StubName, Mangle(F.getName())));
+    }
+  });
+
+  auto OptimizedTSM = Optimize(std::move(C.TSM));
+  if (!OptimizedTSM)
+    return OptimizedTSM.takeError();
+
+  if (auto Err = BaseLayer.add(*C.ImplD, std::move(*OptimizedTSM)))
+    return Err;
+
+  SymbolLookupSet NewBodies;
+  for (auto &KV : StubsToUpdate)
+    NewBodies.add(KV.second);
+  auto NewAddrs =
+      ES.lookup(makeJITDylibSearchOrder(C.ImplD,
+                                        JITDylibLookupFlags::MatchAllSymbols),
+                std::move(NewBodies));
+  if (!NewAddrs)
+    return NewAddrs.takeError();
+
+  for (auto &KV : StubsToUpdate) {
+    LLVM_DEBUG(dbgs() << "Redirecting " << KV.first << " to " << KV.second
+                      << "\n");
+    if (auto Err = CODLayer.updateStub(*C.ImplD, *KV.first,
+                                       (*NewAddrs)[KV.second].getAddress()))
+      return Err;
+  }
+  return Error::success();
+}
+
+} // end namespace orc
+} // end namespace llvm
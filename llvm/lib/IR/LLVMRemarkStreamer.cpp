@@ -79,10 +79,14 @@ void LLVMRemarkStreamer::emit(const DiagnosticInfoOptimizationBase &Diag) {
   if (!RS.matchesFilter(Diag.getPassName()))
       return;
 
+  // Drop the remarks that are not part of the sample before converting them.
+  if (!RS.isSampled(Diag.getPassName()))
+    return;
+
   // First, convert the diagnostic to a remark.
   remarks::Remark R = toRemark(Diag);
-  // Then, emit the remark through the serializer.
-  RS.getSerializer().emit(R);
+  // Then, emit the remark through the main streamer.
+  RS.emit(R);
 }
 
 char LLVMRemarkSetupFileError::ID = 0;
@@ -172,3 +176,8 @@ Error llvm::setupLLVMOptimizationRemarks(LLVMContext &Context, raw_ostream &OS,
 
   return Error::success();
 }
+
+void llvm::finalizeLLVMOptimizationRemarks(LLVMContext &Context) {
+  if (remarks::RemarkStreamer *RS = Context.getMainRemarkStreamer())
+    RS->finalize();
+}
@@ -27,6 +27,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Mutex.h"
+#include "llvm/Support/Telemetry.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -35,6 +36,13 @@
 using namespace llvm;
 using namespace llvm::legacy;
 
+#define DEBUG_TYPE "legacy-pm"
+
+TELEMETRY_COUNTER(ModulePipelineTime,
+                  "Time spent running module pass managers (ns)");
+TELEMETRY_COUNTER(FunctionPipelineTime,
+                  "Time spent running function pass managers (ns)");
+
 // See PassManagers.h for Pass Manager infrastructure overview.
 
 //===----------------------------------------------------------------------===//
@@ -1341,6 +1349,7 @@ bool FunctionPassManager::run(Function &F) {
   handleAllErrors(F.materialize(), [&](ErrorInfoBase &EIB) {
     report_fatal_error("Error reading bitcode file: " + EIB.message());
   });
+  TelemetryTimeRegion TelemetryRegion(FunctionPipelineTime);
   return FPM->run(F);
 }
 
@@ -1723,6 +1732,7 @@ void PassManager::add(Pass *P) {
 /// run - Execute all of the passes scheduled for execution.  Keep track of
 /// whether any of the passes modifies the module, and if so, return true.
 bool PassManager::run(Module &M) {
+  TelemetryTimeRegion TelemetryRegion(ModulePipelineTime);
   return PM->run(M);
 }
 
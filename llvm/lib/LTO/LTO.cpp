@@ -31,7 +31,9 @@
 #include "llvm/Linker/IRMover.h"
 #include "llvm/Object/IRObjectFile.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
@@ -51,6 +53,7 @@
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 #include "llvm/Transforms/Utils/SplitModule.h"
 
+#include <numeric>
 #include <set>
 
 using namespace llvm;
@@ -1075,6 +1078,10 @@ public:
       const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
       MapVector<StringRef, BitcodeModule> &ModuleMap) = 0;
   virtual Error wait() = 0;
+
+  /// Returns true if the backend's output depends on the order in which
+  /// modules are started, which prevents them from being reordered by cost.
+  virtual bool isSensitiveToInputOrder() { return false; }
 };
 
 namespace {
@@ -1113,34 +1120,60 @@ public:
       const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
       const GVSummaryMapTy &DefinedGlobals,
       MapVector<StringRef, BitcodeModule> &ModuleMap) {
-    auto RunThinBackend = [&](AddStreamFn AddStream) {
+    BackendStats Stats;
+    Stats.Task = Task;
+    Stats.ModuleID = std::string(BM.getModuleIdentifier());
+    BackendStats *StatsPtr = Conf.BackendStatsHook ? &Stats : nullptr;
+
+    auto RunThinBackend = [&](AddStreamFn AddStream) -> Error {
       LTOLLVMContext BackendContext(Conf);
-      Expected<std::unique_ptr<Module>> MOrErr = BM.parseModule(BackendContext);
+      // Load the module lazily so that thinBackend() doesn't need to read the
+      // bodies of dead functions.
+      Expected<std::unique_ptr<Module>> MOrErr = [&] {
+        BackendStatsTimer T(StatsPtr, &BackendStats::ReadBitcodeTime);
+        return BM.getLazyModule(BackendContext,
+                                /*ShouldLazyLoadMetadata=*/false,
+                                /*IsImporting=*/false);
+      }();
       if (!MOrErr)
         return MOrErr.takeError();
 
       return thinBackend(Conf, Task, AddStream, **MOrErr, CombinedIndex,
-                         ImportList, DefinedGlobals, ModuleMap);
+                         ImportList, DefinedGlobals, ModuleMap, StatsPtr);
     };
 
-    auto ModuleID = BM.getModuleIdentifier();
-
-    if (!Cache || !CombinedIndex.modulePaths().count(ModuleID) ||
-        all_of(CombinedIndex.getModuleHash(ModuleID),
-               [](uint32_t V) { return V == 0; }))
-      // Cache disabled or no entry for this module in the combined index or
-      // no module hash.
-      return RunThinBackend(AddStream);
+    auto RunTask = [&]() -> Error {
+      auto ModuleID = BM.getModuleIdentifier();
+
+      if (!Cache || !CombinedIndex.modulePaths().count(ModuleID) ||
+          all_of(CombinedIndex.getModuleHash(ModuleID),
+                 [](uint32_t V) { return V == 0; }))
+        // Cache disabled or no entry for this module in the combined index or
+        // no module hash.
+        return RunThinBackend(AddStream);
+
+      SmallString<40> Key;
+      AddStreamFn CacheAddStream;
+      {
+        BackendStatsTimer T(StatsPtr, &BackendStats::CacheLookupTime);
+        // The module may be cached, this helps handling it.
+        computeLTOCacheKey(Key, Conf, CombinedIndex, ModuleID, ImportList,
+                           ExportList, ResolvedODR, DefinedGlobals,
+                           CfiFunctionDefs, CfiFunctionDecls);
+        CacheAddStream = Cache(Task, Key);
+      }
+      Stats.CacheKey = std::string(Key.str());
+      if (CacheAddStream)
+        return RunThinBackend(CacheAddStream);
 
-    SmallString<40> Key;
-    // The module may be cached, this helps handling it.
-    computeLTOCacheKey(Key, Conf, CombinedIndex, ModuleID, ImportList,
-                       ExportList, ResolvedODR, DefinedGlobals, CfiFunctionDefs,
-                       CfiFunctionDecls);
-    if (AddStreamFn CacheAddStream = Cache(Task, Key))
-      return RunThinBackend(CacheAddStream);
+      Stats.CacheHit = true;
+      return Error::success();
+    };
 
-    return Error::success();
+    Error E = RunTask();
+    if (!E && Conf.BackendStatsHook)
+      Conf.BackendStatsHook(Stats);
+    return E;
   }
 
   Error start(
@@ -1277,6 +1310,10 @@ public:
   }
 
   Error wait() override { return Error::success(); }
+
+  // The list of linked objects file and the OnWrite callbacks see modules in
+  // the order in which they are started.
+  bool isSensitiveToInputOrder() override { return true; }
 };
 } // end anonymous namespace
 
@@ -1292,6 +1329,222 @@ ThinBackend lto::createWriteIndexesThinBackend(
   };
 }
 
+static const char ThinLinkCacheMagic[] = "LLVMTHINLINK1";
+
+// Computes the key of the thin link cache entry holding the results of the
+// cross-module import analysis. The analysis only depends on the contents of
+// the combined index, which are determined by the input modules (identified by
+// their hashes) and by the changes made to the summaries by the earlier steps
+// of the thin link, i.e. dead stripping, read/write-only analysis and
+// synthetic entry counts, and by the importing thresholds. Returns an empty
+// string if a module has no hash.
+static std::string
+computeThinLinkCacheKey(const Config &Conf, const ModuleSummaryIndex &Index,
+                        const MapVector<StringRef, BitcodeModule> &ModuleMap) {
+  SHA1 Hasher;
+  Hasher.update(LLVM_VERSION_STRING);
+#ifdef LLVM_REVISION
+  Hasher.update(LLVM_REVISION);
+#endif
+
+  auto AddUint64 = [&](uint64_t I) {
+    uint8_t Data[8];
+    support::endian::write64le(Data, I);
+    Hasher.update(ArrayRef<uint8_t>{Data, 8});
+  };
+  auto AddString = [&](StringRef Str) {
+    AddUint64(Str.size());
+    Hasher.update(Str);
+  };
+
+  AddUint64(Conf.OptLevel);
+  AddUint64(Index.withGlobalValueDeadStripping());
+  AddUint64(Index.withAttributePropagation());
+  AddString(getCrossModuleImportOptionsKey());
+
+  for (auto &Mod : ModuleMap) {
+    if (!Index.modulePaths().count(Mod.first))
+      return "";
+    const ModuleHash &Hash = Index.getModuleHash(Mod.first);
+    if (all_of(Hash, [](uint32_t V) { return V == 0; }))
+      return "";
+    AddString(Mod.first);
+    Hasher.update(ArrayRef<uint8_t>((const uint8_t *)&Hash[0], sizeof(Hash)));
+  }
+
+  for (auto &Entry : Index) {
+    AddUint64(Entry.first);
+    for (auto &S : Entry.second.SummaryList) {
+      GlobalValueSummary::GVFlags Flags = S->flags();
+      AddString(S->modulePath());
+      AddUint64(Flags.Linkage);
+      AddUint64(Flags.NotEligibleToImport);
+      AddUint64(Flags.Live);
+      AddUint64(Flags.DSOLocal);
+      AddUint64(Flags.CanAutoHide);
+      if (auto *FS = dyn_cast<FunctionSummary>(S.get()))
+        AddUint64(FS->entryCount());
+      if (auto *GVS = dyn_cast<GlobalVarSummary>(S.get())) {
+        AddUint64(GVS->maybeReadOnly());
+        AddUint64(GVS->maybeWriteOnly());
+      }
+    }
+  }
+  return toHex(Hasher.result());
+}
+
+// A thin link cache entry consists of the magic string followed by the import
+// lists and the export lists of all modules. All integers are 64-bit
+// little-endian, strings are prefixed with their sizes, and lists are prefixed
+// with their number of elements and sorted so that entries are reproducible.
+static void writeThinLinkCacheEntry(
+    StringRef CacheDir, StringRef EntryPath,
+    const StringMap<FunctionImporter::ImportMapTy> &ImportLists,
+    const StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
+  SmallString<0> Buf;
+  raw_svector_ostream OS(Buf);
+  auto WriteUint64 = [&](uint64_t V) {
+    support::endian::write<uint64_t>(OS, V, support::little);
+  };
+  auto WriteString = [&](StringRef Str) {
+    WriteUint64(Str.size());
+    OS << Str;
+  };
+  auto WriteGUIDs = [&](std::vector<GlobalValue::GUID> &GUIDs) {
+    llvm::sort(GUIDs);
+    WriteUint64(GUIDs.size());
+    for (GlobalValue::GUID GUID : GUIDs)
+      WriteUint64(GUID);
+  };
+  auto GetSortedKeys = [](const auto &Map) {
+    std::vector<StringRef> Keys;
+    for (auto &Entry : Map)
+      Keys.push_back(Entry.first());
+    llvm::sort(Keys);
+    return Keys;
+  };
+
+  OS << ThinLinkCacheMagic;
+  std::vector<StringRef> ImportingModules = GetSortedKeys(ImportLists);
+  WriteUint64(ImportingModules.size());
+  for (StringRef ModPath : ImportingModules) {
+    const FunctionImporter::ImportMapTy &ImportList =
+        ImportLists.find(ModPath)->second;
+    std::vector<StringRef> SourceModules = GetSortedKeys(ImportList);
+    WriteString(ModPath);
+    WriteUint64(SourceModules.size());
+    for (StringRef SrcPath : SourceModules) {
+      const FunctionImporter::FunctionsToImportTy &Functions =
+          ImportList.find(SrcPath)->second;
+      std::vector<GlobalValue::GUID> GUIDs(Functions.begin(), Functions.end());
+      WriteString(SrcPath);
+      WriteGUIDs(GUIDs);
+    }
+  }
+
+  std::vector<StringRef> ExportingModules = GetSortedKeys(ExportLists);
+  WriteUint64(ExportingModules.size());
+  for (StringRef ModPath : ExportingModules) {
+    std::vector<GlobalValue::GUID> GUIDs;
+    for (ValueInfo VI : ExportLists.find(ModPath)->second)
+      GUIDs.push_back(VI.getGUID());
+    WriteString(ModPath);
+    WriteGUIDs(GUIDs);
+  }
+
+  // The cache is only an optimization, so failing to update it is not an
+  // error. Write to a temporary file to avoid racing with concurrent links.
+  if (sys::fs::create_directories(CacheDir))
+    return;
+  SmallString<64> TempFilenameModel;
+  sys::path::append(TempFilenameModel, CacheDir, "ThinLink-%%%%%%.tmp");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempFilenameModel, sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+  {
+    raw_fd_ostream TempOS(Temp->FD, /*shouldClose=*/false);
+    TempOS << Buf;
+  }
+  if (Error E = Temp->keep(EntryPath)) {
+    consumeError(std::move(E));
+    consumeError(Temp->discard());
+  }
+}
+
+// Reads the import and export lists from a thin link cache entry. Returns false
+// if the entry doesn't exist or is malformed.
+static bool
+readThinLinkCacheEntry(StringRef EntryPath, const ModuleSummaryIndex &Index,
+                       StringMap<FunctionImporter::ImportMapTy> &ImportLists,
+                       StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
+  // Update the access time so that the cache pruner sees the entry as used.
+  Expected<sys::fs::file_t> FDOrErr =
+      sys::fs::openNativeFileForRead(EntryPath, sys::fs::OF_UpdateAtime);
+  if (!FDOrErr) {
+    consumeError(FDOrErr.takeError());
+    return false;
+  }
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr = MemoryBuffer::getOpenFile(
+      *FDOrErr, EntryPath, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  sys::fs::closeFile(*FDOrErr);
+  if (!MBOrErr)
+    return false;
+
+  StringRef Data = (*MBOrErr)->getBuffer();
+  bool Valid = Data.consume_front(ThinLinkCacheMagic);
+  auto ReadUint64 = [&]() -> uint64_t {
+    if (Data.size() < 8) {
+      Valid = false;
+      return 0;
+    }
+    uint64_t V = support::endian::read64le(Data.data());
+    Data = Data.drop_front(8);
+    return V;
+  };
+  auto ReadString = [&]() -> StringRef {
+    uint64_t Size = ReadUint64();
+    if (Data.size() < Size) {
+      Valid = false;
+      return "";
+    }
+    StringRef Str = Data.take_front(Size);
+    Data = Data.drop_front(Size);
+    return Str;
+  };
+
+  for (uint64_t I = 0, E = ReadUint64(); Valid && I != E; ++I) {
+    FunctionImporter::ImportMapTy &ImportList = ImportLists[ReadString()];
+    for (uint64_t J = 0, NumSources = ReadUint64(); Valid && J != NumSources;
+         ++J) {
+      FunctionImporter::FunctionsToImportTy &Functions =
+          ImportList[ReadString()];
+      for (uint64_t K = 0, NumGUIDs = ReadUint64(); Valid && K != NumGUIDs;
+           ++K)
+        Functions.insert(ReadUint64());
+    }
+  }
+
+  for (uint64_t I = 0, E = ReadUint64(); Valid && I != E; ++I) {
+    FunctionImporter::ExportSetTy &ExportList = ExportLists[ReadString()];
+    for (uint64_t J = 0, NumGUIDs = ReadUint64(); Valid && J != NumGUIDs;
+         ++J) {
+      ValueInfo VI = Index.getValueInfo(ReadUint64());
+      if (Valid && !VI)
+        Valid = false;
+      ExportList.insert(VI);
+    }
+  }
+
+  if (Valid && Data.empty())
+    return true;
+  ImportLists.clear();
+  ExportLists.clear();
+  return false;
+}
+
 Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache,
                       const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
   if (ThinLTO.ModuleMap.empty())
@@ -1344,9 +1597,29 @@ Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache,
   runWholeProgramDevirtOnIndex(ThinLTO.CombinedIndex, ExportedGUIDs,
                                LocalWPDTargetsMap);
 
-  if (Conf.OptLevel > 0)
-    ComputeCrossModuleImport(ThinLTO.CombinedIndex, ModuleToDefinedGVSummaries,
-                             ImportLists, ExportLists);
+  if (Conf.OptLevel > 0) {
+    // The cross-module import analysis is the most expensive part of the thin
+    // link, so its results can be reused by a link with the same inputs.
+    SmallString<64> CacheEntryPath;
+    if (!Conf.ThinLinkCacheDir.empty()) {
+      std::string Key = computeThinLinkCacheKey(Conf, ThinLTO.CombinedIndex,
+                                                ThinLTO.ModuleMap);
+      if (!Key.empty())
+        sys::path::append(CacheEntryPath, Conf.ThinLinkCacheDir,
+                          "llvmcache-thinlink-" + Key);
+    }
+
+    if (CacheEntryPath.empty() ||
+        !readThinLinkCacheEntry(CacheEntryPath, ThinLTO.CombinedIndex,
+                                ImportLists, ExportLists)) {
+      ComputeCrossModuleImport(ThinLTO.CombinedIndex,
+                               ModuleToDefinedGVSummaries, ImportLists,
+                               ExportLists);
+      if (!CacheEntryPath.empty())
+        writeThinLinkCacheEntry(Conf.ThinLinkCacheDir, CacheEntryPath,
+                                ImportLists, ExportLists);
+    }
+  }
 
   // Figure out which symbols need to be internalized. This also needs to happen
   // at -O0 because summary-based DCE is implemented using internalization, and
@@ -1403,18 +1676,60 @@ Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache,
 
   // Tasks 0 through ParallelCodeGenParallelismLevel-1 are reserved for combined
   // module and parallel code generation partitions.
-  unsigned Task = RegularLTO.ParallelCodeGenParallelismLevel;
-  for (auto &Mod : ThinLTO.ModuleMap) {
-    if (Error E = BackendProc->start(Task, Mod.second, ImportLists[Mod.first],
-                                     ExportLists[Mod.first],
-                                     ResolvedODR[Mod.first], ThinLTO.ModuleMap))
-      return E;
-    ++Task;
+  // A module keeps the same task ID regardless of the order in which its
+  // backend is started, so the outputs are the same either way.
+  auto ProcessOneModule = [&](size_t I) -> Error {
+    auto &Mod = *(ThinLTO.ModuleMap.begin() + I);
+    return BackendProc->start(RegularLTO.ParallelCodeGenParallelismLevel + I,
+                              Mod.second, ImportLists[Mod.first],
+                              ExportLists[Mod.first], ResolvedODR[Mod.first],
+                              ThinLTO.ModuleMap);
+  };
+
+  size_t NumModules = ThinLTO.ModuleMap.size();
+  std::vector<size_t> Order(NumModules);
+  std::iota(Order.begin(), Order.end(), 0);
+
+  if (!BackendProc->isSensitiveToInputOrder()) {
+    std::vector<uint64_t> Costs(NumModules);
+    for (size_t I = 0; I != NumModules; ++I) {
+      StringRef ModPath = (ThinLTO.ModuleMap.begin() + I)->first;
+      Costs[I] = estimateThinLTOBackendCost(
+          ThinLTO.CombinedIndex, ModuleToDefinedGVSummaries[ModPath],
+          ImportLists[ModPath]);
+    }
+    llvm::stable_sort(Order,
+                      [&](size_t L, size_t R) { return Costs[L] > Costs[R]; });
   }
 
+  for (size_t I : Order)
+    if (Error E = ProcessOneModule(I))
+      return E;
+
   return BackendProc->wait();
 }
 
+uint64_t lto::estimateThinLTOBackendCost(
+    const ModuleSummaryIndex &Index, const GVSummaryMapTy &DefinedGlobals,
+    const FunctionImporter::ImportMapTy &ImportList) {
+  // Aliases are not counted separately from their aliasees.
+  auto GetInstCount = [](const GlobalValueSummary *S) -> uint64_t {
+    if (auto *FS = dyn_cast<FunctionSummary>(S))
+      return FS->instCount();
+    return 0;
+  };
+
+  uint64_t Cost = 0;
+  for (auto &GS : DefinedGlobals)
+    Cost += GetInstCount(GS.second);
+  for (auto &Entry : ImportList)
+    for (GlobalValue::GUID GUID : Entry.second)
+      if (const GlobalValueSummary *S =
+              Index.findSummaryInModule(GUID, Entry.first()))
+        Cost += GetInstCount(S);
+  return Cost;
+}
+
 Expected<std::unique_ptr<ToolOutputFile>> lto::setupLLVMOptimizationRemarks(
     LLVMContext &Context, StringRef RemarksFilename, StringRef RemarksPasses,
     StringRef RemarksFormat, bool RemarksWithHotness, int Count) {
@@ -288,6 +288,7 @@ static void runOldPMPasses(const Config &Conf, Module &Mod, TargetMachine *TM,
   PMB.VerifyOutput = !Conf.DisableVerify;
   PMB.LoopVectorize = true;
   PMB.SLPVectorize = true;
+  PMB.MergeFunctions = Conf.PTO.MergeFunctions;
   PMB.OptLevel = Conf.OptLevel;
   PMB.PGOSampleUse = Conf.SampleProfile;
   PMB.EnablePGOCSInstrGen = Conf.RunCSIRInstr;
@@ -415,7 +416,7 @@ void splitCodeGen(const Config &C, TargetMachine *TM, AddStreamFn AddStream,
             // copied into the thread's context.
             std::move(BC), ThreadCount++);
       },
-      false);
+      /*PreserveLocals=*/false, /*ClusterByAffinity=*/true);
 
   // Because the inner lambda (which runs in a worker thread) captures our local
   // variables, we need to wait for the worker threads to terminate before we
@@ -458,18 +459,38 @@ Error lto::backend(const Config &C, AddStreamFn AddStream,
 
   std::unique_ptr<TargetMachine> TM = createTargetMachine(C, *TOrErr, *Mod);
 
+  BackendStats Stats;
+  Stats.ModuleID = Mod->getModuleIdentifier();
+  BackendStats *StatsPtr = C.BackendStatsHook ? &Stats : nullptr;
+
   if (!C.CodeGenOnly) {
-    if (!opt(C, TM.get(), 0, *Mod, /*IsThinLTO=*/false,
-             /*ExportSummary=*/&CombinedIndex, /*ImportSummary=*/nullptr))
+    bool ShouldCodeGen;
+    {
+      BackendStatsTimer T(StatsPtr, &BackendStats::OptTime);
+      ShouldCodeGen =
+          opt(C, TM.get(), 0, *Mod, /*IsThinLTO=*/false,
+              /*ExportSummary=*/&CombinedIndex, /*ImportSummary=*/nullptr);
+    }
+    // A hook stopped the pipeline; the task still finished.
+    if (!ShouldCodeGen) {
+      if (C.BackendStatsHook)
+        C.BackendStatsHook(Stats);
       return Error::success();
+    }
   }
 
-  if (ParallelCodeGenParallelismLevel == 1) {
-    codegen(C, TM.get(), AddStream, 0, *Mod);
-  } else {
-    splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel,
-                 std::move(Mod));
+  {
+    BackendStatsTimer T(StatsPtr, &BackendStats::CodeGenTime);
+    if (ParallelCodeGenParallelismLevel == 1) {
+      codegen(C, TM.get(), AddStream, 0, *Mod);
+    } else {
+      splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel,
+                   std::move(Mod));
+    }
   }
+
+  if (C.BackendStatsHook)
+    C.BackendStatsHook(Stats);
   return Error::success();
 }
 
@@ -494,11 +515,28 @@ static void dropDeadSymbols(Module &Mod, const GVSummaryMapTy &DefinedGlobals,
   }
 }
 
+// Materializes the functions of a lazily loaded module, except for those that
+// are dead according to the summaries. dropDeadSymbols() drops their bodies
+// later without ever reading them.
+static Error materializeLiveFunctions(Module &Mod,
+                                      const GVSummaryMapTy &DefinedGlobals,
+                                      const ModuleSummaryIndex &Index) {
+  for (Function &F : Mod) {
+    GlobalValueSummary *GVS = DefinedGlobals.lookup(F.getGUID());
+    if (GVS && !Index.isGlobalValueLive(GVS))
+      continue;
+    if (Error Err = F.materialize())
+      return Err;
+  }
+  return Error::success();
+}
+
 Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
                        Module &Mod, const ModuleSummaryIndex &CombinedIndex,
                        const FunctionImporter::ImportMapTy &ImportList,
                        const GVSummaryMapTy &DefinedGlobals,
-                       MapVector<StringRef, BitcodeModule> &ModuleMap) {
+                       MapVector<StringRef, BitcodeModule> &ModuleMap,
+                       BackendStats *Stats) {
   Expected<const Target *> TOrErr = initAndLookupTarget(Conf, Mod);
   if (!TOrErr)
     return TOrErr.takeError();
@@ -513,7 +551,21 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
     return DiagFileOrErr.takeError();
   auto DiagnosticOutputFile = std::move(*DiagFileOrErr);
 
+  // Code generation and the pre-optimization hook see the whole module. In all
+  // other cases, dead functions are left unmaterialized until they are dropped.
+  {
+    BackendStatsTimer T(Stats, &BackendStats::ReadBitcodeTime);
+    if (Conf.CodeGenOnly || Conf.PreOptModuleHook) {
+      if (Error Err = Mod.materializeAll())
+        return Err;
+    } else if (Error Err = materializeLiveFunctions(Mod, DefinedGlobals,
+                                                    CombinedIndex)) {
+      return Err;
+    }
+  }
+
   if (Conf.CodeGenOnly) {
+    BackendStatsTimer T(Stats, &BackendStats::CodeGenTime);
     codegen(Conf, TM.get(), AddStream, Task, Mod);
     return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
   }
@@ -527,6 +579,13 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
 
   thinLTOResolvePrevailingInModule(Mod, DefinedGlobals);
 
+  // Read what is left of a lazily loaded module before it is modified further.
+  {
+    BackendStatsTimer T(Stats, &BackendStats::ReadBitcodeTime);
+    if (Error Err = Mod.materializeAll())
+      return Err;
+  }
+
   if (Conf.PostPromoteModuleHook && !Conf.PostPromoteModuleHook(Task, Mod))
     return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
 
@@ -547,17 +606,26 @@ Error lto::thinBackend(const Config &Conf, unsigned Task, AddStreamFn AddStream,
                                    /*IsImporting*/ true);
   };
 
-  FunctionImporter Importer(CombinedIndex, ModuleLoader);
-  if (Error Err = Importer.importFunctions(Mod, ImportList).takeError())
-    return Err;
+  {
+    BackendStatsTimer T(Stats, &BackendStats::ImportTime);
+    FunctionImporter Importer(CombinedIndex, ModuleLoader);
+    if (Error Err = Importer.importFunctions(Mod, ImportList).takeError())
+      return Err;
+  }
 
   if (Conf.PostImportModuleHook && !Conf.PostImportModuleHook(Task, Mod))
     return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
 
-  if (!opt(Conf, TM.get(), Task, Mod, /*IsThinLTO=*/true,
-           /*ExportSummary=*/nullptr, /*ImportSummary=*/&CombinedIndex))
-    return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+  {
+    BackendStatsTimer T(Stats, &BackendStats::OptTime);
+    if (!opt(Conf, TM.get(), Task, Mod, /*IsThinLTO=*/true,
+             /*ExportSummary=*/nullptr, /*ImportSummary=*/&CombinedIndex))
+      return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+  }
 
-  codegen(Conf, TM.get(), AddStream, Task, Mod);
+  {
+    BackendStatsTimer T(Stats, &BackendStats::CodeGenTime);
+    codegen(Conf, TM.get(), AddStream, Task, Mod);
+  }
   return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
 }
@@ -12,6 +12,7 @@
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
@@ -39,6 +40,7 @@
 #include "llvm/Support/Alignment.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
@@ -46,6 +48,7 @@
 #include "llvm/Support/Host.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SMLoc.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/SwapByteOrder.h"
@@ -65,6 +68,10 @@ using namespace llvm;
 #undef  DEBUG_TYPE
 #define DEBUG_TYPE "reloc-info"
 
+static cl::opt<bool> ParallelCompressDebugSections(
+    "elf-parallel-compress-debug-sections", cl::Hidden, cl::init(false),
+    cl::desc("Compress the debug sections of ELF objects in parallel"));
+
 namespace {
 
 using SectionIndexMapTy = DenseMap<const MCSectionELF *, uint32_t>;
@@ -162,6 +169,20 @@ struct ELFWriter {
                              SmallVectorImpl<char> &CompressedContents,
                              bool ZLibStyle, unsigned Alignment);
 
+  struct CompressedSectionData {
+    SmallVector<char, 0> UncompressedData;
+    SmallVector<char, 0> CompressedContents;
+    bool CompressionFailed = false;
+  };
+
+  // Contents of the debug sections compressed ahead of writing them out.
+  MapVector<const MCSectionELF *, CompressedSectionData> CompressedSections;
+
+  bool shouldCompressSection(const MCAssembler &Asm,
+                             const MCSectionELF &Section) const;
+  void compressDebugSections(const MCAssembler &Asm,
+                             const MCAsmLayout &Layout);
+
 public:
   ELFWriter(ELFObjectWriter &OWriter, raw_pwrite_stream &OS,
             bool IsLittleEndian, DwoMode Mode)
@@ -840,6 +861,50 @@ bool ELFWriter::maybeWriteCompression(
   return true;
 }
 
+bool ELFWriter::shouldCompressSection(const MCAssembler &Asm,
+                                      const MCSectionELF &Section) const {
+  // Compressing debug_frame requires handling alignment fragments which is
+  // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
+  // for writing to arbitrary buffers) for little benefit.
+  StringRef SectionName = Section.getSectionName();
+  return Asm.getContext().getAsmInfo()->compressDebugSections() !=
+             DebugCompressionType::None &&
+         SectionName.startswith(".debug_") && SectionName != ".debug_frame";
+}
+
+// Compressing dominates the time spent writing objects with large debug info,
+// and the debug sections are compressed independently of each other. Render
+// them one at a time, so that errors are still reported in order, and run the
+// compression in parallel.
+void ELFWriter::compressDebugSections(const MCAssembler &Asm,
+                                      const MCAsmLayout &Layout) {
+  for (const MCSection &Sec : Asm) {
+    const MCSectionELF &Section = static_cast<const MCSectionELF &>(Sec);
+    if (Mode == NonDwoOnly && isDwoSection(Section))
+      continue;
+    if (Mode == DwoOnly && !isDwoSection(Section))
+      continue;
+    if (!shouldCompressSection(Asm, Section))
+      continue;
+
+    CompressedSectionData &Data = CompressedSections[&Section];
+    raw_svector_ostream VecOS(Data.UncompressedData);
+    Asm.writeSectionData(VecOS, &Section, Layout);
+  }
+
+  parallel::for_each(
+      parallel::par, CompressedSections.begin(), CompressedSections.end(),
+      [](std::pair<const MCSectionELF *, CompressedSectionData> &Entry) {
+        CompressedSectionData &Data = Entry.second;
+        if (Error E = zlib::compress(StringRef(Data.UncompressedData.data(),
+                                               Data.UncompressedData.size()),
+                                     Data.CompressedContents)) {
+          consumeError(std::move(E));
+          Data.CompressionFailed = true;
+        }
+      });
+}
+
 void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
                                  const MCAsmLayout &Layout) {
   MCSectionELF &Section = static_cast<MCSectionELF &>(Sec);
@@ -848,13 +913,7 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
   auto &MC = Asm.getContext();
   const auto &MAI = MC.getAsmInfo();
 
-  // Compressing debug_frame requires handling alignment fragments which is
-  // more work (possibly generalizing MCAssembler.cpp:writeFragment to allow
-  // for writing to arbitrary buffers) for little benefit.
-  bool CompressionEnabled =
-      MAI->compressDebugSections() != DebugCompressionType::None;
-  if (!CompressionEnabled || !SectionName.startswith(".debug_") ||
-      SectionName == ".debug_frame") {
+  if (!shouldCompressSection(Asm, Section)) {
     Asm.writeSectionData(W.OS, &Section, Layout);
     return;
   }
@@ -864,16 +923,26 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
          "expected zlib or zlib-gnu style compression");
 
   SmallVector<char, 128> UncompressedData;
-  raw_svector_ostream VecOS(UncompressedData);
-  Asm.writeSectionData(VecOS, &Section, Layout);
-
   SmallVector<char, 128> CompressedContents;
-  if (Error E = zlib::compress(
-          StringRef(UncompressedData.data(), UncompressedData.size()),
-          CompressedContents)) {
-    consumeError(std::move(E));
-    W.OS << UncompressedData;
-    return;
+  auto It = CompressedSections.find(&Section);
+  if (It != CompressedSections.end()) {
+    UncompressedData = std::move(It->second.UncompressedData);
+    CompressedContents = std::move(It->second.CompressedContents);
+    if (It->second.CompressionFailed) {
+      W.OS << UncompressedData;
+      return;
+    }
+  } else {
+    raw_svector_ostream VecOS(UncompressedData);
+    Asm.writeSectionData(VecOS, &Section, Layout);
+
+    if (Error E = zlib::compress(
+            StringRef(UncompressedData.data(), UncompressedData.size()),
+            CompressedContents)) {
+      consumeError(std::move(E));
+      W.OS << UncompressedData;
+      return;
+    }
   }
 
   bool ZlibStyle = MAI->compressDebugSections() == DebugCompressionType::Z;
@@ -1079,6 +1148,9 @@ uint64_t ELFWriter::writeObject(MCAssembler &Asm, const MCAsmLayout &Layout) {
 
   std::map<const MCSymbol *, std::vector<const MCSectionELF *>> GroupMembers;
 
+  if (ParallelCompressDebugSections)
+    compressDebugSections(Asm, Layout);
+
   // Write out the ELF header ...
   writeHeader(Asm);
 
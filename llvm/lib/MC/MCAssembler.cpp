@@ -68,6 +68,8 @@ STATISTIC(FragmentLayouts, "Number of fragment layouts");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
+STATISTIC(SectionRelaxationSteps,
+          "Number of additional section layout and relaxation steps");
 
 } // end namespace stats
 } // end anonymous namespace
@@ -1133,22 +1135,48 @@ bool MCAssembler::relaxFragment(MCAsmLayout &Layout, MCFragment &F) {
   }
 }
 
-bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
-  // Holds the first fragment which needed relaxing during this layout. It will
-  // remain NULL if none were relaxed.
-  // When a fragment is relaxed, all the fragments following it should get
-  // invalidated because their offset is going to change.
-  MCFragment *FirstRelaxedFragment = nullptr;
+bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec,
+                                    bool &WasRelaxed) {
+  // Holds the first fragment which was relaxed after the offsets of the
+  // fragments following it had already been used during this layout. It will
+  // remain NULL if none were.
+  // When such a fragment is relaxed, all the fragments following it should get
+  // invalidated because their offset is going to change, and the section needs
+  // another iteration.
+  MCFragment *FirstStaleFragment = nullptr;
+
+  // Boundary align fragments look at the sizes of the fragments they align
+  // without laying them out. Holds the layout order of the last fragment whose
+  // size has been looked at this way.
+  unsigned LookAheadOrder = 0;
 
   // Attempt to relax all the fragments in the section.
   for (MCFragment &Frag : Sec) {
+    if (auto *BF = dyn_cast<MCBoundaryAlignFragment>(&Frag))
+      if (const MCFragment *Last = BF->getLastFragment())
+        LookAheadOrder = std::max(LookAheadOrder, Last->getLayoutOrder());
+
     // Check if this is a fragment that needs relaxation.
-    bool RelaxedFrag = relaxFragment(Layout, Frag);
-    if (RelaxedFrag && !FirstRelaxedFragment)
-      FirstRelaxedFragment = &Frag;
+    while (relaxFragment(Layout, Frag)) {
+      WasRelaxed = true;
+      if (FirstStaleFragment)
+        break;
+
+      // If nothing past this fragment has been laid out, nothing has seen its
+      // old size, so the rest of the section is laid out on demand with the
+      // new one. Re-lay out just this fragment and check whether it needs to
+      // be relaxed further, instead of iterating over the whole section again.
+      const MCFragment *Next = Frag.getNextNode();
+      if ((Next && Layout.isFragmentValid(Next)) ||
+          LookAheadOrder >= Frag.getLayoutOrder()) {
+        FirstStaleFragment = &Frag;
+        break;
+      }
+      Layout.invalidateFragmentsFrom(&Frag);
+    }
   }
-  if (FirstRelaxedFragment) {
-    Layout.invalidateFragmentsFrom(FirstRelaxedFragment);
+  if (FirstStaleFragment) {
+    Layout.invalidateFragmentsFrom(FirstStaleFragment);
     return true;
   }
   return false;
@@ -1159,8 +1187,8 @@ bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
 
   bool WasRelaxed = false;
   for (MCSection &Sec : *this) {
-    while (layoutSectionOnce(Layout, Sec))
-      WasRelaxed = true;
+    while (layoutSectionOnce(Layout, Sec, WasRelaxed))
+      ++stats::SectionRelaxationSteps;
   }
 
   return WasRelaxed;
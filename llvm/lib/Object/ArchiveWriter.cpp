@@ -12,6 +12,7 @@
 
 #include "llvm/Object/ArchiveWriter.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
@@ -25,6 +26,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -454,7 +456,38 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  // Reading the symbols of a member, and bitcode members in particular, is
+  // the expensive part of building the archive and doesn't depend on the other
+  // members, so do it in parallel. The names are appended to the symbol table
+  // in member order below.
+  std::vector<std::string> MemberSymNames(NewMembers.size());
+  std::vector<Optional<Expected<std::vector<unsigned>>>> MemberSymbols(
+      NewMembers.size());
+  std::vector<uint8_t> MemberHasObject(NewMembers.size());
+  parallel::for_each_n(parallel::par, size_t(0), NewMembers.size(),
+                       [&](size_t I) {
+                         raw_string_ostream Names(MemberSymNames[I]);
+                         bool HasObj = false;
+                         MemberSymbols[I] = getSymbols(
+                             NewMembers[I].Buf->getMemBufferRef(), Names,
+                             HasObj);
+                         MemberHasObject[I] = HasObj;
+                       });
+  // Report the error of the first failing member, as a serial run would.
+  Error Err = Error::success();
+  for (Optional<Expected<std::vector<unsigned>>> &Symbols : MemberSymbols) {
+    if (Error E = Symbols->takeError()) {
+      if (Err)
+        consumeError(std::move(E));
+      else
+        Err = std::move(E);
+    }
+  }
+  if (Err)
+    return std::move(Err);
+
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -490,13 +523,15 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       ModTime, Size);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    std::vector<unsigned> &Symbols = **MemberSymbols[I];
+    HasObject |= MemberHasObject[I];
+    uint64_t SymNamesBase = SymNames.tell();
+    for (unsigned &Offset : Symbols)
+      Offset += SymNamesBase;
+    SymNames << MemberSymNames[I];
 
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
+    Ret.push_back({std::move(Symbols), std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
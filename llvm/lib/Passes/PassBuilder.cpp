@@ -87,6 +87,7 @@
 #include "llvm/Transforms/IPO/GlobalOpt.h"
 #include "llvm/Transforms/IPO/GlobalSplit.h"
 #include "llvm/Transforms/IPO/HotColdSplitting.h"
+#include "llvm/Transforms/IPO/HotFunctionMultiVersioning.h"
 #include "llvm/Transforms/IPO/InferFunctionAttrs.h"
 #include "llvm/Transforms/IPO/Inliner.h"
 #include "llvm/Transforms/IPO/Internalize.h"
@@ -251,9 +252,12 @@ PipelineTuningOptions::PipelineTuningOptions() {
   LicmMssaOptCap = SetLicmMssaOptCap;
   LicmMssaNoAccForPromotionCap = SetLicmMssaNoAccForPromotionCap;
   CallGraphProfile = EnableCallGraphProfile;
+  MergeFunctions = false;
 }
 
 extern cl::opt<bool> EnableHotColdSplit;
+extern cl::opt<bool> EnablePGOHotColdSplit;
+extern cl::opt<bool> EnableHotFunctionMultiVersioning;
 extern cl::opt<bool> EnableOrderFileInstrumentation;
 
 extern cl::opt<bool> FlattenedProfileUsed;
@@ -688,6 +692,17 @@ getInlineParamsFromOptLevel(PassBuilder::OptimizationLevel Level) {
   return getInlineParams(Level.getSpeedupLevel(), Level.getSizeLevel());
 }
 
+/// Hot/cold splitting is enabled explicitly, or by default on modules that
+/// carry a profile summary to tell the cold code apart. The summary is checked
+/// by the pass itself, since with (Thin)LTO the post-link pipeline has no
+/// PGOOptions even though the IR was annotated before the link.
+static void addHotColdSplittingPass(ModulePassManager &MPM) {
+  if (EnableHotColdSplit)
+    MPM.addPass(HotColdSplittingPass());
+  else if (EnablePGOHotColdSplit)
+    MPM.addPass(HotColdSplittingPass(/*RequireProfileSummary=*/true));
+}
+
 ModulePassManager
 PassBuilder::buildModuleSimplificationPipeline(OptimizationLevel Level,
                                                ThinLTOPhase Phase,
@@ -934,6 +949,12 @@ ModulePassManager PassBuilder::buildModuleOptimizationPipeline(
                         PGOOpt->ProfileRemappingFile);
   }
 
+  // Clone the hottest functions for wider vector units before the vectorizer
+  // runs. This needs the final bodies, so it is done after the cross-module
+  // inlining in LTO and ThinLTO.
+  if (EnableHotFunctionMultiVersioning && !LTOPreLink)
+    MPM.addPass(HotFunctionMultiVersioningPass());
+
   // Re-require GloblasAA here prior to function passes. This is particularly
   // useful as the above will have inlined, DCE'ed, and function-attr
   // propagated everything. We should at this point have a reasonably minimal
@@ -1030,8 +1051,8 @@ ModulePassManager PassBuilder::buildModuleOptimizationPipeline(
   // Split out cold code. Splitting is done late to avoid hiding context from
   // other optimizations and inadvertently regressing performance. The tradeoff
   // is that this has a higher code size cost than splitting early.
-  if (EnableHotColdSplit && !LTOPreLink)
-    MPM.addPass(HotColdSplittingPass());
+  if (!LTOPreLink)
+    addHotColdSplittingPass(MPM);
 
   // LoopSink pass sinks instructions hoisted by LICM, which serves as a
   // canonicalization pass that enables other optimizations. As a result,
@@ -1409,8 +1430,7 @@ PassBuilder::buildLTODefaultPipeline(OptimizationLevel Level, bool DebugLogging,
 
   // Enable splitting late in the FullLTO post-link pipeline. This is done in
   // the same stage in the old pass manager (\ref addLateLTOOptimizationPasses).
-  if (EnableHotColdSplit)
-    MPM.addPass(HotColdSplittingPass());
+  addHotColdSplittingPass(MPM);
 
   // Add late LTO optimization passes.
   // Delete basic blocks, which optimization passes may have killed.
@@ -1422,7 +1442,10 @@ PassBuilder::buildLTODefaultPipeline(OptimizationLevel Level, bool DebugLogging,
   // Now that we have optimized the program, discard unreachable functions.
   MPM.addPass(GlobalDCEPass());
 
-  // FIXME: Maybe enable MergeFuncs conditionally after it's ported.
+  // Merge identical functions across the whole program before code
+  // generation, rather than leaving it to the linker's ICF.
+  if (PTO.MergeFunctions)
+    MPM.addPass(MergeFunctionsPass());
   return MPM;
 }
 
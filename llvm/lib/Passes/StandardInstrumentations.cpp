@@ -14,6 +14,8 @@
 
 #include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 #include "llvm/Analysis/LazyCallGraph.h"
 #include "llvm/Analysis/LoopInfo.h"
@@ -21,12 +23,18 @@
 #include "llvm/IR/IRPrintingPasses.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassInstrumentation.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
 
+static cl::opt<bool> ReportAnalysisRecomputes(
+    "report-analysis-recomputes", cl::Hidden,
+    cl::desc("Report the analyses that are recomputed after being "
+             "invalidated, and the time spent recomputing them"));
+
 namespace {
 
 /// Extracting Module out of \p IR unit. Also fills a textual description
@@ -70,6 +78,19 @@ Optional<std::pair<const Module *, std::string>> unwrapModule(Any IR) {
   llvm_unreachable("Unknown IR unit");
 }
 
+/// Returns the address of the IR unit wrapped in \p IR.
+const void *unwrapIRUnit(Any IR) {
+  if (any_isa<const Module *>(IR))
+    return any_cast<const Module *>(IR);
+  if (any_isa<const Function *>(IR))
+    return any_cast<const Function *>(IR);
+  if (any_isa<const LazyCallGraph::SCC *>(IR))
+    return any_cast<const LazyCallGraph::SCC *>(IR);
+  if (any_isa<const Loop *>(IR))
+    return any_cast<const Loop *>(IR);
+  llvm_unreachable("Unknown IR unit");
+}
+
 void printIR(const Function *F, StringRef Banner,
              StringRef Extra = StringRef()) {
   if (!llvm::isFunctionInPrintList(F->getName()))
@@ -243,8 +264,139 @@ void PrintIRInstrumentation::registerCallbacks(
   }
 }
 
+AnalysisRecomputeInstrumentation::AnalysisRecomputeInstrumentation()
+    : AnalysisRecomputeInstrumentation(ReportAnalysisRecomputes) {}
+
+AnalysisRecomputeInstrumentation::AnalysisRecomputeInstrumentation(
+    bool Enabled)
+    : Enabled(Enabled) {}
+
+AnalysisRecomputeInstrumentation::~AnalysisRecomputeInstrumentation() {
+  if (Enabled)
+    print(errs());
+}
+
+bool AnalysisRecomputeInstrumentation::runBeforePass(StringRef PassID,
+                                                     Any IR) {
+  RunningPasses.emplace_back(PassID, unwrapIRUnit(IR));
+  return true;
+}
+
+const void *AnalysisRecomputeInstrumentation::popPass(StringRef PassID) {
+  // A pass that was skipped by another BeforePass callback gets no AfterPass
+  // callback, so it is popped along with the next pass that finishes.
+  while (!RunningPasses.empty()) {
+    std::pair<StringRef, const void *> Pass = RunningPasses.pop_back_val();
+    if (Pass.first == PassID)
+      return Pass.second;
+  }
+  llvm_unreachable("Unbalanced pass callbacks");
+}
+
+void AnalysisRecomputeInstrumentation::runAfterPass(StringRef PassID, Any IR) {
+  popPass(PassID);
+  if (any_isa<const Module *>(IR))
+    forgetDeletedFunctions(*any_cast<const Module *>(IR));
+  setLastPass(PassID);
+}
+
+void AnalysisRecomputeInstrumentation::runAfterPassInvalidated(
+    StringRef PassID) {
+  // The pass deleted or replaced its IR unit, e.g. a loop or an SCC.
+  Computed.erase(popPass(PassID));
+  setLastPass(PassID);
+}
+
+void AnalysisRecomputeInstrumentation::forgetDeletedFunctions(
+    const Module &M) {
+  SmallPtrSet<const Function *, 32> Functions;
+  for (const Function &F : M)
+    Functions.insert(&F);
+  for (auto I = Computed.begin(), E = Computed.end(); I != E;) {
+    auto Cur = I++;
+    if (Cur->second.Parent && !Functions.count(Cur->second.Parent))
+      Computed.erase(Cur);
+  }
+}
+
+void AnalysisRecomputeInstrumentation::runBeforeAnalysis(StringRef AnalysisID,
+                                                         Any IR) {
+  IRUnitInfo &Info = Computed[unwrapIRUnit(IR)];
+  if (any_isa<const Function *>(IR))
+    Info.Parent = any_cast<const Function *>(IR);
+  else if (any_isa<const Loop *>(IR))
+    Info.Parent = any_cast<const Loop *>(IR)->getHeader()->getParent();
+
+  // Analyses are only run when their result is not cached, so seeing the same
+  // IR unit again means that the previous result was invalidated.
+  Optional<TimeRecord> Start;
+  if (is_contained(Info.Analyses, AnalysisID))
+    Start = TimeRecord::getCurrentTime(/*Start=*/true);
+  else
+    Info.Analyses.push_back(AnalysisID);
+  RunningAnalyses.emplace_back(AnalysisID, Start);
+}
+
+void AnalysisRecomputeInstrumentation::runAfterAnalysis(StringRef AnalysisID) {
+  assert(!RunningAnalyses.empty() &&
+         RunningAnalyses.back().first == AnalysisID &&
+         "Unbalanced analysis callbacks");
+  Optional<TimeRecord> Start = RunningAnalyses.pop_back_val().second;
+  if (!Start)
+    return;
+
+  RecomputeInfo &Info = Recomputes[{AnalysisID, LastPassID}];
+  ++Info.Count;
+  Info.WallTime += TimeRecord::getCurrentTime(/*Start=*/false).getWallTime() -
+                   Start->getWallTime();
+}
+
+void AnalysisRecomputeInstrumentation::setLastPass(StringRef PassID) {
+  // Pass managers and adaptors finish after the passes they run, which are
+  // the ones to blame.
+  if (PassID.startswith("PassManager<") || PassID.contains("PassAdaptor<"))
+    return;
+  LastPassID = PassID;
+}
+
+void AnalysisRecomputeInstrumentation::print(raw_ostream &OS) const {
+  if (Recomputes.empty())
+    return;
+
+  std::vector<std::pair<std::pair<StringRef, StringRef>, RecomputeInfo>>
+      Sorted(Recomputes.begin(), Recomputes.end());
+  llvm::stable_sort(Sorted, [](const auto &LHS, const auto &RHS) {
+    return LHS.second.WallTime > RHS.second.WallTime;
+  });
+
+  OS << "Analyses recomputed after invalidation:\n";
+  OS << "  Wall Time  Count  Analysis <- Last Pass\n";
+  for (const auto &Entry : Sorted)
+    OS << formatv("  {0,9:F4}  {1,5}  {2} <- {3}\n", Entry.second.WallTime,
+                  Entry.second.Count, Entry.first.first,
+                  Entry.first.second.empty() ? "<none>" : Entry.first.second);
+}
+
+void AnalysisRecomputeInstrumentation::registerCallbacks(
+    PassInstrumentationCallbacks &PIC) {
+  if (!Enabled)
+    return;
+
+  PIC.registerBeforeAnalysisCallback(
+      [this](StringRef P, Any IR) { this->runBeforeAnalysis(P, IR); });
+  PIC.registerAfterAnalysisCallback(
+      [this](StringRef P, Any) { this->runAfterAnalysis(P); });
+  PIC.registerBeforePassCallback(
+      [this](StringRef P, Any IR) { return this->runBeforePass(P, IR); });
+  PIC.registerAfterPassCallback(
+      [this](StringRef P, Any IR) { this->runAfterPass(P, IR); });
+  PIC.registerAfterPassInvalidatedCallback(
+      [this](StringRef P) { this->runAfterPassInvalidated(P); });
+}
+
 void StandardInstrumentations::registerCallbacks(
     PassInstrumentationCallbacks &PIC) {
   PrintIR.registerCallbacks(PIC);
   TimePasses.registerCallbacks(PIC);
+  AnalysisRecomputes.registerCallbacks(PIC);
 }
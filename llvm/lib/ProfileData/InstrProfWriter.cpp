@@ -251,9 +251,15 @@ void InstrProfWriter::addRecord(StringRef Name, uint64_t Hash,
 
 void InstrProfWriter::mergeRecordsFromWriter(InstrProfWriter &&IPW,
                                              function_ref<void(Error)> Warn) {
-  for (auto &I : IPW.FunctionData)
-    for (auto &Func : I.getValue())
-      addRecord(I.getKey(), Func.first, std::move(Func.second), 1, Warn);
+  // Release the records of IPW as they are merged so that the peak memory use
+  // of merging two large writers stays close to the size of the result.
+  for (auto I = IPW.FunctionData.begin(), E = IPW.FunctionData.end();
+       I != E;) {
+    auto Cur = I++;
+    for (auto &Func : Cur->getValue())
+      addRecord(Cur->getKey(), Func.first, std::move(Func.second), 1, Warn);
+    IPW.FunctionData.erase(Cur);
+  }
 }
 
 bool InstrProfWriter::shouldEncodeData(const ProfilingData &PD) {
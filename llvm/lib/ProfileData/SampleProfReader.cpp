@@ -557,11 +557,22 @@ std::error_code SampleProfileReaderExtBinary::readFuncProfiles() {
       if (std::error_code EC = readFuncProfile(FuncProfileAddr))
         return EC;
     }
+  } else if (!Remapper) {
+    // The profile usually covers far more functions than the module, so look
+    // up the functions of the module instead of scanning the whole table.
+    for (auto Name : FuncsToUse) {
+      auto iter = FuncOffsetTable.find(Name);
+      if (iter == FuncOffsetTable.end())
+        continue;
+      const uint8_t *FuncProfileAddr = Start + iter->second;
+      assert(FuncProfileAddr < End && "out of LBRProfile section");
+      if (std::error_code EC = readFuncProfile(FuncProfileAddr))
+        return EC;
+    }
   } else {
     for (auto NameOffset : FuncOffsetTable) {
       auto FuncName = NameOffset.first;
-      if (!FuncsToUse.count(FuncName) &&
-          (!Remapper || !Remapper->exist(FuncName)))
+      if (!FuncsToUse.count(FuncName) && !Remapper->exist(FuncName))
         continue;
       const uint8_t *FuncProfileAddr = Start + NameOffset.second;
       assert(FuncProfileAddr < End && "out of LBRProfile section");
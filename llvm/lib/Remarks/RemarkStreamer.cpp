@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Remarks/RemarkStreamer.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 
 using namespace llvm;
@@ -23,11 +24,25 @@ static cl::opt<cl::boolOrDefault> EnableRemarksSection(
         "this is enabled for the following formats: yaml-strtab, bitstream."),
     cl::init(cl::BOU_UNSET), cl::Hidden);
 
+static cl::opt<unsigned> RemarksSampleRate(
+    "remarks-sample-rate",
+    cl::desc("Only emit one in every N remarks of each pass."), cl::init(1),
+    cl::Hidden);
+
+static cl::opt<bool> RemarksAggregate(
+    "remarks-aggregate",
+    cl::desc("Emit a single remark with a count for every remark kind, pass "
+             "and function, instead of one remark per occurrence."),
+    cl::init(false), cl::Hidden);
+
 RemarkStreamer::RemarkStreamer(
     std::unique_ptr<remarks::RemarkSerializer> RemarkSerializer,
     Optional<StringRef> FilenameIn)
     : PassFilter(), RemarkSerializer(std::move(RemarkSerializer)),
-      Filename(FilenameIn ? Optional<std::string>(FilenameIn->str()) : None) {}
+      Filename(FilenameIn ? Optional<std::string>(FilenameIn->str()) : None),
+      SampleRate(1), Aggregate(RemarksAggregate) {
+  setSampleRate(RemarksSampleRate);
+}
 
 Error RemarkStreamer::setFilter(StringRef Filter) {
   Regex R = Regex(Filter);
@@ -70,3 +85,45 @@ bool RemarkStreamer::needsSection() const {
     return false;
   }
 }
+
+void RemarkStreamer::setSampleRate(unsigned Rate) {
+  SampleRate = std::max(Rate, 1u);
+  SampleCounters.clear();
+}
+
+bool RemarkStreamer::isSampled(StringRef PassName) {
+  if (SampleRate == 1)
+    return true;
+  // Keep the first remark of every pass, so that rare remarks still show up.
+  unsigned &Counter = SampleCounters[PassName];
+  return Counter++ % SampleRate == 0;
+}
+
+void RemarkStreamer::emit(const Remark &R) {
+  if (!Aggregate) {
+    RemarkSerializer->emit(R);
+    return;
+  }
+
+  AggregatedRemark &A = AggregatedRemarks[AggregateKey(
+      R.RemarkType, R.PassName.str(), R.RemarkName.str(),
+      R.FunctionName.str())];
+  ++A.Count;
+  if (R.Hotness)
+    A.Hotness = A.Hotness.getValueOr(0) + *R.Hotness;
+}
+
+void RemarkStreamer::finalize() {
+  for (const auto &KV : AggregatedRemarks) {
+    const AggregatedRemark &A = KV.second;
+    Remark R;
+    std::tie(R.RemarkType, R.PassName, R.RemarkName, R.FunctionName) = KV.first;
+    R.Hotness = A.Hotness;
+    std::string Count = utostr(A.Count);
+    R.Args.emplace_back();
+    R.Args.back().Key = "Count";
+    R.Args.back().Val = Count;
+    RemarkSerializer->emit(R);
+  }
+  AggregatedRemarks.clear();
+}
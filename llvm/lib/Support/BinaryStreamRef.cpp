@@ -128,3 +128,10 @@ WritableBinaryStreamRef::operator BinaryStreamRef() const {
 
 /// For buffered streams, commits changes to the backing store.
 Error WritableBinaryStreamRef::commit() { return BorrowedImpl->commit(); }
+
+void WritableBinaryStreamRef::dontNeed(uint32_t Offset, uint32_t Size) const {
+  if (!BorrowedImpl || Offset >= getLength())
+    return;
+  BorrowedImpl->dontNeed(ViewOffset + Offset,
+                         std::min(Size, getLength() - Offset));
+}
@@ -164,6 +164,19 @@ public:
   // This collects the different subcommands that have been registered.
   SmallPtrSet<SubCommand *, 4> RegisteredSubCommands;
 
+  // This collects the options, and the literal names of options without an
+  // argument string, whose constructors have run but that have not been added
+  // to their SubCommands yet. Most options are global variables, so adding
+  // them as they are constructed would fill the option maps before main, even
+  // in programs that never parse a command line. They are added, in the order
+  // they were constructed, the first time the option maps are needed.
+  struct PendingOption {
+    Option *Opt;
+    StringRef LiteralName;
+    bool IsLiteral;
+  };
+  std::vector<PendingOption> PendingOptions;
+
   CommandLineParser() : ActiveSubCommand(nullptr) {
     registerSubCommand(&*TopLevelSubCommand);
     registerSubCommand(&*AllSubCommands);
@@ -171,6 +184,35 @@ public:
 
   void ResetAllOptionOccurrences();
 
+  void registerPendingOptions() {
+    if (LLVM_LIKELY(PendingOptions.empty()))
+      return;
+    // Registering an option can construct others, e.g. by loading a plugin.
+    std::vector<PendingOption> Pending;
+    while (!PendingOptions.empty()) {
+      Pending.swap(PendingOptions);
+      // Most options go to the top level, so make room for all of them at
+      // once instead of growing the map as they are added.
+      StringMap<Option *> &TopLevelOptions = TopLevelSubCommand->OptionsMap;
+      TopLevelOptions.reserve(TopLevelOptions.size() + Pending.size());
+      for (const PendingOption &P : Pending) {
+        if (P.IsLiteral)
+          addLiteralOption(*P.Opt, P.LiteralName);
+        else
+          addOption(P.Opt);
+      }
+      Pending.clear();
+    }
+  }
+
+  void addPendingOption(Option *O) {
+    PendingOptions.push_back({O, StringRef(), /*IsLiteral=*/false});
+  }
+
+  void addPendingLiteralOption(Option &Opt, StringRef Name) {
+    PendingOptions.push_back({&Opt, Name, /*IsLiteral=*/true});
+  }
+
   bool ParseCommandLineOptions(int argc, const char *const *argv,
                                StringRef Overview, raw_ostream *Errs = nullptr,
                                bool LongOptionsUseDoubleDash = false);
@@ -299,6 +341,7 @@ public:
   }
 
   void removeOption(Option *O) {
+    registerPendingOptions();
     if (O->Subs.empty())
       removeOption(O, &*TopLevelSubCommand);
     else {
@@ -317,7 +360,8 @@ public:
             nullptr != Sub.ConsumeAfterOpt);
   }
 
-  bool hasOptions() const {
+  bool hasOptions() {
+    registerPendingOptions();
     for (const auto *S : RegisteredSubCommands) {
       if (hasOptions(*S))
         return true;
@@ -338,6 +382,7 @@ public:
   }
 
   void updateArgStr(Option *O, StringRef NewName) {
+    registerPendingOptions();
     if (O->Subs.empty())
       updateArgStr(O, NewName, &*TopLevelSubCommand);
     else {
@@ -387,11 +432,13 @@ public:
   }
 
   void unregisterSubCommand(SubCommand *sub) {
+    registerPendingOptions();
     RegisteredSubCommands.erase(sub);
   }
 
   iterator_range<typename SmallPtrSet<SubCommand *, 4>::iterator>
   getRegisteredSubcommands() {
+    registerPendingOptions();
     return make_range(RegisteredSubCommands.begin(),
                       RegisteredSubCommands.end());
   }
@@ -406,6 +453,7 @@ public:
 
     ResetAllOptionOccurrences();
     RegisteredSubCommands.clear();
+    PendingOptions.clear();
 
     TopLevelSubCommand->reset();
     AllSubCommands->reset();
@@ -434,7 +482,7 @@ private:
 static ManagedStatic<CommandLineParser> GlobalParser;
 
 void cl::AddLiteralOption(Option &O, StringRef Name) {
-  GlobalParser->addLiteralOption(O, Name);
+  GlobalParser->addPendingLiteralOption(O, Name);
 }
 
 extrahelp::extrahelp(StringRef Help) : morehelp(Help) {
@@ -442,7 +490,7 @@ extrahelp::extrahelp(StringRef Help) : morehelp(Help) {
 }
 
 void Option::addArgument() {
-  GlobalParser->addOption(this);
+  GlobalParser->addPendingOption(this);
   FullyInitialized = true;
 }
 
@@ -526,6 +574,10 @@ Option *CommandLineParser::LookupOption(SubCommand &Sub, StringRef &Arg,
     return nullptr;
   assert(&Sub != &*AllSubCommands);
 
+  // Options constructed while parsing, e.g. by a plugin loaded by an earlier
+  // argument, can be used by the following arguments.
+  registerPendingOptions();
+
   size_t EqualPos = Arg.find('=');
 
   // If we have an equals sign, remember the value.
@@ -1299,6 +1351,7 @@ bool cl::ParseCommandLineOptions(int argc, const char *const *argv,
 void CommandLineParser::ResetAllOptionOccurrences() {
   // So that we can parse different command lines multiple times in succession
   // we reset all option values to look like they have never been seen before.
+  registerPendingOptions();
   for (auto SC : RegisteredSubCommands) {
     for (auto &O : SC->OptionsMap)
       O.second->reset();
@@ -1310,6 +1363,7 @@ bool CommandLineParser::ParseCommandLineOptions(int argc,
                                                 StringRef Overview,
                                                 raw_ostream *Errs,
                                                 bool LongOptionsUseDoubleDash) {
+  registerPendingOptions();
   assert(hasOptions() && "No options specified!");
 
   // Expand response files.
@@ -2161,6 +2215,7 @@ public:
   }
 
   void printHelp() {
+    GlobalParser->registerPendingOptions();
     SubCommand *Sub = GlobalParser->getActiveSubCommand();
     auto &OptionsMap = Sub->OptionsMap;
     auto &PositionalOpts = Sub->PositionalOpts;
@@ -2420,6 +2475,7 @@ void CommandLineParser::printOptionValues() {
   if (!PrintOptions && !PrintAllOptions)
     return;
 
+  registerPendingOptions();
   SmallVector<std::pair<const char *, Option *>, 128> Opts;
   sortOpts(ActiveSubCommand->OptionsMap, Opts, /*ShowHidden*/ true);
 
@@ -2547,6 +2603,7 @@ void cl::AddExtraVersionPrinter(VersionPrinterTy func) {
 }
 
 StringMap<Option *> &cl::getRegisteredOptions(SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   auto &Subs = GlobalParser->RegisteredSubCommands;
   (void)Subs;
   assert(is_contained(Subs, &Sub));
@@ -2559,6 +2616,7 @@ cl::getRegisteredSubcommands() {
 }
 
 void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     for (auto &Cat : I.second->Categories) {
       if (Cat != &Category &&
@@ -2570,6 +2628,7 @@ void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
 
 void cl::HideUnrelatedOptions(ArrayRef<const cl::OptionCategory *> Categories,
                               SubCommand &Sub) {
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     for (auto &Cat : I.second->Categories) {
       if (find(Categories, Cat) == Categories.end() && Cat != &GenericCategory)
@@ -85,6 +85,44 @@ uint32_t zlib::crc32(StringRef Buffer) {
   return ::crc32(0, (const Bytef *)Buffer.data(), Buffer.size());
 }
 
+Error zlib::compressRaw(StringRef InputBuffer,
+                        SmallVectorImpl<char> &CompressedBuffer, int Level,
+                        bool Finish) {
+  z_stream S = {};
+  // A negative window size tells zlib to omit the header and the trailer.
+  int Res = deflateInit2(&S, Level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+  if (Res != Z_OK)
+    return createError(convertZlibCodeToString(Res));
+
+  // deflateBound() doesn't account for the empty block of a sync flush.
+  CompressedBuffer.resize(deflateBound(&S, InputBuffer.size()) + 16);
+  S.next_in = (Bytef *)InputBuffer.data();
+  S.avail_in = InputBuffer.size();
+  S.next_out = (Bytef *)CompressedBuffer.data();
+  S.avail_out = CompressedBuffer.size();
+  Res = deflate(&S, Finish ? Z_FINISH : Z_SYNC_FLUSH);
+  size_t CompressedSize = S.total_out;
+  bool Complete = S.avail_in == 0 && S.avail_out != 0 &&
+                  Res == (Finish ? Z_STREAM_END : Z_OK);
+  deflateEnd(&S);
+
+  // Tell MemorySanitizer that zlib output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented ZLib.
+  __msan_unpoison(CompressedBuffer.data(), CompressedSize);
+  CompressedBuffer.set_size(CompressedSize);
+  if (!Complete)
+    return createError(convertZlibCodeToString(Res < 0 ? Res : Z_BUF_ERROR));
+  return Error::success();
+}
+
+uint32_t zlib::adler32(StringRef Buffer) {
+  return ::adler32(1, (const Bytef *)Buffer.data(), Buffer.size());
+}
+
+uint32_t zlib::adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Size2) {
+  return ::adler32_combine(Adler1, Adler2, Size2);
+}
+
 #else
 bool zlib::isAvailable() { return false; }
 Error zlib::compress(StringRef InputBuffer,
@@ -103,4 +141,15 @@ Error zlib::uncompress(StringRef InputBuffer,
 uint32_t zlib::crc32(StringRef Buffer) {
   llvm_unreachable("zlib::crc32 is unavailable");
 }
+Error zlib::compressRaw(StringRef InputBuffer,
+                        SmallVectorImpl<char> &CompressedBuffer, int Level,
+                        bool Finish) {
+  llvm_unreachable("zlib::compressRaw is unavailable");
+}
+uint32_t zlib::adler32(StringRef Buffer) {
+  llvm_unreachable("zlib::adler32 is unavailable");
+}
+uint32_t zlib::adler32Combine(uint32_t Adler1, uint32_t Adler2, size_t Size2) {
+  llvm_unreachable("zlib::adler32Combine is unavailable");
+}
 #endif
@@ -66,6 +66,10 @@ public:
     consumeError(Temp.discard());
   }
 
+  void dontNeed(size_t Offset, size_t Length) override {
+    Buffer->dontNeed(Offset, Length);
+  }
+
 private:
   std::unique_ptr<fs::mapped_file_region> Buffer;
   fs::TempFile Temp;
@@ -9,9 +9,11 @@
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/Telemetry.h"
 #include <string>
 
 #ifdef _WIN32
@@ -51,6 +53,8 @@ InitLLVM::InitLLVM(int &Argc, const char **&Argv,
   Argc = Args.size() - 1;
   Argv = Args.data();
 #endif
+
+  SetTelemetryToolName(sys::path::stem(Argv[0]));
 }
 
 InitLLVM::~InitLLVM() { llvm_shutdown(); }
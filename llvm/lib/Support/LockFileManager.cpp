@@ -13,18 +13,20 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cerrno>
 #include <chrono>
+#include <condition_variable>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <system_error>
-#include <thread>
 #include <tuple>
 
 #ifdef _WIN32
@@ -46,6 +48,19 @@
 
 using namespace llvm;
 
+namespace {
+/// Wakes up the threads of this process that wait for a lock, whenever a lock
+/// owned by this process is released. Locks owned by other processes are
+/// still only noticed by polling.
+struct UnlockNotifier {
+  std::mutex Mutex;
+  std::condition_variable CV;
+  uint64_t Generation = 0;
+};
+} // end anonymous namespace
+
+static ManagedStatic<UnlockNotifier> Notifier;
+
 /// Attempt to read the lock file with the given name, if it exists.
 ///
 /// \param LockFileName The name of the lock file to read.
@@ -292,6 +307,12 @@ LockFileManager::~LockFileManager() {
   // The unique file is now gone, so remove it from the signal handler. This
   // matches a sys::RemoveFileOnSignal() in LockFileManager().
   sys::DontRemoveFileOnSignal(UniqueLockFileName);
+
+  {
+    std::lock_guard<std::mutex> Lock(Notifier->Mutex);
+    ++Notifier->Generation;
+  }
+  Notifier->CV.notify_all();
 }
 
 LockFileManager::WaitForUnlockResult
@@ -312,16 +333,27 @@ LockFileManager::waitForUnlock(const unsigned MaxSeconds) {
   std::default_random_engine Engine(Device());
 
   auto StartTime = std::chrono::steady_clock::now();
+  uint64_t Generation;
+  {
+    std::lock_guard<std::mutex> Lock(Notifier->Mutex);
+    Generation = Notifier->Generation;
+  }
 
   do {
-    // FIXME: implement event-based waiting
+    // FIXME: implement event-based waiting for locks owned by other processes
 
     // Sleep for the designated interval, to allow the owning process time to
-    // finish up and remove the lock file.
+    // finish up and remove the lock file. If the owner is another thread of
+    // this process, we are woken up as soon as it releases a lock.
     std::uniform_int_distribution<unsigned long> Distribution(1,
                                                               WaitMultiplier);
     unsigned long WaitDurationMS = MinWaitDurationMS * Distribution(Engine);
-    std::this_thread::sleep_for(std::chrono::milliseconds(WaitDurationMS));
+    {
+      std::unique_lock<std::mutex> Lock(Notifier->Mutex);
+      Notifier->CV.wait_for(Lock, std::chrono::milliseconds(WaitDurationMS),
+                            [&] { return Notifier->Generation != Generation; });
+      Generation = Notifier->Generation;
+    }
 
     if (sys::fs::access(LockFileName.c_str(), sys::fs::AccessMode::Exist) ==
         errc::no_such_file_or_directory) {
@@ -218,6 +218,10 @@ public:
   MemoryBuffer::BufferKind getBufferKind() const override {
     return MemoryBuffer::MemoryBuffer_MMap;
   }
+
+  void dontNeedIfMmapped(size_t Offset, size_t Length) override {
+    MFR.dontNeed(this->getBufferStart() - MFR.const_data() + Offset, Length);
+  }
 };
 }
 
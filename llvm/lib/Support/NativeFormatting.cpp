@@ -17,18 +17,47 @@
 
 using namespace llvm;
 
+// The decimal digits of 00 through 99, so that integers can be formatted two
+// digits (and one division) at a time.
+static const char TwoDigitTable[] = "00010203040506070809"
+                                    "10111213141516171819"
+                                    "20212223242526272829"
+                                    "30313233343536373839"
+                                    "40414243444546474849"
+                                    "50515253545556575859"
+                                    "60616263646566676869"
+                                    "70717273747576777879"
+                                    "80818283848586878889"
+                                    "90919293949596979899";
+
 template<typename T, std::size_t N>
 static int format_to_buffer(T Value, char (&Buffer)[N]) {
   char *EndPtr = std::end(Buffer);
   char *CurPtr = EndPtr;
 
-  do {
-    *--CurPtr = '0' + char(Value % 10);
-    Value /= 10;
-  } while (Value);
+  while (Value >= 100) {
+    unsigned Index = static_cast<unsigned>(Value % 100) * 2;
+    Value /= 100;
+    CurPtr -= 2;
+    std::memcpy(CurPtr, &TwoDigitTable[Index], 2);
+  }
+  if (Value >= 10) {
+    CurPtr -= 2;
+    std::memcpy(CurPtr, &TwoDigitTable[static_cast<unsigned>(Value) * 2], 2);
+  } else {
+    *--CurPtr = '0' + char(Value);
+  }
   return EndPtr - CurPtr;
 }
 
+static void writeZeros(raw_ostream &S, size_t Count) {
+  static const char Zeros[] = "0000000000000000";
+  const size_t ChunkSize = sizeof(Zeros) - 1;
+  for (; Count > ChunkSize; Count -= ChunkSize)
+    S.write(Zeros, ChunkSize);
+  S.write(Zeros, Count);
+}
+
 static void writeWithCommas(raw_ostream &S, ArrayRef<char> Buffer) {
   assert(!Buffer.empty());
 
@@ -53,18 +82,13 @@ static void write_unsigned_impl(raw_ostream &S, T N, size_t MinDigits,
   static_assert(std::is_unsigned<T>::value, "Value is not unsigned!");
 
   char NumberBuffer[128];
-  std::memset(NumberBuffer, '0', sizeof(NumberBuffer));
-
-  size_t Len = 0;
-  Len = format_to_buffer(N, NumberBuffer);
+  size_t Len = format_to_buffer(N, NumberBuffer);
 
   if (IsNegative)
     S << '-';
 
-  if (Len < MinDigits && Style != IntegerStyle::Number) {
-    for (size_t I = Len; I < MinDigits; ++I)
-      S << '0';
-  }
+  if (Len < MinDigits && Style != IntegerStyle::Number)
+    writeZeros(S, MinDigits - Len);
 
   if (Style == IntegerStyle::Number) {
     writeWithCommas(S, ArrayRef<char>(std::end(NumberBuffer) - Len, Len));
@@ -145,16 +169,21 @@ void llvm::write_hex(raw_ostream &S, uint64_t N, HexPrintStyle Style,
   unsigned NumChars =
       std::max(static_cast<unsigned>(W), std::max(1u, Nibbles) + PrefixChars);
 
+  // Only the padding in front of the digits needs to be filled in.
   char NumberBuffer[kMaxWidth];
-  ::memset(NumberBuffer, '0', llvm::array_lengthof(NumberBuffer));
+  ::memset(NumberBuffer, '0', NumChars - Nibbles);
   if (Prefix)
     NumberBuffer[1] = 'x';
+  const char *Digits = Upper ? "0123456789ABCDEF" : "0123456789abcdef";
   char *EndPtr = NumberBuffer + NumChars;
   char *CurPtr = EndPtr;
+  for (; N >= 0x100; N >>= 8) {
+    *--CurPtr = Digits[N & 0xf];
+    *--CurPtr = Digits[(N >> 4) & 0xf];
+  }
   while (N) {
-    unsigned char x = static_cast<unsigned char>(N) % 16;
-    *--CurPtr = hexdigit(x, !Upper);
-    N /= 16;
+    *--CurPtr = Digits[N & 0xf];
+    N >>= 4;
   }
 
   S.write(NumberBuffer, NumChars);
@@ -14,9 +14,9 @@
 
 #include "llvm/Support/Threading.h"
 
+#include <algorithm>
 #include <atomic>
 #include <future>
-#include <stack>
 #include <thread>
 #include <vector>
 
@@ -32,7 +32,16 @@ namespace {
 class Executor {
 public:
   virtual ~Executor() = default;
-  virtual void add(std::function<void()> func) = 0;
+
+  /// Queue \p Func as part of \p Group.
+  virtual void add(std::function<void()> Func, const TaskGroup *Group) = 0;
+
+  /// Called when a task of \p Group finished.
+  virtual void taskDone(const TaskGroup *Group) = 0;
+
+  /// Wait until \p L is done, running the queued tasks of \p Group on the
+  /// calling thread meanwhile.
+  virtual void waitFor(const Latch &L, const TaskGroup *Group) = 0;
 
   static Executor *getDefaultExecutor();
 };
@@ -87,12 +96,42 @@ public:
     static void call(void *Ptr) { ((ThreadPoolExecutor *)Ptr)->stop(); }
   };
 
-  void add(std::function<void()> F) override {
+  void add(std::function<void()> F, const TaskGroup *Group) override {
     {
       std::lock_guard<std::mutex> Lock(Mutex);
-      WorkStack.push(F);
+      WorkStack.push_back({std::move(F), Group});
     }
     Cond.notify_one();
+    WaiterCond.notify_all();
+  }
+
+  void taskDone(const TaskGroup *Group) override {
+    // Take the lock so that a waiter can't miss the notification between
+    // checking its latch and going to sleep.
+    { std::lock_guard<std::mutex> Lock(Mutex); }
+    WaiterCond.notify_all();
+  }
+
+  void waitFor(const Latch &L, const TaskGroup *Group) override {
+    // Only run tasks of the same group. The tasks of a group are always
+    // spawned by code that is nested inside the group, so this bounds the
+    // recursion by the nesting depth. It can't deadlock either: if none of
+    // the tasks of the group are queued, they are all running on other
+    // threads, which only wait for groups nested deeper.
+    std::unique_lock<std::mutex> Lock(Mutex);
+    while (!L.isDone()) {
+      auto It = std::find_if(WorkStack.rbegin(), WorkStack.rend(),
+                             [&](const Task &T) { return T.Group == Group; });
+      if (It == WorkStack.rend()) {
+        WaiterCond.wait(Lock);
+        continue;
+      }
+      std::function<void()> F = std::move(It->F);
+      WorkStack.erase(std::next(It).base());
+      Lock.unlock();
+      F();
+      Lock.lock();
+    }
   }
 
 private:
@@ -103,17 +142,24 @@ private:
       Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
       if (Stop)
         break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
+      std::function<void()> F = std::move(WorkStack.back().F);
+      WorkStack.pop_back();
       Lock.unlock();
-      Task();
+      F();
     }
   }
 
+  struct Task {
+    std::function<void()> F;
+    const TaskGroup *Group;
+  };
+
   std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
+  std::vector<Task> WorkStack;
   std::mutex Mutex;
   std::condition_variable Cond;
+  /// Notified when tasks are queued or finished, for the threads in waitFor.
+  std::condition_variable WaiterCond;
   std::promise<void> ThreadsCreated;
   std::vector<std::thread> Threads;
 };
@@ -145,25 +191,23 @@ Executor *Executor::getDefaultExecutor() {
 }
 } // namespace
 
-static std::atomic<int> TaskGroupInstances;
-
-// Latch::sync() called by the dtor may cause one thread to block. If is a dead
-// lock if all threads in the default executor are blocked. To prevent the dead
-// lock, only allow the first TaskGroup to run tasks parallelly. In the scenario
-// of nested parallel_for_each(), only the outermost one runs parallelly.
-TaskGroup::TaskGroup() : Parallel(TaskGroupInstances++ == 0) {}
-TaskGroup::~TaskGroup() { --TaskGroupInstances; }
+TaskGroup::~TaskGroup() { sync(); }
 
 void TaskGroup::spawn(std::function<void()> F) {
-  if (Parallel) {
-    L.inc();
-    Executor::getDefaultExecutor()->add([&, F] {
-      F();
-      L.dec();
-    });
-  } else {
-    F();
-  }
+  L.inc();
+  Executor *E = Executor::getDefaultExecutor();
+  E->add(
+      [this, E, F] {
+        F();
+        L.dec();
+        // L may be gone by now, but the executor outlives all groups.
+        E->taskDone(this);
+      },
+      this);
+}
+
+void TaskGroup::sync() const {
+  Executor::getDefaultExecutor()->waitFor(L, this);
 }
 
 } // namespace detail
@@ -15,6 +15,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/xxhash.h"
 #include <cassert>
 
 using namespace llvm;
@@ -69,18 +70,37 @@ void StringMapImpl::init(unsigned InitSize) {
   TheTable[NumBuckets] = (StringMapEntryBase*)2;
 }
 
+uint32_t StringMapImpl::hash(StringRef Key) {
+  // djbHash is hard to beat for short keys such as identifiers, but it
+  // consumes one byte at a time. xxHash64 reads eight bytes per step, which
+  // makes a difference for long keys like mangled names and paths.
+  if (Key.size() <= 32)
+    return djbHash(Key, 0);
+  return static_cast<uint32_t>(xxHash64(Key));
+}
+
+void StringMapImpl::reserve(unsigned NumEntries) {
+  unsigned NewSize = getMinBucketToReserveForEntries(NumEntries);
+  if (NewSize <= NumBuckets)
+    return;
+  if (NumBuckets == 0)
+    init(NewSize);
+  else
+    RehashTableTo(NewSize, 0);
+}
+
 /// LookupBucketFor - Look up the bucket that the specified string should end
 /// up in.  If it already exists as a key in the map, the Item pointer for the
 /// specified bucket will be non-null.  Otherwise, it will be null.  In either
 /// case, the FullHashValue field of the bucket will be set to the hash value
 /// of the string.
-unsigned StringMapImpl::LookupBucketFor(StringRef Name) {
+unsigned StringMapImpl::LookupBucketFor(StringRef Name,
+                                        uint32_t FullHashValue) {
   unsigned HTSize = NumBuckets;
   if (HTSize == 0) {  // Hash table unallocated so far?
     init(16);
     HTSize = NumBuckets;
   }
-  unsigned FullHashValue = djbHash(Name, 0);
   unsigned BucketNo = FullHashValue & (HTSize-1);
   unsigned *HashTable = (unsigned *)(TheTable + NumBuckets + 1);
 
@@ -131,10 +151,9 @@ unsigned StringMapImpl::LookupBucketFor(StringRef Name) {
 /// FindKey - Look up the bucket that contains the specified key. If it exists
 /// in the map, return the bucket number of the key.  Otherwise return -1.
 /// This does not modify the map.
-int StringMapImpl::FindKey(StringRef Key) const {
+int StringMapImpl::FindKey(StringRef Key, uint32_t FullHashValue) const {
   unsigned HTSize = NumBuckets;
   if (HTSize == 0) return -1;  // Really empty table?
-  unsigned FullHashValue = djbHash(Key, 0);
   unsigned BucketNo = FullHashValue & (HTSize-1);
   unsigned *HashTable = (unsigned *)(TheTable + NumBuckets + 1);
 
@@ -199,7 +218,6 @@ StringMapEntryBase *StringMapImpl::RemoveKey(StringRef Key) {
 /// the appropriate mod-of-hashtable-size.
 unsigned StringMapImpl::RehashTable(unsigned BucketNo) {
   unsigned NewSize;
-  unsigned *HashTable = (unsigned *)(TheTable + NumBuckets + 1);
 
   // If the hash table is now more than 3/4 full, or if fewer than 1/8 of
   // the buckets are empty (meaning that many are filled with tombstones),
@@ -212,7 +230,11 @@ unsigned StringMapImpl::RehashTable(unsigned BucketNo) {
   } else {
     return BucketNo;
   }
+  return RehashTableTo(NewSize, BucketNo);
+}
 
+unsigned StringMapImpl::RehashTableTo(unsigned NewSize, unsigned BucketNo) {
+  unsigned *HashTable = (unsigned *)(TheTable + NumBuckets + 1);
   unsigned NewBucketNo = BucketNo;
   // Allocate one extra bucket which will always be non-empty.  This allows the
   // iterators to stop at end.
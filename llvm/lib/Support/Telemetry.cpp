@@ -0,0 +1,313 @@
+//===-- Telemetry.cpp - Always-on compile-time counters -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements TelemetryCounter and the export of the counters to the
+// file named by LLVM_TELEMETRY_FILE.
+//
+// A counter is assigned a slot when it is first updated. Every thread that
+// updates a counter gets a block with one slot per counter, which only that
+// thread writes to, so an update is a plain load and store on memory no other
+// thread writes. Readers sum the slot over all blocks; the slots are relaxed
+// atomics so that this is not a data race.
+//
+// llvm_shutdown starts a new generation of counters. Only the owner of a block
+// clears it, so a block that a live thread owns at that point is ignored by
+// readers until the thread clears it on its next update.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Telemetry.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if LLVM_ON_UNIX
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace llvm;
+
+namespace {
+/// The number of counters that get a slot in the per-thread blocks. Counters
+/// registered beyond that share a single atomic per counter instead.
+constexpr unsigned NumThreadSlots = 512;
+
+struct ThreadSlots {
+  std::atomic<uint64_t> Values[NumThreadSlots];
+  ThreadSlots *Next;
+  /// Whether a live thread owns this block. Only the owner writes to it.
+  std::atomic<bool> InUse;
+  /// The generation the values belong to. Blocks of an older generation are
+  /// not counted.
+  std::atomic<unsigned> Generation;
+
+  ThreadSlots(ThreadSlots *Next, unsigned Generation)
+      : Next(Next), InUse(true) {
+    reset(Generation);
+  }
+
+  /// Clears the values for a new generation. Only the owner may call this.
+  void reset(unsigned NewGeneration) {
+    for (std::atomic<uint64_t> &V : Values)
+      V.store(0, std::memory_order_relaxed);
+    Generation.store(NewGeneration, std::memory_order_release);
+  }
+};
+
+/// The counters that have been updated, and where their values live.
+///
+/// This class is used in a ManagedStatic so that it is created when the first
+/// counter is updated and destroyed when llvm_shutdown is called, which is
+/// when the counters are written to LLVM_TELEMETRY_FILE.
+class TelemetryInfo {
+public:
+  sys::SmartMutex<true> Lock;
+  std::vector<TelemetryCounter *> Counters;
+  /// Values of the counters that did not get a thread slot, indexed by slot
+  /// number minus NumThreadSlots.
+  std::vector<std::unique_ptr<std::atomic<uint64_t>>> SharedValues;
+  std::string ToolName;
+  bool Written = false;
+
+  ~TelemetryInfo();
+
+  unsigned registerCounter(TelemetryCounter &C);
+  uint64_t getValue(unsigned Slot);
+  void printJSON(raw_ostream &OS);
+  void writeFile();
+};
+} // end anonymous namespace
+
+static ManagedStatic<TelemetryInfo> Telemetry;
+
+/// All blocks that have ever been handed out. A block is not freed when its
+/// thread exits, since its values are still part of the counters' sums;
+/// instead it is handed to the next thread that needs one, which keeps adding
+/// to it. The number of blocks is thus bounded by the largest number of
+/// threads that updated counters at the same time.
+static std::atomic<ThreadSlots *> AllThreadSlots;
+
+/// Bumped by each llvm_shutdown, which starts the counters from scratch.
+static std::atomic<unsigned> CurrentGeneration;
+
+static LLVM_THREAD_LOCAL ThreadSlots *CurrentThreadSlots = nullptr;
+static LLVM_THREAD_LOCAL bool ThreadSlotsReleased = false;
+
+namespace {
+/// Gives the block of the current thread back when the thread exits.
+struct ThreadSlotsOwner {
+  ~ThreadSlotsOwner() {
+    if (ThreadSlots *Slots = CurrentThreadSlots)
+      Slots->InUse.store(false, std::memory_order_release);
+    CurrentThreadSlots = nullptr;
+    ThreadSlotsReleased = true;
+  }
+};
+} // end anonymous namespace
+
+static ThreadSlots *createThreadSlots() {
+  unsigned Generation = CurrentGeneration.load(std::memory_order_acquire);
+  ThreadSlots *Slots = nullptr;
+  for (ThreadSlots *S = AllThreadSlots.load(std::memory_order_acquire); S;
+       S = S->Next) {
+    bool Expected = false;
+    if (!S->InUse.load(std::memory_order_relaxed) &&
+        S->InUse.compare_exchange_strong(Expected, true,
+                                         std::memory_order_acquire)) {
+      Slots = S;
+      // The block may have been released before the last llvm_shutdown.
+      if (Slots->Generation.load(std::memory_order_relaxed) != Generation)
+        Slots->reset(Generation);
+      break;
+    }
+  }
+
+  if (!Slots) {
+    ThreadSlots *Head = AllThreadSlots.load(std::memory_order_relaxed);
+    Slots = new ThreadSlots(Head, Generation);
+    while (!AllThreadSlots.compare_exchange_weak(Slots->Next, Slots,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+    }
+  }
+  CurrentThreadSlots = Slots;
+
+  // A counter updated by another thread-local destructor after the owner has
+  // run keeps its block for good rather than recreating the owner.
+  if (!ThreadSlotsReleased) {
+    static thread_local ThreadSlotsOwner Owner;
+    (void)Owner;
+  }
+  return Slots;
+}
+
+TelemetryInfo::~TelemetryInfo() {
+  writeFile();
+  // Start from scratch if a counter is updated after llvm_shutdown.
+  for (TelemetryCounter *C : Counters)
+    C->Slot.store(0, std::memory_order_relaxed);
+  unsigned Generation =
+      CurrentGeneration.fetch_add(1, std::memory_order_acq_rel) + 1;
+  // Clear the blocks no thread owns, taking ownership while doing so. The
+  // others are cleared by their owners.
+  for (ThreadSlots *S = AllThreadSlots.load(std::memory_order_acquire); S;
+       S = S->Next) {
+    bool Expected = false;
+    if (S->InUse.compare_exchange_strong(Expected, true,
+                                         std::memory_order_acquire)) {
+      S->reset(Generation);
+      S->InUse.store(false, std::memory_order_release);
+    }
+  }
+}
+
+unsigned TelemetryInfo::registerCounter(TelemetryCounter &C) {
+  sys::SmartScopedLock<true> Writer(Lock);
+  // Another thread may have registered the counter while we waited.
+  if (unsigned Slot = C.Slot.load(std::memory_order_acquire))
+    return Slot;
+  unsigned Slot = Counters.size();
+  Counters.push_back(&C);
+  if (Slot >= NumThreadSlots)
+    SharedValues.push_back(std::make_unique<std::atomic<uint64_t>>(0));
+  C.Slot.store(Slot + 1, std::memory_order_release);
+  return Slot + 1;
+}
+
+uint64_t TelemetryInfo::getValue(unsigned Slot) {
+  if (Slot >= NumThreadSlots) {
+    sys::SmartScopedLock<true> Reader(Lock);
+    return SharedValues[Slot - NumThreadSlots]->load(
+        std::memory_order_relaxed);
+  }
+  unsigned Generation = CurrentGeneration.load(std::memory_order_acquire);
+  uint64_t Sum = 0;
+  for (ThreadSlots *S = AllThreadSlots.load(std::memory_order_acquire); S;
+       S = S->Next)
+    if (S->Generation.load(std::memory_order_acquire) == Generation)
+      Sum += S->Values[Slot].load(std::memory_order_relaxed);
+  return Sum;
+}
+
+void TelemetryCounter::add(uint64_t V) {
+  unsigned S = Slot.load(std::memory_order_acquire);
+  if (LLVM_UNLIKELY(!S))
+    S = Telemetry->registerCounter(*this);
+  --S;
+
+  if (LLVM_UNLIKELY(S >= NumThreadSlots)) {
+    TelemetryInfo &Info = *Telemetry;
+    sys::SmartScopedLock<true> Reader(Info.Lock);
+    Info.SharedValues[S - NumThreadSlots]->fetch_add(
+        V, std::memory_order_relaxed);
+    return;
+  }
+
+  ThreadSlots *Slots = CurrentThreadSlots;
+  if (LLVM_UNLIKELY(!Slots)) {
+    Slots = createThreadSlots();
+  } else {
+    unsigned Generation = CurrentGeneration.load(std::memory_order_relaxed);
+    if (LLVM_UNLIKELY(Slots->Generation.load(std::memory_order_relaxed) !=
+                      Generation))
+      Slots->reset(Generation);
+  }
+  // Only this thread writes to its block, so there is no need for an atomic
+  // read-modify-write.
+  std::atomic<uint64_t> &Value = Slots->Values[S];
+  Value.store(Value.load(std::memory_order_relaxed) + V,
+              std::memory_order_relaxed);
+}
+
+uint64_t TelemetryCounter::getValue() const {
+  unsigned S = Slot.load(std::memory_order_acquire);
+  if (!S)
+    return 0;
+  return Telemetry->getValue(S - 1);
+}
+
+void llvm::SetTelemetryToolName(StringRef ToolName) {
+  TelemetryInfo &Info = *Telemetry;
+  sys::SmartScopedLock<true> Writer(Info.Lock);
+  Info.ToolName = std::string(ToolName);
+}
+
+void TelemetryInfo::printJSON(raw_ostream &OS) {
+  std::string ToolName;
+  std::vector<std::pair<std::string, TelemetryCounter *>> Sorted;
+  {
+    sys::SmartScopedLock<true> Reader(Lock);
+    ToolName = this->ToolName;
+    for (TelemetryCounter *C : Counters)
+      Sorted.emplace_back((Twine(C->getGroup()) + "." + C->getName()).str(),
+                          C);
+  }
+  llvm::sort(Sorted, less_first());
+
+  json::OStream J(OS);
+  J.object([&] {
+    if (!ToolName.empty())
+      J.attribute("tool", ToolName);
+#if LLVM_ON_UNIX
+    J.attribute("pid", int64_t(::getpid()));
+#elif defined(_WIN32)
+    J.attribute("pid", int64_t(::GetCurrentProcessId()));
+#endif
+    J.attributeObject("counters", [&] {
+      for (const auto &C : Sorted) {
+        unsigned Slot = C.second->Slot.load(std::memory_order_acquire);
+        J.attribute(C.first, int64_t(getValue(Slot - 1)));
+      }
+    });
+  });
+}
+
+void TelemetryInfo::writeFile() {
+  const char *Path = std::getenv("LLVM_TELEMETRY_FILE");
+  if (!Path || !*Path)
+    return;
+  {
+    sys::SmartScopedLock<true> Writer(Lock);
+    if (Written)
+      return;
+    Written = true;
+  }
+
+  std::string Line;
+  raw_string_ostream LineOS(Line);
+  printJSON(LineOS);
+  LineOS << '\n';
+  LineOS.flush();
+
+  // Several processes of a build may share the file. Appending the whole line
+  // with a single write keeps their lines from interleaving.
+  std::error_code EC;
+  raw_fd_ostream OS(Path, EC, sys::fs::OF_Append | sys::fs::OF_Text);
+  if (EC)
+    return;
+  OS.SetUnbuffered();
+  OS << Line;
+}
+
+void llvm::PrintTelemetryJSON(raw_ostream &OS) { Telemetry->printJSON(OS); }
+
+void llvm::WriteTelemetryFile() {
+  // Nothing has been counted if the registry was never created.
+  if (Telemetry.isConstructed())
+    Telemetry->writeFile();
+}
@@ -520,6 +520,88 @@ directory_iterator OverlayFileSystem::dir_begin(const Twine &Dir,
 
 void ProxyFileSystem::anchor() {}
 
+//===-----------------------------------------------------------------------===/
+// StatCachingFileSystem implementation
+//===-----------------------------------------------------------------------===/
+
+SmallString<256> StatCachingFileSystem::getCacheKey(const Twine &Path) const {
+  SmallString<256> Key;
+  Path.toVector(Key);
+  if (makeAbsolute(Key))
+    return {};
+  sys::path::remove_dots(Key, /*remove_dot_dot=*/false);
+  return Key;
+}
+
+bool StatCachingFileSystem::isCacheableError(std::error_code EC) {
+  return EC == errc::no_such_file_or_directory || EC == errc::not_a_directory;
+}
+
+void StatCachingFileSystem::insert(StringRef Key,
+                                   const llvm::ErrorOr<Status> &Entry) {
+  if (Key.empty() || (!Entry && !isCacheableError(Entry.getError())))
+    return;
+  std::lock_guard<std::mutex> Lock(CacheLock);
+  Cache.insert({Key, Entry});
+}
+
+llvm::ErrorOr<Status> StatCachingFileSystem::status(const Twine &Path) {
+  SmallString<256> Key = getCacheKey(Path);
+  if (!Key.empty()) {
+    std::lock_guard<std::mutex> Lock(CacheLock);
+    auto It = Cache.find(Key);
+    if (It != Cache.end()) {
+      ++NumCacheHits;
+      if (!It->second)
+        return It->second.getError();
+      // Report the path the way it was asked for, like a stat would.
+      return Status::copyWithNewName(*It->second, Path);
+    }
+  }
+
+  llvm::ErrorOr<Status> Result = getUnderlyingFS().status(Path);
+  insert(Key, Result);
+  return Result;
+}
+
+llvm::ErrorOr<std::unique_ptr<File>>
+StatCachingFileSystem::openFileForRead(const Twine &Path) {
+  SmallString<256> Key = getCacheKey(Path);
+  if (!Key.empty()) {
+    std::lock_guard<std::mutex> Lock(CacheLock);
+    auto It = Cache.find(Key);
+    if (It != Cache.end() && !It->second) {
+      ++NumCacheHits;
+      return It->second.getError();
+    }
+  }
+
+  auto Result = getUnderlyingFS().openFileForRead(Path);
+  if (!Result) {
+    insert(Key, Result.getError());
+    return Result;
+  }
+  // The status of an open file comes from fstat, which is cheap; remember it
+  // for the stat that usually follows soon for the same path.
+  llvm::ErrorOr<Status> S = (*Result)->status();
+  if (S)
+    insert(Key, Status::copyWithNewName(*S, Key));
+  return Result;
+}
+
+void StatCachingFileSystem::invalidate(const Twine &Path) {
+  SmallString<256> Key = getCacheKey(Path);
+  if (Key.empty())
+    return;
+  std::lock_guard<std::mutex> Lock(CacheLock);
+  Cache.erase(Key);
+}
+
+void StatCachingFileSystem::invalidateAll() {
+  std::lock_guard<std::mutex> Lock(CacheLock);
+  Cache.clear();
+}
+
 namespace llvm {
 namespace vfs {
 
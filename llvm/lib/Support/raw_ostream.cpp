@@ -41,6 +41,10 @@
 # include <unistd.h>
 #endif
 
+#if defined(LLVM_ON_UNIX)
+#include <sys/uio.h>
+#endif
+
 #if defined(__CYGWIN__)
 #include <io.h>
 #endif
@@ -219,6 +223,12 @@ void raw_ostream::flush_nonempty() {
   write_impl(OutBufStart, Length);
 }
 
+void raw_ostream::write_vectored_impl(const char *BufferPtr, size_t BufferSize,
+                                      const char *Ptr, size_t Size) {
+  write_impl(BufferPtr, BufferSize);
+  write_impl(Ptr, Size);
+}
+
 raw_ostream &raw_ostream::write(unsigned char C) {
   // Group exceptional cases into a single branch.
   if (LLVM_UNLIKELY(OutBufCur >= OutBufEnd)) {
@@ -270,6 +280,16 @@ raw_ostream &raw_ostream::write(const char *Ptr, size_t Size) {
       return *this;
     }
 
+    // The string is at least as large as the whole buffer. Write it out along
+    // with what is buffered, rather than copying part of it into the buffer
+    // first.
+    if (Size >= size_t(OutBufEnd - OutBufStart)) {
+      size_t Length = OutBufCur - OutBufStart;
+      OutBufCur = OutBufStart;
+      write_vectored_impl(OutBufStart, Length, Ptr, Size);
+      return *this;
+    }
+
     // We don't have enough space in the buffer to fit the string in. Insert as
     // much as possible, flush and start over with the remainder.
     copy_to_buffer(Ptr, NumBytes);
@@ -740,6 +760,42 @@ void raw_fd_ostream::write_impl(const char *Ptr, size_t Size) {
   } while (Size > 0);
 }
 
+void raw_fd_ostream::write_vectored_impl(const char *BufferPtr,
+                                         size_t BufferSize, const char *Ptr,
+                                         size_t Size) {
+#if defined(LLVM_ON_UNIX)
+  assert(FD >= 0 && "File already closed.");
+  // Gather both pieces into a single writev. Anything unusual, like a short
+  // write or an error, is left to write_impl, which already knows how to
+  // retry and how to report errors.
+  if (BufferSize + Size <= INT32_MAX) {
+    struct iovec IOV[2];
+    IOV[0].iov_base = const_cast<char *>(BufferPtr);
+    IOV[0].iov_len = BufferSize;
+    IOV[1].iov_base = const_cast<char *>(Ptr);
+    IOV[1].iov_len = Size;
+    ssize_t ret;
+    do
+      ret = ::writev(FD, IOV, 2);
+    while (ret < 0 && errno == EINTR);
+
+    if (ret >= 0) {
+      size_t Written = ret;
+      pos += Written;
+      if (Written < BufferSize) {
+        write_impl(BufferPtr + Written, BufferSize - Written);
+        Written = BufferSize;
+      }
+      Written -= BufferSize;
+      if (Written < Size)
+        write_impl(Ptr + Written, Size - Written);
+      return;
+    }
+  }
+#endif
+  raw_ostream::write_vectored_impl(BufferPtr, BufferSize, Ptr, Size);
+}
+
 void raw_fd_ostream::close() {
   assert(ShouldClose);
   ShouldClose = false;
@@ -794,6 +850,11 @@ size_t raw_fd_ostream::preferred_buffer_size() const {
   // the complexity.
   if (S_ISCHR(statbuf.st_mode) && is_displayed())
     return 0;
+  // Files and pipes often receive a lot of output, such as assembly or
+  // textual IR, and the preferred block size (typically 4KiB) means a system
+  // call for every few hundred lines of it. Use a larger buffer for those.
+  if (S_ISREG(statbuf.st_mode) || S_ISFIFO(statbuf.st_mode))
+    return std::max<size_t>(statbuf.st_blksize, 64 * 1024);
   // Return the preferred block size.
   return statbuf.st_blksize;
 #else
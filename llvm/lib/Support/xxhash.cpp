@@ -33,7 +33,10 @@
 */
 
 /* based on revision d2df04efcbef7d7f6886d345861e5dfda4edacc1 Removed
- * everything but a simple interface for computing XXh64. */
+ * everything but a simple interface for computing XXh64.
+ *
+ * The XXH3 functions follow xxHash 0.8.1 (unseeded, default secret only)
+ * and produce the same values as XXH3_64bits and XXH3_128bits. */
 
 #include "llvm/Support/xxhash.h"
 #include "llvm/Support/Endian.h"
@@ -41,6 +44,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LLVM_XXH3_SSE2 1
+#include <emmintrin.h>
+#endif
+
 using namespace llvm;
 using namespace support;
 
@@ -136,3 +145,400 @@ uint64_t llvm::xxHash64(StringRef Data) {
 uint64_t llvm::xxHash64(ArrayRef<uint8_t> Data) {
   return xxHash64({(const char *)Data.data(), Data.size()});
 }
+
+// The XXH3 family. Inputs of up to 240 bytes are mixed with a handful of
+// 64x64->128 bit multiplications. Longer inputs are consumed in 64 byte
+// stripes by eight independent accumulators, which is where SSE2 is used
+// when it is available.
+
+static const uint32_t PRIME32_1 = 0x9E3779B1U;
+static const uint32_t PRIME32_2 = 0x85EBCA77U;
+static const uint32_t PRIME32_3 = 0xC2B2AE3DU;
+static const uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+static const uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+static const size_t XXH3_SECRETSIZE = 192;
+static const size_t XXH3_MIDSIZE_MAX = 240;
+static const size_t XXH3_MIDSIZE_STARTOFFSET = 3;
+static const size_t XXH3_MIDSIZE_LASTOFFSET = 17;
+static const size_t XXH3_SECRETSIZE_MIN = 136;
+static const size_t XXH_STRIPE_LEN = 64;
+static const size_t XXH_SECRET_CONSUME_RATE = 8;
+static const size_t XXH_ACC_NB = 8;
+static const size_t XXH_SECRET_LASTACC_START = 7;
+static const size_t XXH_SECRET_MERGEACCS_START = 11;
+
+// Pseudorandom secret taken directly from FARSH.
+alignas(64) static const uint8_t kSecret[XXH3_SECRETSIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c,
+    0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+    0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e,
+    0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6,
+    0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+    0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97,
+    0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7,
+    0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+    0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83,
+    0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26,
+    0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+    0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f,
+    0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static XXH128_hash_t mult64to128(uint64_t LHS, uint64_t RHS) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t Product = (__uint128_t)LHS * RHS;
+  return {(uint64_t)Product, (uint64_t)(Product >> 64)};
+#else
+  uint64_t LoLo = (LHS & 0xFFFFFFFF) * (RHS & 0xFFFFFFFF);
+  uint64_t HiLo = (LHS >> 32) * (RHS & 0xFFFFFFFF);
+  uint64_t LoHi = (LHS & 0xFFFFFFFF) * (RHS >> 32);
+  uint64_t HiHi = (LHS >> 32) * (RHS >> 32);
+  uint64_t Cross = (LoLo >> 32) + (HiLo & 0xFFFFFFFF) + LoHi;
+  uint64_t Upper = (HiLo >> 32) + (Cross >> 32) + HiHi;
+  uint64_t Lower = (Cross << 32) | (LoLo & 0xFFFFFFFF);
+  return {Lower, Upper};
+#endif
+}
+
+/// Multiply and fold the two halves of the 128 bit product.
+static uint64_t mul128Fold64(uint64_t LHS, uint64_t RHS) {
+  XXH128_hash_t Product = mult64to128(LHS, RHS);
+  return Product.low64 ^ Product.high64;
+}
+
+static uint64_t XXH64_avalanche(uint64_t Hash) {
+  Hash ^= Hash >> 33;
+  Hash *= PRIME64_2;
+  Hash ^= Hash >> 29;
+  Hash *= PRIME64_3;
+  Hash ^= Hash >> 32;
+  return Hash;
+}
+
+static uint64_t XXH3_avalanche(uint64_t Hash) {
+  Hash ^= Hash >> 37;
+  Hash *= PRIME_MX1;
+  Hash ^= Hash >> 32;
+  return Hash;
+}
+
+static uint64_t XXH3_rrmxmx(uint64_t H64, uint64_t Len) {
+  H64 ^= rotl64(H64, 49) ^ rotl64(H64, 24);
+  H64 *= PRIME_MX2;
+  H64 ^= (H64 >> 35) + Len;
+  H64 *= PRIME_MX2;
+  H64 ^= H64 >> 28;
+  return H64;
+}
+
+static uint64_t XXH3_mix16B(const uint8_t *Input, const uint8_t *Secret,
+                            uint64_t Seed) {
+  uint64_t Lhs = endian::read64le(Input) ^ (endian::read64le(Secret) + Seed);
+  uint64_t Rhs =
+      endian::read64le(Input + 8) ^ (endian::read64le(Secret + 8) - Seed);
+  return mul128Fold64(Lhs, Rhs);
+}
+
+/// Process one 64 byte stripe into the accumulators.
+static void XXH3_accumulate_512(uint64_t *Acc, const uint8_t *Input,
+                                const uint8_t *Secret) {
+#ifdef LLVM_XXH3_SSE2
+  __m128i *XAcc = reinterpret_cast<__m128i *>(Acc);
+  for (size_t I = 0; I != XXH_STRIPE_LEN / 16; ++I) {
+    __m128i DataVec =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Input) + I);
+    __m128i KeyVec =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Secret) + I);
+    __m128i DataKey = _mm_xor_si128(DataVec, KeyVec);
+    // Multiply the low 32 bits of each lane with its high 32 bits.
+    __m128i DataKeyLo = _mm_shuffle_epi32(DataKey, _MM_SHUFFLE(0, 3, 0, 1));
+    __m128i Product = _mm_mul_epu32(DataKey, DataKeyLo);
+    // Add the input to the other lane of the pair.
+    __m128i DataSwap = _mm_shuffle_epi32(DataVec, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i Sum = _mm_add_epi64(XAcc[I], DataSwap);
+    XAcc[I] = _mm_add_epi64(Product, Sum);
+  }
+#else
+  for (size_t I = 0; I != XXH_ACC_NB; ++I) {
+    uint64_t DataVal = endian::read64le(Input + 8 * I);
+    uint64_t DataKey = DataVal ^ endian::read64le(Secret + 8 * I);
+    Acc[I ^ 1] += DataVal;
+    Acc[I] += uint32_t(DataKey) * (DataKey >> 32);
+  }
+#endif
+}
+
+static void XXH3_scrambleAcc(uint64_t *Acc, const uint8_t *Secret) {
+#ifdef LLVM_XXH3_SSE2
+  __m128i *XAcc = reinterpret_cast<__m128i *>(Acc);
+  const __m128i Prime32 = _mm_set1_epi32(int(PRIME32_1));
+  for (size_t I = 0; I != XXH_STRIPE_LEN / 16; ++I) {
+    __m128i AccVec = XAcc[I];
+    __m128i DataVec = _mm_xor_si128(AccVec, _mm_srli_epi64(AccVec, 47));
+    __m128i KeyVec =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Secret) + I);
+    __m128i DataKey = _mm_xor_si128(DataVec, KeyVec);
+    // There is no 64x32 bit multiplication, so do it in two halves.
+    __m128i DataKeyHi = _mm_shuffle_epi32(DataKey, _MM_SHUFFLE(0, 3, 0, 1));
+    __m128i ProdLo = _mm_mul_epu32(DataKey, Prime32);
+    __m128i ProdHi = _mm_mul_epu32(DataKeyHi, Prime32);
+    XAcc[I] = _mm_add_epi64(ProdLo, _mm_slli_epi64(ProdHi, 32));
+  }
+#else
+  for (size_t I = 0; I != XXH_ACC_NB; ++I) {
+    uint64_t Acc64 = Acc[I];
+    Acc64 ^= Acc64 >> 47;
+    Acc64 ^= endian::read64le(Secret + 8 * I);
+    Acc64 *= PRIME32_1;
+    Acc[I] = Acc64;
+  }
+#endif
+}
+
+static uint64_t XXH3_mix2Accs(const uint64_t *Acc, const uint8_t *Secret) {
+  return mul128Fold64(Acc[0] ^ endian::read64le(Secret),
+                      Acc[1] ^ endian::read64le(Secret + 8));
+}
+
+static uint64_t XXH3_mergeAccs(const uint64_t *Acc, const uint8_t *Secret,
+                               uint64_t Start) {
+  uint64_t Result64 = Start;
+  for (size_t I = 0; I != 4; ++I)
+    Result64 += XXH3_mix2Accs(Acc + 2 * I, Secret + 16 * I);
+  return XXH3_avalanche(Result64);
+}
+
+/// Run the accumulators over an input longer than XXH3_MIDSIZE_MAX bytes.
+static void XXH3_hashLong(uint64_t *Acc, const uint8_t *Input, size_t Len) {
+  const size_t NbStripesPerBlock =
+      (XXH3_SECRETSIZE - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE;
+  const size_t BlockLen = XXH_STRIPE_LEN * NbStripesPerBlock;
+  const size_t NbBlocks = (Len - 1) / BlockLen;
+  const uint8_t *ScrambleSecret = kSecret + XXH3_SECRETSIZE - XXH_STRIPE_LEN;
+
+  for (size_t N = 0; N != NbBlocks; ++N) {
+    const uint8_t *Block = Input + N * BlockLen;
+    for (size_t S = 0; S != NbStripesPerBlock; ++S)
+      XXH3_accumulate_512(Acc, Block + S * XXH_STRIPE_LEN,
+                          kSecret + S * XXH_SECRET_CONSUME_RATE);
+    XXH3_scrambleAcc(Acc, ScrambleSecret);
+  }
+
+  // The last partial block, and the last stripe which may overlap it.
+  const size_t NbStripes = (Len - 1 - BlockLen * NbBlocks) / XXH_STRIPE_LEN;
+  const uint8_t *Block = Input + NbBlocks * BlockLen;
+  for (size_t S = 0; S != NbStripes; ++S)
+    XXH3_accumulate_512(Acc, Block + S * XXH_STRIPE_LEN,
+                        kSecret + S * XXH_SECRET_CONSUME_RATE);
+  XXH3_accumulate_512(Acc, Input + Len - XXH_STRIPE_LEN,
+                      kSecret + XXH3_SECRETSIZE - XXH_STRIPE_LEN -
+                          XXH_SECRET_LASTACC_START);
+}
+
+static void XXH3_initAcc(uint64_t *Acc) {
+  const uint64_t Init[XXH_ACC_NB] = {PRIME32_3, PRIME64_1, PRIME64_2,
+                                     PRIME64_3, PRIME64_4, PRIME32_2,
+                                     PRIME64_5, PRIME32_1};
+  memcpy(Acc, Init, sizeof(Init));
+}
+
+uint64_t llvm::xxh3_64bits(ArrayRef<uint8_t> Data) {
+  const uint8_t *In = Data.data();
+  const size_t Len = Data.size();
+  const uint8_t *Secret = kSecret;
+
+  if (Len <= 16) {
+    if (Len > 8) {
+      uint64_t BitFlip1 =
+          endian::read64le(Secret + 24) ^ endian::read64le(Secret + 32);
+      uint64_t BitFlip2 =
+          endian::read64le(Secret + 40) ^ endian::read64le(Secret + 48);
+      uint64_t InputLo = endian::read64le(In) ^ BitFlip1;
+      uint64_t InputHi = endian::read64le(In + Len - 8) ^ BitFlip2;
+      uint64_t Acc = Len + ByteSwap_64(InputLo) + InputHi +
+                     mul128Fold64(InputLo, InputHi);
+      return XXH3_avalanche(Acc);
+    }
+    if (Len >= 4) {
+      uint64_t Input1 = endian::read32le(In);
+      uint64_t Input2 = endian::read32le(In + Len - 4);
+      uint64_t BitFlip =
+          endian::read64le(Secret + 8) ^ endian::read64le(Secret + 16);
+      uint64_t Keyed = (Input2 + (Input1 << 32)) ^ BitFlip;
+      return XXH3_rrmxmx(Keyed, Len);
+    }
+    if (Len) {
+      uint32_t Combined = (uint32_t(In[0]) << 16) |
+                          (uint32_t(In[Len >> 1]) << 24) |
+                          uint32_t(In[Len - 1]) | (uint32_t(Len) << 8);
+      uint64_t BitFlip =
+          endian::read32le(Secret) ^ endian::read32le(Secret + 4);
+      return XXH64_avalanche(uint64_t(Combined) ^ BitFlip);
+    }
+    return XXH64_avalanche(endian::read64le(Secret + 56) ^
+                           endian::read64le(Secret + 64));
+  }
+
+  if (Len <= 128) {
+    uint64_t Acc = Len * PRIME64_1;
+    if (Len > 32) {
+      if (Len > 64) {
+        if (Len > 96) {
+          Acc += XXH3_mix16B(In + 48, Secret + 96, 0);
+          Acc += XXH3_mix16B(In + Len - 64, Secret + 112, 0);
+        }
+        Acc += XXH3_mix16B(In + 32, Secret + 64, 0);
+        Acc += XXH3_mix16B(In + Len - 48, Secret + 80, 0);
+      }
+      Acc += XXH3_mix16B(In + 16, Secret + 32, 0);
+      Acc += XXH3_mix16B(In + Len - 32, Secret + 48, 0);
+    }
+    Acc += XXH3_mix16B(In, Secret, 0);
+    Acc += XXH3_mix16B(In + Len - 16, Secret + 16, 0);
+    return XXH3_avalanche(Acc);
+  }
+
+  if (Len <= XXH3_MIDSIZE_MAX) {
+    const size_t NbRounds = Len / 16;
+    uint64_t Acc = Len * PRIME64_1;
+    for (size_t I = 0; I != 8; ++I)
+      Acc += XXH3_mix16B(In + 16 * I, Secret + 16 * I, 0);
+    Acc = XXH3_avalanche(Acc);
+    for (size_t I = 8; I != NbRounds; ++I)
+      Acc += XXH3_mix16B(In + 16 * I,
+                         Secret + 16 * (I - 8) + XXH3_MIDSIZE_STARTOFFSET, 0);
+    Acc += XXH3_mix16B(In + Len - 16,
+                       Secret + XXH3_SECRETSIZE_MIN - XXH3_MIDSIZE_LASTOFFSET,
+                       0);
+    return XXH3_avalanche(Acc);
+  }
+
+  alignas(16) uint64_t Acc[XXH_ACC_NB];
+  XXH3_initAcc(Acc);
+  XXH3_hashLong(Acc, In, Len);
+  return XXH3_mergeAccs(Acc, Secret + XXH_SECRET_MERGEACCS_START,
+                        uint64_t(Len) * PRIME64_1);
+}
+
+/// Two XXH3_mix16B at once, for the two halves of the 128 bit hash.
+static XXH128_hash_t XXH128_mix32B(XXH128_hash_t Acc, const uint8_t *Input1,
+                                   const uint8_t *Input2,
+                                   const uint8_t *Secret, uint64_t Seed) {
+  Acc.low64 += XXH3_mix16B(Input1, Secret, Seed);
+  Acc.low64 ^= endian::read64le(Input2) + endian::read64le(Input2 + 8);
+  Acc.high64 += XXH3_mix16B(Input2, Secret + 16, Seed);
+  Acc.high64 ^= endian::read64le(Input1) + endian::read64le(Input1 + 8);
+  return Acc;
+}
+
+XXH128_hash_t llvm::xxh3_128bits(ArrayRef<uint8_t> Data) {
+  const uint8_t *In = Data.data();
+  const size_t Len = Data.size();
+  const uint8_t *Secret = kSecret;
+
+  if (Len <= 16) {
+    if (Len > 8) {
+      uint64_t BitFlipL =
+          endian::read64le(Secret + 32) ^ endian::read64le(Secret + 40);
+      uint64_t BitFlipH =
+          endian::read64le(Secret + 48) ^ endian::read64le(Secret + 56);
+      uint64_t InputLo = endian::read64le(In);
+      uint64_t InputHi = endian::read64le(In + Len - 8);
+      XXH128_hash_t M128 = mult64to128(InputLo ^ InputHi ^ BitFlipL, PRIME64_1);
+      M128.low64 += uint64_t(Len - 1) << 54;
+      InputHi ^= BitFlipH;
+      M128.high64 += InputHi + uint64_t(uint32_t(InputHi)) * (PRIME32_2 - 1);
+      M128.low64 ^= ByteSwap_64(M128.high64);
+      XXH128_hash_t H128 = mult64to128(M128.low64, PRIME64_2);
+      H128.high64 += M128.high64 * PRIME64_2;
+      H128.low64 = XXH3_avalanche(H128.low64);
+      H128.high64 = XXH3_avalanche(H128.high64);
+      return H128;
+    }
+    if (Len >= 4) {
+      uint64_t InputLo = endian::read32le(In);
+      uint64_t InputHi = endian::read32le(In + Len - 4);
+      uint64_t Input64 = InputLo + (InputHi << 32);
+      uint64_t BitFlip =
+          endian::read64le(Secret + 16) ^ endian::read64le(Secret + 24);
+      XXH128_hash_t M128 =
+          mult64to128(Input64 ^ BitFlip, PRIME64_1 + (uint64_t(Len) << 2));
+      M128.high64 += M128.low64 << 1;
+      M128.low64 ^= M128.high64 >> 3;
+      M128.low64 ^= M128.low64 >> 35;
+      M128.low64 *= PRIME_MX2;
+      M128.low64 ^= M128.low64 >> 28;
+      M128.high64 = XXH3_avalanche(M128.high64);
+      return M128;
+    }
+    if (Len) {
+      uint32_t CombinedL = (uint32_t(In[0]) << 16) |
+                           (uint32_t(In[Len >> 1]) << 24) |
+                           uint32_t(In[Len - 1]) | (uint32_t(Len) << 8);
+      uint32_t Swapped = ByteSwap_32(CombinedL);
+      uint32_t CombinedH = (Swapped << 13) | (Swapped >> 19);
+      uint64_t BitFlipL =
+          endian::read32le(Secret) ^ endian::read32le(Secret + 4);
+      uint64_t BitFlipH =
+          endian::read32le(Secret + 8) ^ endian::read32le(Secret + 12);
+      return {XXH64_avalanche(uint64_t(CombinedL) ^ BitFlipL),
+              XXH64_avalanche(uint64_t(CombinedH) ^ BitFlipH)};
+    }
+    return {XXH64_avalanche(endian::read64le(Secret + 64) ^
+                            endian::read64le(Secret + 72)),
+            XXH64_avalanche(endian::read64le(Secret + 80) ^
+                            endian::read64le(Secret + 88))};
+  }
+
+  if (Len <= XXH3_MIDSIZE_MAX) {
+    XXH128_hash_t Acc = {Len * PRIME64_1, 0};
+    if (Len <= 128) {
+      if (Len > 32) {
+        if (Len > 64) {
+          if (Len > 96)
+            Acc = XXH128_mix32B(Acc, In + 48, In + Len - 64, Secret + 96, 0);
+          Acc = XXH128_mix32B(Acc, In + 32, In + Len - 48, Secret + 64, 0);
+        }
+        Acc = XXH128_mix32B(Acc, In + 16, In + Len - 32, Secret + 32, 0);
+      }
+      Acc = XXH128_mix32B(Acc, In, In + Len - 16, Secret, 0);
+    } else {
+      const size_t NbRounds = Len / 32;
+      for (size_t I = 0; I != 4; ++I)
+        Acc = XXH128_mix32B(Acc, In + 32 * I, In + 32 * I + 16,
+                            Secret + 32 * I, 0);
+      Acc.low64 = XXH3_avalanche(Acc.low64);
+      Acc.high64 = XXH3_avalanche(Acc.high64);
+      for (size_t I = 4; I != NbRounds; ++I)
+        Acc = XXH128_mix32B(Acc, In + 32 * I, In + 32 * I + 16,
+                            Secret + XXH3_MIDSIZE_STARTOFFSET + 32 * (I - 4),
+                            0);
+      // The last 32 bytes.
+      Acc = XXH128_mix32B(Acc, In + Len - 16, In + Len - 32,
+                          Secret + XXH3_SECRETSIZE_MIN -
+                              XXH3_MIDSIZE_LASTOFFSET - 16,
+                          0);
+    }
+    XXH128_hash_t H128;
+    H128.low64 = XXH3_avalanche(Acc.low64 + Acc.high64);
+    H128.high64 = 0 - XXH3_avalanche(Acc.low64 * PRIME64_1 +
+                                     Acc.high64 * PRIME64_4 +
+                                     uint64_t(Len) * PRIME64_2);
+    return H128;
+  }
+
+  alignas(16) uint64_t Acc[XXH_ACC_NB];
+  XXH3_initAcc(Acc);
+  XXH3_hashLong(Acc, In, Len);
+  XXH128_hash_t H128;
+  H128.low64 = XXH3_mergeAccs(Acc, Secret + XXH_SECRET_MERGEACCS_START,
+                              uint64_t(Len) * PRIME64_1);
+  H128.high64 = XXH3_mergeAccs(
+      Acc, Secret + XXH3_SECRETSIZE - sizeof(Acc) - XXH_SECRET_MERGEACCS_START,
+      ~(uint64_t(Len) * PRIME64_2));
+  return H128;
+}
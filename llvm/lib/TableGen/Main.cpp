@@ -52,6 +52,9 @@ MacroNames("D", cl::desc("Name of the macro to be defined"),
 static cl::opt<bool>
 WriteIfChanged("write-if-changed", cl::desc("Only write output if it changed"));
 
+static cl::opt<bool>
+TimePhases("time-phases", cl::desc("Time phases of parser and backend"));
+
 static int reportError(const char *ProgName, Twine Msg) {
   errs() << ProgName << ": " << Msg;
   errs().flush();
@@ -62,16 +65,24 @@ static int reportError(const char *ProgName, Twine Msg) {
 ///
 /// This functionality is really only for the benefit of the build system.
 /// It is similar to GCC's `-M*` family of options.
-static int createDependencyFile(const TGParser &Parser, const char *argv0) {
-  if (OutputFilename == "-")
-    return reportError(argv0, "the option -d must be used together with -o\n");
+static int createDependencyFile(const TGParser &Parser, const char *argv0,
+                                ArrayRef<TableGenOutput> Outputs) {
+  for (const TableGenOutput &Output : Outputs)
+    if (Output.Filename == "-")
+      return reportError(argv0,
+                         "the option -d must be used together with -o\n");
 
   std::error_code EC;
   ToolOutputFile DepOut(DependFilename, EC, sys::fs::OF_None);
   if (EC)
     return reportError(argv0, "error opening " + DependFilename + ":" +
                                   EC.message() + "\n");
-  DepOut.os() << OutputFilename << ":";
+  for (const TableGenOutput &Output : Outputs) {
+    if (&Output != Outputs.begin())
+      DepOut.os() << ' ';
+    DepOut.os() << Output.Filename;
+  }
+  DepOut.os() << ":";
   for (const auto &Dep : Parser.getDependencies()) {
     DepOut.os() << ' ' << Dep;
   }
@@ -81,9 +92,19 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
 }
 
 int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
+  TableGenOutput Output = {OutputFilename, "Backend", MainFn};
+  return TableGenMain(argv0, Output);
+}
+
+int llvm::TableGenMain(char *argv0, ArrayRef<TableGenOutput> Outputs) {
   RecordKeeper Records;
 
+  if (TimePhases)
+    Records.startPhaseTiming();
+
   // Parse the input file.
+
+  Records.startTimer("Parse, build records");
   ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
       MemoryBuffer::getFileOrSTDIN(InputFilename);
   if (std::error_code EC = FileOrErr.getError())
@@ -101,42 +122,53 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
 
   if (Parser.ParseFile())
     return 1;
+  Records.stopTimer();
 
   // Write output to memory.
-  std::string OutString;
-  raw_string_ostream Out(OutString);
-  if (MainFn(Out, Records))
-    return 1;
+  std::vector<std::string> OutStrings(Outputs.size());
+  for (size_t I = 0, E = Outputs.size(); I != E; ++I) {
+    Records.startTimer(Outputs[I].Name);
+    raw_string_ostream Out(OutStrings[I]);
+    if (Outputs[I].MainFn(Out, Records))
+      return 1;
+    Out.flush();
+  }
 
+  Records.startTimer("Write output");
   // Always write the depfile, even if the main output hasn't changed.
   // If it's missing, Ninja considers the output dirty.  If this was below
   // the early exit below and someone deleted the .inc.d file but not the .inc
   // file, tablegen would never write the depfile.
   if (!DependFilename.empty()) {
-    if (int Ret = createDependencyFile(Parser, argv0))
+    if (int Ret = createDependencyFile(Parser, argv0, Outputs))
       return Ret;
   }
 
-  if (WriteIfChanged) {
-    // Only updates the real output file if there are any differences.
-    // This prevents recompilation of all the files depending on it if there
-    // aren't any.
-    if (auto ExistingOrErr = MemoryBuffer::getFile(OutputFilename))
-      if (std::move(ExistingOrErr.get())->getBuffer() == Out.str())
-        return 0;
+  for (size_t I = 0, E = Outputs.size(); I != E; ++I) {
+    StringRef Filename = Outputs[I].Filename;
+    if (WriteIfChanged) {
+      // Only updates the real output file if there are any differences.
+      // This prevents recompilation of all the files depending on it if there
+      // aren't any.
+      if (auto ExistingOrErr = MemoryBuffer::getFile(Filename))
+        if (std::move(ExistingOrErr.get())->getBuffer() == OutStrings[I])
+          continue;
+    }
+
+    std::error_code EC;
+    ToolOutputFile OutFile(Filename, EC, sys::fs::OF_None);
+    if (EC)
+      return reportError(argv0, "error opening " + Filename + ":" +
+                                    EC.message() + "\n");
+    OutFile.os() << OutStrings[I];
+
+    if (ErrorsPrinted > 0)
+      return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
+
+    // Declare success.
+    OutFile.keep();
   }
 
-  std::error_code EC;
-  ToolOutputFile OutFile(OutputFilename, EC, sys::fs::OF_None);
-  if (EC)
-    return reportError(argv0, "error opening " + OutputFilename + ":" +
-                                  EC.message() + "\n");
-  OutFile.os() << Out.str();
-
-  if (ErrorsPrinted > 0)
-    return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
-
-  // Declare success.
-  OutFile.keep();
+  Records.stopPhaseTiming();
   return 0;
 }
@@ -2397,8 +2397,46 @@ Init *RecordKeeper::getNewAnonymousName() {
   return StringInit::get("anonymous_" + utostr(AnonCounter++));
 }
 
+void RecordKeeper::startPhaseTiming() {
+  TimingGroup =
+      std::make_unique<TimerGroup>("TableGen", "TableGen Phase Timing");
+  ResolveTimingGroup = std::make_unique<TimerGroup>(
+      "TableGenResolve", "TableGen Record Resolution Timing");
+  ResolveTimer = std::make_unique<Timer>("resolve", "Resolve record fields",
+                                         *ResolveTimingGroup);
+}
+
+void RecordKeeper::startTimer(StringRef Name) {
+  if (!TimingGroup)
+    return;
+  if (!PhaseTimers.empty() && PhaseTimers.back()->isRunning())
+    PhaseTimers.back()->stopTimer();
+  PhaseTimers.push_back(std::make_unique<Timer>(Name, Name, *TimingGroup));
+  PhaseTimers.back()->startTimer();
+}
+
+void RecordKeeper::stopTimer() {
+  if (TimingGroup && !PhaseTimers.empty() && PhaseTimers.back()->isRunning())
+    PhaseTimers.back()->stopTimer();
+}
+
+void RecordKeeper::stopPhaseTiming() {
+  if (!TimingGroup)
+    return;
+  stopTimer();
+  // The groups print their reports once the last of their timers is gone.
+  PhaseTimers.clear();
+  ResolveTimer.reset();
+  ResolveTimingGroup.reset();
+  TimingGroup.reset();
+}
+
 std::vector<Record *>
 RecordKeeper::getAllDerivedDefinitions(StringRef ClassName) const {
+  auto Cached = ClassRecordsMap.find(ClassName);
+  if (Cached != ClassRecordsMap.end())
+    return Cached->second;
+
   Record *Class = getClass(ClassName);
   if (!Class)
     PrintFatalError("ERROR: Couldn't find the `" + ClassName + "' class!\n");
@@ -2408,6 +2446,7 @@ RecordKeeper::getAllDerivedDefinitions(StringRef ClassName) const {
     if (D.second->isSubClassOf(Class))
       Defs.push_back(D.second.get());
 
+  ClassRecordsMap.emplace(ClassName, Defs);
   return Defs;
 }
 
@@ -269,7 +269,10 @@ bool TGParser::AddSubClass(Record *CurRec, SubClassReference &SubClass) {
     Name = CurRec->getNameInit();
   R.set(QualifiedNameOfImplicitName(*SC), Name);
 
-  CurRec->resolveReferences(R);
+  {
+    TimeRegion T(Records.getResolveTimer());
+    CurRec->resolveReferences(R);
+  }
 
   // Since everything went well, we can now set the "superclass" list for the
   // current record.
@@ -422,7 +425,10 @@ bool TGParser::resolve(const std::vector<RecordsEntry> &Source,
       MapResolver R(Rec.get());
       for (const auto &S : Substs)
         R.set(S.first, S.second);
-      Rec->resolveReferences(R);
+      {
+        TimeRegion T(Records.getResolveTimer());
+        Rec->resolveReferences(R);
+      }
 
       if (Dest)
         Dest->push_back(std::move(Rec));
@@ -447,7 +453,10 @@ bool TGParser::addDefOne(std::unique_ptr<Record> Rec) {
     Rec->setName(Records.getNewAnonymousName());
   }
 
-  Rec->resolveReferences();
+  {
+    TimeRegion T(Records.getResolveTimer());
+    Rec->resolveReferences();
+  }
   checkConcrete(*Rec);
 
   if (!isa<StringInit>(Rec->getNameInit())) {
@@ -59,6 +59,9 @@ STATISTIC(NumFnWithoutExactDefinition,
           "Number of functions without exact definitions");
 STATISTIC(NumAttributesTimedOut,
           "Number of abstract attributes timed out before fixpoint");
+STATISTIC(NumAttributeUpdates, "Number of abstract attribute updates");
+STATISTIC(NumFixpointUpdateLimitHits,
+          "Number of fixpoint iterations stopped by the update limit");
 STATISTIC(NumAttributesValidFixpoint,
           "Number of abstract attributes in a valid fixpoint state");
 STATISTIC(NumAttributesManifested,
@@ -154,6 +157,16 @@ static cl::opt<unsigned>
     MaxFixpointIterations("attributor-max-iterations", cl::Hidden,
                           cl::desc("Maximal number of fixpoint iterations."),
                           cl::init(32));
+
+// Bound on the total number of abstract attribute updates, i.e., of the work
+// done by the fixpoint iteration. Unlike a time limit, this keeps the result
+// deterministic. The iteration only stops between two iterations, so the
+// unsettled attributes are reverted exactly as if the iteration limit was hit.
+static cl::opt<unsigned>
+    MaxFixpointUpdates("attributor-max-updates", cl::Hidden,
+                       cl::desc("Maximal number of abstract attribute updates "
+                                "in the fixpoint iteration (0 = no limit)."),
+                       cl::init(0));
 static cl::opt<bool> VerifyMaxFixpointIterations(
     "attributor-max-iterations-verify", cl::Hidden,
     cl::desc("Verify that max-iterations is a tight bound for a fixpoint"),
@@ -7780,6 +7793,8 @@ ChangeStatus Attributor::run() {
   // the abstract analysis.
 
   unsigned IterationCounter = 1;
+  unsigned UpdateCounter = 0;
+  bool UpdateLimitReached = false;
 
   SmallVector<AbstractAttribute *, 32> ChangedAAs;
   SetVector<AbstractAttribute *> Worklist, InvalidAAs;
@@ -7853,6 +7868,8 @@ ChangeStatus Attributor::run() {
       if (!AA->getState().isAtFixpoint() &&
           !isAssumedDead(*AA, nullptr, /* CheckBBLivenessOnly */ true)) {
         QueriedNonFixAA = false;
+        ++UpdateCounter;
+        ++NumAttributeUpdates;
         if (AA->update(*this) == ChangeStatus::CHANGED) {
           ChangedAAs.push_back(AA);
           if (!AA->getState().isValidState())
@@ -7878,8 +7895,17 @@ ChangeStatus Attributor::run() {
     Worklist.clear();
     Worklist.insert(ChangedAAs.begin(), ChangedAAs.end());
 
-  } while (!Worklist.empty() && (IterationCounter++ < MaxFixpointIterations ||
-                                 VerifyMaxFixpointIterations));
+    UpdateLimitReached = MaxFixpointUpdates && !Worklist.empty() &&
+                         UpdateCounter >= MaxFixpointUpdates;
+  } while (!Worklist.empty() && !UpdateLimitReached &&
+           (IterationCounter++ < MaxFixpointIterations ||
+            VerifyMaxFixpointIterations));
+
+  if (UpdateLimitReached) {
+    LLVM_DEBUG(dbgs() << "\n[Attributor] Update limit reached after "
+                      << UpdateCounter << " updates\n");
+    ++NumFixpointUpdateLimitHits;
+  }
 
   LLVM_DEBUG(dbgs() << "\n[Attributor] Fixpoint iteration done after: "
                     << IterationCounter << "/" << MaxFixpointIterations
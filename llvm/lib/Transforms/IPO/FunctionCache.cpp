@@ -0,0 +1,602 @@
+//===- FunctionCache.cpp - Cache function pipeline results ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements FunctionCachePass.
+//
+// Every function is copied into a module of its own, the "extract", which
+// holds declarations of the globals the function refers to and the
+// initializers of the constants it may fold loads from. The key of the
+// function is the SHA-1 of the bitcode of that extract and of the pipeline
+// key, and the cache entry is the extract of the optimized function, stored
+// as bitcode in a file that pruneCache() knows about.
+//
+// On a hit the cached module is read into the same context, its globals are
+// mapped onto the ones of the module by name, and its body replaces the body
+// of the function. The alignment of the globals it refers to is raised where
+// the pipeline raised it. Reading the module renames the identified struct
+// types it shares with the module, so the extract records the original names
+// in named metadata in order to map them back.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/FunctionCache.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/IR/TypeFinder.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "function-cache"
+
+STATISTIC(NumCacheHits, "Number of function bodies taken from the cache");
+STATISTIC(NumCacheMisses, "Number of function bodies added to the cache");
+STATISTIC(NumNotCached, "Number of functions that could not be cached");
+
+/// Named metadata of an extract that maps the names of the identified struct
+/// types it uses to the types.
+static const char StructNamesMDName[] = "llvm.function.cache.types";
+
+/// Returns true if \p MD refers to a global value, which an extract could not
+/// map.
+static bool referencesGlobals(const Metadata *MD,
+                              SmallPtrSetImpl<const Metadata *> &Visited) {
+  if (!Visited.insert(MD).second)
+    return false;
+  if (auto *C = dyn_cast<ConstantAsMetadata>(MD))
+    return !isa<ConstantData>(C->getValue());
+  if (auto *N = dyn_cast<MDNode>(MD))
+    for (const MDOperand &Op : N->operands())
+      if (Op && referencesGlobals(Op.get(), Visited))
+        return true;
+  return false;
+}
+
+static bool referencesGlobals(const Metadata *MD) {
+  SmallPtrSet<const Metadata *, 8> Visited;
+  return referencesGlobals(MD, Visited);
+}
+
+/// Returns true if the extract should hold the initializer of \p GV. Function
+/// passes may fold loads from constants, and the optimized body may refer to
+/// globals that the pipeline created, such as switch tables. \p KnownGlobals
+/// holds the names of the globals in the extract of the function before it
+/// was optimized, or is null if this is that extract.
+static bool shouldCopyInitializer(const GlobalVariable &GV,
+                                  const StringSet<> *KnownGlobals) {
+  if (GV.isConstant() && GV.hasDefinitiveInitializer())
+    return true;
+  return KnownGlobals && GV.hasInitializer() &&
+         !KnownGlobals->count(GV.getName());
+}
+
+/// Collects the globals that \p F refers to, in the order they are found.
+/// Returns false if \p F refers to something that an extract cannot hold.
+static bool collectReferencedGlobals(Function &F,
+                                     const StringSet<> *KnownGlobals,
+                                     SetVector<GlobalValue *> &Globals) {
+  SmallVector<Constant *, 16> Worklist;
+  SmallPtrSet<Constant *, 32> Visited;
+  auto AddOperand = [&](Value *V) {
+    if (auto *C = dyn_cast<Constant>(V))
+      if (Visited.insert(C).second)
+        Worklist.push_back(C);
+  };
+
+  if (F.hasPersonalityFn())
+    AddOperand(F.getPersonalityFn());
+  SmallVector<std::pair<unsigned, MDNode *>, 4> MDs;
+  F.getAllMetadata(MDs);
+  for (const auto &MD : MDs)
+    if (referencesGlobals(MD.second))
+      return false;
+  for (Instruction &I : instructions(F)) {
+    for (Value *Op : I.operands()) {
+      if (auto *MAV = dyn_cast<MetadataAsValue>(Op))
+        if (referencesGlobals(MAV->getMetadata()))
+          return false;
+      AddOperand(Op);
+    }
+    I.getAllMetadata(MDs);
+    for (const auto &MD : MDs)
+      if (referencesGlobals(MD.second))
+        return false;
+  }
+
+  while (!Worklist.empty()) {
+    Constant *C = Worklist.pop_back_val();
+    if (isa<BlockAddress>(C))
+      return false;
+    if (auto *GV = dyn_cast<GlobalValue>(C)) {
+      if (GV == &F)
+        continue;
+      if (!GV->hasName() || isa<GlobalIndirectSymbol>(GV))
+        return false;
+      // Function passes do not create functions, so a definition that did not
+      // exist before the pipeline ran would be cloned from an unknown body.
+      auto *Var = dyn_cast<GlobalVariable>(GV);
+      if (KnownGlobals && !Var && !GV->isDeclaration() &&
+          !KnownGlobals->count(GV->getName()))
+        return false;
+      Globals.insert(GV);
+      if (Var && shouldCopyInitializer(*Var, KnownGlobals))
+        AddOperand(Var->getInitializer());
+      continue;
+    }
+    for (Value *Op : C->operands())
+      AddOperand(Op);
+  }
+  return true;
+}
+
+/// Records the names of the identified struct types in \p Ext. Returns false
+/// if one of them has no name.
+static bool recordStructNames(Module &Ext) {
+  LLVMContext &Ctx = Ext.getContext();
+  TypeFinder Types;
+  Types.run(Ext, /*onlyNamed=*/false);
+  NamedMDNode *Names = Ext.getOrInsertNamedMetadata(StructNamesMDName);
+  for (StructType *STy : Types) {
+    if (STy->isLiteral())
+      continue;
+    if (!STy->hasName())
+      return false;
+    Metadata *Ops[] = {
+        MDString::get(Ctx, STy->getName()),
+        ConstantAsMetadata::get(UndefValue::get(STy->getPointerTo()))};
+    Names->addOperand(MDTuple::get(Ctx, Ops));
+  }
+  return true;
+}
+
+/// Copies what matters about the declaration \p Src to \p Dst, which lives in
+/// another module.
+static void copyDeclarationAttributes(Function *Dst, const Function *Src) {
+  Dst->setCallingConv(Src->getCallingConv());
+  Dst->setAttributes(Src->getAttributes());
+  Dst->setVisibility(Src->getVisibility());
+  Dst->setUnnamedAddr(Src->getUnnamedAddr());
+  Dst->setDLLStorageClass(Src->getDLLStorageClass());
+  Dst->setDSOLocal(Src->isDSOLocal());
+}
+
+/// Copies \p F into a new module, together with what it refers to. Returns
+/// null if \p F cannot be cached.
+static std::unique_ptr<Module>
+extractFunction(Function &F, const StringSet<> *KnownGlobals) {
+  if (!F.hasName() || F.getSubprogram() || F.hasPrefixData() ||
+      F.hasPrologueData())
+    return nullptr;
+  // Blocks whose address is taken cannot be replaced.
+  for (BasicBlock &BB : F)
+    if (BB.hasAddressTaken())
+      return nullptr;
+  SetVector<GlobalValue *> Globals;
+  if (!collectReferencedGlobals(F, KnownGlobals, Globals))
+    return nullptr;
+
+  Module &M = *F.getParent();
+  auto Ext = std::make_unique<Module>("", F.getContext());
+  Ext->setDataLayout(M.getDataLayout());
+  Ext->setTargetTriple(M.getTargetTriple());
+  // Module flags that refer to globals, like the call graph profile, are not
+  // something a function pass looks at.
+  if (NamedMDNode *Flags = M.getModuleFlagsMetadata()) {
+    NamedMDNode *ExtFlags = Ext->getOrInsertModuleFlagsMetadata();
+    for (MDNode *Flag : Flags->operands())
+      if (!referencesGlobals(Flag))
+        ExtFlags->addOperand(Flag);
+  }
+
+  ValueToValueMapTy VMap;
+  for (GlobalValue *GV : Globals) {
+    if (auto *Fn = dyn_cast<Function>(GV)) {
+      Function *NewFn =
+          Function::Create(Fn->getFunctionType(), GlobalValue::ExternalLinkage,
+                           Fn->getAddressSpace(), Fn->getName(), Ext.get());
+      copyDeclarationAttributes(NewFn, Fn);
+      VMap[Fn] = NewFn;
+      continue;
+    }
+    auto *Var = cast<GlobalVariable>(GV);
+    bool CopyInitializer = shouldCopyInitializer(*Var, KnownGlobals);
+    auto *NewVar = new GlobalVariable(
+        *Ext, Var->getValueType(), Var->isConstant(),
+        CopyInitializer ? Var->getLinkage() : GlobalValue::ExternalLinkage,
+        nullptr, Var->getName(), nullptr, Var->getThreadLocalMode(),
+        Var->getAddressSpace());
+    NewVar->copyAttributesFrom(Var);
+    VMap[Var] = NewVar;
+  }
+  for (GlobalValue *GV : Globals)
+    if (auto *Var = dyn_cast<GlobalVariable>(GV))
+      if (shouldCopyInitializer(*Var, KnownGlobals))
+        cast<GlobalVariable>(VMap[Var])
+            ->setInitializer(MapValue(Var->getInitializer(), VMap));
+
+  Function *NewF =
+      Function::Create(F.getFunctionType(), F.getLinkage(),
+                       F.getAddressSpace(), F.getName(), Ext.get());
+  VMap[&F] = NewF;
+  Function::arg_iterator NewArg = NewF->arg_begin();
+  for (Argument &Arg : F.args()) {
+    NewArg->setName(Arg.getName());
+    VMap[&Arg] = &*NewArg++;
+  }
+  SmallVector<ReturnInst *, 8> Returns;
+  CloneFunctionInto(NewF, &F, VMap, /*ModuleLevelChanges=*/true, Returns);
+
+  if (!recordStructNames(*Ext))
+    return nullptr;
+  return Ext;
+}
+
+namespace {
+/// Maps the types of a module read from the cache to the types of the module
+/// being optimized.
+class CachedTypeRemapper : public ValueMapTypeRemapper {
+  DenseMap<Type *, Type *> Map;
+
+public:
+  /// Maps the identified struct types recorded in \p Cached onto the types
+  /// of the same name. Returns false if their bodies do not agree.
+  bool init(Module &M, Module &Cached);
+
+  Type *remapType(Type *Ty) override;
+};
+} // end anonymous namespace
+
+bool CachedTypeRemapper::init(Module &M, Module &Cached) {
+  NamedMDNode *Names = Cached.getNamedMetadata(StructNamesMDName);
+  if (!Names)
+    return false;
+  SmallVector<std::pair<StructType *, StructType *>, 8> Structs;
+  for (MDNode *N : Names->operands()) {
+    if (N->getNumOperands() != 2)
+      return false;
+    auto *Name = dyn_cast<MDString>(N->getOperand(0));
+    auto *Ptr = dyn_cast_or_null<ConstantAsMetadata>(N->getOperand(1));
+    if (!Name || !Ptr || !Ptr->getType()->isPointerTy())
+      return false;
+    auto *CachedTy =
+        dyn_cast<StructType>(Ptr->getType()->getPointerElementType());
+    StructType *Ty = M.getTypeByName(Name->getString());
+    if (!CachedTy || !Ty)
+      return false;
+    Map[CachedTy] = Ty;
+    Structs.push_back({CachedTy, Ty});
+  }
+
+  for (const auto &S : Structs) {
+    StructType *CachedTy = S.first, *Ty = S.second;
+    if (CachedTy == Ty || (CachedTy->isOpaque() && Ty->isOpaque()))
+      continue;
+    if (CachedTy->isOpaque() || Ty->isOpaque() ||
+        CachedTy->isPacked() != Ty->isPacked() ||
+        CachedTy->getNumElements() != Ty->getNumElements())
+      return false;
+    for (unsigned I = 0, E = Ty->getNumElements(); I != E; ++I)
+      if (remapType(CachedTy->getElementType(I)) != Ty->getElementType(I))
+        return false;
+  }
+  return true;
+}
+
+Type *CachedTypeRemapper::remapType(Type *Ty) {
+  auto It = Map.find(Ty);
+  if (It != Map.end())
+    return It->second;
+  // Identified structs that were not recorded are new, and are used as they
+  // are.
+  auto *STy = dyn_cast<StructType>(Ty);
+  if ((STy && !STy->isLiteral()) || !Ty->getNumContainedTypes())
+    return Ty;
+
+  SmallVector<Type *, 4> Elts;
+  bool Changed = false;
+  for (Type *Sub : Ty->subtypes()) {
+    Elts.push_back(remapType(Sub));
+    Changed |= Elts.back() != Sub;
+  }
+
+  Type *Result = Ty;
+  if (Changed) {
+    switch (Ty->getTypeID()) {
+    case Type::PointerTyID:
+      Result = PointerType::get(Elts[0], Ty->getPointerAddressSpace());
+      break;
+    case Type::ArrayTyID:
+      Result = ArrayType::get(Elts[0], Ty->getArrayNumElements());
+      break;
+    case Type::VectorTyID:
+      Result = VectorType::get(Elts[0], cast<VectorType>(Ty)->getElementCount());
+      break;
+    case Type::FunctionTyID:
+      Result = FunctionType::get(Elts[0], makeArrayRef(Elts).drop_front(),
+                                 cast<FunctionType>(Ty)->isVarArg());
+      break;
+    case Type::StructTyID:
+      Result = StructType::get(Ty->getContext(), Elts, STy->isPacked());
+      break;
+    default:
+      llvm_unreachable("Unexpected type with contained types");
+    }
+  }
+  Map[Ty] = Result;
+  return Result;
+}
+
+/// Replaces the body of \p F with the body of the function of the same name in
+/// \p Cached. \p KnownGlobals holds the names of the globals in the extract of
+/// \p F. Returns false, and leaves \p F alone, if the cached function cannot be
+/// used in the module of \p F.
+static bool spliceCachedBody(Function &F, Module &Cached,
+                             const StringSet<> &KnownGlobals) {
+  Module &M = *F.getParent();
+  Function *CachedF = Cached.getFunction(F.getName());
+  if (!CachedF || CachedF->isDeclaration())
+    return false;
+  CachedTypeRemapper Types;
+  if (!Types.init(M, Cached) ||
+      Types.remapType(CachedF->getType()) != F.getType())
+    return false;
+
+  // Map the globals of the cached function onto the ones in M, and create the
+  // ones that the pipeline added.
+  ValueToValueMapTy VMap;
+  SmallVector<GlobalValue *, 4> NewGlobals;
+  SmallVector<std::pair<GlobalVariable *, MaybeAlign>, 4> RaisedAlignments;
+  for (GlobalValue &GV : Cached.global_values()) {
+    if (&GV == CachedF)
+      continue;
+    if (isa<GlobalIndirectSymbol>(GV) ||
+        (isa<Function>(GV) && !GV.isDeclaration()))
+      return false;
+    GlobalValue *Existing = M.getNamedValue(GV.getName());
+    if (KnownGlobals.count(GV.getName()) || (Existing && GV.isDeclaration())) {
+      if (!Existing || isa<Function>(Existing) != isa<Function>(GV) ||
+          Existing->getType() != Types.remapType(GV.getType()))
+        return false;
+      if (auto *Var = dyn_cast<GlobalVariable>(&GV)) {
+        auto *ExistingVar = dyn_cast<GlobalVariable>(Existing);
+        if (!ExistingVar)
+          return false;
+        // Unless the pipeline changed it, the cached declaration matches M.
+        // Passes like InstCombine raise the alignment of globals that the
+        // body then relies on, which has to be done to M as well; other
+        // changes cannot be applied again.
+        if (Var->getAlignment() > ExistingVar->getAlignment()) {
+          if (!ExistingVar->canIncreaseAlignment())
+            return false;
+          RaisedAlignments.push_back({ExistingVar, Var->getAlign()});
+        }
+        if (Var->isConstant() != ExistingVar->isConstant() ||
+            Var->getSection() != ExistingVar->getSection() ||
+            Var->getUnnamedAddr() != ExistingVar->getUnnamedAddr() ||
+            Var->getThreadLocalMode() != ExistingVar->getThreadLocalMode())
+          return false;
+      }
+      VMap[&GV] = Existing;
+      continue;
+    }
+    if (Existing && !GV.hasLocalLinkage())
+      return false;
+    NewGlobals.push_back(&GV);
+  }
+
+  for (const auto &R : RaisedAlignments)
+    R.first->setAlignment(R.second);
+
+  for (GlobalValue *GV : NewGlobals) {
+    if (auto *Fn = dyn_cast<Function>(GV)) {
+      Function *NewFn = Function::Create(
+          cast<FunctionType>(Types.remapType(Fn->getFunctionType())),
+          Fn->getLinkage(), Fn->getAddressSpace(), Fn->getName(), &M);
+      copyDeclarationAttributes(NewFn, Fn);
+      VMap[Fn] = NewFn;
+      continue;
+    }
+    auto *Var = cast<GlobalVariable>(GV);
+    auto *NewVar = new GlobalVariable(
+        M, Types.remapType(Var->getValueType()), Var->isConstant(),
+        Var->getLinkage(), nullptr, Var->getName(), nullptr,
+        Var->getThreadLocalMode(), Var->getAddressSpace());
+    NewVar->copyAttributesFrom(Var);
+    VMap[Var] = NewVar;
+  }
+  for (GlobalValue *GV : NewGlobals)
+    if (auto *Var = dyn_cast<GlobalVariable>(GV))
+      if (Var->hasInitializer())
+        cast<GlobalVariable>(VMap[Var])->setInitializer(
+            MapValue(Var->getInitializer(), VMap, RF_None, &Types));
+
+  // deleteBody() makes the function external.
+  GlobalValue::LinkageTypes Linkage = F.getLinkage();
+  F.deleteBody();
+  VMap[CachedF] = &F;
+  Function::arg_iterator Arg = F.arg_begin();
+  for (Argument &CachedArg : CachedF->args())
+    VMap[&CachedArg] = &*Arg++;
+  SmallVector<ReturnInst *, 8> Returns;
+  CloneFunctionInto(&F, CachedF, VMap, /*ModuleLevelChanges=*/true, Returns,
+                    "", nullptr, &Types);
+  F.setLinkage(Linkage);
+  return true;
+}
+
+/// Returns the path of the cache entry for \p Ext, the extract of a function
+/// in \p M, in \p CacheDir.
+static SmallString<128> getEntryPath(StringRef CacheDir, const Module &Ext,
+                                     const Module &M, StringRef PipelineKey) {
+  SmallString<0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(Ext, OS);
+  }
+  SHA1 Hasher;
+  Hasher.update(Bitcode);
+  Hasher.update(PipelineKey);
+  // The extract declares most globals as external, but passes may look at
+  // their real linkage and at whether the module defines them.
+  for (const GlobalValue &ExtGV : Ext.global_values()) {
+    const GlobalValue *GV = M.getNamedValue(ExtGV.getName());
+    assert(GV && "Extract refers to a global that is not in the module");
+    uint8_t Data[] = {uint8_t(GV->getLinkage()),
+                      uint8_t(GV->isDeclaration())};
+    Hasher.update(Data);
+  }
+
+  // This choice of file name allows the cache to be pruned (see pruneCache()
+  // in include/llvm/Support/CachePruning.h).
+  SmallString<128> EntryPath;
+  sys::path::append(EntryPath, CacheDir,
+                    "llvmcache-fn-" + toHex(Hasher.result()));
+  return EntryPath;
+}
+
+/// Reads the entry at \p EntryPath and splices it into \p F. Returns false if
+/// there is no usable entry.
+static bool restoreFromCache(Function &F, StringRef EntryPath,
+                             const StringSet<> &KnownGlobals) {
+  // Update the access time so that the cache pruner keeps the entry.
+  Expected<sys::fs::file_t> FDOrErr =
+      sys::fs::openNativeFileForRead(EntryPath, sys::fs::OF_UpdateAtime);
+  if (!FDOrErr) {
+    consumeError(FDOrErr.takeError());
+    return false;
+  }
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getOpenFile(*FDOrErr, EntryPath, /*FileSize=*/-1,
+                                /*RequiresNullTerminator=*/false);
+  sys::fs::closeFile(*FDOrErr);
+  if (!MBOrErr)
+    return false;
+
+  Expected<std::unique_ptr<Module>> CachedOrErr =
+      parseBitcodeFile((*MBOrErr)->getMemBufferRef(), F.getContext());
+  if (!CachedOrErr) {
+    LLVM_DEBUG(dbgs() << "Ignoring cache entry " << EntryPath << ": "
+                      << toString(CachedOrErr.takeError()) << "\n");
+    consumeError(CachedOrErr.takeError());
+    return false;
+  }
+  if (!spliceCachedBody(F, **CachedOrErr, KnownGlobals)) {
+    LLVM_DEBUG(dbgs() << "Cache entry " << EntryPath << " does not fit "
+                      << F.getName() << "\n");
+    return false;
+  }
+  return true;
+}
+
+/// Writes the extract of the optimized \p F to \p EntryPath. Returns false if
+/// \p F cannot be cached.
+static bool storeInCache(Function &F, StringRef CacheDir, StringRef EntryPath,
+                         const StringSet<> &KnownGlobals) {
+  std::unique_ptr<Module> Ext = extractFunction(F, &KnownGlobals);
+  if (!Ext)
+    return false;
+
+  // Write to a temporary file and rename it, so that concurrent compiles never
+  // read a partial entry.
+  SmallString<128> TempModel;
+  sys::path::append(TempModel, CacheDir, "FunctionCache-%%%%%%.tmp.bc");
+  Expected<sys::fs::TempFile> Temp = sys::fs::TempFile::create(
+      TempModel, sys::fs::owner_read | sys::fs::owner_write);
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return false;
+  }
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    WriteBitcodeToFile(*Ext, OS);
+  }
+  if (Error E = Temp->keep(EntryPath)) {
+    consumeError(std::move(E));
+    return false;
+  }
+  return true;
+}
+
+PreservedAnalyses FunctionCachePass::run(Module &M,
+                                         ModuleAnalysisManager &AM) {
+  FunctionAnalysisManager &FAM =
+      AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+  PassInstrumentation PI = AM.getResult<PassInstrumentationAnalysis>(M);
+
+  // The cache is only an optimization; just run the pipeline if there is no
+  // cache directory.
+  bool HaveCache = !sys::fs::create_directories(CacheDir);
+
+  PreservedAnalyses PA = PreservedAnalyses::all();
+  for (Function &F : M) {
+    if (F.isDeclaration())
+      continue;
+    if (!PI.runBeforePass<Function>(FPM, F))
+      continue;
+
+    std::unique_ptr<Module> Ext =
+        HaveCache ? extractFunction(F, nullptr) : nullptr;
+    SmallString<128> EntryPath;
+    StringSet<> KnownGlobals;
+    if (Ext) {
+      EntryPath = getEntryPath(CacheDir, *Ext, M, PipelineKey);
+      for (const GlobalValue &GV : Ext->global_values())
+        KnownGlobals.insert(GV.getName());
+      KnownGlobals.erase(F.getName());
+    }
+
+    PreservedAnalyses PassPA;
+    if (Ext && restoreFromCache(F, EntryPath, KnownGlobals)) {
+      ++NumCacheHits;
+      // The cached body may have added declarations to the module.
+      PassPA = PreservedAnalyses::none();
+    } else {
+      {
+        TimeTraceScope TimeScope(FPM.name(), F.getName());
+        PassPA = FPM.run(F, FAM);
+      }
+      if (Ext && storeInCache(F, CacheDir, EntryPath, KnownGlobals))
+        ++NumCacheMisses;
+      else
+        ++NumNotCached;
+    }
+
+    PI.runAfterPass(FPM, F);
+    FAM.invalidate(F, PassPA);
+    PA.intersect(std::move(PassPA));
+  }
+
+  // As in ModuleToFunctionPassAdaptor, every function has been invalidated as
+  // needed already.
+  PA.preserveSet<AllAnalysesOn<Function>>();
+  PA.preserve<FunctionAnalysisManagerModuleProxy>();
+  return PA;
+}
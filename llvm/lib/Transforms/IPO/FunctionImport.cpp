@@ -42,6 +42,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
@@ -68,6 +69,9 @@ STATISTIC(NumImportedCriticalFunctionsThinLink,
           "Number of critical functions thin link decided to import");
 STATISTIC(NumImportedGlobalVarsThinLink,
           "Number of global variables thin link decided to import");
+STATISTIC(NumImportsOverBudgetThinLink,
+          "Number of function imports thin link dropped to stay within the "
+          "total import budget");
 STATISTIC(NumImportedFunctions, "Number of functions imported in backend");
 STATISTIC(NumImportedGlobalVars,
           "Number of global variables imported in backend");
@@ -113,6 +117,12 @@ static cl::opt<float> ImportColdMultiplier(
     "import-cold-multiplier", cl::init(0), cl::Hidden, cl::value_desc("N"),
     cl::desc("Multiply the `import-instr-limit` threshold for cold callsites"));
 
+static cl::opt<unsigned> ImportTotalInstrBudget(
+    "import-total-instr-budget", cl::init(0), cl::Hidden, cl::value_desc("N"),
+    cl::desc("Limit the total number of instructions in functions imported "
+             "into all modules to N, keeping the imports along the hottest "
+             "call edges first (default 0, no limit)"));
+
 static cl::opt<bool> PrintImports("print-imports", cl::init(false), cl::Hidden,
                                   cl::desc("Print imported functions"));
 
@@ -642,6 +652,102 @@ checkVariableImport(const ModuleSummaryIndex &Index,
 }
 #endif
 
+/// Drop function imports until the total number of instructions imported into
+/// all modules fits within ImportTotalInstrBudget. Imports are ranked by the
+/// hottest call edge to the imported function from the importing module's own
+/// or imported functions, and then by size, smaller first. Global variable
+/// imports are kept, as read-only and write-only variables must be imported
+/// wherever they are referenced. The export lists, which at this point hold
+/// exactly the imported values, are rebuilt from the remaining imports.
+static void
+applyImportBudget(const ModuleSummaryIndex &Index,
+                  const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
+                  StringMap<FunctionImporter::ImportMapTy> &ImportLists,
+                  StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
+  struct Candidate {
+    StringRef ModPath;
+    StringRef SrcPath;
+    GlobalValue::GUID GUID;
+    CalleeInfo::HotnessType Hotness;
+    unsigned Cost;
+  };
+  std::vector<Candidate> Candidates;
+
+  for (auto &ModuleImports : ImportLists) {
+    StringRef ModPath = ModuleImports.first();
+    DenseMap<GlobalValue::GUID, CalleeInfo::HotnessType> Hotness;
+    auto AddCallEdges = [&](const GlobalValueSummary *S) {
+      if (auto *FS = dyn_cast<FunctionSummary>(S->getBaseObject()))
+        for (auto &Edge : FS->calls()) {
+          // Without a profile, a call edge is as hot as any non-cold one.
+          CalleeInfo::HotnessType EdgeHotness = Edge.second.getHotness();
+          if (EdgeHotness == CalleeInfo::HotnessType::Unknown)
+            EdgeHotness = CalleeInfo::HotnessType::None;
+          CalleeInfo::HotnessType &H = Hotness[Edge.first.getGUID()];
+          H = std::max(H, EdgeHotness);
+        }
+    };
+
+    for (auto &GVS : ModuleToDefinedGVSummaries.lookup(ModPath))
+      AddCallEdges(GVS.second);
+    for (auto &SrcImports : ModuleImports.second)
+      for (GlobalValue::GUID GUID : SrcImports.second)
+        if (const GlobalValueSummary *S =
+                Index.findSummaryInModule(GUID, SrcImports.first()))
+          AddCallEdges(S);
+
+    for (auto &SrcImports : ModuleImports.second)
+      for (GlobalValue::GUID GUID : SrcImports.second) {
+        const GlobalValueSummary *S =
+            Index.findSummaryInModule(GUID, SrcImports.first());
+        // Refer to the source module by the path owned by the index, since
+        // entries of the import list may be erased below.
+        if (auto *FS = dyn_cast_or_null<FunctionSummary>(
+                S ? S->getBaseObject() : nullptr))
+          Candidates.push_back({ModPath, S->modulePath(), GUID,
+                                Hotness.lookup(GUID), FS->instCount()});
+      }
+  }
+
+  // Sort deterministically, as the iteration order of the maps isn't.
+  llvm::sort(Candidates, [](const Candidate &L, const Candidate &R) {
+    return std::make_tuple(R.Hotness, L.Cost, L.ModPath, L.SrcPath, L.GUID) <
+           std::make_tuple(L.Hotness, R.Cost, R.ModPath, R.SrcPath, R.GUID);
+  });
+
+  uint64_t Budget = ImportTotalInstrBudget;
+  for (const Candidate &C : Candidates) {
+    if (C.Cost <= Budget) {
+      Budget -= C.Cost;
+      continue;
+    }
+    FunctionImporter::ImportMapTy &ImportList = ImportLists[C.ModPath];
+    auto It = ImportList.find(C.SrcPath);
+    It->second.erase(C.GUID);
+    if (It->second.empty())
+      ImportList.erase(It);
+    NumImportsOverBudgetThinLink++;
+  }
+
+  ExportLists.clear();
+  for (auto &ModuleImports : ImportLists)
+    for (auto &SrcImports : ModuleImports.second)
+      for (GlobalValue::GUID GUID : SrcImports.second)
+        ExportLists[SrcImports.first()].insert(Index.getValueInfo(GUID));
+}
+
+std::string llvm::getCrossModuleImportOptionsKey() {
+  std::string Key;
+  raw_string_ostream OS(Key);
+  OS << ImportInstrLimit << ' ' << ImportCutoff << ' '
+     << FloatToBits(ImportInstrFactor) << ' '
+     << FloatToBits(ImportHotInstrFactor) << ' '
+     << FloatToBits(ImportHotMultiplier) << ' '
+     << FloatToBits(ImportCriticalMultiplier) << ' '
+     << FloatToBits(ImportColdMultiplier) << ' ' << ImportTotalInstrBudget;
+  return OS.str();
+}
+
 /// Compute all the import and export for every module using the Index.
 void llvm::ComputeCrossModuleImport(
     const ModuleSummaryIndex &Index,
@@ -658,6 +764,10 @@ void llvm::ComputeCrossModuleImport(
                            &ExportLists);
   }
 
+  if (ImportTotalInstrBudget)
+    applyImportBudget(Index, ModuleToDefinedGVSummaries, ImportLists,
+                      ExportLists);
+
   // When computing imports we only added the variables and functions being
   // imported to the export list. We also need to mark any references and calls
   // they make as exported as well. We do this here, as it is more efficient
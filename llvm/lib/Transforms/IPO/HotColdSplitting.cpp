@@ -86,6 +86,16 @@ static cl::opt<int>
                        cl::desc("Base penalty for splitting cold code (as a "
                                 "multiple of TCC_Basic)"));
 
+static cl::opt<int> HotFunctionBenefitScale(
+    "hotcoldsplit-hot-benefit-scale", cl::init(2), cl::Hidden,
+    cl::desc("Scale the benefit of splitting cold code out of functions that "
+             "are hot in the profile"));
+
+static cl::opt<bool> EnableColdSectionPrefix(
+    "hotcoldsplit-section-prefix", cl::init(true), cl::Hidden,
+    cl::desc("Place split functions in .text.split. sections and functions "
+             "marked cold in .text.unlikely. sections"));
+
 namespace {
 // Same as blockEndsInUnreachable in CodeGen/BranchFolding.cpp. Do not modify
 // this function unless you modify the MBB version as well.
@@ -165,10 +175,24 @@ static bool markFunctionCold(Function &F, bool UpdateEntryCount = false) {
   return Changed;
 }
 
+/// Give \p F the section prefix \p Prefix, so that the linker can group it
+/// with the other cold code, unless it has an explicit section. Return true if
+/// the function is changed.
+static bool setColdSectionPrefix(Function &F, StringRef Prefix) {
+  if (!EnableColdSectionPrefix || F.hasSection())
+    return false;
+  Optional<StringRef> OldPrefix = F.getSectionPrefix();
+  if (OldPrefix && *OldPrefix == Prefix)
+    return false;
+  F.setSectionPrefix(Prefix);
+  return true;
+}
+
 class HotColdSplittingLegacyPass : public ModulePass {
 public:
   static char ID;
-  HotColdSplittingLegacyPass() : ModulePass(ID) {
+  HotColdSplittingLegacyPass(bool RequireProfileSummary = false)
+      : ModulePass(ID), RequireProfileSummary(RequireProfileSummary) {
     initializeHotColdSplittingLegacyPassPass(*PassRegistry::getPassRegistry());
   }
 
@@ -180,6 +204,9 @@ public:
   }
 
   bool runOnModule(Module &M) override;
+
+private:
+  bool RequireProfileSummary;
 };
 
 } // end anonymous namespace
@@ -300,7 +327,8 @@ static int getOutliningPenalty(ArrayRef<BasicBlock *> Region,
 Function *HotColdSplitting::extractColdRegion(
     const BlockSequence &Region, const CodeExtractorAnalysisCache &CEAC,
     DominatorTree &DT, BlockFrequencyInfo *BFI, TargetTransformInfo &TTI,
-    OptimizationRemarkEmitter &ORE, AssumptionCache *AC, unsigned Count) {
+    OptimizationRemarkEmitter &ORE, AssumptionCache *AC, unsigned Count,
+    bool IsHotFunction) {
   assert(!Region.empty());
 
   // TODO: Pass BFI and BPI to update profile information.
@@ -314,6 +342,13 @@ Function *HotColdSplitting::extractColdRegion(
   SetVector<Value *> Inputs, Outputs, Sinks;
   CE.findInputsOutputs(Inputs, Outputs, Sinks);
   int OutliningBenefit = getOutliningBenefit(Region, TTI);
+  // Code moved out of the functions that run the most gives the largest
+  // improvement in instruction cache density.
+  if (IsHotFunction && HotFunctionBenefitScale > 1) {
+    LLVM_DEBUG(dbgs() << "Scaling benefit by " << HotFunctionBenefitScale
+                      << " for a hot function\n");
+    OutliningBenefit *= HotFunctionBenefitScale;
+  }
   int OutliningPenalty =
       getOutliningPenalty(Region, Inputs.size(), Outputs.size());
   LLVM_DEBUG(dbgs() << "Split profitability: benefit = " << OutliningBenefit
@@ -337,6 +372,7 @@ Function *HotColdSplitting::extractColdRegion(
       OutF->setSection(OrigF->getSection());
 
     markFunctionCold(*OutF, BFI != nullptr);
+    setColdSectionPrefix(*OutF, ".split");
 
     LLVM_DEBUG(llvm::dbgs() << "Outlined Region: " << *OutF);
     ORE.emit([&]() {
@@ -576,8 +612,11 @@ bool HotColdSplitting::outlineColdRegions(Function &F, bool HasProfileSummary) {
     if (ColdBlocks.count(BB))
       continue;
 
+    // Trust the profile over the static heuristics when it says that the
+    // block is hot.
     bool Cold = (BFI && PSI->isColdBlock(BB, BFI)) ||
-                (EnableStaticAnalyis && unlikelyExecuted(*BB));
+                (EnableStaticAnalyis && unlikelyExecuted(*BB) &&
+                 !(BFI && PSI->isHotBlock(BB, BFI)));
     if (!Cold)
       continue;
 
@@ -598,7 +637,9 @@ bool HotColdSplitting::outlineColdRegions(Function &F, bool HasProfileSummary) {
 
       if (Region.isEntireFunctionCold()) {
         LLVM_DEBUG(dbgs() << "Entire function is cold\n");
-        return markFunctionCold(F);
+        Changed |= markFunctionCold(F);
+        Changed |= setColdSectionPrefix(F, ".unlikely");
+        return Changed;
       }
 
       // If this outlining region intersects with another, drop the new region.
@@ -620,6 +661,9 @@ bool HotColdSplitting::outlineColdRegions(Function &F, bool HasProfileSummary) {
   if (OutliningWorklist.empty())
     return Changed;
 
+  // With a profile, find out whether splitting improves the hot path.
+  bool IsHotFunction = BFI && PSI->isFunctionHotInCallGraph(&F, *BFI);
+
   // Outline single-entry cold regions, splitting up larger regions as needed.
   unsigned OutlinedFunctionID = 1;
   // Cache and recycle the CodeExtractor analysis to avoid O(n^2) compile-time.
@@ -635,8 +679,9 @@ bool HotColdSplitting::outlineColdRegions(Function &F, bool HasProfileSummary) {
           BB->dump();
       });
 
-      Function *Outlined = extractColdRegion(SubRegion, CEAC, *DT, BFI, TTI,
-                                             ORE, AC, OutlinedFunctionID);
+      Function *Outlined =
+          extractColdRegion(SubRegion, CEAC, *DT, BFI, TTI, ORE, AC,
+                            OutlinedFunctionID, IsHotFunction);
       if (Outlined) {
         ++OutlinedFunctionID;
         Changed = true;
@@ -661,9 +706,12 @@ bool HotColdSplitting::run(Module &M) {
     if (F.hasOptNone())
       continue;
 
-    // Detect inherently cold functions and mark them as such.
+    // Detect inherently cold functions and mark them as such. Functions split
+    // out earlier in this loop keep their .split prefix.
     if (isFunctionCold(F)) {
       Changed |= markFunctionCold(F);
+      if (F.getSectionPrefix() != StringRef(".split"))
+        Changed |= setColdSectionPrefix(F, ".unlikely");
       continue;
     }
 
@@ -683,6 +731,8 @@ bool HotColdSplittingLegacyPass::runOnModule(Module &M) {
     return false;
   ProfileSummaryInfo *PSI =
       &getAnalysis<ProfileSummaryInfoWrapperPass>().getPSI();
+  if (RequireProfileSummary && !PSI->hasProfileSummary())
+    return false;
   auto GTTI = [this](Function &F) -> TargetTransformInfo & {
     return this->getAnalysis<TargetTransformInfoWrapperPass>().getTTI(F);
   };
@@ -706,6 +756,10 @@ bool HotColdSplittingLegacyPass::runOnModule(Module &M) {
 
 PreservedAnalyses
 HotColdSplittingPass::run(Module &M, ModuleAnalysisManager &AM) {
+  ProfileSummaryInfo *PSI = &AM.getResult<ProfileSummaryAnalysis>(M);
+  if (RequireProfileSummary && !PSI->hasProfileSummary())
+    return PreservedAnalyses::all();
+
   auto &FAM = AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
 
   auto LookupAC = [&FAM](Function &F) -> AssumptionCache * {
@@ -728,8 +782,6 @@ HotColdSplittingPass::run(Module &M, ModuleAnalysisManager &AM) {
     return *ORE.get();
   };
 
-  ProfileSummaryInfo *PSI = &AM.getResult<ProfileSummaryAnalysis>(M);
-
   if (HotColdSplitting(PSI, GBFI, GTTI, &GetORE, LookupAC).run(M))
     return PreservedAnalyses::none();
   return PreservedAnalyses::all();
@@ -743,6 +795,6 @@ INITIALIZE_PASS_DEPENDENCY(BlockFrequencyInfoWrapperPass)
 INITIALIZE_PASS_END(HotColdSplittingLegacyPass, "hotcoldsplit",
                     "Hot Cold Splitting", false, false)
 
-ModulePass *llvm::createHotColdSplittingPass() {
-  return new HotColdSplittingLegacyPass();
+ModulePass *llvm::createHotColdSplittingPass(bool RequireProfileSummary) {
+  return new HotColdSplittingLegacyPass(RequireProfileSummary);
 }
@@ -0,0 +1,301 @@
+//===- HotFunctionMultiVersioning.cpp - Multiversion hot functions --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass uses the profile to find the hottest functions that contain loops,
+// and clones them for CPUs with wider vector units than the compilation target
+// assumes. The original function and its clones are dispatched through an
+// ifunc whose resolver checks the features of the running CPU, which is how
+// clang implements __attribute__((target(...))) multiversioning:
+//
+//   @foo = ifunc void (), void ()* ()* @foo.resolver
+//
+//   define internal void ()* @foo.resolver() {
+//     call void @__cpu_indicator_init()
+//     ; Return @foo.avx512, @foo.avx2 or @foo.default, the first of them
+//     ; whose features are set in @__cpu_model.
+//   }
+//
+// The pass runs before the loop vectorizer, so that the clones are vectorized
+// for the features they were created for.
+//
+// Only x86-64 ELF targets are supported, since the resolver relies on the
+// __cpu_model interface of compiler-rt and libgcc and on ifunc support.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/HotFunctionMultiVersioning.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalIFunc.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/TargetParser.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "hot-function-multiversioning"
+
+STATISTIC(NumFunctionsMultiVersioned, "Number of functions multiversioned");
+STATISTIC(NumVersionsCreated, "Number of target specific versions created");
+
+static cl::opt<unsigned> MaxMultiVersionedFunctions(
+    "hot-function-multiversioning-max-functions", cl::init(16), cl::Hidden,
+    cl::desc("Maximum number of functions to multiversion in a module"));
+
+namespace {
+
+/// A version of the hot functions for CPUs with some set of features.
+struct TargetVersion {
+  /// Appended to the name of the function.
+  const char *Suffix;
+  /// Appended to the "target-features" attribute of the function.
+  const char *TargetFeatures;
+  /// The bits that have to be set in __cpu_model.__cpu_features[0] for this
+  /// version to be selected.
+  uint32_t CPUFeatures;
+};
+
+} // end anonymous namespace
+
+// Ordered from the most to the least capable CPU; the resolver selects the
+// first version the CPU supports. The features are those of the Skylake server
+// and Haswell generations, which is what most AVX-512 and AVX2 capable
+// machines in use provide.
+static const TargetVersion X86Versions[] = {
+    {"avx512", "+avx512f,+avx512cd,+avx512bw,+avx512dq,+avx512vl",
+     (1u << X86::FEATURE_AVX512F) | (1u << X86::FEATURE_AVX512CD) |
+         (1u << X86::FEATURE_AVX512BW) | (1u << X86::FEATURE_AVX512DQ) |
+         (1u << X86::FEATURE_AVX512VL)},
+    {"avx2", "+avx2,+fma,+bmi,+bmi2",
+     (1u << X86::FEATURE_AVX2) | (1u << X86::FEATURE_FMA) |
+         (1u << X86::FEATURE_BMI) | (1u << X86::FEATURE_BMI2)},
+};
+
+static bool shouldMultiVersion(Function &F, ProfileSummaryInfo &PSI) {
+  if (F.isDeclaration() || F.hasComdat())
+    return false;
+
+  // Another definition may be chosen for interposable and discardable
+  // functions.
+  if (!F.hasExternalLinkage() && !F.hasLocalLinkage())
+    return false;
+
+  if (F.hasOptNone() || F.hasOptSize() || F.hasFnAttribute(Attribute::Naked))
+    return false;
+
+  // Don't second-guess functions that are already compiled for, or
+  // multiversioned over, these features.
+  StringRef Features = F.getFnAttribute("target-features").getValueAsString();
+  if (Features.contains("avx2") || Features.contains("avx512"))
+    return false;
+
+  // Aliases and block addresses must refer to the function itself rather than
+  // to the ifunc that replaces it.
+  if (any_of(F.users(), [](const User *U) {
+        return isa<GlobalIndirectSymbol>(U) || isa<BlockAddress>(U);
+      }))
+    return false;
+
+  if (!PSI.isFunctionEntryHot(&F))
+    return false;
+
+  // Functions without loops have nothing for the loop vectorizer to do.
+  DominatorTree DT(F);
+  LoopInfo LI(DT);
+  return !LI.empty();
+}
+
+static void addTargetFeatures(Function &F, StringRef Features) {
+  std::string NewFeatures =
+      std::string(F.getFnAttribute("target-features").getValueAsString());
+  if (!NewFeatures.empty())
+    NewFeatures += ',';
+  NewFeatures += Features;
+  F.addFnAttr("target-features", NewFeatures);
+}
+
+/// Make \p F internal, so that it can only be reached through the resolver.
+static void internalize(Function &F) {
+  F.setLinkage(GlobalValue::InternalLinkage);
+  F.setVisibility(GlobalValue::DefaultVisibility);
+  F.setDLLStorageClass(GlobalValue::DefaultStorageClass);
+}
+
+/// Emit the body of the resolver, which returns the first of \p Versions that
+/// the CPU supports, or \p Default.
+static void emitResolver(Function &Resolver, Function &Default,
+                         ArrayRef<std::pair<const TargetVersion *, Function *>>
+                             Versions) {
+  Module &M = *Resolver.getParent();
+  LLVMContext &Ctx = M.getContext();
+  IRBuilder<> Builder(BasicBlock::Create(Ctx, "resolver_entry", &Resolver));
+
+  FunctionCallee CPUInit =
+      M.getOrInsertFunction("__cpu_indicator_init", Builder.getVoidTy());
+  if (auto *CPUInitFn = dyn_cast<Function>(CPUInit.getCallee()))
+    CPUInitFn->setDSOLocal(true);
+  Builder.CreateCall(CPUInit);
+
+  // Matching the struct layout from the compiler-rt/libgcc structure that is
+  // filled in:
+  // unsigned int __cpu_vendor;
+  // unsigned int __cpu_type;
+  // unsigned int __cpu_subtype;
+  // unsigned int __cpu_features[1];
+  Type *Int32Ty = Builder.getInt32Ty();
+  StructType *CPUModelTy = StructType::get(Int32Ty, Int32Ty, Int32Ty,
+                                           ArrayType::get(Int32Ty, 1));
+  Constant *CPUModel = M.getOrInsertGlobal("__cpu_model", CPUModelTy);
+  if (auto *CPUModelGV = dyn_cast<GlobalValue>(CPUModel))
+    CPUModelGV->setDSOLocal(true);
+  Value *Idxs[] = {Builder.getInt32(0), Builder.getInt32(3),
+                   Builder.getInt32(0)};
+  Value *CPUFeatures = Builder.CreateAlignedLoad(
+      Int32Ty, Builder.CreateInBoundsGEP(CPUModelTy, CPUModel, Idxs),
+      Align(4));
+
+  for (const auto &V : Versions) {
+    Value *Mask = Builder.getInt32(V.first->CPUFeatures);
+    Value *Supported =
+        Builder.CreateICmpEQ(Builder.CreateAnd(CPUFeatures, Mask), Mask);
+    BasicBlock *Return = BasicBlock::Create(Ctx, "resolver_return", &Resolver);
+    BasicBlock *Else = BasicBlock::Create(Ctx, "resolver_else", &Resolver);
+    Builder.CreateCondBr(Supported, Return, Else);
+    ReturnInst::Create(Ctx, V.second, Return);
+    Builder.SetInsertPoint(Else);
+  }
+  Builder.CreateRet(&Default);
+}
+
+static void multiVersion(Function &F, ArrayRef<TargetVersion> Versions) {
+  Module &M = *F.getParent();
+  std::string Name = std::string(F.getName());
+  LLVM_DEBUG(dbgs() << "HFMV: Multiversioning " << Name << "\n");
+
+  SmallVector<std::pair<const TargetVersion *, Function *>, 2> Clones;
+  for (const TargetVersion &V : Versions) {
+    ValueToValueMapTy VMap;
+    Function *Clone = CloneFunction(&F, VMap);
+    Clone->setName(Name + "." + V.Suffix);
+    internalize(*Clone);
+    addTargetFeatures(*Clone, V.TargetFeatures);
+    Clones.push_back({&V, Clone});
+    ++NumVersionsCreated;
+  }
+
+  // The ifunc takes over the name and linkage of the function, and the
+  // original body becomes the default version.
+  GlobalValue::LinkageTypes Linkage = F.getLinkage();
+  GlobalValue::VisibilityTypes Visibility = F.getVisibility();
+  GlobalValue::DLLStorageClassTypes DLLStorage = F.getDLLStorageClass();
+  F.setName(Name + ".default");
+  internalize(F);
+
+  FunctionType *ResolverTy = FunctionType::get(F.getType(), /*isVarArg=*/false);
+  Function *Resolver = Function::Create(
+      ResolverTy, GlobalValue::InternalLinkage, Name + ".resolver", M);
+  GlobalIFunc *IFunc = GlobalIFunc::create(
+      F.getValueType(), F.getAddressSpace(), Linkage, Name, Resolver, &M);
+  IFunc->setVisibility(Visibility);
+  IFunc->setDLLStorageClass(DLLStorage);
+
+  // Every use, including the recursive calls in the versions themselves, goes
+  // through the ifunc. The resolver is emitted afterwards, since it needs to
+  // refer to the versions directly.
+  F.replaceAllUsesWith(IFunc);
+  emitResolver(*Resolver, F, Clones);
+  ++NumFunctionsMultiVersioned;
+}
+
+static bool multiVersionHotFunctions(Module &M, ProfileSummaryInfo &PSI) {
+  Triple TT(M.getTargetTriple());
+  if (TT.getArch() != Triple::x86_64 || !TT.isOSBinFormatELF() ||
+      TT.isOSFuchsia())
+    return false;
+  if (!PSI.hasProfileSummary())
+    return false;
+
+  SmallVector<std::pair<uint64_t, Function *>, 16> Candidates;
+  for (Function &F : M)
+    if (shouldMultiVersion(F, PSI))
+      Candidates.push_back({F.getEntryCount().getCount(), &F});
+  if (Candidates.empty())
+    return false;
+
+  // Spend the code size on the hottest functions.
+  llvm::stable_sort(Candidates, [](const std::pair<uint64_t, Function *> &A,
+                                   const std::pair<uint64_t, Function *> &B) {
+    return A.first > B.first;
+  });
+  if (Candidates.size() > MaxMultiVersionedFunctions)
+    Candidates.resize(MaxMultiVersionedFunctions);
+
+  for (const auto &C : Candidates)
+    multiVersion(*C.second, X86Versions);
+  return true;
+}
+
+PreservedAnalyses
+HotFunctionMultiVersioningPass::run(Module &M, ModuleAnalysisManager &AM) {
+  ProfileSummaryInfo &PSI = AM.getResult<ProfileSummaryAnalysis>(M);
+  if (!multiVersionHotFunctions(M, PSI))
+    return PreservedAnalyses::all();
+  return PreservedAnalyses::none();
+}
+
+namespace {
+
+class HotFunctionMultiVersioningLegacyPass : public ModulePass {
+public:
+  static char ID;
+  HotFunctionMultiVersioningLegacyPass() : ModulePass(ID) {
+    initializeHotFunctionMultiVersioningLegacyPassPass(
+        *PassRegistry::getPassRegistry());
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<ProfileSummaryInfoWrapperPass>();
+  }
+
+  bool runOnModule(Module &M) override {
+    if (skipModule(M))
+      return false;
+    return multiVersionHotFunctions(
+        M, getAnalysis<ProfileSummaryInfoWrapperPass>().getPSI());
+  }
+};
+
+} // end anonymous namespace
+
+char HotFunctionMultiVersioningLegacyPass::ID = 0;
+INITIALIZE_PASS_BEGIN(HotFunctionMultiVersioningLegacyPass,
+                      "hot-function-multiversioning",
+                      "Multiversion hot functions", false, false)
+INITIALIZE_PASS_DEPENDENCY(ProfileSummaryInfoWrapperPass)
+INITIALIZE_PASS_END(HotFunctionMultiVersioningLegacyPass,
+                    "hot-function-multiversioning",
+                    "Multiversion hot functions", false, false)
+
+ModulePass *llvm::createHotFunctionMultiVersioningPass() {
+  return new HotFunctionMultiVersioningLegacyPass();
+}
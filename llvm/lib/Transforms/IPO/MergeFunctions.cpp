@@ -180,8 +180,11 @@ class FunctionNode {
 
 public:
   // Note the hash is recalculated potentially multiple times, but it is cheap.
+  // Only functions that are equal get merged, so the constants are hashed as
+  // well.
   FunctionNode(Function *F)
-    : F(F), Hash(FunctionComparator::functionHash(*F))  {}
+    : F(F), Hash(FunctionComparator::functionHash(*F, /*HashConstants=*/true))
+  {}
 
   Function *getFunc() const { return F; }
   FunctionComparator::FunctionHash getHash() const { return Hash; }
@@ -417,7 +420,9 @@ bool MergeFunctions::runOnModule(Module &M) {
     HashedFuncs;
   for (Function &Func : M) {
     if (isEligibleForMerging(Func)) {
-      HashedFuncs.push_back({FunctionComparator::functionHash(Func), &Func});
+      HashedFuncs.push_back(
+          {FunctionComparator::functionHash(Func, /*HashConstants=*/true),
+           &Func});
     }
   }
 
@@ -103,6 +103,14 @@ static cl::opt<bool>
 cl::opt<bool> EnableHotColdSplit("hot-cold-split", cl::init(false), cl::Hidden,
     cl::desc("Enable hot-cold splitting pass"));
 
+cl::opt<bool> EnablePGOHotColdSplit(
+    "pgo-hot-cold-split", cl::init(true), cl::Hidden,
+    cl::desc("Enable hot-cold splitting pass when optimizing with a profile"));
+
+cl::opt<bool> EnableHotFunctionMultiVersioning(
+    "enable-hot-function-multiversioning", cl::init(false), cl::Hidden,
+    cl::desc("Clone hot functions for wider vector units, using PGO data"));
+
 static cl::opt<bool> UseLoopVersioningLICM(
     "enable-loop-versioning-licm", cl::init(false), cl::Hidden,
     cl::desc("Enable the experimental Loop Versioning LICM pass"));
@@ -289,6 +297,17 @@ void PassManagerBuilder::populateFunctionPassManager(
   FPM.add(createLowerExpectIntrinsicPass());
 }
 
+/// Hot/cold splitting is enabled explicitly, or by default on modules that
+/// carry a profile summary to tell the cold code apart. The summary is checked
+/// by the pass itself, since the LTO link step is not given the profile.
+void PassManagerBuilder::addHotColdSplittingPass(
+    legacy::PassManagerBase &PM) const {
+  if (EnableHotColdSplit)
+    PM.add(createHotColdSplittingPass());
+  else if (EnablePGOHotColdSplit)
+    PM.add(createHotColdSplittingPass(/*RequireProfileSummary=*/true));
+}
+
 // Do PGO instrumentation generation or use pass as the option specified.
 void PassManagerBuilder::addPGOInstrPasses(legacy::PassManagerBase &MPM,
                                            bool IsCS = false) {
@@ -681,6 +700,11 @@ void PassManagerBuilder::populateModulePassManager(
     MPM.add(createLICMPass(LicmMssaOptCap, LicmMssaNoAccForPromotionCap));
   }
 
+  // See comment in the new PM for justification of scheduling multiversioning
+  // at this stage (\ref buildModuleOptimizationPipeline).
+  if (EnableHotFunctionMultiVersioning && !(PrepareForLTO || PrepareForThinLTO))
+    MPM.add(createHotFunctionMultiVersioningPass());
+
   // We add a fresh GlobalsModRef run at this point. This is particularly
   // useful as the above will have inlined, DCE'ed, and function-attr
   // propagated everything. We should at this point have a reasonably minimal
@@ -808,8 +832,8 @@ void PassManagerBuilder::populateModulePassManager(
 
   // See comment in the new PM for justification of scheduling splitting at
   // this stage (\ref buildModuleSimplificationPipeline).
-  if (EnableHotColdSplit && !(PrepareForLTO || PrepareForThinLTO))
-    MPM.add(createHotColdSplittingPass());
+  if (!(PrepareForLTO || PrepareForThinLTO))
+    addHotColdSplittingPass(MPM);
 
   if (MergeFunctions)
     MPM.add(createMergeFunctionsPass());
@@ -978,6 +1002,11 @@ void PassManagerBuilder::addLTOOptimizationPasses(legacy::PassManagerBase &PM) {
   // Nuke dead stores.
   PM.add(createDeadStoreEliminationPass());
 
+  // Clone the hottest functions for wider vector units before the vectorizer
+  // runs.
+  if (EnableHotFunctionMultiVersioning)
+    PM.add(createHotFunctionMultiVersioningPass());
+
   // More loops are countable; try to optimize them.
   PM.add(createIndVarSimplifyPass());
   PM.add(createLoopDeletionPass());
@@ -1025,8 +1054,7 @@ void PassManagerBuilder::addLateLTOOptimizationPasses(
     legacy::PassManagerBase &PM) {
   // See comment in the new PM for justification of scheduling splitting at
   // this stage (\ref buildLTODefaultPipeline).
-  if (EnableHotColdSplit)
-    PM.add(createHotColdSplittingPass());
+  addHotColdSplittingPass(PM);
 
   // Delete basic blocks, which optimization passes may have killed.
   PM.add(createCFGSimplificationPass());
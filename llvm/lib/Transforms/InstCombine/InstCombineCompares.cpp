@@ -4716,7 +4716,7 @@ static Instruction *processUMulZExtIdiom(ICmpInst &I, Value *MulVal,
         if (TI->getType()->getPrimitiveSizeInBits() == MulWidth)
           IC.replaceInstUsesWith(*TI, Mul);
         else
-          TI->setOperand(0, Mul);
+          IC.replaceOperand(*TI, 0, Mul);
       } else if (BinaryOperator *BO = dyn_cast<BinaryOperator>(U)) {
         assert(BO->getOpcode() == Instruction::And);
         // Replace (mul & mask) --> zext (mul.with.overflow & short_mask)
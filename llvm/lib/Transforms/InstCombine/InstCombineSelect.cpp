@@ -894,7 +894,7 @@ static Value *foldSelectCttzCtlz(ICmpInst *ICI, Value *TrueVal, Value *FalseVal,
 /// Return true if we find and adjust an icmp+select pattern where the compare
 /// is with a constant that can be incremented or decremented to match the
 /// minimum or maximum idiom.
-static bool adjustMinMax(SelectInst &Sel, ICmpInst &Cmp) {
+static bool adjustMinMax(SelectInst &Sel, ICmpInst &Cmp, InstCombiner &IC) {
   ICmpInst::Predicate Pred = Cmp.getPredicate();
   Value *CmpLHS = Cmp.getOperand(0);
   Value *CmpRHS = Cmp.getOperand(1);
@@ -971,16 +971,19 @@ static bool adjustMinMax(SelectInst &Sel, ICmpInst &Cmp) {
   CmpRHS = AdjustedRHS;
   std::swap(FalseVal, TrueVal);
   Cmp.setPredicate(Pred);
-  Cmp.setOperand(0, CmpLHS);
-  Cmp.setOperand(1, CmpRHS);
-  Sel.setOperand(1, TrueVal);
-  Sel.setOperand(2, FalseVal);
+  IC.replaceOperand(Cmp, 0, CmpLHS);
+  IC.replaceOperand(Cmp, 1, CmpRHS);
+  IC.replaceOperand(Sel, 1, TrueVal);
+  IC.replaceOperand(Sel, 2, FalseVal);
   Sel.swapProfMetadata();
 
   // Move the compare instruction right before the select instruction. Otherwise
   // the sext/zext value may be defined after the compare instruction uses it.
   Cmp.moveBefore(&Sel);
 
+  // Only the select is revisited when we return, so revisit the compare too.
+  IC.Worklist.push(&Cmp);
+
   return true;
 }
 
@@ -1077,9 +1080,11 @@ static Instruction *canonicalizeAbsNabs(SelectInst &Sel, ICmpInst &Cmp,
   // Create the canonical compare: icmp slt LHS 0.
   if (!CmpCanonicalized) {
     Cmp.setPredicate(ICmpInst::ICMP_SLT);
-    Cmp.setOperand(1, ConstantInt::getNullValue(Cmp.getOperand(0)->getType()));
+    IC.replaceOperand(
+        Cmp, 1, ConstantInt::getNullValue(Cmp.getOperand(0)->getType()));
     if (CmpUsesNegatedOp)
-      Cmp.setOperand(0, LHS);
+      IC.replaceOperand(Cmp, 0, LHS);
+    IC.Worklist.push(&Cmp);
   }
 
   // Create the canonical RHS: RHS = sub (0, LHS).
@@ -1410,7 +1415,7 @@ Instruction *InstCombiner::foldSelectInstWithICmp(SelectInst &SI,
           tryToReuseConstantFromSelectInComparison(SI, *ICI, *this))
     return NewSel;
 
-  bool Changed = adjustMinMax(SI, *ICI);
+  bool Changed = adjustMinMax(SI, *ICI, *this);
 
   if (Value *V = foldSelectICmpAnd(SI, ICI, Builder))
     return replaceInstUsesWith(SI, V);
@@ -1424,11 +1429,11 @@ Instruction *InstCombiner::foldSelectInstWithICmp(SelectInst &SI,
   if (CmpRHS != CmpLHS && isa<Constant>(CmpRHS)) {
     if (CmpLHS == TrueVal && Pred == ICmpInst::ICMP_EQ) {
       // Transform (X == C) ? X : Y -> (X == C) ? C : Y
-      SI.setOperand(1, CmpRHS);
+      replaceOperand(SI, 1, CmpRHS);
       Changed = true;
     } else if (CmpLHS == FalseVal && Pred == ICmpInst::ICMP_NE) {
       // Transform (X != C) ? Y : X -> (X != C) ? Y : C
-      SI.setOperand(2, CmpRHS);
+      replaceOperand(SI, 2, CmpRHS);
       Changed = true;
     }
   }
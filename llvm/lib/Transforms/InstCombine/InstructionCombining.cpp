@@ -120,6 +120,13 @@ STATISTIC(NumSunkInst , "Number of instructions sunk");
 STATISTIC(NumExpand,    "Number of expansions");
 STATISTIC(NumFactor   , "Number of factorizations");
 STATISTIC(NumReassoc  , "Number of reassociations");
+STATISTIC(NumWorklistIterations,
+          "Number of instruction combining iterations performed");
+STATISTIC(NumOneIteration, "Number of functions with one iteration");
+STATISTIC(NumTwoIterations, "Number of functions with two iterations");
+STATISTIC(NumThreeIterations, "Number of functions with three iterations");
+STATISTIC(NumFourOrMoreIterations,
+          "Number of functions with four or more iterations");
 DEBUG_COUNTER(VisitCounter, "instcombine-visit",
               "Controls which instructions are visited");
 
@@ -141,6 +148,17 @@ static cl::opt<unsigned> InfiniteLoopDetectionThreshold(
              "infinite loop"),
     cl::init(InstCombineDefaultInfiniteLoopThreshold), cl::Hidden);
 
+// Every fold is expected to add the instructions it affects to the worklist,
+// so that a single iteration reaches a fixpoint. When this is set, one more
+// iteration than allowed by the iteration limit is run, and it is an error if
+// that iteration still changes something. Use it with
+// -instcombine-max-iterations=1 to find folds that miss worklist updates.
+static cl::opt<bool> VerifyFixpoint(
+    "instcombine-verify-fixpoint",
+    cl::desc("Verify that instruction combining reaches a fixpoint within "
+             "the iteration limit"),
+    cl::init(false), cl::Hidden);
+
 static cl::opt<unsigned>
 MaxArraySize("instcombine-maxarray-size", cl::init(1024),
              cl::desc("Maximum array size considered when doing a combine"));
@@ -2053,9 +2071,11 @@ Instruction *InstCombiner::visitGetElementPtrInst(GetElementPtrInst &GEP) {
           auto *SO0Ty = SO0->getType();
           if (!isa<VectorType>(GEPType) || // case 3
               isa<VectorType>(SO0Ty)) {    // case 4
-            Src->setOperand(1, GO1);
-            GEP.setOperand(1, SO1);
-            return &GEP;
+            // SO1 is loop variant, so Src is not a constant expression.
+            auto *SrcI = cast<Instruction>(Src);
+            replaceOperand(*SrcI, 1, GO1);
+            Worklist.push(SrcI);
+            return replaceOperand(GEP, 1, SO1);
           } else {
             // Case 1 or 2
             // -- have to recreate %src & %gep
@@ -3771,10 +3791,11 @@ static bool combineInstructionsOverFunction(
           Twine(InfiniteLoopDetectionThreshold) + " iterations.");
     }
 
-    if (Iteration > MaxIterations) {
+    if (Iteration > MaxIterations && !VerifyFixpoint) {
       LLVM_DEBUG(dbgs() << "\n\n[IC] Iteration limit #" << MaxIterations
                         << " on " << F.getName()
                         << " reached; stopping before reaching a fixpoint\n");
+      --Iteration;
       break;
     }
 
@@ -3791,7 +3812,22 @@ static bool combineInstructionsOverFunction(
       break;
 
     MadeIRChange = true;
-  }
+
+    if (Iteration > MaxIterations)
+      report_fatal_error("Instruction Combining did not reach a fixpoint on " +
+                         F.getName() + " after " + Twine(MaxIterations) +
+                         " iterations");
+  }
+
+  NumWorklistIterations += Iteration;
+  if (Iteration == 1)
+    ++NumOneIteration;
+  else if (Iteration == 2)
+    ++NumTwoIterations;
+  else if (Iteration == 3)
+    ++NumThreeIterations;
+  else if (Iteration > 3)
+    ++NumFourOrMoreIterations;
 
   return MadeIRChange;
 }
@@ -17,6 +17,8 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/MemoryBuiltins.h"
+#include "llvm/Analysis/ValueTracking.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/BasicBlock.h"
@@ -181,6 +183,11 @@ static cl::opt<bool> ClInlineAllChecks("hwasan-inline-all-checks",
                                        cl::desc("inline all checks"),
                                        cl::Hidden, cl::init(false));
 
+static cl::opt<bool> ClOptSafeAccesses(
+    "hwasan-opt-safe-accesses",
+    cl::desc("don't check inbounds accesses to stack variables and globals"),
+    cl::Hidden, cl::init(true));
+
 namespace {
 
 /// An instrumentation pass implementing detection of addressability bugs
@@ -215,6 +222,8 @@ public:
   Value *isInterestingMemoryAccess(Instruction *I, bool *IsWrite,
                                    uint64_t *TypeSize, unsigned *Alignment,
                                    Value **MaybeMask);
+  bool isSafeAccess(ObjectSizeOffsetVisitor &ObjSizeVis, Value *Addr,
+                    uint64_t TypeSize) const;
 
   bool isInterestingAlloca(const AllocaInst &AI);
   bool tagAlloca(IRBuilder<> &IRB, AllocaInst *AI, Value *Tag, size_t Size);
@@ -756,6 +765,25 @@ bool HWAddressSanitizer::instrumentMemAccess(Instruction *I) {
   return true;
 }
 
+// isSafeAccess returns true if Addr is always inbounds with respect to a stack
+// variable or a global, e.g. it is a field access or an array access with
+// constant inbounds index. The memory of such an object keeps its tag as long
+// as the function can refer to it directly, so the check can never fail.
+// Accesses to heap objects are not safe, as the object may have been freed.
+bool HWAddressSanitizer::isSafeAccess(ObjectSizeOffsetVisitor &ObjSizeVis,
+                                      Value *Addr, uint64_t TypeSize) const {
+  Value *Obj = GetUnderlyingObject(Addr, M.getDataLayout());
+  if (!isa<AllocaInst>(Obj) && !isa<GlobalVariable>(Obj))
+    return false;
+  SizeOffsetType SizeOffset = ObjSizeVis.compute(Addr);
+  if (!ObjSizeVis.bothKnown(SizeOffset))
+    return false;
+  uint64_t Size = SizeOffset.first.getZExtValue();
+  int64_t Offset = SizeOffset.second.getSExtValue();
+  return Offset >= 0 && Size >= uint64_t(Offset) &&
+         Size - uint64_t(Offset) >= TypeSize / 8;
+}
+
 static uint64_t getAllocaSizeInBytes(const AllocaInst &AI) {
   uint64_t ArraySize = 1;
   if (AI.isArrayAllocation()) {
@@ -1090,10 +1118,15 @@ bool HWAddressSanitizer::sanitizeFunction(Function &F) {
   LLVM_DEBUG(dbgs() << "Function: " << F.getName() << "\n");
 
   SmallVector<Instruction*, 16> ToInstrument;
+  SmallVector<Instruction*, 16> SafeAccesses;
   SmallVector<AllocaInst*, 8> AllocasToInstrument;
   SmallVector<Instruction*, 8> RetVec;
   SmallVector<Instruction*, 8> LandingPadVec;
   DenseMap<AllocaInst *, std::vector<DbgVariableIntrinsic *>> AllocaDbgMap;
+  // Note that the size of an object isn't rounded up to its alignment, as
+  // objects are only padded to the granule size.
+  ObjectSizeOffsetVisitor ObjSizeVis(M.getDataLayout(), /*TLI=*/nullptr,
+                                     F.getContext());
   for (auto &BB : F) {
     for (auto &Inst : BB) {
       if (ClInstrumentStack)
@@ -1121,7 +1154,10 @@ bool HWAddressSanitizer::sanitizeFunction(Function &F) {
       uint64_t TypeSize;
       Value *Addr = isInterestingMemoryAccess(&Inst, &IsWrite, &TypeSize,
                                               &Alignment, &MaybeMask);
-      if (Addr || isa<MemIntrinsic>(Inst))
+      if (Addr && !MaybeMask && ClOptSafeAccesses &&
+          isSafeAccess(ObjSizeVis, Addr, TypeSize))
+        SafeAccesses.push_back(&Inst);
+      else if (Addr || isa<MemIntrinsic>(Inst))
         ToInstrument.push_back(&Inst);
     }
   }
@@ -1138,7 +1174,8 @@ bool HWAddressSanitizer::sanitizeFunction(Function &F) {
     F.setPersonalityFn(nullptr);
   }
 
-  if (AllocasToInstrument.empty() && ToInstrument.empty())
+  if (AllocasToInstrument.empty() && ToInstrument.empty() &&
+      SafeAccesses.empty())
     return false;
 
   assert(!LocalDynamicShadow);
@@ -1219,6 +1256,15 @@ bool HWAddressSanitizer::sanitizeFunction(Function &F) {
   for (auto Inst : ToInstrument)
     Changed |= instrumentMemAccess(Inst);
 
+  // Safe accesses aren't checked, but they still need an untagged pointer on
+  // targets that don't ignore the top byte of addresses.
+  if (!TargetTriple.isAArch64()) {
+    for (auto Inst : SafeAccesses)
+      untagPointerOperand(Inst,
+                          Inst->getOperand(getPointerOperandIndex(Inst)));
+    Changed |= !SafeAccesses.empty();
+  }
+
   LocalDynamicShadow = nullptr;
   StackBaseTag = nullptr;
 
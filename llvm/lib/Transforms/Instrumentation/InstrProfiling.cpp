@@ -426,6 +426,7 @@ static InstrProfIncrementInst *castToIncrementInst(Instruction *Instr) {
 bool InstrProfiling::lowerIntrinsics(Function *F) {
   bool MadeChange = false;
   PromotionCandidates.clear();
+  CounterBiasLoad = nullptr;
   for (BasicBlock &BB : *F) {
     for (auto I = BB.begin(), E = BB.end(); I != E;) {
       auto Instr = I++;
@@ -675,22 +676,24 @@ void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
   if (isRuntimeCounterRelocationEnabled()) {
     Type *Int64Ty = Type::getInt64Ty(M->getContext());
     Type *Int64PtrTy = Type::getInt64PtrTy(M->getContext());
-    Function *Fn = Inc->getParent()->getParent();
-    Instruction &I = Fn->getEntryBlock().front();
-    LoadInst *LI = dyn_cast<LoadInst>(&I);
-    if (!LI) {
-      IRBuilder<> Builder(&I);
-      Type *Int64Ty = Type::getInt64Ty(M->getContext());
-      GlobalVariable *Bias = M->getGlobalVariable(getInstrProfCounterBiasVarName());
+    // Load the bias once in the entry block and share it between all the
+    // counter updates of the function. Don't look for an existing load at the
+    // start of the entry block, it may be a load of something else.
+    if (!CounterBiasLoad) {
+      Function *Fn = Inc->getParent()->getParent();
+      IRBuilder<> EntryBuilder(&Fn->getEntryBlock().front());
+      GlobalVariable *Bias =
+          M->getGlobalVariable(getInstrProfCounterBiasVarName());
       if (!Bias) {
-        Bias = new GlobalVariable(*M, Int64Ty, false, GlobalValue::LinkOnceODRLinkage,
-                                  Constant::getNullValue(Int64Ty),
-                                  getInstrProfCounterBiasVarName());
+        Bias = new GlobalVariable(
+            *M, Int64Ty, false, GlobalValue::LinkOnceODRLinkage,
+            Constant::getNullValue(Int64Ty), getInstrProfCounterBiasVarName());
         Bias->setVisibility(GlobalVariable::HiddenVisibility);
       }
-      LI = Builder.CreateLoad(Int64Ty, Bias);
+      CounterBiasLoad = EntryBuilder.CreateLoad(Int64Ty, Bias);
     }
-    auto *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty), LI);
+    auto *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty),
+                                  CounterBiasLoad);
     Addr = Builder.CreateIntToPtr(Add, Int64PtrTy);
   }
 
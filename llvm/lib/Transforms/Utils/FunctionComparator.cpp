@@ -907,20 +907,119 @@ public:
 
 } // end anonymous namespace
 
-// A function hash is calculated by considering only the number of arguments and
-// whether a function is varargs, the order of basic blocks (given by the
-// successors of each basic block in depth first order), and the order of
-// opcodes of each instruction within each of these basic blocks. This mirrors
-// the strategy compare() uses to compare functions by walking the BBs in depth
-// first order and comparing each instruction in sequence. Because this hash
-// does not look at the operands, it is insensitive to things such as the
-// target of calls and the constants used in the function, which makes it useful
-// when possibly merging functions which are the same modulo constants and call
-// targets.
-FunctionComparator::FunctionHash FunctionComparator::functionHash(Function &F) {
+// Add the parts of a type that cmpTypes() looks at without recursing into the
+// element types. Pointers in address space 0 compare like the integer type of
+// the same size, so they hash like it as well.
+static void hashType(HashAccumulator64 &H, Type *Ty, const DataLayout &DL) {
+  if (auto *PTy = dyn_cast<PointerType>(Ty))
+    if (PTy->getAddressSpace() == 0)
+      Ty = DL.getIntPtrType(Ty);
+  H.add(Ty->getTypeID());
+  switch (Ty->getTypeID()) {
+  case Type::IntegerTyID:
+    H.add(cast<IntegerType>(Ty)->getBitWidth());
+    break;
+  case Type::PointerTyID:
+    H.add(cast<PointerType>(Ty)->getAddressSpace());
+    break;
+  case Type::StructTyID:
+    H.add(cast<StructType>(Ty)->getNumElements());
+    break;
+  case Type::FunctionTyID:
+    H.add(cast<FunctionType>(Ty)->getNumParams());
+    break;
+  case Type::ArrayTyID:
+  case Type::VectorTyID:
+    H.add(cast<SequentialType>(Ty)->getNumElements());
+    break;
+  default:
+    break;
+  }
+}
+
+// Add what cmpValues() can tell apart about an operand without looking at
+// other functions: whether it is a constant at all, whether it is null, and the
+// value of integer constants.
+static void hashOperand(HashAccumulator64 &H, const Value *Op) {
+  const auto *C = dyn_cast<Constant>(Op);
+  if (!C) {
+    H.add(0);
+  } else if (C->isNullValue()) {
+    H.add(1);
+  } else if (const auto *CI = dyn_cast<ConstantInt>(C)) {
+    H.add(2);
+    H.add(hash_value(CI->getValue()));
+  } else {
+    H.add(3);
+  }
+}
+
+// Add the parts of an instruction that cmpOperations() compares as plain
+// numbers, leaving out the operands themselves unless HashConstants is set.
+static void hashInstruction(HashAccumulator64 &H, const Instruction &Inst,
+                            const DataLayout &DL, bool HashConstants) {
+  H.add(Inst.getOpcode());
+  // GEPs are compared by the offset they compute if it is constant, so
+  // neither their types nor their number of operands are hashed.
+  if (auto *GEP = dyn_cast<GetElementPtrInst>(&Inst)) {
+    H.add(GEP->getPointerAddressSpace());
+    return;
+  }
+  H.add(Inst.getNumOperands());
+  H.add(Inst.getRawSubclassOptionalData());
+  hashType(H, Inst.getType(), DL);
+  for (const Value *Op : Inst.operand_values()) {
+    hashType(H, Op->getType(), DL);
+    if (HashConstants)
+      hashOperand(H, Op);
+  }
+
+  if (const auto *LI = dyn_cast<LoadInst>(&Inst)) {
+    H.add(LI->isVolatile());
+    H.add(LI->getAlignment());
+    H.add(static_cast<uint64_t>(LI->getOrdering()));
+  } else if (const auto *SI = dyn_cast<StoreInst>(&Inst)) {
+    H.add(SI->isVolatile());
+    H.add(SI->getAlignment());
+    H.add(static_cast<uint64_t>(SI->getOrdering()));
+  } else if (const auto *CI = dyn_cast<CmpInst>(&Inst)) {
+    H.add(CI->getPredicate());
+  } else if (const auto *Call = dyn_cast<CallBase>(&Inst)) {
+    H.add(Call->getCallingConv());
+    if (const auto *CI = dyn_cast<CallInst>(Call))
+      H.add(CI->getTailCallKind());
+  }
+}
+
+// A function hash is calculated by considering the signature of the function,
+// the order of basic blocks (given by the successors of each basic block in
+// depth first order), and for each instruction within each of these basic
+// blocks, its opcode and the parts of it that compare() looks at as plain
+// numbers, such as its type, its number of operands and the types of those,
+// predicates, alignments and calling conventions. This mirrors the strategy
+// compare() uses to compare functions by walking the BBs in depth first order
+// and comparing each instruction in sequence. Because this hash does not look
+// at the operands, it is insensitive to things such as the target of calls and
+// the constants used in the function, which makes it useful when possibly
+// merging functions which are the same modulo constants and call targets.
+//
+// Only looking at the opcodes would be enough to be consistent with compare(),
+// but then all the instantiations of a template that differ in their types
+// would hash alike, and MergeFunctions would have to tell them apart with full
+// comparisons. For the same reason, HashConstants also takes the integer
+// constants used as operands into account.
+FunctionComparator::FunctionHash
+FunctionComparator::functionHash(Function &F, bool HashConstants) {
+  const DataLayout &DL = F.getParent()->getDataLayout();
   HashAccumulator64 H;
   H.add(F.isVarArg());
   H.add(F.arg_size());
+  H.add(F.getCallingConv());
+  H.add(F.hasGC());
+  H.add(F.hasSection());
+  hashType(H, F.getReturnType(), DL);
+  for (const Argument &Arg : F.args())
+    hashType(H, Arg.getType(), DL);
 
   SmallVector<const BasicBlock *, 8> BBs;
   SmallPtrSet<const BasicBlock *, 16> VisitedBBs;
@@ -935,7 +1034,7 @@ FunctionComparator::FunctionHash FunctionComparator::functionHash(Function &F) {
     // opcodes into BBs wouldn't affect the hash, only the order of the opcodes
     H.add(45798);
     for (auto &Inst : *BB) {
-      H.add(Inst.getOpcode());
+      hashInstruction(H, Inst, DL, HashConstants);
     }
     const Instruction *Term = BB->getTerminator();
     for (unsigned i = 0, e = Term->getNumSuccessors(); i != e; ++i) {
@@ -15,6 +15,7 @@
 #include "llvm/Transforms/Utils/SplitModule.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/EquivalenceClasses.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -27,7 +28,9 @@
 #include "llvm/IR/GlobalIndirectSymbol.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instruction.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/User.h"
 #include "llvm/IR/Value.h"
@@ -91,12 +94,113 @@ static void addAllGlobalValueUsers(ClusterMapType &GVtoClusterMap,
   }
 }
 
+// Returns an estimate of the cost of generating code for GV.
+static uint64_t getCodeGenCost(const GlobalValue *GV) {
+  if (const Function *F = dyn_cast<Function>(GV))
+    return F->getInstructionCount() + 1;
+  return 1;
+}
+
+// Returns the weight of a call edge between two functions. Edges between
+// functions that are known to run often according to the profile are heavier.
+static uint64_t getCallEdgeWeight(const Function &Caller,
+                                  const Function &Callee) {
+  Function::ProfileCount CallerCount = Caller.getEntryCount();
+  Function::ProfileCount CalleeCount = Callee.getEntryCount();
+  if (!CallerCount.hasValue() || !CalleeCount.hasValue())
+    return 1;
+  return std::max<uint64_t>(
+      std::min(CallerCount.getCount(), CalleeCount.getCount()), 1);
+}
+
+// Group the clusters of GVtoClusterMap further so that functions that call
+// each other end up in the same partition, which keeps related code together
+// in the output. Call edges are considered in order of decreasing weight, and
+// clusters are only merged while they stay small enough for the partitions to
+// be balanced. Then assign the clusters to N partitions, largest first, each
+// to the partition with the lowest estimated code generation cost so far.
+static void findAffinityPartitions(Module *M, ClusterMapType &GVtoClusterMap,
+                                   ClusterIDMapType &ClusterIDMap,
+                                   unsigned N) {
+  std::vector<const GlobalValue *> Defined;
+  for (const GlobalValue &GV : M->global_values())
+    if (!GV.isDeclaration())
+      Defined.push_back(&GV);
+
+  // Collect the cost of each cluster, indexed by its leader.
+  DenseMap<const GlobalValue *, uint64_t> ClusterCost;
+  uint64_t TotalCost = 0;
+  for (const GlobalValue *GV : Defined) {
+    uint64_t Cost = getCodeGenCost(GV);
+    ClusterCost[GVtoClusterMap.getOrInsertLeaderValue(GV)] += Cost;
+    TotalCost += Cost;
+  }
+
+  // Collect the call edges between defined functions. A MapVector keeps the
+  // order deterministic.
+  MapVector<std::pair<const Function *, const Function *>, uint64_t> Edges;
+  for (const Function &F : M->functions())
+    for (const Instruction &I : instructions(F))
+      if (const auto *CB = dyn_cast<CallBase>(&I))
+        if (const Function *Callee = CB->getCalledFunction())
+          if (Callee != &F && !Callee->isDeclaration())
+            Edges[{&F, Callee}] += getCallEdgeWeight(F, *Callee);
+
+  std::vector<std::pair<std::pair<const Function *, const Function *>,
+                        uint64_t>>
+      SortedEdges(Edges.begin(), Edges.end());
+  llvm::stable_sort(SortedEdges, [](const auto &A, const auto &B) {
+    return A.second > B.second;
+  });
+
+  // Limit clusters to half of a partition so that the assignment below can
+  // still balance the partitions.
+  uint64_t MaxClusterCost = std::max<uint64_t>(TotalCost / N / 2, 1);
+  for (auto &Edge : SortedEdges) {
+    const GlobalValue *L1 = GVtoClusterMap.getLeaderValue(Edge.first.first);
+    const GlobalValue *L2 = GVtoClusterMap.getLeaderValue(Edge.first.second);
+    if (L1 == L2)
+      continue;
+    uint64_t Cost = ClusterCost[L1] + ClusterCost[L2];
+    if (Cost > MaxClusterCost)
+      continue;
+    ClusterCost.erase(L1);
+    ClusterCost.erase(L2);
+    ClusterCost[*GVtoClusterMap.unionSets(L1, L2)] = Cost;
+  }
+
+  // To guarantee determinism, sort clusters by cost and then by the name of
+  // their leaders.
+  std::vector<std::pair<uint64_t, const GlobalValue *>> Clusters;
+  for (auto &C : ClusterCost)
+    Clusters.push_back({C.second, C.first});
+  llvm::sort(Clusters, [](const auto &A, const auto &B) {
+    if (A.first != B.first)
+      return A.first > B.first;
+    return A.second->getName() < B.second->getName();
+  });
+
+  std::vector<uint64_t> PartitionCost(N);
+  for (auto &C : Clusters) {
+    unsigned ID = std::min_element(PartitionCost.begin(), PartitionCost.end()) -
+                  PartitionCost.begin();
+    PartitionCost[ID] += C.first;
+    LLVM_DEBUG(dbgs() << "Root[" << ID << "] cluster_cost(" << C.first
+                      << ") ----> " << C.second->getName() << "\n");
+    for (ClusterMapType::member_iterator
+             MI = GVtoClusterMap.findLeader(C.second),
+             ME = GVtoClusterMap.member_end();
+         MI != ME; ++MI)
+      ClusterIDMap[*MI] = ID;
+  }
+}
+
 // Find partitions for module in the way that no locals need to be
 // globalized.
 // Try to balance pack those partitions into N files since this roughly equals
 // thread balancing for the backend codegen step.
 static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
-                           unsigned N) {
+                           unsigned N, bool ClusterByAffinity) {
   // At this point module should have the proper mix of globals and locals.
   // As we attempt to partition this module, we must not change any
   // locals to globals.
@@ -148,6 +252,9 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
   llvm::for_each(M->globals(), recordGVSet);
   llvm::for_each(M->aliases(), recordGVSet);
 
+  if (ClusterByAffinity)
+    return findAffinityPartitions(M, GVtoClusterMap, ClusterIDMap, N);
+
   // Assigned all GVs to merged clusters while balancing number of objects in
   // each.
   auto CompareClusters = [](const std::pair<unsigned, unsigned> &a,
@@ -249,7 +356,7 @@ static bool isInPartition(const GlobalValue *GV, unsigned I, unsigned N) {
 void llvm::SplitModule(
     std::unique_ptr<Module> M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
-    bool PreserveLocals) {
+    bool PreserveLocals, bool ClusterByAffinity) {
   if (!PreserveLocals) {
     for (Function &F : *M)
       externalize(&F);
@@ -264,7 +371,7 @@ void llvm::SplitModule(
   // This performs splitting without a need for externalization, which might not
   // always be possible.
   ClusterIDMapType ClusterIDMap;
-  findPartitions(M.get(), ClusterIDMap, N);
+  findPartitions(M.get(), ClusterIDMap, N, ClusterByAffinity);
 
   // FIXME: We should be able to reuse M as the last partition instead of
   // cloning it.
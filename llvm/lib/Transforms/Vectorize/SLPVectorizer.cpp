@@ -3788,6 +3788,28 @@ int BoUpSLP::getTreeCost() {
 
   unsigned BundleWidth = VectorizableTree[0]->Scalars.size();
 
+  // Find the gather entries that are the same as a later gather entry in a
+  // single backwards walk, instead of comparing every gather entry with all
+  // the entries after it. Gathers with reused scalars can match a longer
+  // list, but they are rare, so those are still compared one by one.
+  SmallVector<bool, 16> HasLaterDuplicate(VectorizableTree.size());
+  DenseSet<ArrayRef<Value *>> LaterGathers;
+  SmallVector<const TreeEntry *, 4> LaterReusingGathers;
+  for (unsigned I = VectorizableTree.size(); I-- > 0;) {
+    const TreeEntry &TE = *VectorizableTree[I];
+    if (TE.State != TreeEntry::NeedToGather)
+      continue;
+    ArrayRef<Value *> VL = TE.Scalars;
+    HasLaterDuplicate[I] =
+        LaterGathers.count(VL) ||
+        llvm::any_of(LaterReusingGathers, [VL](const TreeEntry *Later) {
+          return Later->isSame(VL);
+        });
+    LaterGathers.insert(VL);
+    if (!TE.ReuseShuffleIndices.empty())
+      LaterReusingGathers.push_back(&TE);
+  }
+
   for (unsigned I = 0, E = VectorizableTree.size(); I < E; ++I) {
     TreeEntry &TE = *VectorizableTree[I].get();
 
@@ -3803,13 +3825,7 @@ int BoUpSLP::getTreeCost() {
     // their uses. Since such an approach results in fewer total entries,
     // existing heuristics based on tree size may yield different results.
     //
-    if (TE.State == TreeEntry::NeedToGather &&
-        std::any_of(std::next(VectorizableTree.begin(), I + 1),
-                    VectorizableTree.end(),
-                    [TE](const std::unique_ptr<TreeEntry> &EntryPtr) {
-                      return EntryPtr->State == TreeEntry::NeedToGather &&
-                             EntryPtr->isSame(TE.Scalars);
-                    }))
+    if (HasLaterDuplicate[I])
       continue;
 
     int C = getEntryCost(&TE);
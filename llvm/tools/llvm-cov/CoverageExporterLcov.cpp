@@ -37,6 +37,8 @@
 
 #include "CoverageExporterLcov.h"
 #include "CoverageReport.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace llvm;
 
@@ -100,10 +102,31 @@ void renderFile(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
 void renderFiles(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
                  ArrayRef<std::string> SourceFiles,
                  ArrayRef<FileCoverageSummary> FileReports,
-                 bool ExportSummaryOnly, bool SkipFunctions) {
-  for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I)
-    renderFile(OS, Coverage, SourceFiles[I], FileReports[I], ExportSummaryOnly,
-               SkipFunctions);
+                 bool ExportSummaryOnly, bool SkipFunctions,
+                 unsigned NumThreads) {
+  if (NumThreads == 0)
+    NumThreads = SourceFiles.size();
+  if (NumThreads <= 1) {
+    for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I)
+      renderFile(OS, Coverage, SourceFiles[I], FileReports[I],
+                 ExportSummaryOnly, SkipFunctions);
+    return;
+  }
+
+  // Render the records in parallel and emit them in the original order so
+  // that the output doesn't depend on the number of threads.
+  std::vector<std::string> Records(SourceFiles.size());
+  ThreadPool Pool(heavyweight_hardware_concurrency(NumThreads));
+  for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I) {
+    Pool.async([&, I] {
+      raw_string_ostream RecordOS(Records[I]);
+      renderFile(RecordOS, Coverage, SourceFiles[I], FileReports[I],
+                 ExportSummaryOnly, SkipFunctions);
+    });
+  }
+  Pool.wait();
+  for (const std::string &Record : Records)
+    OS << Record;
 }
 
 } // end anonymous namespace
@@ -122,5 +145,5 @@ void CoverageExporterLcov::renderRoot(ArrayRef<std::string> SourceFiles) {
   auto FileReports = CoverageReport::prepareFileReports(Coverage, Totals,
                                                         SourceFiles, Options);
   renderFiles(OS, Coverage, SourceFiles, FileReports, Options.ExportSummaryOnly,
-              Options.SkipFunctions);
+              Options.SkipFunctions, Options.NumThreads);
 }
@@ -244,6 +244,30 @@ Analysis::makePointsPerSchedClass() const {
   return Entries;
 }
 
+std::vector<Analysis::SchedClassCluster> Analysis::makeSchedClassClusters(
+    const ResolvedSchedClassAndPoints &RSCAndPoints) const {
+  // Bucket sched class points into sched class clusters.
+  std::vector<SchedClassCluster> SchedClassClusters;
+  for (const size_t PointId : RSCAndPoints.PointIds) {
+    const auto &ClusterId = Clustering_.getClusterIdForPoint(PointId);
+    if (!ClusterId.isValid())
+      continue; // Ignore noise and errors. FIXME: take noise into account ?
+    if (ClusterId.isUnstable() ^ AnalysisDisplayUnstableOpcodes_)
+      continue; // Either display stable or unstable clusters only.
+    auto SchedClassClusterIt =
+        std::find_if(SchedClassClusters.begin(), SchedClassClusters.end(),
+                     [ClusterId](const SchedClassCluster &C) {
+                       return C.id() == ClusterId;
+                     });
+    if (SchedClassClusterIt == SchedClassClusters.end()) {
+      SchedClassClusters.emplace_back();
+      SchedClassClusterIt = std::prev(SchedClassClusters.end());
+    }
+    SchedClassClusterIt->addPoint(PointId, Clustering_);
+  }
+  return SchedClassClusters;
+}
+
 // Parallel benchmarks repeat the same opcode multiple times. Just show this
 // opcode and show the whole snippet only on hover.
 static void writeParallelSnippetHtml(raw_ostream &OS,
@@ -547,25 +571,8 @@ Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
     if (!RSCAndPoints.RSC.SCDesc)
       continue;
-    // Bucket sched class points into sched class clusters.
-    std::vector<SchedClassCluster> SchedClassClusters;
-    for (const size_t PointId : RSCAndPoints.PointIds) {
-      const auto &ClusterId = Clustering_.getClusterIdForPoint(PointId);
-      if (!ClusterId.isValid())
-        continue; // Ignore noise and errors. FIXME: take noise into account ?
-      if (ClusterId.isUnstable() ^ AnalysisDisplayUnstableOpcodes_)
-        continue; // Either display stable or unstable clusters only.
-      auto SchedClassClusterIt =
-          std::find_if(SchedClassClusters.begin(), SchedClassClusters.end(),
-                       [ClusterId](const SchedClassCluster &C) {
-                         return C.id() == ClusterId;
-                       });
-      if (SchedClassClusterIt == SchedClassClusters.end()) {
-        SchedClassClusters.emplace_back();
-        SchedClassClusterIt = std::prev(SchedClassClusters.end());
-      }
-      SchedClassClusterIt->addPoint(PointId, Clustering_);
-    }
+    const std::vector<SchedClassCluster> SchedClassClusters =
+        makeSchedClassClusters(RSCAndPoints);
 
     // Print any scheduling class that has at least one cluster that does not
     // match the checked-in data.
@@ -599,5 +606,65 @@ Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   return Error::success();
 }
 
+template <>
+Error Analysis::run<Analysis::PrintSchedClassDiffs>(raw_ostream &OS) const {
+  const InstructionBenchmark::ModeE Mode = Clustering_.getPoints()[0].Mode;
+
+  // Write the header.
+  OS << "sched_class" << kCsvSep << "cluster_id" << kCsvSep << "opcode_names"
+     << kCsvSep << "measure" << kCsvSep << "measured" << kCsvSep << "model"
+     << "\n";
+
+  for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
+    if (!RSCAndPoints.RSC.SCDesc)
+      continue;
+    for (const SchedClassCluster &Cluster :
+         makeSchedClassClusters(RSCAndPoints)) {
+      if (Cluster.measurementsMatch(*SubtargetInfo_, RSCAndPoints.RSC,
+                                    Clustering_,
+                                    AnalysisInconsistencyEpsilonSquared_))
+        continue;
+      const SchedClassClusterCentroid &Centroid = Cluster.getCentroid();
+      if (!Centroid.validate(Mode))
+        continue;
+      const std::vector<BenchmarkMeasure> Measured = Centroid.getAsPoint();
+      const std::vector<BenchmarkMeasure> Model =
+          RSCAndPoints.RSC.getAsPoint(Mode, *SubtargetInfo_,
+                                      Centroid.getStats());
+      if (Model.size() != Measured.size())
+        continue;
+
+      // The distinct opcodes of the cluster, in order of appearance.
+      SmallVector<StringRef, 4> OpcodeNames;
+      for (const size_t PointId : Cluster.getPointIds()) {
+        const StringRef Name = InstrInfo_->getName(
+            Clustering_.getPoints()[PointId].keyInstruction().getOpcode());
+        if (!is_contained(OpcodeNames, Name))
+          OpcodeNames.push_back(Name);
+      }
+
+      for (size_t I = 0, E = Measured.size(); I < E; ++I) {
+#if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
+        writeEscaped<kEscapeCsv>(OS, RSCAndPoints.RSC.SCDesc->Name);
+#else
+        OS << RSCAndPoints.RSC.SchedClassId;
+#endif
+        OS << kCsvSep;
+        writeClusterId<kEscapeCsv>(OS, Cluster.id());
+        OS << kCsvSep;
+        writeEscaped<kEscapeCsv>(OS, join(OpcodeNames, " "));
+        OS << kCsvSep;
+        writeEscaped<kEscapeCsv>(OS, Measured[I].Key);
+        OS << kCsvSep;
+        writeMeasurementValue<kEscapeCsv>(OS, Measured[I].PerInstructionValue);
+        OS << kCsvSep;
+        writeMeasurementValue<kEscapeCsv>(OS, Model[I].PerInstructionValue);
+        OS << "\n";
+      }
+    }
+  }
+  return Error::success();
+}
+
 } // namespace exegesis
 } // namespace llvm
@@ -145,6 +145,12 @@ static cl::opt<std::string>
                                       cl::desc(""), cl::cat(AnalysisOptions),
                                       cl::init(""));
 
+static cl::opt<std::string> AnalysisSchedClassDiffsOutputFile(
+    "analysis-sched-class-diffs-output-file",
+    cl::desc("csv file listing the measured and modeled values of each "
+             "inconsistent sched class, one row per measure"),
+    cl::cat(AnalysisOptions), cl::init(""));
+
 static cl::opt<bool> AnalysisDisplayUnstableOpcodes(
     "analysis-display-unstable-clusters",
     cl::desc("if there is more than one benchmark for an opcode, said "
@@ -375,10 +381,12 @@ static void analysisMain() {
     ExitWithError("--benchmarks-file must be set");
 
   if (AnalysisClustersOutputFile.empty() &&
-      AnalysisInconsistenciesOutputFile.empty()) {
+      AnalysisInconsistenciesOutputFile.empty() &&
+      AnalysisSchedClassDiffsOutputFile.empty()) {
     ExitWithError(
-        "for --mode=analysis: At least one of --analysis-clusters-output-file"
-        "and --analysis-inconsistencies-output-file must be specified");
+        "for --mode=analysis: At least one of --analysis-clusters-output-file,"
+        " --analysis-inconsistencies-output-file and "
+        "--analysis-sched-class-diffs-output-file must be specified");
   }
 
   InitializeNativeTarget();
@@ -421,6 +429,8 @@ static void analysisMain() {
   maybeRunAnalysis<Analysis::PrintSchedClassInconsistencies>(
       Analyzer, "sched class consistency analysis",
       AnalysisInconsistenciesOutputFile);
+  maybeRunAnalysis<Analysis::PrintSchedClassDiffs>(
+      Analyzer, "sched class diffs", AnalysisSchedClassDiffsOutputFile);
 }
 
 } // namespace exegesis
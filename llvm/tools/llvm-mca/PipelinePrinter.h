@@ -19,6 +19,7 @@
 #include "Views/View.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/MCA/Pipeline.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 
 #define DEBUG_TYPE "llvm-mca"
@@ -46,6 +47,9 @@ public:
   }
 
   void printReport(llvm::raw_ostream &OS) const;
+
+  /// Adds the data of every view that can be exported to JSON to \p JO.
+  void printReport(llvm::json::Object &JO) const;
 };
 } // namespace mca
 } // namespace llvm
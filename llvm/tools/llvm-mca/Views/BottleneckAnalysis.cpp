@@ -591,6 +591,16 @@ void BottleneckAnalysis::onCycleEnd() {
   PressureIncreasedBecauseOfMemoryDependencies = false;
 }
 
+json::Value BottleneckAnalysis::toJSON() const {
+  return json::Object(
+      {{"TotalCycles", TotalCycles},
+       {"PressureIncreaseCycles", BPI.PressureIncreaseCycles},
+       {"ResourcePressureCycles", BPI.ResourcePressureCycles},
+       {"DataDependencyCycles", BPI.DataDependencyCycles},
+       {"RegisterDependencyCycles", BPI.RegisterDependencyCycles},
+       {"MemoryDependencyCycles", BPI.MemoryDependencyCycles}});
+}
+
 void BottleneckAnalysis::printBottleneckHints(raw_ostream &OS) const {
   if (!SeenStallCycles || !BPI.PressureIncreaseCycles) {
     OS << "\n\nNo resource or data dependency bottlenecks discovered.\n";
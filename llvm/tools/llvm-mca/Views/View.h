@@ -15,7 +15,9 @@
 #ifndef LLVM_TOOLS_LLVM_MCA_VIEW_H
 #define LLVM_TOOLS_LLVM_MCA_VIEW_H
 
+#include "llvm/ADT/StringRef.h"
 #include "llvm/MCA/HWEventListener.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
@@ -24,6 +26,12 @@ namespace mca {
 class View : public HWEventListener {
 public:
   virtual void printView(llvm::raw_ostream &OS) const = 0;
+
+  /// Returns the key under which this view is reported in JSON output, or an
+  /// empty string if the view can't be exported to JSON.
+  virtual llvm::StringRef getNameAsString() const { return llvm::StringRef(); }
+  virtual llvm::json::Value toJSON() const { return nullptr; }
+
   virtual ~View() = default;
   void anchor() override;
 };
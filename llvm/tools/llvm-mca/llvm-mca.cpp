@@ -51,8 +51,10 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
@@ -215,6 +217,12 @@ static cl::opt<bool> ShowEncoding(
     cl::desc("Print encoding information in the instruction info view"),
     cl::cat(ViewOptions), cl::init(false));
 
+static cl::opt<bool> PrintJson(
+    "json",
+    cl::desc("Print the summary and bottleneck analysis of each code region "
+             "in JSON format"),
+    cl::cat(ViewOptions), cl::init(false));
+
 namespace {
 
 const Target *getTarget(const char *ProgName) {
@@ -333,6 +341,11 @@ int main(int argc, char **argv) {
   if (!STI->isCPUStringValid(MCPU))
     return 1;
 
+  if (PrintJson && PrintInstructionTables) {
+    WithColor::error() << "-json is not supported with -instruction-tables\n";
+    return 1;
+  }
+
   if (!PrintInstructionTables && !STI->getSchedModel().isOutOfOrder()) {
     WithColor::error() << "please specify an out-of-order cpu. '" << MCPU
                        << "' is an in-order cpu.\n";
@@ -441,6 +454,9 @@ int main(int argc, char **argv) {
   // Number each region in the sequence.
   unsigned RegionIdx = 0;
 
+  // The reports of the code regions when printing JSON.
+  json::Array JSONRegions;
+
   std::unique_ptr<MCCodeEmitter> MCE(
       TheTarget->createMCCodeEmitter(*MCII, *MRI, Ctx));
 
@@ -454,7 +470,8 @@ int main(int argc, char **argv) {
 
     // Don't print the header of this region if it is the default region, and
     // it doesn't have an end location.
-    if (Region->startLoc().isValid() || Region->endLoc().isValid()) {
+    if (!PrintJson &&
+        (Region->startLoc().isValid() || Region->endLoc().isValid())) {
       TOF->os() << "\n[" << RegionIdx++ << "] Code Region";
       StringRef Desc = Region->getDescription();
       if (!Desc.empty())
@@ -558,12 +575,26 @@ int main(int argc, char **argv) {
     if (!runPipeline(*P))
       return 1;
 
-    Printer.printReport(TOF->os());
+    if (PrintJson) {
+      json::Object JSONRegion;
+      JSONRegion.try_emplace("Name", Region->getDescription());
+      Printer.printReport(JSONRegion);
+      JSONRegions.push_back(std::move(JSONRegion));
+    } else {
+      Printer.printReport(TOF->os());
+    }
 
     // Clear the InstrBuilder internal state in preparation for another round.
     IB.clear();
   }
 
+  if (PrintJson) {
+    json::Object JSONOutput({{"TargetTriple", TripleName},
+                             {"CPUName", MCPU},
+                             {"CodeRegions", std::move(JSONRegions)}});
+    TOF->os() << formatv("{0:2}", json::Value(std::move(JSONOutput))) << '\n';
+  }
+
   TOF->keep();
   return 0;
 }
@@ -1058,14 +1058,17 @@ public:
   Error removeSections(bool AllowBrokenLinks,
                        std::function<bool(const SectionBase &)> ToRemove);
   Error removeSymbols(function_ref<bool(const Symbol &)> ToRemove);
-  template <class T, class... Ts> T &addSection(Ts &&... Args) {
-    auto Sec = std::make_unique<T>(std::forward<Ts>(Args)...);
+  SectionBase &addSection(std::unique_ptr<SectionBase> Sec) {
     auto Ptr = Sec.get();
     MustBeRelocatable |= isa<RelocationSection>(*Ptr);
     Sections.emplace_back(std::move(Sec));
     Ptr->Index = Sections.size();
     return *Ptr;
   }
+  template <class T, class... Ts> T &addSection(Ts &&... Args) {
+    return static_cast<T &>(
+        addSection(std::make_unique<T>(std::forward<Ts>(Args)...)));
+  }
   Segment &addSegment(ArrayRef<uint8_t> Data) {
     Segments.emplace_back(std::make_unique<Segment>(Data));
     return *Segments.back();
@@ -1326,7 +1326,7 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
     uint64_t Size;
     uint64_t Index;
     bool PrintedSection = false;
-    std::vector<RelocationRef> Rels = RelocMap[Section];
+    std::vector<RelocationRef> &Rels = RelocMap[Section];
     std::vector<RelocationRef>::const_iterator RelCur = Rels.begin();
     std::vector<RelocationRef>::const_iterator RelEnd = Rels.end();
     // Disassemble symbol by symbol.
@@ -14,25 +14,52 @@
 
 #include "Delta.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Transforms/Utils/Cloning.h"
-#include <fstream>
+#include <deque>
 #include <set>
 
 using namespace llvm;
 
-bool IsReduced(Module &M, TestRunner &Test, SmallString<128> &CurrentFilepath) {
+static cl::opt<unsigned> NumJobs(
+    "j",
+    cl::desc("Maximum number of interesting-ness tests to run in parallel. "
+             "Set to 1 to disable parallelism."),
+    cl::init(1));
+
+static cl::opt<bool> TmpFilesAsBitcode(
+    "write-tmp-files-as-bitcode",
+    cl::desc("Write temporary files as bitcode, instead of textual IR"),
+    cl::init(false));
+
+/// Writes \p M to a temporary file and runs the interesting-ness test on it.
+/// If the file is textual IR, sets \p Lines to its number of lines.
+static bool IsReduced(Module &M, TestRunner &Test, int &Lines) {
+  SmallString<0> Buffer;
+  raw_svector_ostream BufferOS(Buffer);
+  if (TmpFilesAsBitcode)
+    WriteBitcodeToFile(M, BufferOS);
+  else
+    M.print(BufferOS, /*AnnotationWriter=*/nullptr);
+  Lines = TmpFilesAsBitcode ? 0 : count(Buffer, '\n');
+
   // Write Module to tmp file
   int FD;
-  std::error_code EC =
-      sys::fs::createTemporaryFile("llvm-reduce", "ll", FD, CurrentFilepath);
+  SmallString<128> CurrentFilepath;
+  std::error_code EC = sys::fs::createTemporaryFile(
+      "llvm-reduce", TmpFilesAsBitcode ? "bc" : "ll", FD, CurrentFilepath);
   if (EC) {
     errs() << "Error making unique filename: " << EC.message() << "!\n";
     exit(1);
   }
 
   ToolOutputFile Out(CurrentFilepath, FD);
-  M.print(Out.os(), /*AnnotationWriter=*/nullptr);
+  Out.os() << Buffer;
   Out.os().close();
   if (Out.os().has_error()) {
     errs() << "Error emitting bitcode to file '" << CurrentFilepath << "'!\n";
@@ -43,16 +70,42 @@ bool IsReduced(Module &M, TestRunner &Test, SmallString<128> &CurrentFilepath) {
   return Test.run(CurrentFilepath);
 }
 
-/// Counts the amount of lines for a given file
-static int getLines(StringRef Filepath) {
+namespace {
+/// The outcome of testing one candidate in parallel mode.
+struct ChunkTestResult {
+  bool Interesting = false;
   int Lines = 0;
-  std::string CurrLine;
-  std::ifstream FileStream{std::string(Filepath)};
+  /// The reduced module, if it is interesting.
+  SmallString<0> Bitcode;
+};
+} // end anonymous namespace
 
-  while (std::getline(FileStream, CurrLine))
-    ++Lines;
+/// Keeps only the targets in \p ChunksToKeep of the module serialized in
+/// \p OriginalBC and runs the test on the result. The module is parsed into a
+/// context of its own so that several candidates can be tested at once.
+static void testChunksInNewContext(
+    StringRef OriginalBC, StringRef ModuleID,
+    const std::vector<Chunk> &ChunksToKeep,
+    TestRunner &Test,
+    const std::function<void(const std::vector<Chunk> &, Module *)>
+        &ExtractChunksFromModule,
+    ChunkTestResult &Result) {
+  LLVMContext Ctx;
+  Expected<std::unique_ptr<Module>> MOrErr =
+      parseBitcodeFile(MemoryBufferRef(OriginalBC, ModuleID), Ctx);
+  if (!MOrErr) {
+    errs() << "Error reading bitcode: " << toString(MOrErr.takeError())
+           << "\n";
+    exit(1);
+  }
+  std::unique_ptr<Module> Clone = std::move(*MOrErr);
+  ExtractChunksFromModule(ChunksToKeep, Clone.get());
 
-  return Lines;
+  Result.Interesting = IsReduced(*Clone, Test, Result.Lines);
+  if (Result.Interesting) {
+    raw_svector_ostream BCOS(Result.Bitcode);
+    WriteBitcodeToFile(*Clone, BCOS);
+  }
 }
 
 /// Splits Chunks in half and prints them.
@@ -98,8 +151,8 @@ void llvm::runDeltaPass(
   }
 
   if (Module *Program = Test.getProgram()) {
-    SmallString<128> CurrentFilepath;
-    if (!IsReduced(*Program, Test, CurrentFilepath)) {
+    int Lines;
+    if (!IsReduced(*Program, Test, Lines)) {
       errs() << "\nInput isn't interesting! Verify interesting-ness test\n";
       exit(1);
     }
@@ -114,40 +167,113 @@ void llvm::runDeltaPass(
     return;
   }
 
+  // In parallel mode every test starts from the bitcode of the program,
+  // which does not change during the pass.
+  SmallString<0> OriginalBC;
+  SmallString<0> ReducedBC;
+  std::string ModuleID = Test.getProgram()->getModuleIdentifier();
+  std::unique_ptr<ThreadPool> Pool;
+  if (NumJobs > 1) {
+    raw_svector_ostream BCOS(OriginalBC);
+    WriteBitcodeToFile(*Test.getProgram(), BCOS);
+    Pool = std::make_unique<ThreadPool>(hardware_concurrency(NumJobs));
+  }
+
+  // The chunks to keep when Chunks[I] is ignored as well, or an empty vector
+  // if there would be nothing left.
+  auto getChunksToKeep = [&](int I) {
+    std::vector<Chunk> CurrentChunks;
+    for (auto C : Chunks)
+      if (!UninterestingChunks.count(C) && C != Chunks[I])
+        CurrentChunks.push_back(C);
+    return CurrentChunks;
+  };
+
+  auto printIgnoring = [&](int I) {
+    errs() << "Ignoring: ";
+    Chunks[I].print();
+    for (auto C : UninterestingChunks)
+      C.print();
+  };
+
   do {
     UninterestingChunks = {};
-    for (int I = Chunks.size() - 1; I >= 0; --I) {
-      std::vector<Chunk> CurrentChunks;
+    if (!Pool) {
+      for (int I = Chunks.size() - 1; I >= 0; --I) {
+        std::vector<Chunk> CurrentChunks = getChunksToKeep(I);
+        if (CurrentChunks.empty())
+          continue;
 
-      for (auto C : Chunks)
-        if (!UninterestingChunks.count(C) && C != Chunks[I])
-          CurrentChunks.push_back(C);
+        // Clone module before hacking it up..
+        std::unique_ptr<Module> Clone = CloneModule(*Test.getProgram());
+        // Generate Module with only Targets inside Current Chunks
+        ExtractChunksFromModule(CurrentChunks, Clone.get());
 
-      if (CurrentChunks.empty())
-        continue;
+        printIgnoring(I);
 
-      // Clone module before hacking it up..
-      std::unique_ptr<Module> Clone = CloneModule(*Test.getProgram());
-      // Generate Module with only Targets inside Current Chunks
-      ExtractChunksFromModule(CurrentChunks, Clone.get());
+        int Lines;
+        if (!IsReduced(*Clone, Test, Lines)) {
+          errs() << "\n";
+          continue;
+        }
 
-      errs() << "Ignoring: ";
-      Chunks[I].print();
-      for (auto C : UninterestingChunks)
-        C.print();
+        UninterestingChunks.insert(Chunks[I]);
+        ReducedProgram = std::move(Clone);
+        errs() << " **** SUCCESS | lines: " << Lines << "\n";
+      }
+    } else {
+      // Test the next chunks speculatively, assuming that the tests still in
+      // flight will fail, which is what most of them do. Results are looked at
+      // in the order the serial loop would produce them. Once one succeeds,
+      // the tests after it were based on a stale set of chunks, so they are
+      // discarded and restarted, which keeps the result independent of -j.
+      struct PendingTest {
+        int Index;
+        std::shared_future<void> Done;
+        std::unique_ptr<ChunkTestResult> Result;
+      };
+      std::deque<PendingTest> InFlight;
+      int NextIndex = Chunks.size() - 1;
+      while (true) {
+        while (NextIndex >= 0 && InFlight.size() < NumJobs) {
+          int I = NextIndex--;
+          std::vector<Chunk> CurrentChunks = getChunksToKeep(I);
+          if (CurrentChunks.empty())
+            continue;
+          auto Result = std::make_unique<ChunkTestResult>();
+          ChunkTestResult *R = Result.get();
+          std::shared_future<void> Done = Pool->async(
+              [&OriginalBC, &ModuleID, &Test, &ExtractChunksFromModule, R,
+               CurrentChunks = std::move(CurrentChunks)] {
+                testChunksInNewContext(OriginalBC, ModuleID, CurrentChunks,
+                                       Test, ExtractChunksFromModule, *R);
+              });
+          InFlight.push_back({I, std::move(Done), std::move(Result)});
+        }
+        if (InFlight.empty())
+          break;
 
+        PendingTest T = std::move(InFlight.front());
+        InFlight.pop_front();
+        T.Done.wait();
 
+        printIgnoring(T.Index);
+        if (!T.Result->Interesting) {
+          errs() << "\n";
+          continue;
+        }
 
-      SmallString<128> CurrentFilepath;
-      if (!IsReduced(*Clone, Test, CurrentFilepath)) {
-        errs() << "\n";
-        continue;
-      }
+        UninterestingChunks.insert(Chunks[T.Index]);
+        ReducedBC = std::move(T.Result->Bitcode);
+        errs() << " **** SUCCESS | lines: " << T.Result->Lines << "\n";
 
-      UninterestingChunks.insert(Chunks[I]);
-      ReducedProgram = std::move(Clone);
-      errs() << " **** SUCCESS | lines: " << getLines(CurrentFilepath) << "\n";
+        for (PendingTest &Stale : InFlight)
+          Stale.Done.wait();
+        InFlight.clear();
+        NextIndex = T.Index - 1;
+      }
     }
+
     // Delete uninteresting chunks
     erase_if(Chunks, [&UninterestingChunks](const Chunk &C) {
       return UninterestingChunks.count(C);
@@ -155,6 +281,18 @@ void llvm::runDeltaPass(
 
   } while (!UninterestingChunks.empty() || increaseGranularity(Chunks));
 
+  if (!ReducedBC.empty()) {
+    Expected<std::unique_ptr<Module>> MOrErr =
+        parseBitcodeFile(MemoryBufferRef(ReducedBC, ModuleID),
+                         Test.getProgram()->getContext());
+    if (!MOrErr) {
+      errs() << "Error reading bitcode: " << toString(MOrErr.takeError())
+             << "\n";
+      exit(1);
+    }
+    ReducedProgram = std::move(*MOrErr);
+  }
+
   // If we reduced the testcase replace it
   if (ReducedProgram)
     Test.setProgram(std::move(ReducedProgram));
@@ -39,6 +39,10 @@ static cl::opt<bool>
     PreserveLocals("preserve-locals", cl::Prefix, cl::init(false),
                    cl::desc("Split without externalizing locals"));
 
+static cl::opt<bool> ClusterByAffinity(
+    "cluster-by-affinity", cl::Prefix, cl::init(false),
+    cl::desc("Keep functions that call each other in the same output file"));
+
 int main(int argc, char **argv) {
   LLVMContext Context;
   SMDiagnostic Err;
@@ -66,7 +70,7 @@ int main(int argc, char **argv) {
 
     // Declare success.
     Out->keep();
-  }, PreserveLocals);
+  }, PreserveLocals, ClusterByAffinity);
 
   return 0;
 }
@@ -141,6 +141,12 @@ static cl::opt<uint64_t>
     ClAdjustVMA("adjust-vma", cl::init(0), cl::value_desc("offset"),
                 cl::desc("Add specified offset to object file addresses"));
 
+static cl::opt<uint64_t> ClMaxCacheSize(
+    "max-cache-size", cl::init(0), cl::value_desc("bytes"),
+    cl::desc("Approximate maximum total size of the binaries to keep open. "
+             "The least recently used ones are closed first (default = no "
+             "limit)"));
+
 static cl::list<std::string> ClInputAddresses(cl::Positional,
                                               cl::desc("<input addresses>..."),
                                               cl::ZeroOrMore);
@@ -307,6 +313,7 @@ int main(int argc, char **argv) {
   Opts.FallbackDebugPath = ClFallbackDebugPath;
   Opts.DWPName = ClDwpName;
   Opts.DebugFileDirectory = ClDebugFileDirectory;
+  Opts.MaxCacheSize = ClMaxCacheSize;
   Opts.PathStyle = DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath;
   // If both --basenames and --relativenames are specified then pick the last
   // one.
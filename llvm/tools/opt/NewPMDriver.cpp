@@ -22,16 +22,20 @@
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/IRPrintingPasses.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LLVMRemarkStreamer.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Passes/PassPlugin.h"
 #include "llvm/Passes/StandardInstrumentations.h"
+#include "llvm/Support/CachePruning.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Telemetry.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO/FunctionCache.h"
 #include "llvm/Transforms/IPO/ThinLTOBitcodeWriter.h"
 #include "llvm/Transforms/Scalar/LoopPassManager.h"
 #include "llvm/Transforms/Utils/Debugify.h"
@@ -39,6 +43,11 @@
 using namespace llvm;
 using namespace opt_tool;
 
+#define DEBUG_TYPE "opt"
+
+TELEMETRY_COUNTER(NewPMPipelineTime,
+                  "Time spent running the new pass manager pipeline (ns)");
+
 static cl::opt<bool>
     DebugPM("debug-pass-manager", cl::Hidden,
             cl::desc("Print pass management debugging information"));
@@ -100,6 +109,15 @@ static cl::opt<std::string> OptimizerLastEPPipeline(
              "the OptimizerLast extension point into default pipelines"),
     cl::Hidden);
 
+static cl::opt<std::string> FunctionCacheDir(
+    "function-cache-dir",
+    cl::desc("Run the function pass pipeline given with -passes through a "
+             "cache of optimized function bodies in this directory"));
+static cl::opt<std::string> FunctionCachePolicy(
+    "function-cache-policy",
+    cl::desc("Pruning policy for the -function-cache-dir directory"),
+    cl::Hidden);
+
 extern cl::opt<PGOKind> PGOKindFlag;
 extern cl::opt<std::string> ProfileFile;
 extern cl::opt<CSPGOKind> CSPGOKindFlag;
@@ -206,8 +224,42 @@ static void registerEPCallbacks(PassBuilder &PB, bool VerifyEachPass,
   llvm::PassPluginLibraryInfo get##Ext##PluginInfo();
 #include "llvm/Support/Extension.def"
 
-bool llvm::runPassPipeline(StringRef Arg0, Module &M, TargetMachine *TM,
-                           ToolOutputFile *Out, ToolOutputFile *ThinLTOLinkOut,
+/// Appends to \p OS the options in \p Args, which is the command line, that
+/// may change how a function is optimized. That is every option but the ones
+/// that name the input and output files and the cache itself.
+static void appendOptionsToKey(raw_ostream &OS, ArrayRef<const char *> Args) {
+  StringMap<cl::Option *> &Options = cl::getRegisteredOptions();
+  bool NextIsValue = false, SkipValue = false;
+  for (StringRef Arg : Args.drop_front()) {
+    if (NextIsValue) {
+      NextIsValue = false;
+      if (!SkipValue)
+        OS << '\0' << Arg;
+      continue;
+    }
+    // Positional arguments are the input file.
+    if (!Arg.startswith("-") || Arg == "-")
+      continue;
+    StringRef Name, Value;
+    std::tie(Name, Value) = Arg.ltrim('-').split('=');
+    bool Skip = Name == "o" || Name == "thin-link-bitcode-file" ||
+                Name == "pass-remarks-output" ||
+                Name == FunctionCacheDir.ArgStr ||
+                Name == FunctionCachePolicy.ArgStr;
+    auto It = Options.find(Name);
+    if (!Arg.contains('=') && It != Options.end() &&
+        It->second->getValueExpectedFlag() == cl::ValueRequired) {
+      NextIsValue = true;
+      SkipValue = Skip;
+    }
+    if (!Skip)
+      OS << '\0' << Arg;
+  }
+}
+
+bool llvm::runPassPipeline(StringRef Arg0, ArrayRef<const char *> Args,
+                           Module &M, TargetMachine *TM, ToolOutputFile *Out,
+                           ToolOutputFile *ThinLTOLinkOut,
                            ToolOutputFile *OptRemarkFile,
                            StringRef PassPipeline, OutputKind OK,
                            VerifierKind VK,
@@ -323,8 +375,38 @@ bool llvm::runPassPipeline(StringRef Arg0, Module &M, TargetMachine *TM,
   if (EnableDebugify)
     MPM.addPass(NewPMDebugifyPass());
 
-  if (auto Err =
-          PB.parsePassPipeline(MPM, PassPipeline, VerifyEachPass, DebugPM)) {
+  Optional<CachePruningPolicy> CachePolicy;
+  if (!FunctionCacheDir.empty()) {
+    // Only a function pipeline can be cached function by function.
+    FunctionPassManager FPM(DebugPM);
+    if (auto Err =
+            PB.parsePassPipeline(FPM, PassPipeline, VerifyEachPass, DebugPM)) {
+      errs() << Arg0 << ": " << toString(std::move(Err)) << "\n";
+      return false;
+    }
+    Expected<CachePruningPolicy> Policy =
+        parseCachePruningPolicy(FunctionCachePolicy);
+    if (!Policy) {
+      errs() << Arg0 << ": " << toString(Policy.takeError()) << "\n";
+      return false;
+    }
+    CachePolicy = *Policy;
+
+    std::string Key;
+    raw_string_ostream KeyOS(Key);
+    KeyOS << LLVM_VERSION_STRING << '\0' << PassPipeline << '\0'
+          << AAPipeline;
+    if (TM)
+      KeyOS << '\0' << TM->getTargetTriple().str() << '\0'
+            << TM->getTargetCPU() << '\0' << TM->getTargetFeatureString()
+            << '\0' << unsigned(TM->getOptLevel());
+    // Options such as -vector-library or -disable-simplify-libcalls, and any
+    // cl::opt a pass reads, change the result as much as the pipeline does.
+    appendOptionsToKey(KeyOS, Args);
+    MPM.addPass(FunctionCachePass(std::move(FPM), FunctionCacheDir,
+                                  KeyOS.str()));
+  } else if (auto Err = PB.parsePassPipeline(MPM, PassPipeline, VerifyEachPass,
+                                             DebugPM)) {
     errs() << Arg0 << ": " << toString(std::move(Err)) << "\n";
     return false;
   }
@@ -356,7 +438,13 @@ bool llvm::runPassPipeline(StringRef Arg0, Module &M, TargetMachine *TM,
   cl::PrintOptionValues();
 
   // Now that we have all of the passes ready, run them.
-  MPM.run(M, MAM);
+  {
+    TelemetryTimeRegion TelemetryRegion(NewPMPipelineTime);
+    MPM.run(M, MAM);
+  }
+
+  if (CachePolicy)
+    pruneCache(FunctionCacheDir, *CachePolicy);
 
   // Declare success.
   if (OK != OK_NoOutput) {
@@ -365,8 +453,10 @@ bool llvm::runPassPipeline(StringRef Arg0, Module &M, TargetMachine *TM,
       ThinLTOLinkOut->keep();
   }
 
-  if (OptRemarkFile)
+  if (OptRemarkFile) {
+    finalizeLLVMOptimizationRemarks(M.getContext());
     OptRemarkFile->keep();
+  }
 
   return true;
 }
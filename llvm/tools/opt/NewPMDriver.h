@@ -20,6 +20,8 @@
 #ifndef LLVM_TOOLS_OPT_NEWPMDRIVER_H
 #define LLVM_TOOLS_OPT_NEWPMDRIVER_H
 
+#include "llvm/ADT/ArrayRef.h"
+
 namespace llvm {
 class StringRef;
 class LLVMContext;
@@ -56,9 +58,11 @@ enum CSPGOKind { NoCSPGO, CSInstrGen, CSInstrUse };
 /// when the transition finishes.
 ///
 /// ThinLTOLinkOut is only used when OK is OK_OutputThinLTOBitcode, and can be
-/// nullptr.
-bool runPassPipeline(StringRef Arg0, Module &M, TargetMachine *TM,
-                     ToolOutputFile *Out, ToolOutputFile *ThinLinkOut,
+/// nullptr. Args is the command line, which goes into the key of the
+/// -function-cache-dir cache.
+bool runPassPipeline(StringRef Arg0, ArrayRef<const char *> Args, Module &M,
+                     TargetMachine *TM, ToolOutputFile *Out,
+                     ToolOutputFile *ThinLinkOut,
                      ToolOutputFile *OptRemarkFile, StringRef PassPipeline,
                      opt_tool::OutputKind OK, opt_tool::VerifierKind VK,
                      bool ShouldPreserveAssemblyUseListOrder,
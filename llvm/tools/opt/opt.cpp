@@ -749,7 +749,8 @@ int main(int argc, char **argv) {
     // The user has asked to use the new pass manager and provided a pipeline
     // string. Hand off the rest of the functionality to the new code for that
     // layer.
-    return runPassPipeline(argv[0], *M, TM.get(), Out.get(), ThinLinkOut.get(),
+    return runPassPipeline(argv[0], ArrayRef<const char *>(argv, argc), *M,
+                           TM.get(), Out.get(), ThinLinkOut.get(),
                            RemarksFile.get(), PassPipeline, OK, VK,
                            PreserveAssemblyUseListOrder,
                            PreserveBitcodeUseListOrder, EmitSummaryIndex,
@@ -1000,8 +1001,10 @@ int main(int argc, char **argv) {
         Out->os() << BOS->str();
         Out->keep();
       }
-      if (RemarksFile)
+      if (RemarksFile) {
+        finalizeLLVMOptimizationRemarks(Context);
         RemarksFile->keep();
+      }
       return 1;
     }
     if (ShouldEmitOutput)
@@ -1015,8 +1018,10 @@ int main(int argc, char **argv) {
   if (!NoOutput || PrintBreakpoints)
     Out->keep();
 
-  if (RemarksFile)
+  if (RemarksFile) {
+    finalizeLLVMOptimizationRemarks(Context);
     RemarksFile->keep();
+  }
 
   if (ThinLinkOut)
     ThinLinkOut->keep();
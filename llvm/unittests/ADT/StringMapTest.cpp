@@ -12,6 +12,7 @@
 #include "gtest/gtest.h"
 #include <limits>
 #include <tuple>
+#include <vector>
 using namespace llvm;
 
 namespace {
@@ -508,6 +509,50 @@ TEST(StringMapCustomTest, EmplaceTest) {
   EXPECT_EQ(42, Map["abcd"].Data);
 }
 
+TEST(StringMapCustomTest, PrecomputedHash) {
+  StringMap<int> Map;
+  std::string LongKey(100, 'x');
+  for (StringRef Key : {StringRef("abcd"), StringRef(LongKey)}) {
+    uint32_t Hash = StringMapImpl::hash(Key);
+    EXPECT_TRUE(Map.try_emplace_with_hash(Key, Hash, 42).second);
+    EXPECT_FALSE(Map.try_emplace_with_hash(Key, Hash, 43).second);
+    EXPECT_EQ(1u, Map.count(Key, Hash));
+    EXPECT_EQ(Map.find(Key), Map.find(Key, Hash));
+    EXPECT_EQ(42, Map.find(Key, Hash)->second);
+  }
+  EXPECT_EQ(2u, Map.size());
+  EXPECT_EQ(0u, Map.count("efgh", StringMapImpl::hash("efgh")));
+}
+
+TEST(StringMapCustomTest, Reserve) {
+  StringMap<int> Map;
+  Map["a"] = 1;
+  Map.reserve(100);
+  unsigned NumBuckets = Map.getNumBuckets();
+  for (int I = 0; I < 99; ++I)
+    Map[Twine(I).str()] = I;
+  EXPECT_EQ(NumBuckets, Map.getNumBuckets());
+  EXPECT_EQ(1, Map.lookup("a"));
+  EXPECT_EQ(42, Map.lookup("42"));
+
+  // Reserving less than what is there does not shrink the table.
+  Map.reserve(1);
+  EXPECT_EQ(NumBuckets, Map.getNumBuckets());
+}
+
+TEST(StringMapCustomTest, InsertRange) {
+  std::vector<std::pair<std::string, int>> Entries;
+  for (int I = 0; I < 100; ++I)
+    Entries.emplace_back(Twine(I).str(), I);
+  StringMap<int> Map;
+  Map["0"] = -1;
+  Map.insert(Entries.begin(), Entries.end());
+  EXPECT_EQ(100u, Map.size());
+  // Existing entries are not overwritten.
+  EXPECT_EQ(-1, Map.lookup("0"));
+  EXPECT_EQ(99, Map.lookup("99"));
+}
+
 // Test that StringMapEntryBase can handle size_t wide sizes.
 TEST(StringMapCustomTest, StringMapEntryBaseSize) {
   size_t LargeValue;
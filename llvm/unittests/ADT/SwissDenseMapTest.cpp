@@ -0,0 +1,241 @@
+//===- llvm/unittest/ADT/SwissDenseMapTest.cpp - SwissDenseMap tests ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/SwissDenseMap.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+
+using namespace llvm;
+
+namespace {
+
+/// Checks that every constructed object is destroyed exactly once.
+class CtorTester {
+  static std::set<CtorTester *> Constructed;
+  int Value;
+
+public:
+  explicit CtorTester(int Value = 0) : Value(Value) {
+    EXPECT_TRUE(Constructed.insert(this).second);
+  }
+  CtorTester(const CtorTester &Arg) : Value(Arg.Value) {
+    EXPECT_TRUE(Constructed.insert(this).second);
+  }
+  CtorTester &operator=(const CtorTester &) = default;
+  ~CtorTester() { EXPECT_EQ(1u, Constructed.erase(this)); }
+
+  int getValue() const { return Value; }
+  bool operator==(const CtorTester &RHS) const { return Value == RHS.Value; }
+
+  static size_t getNumConstructed() { return Constructed.size(); }
+};
+
+std::set<CtorTester *> CtorTester::Constructed;
+
+struct CtorTesterMapInfo {
+  static unsigned getHashValue(const CtorTester &Val) {
+    return Val.getValue() * 37u;
+  }
+  static bool isEqual(const CtorTester &LHS, const CtorTester &RHS) {
+    return LHS == RHS;
+  }
+};
+
+/// A hash that puts every key into the same group.
+struct CollidingMapInfo {
+  static unsigned getHashValue(unsigned) { return 0; }
+  static bool isEqual(unsigned LHS, unsigned RHS) { return LHS == RHS; }
+};
+
+TEST(SwissDenseMapTest, EmptyMap) {
+  SwissDenseMap<unsigned, unsigned> Map;
+  EXPECT_TRUE(Map.empty());
+  EXPECT_EQ(0u, Map.size());
+  EXPECT_TRUE(Map.begin() == Map.end());
+  EXPECT_EQ(0u, Map.count(1));
+  EXPECT_TRUE(Map.find(1) == Map.end());
+  EXPECT_EQ(0u, Map.lookup(1));
+  EXPECT_FALSE(Map.erase(1));
+  EXPECT_EQ(0u, Map.getMemorySize());
+  Map.clear();
+  EXPECT_TRUE(Map.empty());
+}
+
+TEST(SwissDenseMapTest, InsertFindErase) {
+  SwissDenseMap<unsigned, unsigned> Map;
+  EXPECT_TRUE(Map.insert({1, 10}).second);
+  EXPECT_FALSE(Map.insert({1, 20}).second);
+  EXPECT_EQ(10u, Map.lookup(1));
+  EXPECT_EQ(1u, Map.size());
+
+  Map[2] = 20;
+  EXPECT_EQ(20u, Map[2]);
+  EXPECT_EQ(2u, Map.size());
+
+  auto It = Map.find(2);
+  ASSERT_TRUE(It != Map.end());
+  EXPECT_EQ(2u, It->first);
+  EXPECT_EQ(20u, It->second);
+
+  Map.erase(It);
+  EXPECT_EQ(0u, Map.count(2));
+  EXPECT_TRUE(Map.erase(1));
+  EXPECT_FALSE(Map.erase(1));
+  EXPECT_TRUE(Map.empty());
+}
+
+TEST(SwissDenseMapTest, DenseMapSpecialKeys) {
+  // The empty and tombstone keys of DenseMapInfo are ordinary keys here.
+  SwissDenseMap<unsigned, unsigned> Map;
+  const unsigned EmptyKey = DenseMapInfo<unsigned>::getEmptyKey();
+  const unsigned TombstoneKey = DenseMapInfo<unsigned>::getTombstoneKey();
+  Map[EmptyKey] = 1;
+  Map[TombstoneKey] = 2;
+  EXPECT_EQ(1u, Map.lookup(EmptyKey));
+  EXPECT_EQ(2u, Map.lookup(TombstoneKey));
+  EXPECT_EQ(2u, Map.size());
+}
+
+TEST(SwissDenseMapTest, Iteration) {
+  SwissDenseMap<unsigned, unsigned> Map;
+  for (unsigned I = 0; I < 100; ++I)
+    Map[I] = I * 2;
+
+  std::set<unsigned> Seen;
+  for (const auto &KV : Map) {
+    EXPECT_EQ(KV.first * 2, KV.second);
+    EXPECT_TRUE(Seen.insert(KV.first).second);
+  }
+  EXPECT_EQ(100u, Seen.size());
+
+  const auto &ConstMap = Map;
+  SwissDenseMap<unsigned, unsigned>::const_iterator CIt = Map.begin();
+  EXPECT_TRUE(CIt == ConstMap.begin());
+  EXPECT_EQ(100, std::distance(ConstMap.begin(), ConstMap.end()));
+}
+
+TEST(SwissDenseMapTest, CopyAndMove) {
+  SwissDenseMap<unsigned, std::string> Map;
+  for (unsigned I = 0; I < 50; ++I)
+    Map[I] = std::to_string(I);
+  Map.erase(7);
+
+  SwissDenseMap<unsigned, std::string> Copy(Map);
+  EXPECT_EQ(49u, Copy.size());
+  EXPECT_EQ("42", Copy.lookup(42));
+  EXPECT_EQ(0u, Copy.count(7));
+
+  SwissDenseMap<unsigned, std::string> Moved(std::move(Copy));
+  EXPECT_EQ(49u, Moved.size());
+  EXPECT_TRUE(Copy.empty());
+
+  SwissDenseMap<unsigned, std::string> Assigned;
+  Assigned[1000] = "x";
+  Assigned = Moved;
+  EXPECT_EQ(49u, Assigned.size());
+  EXPECT_EQ(0u, Assigned.count(1000));
+
+  Assigned = std::move(Moved);
+  EXPECT_EQ(49u, Assigned.size());
+
+  SwissDenseMap<unsigned, std::string> Other = {{1, "one"}};
+  Other.swap(Assigned);
+  EXPECT_EQ(49u, Other.size());
+  EXPECT_EQ("one", Assigned.lookup(1));
+}
+
+TEST(SwissDenseMapTest, MoveOnlyValues) {
+  SwissDenseMap<unsigned, std::unique_ptr<int>> Map;
+  for (unsigned I = 0; I < 100; ++I)
+    Map.try_emplace(I, std::make_unique<int>(I));
+  for (unsigned I = 0; I < 100; ++I)
+    EXPECT_EQ(static_cast<int>(I), *Map.find(I)->second);
+}
+
+TEST(SwissDenseMapTest, ConstructionAndDestruction) {
+  {
+    SwissDenseMap<CtorTester, CtorTester, CtorTesterMapInfo> Map;
+    for (int I = 0; I < 200; ++I)
+      Map.try_emplace(CtorTester(I), I + 1);
+    for (int I = 0; I < 200; I += 3)
+      Map.erase(CtorTester(I));
+    EXPECT_EQ(2 * Map.size(), CtorTester::getNumConstructed());
+
+    SwissDenseMap<CtorTester, CtorTester, CtorTesterMapInfo> Copy(Map);
+    EXPECT_EQ(4 * Map.size(), CtorTester::getNumConstructed());
+    Copy.clear();
+    EXPECT_EQ(2 * Map.size(), CtorTester::getNumConstructed());
+  }
+  EXPECT_EQ(0u, CtorTester::getNumConstructed());
+}
+
+TEST(SwissDenseMapTest, Reserve) {
+  SwissDenseMap<unsigned, unsigned> Map;
+  Map.reserve(1000);
+  size_t MemorySize = Map.getMemorySize();
+  for (unsigned I = 0; I < 1000; ++I)
+    Map[I] = I;
+  EXPECT_EQ(MemorySize, Map.getMemorySize());
+}
+
+TEST(SwissDenseMapTest, Collisions) {
+  // All keys share their first group and their control byte, so lookups and
+  // erasure have to probe the other groups.
+  SwissDenseMap<unsigned, unsigned, CollidingMapInfo> Map;
+  for (unsigned I = 0; I < 100; ++I)
+    Map[I] = I;
+  for (unsigned I = 0; I < 100; I += 2)
+    EXPECT_TRUE(Map.erase(I));
+  for (unsigned I = 0; I < 100; ++I)
+    EXPECT_EQ(I % 2, Map.count(I)) << I;
+  for (unsigned I = 0; I < 100; I += 2)
+    Map[I] = I;
+  EXPECT_EQ(100u, Map.size());
+}
+
+TEST(SwissDenseMapTest, RandomOperations) {
+  // Compare against std::map over a mix of operations that keeps the map at
+  // about the same size, so that erased buckets get reused and cleaned up.
+  std::mt19937 Rng(42);
+  std::uniform_int_distribution<unsigned> KeyDist(0, 2000);
+  SwissDenseMap<unsigned, unsigned> Map;
+  std::map<unsigned, unsigned> Expected;
+  for (unsigned Step = 0; Step < 100000; ++Step) {
+    unsigned Key = KeyDist(Rng);
+    switch (Rng() % 3) {
+    case 0:
+      Map[Key] = Step;
+      Expected[Key] = Step;
+      break;
+    case 1:
+      EXPECT_EQ(Expected.erase(Key) == 1, Map.erase(Key));
+      break;
+    case 2:
+      EXPECT_EQ(Expected.count(Key), Map.count(Key));
+      break;
+    }
+  }
+  ASSERT_EQ(Expected.size(), Map.size());
+  for (const auto &KV : Expected)
+    EXPECT_EQ(KV.second, Map.lookup(KV.first));
+}
+
+TEST(SwissDenseMapTest, PointerKeys) {
+  int Values[64];
+  SwissDenseMap<int *, int> Map;
+  for (int I = 0; I < 64; ++I)
+    Map[&Values[I]] = I;
+  for (int I = 0; I < 64; ++I)
+    EXPECT_EQ(I, Map.lookup(&Values[I]));
+  EXPECT_EQ(0u, Map.count(nullptr));
+}
+
+} // end anonymous namespace
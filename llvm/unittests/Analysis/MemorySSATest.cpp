@@ -821,6 +821,36 @@ TEST_F(MemorySSATest, WalkerReopt) {
   EXPECT_EQ(NewLoadAccess->getDefiningAccess(), LoadClobber);
 }
 
+// Test that a walk with a limited budget stops at a conservative clobber.
+TEST_F(MemorySSATest, WalkerStepLimit) {
+  F = Function::Create(FunctionType::get(B.getVoidTy(), {}, false),
+                       GlobalValue::ExternalLinkage, "F", &M);
+  B.SetInsertPoint(BasicBlock::Create(C, "", F));
+  Type *Int8 = Type::getInt8Ty(C);
+  Value *AllocaA = B.CreateAlloca(Int8, ConstantInt::get(Int8, 1), "A");
+  Value *AllocaB = B.CreateAlloca(Int8, ConstantInt::get(Int8, 1), "B");
+  Instruction *SIA = B.CreateStore(ConstantInt::get(Int8, 0), AllocaA);
+  Instruction *SIB1 = B.CreateStore(ConstantInt::get(Int8, 1), AllocaB);
+  Instruction *SIB2 = B.CreateStore(ConstantInt::get(Int8, 2), AllocaB);
+
+  setupAnalyses();
+  MemorySSA &MSSA = *Analyses->MSSA;
+  MemorySSAWalker *Walker = Analyses->Walker;
+
+  MemoryAccess *Start = MSSA.getMemoryAccess(SIB2);
+  MemoryLocation LocA(AllocaA, LocationSize::precise(1));
+
+  unsigned Limit = 100;
+  EXPECT_EQ(Walker->getClobberingMemoryAccess(Start, LocA, Limit),
+            MSSA.getMemoryAccess(SIA));
+  EXPECT_EQ(Limit, 97u);
+
+  Limit = 2;
+  EXPECT_EQ(Walker->getClobberingMemoryAccess(Start, LocA, Limit),
+            MSSA.getMemoryAccess(SIB1));
+  EXPECT_EQ(Limit, 0u);
+}
+
 // Test out MemorySSAUpdater::moveBefore
 TEST_F(MemorySSATest, MoveAboveMemoryDef) {
   F = Function::Create(FunctionType::get(B.getVoidTy(), {}, false),
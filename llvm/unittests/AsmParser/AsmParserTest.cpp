@@ -11,8 +11,12 @@
 #include "llvm/AsmParser/SlotMapping.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -414,4 +418,137 @@ TEST(AsmParserTest, TypeAtBeginningWithSlotMappingParsing) {
   ASSERT_TRUE(Read == 4);
 }
 
+static std::unique_ptr<Module> parseLazily(StringRef Source, LLVMContext &Ctx,
+                                           SMDiagnostic &Error) {
+  return parseAssemblyLazily(MemoryBuffer::getMemBufferCopy(Source), Error,
+                             Ctx);
+}
+
+TEST(AsmParserTest, LazyFunctionBodies) {
+  LLVMContext Ctx;
+  StringRef Source = R"(
+    @str = constant [2 x i8] c"}\00"
+    @addr = global i8* blockaddress(@g, %target)
+
+    define i32 @f(i32 %x) !dbg !0 {
+      ; A comment with a {
+      %"a}" = add i32 %x, 1
+      %s = insertvalue { i32, i32 } undef, i32 %"a}", 0
+      %r = call i32 @llvm.ctlz.i32(i32 %"a}")
+      ret i32 %r
+    }
+
+    define void @g() {
+      br label %target
+    target:
+      ret void
+    }
+
+    define void @h() {
+      ret i32 0
+    }
+
+    declare i32 @llvm.ctlz.i32(i32)
+
+    !0 = !{}
+  )";
+  SMDiagnostic Error;
+  auto Mod = parseLazily(Source, Ctx, Error);
+  ASSERT_TRUE(Mod != nullptr) << Error.getMessage();
+
+  // The body of @g is needed to resolve the blockaddress.
+  Function *F = Mod->getFunction("f");
+  Function *G = Mod->getFunction("g");
+  Function *H = Mod->getFunction("h");
+  EXPECT_TRUE(F->isMaterializable());
+  EXPECT_FALSE(F->hasMetadata());
+  EXPECT_FALSE(G->isMaterializable());
+  EXPECT_FALSE(G->empty());
+  EXPECT_TRUE(H->isMaterializable());
+  EXPECT_FALSE(verifyModule(*Mod, &errs()));
+
+  ASSERT_FALSE(errorToBool(F->materialize()));
+  EXPECT_FALSE(F->isMaterializable());
+  EXPECT_TRUE(F->getMetadata(LLVMContext::MD_dbg));
+  ASSERT_EQ(F->getEntryBlock().size(), 4u);
+  // The call was upgraded to the two-argument form of the intrinsic.
+  auto *Call = cast<CallInst>(F->getEntryBlock().getTerminator()
+                                  ->getPrevNode());
+  EXPECT_EQ(Call->getNumArgOperands(), 2u);
+
+  // The error in @h is only found when it is parsed.
+  auto Err = H->materialize();
+  ASSERT_TRUE(bool(Err));
+  EXPECT_NE(toString(std::move(Err)).find("value doesn't match function "
+                                          "result type 'void'"),
+            std::string::npos);
+}
+
+TEST(AsmParserTest, LazyFunctionBodiesMaterializeAll) {
+  LLVMContext Ctx;
+  StringRef Source = R"(
+    define i32 @f(i32 %x) {
+      %r = call i32 @llvm.ctlz.i32(i32 %x) #0
+      ret i32 %r
+    }
+
+    declare i32 @llvm.ctlz.i32(i32)
+
+    attributes #0 = { nounwind }
+  )";
+  SMDiagnostic Error;
+  auto Mod = parseLazily(Source, Ctx, Error);
+  ASSERT_TRUE(Mod != nullptr) << Error.getMessage();
+
+  ASSERT_FALSE(errorToBool(Mod->materializeAll()));
+  EXPECT_FALSE(Mod->getFunction("f")->isMaterializable());
+  // The old declaration is gone once no body can refer to it.
+  EXPECT_EQ(Mod->getFunction("llvm.ctlz.i32")->arg_size(), 2u);
+  EXPECT_FALSE(verifyModule(*Mod, &errs()));
+
+  const Instruction &Call = Mod->getFunction("f")->getEntryBlock().front();
+  EXPECT_TRUE(cast<CallInst>(Call).hasFnAttr(Attribute::NoUnwind));
+}
+
+TEST(AsmParserTest, LazyFunctionBodiesWithUseListOrder) {
+  LLVMContext Ctx;
+  StringRef Source = R"(
+    @g = global i32 0
+
+    define i32 @f() {
+      %a = load i32, i32* @g
+      ret i32 %a
+    }
+
+    define i32 @f2() {
+      %a = load i32, i32* @g
+      ret i32 %a
+    }
+
+    uselistorder i32* @g, { 1, 0 }
+  )";
+  SMDiagnostic Error;
+  auto Mod = parseLazily(Source, Ctx, Error);
+  ASSERT_TRUE(Mod != nullptr) << Error.getMessage();
+  EXPECT_FALSE(Mod->getFunction("f")->isMaterializable());
+  EXPECT_FALSE(Mod->getFunction("f")->empty());
+
+  Source = R"(
+    define void @f(i32 %x) {
+      %a = add i32 %x, 1
+      %b = add i32 %x, 2
+      ret void
+      uselistorder i32 %x, { 1, 0 }
+    }
+
+    define void @g() {
+      ret void
+    }
+  )";
+  Mod = parseLazily(Source, Ctx, Error);
+  ASSERT_TRUE(Mod != nullptr) << Error.getMessage();
+  EXPECT_FALSE(Mod->getFunction("f")->isMaterializable());
+  EXPECT_FALSE(Mod->getFunction("g")->isMaterializable());
+}
+
 } // end anonymous namespace
@@ -1927,6 +1927,86 @@ TEST(DWARFDebugInfo, TestDwarfVerifyInvalidCURef) {
                              "0x0000001a):");
 }
 
+TEST(DWARFDebugInfo, TestDwarfVerifyThreadSafeContext) {
+  // Create two compile units with an invalid CU relative DW_AT_type each, and
+  // check that verifying them in parallel reports the same errors in the same
+  // order as verifying them serially.
+  const char *yamldata = R"(
+    debug_str:
+      - ''
+      - /tmp/main.c
+      - main
+    debug_abbrev:
+      - Code:            0x00000001
+        Tag:             DW_TAG_compile_unit
+        Children:        DW_CHILDREN_yes
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+      - Code:            0x00000002
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_no
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_strp
+          - Attribute:       DW_AT_type
+            Form:            DW_FORM_ref4
+    debug_info:
+      - Length:
+          TotalLength:     22
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000000001
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x000000000000000D
+              - Value:           0x0000000000001234
+          - AbbrCode:        0x00000000
+            Values:
+      - Length:
+          TotalLength:     22
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000000001
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x000000000000000D
+              - Value:           0x0000000000002345
+          - AbbrCode:        0x00000000
+            Values:
+  )";
+  auto ErrOrSections = DWARFYAML::EmitDebugSections(StringRef(yamldata));
+  ASSERT_TRUE((bool)ErrOrSections);
+
+  std::unique_ptr<DWARFContext> SerialContext =
+      DWARFContext::create(*ErrOrSections, 8);
+  std::string SerialOutput;
+  raw_string_ostream SerialStrm(SerialOutput);
+  EXPECT_FALSE(SerialContext->verify(SerialStrm));
+
+  std::unique_ptr<DWARFContext> ParallelContext =
+      DWARFContext::create(*ErrOrSections, 8);
+  ParallelContext->setThreadSafe();
+  std::string ParallelOutput;
+  raw_string_ostream ParallelStrm(ParallelOutput);
+  EXPECT_FALSE(ParallelContext->verify(ParallelStrm));
+
+  EXPECT_EQ(SerialStrm.str(), ParallelStrm.str());
+  size_t First = ParallelOutput.find("CU offset 0x00001234");
+  size_t Second = ParallelOutput.find("CU offset 0x00002345");
+  ASSERT_NE(std::string::npos, First);
+  ASSERT_NE(std::string::npos, Second);
+  EXPECT_LT(First, Second);
+}
+
 TEST(DWARFDebugInfo, TestDwarfVerifyInvalidRefAddr) {
   // Create a single compile unit with a single function that has an invalid
   // DW_AT_type with an invalid .debug_info offset in its DW_FORM_ref_addr.
@@ -9,8 +9,10 @@
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/ObjectYAML/DWARFEmitter.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
+#include <atomic>
 
 using namespace llvm;
 using namespace llvm::dwarf;
@@ -115,4 +117,94 @@ TEST(DWARFDie, getLocations) {
                                               "No DW_AT_call_data_value")));
 }
 
+TEST(DWARFDie, ThreadSafeQueries) {
+  const char *yamldata = R"(
+    debug_abbrev:
+      - Code:            0x00000001
+        Tag:             DW_TAG_compile_unit
+        Children:        DW_CHILDREN_yes
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_string
+      - Code:            0x00000002
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_no
+        Attributes:
+          - Attribute:       DW_AT_name
+            Form:            DW_FORM_string
+          - Attribute:       DW_AT_low_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_high_pc
+            Form:            DW_FORM_data4
+    debug_info:
+      - Length:
+          TotalLength:     0
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - CStr:            a.c
+          - AbbrCode:        0x00000002
+            Values:
+              - CStr:            f
+              - Value:           0x0000000000001000
+              - Value:           0x0000000000000010
+          - AbbrCode:        0x00000000
+            Values:
+      - Length:
+          TotalLength:     0
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - CStr:            b.c
+          - AbbrCode:        0x00000002
+            Values:
+              - CStr:            g
+              - Value:           0x0000000000002000
+              - Value:           0x0000000000000010
+          - AbbrCode:        0x00000000
+            Values:
+  )";
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::EmitDebugSections(StringRef(yamldata), /*ApplyFixups=*/true,
+                                   /*IsLittleEndian=*/true);
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+  std::unique_ptr<DWARFContext> Ctx =
+      DWARFContext::create(*Sections, 8, /*isLittleEndian=*/true);
+  Ctx->setThreadSafe();
+
+  // Start all queries on a fresh context, so that the threads race to parse
+  // the units and to extract their DIEs.
+  std::atomic<unsigned> Failures(0);
+  {
+    ThreadPool Pool;
+    for (unsigned I = 0; I != 16; ++I)
+      Pool.async([&, I] {
+        uint64_t Address = I % 2 ? 0x2008 : 0x1008;
+        const char *SubprogramName = I % 2 ? "g" : "f";
+        const char *UnitName = I % 2 ? "b.c" : "a.c";
+        if (Ctx->getNumCompileUnits() != 2) {
+          ++Failures;
+          return;
+        }
+        DWARFUnit *CU = Ctx->getUnitAtIndex(I % 2);
+        DWARFDie Subprogram = CU->getSubroutineForAddress(Address);
+        DWARFDie UnitDIE = CU->getUnitDIE(/*ExtractUnitDIEOnly=*/false);
+        if (!Subprogram.isValid() ||
+            StringRef(Subprogram.getName(DINameKind::ShortName)) !=
+                SubprogramName ||
+            StringRef(UnitDIE.getName(DINameKind::ShortName)) != UnitName ||
+            Subprogram.getParent() != UnitDIE)
+          ++Failures;
+      });
+    Pool.wait();
+  }
+  EXPECT_EQ(0u, Failures);
+}
+
 } // end anonymous namespace
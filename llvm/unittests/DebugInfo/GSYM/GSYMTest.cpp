@@ -1148,6 +1148,45 @@ static void TestEncodeDecode(const GsymCreator &GC,
   Compare(GC, GR.get());
 }
 
+TEST(GSYMTest, TestGsymCreatorRemoveDuplicates) {
+  GsymCreator GC;
+  const uint32_t Func1Name = GC.insertString("foo");
+  const uint32_t Func2Name = GC.insertString("bar");
+  const uint32_t Func3Name = GC.insertString("baz");
+  // Many exact duplicates of the same symbol.
+  constexpr uint32_t NumDups = 1000;
+  for (uint32_t I = 0; I < NumDups; ++I)
+    GC.addFunctionInfo(FunctionInfo(0x1000, 0x10, Func1Name));
+  // A symbol table entry and a debug info entry for the same range.
+  FunctionInfo FIWithLines(0x2000, 0x10, Func2Name);
+  FIWithLines.OptLineTable = LineTable();
+  FIWithLines.OptLineTable->push(LineEntry(0x2000, 1, 5));
+  GC.addFunctionInfo(FunctionInfo(0x2000, 0x10, Func2Name));
+  GC.addFunctionInfo(FunctionInfo(FIWithLines));
+  // A zero sized symbol that is contained in the next function.
+  GC.addFunctionInfo(FunctionInfo(0x3000, 0, Func3Name));
+  GC.addFunctionInfo(FunctionInfo(0x3000, 0x10, Func3Name));
+  ASSERT_EQ(GC.getNumFunctionInfos(), NumDups + 4);
+  std::string Warnings;
+  raw_string_ostream OS(Warnings);
+  Error Err = GC.finalize(OS);
+  ASSERT_FALSE(Err);
+  ASSERT_EQ(GC.getNumFunctionInfos(), 3u);
+  std::vector<FunctionInfo> Funcs;
+  GC.forEachFunctionInfo([&](FunctionInfo &FI) {
+    Funcs.push_back(FI);
+    return true;
+  });
+  ASSERT_EQ(Funcs.size(), 3u);
+  EXPECT_EQ(Funcs[0], FunctionInfo(0x1000, 0x10, Func1Name));
+  EXPECT_EQ(Funcs[1], FIWithLines);
+  EXPECT_EQ(Funcs[2], FunctionInfo(0x3000, 0x10, Func3Name));
+  OS.flush();
+  EXPECT_NE(Warnings.find("duplicate function info entries"),
+            std::string::npos);
+  EXPECT_NE(Warnings.find("removing symbol"), std::string::npos);
+}
+
 TEST(GSYMTest, TestGsymCreator1ByteAddrOffsets) {
   uint8_t UUID[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
   GsymCreator GC;
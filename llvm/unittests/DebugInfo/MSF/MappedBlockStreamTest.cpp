@@ -62,11 +62,16 @@ public:
   }
   Error commit() override { return Error::success(); }
 
+  void dontNeed(uint32_t Offset, uint32_t Size) override {
+    DontNeedRanges.emplace_back(Offset, Size);
+  }
+
   MSFStreamLayout layout() const {
     return MSFStreamLayout{static_cast<uint32_t>(Data.size()), Blocks};
   }
 
   BumpPtrAllocator Allocator;
+  std::vector<std::pair<uint32_t, uint32_t>> DontNeedRanges;
 
 private:
   std::vector<support::ulittle32_t> Blocks;
@@ -499,6 +504,28 @@ MATCHER_P3(BlockIsFilledWith, Layout, BlockIndex, Byte, "succeeded") {
 }
 
 namespace {
+TEST(MappedBlockStreamTest, DontNeedCoalescesContiguousBlocks) {
+  std::vector<uint8_t> DataBytes(10);
+  DiscontiguousStream F(BlocksAry, DataBytes);
+  auto S = WritableMappedBlockStream::createStream(F.block_size(), F.layout(),
+                                                   F, F.Allocator);
+
+  using Range = std::pair<uint32_t, uint32_t>;
+  S->dontNeed(0, S->getLength());
+  EXPECT_THAT(F.DontNeedRanges,
+              testing::ElementsAre(Range(0, 3), Range(5, 1), Range(4, 1),
+                                   Range(3, 1), Range(6, 4)));
+
+  F.DontNeedRanges.clear();
+  S->dontNeed(1, 4);
+  EXPECT_THAT(F.DontNeedRanges,
+              testing::ElementsAre(Range(1, 2), Range(5, 1), Range(4, 1)));
+
+  F.DontNeedRanges.clear();
+  S->dontNeed(8, 100);
+  EXPECT_THAT(F.DontNeedRanges, testing::ElementsAre(Range(8, 2)));
+}
+
 TEST(MappedBlockStreamTest, CreateFpmStream) {
   BumpPtrAllocator Allocator;
   SuperBlock SB;
@@ -0,0 +1,240 @@
+//===- NativeAddressLookupTest.cpp ----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/PDB/PDB.h"
+
+#include "llvm/DebugInfo/CodeView/DebugChecksumsSubsection.h"
+#include "llvm/DebugInfo/CodeView/DebugLinesSubsection.h"
+#include "llvm/DebugInfo/CodeView/DebugStringTableSubsection.h"
+#include "llvm/DebugInfo/CodeView/SymbolRecord.h"
+#include "llvm/DebugInfo/CodeView/SymbolSerializer.h"
+#include "llvm/DebugInfo/MSF/MSFBuilder.h"
+#include "llvm/DebugInfo/PDB/IPDBLineNumber.h"
+#include "llvm/DebugInfo/PDB/IPDBSession.h"
+#include "llvm/DebugInfo/PDB/IPDBSourceFile.h"
+#include "llvm/DebugInfo/PDB/Native/DbiModuleDescriptorBuilder.h"
+#include "llvm/DebugInfo/PDB/Native/DbiStreamBuilder.h"
+#include "llvm/DebugInfo/PDB/Native/InfoStreamBuilder.h"
+#include "llvm/DebugInfo/PDB/Native/PDBFileBuilder.h"
+#include "llvm/DebugInfo/PDB/Native/PDBStringTableBuilder.h"
+#include "llvm/DebugInfo/PDB/Native/RawConstants.h"
+#include "llvm/DebugInfo/PDB/Native/RawTypes.h"
+#include "llvm/DebugInfo/PDB/Native/TpiStreamBuilder.h"
+#include "llvm/DebugInfo/PDB/PDBSymbolCompiland.h"
+#include "llvm/DebugInfo/PDB/PDBSymbolFunc.h"
+#include "llvm/Object/COFF.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+
+#include "llvm/Testing/Support/Error.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::codeview;
+using namespace llvm::pdb;
+
+namespace {
+
+// The image has a single .text section at RVA 0x1000. Function foo covers
+// .text+0x10 to .text+0x30, with line 10 at its start and line 11 at
+// .text+0x18.
+const uint64_t LoadAddress = 0x140000000;
+const uint32_t TextRVA = 0x1000;
+const uint32_t FooOffset = 0x10;
+const uint32_t FooSize = 0x20;
+const uint32_t Line11Offset = 0x18;
+
+class NativeAddressLookupTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(
+        sys::fs::createTemporaryFile("address-lookup", "pdb", PdbPath));
+    Remover.setFile(PdbPath);
+    ASSERT_THAT_ERROR(writePdb(), Succeeded());
+    ASSERT_THAT_ERROR(
+        loadDataForPDB(PDB_ReaderType::Native, PdbPath, Session), Succeeded());
+    ASSERT_TRUE(Session->setLoadAddress(LoadAddress));
+  }
+
+  Error writePdb() {
+    BumpPtrAllocator Allocator;
+    PDBFileBuilder Builder(Allocator);
+    if (Error E = Builder.initialize(4096))
+      return E;
+    for (uint32_t I = 0; I < kSpecialStreamCount; ++I)
+      if (Error E = Builder.getMsfBuilder().addStream(0).takeError())
+        return E;
+
+    Builder.getInfoBuilder().setVersion(PdbRaw_ImplVer::PdbImplVC70);
+    Builder.getInfoBuilder().setAge(1);
+    Builder.getTpiBuilder().setVersionHeader(PdbRaw_TpiVer::PdbTpiV80);
+    Builder.getIpiBuilder().setVersionHeader(PdbRaw_TpiVer::PdbTpiV80);
+
+    DbiStreamBuilder &Dbi = Builder.getDbiBuilder();
+    Dbi.setVersionHeader(PdbRaw_DbiVer::PdbDbiV70);
+    Dbi.setAge(1);
+    Dbi.setMachineType(PDB_Machine::Amd64);
+
+    object::coff_section Text;
+    std::memset(&Text, 0, sizeof(Text));
+    std::memcpy(Text.Name, ".text", 5);
+    Text.VirtualSize = 0x100;
+    Text.VirtualAddress = TextRVA;
+    Text.SizeOfRawData = 0x200;
+    Text.Characteristics = COFF::IMAGE_SCN_CNT_CODE |
+                           COFF::IMAGE_SCN_MEM_EXECUTE |
+                           COFF::IMAGE_SCN_MEM_READ;
+    Dbi.createSectionMap(Text);
+    if (Error E = Dbi.addDbgStream(
+            DbgHeaderType::SectionHdr,
+            makeArrayRef(reinterpret_cast<const uint8_t *>(&Text),
+                         sizeof(Text))))
+      return E;
+
+    Expected<DbiModuleDescriptorBuilder &> Mod = Dbi.addModuleInfo("a.obj");
+    if (!Mod)
+      return Mod.takeError();
+    Mod->setObjFileName("a.obj");
+
+    SectionContrib SC;
+    std::memset(&SC, 0, sizeof(SC));
+    SC.ISect = 1;
+    SC.Off = 0;
+    SC.Size = 0x100;
+    SC.Imod = Mod->getModuleIndex();
+    Dbi.addSectionContrib(SC);
+
+    ProcSym Foo(SymbolRecordKind::GlobalProcSym);
+    Foo.Segment = 1;
+    Foo.CodeOffset = FooOffset;
+    Foo.CodeSize = FooSize;
+    Foo.FunctionType = TypeIndex::None();
+    Foo.Flags = ProcSymFlags::None;
+    Foo.Name = "foo";
+    ScopeEndSym End(SymbolRecordKind::ScopeEndSym);
+    Mod->addSymbol(SymbolSerializer::writeOneSymbol(Foo, Allocator,
+                                                    CodeViewContainer::Pdb));
+    Mod->addSymbol(SymbolSerializer::writeOneSymbol(End, Allocator,
+                                                    CodeViewContainer::Pdb));
+
+    auto Strings = std::make_shared<DebugStringTableSubsection>();
+    auto Checksums = std::make_shared<DebugChecksumsSubsection>(*Strings);
+    Checksums->addChecksum("a.cpp", FileChecksumKind::None, None);
+    auto Lines = std::make_shared<DebugLinesSubsection>(*Checksums, *Strings);
+    Lines->setRelocationAddress(1, FooOffset);
+    Lines->setCodeSize(FooSize);
+    Lines->createBlock("a.cpp");
+    Lines->addLineInfo(0, LineInfo(10, 10, true));
+    Lines->addLineInfo(Line11Offset - FooOffset, LineInfo(11, 11, true));
+    Mod->addDebugSubsection(Checksums);
+    Mod->addDebugSubsection(Lines);
+    Builder.getStringTableBuilder().setStrings(*Strings);
+
+    codeview::GUID IgnoredOutGuid;
+    return Builder.commit(PdbPath, &IgnoredOutGuid);
+  }
+
+  // Returns the line numbers of the rows found by \p Lines.
+  static std::vector<uint32_t>
+  lineNumbers(std::unique_ptr<IPDBEnumLineNumbers> Lines) {
+    std::vector<uint32_t> Result;
+    if (!Lines)
+      return Result;
+    while (auto Line = Lines->getNext())
+      Result.push_back(Line->getLineNumber());
+    return Result;
+  }
+
+  SmallString<128> PdbPath;
+  FileRemover Remover;
+  std::unique_ptr<IPDBSession> Session;
+};
+
+TEST_F(NativeAddressLookupTest, FindSymbol) {
+  uint32_t RVA = TextRVA + FooOffset + 4;
+  std::vector<std::unique_ptr<PDBSymbol>> Found;
+  Found.push_back(
+      Session->findSymbolByAddress(LoadAddress + RVA, PDB_SymType::Function));
+  Found.push_back(Session->findSymbolByRVA(RVA, PDB_SymType::Function));
+  Found.push_back(
+      Session->findSymbolBySectOffset(1, FooOffset + 4, PDB_SymType::Function));
+  for (const std::unique_ptr<PDBSymbol> &Sym : Found) {
+    ASSERT_TRUE(Sym);
+    auto *Func = dyn_cast<PDBSymbolFunc>(Sym.get());
+    ASSERT_NE(nullptr, Func);
+    EXPECT_EQ("foo", Func->getName());
+    EXPECT_EQ(TextRVA + FooOffset, Func->getRelativeVirtualAddress());
+    EXPECT_EQ(LoadAddress + TextRVA + FooOffset, Func->getVirtualAddress());
+    EXPECT_EQ(FooSize, Func->getLength());
+  }
+
+  // The compiland is found through its section contribution, also outside of
+  // any function.
+  std::unique_ptr<PDBSymbol> Compiland =
+      Session->findSymbolByRVA(TextRVA, PDB_SymType::Compiland);
+  ASSERT_TRUE(Compiland);
+  ASSERT_TRUE(isa<PDBSymbolCompiland>(Compiland.get()));
+  EXPECT_EQ("a.obj", cast<PDBSymbolCompiland>(Compiland.get())->getName());
+
+  // Nothing is found past the end of the function, or outside of the image.
+  EXPECT_FALSE(Session->findSymbolByRVA(TextRVA + FooOffset + FooSize,
+                                        PDB_SymType::Function));
+  EXPECT_FALSE(Session->findSymbolByAddress(LoadAddress, PDB_SymType::None));
+  EXPECT_FALSE(Session->findSymbolByRVA(0x10000, PDB_SymType::None));
+}
+
+TEST_F(NativeAddressLookupTest, FindLines) {
+  using Lines = std::vector<uint32_t>;
+  uint32_t RVA = TextRVA + FooOffset + 4;
+  EXPECT_EQ(Lines{10}, lineNumbers(Session->findLineNumbersByAddress(
+                           LoadAddress + RVA, 1)));
+  EXPECT_EQ(Lines{10}, lineNumbers(Session->findLineNumbersByRVA(RVA, 1)));
+  EXPECT_EQ(Lines{10}, lineNumbers(Session->findLineNumbersBySectOffset(
+                           1, FooOffset + 4, 1)));
+
+  // A range that spans both rows returns both, in address order.
+  EXPECT_EQ((Lines{10, 11}), lineNumbers(Session->findLineNumbersByRVA(
+                                 TextRVA + FooOffset, FooSize)));
+  EXPECT_EQ(Lines{11}, lineNumbers(Session->findLineNumbersBySectOffset(
+                           1, FooOffset + FooSize - 1, 1)));
+  EXPECT_EQ(Lines{}, lineNumbers(Session->findLineNumbersBySectOffset(
+                         1, FooOffset + FooSize, 1)));
+
+  // The last row runs up to the end of the fragment.
+  auto Line11 = Session->findLineNumbersByRVA(TextRVA + Line11Offset, 1);
+  ASSERT_TRUE(Line11);
+  auto Row = Line11->getNext();
+  ASSERT_TRUE(Row);
+  EXPECT_EQ(1u, Row->getAddressSection());
+  EXPECT_EQ(Line11Offset, Row->getAddressOffset());
+  EXPECT_EQ(TextRVA + Line11Offset, Row->getRelativeVirtualAddress());
+  EXPECT_EQ(FooOffset + FooSize - Line11Offset, Row->getLength());
+}
+
+TEST_F(NativeAddressLookupTest, FindFile) {
+  auto Lines = Session->findLineNumbersByRVA(TextRVA + FooOffset, FooSize);
+  ASSERT_TRUE(Lines);
+  auto First = Lines->getNext();
+  auto Second = Lines->getNext();
+  ASSERT_TRUE(First);
+  ASSERT_TRUE(Second);
+
+  // Both rows name the same file, which is created once.
+  EXPECT_NE(0u, First->getSourceFileId());
+  EXPECT_EQ(First->getSourceFileId(), Second->getSourceFileId());
+  auto File = Session->getSourceFileById(First->getSourceFileId());
+  ASSERT_TRUE(File);
+  EXPECT_EQ("a.cpp", File->getFileName());
+
+  EXPECT_FALSE(Session->getSourceFileById(0));
+}
+
+} // end anonymous namespace
@@ -0,0 +1,154 @@
+//===- SymbolizerTest.cpp -------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/Symbolize/Symbolize.h"
+#include "llvm/ObjectYAML/yaml2obj.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/YAMLTraits.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::symbolize;
+
+namespace {
+
+const uint64_t FunctionAddress = 0x1000;
+
+// Each binary defines a single function, whose name tells which version of
+// the binary the symbolizer has open. All names have the same length, so all
+// binaries have the same size.
+class SymbolizerCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("symbolizer-cache", Dir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(Dir); }
+
+  // Writes a binary defining FunctionName to a new file at Name, replacing
+  // any previous one. Returns the path of the binary.
+  std::string writeBinary(StringRef Name, StringRef FunctionName) {
+    SmallString<128> Path(Dir);
+    sys::path::append(Path, Name);
+    // Remove the old file rather than overwrite it, so that a symbolizer
+    // which still has it mapped keeps seeing its old contents.
+    sys::fs::remove(Path);
+
+    std::string Yaml = (R"(
+--- !ELF
+FileHeader:
+  Class:   ELFCLASS64
+  Data:    ELFDATA2LSB
+  Type:    ET_EXEC
+  Machine: EM_X86_64
+Sections:
+  - Name:    .text
+    Type:    SHT_PROGBITS
+    Flags:   [ SHF_ALLOC, SHF_EXECINSTR ]
+    Address: 0x1000
+    Content: "c3c3c3c3c3c3c3c3c3c3c3c3c3c3c3c3"
+Symbols:
+  - Name:    )" + FunctionName + R"(
+    Type:    STT_FUNC
+    Section: .text
+    Binding: STB_GLOBAL
+    Value:   0x1000
+    Size:    0x10
+)").str();
+    std::error_code EC;
+    raw_fd_ostream OS(Path, EC);
+    EXPECT_FALSE(EC);
+    yaml::Input YIn(Yaml);
+    EXPECT_TRUE(yaml::convertYAML(YIn, OS, [](const Twine &Msg) {
+      ADD_FAILURE() << Msg.str();
+    }));
+
+    uint64_t Size = OS.tell();
+    EXPECT_TRUE(BinarySize == 0 || BinarySize == Size);
+    BinarySize = Size;
+    return std::string(Path.str());
+  }
+
+  static std::string symbolize(LLVMSymbolizer &Symbolizer,
+                               const std::string &Path) {
+    Expected<DILineInfo> Info = Symbolizer.symbolizeCode(
+        Path, {FunctionAddress + 4, object::SectionedAddress::UndefSection});
+    if (!Info) {
+      ADD_FAILURE() << toString(Info.takeError());
+      return "";
+    }
+    return Info->FunctionName;
+  }
+
+  // A symbolizer with room for the given number of binaries.
+  LLVMSymbolizer::Options optionsFor(unsigned NumBinaries) {
+    LLVMSymbolizer::Options Opts;
+    Opts.MaxCacheSize = NumBinaries * BinarySize;
+    return Opts;
+  }
+
+  SmallString<128> Dir;
+  uint64_t BinarySize = 0;
+};
+
+TEST_F(SymbolizerCacheTest, LeastRecentlyUsedIsEvicted) {
+  std::string A = writeBinary("a", "a_v1");
+  std::string B = writeBinary("b", "b_v1");
+  std::string C = writeBinary("c", "c_v1");
+  LLVMSymbolizer Symbolizer(optionsFor(2));
+
+  EXPECT_EQ("a_v1", symbolize(Symbolizer, A));
+  EXPECT_EQ("b_v1", symbolize(Symbolizer, B));
+  // Using a again makes b the least recently used module, which makes room
+  // for c.
+  EXPECT_EQ("a_v1", symbolize(Symbolizer, A));
+  EXPECT_EQ("c_v1", symbolize(Symbolizer, C));
+
+  // Only b was closed, so only b is read again from disk.
+  writeBinary("a", "a_v2");
+  writeBinary("b", "b_v2");
+  EXPECT_EQ("a_v1", symbolize(Symbolizer, A));
+  EXPECT_EQ("b_v2", symbolize(Symbolizer, B));
+}
+
+TEST_F(SymbolizerCacheTest, LatestModuleIsKept) {
+  std::string A = writeBinary("a", "a_v1");
+  std::string B = writeBinary("b", "b_v1");
+  LLVMSymbolizer Symbolizer(optionsFor(1));
+
+  EXPECT_EQ("a_v1", symbolize(Symbolizer, A));
+  writeBinary("a", "a_v2");
+  EXPECT_EQ("a_v1", symbolize(Symbolizer, A));
+
+  // A limit below the size of one binary still keeps the latest module.
+  LLVMSymbolizer::Options Opts;
+  Opts.MaxCacheSize = 1;
+  LLVMSymbolizer Small(Opts);
+  EXPECT_EQ("b_v1", symbolize(Small, B));
+  writeBinary("b", "b_v2");
+  EXPECT_EQ("b_v1", symbolize(Small, B));
+  EXPECT_EQ("a_v2", symbolize(Small, A));
+  EXPECT_EQ("b_v2", symbolize(Small, B));
+}
+
+TEST_F(SymbolizerCacheTest, UnlimitedByDefault) {
+  std::string A = writeBinary("a", "a_v1");
+  std::string B = writeBinary("b", "b_v1");
+  std::string C = writeBinary("c", "c_v1");
+  LLVMSymbolizer Symbolizer;
+
+  EXPECT_EQ("a_v1", symbolize(Symbolizer, A));
+  EXPECT_EQ("b_v1", symbolize(Symbolizer, B));
+  EXPECT_EQ("c_v1", symbolize(Symbolizer, C));
+  writeBinary("a", "a_v2");
+  EXPECT_EQ("a_v1", symbolize(Symbolizer, A));
+}
+
+} // end anonymous namespace
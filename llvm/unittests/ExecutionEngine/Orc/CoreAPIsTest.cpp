@@ -1204,6 +1204,46 @@ TEST_F(CoreAPIsStandardTest, TestLookupWithThreadedMaterialization) {
 #endif
 }
 
+TEST_F(CoreAPIsStandardTest, TestMaterializationPriority) {
+  std::vector<MaterializationPriority> Priorities;
+  ES.setPrioritizedDispatchMaterialization(
+      [&](JITDylib &JD, std::unique_ptr<MaterializationUnit> MU,
+          MaterializationPriority Priority) {
+        Priorities.push_back(Priority);
+        MU->doMaterialize(JD);
+      });
+
+  auto MakeMU = [](SymbolStringPtr Name, JITEvaluatedSymbol Sym) {
+    return std::make_unique<SimpleMaterializationUnit>(
+        SymbolFlagsMap({{Name, Sym.getFlags()}}),
+        [=](MaterializationResponsibility R) {
+          cantFail(R.notifyResolved({{Name, Sym}}));
+          cantFail(R.notifyEmitted());
+        });
+  };
+  cantFail(JD.define(MakeMU(Foo, FooSym)));
+  cantFail(JD.define(MakeMU(Bar, BarSym)));
+
+  bool FooReady = false;
+  ES.lookup(
+      LookupKind::Static, makeJITDylibSearchOrder(&JD), SymbolLookupSet(Foo),
+      SymbolState::Ready,
+      [&](Expected<SymbolMap> Result) {
+        cantFail(std::move(Result));
+        FooReady = true;
+      },
+      NoDependenciesToRegister, MaterializationPriority::Speculative);
+  EXPECT_TRUE(FooReady) << "Speculative lookup did not complete";
+
+  cantFail(ES.lookup(makeJITDylibSearchOrder(&JD), Bar));
+
+  ASSERT_EQ(Priorities.size(), 2U) << "Expected two materializations";
+  EXPECT_EQ(Priorities[0], MaterializationPriority::Speculative)
+      << "Expected Foo to be dispatched speculatively";
+  EXPECT_EQ(Priorities[1], MaterializationPriority::Normal)
+      << "Expected Bar to be dispatched with normal priority";
+}
+
 TEST_F(CoreAPIsStandardTest, TestGetRequestedSymbolsAndReplace) {
   // Test that GetRequestedSymbols returns the set of symbols that currently
   // have pending queries, and test that MaterializationResponsibility's
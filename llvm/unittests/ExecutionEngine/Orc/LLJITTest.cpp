@@ -0,0 +1,129 @@
+//===--------------- LLJITTest.cpp - Unit tests for LLJIT -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "OrcTestCommon.h"
+
+#include <future>
+#include <mutex>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+// Runs lookups against an LLJIT with a single compile thread and records the
+// order in which the compile thread materializes the symbols. The first
+// symbol looked up is "blocker", whose materializer holds the compile thread
+// until release() is called, so that the order of everything dispatched in
+// the meantime is decided by the LLJIT's queues alone.
+class LLJITCompileThreadTest : public testing::Test {
+protected:
+  void SetUp() override {
+#if LLVM_ENABLE_THREADS
+    OrcNativeTarget::initialize();
+    auto JIT = LLJITBuilder().setNumCompileThreads(1).create();
+    if (!JIT) {
+      // It is valid to run these tests without a native target.
+      consumeError(JIT.takeError());
+      return;
+    }
+    J = std::move(*JIT);
+    Released = Release.get_future().share();
+    for (StringRef Name : {"blocker", "n", "s1", "s2", "s3"})
+      define(Name);
+    lookup("blocker", MaterializationPriority::Normal);
+#endif
+  }
+
+  // Destroys the JIT, which waits for the compile thread, before the state
+  // used by the materializers goes away.
+  void TearDown() override {
+    if (J && !IsReleased)
+      Release.set_value();
+    J.reset();
+  }
+
+  void define(StringRef Name) {
+    auto Sym = J->getExecutionSession().intern(Name);
+    auto Materialize = [this, Sym,
+                        Str = Name.str()](MaterializationResponsibility R) {
+      if (Str == "blocker")
+        Released.wait();
+      {
+        std::lock_guard<std::mutex> Lock(OrderMutex);
+        Order.push_back(Str);
+      }
+      cantFail(R.notifyResolved(
+          {{Sym, JITEvaluatedSymbol(0x1000, JITSymbolFlags::Exported)}}));
+      cantFail(R.notifyEmitted());
+    };
+    cantFail(J->getMainJITDylib().define(
+        std::make_unique<SimpleMaterializationUnit>(
+            SymbolFlagsMap({{Sym, JITSymbolFlags::Exported}}),
+            std::move(Materialize))));
+  }
+
+  void lookup(StringRef Name, MaterializationPriority Priority) {
+    auto &ES = J->getExecutionSession();
+    auto Done = std::make_shared<std::promise<void>>();
+    Pending.push_back(Done->get_future());
+    ES.lookup(
+        LookupKind::Static, makeJITDylibSearchOrder(&J->getMainJITDylib()),
+        SymbolLookupSet(ES.intern(Name)), SymbolState::Ready,
+        [Done](Expected<SymbolMap> Result) {
+          cantFail(std::move(Result));
+          Done->set_value();
+        },
+        NoDependenciesToRegister, Priority);
+  }
+
+  // Lets the compile thread go and waits for all lookups to complete.
+  std::vector<std::string> release() {
+    Release.set_value();
+    IsReleased = true;
+    for (auto &F : Pending)
+      F.wait();
+    std::lock_guard<std::mutex> Lock(OrderMutex);
+    return Order;
+  }
+
+  std::unique_ptr<LLJIT> J;
+  std::promise<void> Release;
+  std::shared_future<void> Released;
+  bool IsReleased = false;
+  std::vector<std::future<void>> Pending;
+  std::mutex OrderMutex;
+  std::vector<std::string> Order;
+};
+
+TEST_F(LLJITCompileThreadTest, NormalWorkRunsBeforeSpeculativeWork) {
+  if (!J)
+    return;
+
+  lookup("s1", MaterializationPriority::Speculative);
+  lookup("s2", MaterializationPriority::Speculative);
+  lookup("n", MaterializationPriority::Normal);
+  EXPECT_EQ((std::vector<std::string>{"blocker", "n", "s1", "s2"}), release());
+}
+
+TEST_F(LLJITCompileThreadTest, WaitedForSpeculativeWorkIsPromoted) {
+  if (!J)
+    return;
+
+  // The normal lookup of s3 finds it already queued by the speculative one,
+  // and moves it ahead of the other speculative work.
+  lookup("s1", MaterializationPriority::Speculative);
+  lookup("s2", MaterializationPriority::Speculative);
+  lookup("s3", MaterializationPriority::Speculative);
+  lookup("s3", MaterializationPriority::Normal);
+  EXPECT_EQ((std::vector<std::string>{"blocker", "s3", "s1", "s2"}),
+            release());
+}
+
+} // namespace
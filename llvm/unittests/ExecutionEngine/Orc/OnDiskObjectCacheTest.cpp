@@ -0,0 +1,171 @@
+//===------ OnDiskObjectCacheTest.cpp - Unit tests for OnDiskObjectCache --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+#include <functional>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+std::unique_ptr<Module> createModule(LLVMContext &Ctx, int Result) {
+  auto M = std::make_unique<Module>("test", Ctx);
+  auto *F = Function::Create(FunctionType::get(Type::getInt32Ty(Ctx), false),
+                             GlobalValue::ExternalLinkage, "foo", *M);
+  IRBuilder<> B(BasicBlock::Create(Ctx, "entry", F));
+  B.CreateRet(B.getInt32(Result));
+  return M;
+}
+
+TEST(OnDiskObjectCacheTest, KeyedByModuleAndTarget) {
+  SmallString<128> CacheDir;
+  ASSERT_FALSE(
+      sys::fs::createUniqueDirectory("OnDiskObjectCacheTest", CacheDir));
+
+  JITTargetMachineBuilder JTMB(Triple("x86_64-unknown-linux-gnu"));
+  StringRef Obj = "not really an object file";
+
+  {
+    auto Cache = OnDiskObjectCache::Create(CacheDir, JTMB);
+    ASSERT_THAT_EXPECTED(Cache, Succeeded());
+    LLVMContext Ctx;
+    auto M = createModule(Ctx, 42);
+    EXPECT_EQ((*Cache)->getObject(M.get()), nullptr);
+    (*Cache)->notifyObjectCompiled(M.get(), MemoryBufferRef(Obj, "obj"));
+  }
+
+  // A new cache for the same directory finds the object for an identical
+  // module in an unrelated context.
+  {
+    auto Cache = OnDiskObjectCache::Create(CacheDir, JTMB);
+    ASSERT_THAT_EXPECTED(Cache, Succeeded());
+    LLVMContext Ctx;
+    auto M = createModule(Ctx, 42);
+    auto Cached = (*Cache)->getObject(M.get());
+    ASSERT_NE(Cached, nullptr);
+    EXPECT_EQ(Cached->getBuffer(), Obj);
+
+    // A different module is not found.
+    auto Other = createModule(Ctx, 43);
+    EXPECT_EQ((*Cache)->getObject(Other.get()), nullptr);
+  }
+
+  // Neither is the same module compiled for a different CPU.
+  {
+    JITTargetMachineBuilder OtherJTMB = JTMB;
+    OtherJTMB.setCPU("skylake");
+    auto Cache = OnDiskObjectCache::Create(CacheDir, OtherJTMB);
+    ASSERT_THAT_EXPECTED(Cache, Succeeded());
+    LLVMContext Ctx;
+    auto M = createModule(Ctx, 42);
+    EXPECT_EQ((*Cache)->getObject(M.get()), nullptr);
+  }
+
+  sys::fs::remove_directories(CacheDir);
+}
+
+TEST(OnDiskObjectCacheTest, KeyedByAllOptions) {
+  SmallString<128> CacheDir;
+  ASSERT_FALSE(
+      sys::fs::createUniqueDirectory("OnDiskObjectCacheTest", CacheDir));
+
+  JITTargetMachineBuilder JTMB(Triple("x86_64-unknown-linux-gnu"));
+  StringRef Obj = "not really an object file";
+  {
+    auto Cache = OnDiskObjectCache::Create(CacheDir, JTMB);
+    ASSERT_THAT_EXPECTED(Cache, Succeeded());
+    LLVMContext Ctx;
+    auto M = createModule(Ctx, 42);
+    EXPECT_EQ((*Cache)->getObject(M.get()), nullptr);
+    (*Cache)->notifyObjectCompiled(M.get(), MemoryBufferRef(Obj, "obj"));
+  }
+
+  // Each of these changes the code generated for the module, so none of them
+  // may find the object compiled with the default options.
+  std::vector<std::function<void(TargetOptions &)>> Changes = {
+      [](TargetOptions &O) { O.EnableFastISel = true; },
+      [](TargetOptions &O) { O.TrapUnreachable = true; },
+      [](TargetOptions &O) { O.StackAlignmentOverride = 32; },
+      [](TargetOptions &O) { O.DebuggerTuning = DebuggerKind::GDB; },
+      [](TargetOptions &O) {
+        O.setFPDenormalMode(DenormalMode::getPreserveSign());
+      },
+      [](TargetOptions &O) { O.MCOptions.MCRelaxAll = true; },
+      [](TargetOptions &O) { O.MCOptions.ABIName = "x32"; },
+  };
+  for (auto &Change : Changes) {
+    JITTargetMachineBuilder OtherJTMB = JTMB;
+    Change(OtherJTMB.getOptions());
+    auto Cache = OnDiskObjectCache::Create(CacheDir, OtherJTMB);
+    ASSERT_THAT_EXPECTED(Cache, Succeeded());
+    LLVMContext Ctx;
+    auto M = createModule(Ctx, 42);
+    EXPECT_EQ((*Cache)->getObject(M.get()), nullptr);
+  }
+
+  sys::fs::remove_directories(CacheDir);
+}
+
+// Returns the names of the files in Dir.
+static std::vector<std::string> listDirectory(StringRef Dir) {
+  std::vector<std::string> Names;
+  std::error_code EC;
+  for (sys::fs::directory_iterator I(Dir, EC), E; I != E && !EC;
+       I.increment(EC))
+    Names.push_back(std::string(sys::path::filename(I->path())));
+  return Names;
+}
+
+TEST(OnDiskObjectCacheTest, NoTemporaryFilesLeftBehind) {
+  SmallString<128> CacheDir;
+  ASSERT_FALSE(
+      sys::fs::createUniqueDirectory("OnDiskObjectCacheTest", CacheDir));
+
+  JITTargetMachineBuilder JTMB(Triple("x86_64-unknown-linux-gnu"));
+  auto Cache = OnDiskObjectCache::Create(CacheDir, JTMB);
+  ASSERT_THAT_EXPECTED(Cache, Succeeded());
+  LLVMContext Ctx;
+  auto M = createModule(Ctx, 42);
+  StringRef Obj = "not really an object file";
+
+  // A stored object leaves nothing but its entry.
+  EXPECT_EQ((*Cache)->getObject(M.get()), nullptr);
+  (*Cache)->notifyObjectCompiled(M.get(), MemoryBufferRef(Obj, "obj"));
+  std::vector<std::string> Names = listDirectory(CacheDir);
+  ASSERT_EQ(1u, Names.size());
+  EXPECT_TRUE(StringRef(Names[0]).startswith("llvmcache-"));
+
+  // Make the entry impossible to write by putting a non-empty directory in
+  // its place. The temporary file is removed when the rename fails.
+  SmallString<128> EntryPath(CacheDir);
+  sys::path::append(EntryPath, Names[0]);
+  ASSERT_FALSE(sys::fs::remove(EntryPath));
+  ASSERT_FALSE(sys::fs::create_directory(EntryPath));
+  SmallString<128> Blocker(EntryPath);
+  sys::path::append(Blocker, "blocker");
+  ASSERT_FALSE(sys::fs::create_directory(Blocker));
+
+  EXPECT_EQ((*Cache)->getObject(M.get()), nullptr);
+  (*Cache)->notifyObjectCompiled(M.get(), MemoryBufferRef(Obj, "obj"));
+  EXPECT_EQ(std::vector<std::string>{Names[0]}, listDirectory(CacheDir));
+
+  sys::fs::remove_directories(CacheDir);
+}
+
+} // namespace
@@ -0,0 +1,122 @@
+//===------- ReoptimizeLayerTest.cpp - Unit tests for ReoptimizeLayer -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/ReoptimizeLayer.h"
+#include "OrcTestCommon.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
+#include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
+#include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/IR/Constants.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class ReoptimizeLayerTest : public testing::Test, public OrcExecutionTest {};
+
+// The ReoptimizeLayer and the CompileOnDemandLayer refer to each other. The
+// reference to the CompileOnDemandLayer is only stored on construction.
+struct ReoptimizeStack {
+  ReoptimizeStack(ExecutionSession &ES, IRLayer &CompileLayer,
+                  LazyCallThroughManager &LCTM,
+                  CompileOnDemandLayer::IndirectStubsManagerBuilder ISMBuilder,
+                  ReoptimizeLayer::OptimizeFunction Optimize)
+      : ReoptLayer(ES, CompileLayer, CODLayer, std::move(Optimize),
+                   /*CallThreshold=*/2),
+        CODLayer(ES, ReoptLayer, LCTM, std::move(ISMBuilder)) {}
+
+  ReoptimizeLayer ReoptLayer;
+  CompileOnDemandLayer CODLayer;
+};
+
+// Replaces the body of each function in the module with 'ret i32 2'.
+static Expected<ThreadSafeModule> returnTwo(ThreadSafeModule TSM) {
+  TSM.withModuleDo([](Module &M) {
+    for (auto &F : M.functions()) {
+      if (F.isDeclaration())
+        continue;
+      F.deleteBody();
+      IRBuilder<> B(BasicBlock::Create(M.getContext(), "entry", &F));
+      B.CreateRet(ConstantInt::get(Type::getInt32Ty(M.getContext()), 2));
+    }
+  });
+  return std::move(TSM);
+}
+
+TEST_F(ReoptimizeLayerTest, HotFunctionIsRedirected) {
+  if (!SupportsJIT || !SupportsIndirection)
+    return;
+
+  auto JTMB = JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    consumeError(JTMB.takeError());
+    return;
+  }
+  auto DL = cantFail(JTMB->getDefaultDataLayoutForTarget());
+  auto LCTM =
+      cantFail(createLocalLazyCallThroughManager(JTMB->getTargetTriple(), ES,
+                                                 0));
+
+  ES.setErrorReporter(
+      [](Error Err) { ADD_FAILURE() << toString(std::move(Err)); });
+
+  auto &JD = ES.createBareJITDylib("main");
+  MangleAndInterner Mangle(ES, DL);
+
+  RTDyldObjectLinkingLayer ObjLayer(
+      ES, []() { return std::make_unique<SectionMemoryManager>(); });
+  IRCompileLayer CompileLayer(ES, ObjLayer,
+                              std::make_unique<ConcurrentIRCompiler>(*JTMB));
+  ReoptimizeStack Stack(
+      ES, CompileLayer, *LCTM,
+      createLocalIndirectStubsManagerBuilder(JTMB->getTargetTriple()),
+      returnTwo);
+  cantFail(Stack.ReoptLayer.addReoptimizationRuntime(JD, Mangle));
+
+  // Add 'i32 foo() { return 1; }'.
+  ThreadSafeContext TSCtx(std::make_unique<LLVMContext>());
+  {
+    ModuleBuilder MB(*TSCtx.getContext(), JTMB->getTargetTriple().str(),
+                     "foo");
+    MB.getModule()->setDataLayout(DL);
+    auto *Int32Ty = Type::getInt32Ty(*TSCtx.getContext());
+    Function *Foo =
+        MB.createFunctionDecl(FunctionType::get(Int32Ty, {}, false), "foo");
+    IRBuilder<> B(BasicBlock::Create(*TSCtx.getContext(), "entry", Foo));
+    B.CreateRet(ConstantInt::get(Int32Ty, 1));
+    cantFail(Stack.CODLayer.add(JD, ThreadSafeModule(MB.takeModule(), TSCtx)));
+  }
+
+  auto FooSym = cantFail(ES.lookup({&JD}, Mangle("foo")));
+  auto FooFn =
+      reinterpret_cast<int (*)()>(static_cast<uintptr_t>(FooSym.getAddress()));
+
+  // The second call reaches the threshold and schedules the re-optimization,
+  // but still runs the instrumented body.
+  EXPECT_EQ(FooFn(), 1);
+  EXPECT_EQ(FooFn(), 1);
+
+  // Wait for the stub to be redirected to the re-optimized body.
+  int Result = FooFn();
+  for (unsigned I = 0; I != 1000 && Result != 2; ++I) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Result = FooFn();
+  }
+  EXPECT_EQ(Result, 2) << "Stub was not redirected to the re-optimized body";
+}
+
+} // end anonymous namespace
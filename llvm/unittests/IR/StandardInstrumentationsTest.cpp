@@ -0,0 +1,74 @@
+//===- unittests/IR/StandardInstrumentationsTest.cpp ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Passes/StandardInstrumentations.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+struct InvalidatingPass : PassInfoMixin<InvalidatingPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM) {
+    return PreservedAnalyses::none();
+  }
+};
+
+struct PreservingPass : PassInfoMixin<PreservingPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM) {
+    return PreservedAnalyses::all();
+  }
+};
+
+TEST(AnalysisRecomputeInstrumentationTest, Basic) {
+  LLVMContext Context;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString("define void @f() {\n"
+                                                  "entry:\n"
+                                                  "  ret void\n"
+                                                  "}\n",
+                                                  Err, Context);
+  ASSERT_TRUE(M);
+
+  PassInstrumentationCallbacks PIC;
+  AnalysisRecomputeInstrumentation Disabled(/*Enabled=*/false);
+  AnalysisRecomputeInstrumentation Recomputes(/*Enabled=*/true);
+  Disabled.registerCallbacks(PIC);
+  Recomputes.registerCallbacks(PIC);
+
+  FunctionAnalysisManager FAM;
+  FAM.registerPass([&] { return PassInstrumentationAnalysis(&PIC); });
+  FAM.registerPass([] { return DominatorTreeAnalysis(); });
+
+  FunctionPassManager FPM;
+  FPM.addPass(RequireAnalysisPass<DominatorTreeAnalysis, Function>());
+  FPM.addPass(PreservingPass());
+  FPM.addPass(RequireAnalysisPass<DominatorTreeAnalysis, Function>());
+  FPM.addPass(InvalidatingPass());
+  FPM.addPass(RequireAnalysisPass<DominatorTreeAnalysis, Function>());
+  FPM.run(*M->getFunction("f"), FAM);
+
+  std::string Report;
+  raw_string_ostream OS(Report);
+  Disabled.print(OS);
+  EXPECT_TRUE(OS.str().empty());
+
+  Recomputes.print(OS);
+  EXPECT_NE(OS.str().find("DominatorTreeAnalysis <- "), std::string::npos);
+  EXPECT_NE(OS.str().find("InvalidatingPass"), std::string::npos);
+  EXPECT_EQ(OS.str().find("PreservingPass"), std::string::npos);
+}
+
+} // end anonymous namespace
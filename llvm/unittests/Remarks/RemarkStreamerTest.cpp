@@ -0,0 +1,94 @@
+//===- unittest/Remarks/RemarkStreamerTest.cpp ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/RemarkStreamer.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "llvm/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+static std::unique_ptr<remarks::RemarkStreamer>
+createStreamer(raw_ostream &OS) {
+  Expected<std::unique_ptr<remarks::RemarkSerializer>> MaybeS =
+      remarks::createRemarkSerializer(remarks::Format::YAML,
+                                      remarks::SerializerMode::Separate, OS);
+  EXPECT_FALSE(errorToBool(MaybeS.takeError()));
+  return std::make_unique<remarks::RemarkStreamer>(std::move(*MaybeS));
+}
+
+static remarks::Remark createRemark(StringRef FunctionName,
+                                    Optional<uint64_t> Hotness) {
+  remarks::Remark R;
+  R.RemarkType = remarks::Type::Missed;
+  R.PassName = "pass";
+  R.RemarkName = "name";
+  R.FunctionName = FunctionName;
+  R.Hotness = Hotness;
+  R.Args.emplace_back();
+  R.Args.back().Key = "key";
+  R.Args.back().Val = "value";
+  return R;
+}
+
+TEST(RemarkStreamer, SampleRate) {
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  std::unique_ptr<remarks::RemarkStreamer> RS = createStreamer(OS);
+  RS->setSampleRate(3);
+
+  // Every pass is sampled on its own, starting with its first remark.
+  std::vector<bool> Sampled;
+  for (StringRef PassName : {"a", "a", "b", "a", "a", "b", "b", "b"})
+    Sampled.push_back(RS->isSampled(PassName));
+  EXPECT_EQ(std::vector<bool>({true, false, true, false, true, false, false,
+                               true}),
+            Sampled);
+
+  RS->setSampleRate(1);
+  EXPECT_TRUE(RS->isSampled("a"));
+  EXPECT_TRUE(RS->isSampled("a"));
+}
+
+TEST(RemarkStreamer, Aggregate) {
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  std::unique_ptr<remarks::RemarkStreamer> RS = createStreamer(OS);
+  RS->setAggregate(true);
+  EXPECT_TRUE(RS->isAggregating());
+
+  RS->emit(createRemark("g", None));
+  RS->emit(createRemark("f", 5));
+  RS->emit(createRemark("f", 7));
+  RS->emit(createRemark("f", None));
+  EXPECT_EQ("", OS.str());
+
+  RS->finalize();
+  EXPECT_EQ("--- !Missed\n"
+            "Pass:            pass\n"
+            "Name:            name\n"
+            "Function:        f\n"
+            "Hotness:         12\n"
+            "Args:\n"
+            "  - Count:           '3'\n"
+            "...\n"
+            "--- !Missed\n"
+            "Pass:            pass\n"
+            "Name:            name\n"
+            "Function:        g\n"
+            "Args:\n"
+            "  - Count:           '1'\n"
+            "...\n",
+            OS.str());
+
+  // Nothing is left to emit.
+  Buf.clear();
+  RS->finalize();
+  EXPECT_EQ("", OS.str());
+}
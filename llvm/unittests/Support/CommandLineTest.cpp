@@ -1786,6 +1786,45 @@ TEST(CommandLineTest, Callback) {
   cl::ResetAllOptionOccurrences();
 }
 
+TEST(CommandLineTest, LazyRegistration) {
+  cl::ResetCommandLineParser();
+
+  StackOption<bool> OptA("a", cl::desc("option a"));
+  const char *args1[] = {"prog", "-a"};
+  EXPECT_TRUE(
+      cl::ParseCommandLineOptions(2, args1, StringRef(), &llvm::nulls()));
+  EXPECT_TRUE(OptA);
+  cl::ResetAllOptionOccurrences();
+
+  // An option constructed after the option maps were filled is still found.
+  StackOption<bool> OptB("b", cl::desc("option b"));
+  EXPECT_EQ(1u, cl::getRegisteredOptions(*cl::TopLevelSubCommand).count("b"));
+  const char *args2[] = {"prog", "-b"};
+  EXPECT_TRUE(
+      cl::ParseCommandLineOptions(2, args2, StringRef(), &llvm::nulls()));
+  EXPECT_FALSE(OptA);
+  EXPECT_TRUE(OptB);
+  cl::ResetAllOptionOccurrences();
+
+  // An option constructed while parsing, e.g. by a plugin loaded by an earlier
+  // argument, can be used by the following arguments.
+  std::unique_ptr<StackOption<bool>> OptD;
+  StackOption<bool> OptC(
+      "c", cl::desc("option c -- This option constructs option d"),
+      cl::callback([&](const bool &) {
+        OptD = std::make_unique<StackOption<bool>>("d", cl::desc("option d"));
+      }));
+  const char *args3[] = {"prog", "-c", "-d"};
+  EXPECT_TRUE(
+      cl::ParseCommandLineOptions(3, args3, StringRef(), &llvm::nulls()));
+  EXPECT_TRUE(OptC);
+  ASSERT_TRUE(OptD != nullptr);
+  EXPECT_TRUE(*OptD);
+
+  OptD.reset();
+  cl::ResetAllOptionOccurrences();
+}
+
 enum Enum { Val1, Val2 };
 static cl::bits<Enum> ExampleBits(
     cl::desc("An example cl::bits to ensure it compiles"),
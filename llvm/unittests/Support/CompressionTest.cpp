@@ -71,6 +71,44 @@ TEST(CompressionTest, ZlibCRC32) {
       zlib::crc32(StringRef("The quick brown fox jumps over the lazy dog")));
 }
 
+TEST(CompressionTest, ZlibAdler32) {
+  EXPECT_EQ(0x11E60398U, zlib::adler32(StringRef("Wikipedia")));
+  EXPECT_EQ(0x11E60398U, zlib::adler32Combine(zlib::adler32("Wiki"),
+                                              zlib::adler32("pedia"), 5));
+}
+
+TEST(CompressionTest, ZlibRawConcatenation) {
+  const size_t kSize = 4096;
+  char BinaryData[kSize];
+  for (size_t i = 0; i < kSize; ++i)
+    BinaryData[i] = (i * i) & 255;
+  StringRef Input(BinaryData, kSize);
+  StringRef First = Input.take_front(1000);
+  StringRef Second = Input.drop_front(1000);
+
+  // Build a zlib stream out of two independently compressed pieces.
+  SmallString<32> Compressed("\x78\x01");
+  SmallString<32> Piece;
+  Error E = zlib::compressRaw(First, Piece, zlib::BestSpeedCompression, false);
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  Compressed += Piece;
+  E = zlib::compressRaw(Second, Piece, zlib::BestSpeedCompression, true);
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  Compressed += Piece;
+  uint32_t Checksum = zlib::adler32Combine(
+      zlib::adler32(First), zlib::adler32(Second), Second.size());
+  for (int Shift = 24; Shift >= 0; Shift -= 8)
+    Compressed.push_back((Checksum >> Shift) & 255);
+
+  SmallString<32> Uncompressed;
+  E = zlib::uncompress(Compressed, Uncompressed, Input.size());
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  EXPECT_EQ(Input, Uncompressed);
+}
+
 #endif
 
 }
@@ -140,6 +140,30 @@ TEST(FileOutputBuffer, Test) {
   ASSERT_NO_ERROR(fs::file_size(Twine(File5), File5Size));
   ASSERT_EQ(File5Size, 8000ULL);
   ASSERT_NO_ERROR(fs::remove(File5.str()));
+
+  // TEST 6: Contents survive releasing the pages of the buffer.
+  SmallString<128> File6(TestDirectory);
+  File6.append("/file6");
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File6, 1 << 20);
+    ASSERT_NO_ERROR(errorToErrorCode(BufferOrErr.takeError()));
+    std::unique_ptr<FileOutputBuffer> &Buffer = *BufferOrErr;
+    memset(Buffer->getBufferStart(), 'A', Buffer->getBufferSize());
+    Buffer->dontNeed(0, Buffer->getBufferSize());
+    EXPECT_EQ(Buffer->getBufferStart()[12345], 'A');
+    Buffer->dontNeed(100, Buffer->getBufferSize() - 200);
+    ASSERT_NO_ERROR(errorToErrorCode(Buffer->commit()));
+  }
+  {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+        MemoryBuffer::getFile(File6);
+    ASSERT_NO_ERROR(BufferOrErr.getError());
+    StringRef Contents = (*BufferOrErr)->getBuffer();
+    ASSERT_EQ(Contents.size(), size_t(1 << 20));
+    EXPECT_EQ(Contents.find_first_not_of('A'), StringRef::npos);
+  }
+  ASSERT_NO_ERROR(fs::remove(File6.str()));
   // Clean up.
   ASSERT_NO_ERROR(fs::remove(TestDirectory.str()));
 }
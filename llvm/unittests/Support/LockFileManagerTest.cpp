@@ -7,10 +7,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/LockFileManager.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include "gtest/gtest.h"
 #include <memory>
+#include <thread>
 
 using namespace llvm;
 
@@ -43,6 +46,40 @@ TEST(LockFileManagerTest, Basic) {
   ASSERT_FALSE(EC);
 }
 
+#if LLVM_ENABLE_THREADS
+TEST(LockFileManagerTest, WaitForUnlockInSameProcess) {
+  SmallString<64> TmpDir;
+  std::error_code EC;
+  EC = sys::fs::createUniqueDirectory("LockFileManagerTestDir", TmpDir);
+  ASSERT_FALSE(EC);
+
+  SmallString<64> LockedFile(TmpDir);
+  sys::path::append(LockedFile, "file");
+
+  auto Locked1 = std::make_unique<LockFileManager>(LockedFile);
+  ASSERT_EQ(LockFileManager::LFS_Owned, Locked1->getState());
+
+  LockFileManager Locked2(LockedFile);
+  ASSERT_EQ(LockFileManager::LFS_Shared, Locked2.getState());
+
+  // Produce the locked file and release the lock on another thread.
+  std::thread Owner([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int FD;
+    ASSERT_FALSE(sys::fs::openFileForWrite(LockedFile, FD));
+    ASSERT_FALSE(sys::Process::SafelyCloseFileDescriptor(FD));
+    Locked1.reset();
+  });
+  EXPECT_EQ(LockFileManager::Res_Success, Locked2.waitForUnlock());
+  Owner.join();
+
+  EC = sys::fs::remove(StringRef(LockedFile));
+  ASSERT_FALSE(EC);
+  EC = sys::fs::remove(StringRef(TmpDir));
+  ASSERT_FALSE(EC);
+}
+#endif
+
 TEST(LockFileManagerTest, LinkLockExists) {
   SmallString<64> TmpDir;
   std::error_code EC;
@@ -147,6 +147,16 @@ TEST(NativeFormatTest, HexTests) {
   // Try printing more digits than can fit in a uint64.
   EXPECT_EQ("0x00000000000000abcde",
             format_number(0xABCDE, HexPrintStyle::PrefixLower, 21));
+
+  // Every number of nibbles.
+  EXPECT_EQ("0xFFFFFFFFFFFFFFFF",
+            format_number(UINT64_MAX, HexPrintStyle::PrefixUpper));
+  for (unsigned Shift = 0; Shift < 64; Shift += 4) {
+    uint64_t N = 0x123456789abcdef0ULL >> Shift;
+    char Expected[32];
+    snprintf(Expected, sizeof(Expected), "%llx", (unsigned long long)N);
+    EXPECT_EQ(Expected, format_number(N, HexPrintStyle::Lower));
+  }
 }
 
 TEST(NativeFormatTest, IntegerTests) {
@@ -158,6 +168,32 @@ TEST(NativeFormatTest, IntegerTests) {
   EXPECT_EQ("100", format_number(100, IntegerStyle::Integer));
   EXPECT_EQ("1000", format_number(1000, IntegerStyle::Integer));
   EXPECT_EQ("1234567890", format_number(1234567890, IntegerStyle::Integer));
+
+  // Digits are produced two at a time, so check every length on either side
+  // of each power of ten.
+  for (unsigned I = 0; I < 1000; ++I)
+    EXPECT_EQ(std::to_string(I), format_number(I, IntegerStyle::Integer));
+  for (uint64_t P = 10;; P *= 10) {
+    EXPECT_EQ(std::to_string(P - 1),
+              format_number(P - 1, IntegerStyle::Integer));
+    EXPECT_EQ(std::to_string(P), format_number(P, IntegerStyle::Integer));
+    if (P > UINT64_MAX / 10)
+      break;
+  }
+}
+
+TEST(NativeFormatTest, MinDigitsTests) {
+  auto format_padded = [](int64_t N, size_t MinDigits) {
+    std::string S;
+    llvm::raw_string_ostream Str(S);
+    write_integer(Str, N, MinDigits, IntegerStyle::Integer);
+    return Str.str();
+  };
+  EXPECT_EQ("7", format_padded(7, 0));
+  EXPECT_EQ("007", format_padded(7, 3));
+  EXPECT_EQ("-007", format_padded(-7, 3));
+  EXPECT_EQ("12345", format_padded(12345, 3));
+  EXPECT_EQ(std::string(39, '0') + "1", format_padded(1, 40));
 }
 
 TEST(NativeFormatTest, CommaTests) {
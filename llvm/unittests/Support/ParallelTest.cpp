@@ -14,6 +14,7 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
 #include <random>
 
 uint32_t array[1024 * 1024];
@@ -49,4 +50,16 @@ TEST(Parallel, parallel_for) {
   ASSERT_EQ(range[2049], 1u);
 }
 
+TEST(Parallel, nested_parallel_for) {
+  // The inner loops run in parallel as well, which must neither deadlock nor
+  // lose iterations.
+  std::atomic<unsigned> count{0};
+  for_each_n(parallel::par, 0, 64, [&](size_t) {
+    for_each_n(parallel::par, 0, 64, [&](size_t) {
+      for_each_n(parallel::par, 0, 8, [&](size_t) { ++count; });
+    });
+  });
+  ASSERT_EQ(count, 64u * 64u * 8u);
+}
+
 #endif
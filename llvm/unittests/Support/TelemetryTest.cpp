@@ -0,0 +1,91 @@
+//===- unittests/Support/TelemetryTest.cpp - Telemetry counter tests ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Telemetry.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "telemetry-test"
+
+namespace {
+
+TELEMETRY_COUNTER(Counter1, "Counter 1");
+TELEMETRY_COUNTER(Counter2, "Counter 2");
+TELEMETRY_COUNTER(ThreadCounter, "Updated from several threads");
+TELEMETRY_COUNTER(TimeCounter, "Time spent in a region (ns)");
+TELEMETRY_COUNTER(NeverUpdated, "Not updated by any test");
+
+TEST(TelemetryTest, Count) {
+  uint64_t Start = Counter1.getValue();
+  ++Counter1;
+  ++Counter1;
+  Counter1 += 40;
+  EXPECT_EQ(Start + 42, Counter1.getValue());
+  EXPECT_EQ(0u, NeverUpdated.getValue());
+
+  Counter2 += uint64_t(1) << 40;
+  EXPECT_EQ(uint64_t(1) << 40, Counter2.getValue());
+}
+
+#if LLVM_ENABLE_THREADS
+TEST(TelemetryTest, Threads) {
+  const unsigned NumThreads = 8, NumUpdates = 10000;
+  std::vector<std::thread> Threads;
+  for (unsigned I = 0; I != NumThreads; ++I)
+    Threads.emplace_back([] {
+      for (unsigned J = 0; J != NumUpdates; ++J)
+        ++ThreadCounter;
+    });
+  for (std::thread &T : Threads)
+    T.join();
+  // The blocks of the threads that have exited still count.
+  EXPECT_EQ(NumThreads * NumUpdates, ThreadCounter.getValue());
+}
+#endif
+
+TEST(TelemetryTest, TimeRegion) {
+  uint64_t Start = TimeCounter.getValue();
+  {
+    TelemetryTimeRegion T(TimeCounter);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GE(TimeCounter.getValue() - Start, 1000000u);
+}
+
+TEST(TelemetryTest, JSON) {
+  ++Counter1;
+  SetTelemetryToolName("telemetry-test");
+
+  std::string Output;
+  raw_string_ostream OS(Output);
+  PrintTelemetryJSON(OS);
+  OS.flush();
+  EXPECT_EQ(std::string::npos, Output.find('\n'));
+
+  Expected<json::Value> Parsed = json::parse(Output);
+  ASSERT_TRUE(bool(Parsed)) << toString(Parsed.takeError());
+  const json::Object *Root = Parsed->getAsObject();
+  ASSERT_TRUE(Root);
+  EXPECT_EQ(StringRef("telemetry-test"), Root->getString("tool"));
+  EXPECT_TRUE(Root->getInteger("pid"));
+
+  const json::Object *Counters = Root->getObject("counters");
+  ASSERT_TRUE(Counters);
+  EXPECT_EQ(int64_t(Counter1.getValue()),
+            Counters->getInteger("telemetry-test.Counter1"));
+  // Only counters that have been updated are listed.
+  EXPECT_FALSE(Counters->get("telemetry-test.NeverUpdated"));
+}
+
+} // end anonymous namespace
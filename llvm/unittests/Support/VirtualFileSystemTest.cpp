@@ -934,6 +934,85 @@ TEST(ProxyFileSystemTest, Basic) {
   EXPECT_FALSE(Local);
 }
 
+namespace {
+/// Counts the calls that reach the wrapped file system.
+class CountingFileSystem : public vfs::ProxyFileSystem {
+public:
+  using ProxyFileSystem::ProxyFileSystem;
+
+  ErrorOr<vfs::Status> status(const Twine &Path) override {
+    ++NumStatus;
+    return ProxyFileSystem::status(Path);
+  }
+  ErrorOr<std::unique_ptr<vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    ++NumOpen;
+    return ProxyFileSystem::openFileForRead(Path);
+  }
+
+  unsigned NumStatus = 0;
+  unsigned NumOpen = 0;
+};
+} // end anonymous namespace
+
+TEST(StatCachingFileSystemTest, Basic) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  Base->addFile("/dir/a", 0, MemoryBuffer::getMemBuffer("test"));
+  IntrusiveRefCntPtr<CountingFileSystem> Counter(new CountingFileSystem(Base));
+  vfs::StatCachingFileSystem FS(Counter);
+  ASSERT_FALSE(FS.setCurrentWorkingDirectory("/dir"));
+
+  // Repeated queries, also for other spellings of the same path, only stat
+  // once, and the status carries the name it was asked for.
+  auto Stat = FS.status("/dir/a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ("/dir/a", Stat->getName());
+  Stat = FS.status("a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ("a", Stat->getName());
+  Stat = FS.status("./a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ(1u, Counter->NumStatus);
+  EXPECT_EQ(2u, FS.getNumCacheHits());
+
+  // Failed lookups are cached too, and let opening skip the file system.
+  EXPECT_TRUE(FS.status("/dir/b").getError());
+  EXPECT_EQ(std::errc::no_such_file_or_directory,
+            FS.status("/dir/b").getError());
+  EXPECT_TRUE(FS.openFileForRead("/dir/b").getError());
+  EXPECT_EQ(2u, Counter->NumStatus);
+  EXPECT_EQ(0u, Counter->NumOpen);
+
+  // Opening a file fills in its status.
+  Base->addFile("/dir/c", 0, MemoryBuffer::getMemBuffer("c"));
+  auto File = FS.openFileForRead("/dir/c");
+  ASSERT_FALSE(File.getError());
+  EXPECT_EQ("c", (*(*File)->getBuffer("ignored"))->getBuffer());
+  Stat = FS.status("c");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_TRUE(Stat->isRegularFile());
+  EXPECT_EQ(2u, Counter->NumStatus);
+}
+
+TEST(StatCachingFileSystemTest, Invalidate) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  vfs::StatCachingFileSystem FS(Base);
+
+  EXPECT_TRUE(FS.status("/a").getError());
+  Base->addFile("/a", 0, MemoryBuffer::getMemBuffer("a"));
+  EXPECT_TRUE(FS.status("/a").getError());
+  FS.invalidate("/a");
+  EXPECT_FALSE(FS.status("/a").getError());
+
+  EXPECT_TRUE(FS.status("/b").getError());
+  Base->addFile("/b", 0, MemoryBuffer::getMemBuffer("b"));
+  FS.invalidateAll();
+  EXPECT_FALSE(FS.status("/b").getError());
+  EXPECT_FALSE(FS.openFileForRead("/b").getError());
+}
+
 class InMemoryFileSystemTest : public ::testing::Test {
 protected:
   llvm::vfs::InMemoryFileSystem FS;
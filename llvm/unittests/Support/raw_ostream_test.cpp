@@ -9,6 +9,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
@@ -345,6 +346,38 @@ TEST(raw_ostreamTest, FormattedHexBytes) {
             format_bytes_with_ascii_str(B.take_front(12), 0, 7, 1));
 }
 
+TEST(raw_fd_ostreamTest, LargeWrites) {
+  // Writes that are larger than the buffer go out together with what is
+  // already buffered.
+  SmallString<64> Path;
+  int FD;
+  ASSERT_FALSE(sys::fs::createTemporaryFile("raw_fd_ostream", "txt", FD, Path));
+
+  std::string Large(100000, 'x');
+  for (size_t I = 0; I < Large.size(); I += 7)
+    Large[I] = 'a' + I % 26;
+  std::string Expected;
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS.SetBufferSize(1024);
+    for (int I = 0; I < 3; ++I) {
+      OS << "prefix" << I;
+      OS << Large;
+      Expected += "prefix" + std::to_string(I) + Large;
+    }
+    OS.write(Large.data(), 1024);
+    OS << 'c';
+    OS.write(Large.data(), 1023);
+    Expected += Large.substr(0, 1024) + "c" + Large.substr(0, 1023);
+    EXPECT_EQ(Expected.size(), OS.tell());
+  }
+
+  auto Buffer = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(bool(Buffer));
+  EXPECT_EQ(Expected, (*Buffer)->getBuffer());
+  sys::fs::remove(Path);
+}
+
 TEST(raw_fd_ostreamTest, multiple_raw_fd_ostream_to_stdout) {
   std::error_code EC;
 
@@ -17,3 +17,45 @@ TEST(xxhashTest, Basic) {
   EXPECT_EQ(0x69196c1b3af0bff9U,
             xxHash64("0123456789abcdefghijklmnopqrstuvwxyz"));
 }
+
+TEST(xxhashTest, xxh3) {
+  // Pseudorandom input, with the expected values computed by the reference
+  // implementation for lengths around the boundaries of each code path.
+  uint8_t Buf[2048];
+  uint64_t X = 0x9E3779B185EBCA87ULL;
+  for (uint8_t &B : Buf) {
+    X = X * 6364136223846793005ULL + 1442695040888963407ULL;
+    B = uint8_t(X >> 56);
+  }
+
+  struct {
+    size_t Len;
+    uint64_t Hash64;
+    XXH128_hash_t Hash128;
+  } Tests[] = {
+      {0, 0x2d06800538d394c2U, {0x6001c324468d497fU, 0x99aa06d3014798d8U}},
+      {1, 0x4272be416e3711f0U, {0x4272be416e3711f0U, 0xb5e79b035bb57390U}},
+      {3, 0x922c0bd470da1518U, {0x922c0bd470da1518U, 0x71aca226de09d588U}},
+      {4, 0x3424ed1cb7e908e9U, {0x045d3c5d1cdd72d2U, 0x05815e4fa0cc3a1eU}},
+      {8, 0x85361ca943110d0bU, {0xb4a4347851a4cbccU, 0xe12be665c381e1c4U}},
+      {9, 0x4107086217c34815U, {0xa49113c6018da04cU, 0xb07ac479f0895977U}},
+      {16, 0xf1df8ec66e834bdfU, {0xd601fe104929cbe0U, 0xc20a50bfb989b287U}},
+      {17, 0xcb638f96bdd0cf4bU, {0xec4f45a878d05f01U, 0xe5a426233b151378U}},
+      {128, 0xfaa8ce6904d9d317U, {0xa840da0c128dc2feU, 0xeebfb62e24197975U}},
+      {129, 0xcb80c7a7ff0af470U, {0xac15b78e1109aa86U, 0xb5d8106797ffcca9U}},
+      {240, 0x3011351cd873fe86U, {0x27e431b322e012b4U, 0x016df4ed0b50fcf0U}},
+      {241, 0xbf455fb68487c204U, {0xbf455fb68487c204U, 0x6066cfe493692abfU}},
+      {1024, 0xf2716404cbb45dc4U, {0xf2716404cbb45dc4U, 0x3522149947b9ce07U}},
+      {2048, 0x34a333c364b9e176U, {0x34a333c364b9e176U, 0x16e99707aa63198eU}},
+  };
+  for (const auto &T : Tests) {
+    ArrayRef<uint8_t> Data(Buf, T.Len);
+    EXPECT_EQ(T.Hash64, xxh3_64bits(Data)) << T.Len;
+    XXH128_hash_t Hash128 = xxh3_128bits(Data);
+    EXPECT_EQ(T.Hash128.low64, Hash128.low64) << T.Len;
+    EXPECT_EQ(T.Hash128.high64, Hash128.high64) << T.Len;
+  }
+
+  EXPECT_EQ(xxh3_64bits(makeArrayRef(Buf, 10)),
+            xxh3_64bits(StringRef(reinterpret_cast<const char *>(Buf), 10)));
+}
@@ -0,0 +1,36 @@
+//===- unittest/TableGen/MultipleOutputsTest.cpp - -emit tests ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+static std::string readOutput(StringRef Name) {
+  SmallString<128> Path(TABLEGEN_TEST_OUTPUT_DIR);
+  sys::path::append(Path, Name);
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer = MemoryBuffer::getFile(Path);
+  EXPECT_TRUE(bool(Buffer)) << "cannot read " << Path;
+  if (!Buffer)
+    return "";
+  return std::string((*Buffer)->getBuffer());
+}
+
+// The code emitter and the disassembler both reverse the encodings of a
+// little-endian target in place. When they run on the records of a single
+// -emit invocation, the encodings must only be reversed once.
+TEST(MultipleOutputs, SharedRecordsMatchSeparateRuns) {
+  std::string Emitter = readOutput("LittleEndianEmitter.inc");
+  EXPECT_FALSE(Emitter.empty());
+  EXPECT_EQ(Emitter, readOutput("LittleEndianEmitterShared.inc"));
+
+  std::string Disassembler = readOutput("LittleEndianDisassembler.inc");
+  EXPECT_FALSE(Disassembler.empty());
+  EXPECT_EQ(Disassembler, readOutput("LittleEndianDisassemblerShared.inc"));
+}
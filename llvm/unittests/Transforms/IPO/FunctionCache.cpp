@@ -0,0 +1,234 @@
+//===- FunctionCache.cpp - Unit tests for the function cache --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/FunctionCache.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PatternMatch.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::PatternMatch;
+
+namespace {
+
+const char *IR = R"(
+  %struct.S = type { i32, %struct.S* }
+
+  @table = internal constant [2 x i32] [i32 1, i32 2]
+  @counter = external global i32
+
+  declare void @use(%struct.S*)
+
+  define i32 @f(%struct.S* %s, i32 %x) {
+    %a = add i32 %x, 0
+    %p = getelementptr %struct.S, %struct.S* %s, i32 0, i32 0
+    store i32 %a, i32* %p
+    call void @use(%struct.S* %s)
+    %q = getelementptr [2 x i32], [2 x i32]* @table, i32 0, i32 1
+    %t = load i32, i32* %q
+    ret i32 %t
+  }
+
+  define internal i32 @g(i32 %x) {
+    %a = add i32 %x, 0
+    %c = load i32, i32* @counter
+    %r = add i32 %a, %c
+    ret i32 %r
+  }
+)";
+
+/// Folds adds of zero, and marks every function it changes with a call to a
+/// new declaration, so that the cache has to create globals on a hit.
+struct FoldAddZeroPass : PassInfoMixin<FoldAddZeroPass> {
+  unsigned &Runs;
+  explicit FoldAddZeroPass(unsigned &Runs) : Runs(Runs) {}
+
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &) {
+    ++Runs;
+    bool Changed = false;
+    for (Instruction &I : make_early_inc_range(instructions(F))) {
+      Value *X;
+      if (match(&I, m_Add(m_Value(X), m_Zero()))) {
+        I.replaceAllUsesWith(X);
+        I.eraseFromParent();
+        Changed = true;
+      }
+    }
+    if (!Changed)
+      return PreservedAnalyses::all();
+    Module &M = *F.getParent();
+    FunctionCallee Marker =
+        M.getOrInsertFunction("marker", Type::getVoidTy(M.getContext()));
+    CallInst::Create(Marker, "", &*F.getEntryBlock().getFirstInsertionPt());
+    return PreservedAnalyses::none();
+  }
+};
+
+/// Raises the alignment of globals that vectors are loaded from, as
+/// InstCombine does, which is a change to the module outside the function.
+struct AlignVectorLoadsPass : PassInfoMixin<AlignVectorLoadsPass> {
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &) {
+    bool Changed = false;
+    for (Instruction &I : instructions(F)) {
+      auto *LI = dyn_cast<LoadInst>(&I);
+      if (!LI || !LI->getType()->isVectorTy() || LI->getAlignment() >= 16)
+        continue;
+      auto *GV = dyn_cast<GlobalVariable>(LI->getPointerOperand());
+      if (!GV || !GV->canIncreaseAlignment())
+        continue;
+      GV->setAlignment(Align(16));
+      LI->setAlignment(Align(16));
+      Changed = true;
+    }
+    return Changed ? PreservedAnalyses::none() : PreservedAnalyses::all();
+  }
+};
+
+class FunctionCacheTest : public testing::Test {
+protected:
+  SmallString<128> CacheDir;
+
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("function-cache", CacheDir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(CacheDir); }
+
+  /// Parses \p Source in \p Ctx, runs the cached pipeline on it, and returns
+  /// the printed result. \p Runs counts the functions the pipeline ran on.
+  std::string optimize(LLVMContext &Ctx, unsigned &Runs,
+                       StringRef Key = "key", StringRef Source = IR) {
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(Source, Err, Ctx);
+    EXPECT_TRUE(M);
+    if (!M)
+      return "";
+
+    FunctionAnalysisManager FAM;
+    ModuleAnalysisManager MAM;
+    FAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+    MAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+    MAM.registerPass([&] { return FunctionAnalysisManagerModuleProxy(FAM); });
+    FAM.registerPass([&] { return ModuleAnalysisManagerFunctionProxy(MAM); });
+
+    FunctionPassManager FPM;
+    FPM.addPass(FoldAddZeroPass(Runs));
+    FPM.addPass(AlignVectorLoadsPass());
+    ModulePassManager MPM;
+    MPM.addPass(FunctionCachePass(std::move(FPM), std::string(CacheDir),
+                                  std::string(Key)));
+    MPM.run(*M, MAM);
+
+    EXPECT_FALSE(verifyModule(*M, &errs()));
+    std::string Result;
+    raw_string_ostream OS(Result);
+    M->print(OS, nullptr);
+    return OS.str();
+  }
+};
+
+TEST_F(FunctionCacheTest, Reuse) {
+  unsigned FirstRuns = 0, SecondRuns = 0;
+  std::string First, Second;
+  {
+    LLVMContext Ctx;
+    First = optimize(Ctx, FirstRuns);
+  }
+  {
+    // Reading the cached bodies into a context that already holds %struct.S
+    // renames the type in the cached module, which has to be mapped back.
+    LLVMContext Ctx;
+    Second = optimize(Ctx, SecondRuns);
+  }
+  EXPECT_EQ(2u, FirstRuns);
+  EXPECT_EQ(0u, SecondRuns);
+  EXPECT_EQ(First, Second);
+  EXPECT_NE(std::string::npos, Second.find("declare void @marker()"));
+  EXPECT_EQ(std::string::npos, Second.find("add i32 %x, 0"));
+}
+
+TEST_F(FunctionCacheTest, PipelineKey) {
+  unsigned FirstRuns = 0, SecondRuns = 0;
+  LLVMContext Ctx;
+  optimize(Ctx, FirstRuns, "pipeline-a");
+  LLVMContext OtherCtx;
+  optimize(OtherCtx, SecondRuns, "pipeline-b");
+  EXPECT_EQ(2u, SecondRuns);
+}
+
+TEST_F(FunctionCacheTest, CalleeLinkage) {
+  // Passes may look at the linkage of a callee and at whether the module
+  // defines it, so these modules must not share the entry of @f.
+  const char *Body = R"(
+    define i32 @f(i32 %x) {
+      %a = add i32 %x, 0
+      %r = call i32 @callee(i32 %a)
+      ret i32 %r
+    }
+  )";
+  std::string External =
+      std::string(Body) + "define i32 @callee(i32 %x) { ret i32 %x }\n";
+  std::string Internal = std::string(Body) +
+                         "define internal i32 @callee(i32 %x) { ret i32 %x }\n";
+  std::string Declared = std::string(Body) + "declare i32 @callee(i32)\n";
+
+  unsigned ExternalRuns = 0, InternalRuns = 0, DeclaredRuns = 0;
+  LLVMContext Ctx;
+  optimize(Ctx, ExternalRuns, "key", External);
+  LLVMContext InternalCtx;
+  optimize(InternalCtx, InternalRuns, "key", Internal);
+  LLVMContext DeclaredCtx;
+  optimize(DeclaredCtx, DeclaredRuns, "key", Declared);
+  EXPECT_EQ(2u, ExternalRuns);
+  EXPECT_EQ(2u, InternalRuns);
+  EXPECT_EQ(1u, DeclaredRuns);
+
+  // The same module hits.
+  unsigned AgainRuns = 0;
+  LLVMContext AgainCtx;
+  optimize(AgainCtx, AgainRuns, "key", Internal);
+  EXPECT_EQ(0u, AgainRuns);
+}
+
+TEST_F(FunctionCacheTest, RaisedAlignment) {
+  // On a hit, @buf has to be aligned for the cached load as well.
+  const char *Source = R"(
+    @buf = global <4 x i32> zeroinitializer, align 4
+
+    define <4 x i32> @f() {
+      %v = load <4 x i32>, <4 x i32>* @buf, align 4
+      ret <4 x i32> %v
+    }
+  )";
+  unsigned FirstRuns = 0, SecondRuns = 0;
+  std::string First, Second;
+  {
+    LLVMContext Ctx;
+    First = optimize(Ctx, FirstRuns, "key", Source);
+  }
+  {
+    LLVMContext Ctx;
+    Second = optimize(Ctx, SecondRuns, "key", Source);
+  }
+  EXPECT_EQ(1u, FirstRuns);
+  EXPECT_EQ(0u, SecondRuns);
+  EXPECT_EQ(First, Second);
+  EXPECT_NE(std::string::npos,
+            Second.find("@buf = global <4 x i32> zeroinitializer, align 16"));
+  EXPECT_NE(std::string::npos, Second.find("@buf, align 16"));
+}
+
+} // end anonymous namespace
@@ -0,0 +1,198 @@
+//===- HotColdSplitting.cpp - Unit tests for hot/cold splitting -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/HotColdSplitting.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+const char *Functions = R"IR(
+  target triple = "x86_64-unknown-linux-gnu"
+
+  declare void @sink(i32) cold
+
+  define void @cold_entry(i32 %x) !prof !15 {
+    call void @sink(i32 %x)
+    ret void
+  }
+
+  define i32 @rarely_taken(i32 %x) !prof !14 {
+  entry:
+    %c = icmp eq i32 %x, 0
+    br i1 %c, label %cold, label %exit, !prof !16
+
+  cold:
+    call void @sink(i32 %x)
+    call void @sink(i32 1)
+    call void @sink(i32 2)
+    call void @sink(i32 3)
+    br label %exit
+
+  exit:
+    ret i32 %x
+  }
+
+  define i32 @often_taken(i32 %x) !prof !14 {
+  entry:
+    %c = icmp eq i32 %x, 0
+    br i1 %c, label %warm, label %exit, !prof !17
+
+  warm:
+    call void @sink(i32 %x)
+    call void @sink(i32 1)
+    call void @sink(i32 2)
+    call void @sink(i32 3)
+    br label %exit
+
+  exit:
+    ret i32 %x
+  }
+
+  define void @in_section(i32 %x) section "custom" !prof !15 {
+    ret void
+  }
+)IR";
+
+const char *ProfileSummary = R"IR(
+  !llvm.module.flags = !{!0}
+
+  !0 = !{i32 1, !"ProfileSummary", !1}
+  !1 = !{!2, !3, !4, !5, !6, !7, !8, !9}
+  !2 = !{!"ProfileFormat", !"InstrProf"}
+  !3 = !{!"TotalCount", i64 10000}
+  !4 = !{!"MaxCount", i64 10}
+  !5 = !{!"MaxInternalCount", i64 1}
+  !6 = !{!"MaxFunctionCount", i64 1000}
+  !7 = !{!"NumCounts", i64 3}
+  !8 = !{!"NumFunctions", i64 3}
+  !9 = !{!"DetailedSummary", !10}
+  !10 = !{!11, !12, !13}
+  !11 = !{i32 10000, i64 1000, i32 1}
+  !12 = !{i32 999000, i64 300, i32 3}
+  !13 = !{i32 999999, i64 5, i32 10}
+)IR";
+
+const char *Weights = R"IR(
+  !14 = !{!"function_entry_count", i64 1000}
+  !15 = !{!"function_entry_count", i64 1}
+  !16 = !{!"branch_weights", i32 1, i32 1000}
+  !17 = !{!"branch_weights", i32 1, i32 1}
+)IR";
+
+class HotColdSplittingTest : public testing::Test {
+protected:
+  std::unique_ptr<Module> run(bool WithProfileSummary,
+                              bool RequireProfileSummary) {
+    std::string Source = std::string(Functions) +
+                         (WithProfileSummary ? ProfileSummary : "") + Weights;
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(Source, Err, Ctx);
+    if (!M) {
+      Err.print("HotColdSplittingTest", errs());
+      return nullptr;
+    }
+
+    FunctionAnalysisManager FAM;
+    ModuleAnalysisManager MAM;
+    FAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+    FAM.registerPass([&] { return AssumptionAnalysis(); });
+    FAM.registerPass([&] { return BlockFrequencyAnalysis(); });
+    FAM.registerPass([&] { return BranchProbabilityAnalysis(); });
+    FAM.registerPass([&] { return DominatorTreeAnalysis(); });
+    FAM.registerPass([&] { return LoopAnalysis(); });
+    FAM.registerPass([&] { return TargetIRAnalysis(); });
+    FAM.registerPass([&] { return TargetLibraryAnalysis(); });
+    MAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+    MAM.registerPass([&] { return ProfileSummaryAnalysis(); });
+    MAM.registerPass([&] { return FunctionAnalysisManagerModuleProxy(FAM); });
+    FAM.registerPass([&] { return ModuleAnalysisManagerFunctionProxy(MAM); });
+
+    ModulePassManager MPM;
+    MPM.addPass(HotColdSplittingPass(RequireProfileSummary));
+    MPM.run(*M, MAM);
+    EXPECT_FALSE(verifyModule(*M, &errs()));
+    return M;
+  }
+
+  static Optional<StringRef> prefix(Module &M, StringRef Name) {
+    Function *F = M.getFunction(Name);
+    EXPECT_NE(nullptr, F) << Name;
+    return F ? F->getSectionPrefix() : None;
+  }
+
+  LLVMContext Ctx;
+};
+
+TEST_F(HotColdSplittingTest, SectionPrefixes) {
+  std::unique_ptr<Module> M =
+      run(/*WithProfileSummary=*/true, /*RequireProfileSummary=*/true);
+  ASSERT_TRUE(M);
+
+  // A function whose entry is cold is placed in .text.unlikely as a whole.
+  Function *ColdEntry = M->getFunction("cold_entry");
+  ASSERT_NE(nullptr, ColdEntry);
+  EXPECT_TRUE(ColdEntry->hasFnAttribute(Attribute::Cold));
+  EXPECT_EQ(StringRef(".unlikely"), prefix(*M, "cold_entry"));
+
+  // The rarely taken block is split out into .text.split, and its hot parent
+  // keeps its place.
+  Function *Split = M->getFunction("rarely_taken.cold.1");
+  ASSERT_NE(nullptr, Split);
+  EXPECT_TRUE(Split->hasFnAttribute(Attribute::Cold));
+  EXPECT_EQ(StringRef(".split"), prefix(*M, "rarely_taken.cold.1"));
+  EXPECT_EQ(None, prefix(*M, "rarely_taken"));
+
+  // An explicit section wins over the prefix.
+  EXPECT_EQ(None, prefix(*M, "in_section"));
+}
+
+TEST_F(HotColdSplittingTest, HotBlockIsNotSplit) {
+  std::unique_ptr<Module> M =
+      run(/*WithProfileSummary=*/true, /*RequireProfileSummary=*/true);
+  ASSERT_TRUE(M);
+
+  // The block calls a cold function, which the static analysis would take as
+  // a sign of cold code, but the profile says that it runs half of the time.
+  EXPECT_EQ(nullptr, M->getFunction("often_taken.cold.1"));
+  EXPECT_EQ(None, prefix(*M, "often_taken"));
+}
+
+TEST_F(HotColdSplittingTest, RequireProfileSummary) {
+  // Without a profile summary the default-on pass leaves the module alone.
+  std::unique_ptr<Module> M =
+      run(/*WithProfileSummary=*/false, /*RequireProfileSummary=*/true);
+  ASSERT_TRUE(M);
+  EXPECT_EQ(nullptr, M->getFunction("rarely_taken.cold.1"));
+  EXPECT_EQ(nullptr, M->getFunction("often_taken.cold.1"));
+  EXPECT_EQ(None, prefix(*M, "cold_entry"));
+
+  // Enabled explicitly, the static analysis splits both blocks that call the
+  // cold function.
+  M = run(/*WithProfileSummary=*/false, /*RequireProfileSummary=*/false);
+  ASSERT_TRUE(M);
+  EXPECT_NE(nullptr, M->getFunction("rarely_taken.cold.1"));
+  EXPECT_NE(nullptr, M->getFunction("often_taken.cold.1"));
+}
+
+} // end anonymous namespace
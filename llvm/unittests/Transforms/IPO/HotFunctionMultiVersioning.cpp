@@ -0,0 +1,147 @@
+//===- HotFunctionMultiVersioning.cpp - Unit tests for hot function MV ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/HotFunctionMultiVersioning.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/GlobalIFunc.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+const char *IR = R"IR(
+  target triple = "x86_64-unknown-linux-gnu"
+
+  define i32 @sum(i32* %p, i32 %n) !prof !14 {
+  entry:
+    br label %loop
+
+  loop:
+    %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+    %s = phi i32 [ 0, %entry ], [ %s.next, %loop ]
+    %q = getelementptr i32, i32* %p, i32 %i
+    %v = load i32, i32* %q
+    %s.next = add i32 %s, %v
+    %i.next = add i32 %i, 1
+    %done = icmp eq i32 %i.next, %n
+    br i1 %done, label %exit, label %loop
+
+  exit:
+    ret i32 %s.next
+  }
+
+  define i32 @cold_sum(i32* %p, i32 %n) !prof !15 {
+  entry:
+    br label %loop
+
+  loop:
+    %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+    %i.next = add i32 %i, 1
+    %done = icmp eq i32 %i.next, %n
+    br i1 %done, label %exit, label %loop
+
+  exit:
+    ret i32 %i.next
+  }
+
+  define i32 @hot_no_loop(i32 %x) !prof !14 {
+    ret i32 %x
+  }
+
+  define i32 @caller(i32* %p) !prof !14 {
+    %r = call i32 @sum(i32* %p, i32 16)
+    ret i32 %r
+  }
+
+  !llvm.module.flags = !{!0}
+
+  !0 = !{i32 1, !"ProfileSummary", !1}
+  !1 = !{!2, !3, !4, !5, !6, !7, !8, !9}
+  !2 = !{!"ProfileFormat", !"InstrProf"}
+  !3 = !{!"TotalCount", i64 10000}
+  !4 = !{!"MaxCount", i64 10}
+  !5 = !{!"MaxInternalCount", i64 1}
+  !6 = !{!"MaxFunctionCount", i64 1000}
+  !7 = !{!"NumCounts", i64 3}
+  !8 = !{!"NumFunctions", i64 3}
+  !9 = !{!"DetailedSummary", !10}
+  !10 = !{!11, !12, !13}
+  !11 = !{i32 10000, i64 1000, i32 1}
+  !12 = !{i32 999000, i64 300, i32 3}
+  !13 = !{i32 999999, i64 5, i32 10}
+  !14 = !{!"function_entry_count", i64 1000}
+  !15 = !{!"function_entry_count", i64 1}
+)IR";
+
+TEST(HotFunctionMultiVersioning, HotFunctionIsClonedAndDispatched) {
+  LLVMContext Ctx;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(IR, Err, Ctx);
+  ASSERT_TRUE(M);
+
+  ModuleAnalysisManager MAM;
+  MAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+  MAM.registerPass([&] { return ProfileSummaryAnalysis(); });
+  ModulePassManager MPM;
+  MPM.addPass(HotFunctionMultiVersioningPass());
+  MPM.run(*M, MAM);
+  EXPECT_FALSE(verifyModule(*M, &errs()));
+
+  // Only the hot function with a loop is multiversioned.
+  EXPECT_EQ(nullptr, M->getFunction("cold_sum.default"));
+  EXPECT_EQ(nullptr, M->getFunction("hot_no_loop.default"));
+  EXPECT_EQ(nullptr, M->getFunction("caller.default"));
+
+  // @sum is now an ifunc, and the original body is the default version.
+  GlobalIFunc *IFunc = M->getNamedIFunc("sum");
+  ASSERT_NE(nullptr, IFunc);
+  EXPECT_TRUE(IFunc->hasExternalLinkage());
+  Function *Default = M->getFunction("sum.default");
+  Function *AVX512 = M->getFunction("sum.avx512");
+  Function *AVX2 = M->getFunction("sum.avx2");
+  ASSERT_NE(nullptr, Default);
+  ASSERT_NE(nullptr, AVX512);
+  ASSERT_NE(nullptr, AVX2);
+  for (Function *F : {Default, AVX512, AVX2})
+    EXPECT_TRUE(F->hasLocalLinkage());
+  EXPECT_TRUE(AVX512->getFnAttribute("target-features")
+                  .getValueAsString()
+                  .contains("+avx512f"));
+  EXPECT_TRUE(
+      AVX2->getFnAttribute("target-features").getValueAsString().contains(
+          "+avx2"));
+  EXPECT_FALSE(Default->hasFnAttribute("target-features"));
+
+  // Callers go through the ifunc.
+  auto *Call = cast<CallInst>(&M->getFunction("caller")->front().front());
+  EXPECT_EQ(IFunc, Call->getCalledOperand());
+
+  // The resolver returns the most capable version first, and the default
+  // version last.
+  auto *Resolver = dyn_cast<Function>(IFunc->getResolver());
+  ASSERT_NE(nullptr, Resolver);
+  EXPECT_NE(nullptr, M->getFunction("__cpu_indicator_init"));
+  SmallVector<Value *, 3> Returned;
+  for (BasicBlock &BB : *Resolver)
+    if (auto *Ret = dyn_cast<ReturnInst>(BB.getTerminator()))
+      Returned.push_back(Ret->getReturnValue()->stripPointerCasts());
+  ASSERT_EQ(3u, Returned.size());
+  EXPECT_EQ(AVX512, Returned[0]);
+  EXPECT_EQ(AVX2, Returned[1]);
+  EXPECT_EQ(Default, Returned[2]);
+}
+
+} // end anonymous namespace
@@ -23,16 +23,16 @@ struct TestFunction {
   Instruction *I;
   Type *T;
 
-  TestFunction(LLVMContext &Ctx, Module &M, int addVal) {
+  TestFunction(LLVMContext &Ctx, Module &M, int addVal, unsigned Bits = 8) {
     IRBuilder<> B(Ctx);
-    T = B.getInt8Ty();
-    F = Function::Create(FunctionType::get(T, {B.getInt8PtrTy()}, false),
+    T = B.getIntNTy(Bits);
+    F = Function::Create(FunctionType::get(T, {T->getPointerTo()}, false),
                          GlobalValue::ExternalLinkage, "F", &M);
     BB = BasicBlock::Create(Ctx, "", F);
     B.SetInsertPoint(BB);
     Argument *PointerArg = &*F->arg_begin();
     LoadInst *LoadInst = B.CreateLoad(T, PointerArg);
-    C = B.getInt8(addVal);
+    C = ConstantInt::get(T, addVal);
     I = cast<Instruction>(B.CreateAdd(LoadInst, C));
     B.CreateRet(I);
   }
@@ -127,3 +127,30 @@ TEST(FunctionComparatorTest, TestAPI) {
   EXPECT_EQ(Cmp.testCmpTypes(F1.T, F2.T), 0);
   EXPECT_EQ(Cmp.testCmpPrimitives(), -4);
 }
+
+TEST(FunctionComparatorTest, Hash) {
+  using FunctionHash = FunctionComparator::FunctionHash;
+  LLVMContext C;
+  Module M("test", C);
+  TestFunction F8(C, M, 27);
+  TestFunction F8Same(C, M, 27);
+  TestFunction F8Other(C, M, 28);
+  TestFunction F16(C, M, 27, /*Bits=*/16);
+
+  // Equal functions hash alike, with or without their constants.
+  EXPECT_EQ(FunctionComparator::functionHash(*F8.F),
+            FunctionComparator::functionHash(*F8Same.F));
+  EXPECT_EQ(FunctionComparator::functionHash(*F8.F, /*HashConstants=*/true),
+            FunctionComparator::functionHash(*F8Same.F,
+                                             /*HashConstants=*/true));
+
+  // Functions that only differ in their constants hash alike by default.
+  FunctionHash H8 = FunctionComparator::functionHash(*F8.F);
+  EXPECT_EQ(H8, FunctionComparator::functionHash(*F8Other.F));
+  EXPECT_NE(FunctionComparator::functionHash(*F8.F, /*HashConstants=*/true),
+            FunctionComparator::functionHash(*F8Other.F,
+                                             /*HashConstants=*/true));
+
+  // The same opcodes on other types used to collide.
+  EXPECT_NE(H8, FunctionComparator::functionHash(*F16.F));
+}
@@ -0,0 +1,101 @@
+//===- SplitModuleTest.cpp - Unit tests for SplitModule -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/Utils/SplitModule.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+static std::unique_ptr<Module> parseIR(LLVMContext &C, const char *IR) {
+  SMDiagnostic Err;
+  std::unique_ptr<Module> Mod = parseAssemblyString(IR, Err, C);
+  if (!Mod)
+    Err.print("SplitModuleTests", errs());
+  return Mod;
+}
+
+static const char *AffinityIR = R"IR(
+define i32 @a(i32 %p) {
+  %r = call i32 @b(i32 %p)
+  ret i32 %r
+}
+
+define i32 @b(i32 %p) {
+  %r = add i32 %p, 1
+  ret i32 %r
+}
+
+define i32 @c(i32 %p) {
+  %r = call i32 @d(i32 %p)
+  ret i32 %r
+}
+
+define i32 @d(i32 %p) {
+  %r = add i32 %p, 2
+  ret i32 %r
+}
+
+define i32 @big1(i32 %p) {
+  %x1 = add i32 %p, 1
+  %x2 = mul i32 %x1, 3
+  %x3 = add i32 %x2, 5
+  %x4 = mul i32 %x3, 7
+  %x5 = add i32 %x4, 11
+  %x6 = mul i32 %x5, 13
+  %x7 = add i32 %x6, 17
+  %x8 = mul i32 %x7, 19
+  %x9 = add i32 %x8, 23
+  %x10 = mul i32 %x9, 29
+  ret i32 %x10
+}
+
+define i32 @big2(i32 %p) {
+  %x1 = add i32 %p, 1
+  %x2 = mul i32 %x1, 3
+  %x3 = add i32 %x2, 5
+  %x4 = mul i32 %x3, 7
+  %x5 = add i32 %x4, 11
+  %x6 = mul i32 %x5, 13
+  %x7 = add i32 %x6, 17
+  %x8 = mul i32 %x7, 19
+  %x9 = add i32 %x8, 23
+  %x10 = mul i32 %x9, 29
+  ret i32 %x10
+}
+)IR";
+
+static bool definesFunction(const Module &M, StringRef Name) {
+  const Function *F = M.getFunction(Name);
+  return F && !F->isDeclaration();
+}
+
+TEST(SplitModuleTest, ClusterByAffinity) {
+  LLVMContext C;
+  std::unique_ptr<Module> M = parseIR(C, AffinityIR);
+  ASSERT_TRUE(M);
+
+  std::vector<std::unique_ptr<Module>> Parts;
+  SplitModule(
+      std::move(M), 2,
+      [&](std::unique_ptr<Module> MPart) { Parts.push_back(std::move(MPart)); },
+      /*PreserveLocals=*/false, /*ClusterByAffinity=*/true);
+  ASSERT_EQ(2u, Parts.size());
+
+  for (const std::unique_ptr<Module> &Part : Parts) {
+    // Callers and callees stay together.
+    EXPECT_EQ(definesFunction(*Part, "a"), definesFunction(*Part, "b"));
+    EXPECT_EQ(definesFunction(*Part, "c"), definesFunction(*Part, "d"));
+    // The two large functions are balanced across the partitions.
+    EXPECT_NE(definesFunction(*Part, "big1"), definesFunction(*Part, "big2"));
+  }
+  EXPECT_NE(definesFunction(*Parts[0], "a"), definesFunction(*Parts[1], "a"));
+}
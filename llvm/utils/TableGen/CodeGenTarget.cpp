@@ -478,6 +478,10 @@ bool CodeGenTarget::isLittleEndianEncoding() const {
 void CodeGenTarget::reverseBitsForLittleEndianEncoding() {
   if (!isLittleEndianEncoding())
     return;
+  // Both the code emitter and the disassembler reverse the bits, and they may
+  // run on the same records.
+  if (!Records.startRewrite("reverse-bits-for-little-endian-encoding"))
+    return;
 
   std::vector<Record *> Insts =
       Records.getAllDerivedDefinitions("InstructionEncoding");
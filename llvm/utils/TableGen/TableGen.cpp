@@ -140,7 +140,14 @@ cl::opt<bool, true>
                    cl::desc("Time regions of tablegens execution"),
                    cl::location(TimeRegions));
 
-bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
+cl::list<std::string> EmitOutputs(
+    "emit",
+    cl::desc("Run the backend for <action> and write its output to <file>. "
+             "Can be given several times to produce several files from a "
+             "single parse of the input, instead of an action and -o"),
+    cl::value_desc("action=file"));
+
+bool runAction(ActionType Action, raw_ostream &OS, RecordKeeper &Records) {
   switch (Action) {
   case PrintRecords:
     OS << Records;           // No argument, dump all contents
@@ -257,8 +264,38 @@ bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
 
   return false;
 }
+
+bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
+  return runAction(Action, OS, Records);
 }
 
+/// Turn each -emit option into an output, or return true on error.
+bool getEmitOutputs(std::vector<TableGenOutput> &Outputs) {
+  if (Action.getNumOccurrences()) {
+    errs() << "error: an action cannot be combined with -emit\n";
+    return true;
+  }
+  for (StringRef Emit : EmitOutputs) {
+    StringRef Name, Filename;
+    std::tie(Name, Filename) = Emit.split('=');
+    if (Filename.empty()) {
+      errs() << "error: expected -emit=<action>=<file>, got '" << Emit
+             << "'\n";
+      return true;
+    }
+    // Look the action up by the same name as its command line flag.
+    ActionType EmitAction;
+    if (Action.getParser().parse(Action, Name, "", EmitAction))
+      return true;
+    Outputs.push_back({std::string(Filename), std::string(Name),
+                       [EmitAction](raw_ostream &OS, RecordKeeper &Records) {
+                         return runAction(EmitAction, OS, Records);
+                       }});
+  }
+  return false;
+}
+} // end anonymous namespace
+
 int main(int argc, char **argv) {
   sys::PrintStackTraceOnErrorSignal(argv[0]);
   PrettyStackTraceProgram X(argc, argv);
@@ -266,6 +303,12 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
+  if (!EmitOutputs.empty()) {
+    std::vector<TableGenOutput> Outputs;
+    if (getEmitOutputs(Outputs))
+      return 1;
+    return TableGenMain(argv[0], Outputs);
+  }
   return TableGenMain(argv[0], &LLVMTableGenMain);
 }
 
@@ -16,11 +16,13 @@
 #include "mlir/Support/LLVM.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/Error.h"
 
 #include <functional>
 #include <memory>
+#include <mutex>
 
 namespace llvm {
 template <typename T> class Expected;
@@ -45,6 +47,7 @@ public:
   void dumpToObjectFile(StringRef filename);
 
 private:
+  std::mutex cachedObjectsMutex;
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cachedObjects;
 };
 
@@ -71,13 +74,21 @@ public:
   /// resolution. If `enableObjectCache` is set, the JIT compiler will create
   /// one to store the object generated for the given module. If enable
   // `enableGDBNotificationListener` is set, the JIT compiler will notify
-  /// the llvm's global GDB notification listener.
+  /// the llvm's global GDB notification listener. If `objectCacheDir` is
+  /// provided, the objects are also cached in that directory, keyed by the
+  /// contents of the module and the target, and are reused by later engines
+  /// and processes instead of being compiled again. If `numCompileThreads` is
+  /// greater than one, the module is split into that many independent parts
+  /// that are transformed and compiled concurrently, so `transformer` must be
+  /// safe to call from several threads at once; in particular, it must not
+  /// share a TargetMachine between calls.
   static llvm::Expected<std::unique_ptr<ExecutionEngine>>
   create(ModuleOp m,
          std::function<llvm::Error(llvm::Module *)> transformer = {},
          Optional<llvm::CodeGenOpt::Level> jitCodeGenOptLevel = llvm::None,
          ArrayRef<StringRef> sharedLibPaths = {}, bool enableObjectCache = true,
-         bool enableGDBNotificationListener = true);
+         bool enableGDBNotificationListener = true,
+         StringRef objectCacheDir = "", unsigned numCompileThreads = 0);
 
   /// Looks up a packed-argument function with the given name and returns a
   /// pointer to it.  Propagates errors in case of failure.
@@ -98,7 +109,8 @@ public:
   /// the engine.
   static bool setupTargetTriple(llvm::Module *llvmModule);
 
-  /// Dump object code to output file `filename`.
+  /// Dump object code to output file `filename`. This is only supported when
+  /// the module is compiled as a single part.
   void dumpToObjectFile(StringRef filename);
 
 private:
@@ -112,6 +124,10 @@ private:
   /// Underlying cache.
   std::unique_ptr<SimpleObjectCache> cache;
 
+  /// Persistent cache, if a cache directory was provided. This takes
+  /// precedence over the in-memory cache.
+  std::unique_ptr<llvm::orc::OnDiskObjectCache> diskCache;
+
   /// GDB notification listener.
   llvm::JITEventListener *gdbListener;
 };
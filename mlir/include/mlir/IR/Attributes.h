@@ -739,6 +739,15 @@ public:
                                             ArrayRef<char> rawBuffer,
                                             bool isSplatBuffer);
 
+  /// Construct a dense elements attribute that references, instead of copies,
+  /// a raw buffer owned by the caller, e.g. a memory mapped file of model
+  /// weights. The buffer must have the format expected by 'getFromRawBuffer'
+  /// for a non-splat value and must outlive the context. Such attributes are
+  /// uniqued by the identity of the buffer rather than by its contents, so
+  /// the buffer is never hashed or scanned.
+  static DenseElementsAttr getFromUnownedBuffer(ShapedType type,
+                                                ArrayRef<char> rawBuffer);
+
   //===--------------------------------------------------------------------===//
   // Iterators
   //===--------------------------------------------------------------------===//
@@ -835,6 +844,10 @@ public:
   /// values are the same.
   bool isSplat() const;
 
+  /// Returns if the data of this attribute is owned by the user, i.e. it was
+  /// created with 'getFromUnownedBuffer'.
+  bool isUnowned() const;
+
   /// Return the splat value for this attribute. This asserts that the attribute
   /// corresponds to a splat.
   Attribute getSplatValue() const { return getSplatValue<Attribute>(); }
@@ -977,9 +990,10 @@ protected:
   static DenseElementsAttr getRaw(ShapedType type, ArrayRef<APInt> values);
 
   /// Get or create a new dense elements attribute instance with the given raw
-  /// data buffer. 'type' must be a vector or tensor with static shape.
+  /// data buffer. 'type' must be a vector or tensor with static shape. If
+  /// 'isUnowned' is true, the buffer is referenced instead of copied.
   static DenseElementsAttr getRaw(ShapedType type, ArrayRef<char> data,
-                                  bool isSplat);
+                                  bool isSplat, bool isUnowned = false);
 
   /// Overload of the raw 'get' method that asserts that the given type is of
   /// integer or floating-point type. This method is used to verify type
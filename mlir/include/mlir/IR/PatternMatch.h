@@ -429,8 +429,9 @@ private:
   void operator=(const RewritePatternMatcher &) = delete;
 
   /// The group of patterns that are matched for optimization through this
-  /// matcher.
-  std::vector<RewritePattern *> patterns;
+  /// matcher, indexed by the name of their root operation and sorted by
+  /// decreasing benefit. Patterns that are impossible to match are dropped.
+  DenseMap<OperationName, SmallVector<RewritePattern *, 2>> patterns;
 };
 
 /// Rewrite the regions of the specified operation, which must be isolated from
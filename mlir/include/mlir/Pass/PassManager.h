@@ -236,6 +236,18 @@ public:
   /// unintentionally included in the timing results.
   void enableTiming(PassDisplayMode displayMode = PassDisplayMode::Pipeline);
 
+  //===--------------------------------------------------------------------===//
+  // Pass Tracing
+
+  /// Add an instrumentation that records each pass execution on a per-thread
+  /// timeline, along with the number of operations before and after the pass
+  /// and the change in heap usage across it. The trace is written in the
+  /// Chrome trace event format to 'outputFile' when the pass manager is
+  /// destroyed.
+  /// Note: The heap usage is process wide, so the deltas of passes running
+  /// concurrently on different threads include each other's allocations.
+  void enableTracing(StringRef outputFile);
+
   /// Prompts the pass manager to print the statistics collected for each of the
   /// held passes after each call to 'run'.
   void
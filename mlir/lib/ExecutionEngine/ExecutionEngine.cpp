@@ -33,6 +33,7 @@
 #include "llvm/Support/Host.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 
 #define DEBUG_TYPE "execution-engine"
 
@@ -49,9 +50,11 @@ using llvm::SectionMemoryManager;
 using llvm::StringError;
 using llvm::Triple;
 using llvm::orc::DynamicLibrarySearchGenerator;
+using llvm::orc::ConcurrentIRCompiler;
 using llvm::orc::ExecutionSession;
 using llvm::orc::IRCompileLayer;
 using llvm::orc::JITTargetMachineBuilder;
+using llvm::orc::OnDiskObjectCache;
 using llvm::orc::RTDyldObjectLinkingLayer;
 using llvm::orc::ThreadSafeModule;
 using llvm::orc::TMOwningSimpleCompiler;
@@ -64,11 +67,13 @@ static Error make_string_error(const Twine &message) {
 
 void SimpleObjectCache::notifyObjectCompiled(const Module *M,
                                              MemoryBufferRef ObjBuffer) {
+  std::lock_guard<std::mutex> lock(cachedObjectsMutex);
   cachedObjects[M->getModuleIdentifier()] = MemoryBuffer::getMemBufferCopy(
       ObjBuffer.getBuffer(), ObjBuffer.getBufferIdentifier());
 }
 
 std::unique_ptr<MemoryBuffer> SimpleObjectCache::getObject(const Module *M) {
+  std::lock_guard<std::mutex> lock(cachedObjectsMutex);
   auto I = cachedObjects.find(M->getModuleIdentifier());
   if (I == cachedObjects.end()) {
     LLVM_DEBUG(dbgs() << "No object for " << M->getModuleIdentifier()
@@ -90,13 +95,20 @@ void SimpleObjectCache::dumpToObjectFile(StringRef outputFilename) {
   }
 
   // Dump the object generated for a single module to the output file.
-  assert(cachedObjects.size() == 1 && "Expected only one object entry.");
+  if (cachedObjects.size() != 1) {
+    llvm::errs() << "expected exactly one object in the cache\n";
+    return;
+  }
   auto &cachedObject = cachedObjects.begin()->second;
   file->os() << cachedObject->getBuffer();
   file->keep();
 }
 
 void ExecutionEngine::dumpToObjectFile(StringRef filename) {
+  if (!cache) {
+    llvm::errs() << "cannot dump object file without the in-memory cache\n";
+    return;
+  }
   cache->dumpToObjectFile(filename);
 }
 
@@ -194,7 +206,8 @@ Expected<std::unique_ptr<ExecutionEngine>> ExecutionEngine::create(
     ModuleOp m, std::function<Error(llvm::Module *)> transformer,
     Optional<llvm::CodeGenOpt::Level> jitCodeGenOptLevel,
     ArrayRef<StringRef> sharedLibPaths, bool enableObjectCache,
-    bool enableGDBNotificationListener) {
+    bool enableGDBNotificationListener, StringRef objectCacheDir,
+    unsigned numCompileThreads) {
   auto engine = std::make_unique<ExecutionEngine>(
       enableObjectCache, enableGDBNotificationListener);
 
@@ -269,26 +282,98 @@ Expected<std::unique_ptr<ExecutionEngine>> ExecutionEngine::create(
       -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
     if (jitCodeGenOptLevel)
       JTMB.setCodeGenOptLevel(jitCodeGenOptLevel.getValue());
+
+    // The persistent cache is keyed by the configuration of the target
+    // machine, so it can only be created once that is known.
+    llvm::ObjectCache *objectCache = engine->cache.get();
+    if (!objectCacheDir.empty()) {
+      auto diskCache = OnDiskObjectCache::Create(objectCacheDir, JTMB);
+      if (!diskCache)
+        return diskCache.takeError();
+      engine->diskCache = std::move(*diskCache);
+      objectCache = engine->diskCache.get();
+    }
+
+    // A target machine can't be shared by concurrent compilations.
+    if (numCompileThreads > 1)
+      return std::make_unique<ConcurrentIRCompiler>(std::move(JTMB),
+                                                    objectCache);
+
     auto TM = JTMB.createTargetMachine();
     if (!TM)
       return TM.takeError();
     return std::make_unique<TMOwningSimpleCompiler>(std::move(*TM),
-                                                    engine->cache.get());
+                                                    objectCache);
   };
 
   // Create the LLJIT by calling the LLJITBuilder with 2 callbacks.
-  auto jit =
-      cantFail(llvm::orc::LLJITBuilder()
-                   .setCompileFunctionCreator(compileFunctionCreator)
-                   .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
-                   .create());
-
-  // Add a ThreadSafemodule to the engine and return.
-  ThreadSafeModule tsm(std::move(deserModule), std::move(ctx));
-  if (transformer)
-    cantFail(tsm.withModuleDo(
-        [&](llvm::Module &module) { return transformer(&module); }));
-  cantFail(jit->addIRModule(std::move(tsm)));
+  auto expectedJIT =
+      llvm::orc::LLJITBuilder()
+          .setCompileFunctionCreator(compileFunctionCreator)
+          .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
+          .setNumCompileThreads(numCompileThreads > 1 ? numCompileThreads : 0)
+          .create();
+  if (!expectedJIT)
+    return expectedJIT.takeError();
+  auto jit = std::move(*expectedJIT);
+
+  // Split the module into independent parts so that each of them can be
+  // transformed and compiled on its own thread. Each part gets its own context
+  // as the compilation of a module holds the lock of its context.
+  std::vector<ThreadSafeModule> parts;
+  if (numCompileThreads > 1) {
+    Error splitErr = Error::success();
+    unsigned partIndex = 0;
+    llvm::SplitModule(
+        std::move(deserModule), numCompileThreads,
+        [&](std::unique_ptr<Module> part) {
+          if (splitErr)
+            return;
+          // The in-memory cache identifies objects by module name.
+          part->setModuleIdentifier(
+              (part->getModuleIdentifier() + "." + Twine(partIndex++)).str());
+          SmallVector<char, 1> partBuffer;
+          {
+            llvm::raw_svector_ostream os(partBuffer);
+            WriteBitcodeToFile(*part, os);
+          }
+          auto partCtx = std::make_unique<llvm::LLVMContext>();
+          auto partModule = parseBitcodeFile(
+              MemoryBufferRef(StringRef(partBuffer.data(), partBuffer.size()),
+                              part->getModuleIdentifier()),
+              *partCtx);
+          if (!partModule) {
+            splitErr = partModule.takeError();
+            return;
+          }
+          parts.emplace_back(std::move(*partModule), std::move(partCtx));
+        });
+    if (splitErr)
+      return std::move(splitErr);
+  } else {
+    parts.emplace_back(std::move(deserModule), std::move(ctx));
+  }
+
+  // Add the ThreadSafeModules to the engine and return. When compiling
+  // concurrently, the transformer is applied to each part on the thread that
+  // compiles it.
+  if (transformer && parts.size() > 1) {
+    jit->getIRTransformLayer().setTransform(
+        [transformer](ThreadSafeModule tsm,
+                      llvm::orc::MaterializationResponsibility &)
+            -> Expected<ThreadSafeModule> {
+          if (Error err = tsm.withModuleDo(
+                  [&](llvm::Module &module) { return transformer(&module); }))
+            return std::move(err);
+          return std::move(tsm);
+        });
+  }
+  for (ThreadSafeModule &tsm : parts) {
+    if (transformer && parts.size() == 1)
+      cantFail(tsm.withModuleDo(
+          [&](llvm::Module &module) { return transformer(&module); }));
+    cantFail(jit->addIRModule(std::move(tsm)));
+  }
   engine->jit = std::move(jit);
 
   // Resolve symbols that are statically linked in the current process.
@@ -1230,6 +1230,25 @@ static void printSymbolReference(StringRef symbolRef, raw_ostream &os) {
   os << '"';
 }
 
+/// Print the given data as a quoted hex string, e.g. "0xDEADBEEF". The data
+/// is converted in chunks, so that large constants aren't first rendered into
+/// a string twice their size.
+static void printHexString(ArrayRef<char> data, raw_ostream &os) {
+  os << "\"0x";
+  char buffer[4096];
+  while (!data.empty()) {
+    ArrayRef<char> chunk = data.take_front(sizeof(buffer) / 2);
+    data = data.drop_front(chunk.size());
+    char *out = buffer;
+    for (char c : chunk) {
+      *out++ = llvm::hexdigit(static_cast<unsigned char>(c) >> 4);
+      *out++ = llvm::hexdigit(static_cast<unsigned char>(c) & 0xF);
+    }
+    os.write(buffer, out - buffer);
+  }
+  os << '"';
+}
+
 // Print out a valid ElementsAttr that is succinct and can represent any
 // potential shape/type, for use when eliding a large ElementsAttr.
 //
@@ -1351,7 +1370,10 @@ void ModulePrinter::printAttribute(Attribute attr,
       break;
     }
     os << "opaque<\"" << eltsAttr.getDialect()->getNamespace() << "\", ";
-    os << '"' << "0x" << llvm::toHex(eltsAttr.getValue()) << "\">";
+    printHexString(ArrayRef<char>(eltsAttr.getValue().data(),
+                                  eltsAttr.getValue().size()),
+                   os);
+    os << '>';
     break;
   }
   case StandardAttributes::DenseElements: {
@@ -1447,9 +1469,7 @@ void ModulePrinter::printDenseElementsAttr(DenseElementsAttr attr,
   // Check to see if we should format this attribute as a hex string.
   if (allowHex && printElementsAttrWithHexIfLarger != -1 &&
       numElements > printElementsAttrWithHexIfLarger) {
-    ArrayRef<char> rawData = attr.getRawData();
-    os << '"' << "0x" << llvm::toHex(StringRef(rawData.data(), rawData.size()))
-       << "\"";
+    printHexString(attr.getRawData(), os);
     return;
   }
 
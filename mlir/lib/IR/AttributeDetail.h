@@ -376,8 +376,9 @@ struct TypeAttributeStorage : public AttributeStorage {
 struct DenseElementsAttributeStorage : public AttributeStorage {
   struct KeyTy {
     KeyTy(ShapedType type, ArrayRef<char> data, llvm::hash_code hashCode,
-          bool isSplat = false)
-        : type(type), data(data), hashCode(hashCode), isSplat(isSplat) {}
+          bool isSplat = false, bool isUnowned = false)
+        : type(type), data(data), hashCode(hashCode), isSplat(isSplat),
+          isUnowned(isUnowned) {}
 
     /// The type of the dense elements.
     ShapedType type;
@@ -390,17 +391,26 @@ struct DenseElementsAttributeStorage : public AttributeStorage {
 
     /// A boolean that indicates if this data is a splat or not.
     bool isSplat;
+
+    /// A boolean that indicates if the data is owned by the user, in which
+    /// case it is referenced by identity instead of being copied and hashed.
+    bool isUnowned;
   };
 
   DenseElementsAttributeStorage(ShapedType ty, ArrayRef<char> data,
-                                bool isSplat = false)
-      : AttributeStorage(ty), data(data), isSplat(isSplat) {}
+                                bool isSplat = false, bool isUnowned = false)
+      : AttributeStorage(ty), data(data), isSplat(isSplat),
+        isUnowned(isUnowned) {}
 
   /// Compare this storage instance with the provided key.
   bool operator==(const KeyTy &key) const {
-    if (key.type != getType())
+    if (key.type != getType() || key.isUnowned != isUnowned)
       return false;
 
+    // Unowned data is uniqued by the identity of the buffer.
+    if (isUnowned)
+      return key.data.data() == data.data() && key.data.size() == data.size();
+
     // For boolean splats we need to explicitly check that the first bit is the
     // same. Boolean values are packed at the bit level, and even though a splat
     // is detected the rest of the bits in the first byte may differ from the
@@ -420,11 +430,19 @@ struct DenseElementsAttributeStorage : public AttributeStorage {
   /// signals if the data is already known to be a splat. Callers to this
   /// function are expected to tag preknown splat values when possible, e.g. one
   /// element shapes.
-  static KeyTy getKey(ShapedType ty, ArrayRef<char> data, bool isKnownSplat) {
+  static KeyTy getKey(ShapedType ty, ArrayRef<char> data, bool isKnownSplat,
+                      bool isUnowned) {
     // Handle an empty storage instance.
     if (data.empty())
       return KeyTy(ty, data, 0);
 
+    // Unowned buffers may be very large, e.g. memory mapped model weights, so
+    // only hash the location of the buffer and never scan the contents.
+    if (isUnowned)
+      return KeyTy(ty, data,
+                   llvm::hash_combine(data.data(), data.size(), isKnownSplat),
+                   isKnownSplat, /*isUnowned=*/true);
+
     // If the data is already known to be a splat, the key hash value is
     // directly the data buffer.
     if (isKnownSplat)
@@ -508,6 +526,12 @@ struct DenseElementsAttributeStorage : public AttributeStorage {
   /// Construct a new storage instance.
   static DenseElementsAttributeStorage *
   construct(AttributeStorageAllocator &allocator, KeyTy key) {
+    // Unowned data is referenced directly.
+    if (key.isUnowned)
+      return new (allocator.allocate<DenseElementsAttributeStorage>())
+          DenseElementsAttributeStorage(key.type, key.data, key.isSplat,
+                                        /*isUnowned=*/true);
+
     // If the data buffer is non-empty, we copy it into the allocator with a
     // 64-bit alignment.
     ArrayRef<char> copy, data = key.data;
@@ -528,6 +552,7 @@ struct DenseElementsAttributeStorage : public AttributeStorage {
 
   ArrayRef<char> data;
   bool isSplat;
+  bool isUnowned;
 };
 
 /// An attribute representing a reference to a tensor constant with opaque
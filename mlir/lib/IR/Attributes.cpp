@@ -689,6 +689,19 @@ DenseElementsAttr DenseElementsAttr::getFromRawBuffer(ShapedType type,
   return getRaw(type, rawBuffer, isSplatBuffer);
 }
 
+DenseElementsAttr
+DenseElementsAttr::getFromUnownedBuffer(ShapedType type,
+                                        ArrayRef<char> rawBuffer) {
+  size_t storageWidth = getDenseElementStorageWidth(
+      getDenseElementBitwidth(type.getElementType()));
+  (void)storageWidth;
+  assert(rawBuffer.size() ==
+             llvm::divideCeil(storageWidth * type.getNumElements(), CHAR_BIT) &&
+         "buffer does not hold the expected number of elements");
+  return getRaw(type, rawBuffer, /*isSplat=*/type.getNumElements() == 1,
+                /*isUnowned=*/true);
+}
+
 /// Constructs a dense elements attribute from an array of raw APInt values.
 /// Each APInt value is expected to have the same bitwidth as the element type
 /// of 'type'.
@@ -708,12 +721,13 @@ DenseElementsAttr DenseElementsAttr::getRaw(ShapedType type,
 }
 
 DenseElementsAttr DenseElementsAttr::getRaw(ShapedType type,
-                                            ArrayRef<char> data, bool isSplat) {
+                                            ArrayRef<char> data, bool isSplat,
+                                            bool isUnowned) {
   assert((type.isa<RankedTensorType>() || type.isa<VectorType>()) &&
          "type must be ranked tensor or vector");
   assert(type.hasStaticShape() && "type must have static shape");
   return Base::get(type.getContext(), StandardAttributes::DenseElements, type,
-                   data, isSplat);
+                   data, isSplat, isUnowned);
 }
 
 /// Check the information for a C++ data type, check if this type is valid for
@@ -766,6 +780,8 @@ bool DenseElementsAttr::isValidIntOrFloat(int64_t dataEltSize, bool isInt,
 /// values are the same.
 bool DenseElementsAttr::isSplat() const { return getImpl()->isSplat; }
 
+bool DenseElementsAttr::isUnowned() const { return getImpl()->isUnowned; }
+
 /// Return the held element values as a range of Attributes.
 auto DenseElementsAttr::getAttributeValues() const
     -> llvm::iterator_range<AttributeElementIterator> {
@@ -843,7 +859,7 @@ DenseElementsAttr DenseElementsAttr::reshape(ShapedType newType) {
          "expected the same element type");
   assert(newType.getNumElements() == curType.getNumElements() &&
          "expected the same number of elements");
-  return getRaw(newType, getRawData(), isSplat());
+  return getRaw(newType, getRawData(), isSplat(), isUnowned());
 }
 
 DenseElementsAttr
@@ -24,6 +24,7 @@
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include <numeric>
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -432,7 +433,27 @@ void OpToOpPassAdaptorParallel::runOnOperation() {
   // ordering.
   ParallelDiagnosticHandler diagHandler(&getContext());
 
-  // An index for the current operation/analysis manager pair.
+  // The order in which to process the operations. If there are more operations
+  // than executors, start with the largest ones so that a single large
+  // operation picked up last doesn't leave the other executors idle while it
+  // runs on its own.
+  std::vector<unsigned> opOrder(opAMPairs.size());
+  std::iota(opOrder.begin(), opOrder.end(), 0);
+  if (opAMPairs.size() > asyncExecutors.size()) {
+    std::vector<size_t> opSizes;
+    opSizes.reserve(opAMPairs.size());
+    for (auto &it : opAMPairs) {
+      size_t numOps = 0;
+      it.first->walk([&](Operation *) { ++numOps; });
+      opSizes.push_back(numOps);
+    }
+    std::stable_sort(opOrder.begin(), opOrder.end(),
+                     [&](unsigned lhs, unsigned rhs) {
+                       return opSizes[lhs] > opSizes[rhs];
+                     });
+  }
+
+  // An index into opOrder for the next operation/analysis manager pair.
   std::atomic<unsigned> opIt(0);
 
   // Get the current thread for this adaptor.
@@ -449,9 +470,10 @@ void OpToOpPassAdaptorParallel::runOnOperation() {
       [&](MutableArrayRef<OpPassManager> pms) {
         for (auto e = opAMPairs.size(); !passFailed && opIt < e;) {
           // Get the next available operation index.
-          unsigned nextID = opIt++;
-          if (nextID >= e)
+          unsigned nextIt = opIt++;
+          if (nextIt >= e)
             break;
+          unsigned nextID = opOrder[nextIt];
 
           // Set the order id for this thread in the diagnostic handler.
           diagHandler.setOrderIDForThread(nextID);
@@ -93,6 +93,14 @@ struct PassManagerOptions {
 
   /// Add a pass timing instrumentation if enabled by 'pass-timing' flags.
   void addTimingInstrumentation(PassManager &pm);
+
+  //===--------------------------------------------------------------------===//
+  // Pass Tracing
+  //===--------------------------------------------------------------------===//
+  llvm::cl::opt<std::string> passTraceFile{
+      "pass-trace-file",
+      llvm::cl::desc("Write a Chrome trace of the executed passes, with "
+                     "operation counts and heap usage, to the given file")};
 };
 } // end anonymous namespace
 
@@ -166,6 +174,10 @@ void mlir::applyPassManagerCLOptions(PassManager &pm) {
   // Add the IR printing instrumentation.
   (*options)->addPrinterInstrumentation(pm);
 
+  // Add the pass tracing instrumentation.
+  if ((*options)->passTraceFile.getNumOccurrences())
+    pm.enableTracing((*options)->passTraceFile);
+
   // Note: The pass timing instrumentation should be added last to avoid any
   // potential "ghost" timing from other instrumentations being unintentionally
   // included in the timing results.
@@ -0,0 +1,169 @@
+//===- PassTracing.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements an instrumentation that records the execution of each
+// pass as a Chrome trace event, e.g. for viewing in chrome://tracing. Each
+// event carries the number of operations nested under the operation before and
+// after the pass, as well as the change in heap usage across the pass.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+#include "mlir/Pass/PassManager.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+
+using namespace mlir;
+using namespace mlir::detail;
+
+namespace {
+/// A single completed pass execution.
+struct TraceEvent {
+  std::string passName;
+  std::string opName;
+  uint64_t threadID;
+  std::chrono::microseconds start, duration;
+  size_t opsBefore, opsAfter;
+  int64_t heapDelta;
+  bool failed;
+};
+
+struct PassTracing : public PassInstrumentation {
+  PassTracing(StringRef outputFile)
+      : outputFile(outputFile), startTime(std::chrono::steady_clock::now()) {}
+  ~PassTracing() override { print(); }
+
+  /// Setup the instrumentation hooks. Note that the pass instrumentor already
+  /// serializes the calls to these hooks.
+  void runBeforePass(Pass *pass, Operation *op) override;
+  void runAfterPass(Pass *pass, Operation *op) override {
+    finishPass(pass, op, /*failed=*/false);
+  }
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    finishPass(pass, op, /*failed=*/true);
+  }
+
+  /// Record the end of the last pass started on the current thread.
+  void finishPass(Pass *pass, Operation *op, bool failed);
+
+  /// Write the recorded events to the output file and clear them.
+  void print();
+
+  /// Returns the number of operations nested under, and including, 'op'.
+  static size_t countOps(Operation *op) {
+    size_t numOps = 0;
+    op->walk([&](Operation *) { ++numOps; });
+    return numOps;
+  }
+
+  /// The state of a pass that is currently executing.
+  struct ActivePass {
+    Pass *pass;
+    std::chrono::steady_clock::time_point start;
+    size_t opsBefore;
+    size_t heapBefore;
+  };
+
+  /// The file to write the trace to.
+  std::string outputFile;
+
+  /// The time at which tracing started, all timestamps are relative to it.
+  std::chrono::steady_clock::time_point startTime;
+
+  /// A stack of the passes executing on each thread.
+  DenseMap<uint64_t, SmallVector<ActivePass, 4>> activeThreadPasses;
+
+  /// The events recorded so far.
+  std::vector<TraceEvent> events;
+};
+} // end anonymous namespace
+
+void PassTracing::runBeforePass(Pass *pass, Operation *op) {
+  // Count the operations before taking the snapshot of the heap, so that the
+  // cost of the walk isn't attributed to the pass.
+  size_t opsBefore = countOps(op);
+  activeThreadPasses[llvm::get_threadid()].push_back(
+      {pass, std::chrono::steady_clock::now(), opsBefore,
+       llvm::sys::Process::GetMallocUsage()});
+}
+
+void PassTracing::finishPass(Pass *pass, Operation *op, bool failed) {
+  auto end = std::chrono::steady_clock::now();
+  size_t heapAfter = llvm::sys::Process::GetMallocUsage();
+
+  uint64_t tid = llvm::get_threadid();
+  auto &activePasses = activeThreadPasses[tid];
+  assert(!activePasses.empty() && activePasses.back().pass == pass &&
+         "expected the pass to be active on this thread");
+  ActivePass active = activePasses.pop_back_val();
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  events.push_back(
+      {pass->getName().str(), op->getName().getStringRef().str(), tid,
+       duration_cast<microseconds>(active.start - startTime),
+       duration_cast<microseconds>(end - active.start), active.opsBefore,
+       failed ? active.opsBefore : countOps(op),
+       int64_t(heapAfter) - int64_t(active.heapBefore), failed});
+}
+
+void PassTracing::print() {
+  if (events.empty())
+    return;
+
+  std::error_code ec;
+  llvm::raw_fd_ostream os(outputFile, ec, llvm::sys::fs::OF_Text);
+  if (ec) {
+    llvm::errs() << "could not open pass trace file '" << outputFile
+                 << "': " << ec.message() << "\n";
+    return;
+  }
+
+  llvm::json::OStream json(os);
+  json.object([&] {
+    json.attributeArray("traceEvents", [&] {
+      for (const TraceEvent &event : events) {
+        json.object([&] {
+          json.attribute("name", event.passName);
+          json.attribute("cat", "pass");
+          json.attribute("ph", "X");
+          json.attribute("pid", 1);
+          json.attribute("tid", int64_t(event.threadID));
+          json.attribute("ts", int64_t(event.start.count()));
+          json.attribute("dur", int64_t(event.duration.count()));
+          json.attributeObject("args", [&] {
+            json.attribute("operation", event.opName);
+            json.attribute("ops_before", int64_t(event.opsBefore));
+            json.attribute("ops_after", int64_t(event.opsAfter));
+            json.attribute("heap_delta", event.heapDelta);
+            if (event.failed)
+              json.attribute("failed", true);
+          });
+        });
+      }
+    });
+    json.attribute("displayTimeUnit", "ms");
+  });
+  os << "\n";
+  events.clear();
+}
+
+//===----------------------------------------------------------------------===//
+// PassManager
+//===----------------------------------------------------------------------===//
+
+/// Add an instrumentation to trace the execution of passes.
+void PassManager::enableTracing(StringRef outputFile) {
+  addInstrumentation(std::make_unique<PassTracing>(outputFile));
+}
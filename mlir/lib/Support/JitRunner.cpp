@@ -90,6 +90,17 @@ static llvm::cl::opt<std::string> objectFilename(
     "object-filename",
     llvm::cl::desc("Dump JITted-compiled object to file <input file>.o"));
 
+static llvm::cl::opt<std::string> objectCacheDir(
+    "object-cache-dir",
+    llvm::cl::desc("Cache the JIT-compiled objects in the given directory and "
+                   "reuse them across runs"));
+
+static llvm::cl::opt<unsigned> compileThreads(
+    "compile-threads",
+    llvm::cl::desc("Split the module and compile the parts on this many "
+                   "threads"),
+    llvm::cl::init(0));
+
 static OwningModuleRef parseMLIRInput(StringRef inputFilename,
                                       MLIRContext *context) {
   // Set up the input file.
@@ -136,8 +147,10 @@ compileAndExecute(ModuleOp module, StringRef entryPoint,
     jitCodeGenOptLevel =
         static_cast<llvm::CodeGenOpt::Level>(clOptLevel.getValue());
   SmallVector<StringRef, 4> libs(clSharedLibs.begin(), clSharedLibs.end());
-  auto expectedEngine = mlir::ExecutionEngine::create(module, transformer,
-                                                      jitCodeGenOptLevel, libs);
+  auto expectedEngine = mlir::ExecutionEngine::create(
+      module, transformer, jitCodeGenOptLevel, libs,
+      /*enableObjectCache=*/true, /*enableGDBNotificationListener=*/true,
+      objectCacheDir, compileThreads);
   if (!expectedEngine)
     return expectedEngine.takeError();
 
@@ -250,8 +263,24 @@ int mlir::JitRunnerMain(
     return EXIT_FAILURE;
   }
 
-  auto transformer = mlir::makeLLVMPassesTransformer(
-      passes, optLevel, /*targetMachine=*/tmOrError->get(), optPosition);
+  // With -compile-threads, the transformer runs on every compile thread, and a
+  // target machine can't be shared by concurrent compilations, so each call
+  // creates its own.
+  std::function<llvm::Error(llvm::Module *)> transformer;
+  if (compileThreads > 1) {
+    transformer = [tmBuilder = std::move(*tmBuilderOrError), passes, optLevel,
+                   optPosition](llvm::Module *module) -> Error {
+      llvm::orc::JITTargetMachineBuilder builder = tmBuilder;
+      auto tm = builder.createTargetMachine();
+      if (!tm)
+        return tm.takeError();
+      return mlir::makeLLVMPassesTransformer(passes, optLevel, tm->get(),
+                                             optPosition)(module);
+    };
+  } else {
+    transformer = mlir::makeLLVMPassesTransformer(
+        passes, optLevel, /*targetMachine=*/tmOrError->get(), optPosition);
+  }
 
   // Get the function used to compile and execute the module.
   using CompileAndExecuteFnT = Error (*)(
@@ -15,6 +15,7 @@
 #include "mlir/Transforms/FoldUtils.h"
 #include "mlir/Transforms/RegionUtils.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
@@ -45,6 +46,11 @@ public:
   bool simplify(MutableArrayRef<Region> regions, int maxIterations);
 
   void addToWorklist(Operation *op) {
+    // Remember the operations touched by a change, to start the next iteration
+    // from them.
+    if (recordChanges && changedOpSet.insert(op).second)
+      changedOps.push_back(op);
+
     // Check to see if the worklist already contains this op.
     if (worklistMap.count(op))
       return;
@@ -66,6 +72,7 @@ public:
   /// If the specified operation is in the worklist, remove it.  If not, this is
   /// a no-op.
   void removeFromWorklist(Operation *op) {
+    changedOpSet.erase(op);
     auto it = worklistMap.find(op);
     if (it != worklistMap.end()) {
       assert(worklist[it->second] == op && "malformed worklist data structure");
@@ -93,6 +100,15 @@ protected:
     });
   }
 
+  // When an operation is updated in place, its users may now be simplified and
+  // the operation itself may be matched by other patterns.
+  void finalizeRootUpdate(Operation *op) override {
+    addToWorklist(op);
+    for (auto result : op->getResults())
+      for (auto *user : result.getUsers())
+        addToWorklist(user);
+  }
+
   // When the root of a pattern is about to be replaced, it can trigger
   // simplifications to its users - make sure to add them to the worklist
   // before the root is changed.
@@ -131,6 +147,13 @@ private:
   std::vector<Operation *> worklist;
   DenseMap<Operation *, unsigned> worklistMap;
 
+  /// The operations added to the worklist by a change in the current
+  /// iteration, in the order they were added. Operations erased since are
+  /// dropped from the set but not from the vector.
+  std::vector<Operation *> changedOps;
+  DenseSet<Operation *> changedOpSet;
+  bool recordChanges = false;
+
   /// Non-pattern based folder for operations.
   OperationFolder folder;
 };
@@ -142,12 +165,27 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions,
   // Add the given operation to the worklist.
   auto collectOps = [this](Operation *op) { addToWorklist(op); };
 
+  // Rewrites notify the driver of every operation they touch, so only the
+  // first iteration, and those following a change to the CFG, have to scan
+  // the regions. The others start from the operations that the previous
+  // iteration changed.
   bool changed = false;
+  bool rescan = true;
   int i = 0;
   do {
-    // Add all nested operations to the worklist.
-    for (auto &region : regions)
-      region.walk(collectOps);
+    recordChanges = false;
+    if (rescan) {
+      // Add all nested operations to the worklist.
+      for (auto &region : regions)
+        region.walk(collectOps);
+    } else {
+      for (Operation *op : changedOps)
+        if (changedOpSet.count(op))
+          addToWorklist(op);
+    }
+    changedOps.clear();
+    changedOpSet.clear();
+    recordChanges = true;
 
     // These are scratch vectors used in the folding loop below.
     SmallVector<Value, 8> originalOperands, resultValues;
@@ -171,7 +209,10 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions,
       // Collects all the operands and result uses of the given `op` into work
       // list. Also remove `op` and nested ops from worklist.
       originalOperands.assign(op->operand_begin(), op->operand_end());
+      bool opReplaced = false;
       auto preReplaceAction = [&](Operation *op) {
+        opReplaced = true;
+
         // Add the operands to the worklist for visitation.
         addToWorklist(originalOperands);
 
@@ -184,10 +225,15 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions,
         notifyOperationRemoved(op);
       };
 
-      // Try to fold this op.
+      // Try to fold this op. If it was folded in place, revisit its users and
+      // give the patterns a chance to match the updated operation.
       if (succeeded(folder.tryToFold(op, collectOps, preReplaceAction))) {
-        changed |= true;
-        continue;
+        changed = true;
+        if (opReplaced)
+          continue;
+        for (auto result : op->getResults())
+          for (auto *user : result.getUsers())
+            addToWorklist(user);
       }
 
       // Make sure that any new operations are inserted at this point.
@@ -199,8 +245,10 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions,
     }
 
     // After applying patterns, make sure that the CFG of each of the regions is
-    // kept up to date.
-    if (succeeded(simplifyRegions(regions))) {
+    // kept up to date. The operations this erases are not reported to the
+    // driver, so the next iteration has to scan the regions again.
+    rescan = succeeded(simplifyRegions(regions));
+    if (rescan) {
       folder.clear();
       changed = true;
     }
@@ -0,0 +1,34 @@
+// RUN: mlir-cpu-runner %s -O3 -compile-threads=4 | FileCheck %s
+// RUN: mlir-cpu-runner %s -O3 -compile-threads=4 | FileCheck %s
+// RUN: mlir-cpu-runner %s -O3 -compile-threads=4 | FileCheck %s
+
+// The parts of the module are optimized on their compile threads at the same
+// time, each with a target machine of its own.
+
+llvm.func @fabsf(!llvm.float) -> !llvm.float
+
+llvm.func @negate(%arg0: !llvm.float) -> !llvm.float {
+  %0 = llvm.fneg %arg0 : !llvm.float
+  llvm.return %0 : !llvm.float
+}
+
+llvm.func @twice(%arg0: !llvm.float) -> !llvm.float {
+  %0 = llvm.fadd %arg0, %arg0 : !llvm.float
+  llvm.return %0 : !llvm.float
+}
+
+llvm.func @half(%arg0: !llvm.float) -> !llvm.float {
+  %0 = llvm.mlir.constant(5.000000e-01 : f32) : !llvm.float
+  %1 = llvm.fmul %arg0, %0 : !llvm.float
+  llvm.return %1 : !llvm.float
+}
+
+llvm.func @main() -> !llvm.float {
+  %0 = llvm.mlir.constant(4.200000e+02 : f32) : !llvm.float
+  %1 = llvm.call @negate(%0) : (!llvm.float) -> !llvm.float
+  %2 = llvm.call @twice(%1) : (!llvm.float) -> !llvm.float
+  %3 = llvm.call @half(%2) : (!llvm.float) -> !llvm.float
+  %4 = llvm.call @fabsf(%3) : (!llvm.float) -> !llvm.float
+  llvm.return %4 : !llvm.float
+}
+// CHECK: 4.200000e+02
@@ -0,0 +1,28 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: mlir-cpu-runner %s -object-cache-dir=%t | FileCheck %s
+// RUN: ls %t | FileCheck -check-prefix=CACHE %s
+
+// A second run loads the cached object instead of compiling the module.
+// RUN: mlir-cpu-runner %s -object-cache-dir=%t | FileCheck %s
+
+// RUN: mlir-cpu-runner %s -compile-threads=2 | FileCheck %s
+// RUN: mlir-cpu-runner %s -compile-threads=2 -object-cache-dir=%t | FileCheck %s
+
+// CACHE: llvmcache-
+
+llvm.func @fabsf(!llvm.float) -> !llvm.float
+
+llvm.func @negate(%arg0: !llvm.float) -> !llvm.float {
+  %0 = llvm.fneg %arg0 : !llvm.float
+  llvm.return %0 : !llvm.float
+}
+
+// Check that the result is the same whether the module is compiled in one
+// part, loaded from the cache or split across compile threads.
+llvm.func @main() -> !llvm.float {
+  %0 = llvm.mlir.constant(4.200000e+02 : f32) : !llvm.float
+  %1 = llvm.call @negate(%0) : (!llvm.float) -> !llvm.float
+  %2 = llvm.call @fabsf(%1) : (!llvm.float) -> !llvm.float
+  llvm.return %2 : !llvm.float
+}
+// CHECK: 4.200000e+02
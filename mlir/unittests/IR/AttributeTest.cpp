@@ -145,4 +145,30 @@ TEST(DenseSplatTest, BF16Splat) {
   testSplat(floatTy, value);
 }
 
+TEST(DenseUnownedTest, ReferencesBuffer) {
+  MLIRContext context;
+  IntegerType intTy = IntegerType::get(32, &context);
+  VectorType shape = VectorType::get({4}, intTy);
+
+  int32_t data[] = {1, 2, 3, 4};
+  ArrayRef<char> rawData(reinterpret_cast<const char *>(data), sizeof(data));
+  auto attr = DenseElementsAttr::getFromUnownedBuffer(shape, rawData);
+  EXPECT_TRUE(attr.isUnowned());
+  EXPECT_FALSE(attr.isSplat());
+  EXPECT_EQ(attr.getRawData().data(), rawData.data());
+  EXPECT_EQ(*std::next(attr.getValues<int32_t>().begin(), 2), 3);
+
+  // Unowned attributes are uniqued by the identity of their buffer.
+  EXPECT_EQ(DenseElementsAttr::getFromUnownedBuffer(shape, rawData), attr);
+  int32_t copy[] = {1, 2, 3, 4};
+  ArrayRef<char> rawCopy(reinterpret_cast<const char *>(copy), sizeof(copy));
+  EXPECT_NE(DenseElementsAttr::getFromUnownedBuffer(shape, rawCopy), attr);
+  EXPECT_NE(DenseElementsAttr::get(shape, llvm::makeArrayRef(data)), attr);
+
+  // Reshaping keeps referencing the same buffer.
+  auto reshaped = attr.reshape(VectorType::get({2, 2}, intTy));
+  EXPECT_TRUE(reshaped.isUnowned());
+  EXPECT_EQ(reshaped.getRawData().data(), rawData.data());
+}
+
 } // end namespace
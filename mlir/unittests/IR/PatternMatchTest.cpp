@@ -0,0 +1,99 @@
+//===- PatternMatchTest.cpp - Pattern matcher unit tests ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/PatternMatch.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+/// A pattern that records its attempts to match in `log` and never matches,
+/// unless `matches` is set.
+struct LoggingPattern : public RewritePattern {
+  LoggingPattern(StringRef rootName, PatternBenefit benefit,
+                 MLIRContext *context, std::vector<std::string> &log,
+                 bool matches = false)
+      : RewritePattern(rootName, benefit, context), log(log),
+        matches(matches) {}
+
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    log.push_back(getRootKind().getStringRef().str() + "/" +
+                  std::to_string(getBenefit().getBenefit()));
+    return success(matches);
+  }
+
+  std::vector<std::string> &log;
+  bool matches;
+};
+
+/// A rewriter that only inserts the operations it creates.
+struct TestRewriter : public PatternRewriter {
+  explicit TestRewriter(MLIRContext *context) : PatternRewriter(context) {}
+  Operation *insert(Operation *op) override { return OpBuilder::insert(op); }
+};
+
+Operation *createOp(MLIRContext *context, StringRef name) {
+  context->allowUnregisteredDialects();
+  return Operation::create(UnknownLoc::get(context),
+                           OperationName(name, context), llvm::None,
+                           llvm::None, llvm::None, llvm::None, 0,
+                           /*resizableOperandList=*/false);
+}
+
+TEST(RewritePatternMatcherTest, OnlyPatternsForTheRootAreTried) {
+  MLIRContext context;
+  std::vector<std::string> log;
+  OwningRewritePatternList patterns;
+  patterns.insert<LoggingPattern>("test.a", 1, &context, log);
+  patterns.insert<LoggingPattern>("test.b", 1, &context, log);
+  patterns.insert<LoggingPattern>("test.a", 3, &context, log);
+  patterns.insert<LoggingPattern>("test.a", PatternBenefit::impossibleToMatch(),
+                                  &context, log);
+  RewritePatternMatcher matcher(patterns);
+  TestRewriter rewriter(&context);
+
+  // The patterns rooted at the op are tried in order of decreasing benefit,
+  // and the one that can never match is not tried at all.
+  Operation *a = createOp(&context, "test.a");
+  EXPECT_FALSE(matcher.matchAndRewrite(a, rewriter));
+  EXPECT_EQ((std::vector<std::string>{"test.a/3", "test.a/1"}), log);
+
+  log.clear();
+  Operation *b = createOp(&context, "test.b");
+  EXPECT_FALSE(matcher.matchAndRewrite(b, rewriter));
+  EXPECT_EQ(std::vector<std::string>{"test.b/1"}, log);
+
+  // An op without patterns is not looked at.
+  log.clear();
+  Operation *c = createOp(&context, "test.c");
+  EXPECT_FALSE(matcher.matchAndRewrite(c, rewriter));
+  EXPECT_TRUE(log.empty());
+
+  a->destroy();
+  b->destroy();
+  c->destroy();
+}
+
+TEST(RewritePatternMatcherTest, StopsAtTheFirstMatch) {
+  MLIRContext context;
+  std::vector<std::string> log;
+  OwningRewritePatternList patterns;
+  patterns.insert<LoggingPattern>("test.a", 1, &context, log);
+  patterns.insert<LoggingPattern>("test.a", 2, &context, log,
+                                  /*matches=*/true);
+  patterns.insert<LoggingPattern>("test.a", 3, &context, log);
+  RewritePatternMatcher matcher(patterns);
+  TestRewriter rewriter(&context);
+
+  Operation *a = createOp(&context, "test.a");
+  EXPECT_TRUE(matcher.matchAndRewrite(a, rewriter));
+  EXPECT_EQ((std::vector<std::string>{"test.a/3", "test.a/2"}), log);
+  a->destroy();
+}
+} // end namespace
@@ -0,0 +1,112 @@
+//===--------- MemoryManager.cpp - Target independent memory manager ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Functionality for caching device memory of small objects.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MemoryManager.h"
+#include "device.h"
+#include "private.h"
+#include "rtl.h"
+
+#include <cstdlib>
+#include <string>
+
+MemoryManagerTy::MemoryManagerTy(RTLInfoTy *RTL, int32_t RTLDeviceID)
+    : RTL(RTL), RTLDeviceID(RTLDeviceID), Threshold(DefaultThreshold) {
+  if (char *envStr = getenv("LIBOMPTARGET_MEMORY_MANAGER_THRESHOLD")) {
+    Threshold = std::stoul(envStr);
+    size_t MaxThreshold = (size_t)1 << (NumBuckets - 1);
+    if (Threshold > MaxThreshold) {
+      DP("Memory manager threshold %zu is too large, using %zu instead\n",
+         Threshold, MaxThreshold);
+      Threshold = MaxThreshold;
+    }
+  }
+  DP("Memory manager threshold for device %d is %zu bytes\n", RTLDeviceID,
+     Threshold);
+}
+
+int MemoryManagerTy::findBucket(size_t Size) {
+  int Bucket = 0;
+  while (((size_t)1 << Bucket) < Size)
+    ++Bucket;
+  return Bucket;
+}
+
+void *MemoryManagerTy::allocateFromDevice(int Bucket, void *HstPtr) {
+  int64_t BucketSize = (int64_t)1 << Bucket;
+  void *TgtPtr = RTL->data_alloc(RTLDeviceID, BucketSize, HstPtr);
+  if (!TgtPtr) {
+    // The device may be out of memory because of the blocks we hold on to.
+    DP("Allocation of %ld bytes failed, releasing cached blocks and "
+       "retrying\n", BucketSize);
+    releaseFreeBlocks();
+    TgtPtr = RTL->data_alloc(RTLDeviceID, BucketSize, HstPtr);
+    if (!TgtPtr)
+      return nullptr;
+  }
+
+  std::lock_guard<std::mutex> LG(PtrToBucketMtx);
+  PtrToBucket[TgtPtr] = Bucket;
+  return TgtPtr;
+}
+
+void MemoryManagerTy::releaseFreeBlocks() {
+  for (int Bucket = 0; Bucket < NumBuckets; ++Bucket) {
+    std::vector<void *> Blocks;
+    {
+      std::lock_guard<std::mutex> LG(FreeListMtx[Bucket]);
+      Blocks.swap(FreeLists[Bucket]);
+    }
+    if (Blocks.empty())
+      continue;
+    {
+      std::lock_guard<std::mutex> LG(PtrToBucketMtx);
+      for (void *TgtPtr : Blocks)
+        PtrToBucket.erase(TgtPtr);
+    }
+    for (void *TgtPtr : Blocks)
+      RTL->data_delete(RTLDeviceID, TgtPtr);
+  }
+}
+
+void *MemoryManagerTy::allocate(int64_t Size, void *HstPtr) {
+  if (Size <= 0 || (size_t)Size > Threshold)
+    return RTL->data_alloc(RTLDeviceID, Size, HstPtr);
+
+  int Bucket = findBucket(Size);
+  {
+    std::lock_guard<std::mutex> LG(FreeListMtx[Bucket]);
+    std::vector<void *> &FreeList = FreeLists[Bucket];
+    if (!FreeList.empty()) {
+      void *TgtPtr = FreeList.back();
+      FreeList.pop_back();
+      DP("Reusing cached block " DPxMOD " for %ld bytes\n", DPxPTR(TgtPtr),
+         Size);
+      return TgtPtr;
+    }
+  }
+  return allocateFromDevice(Bucket, HstPtr);
+}
+
+int MemoryManagerTy::free(void *TgtPtr) {
+  int Bucket;
+  {
+    std::lock_guard<std::mutex> LG(PtrToBucketMtx);
+    auto It = PtrToBucket.find(TgtPtr);
+    if (It == PtrToBucket.end())
+      return RTL->data_delete(RTLDeviceID, TgtPtr);
+    Bucket = It->second;
+  }
+
+  std::lock_guard<std::mutex> LG(FreeListMtx[Bucket]);
+  FreeLists[Bucket].push_back(TgtPtr);
+  return OFFLOAD_SUCCESS;
+}
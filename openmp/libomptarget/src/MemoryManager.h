@@ -0,0 +1,83 @@
+//===----------- MemoryManager.h - Target independent memory manager ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Declarations for a target independent memory manager that caches device
+// memory of small objects.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _OMPTARGET_MEMORY_MANAGER_H
+#define _OMPTARGET_MEMORY_MANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations.
+struct RTLInfoTy;
+
+/// Keeps the device memory of small mapped objects around after they are
+/// unmapped, so that mapping objects of a similar size again, e.g. in each
+/// invocation of an offloaded loop, doesn't go through the plugin (and the
+/// device driver) every time.
+///
+/// Requests are rounded up to the next power of two and freed blocks are kept
+/// in one free list per size class. Requests larger than the threshold are
+/// forwarded to the plugin as is. The threshold can be set with the
+/// environment variable LIBOMPTARGET_MEMORY_MANAGER_THRESHOLD, a value of 0
+/// disables the cache.
+class MemoryManagerTy {
+  /// The largest size class is 2^(NumBuckets - 1) bytes.
+  static constexpr int NumBuckets = 21;
+
+  /// The default threshold in bytes.
+  static constexpr size_t DefaultThreshold = 8 * 1024;
+
+  RTLInfoTy *RTL;
+  int32_t RTLDeviceID;
+
+  /// Requests larger than this are not cached.
+  size_t Threshold;
+
+  /// Free blocks of each size class.
+  std::vector<void *> FreeLists[NumBuckets];
+  std::mutex FreeListMtx[NumBuckets];
+
+  /// Size class of each block allocated through the cache.
+  std::unordered_map<void *, int> PtrToBucket;
+  std::mutex PtrToBucketMtx;
+
+  /// Returns the size class that fits Size bytes.
+  static int findBucket(size_t Size);
+
+  /// Allocates a new block of the given size class from the plugin.
+  void *allocateFromDevice(int Bucket, void *HstPtr);
+
+  /// Returns all free blocks to the plugin.
+  void releaseFreeBlocks();
+
+public:
+  MemoryManagerTy(RTLInfoTy *RTL, int32_t RTLDeviceID);
+
+  /// The cached blocks are deliberately not returned to the plugin on
+  /// destruction: this happens at program exit, when the plugin may already
+  /// have been unloaded.
+  ~MemoryManagerTy() = default;
+
+  /// Allocates Size bytes of device memory, reusing a cached block if there is
+  /// one.
+  void *allocate(int64_t Size, void *HstPtr);
+
+  /// Frees TgtPtr, which must have been returned by allocate(). Small blocks
+  /// are kept for reuse.
+  int free(void *TgtPtr);
+};
+
+#endif
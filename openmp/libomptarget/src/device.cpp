@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "device.h"
+#include "MemoryManager.h"
 #include "private.h"
 #include "rtl.h"
 
@@ -198,7 +199,7 @@ void *DeviceTy::getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase,
     } else {
       // If it is not contained and Size > 0 we should create a new entry for it.
       IsNew = true;
-      uintptr_t tp = (uintptr_t)RTL->data_alloc(RTLDeviceID, Size, HstPtrBegin);
+      uintptr_t tp = (uintptr_t)allocData(Size, HstPtrBegin);
       DP("Creating new map entry: HstBase=" DPxMOD ", HstBegin=" DPxMOD ", "
          "HstEnd=" DPxMOD ", TgtBegin=" DPxMOD "\n", DPxPTR(HstPtrBase),
          DPxPTR(HstPtrBegin), DPxPTR((uintptr_t)HstPtrBegin + Size), DPxPTR(tp));
@@ -279,7 +280,7 @@ int DeviceTy::deallocTgtPtr(void *HstPtrBegin, int64_t Size, bool ForceDelete,
     if (HT.decRefCount() == 0) {
       DP("Deleting tgt data " DPxMOD " of size %ld\n",
           DPxPTR(HT.TgtPtrBegin), Size);
-      RTL->data_delete(RTLDeviceID, (void *)HT.TgtPtrBegin);
+      deleteData((void *)HT.TgtPtrBegin);
       DP("Removing%s mapping with HstPtrBegin=" DPxMOD ", TgtPtrBegin=" DPxMOD
           ", Size=%ld\n", (ForceDelete ? " (forced)" : ""),
           DPxPTR(HT.HstPtrBegin), DPxPTR(HT.TgtPtrBegin), Size);
@@ -303,6 +304,7 @@ void DeviceTy::init() {
     RTL->init_requires(RTLs->RequiresFlags);
   int32_t rc = RTL->init_device(RTLDeviceID);
   if (rc == OFFLOAD_SUCCESS) {
+    MemoryManager = std::make_shared<MemoryManagerTy>(RTL, RTLDeviceID);
     IsInit = true;
   }
 }
@@ -331,6 +333,20 @@ __tgt_target_table *DeviceTy::load_binary(void *Img) {
   return rc;
 }
 
+// Allocate device memory, reusing cached blocks for small objects.
+void *DeviceTy::allocData(int64_t Size, void *HstPtr) {
+  if (!MemoryManager)
+    return RTL->data_alloc(RTLDeviceID, Size, HstPtr);
+  return MemoryManager->allocate(Size, HstPtr);
+}
+
+// Free device memory allocated by allocData.
+int32_t DeviceTy::deleteData(void *TgtPtr) {
+  if (!MemoryManager)
+    return RTL->data_delete(RTLDeviceID, TgtPtr);
+  return MemoryManager->free(TgtPtr);
+}
+
 // Submit data to device.
 int32_t DeviceTy::data_submit(void *TgtPtrBegin, void *HstPtrBegin,
     int64_t Size) {
@@ -17,10 +17,12 @@
 #include <cstddef>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 // Forward declarations.
+class MemoryManagerTy;
 struct RTLInfoTy;
 struct __tgt_bin_desc;
 struct __tgt_target_table;
@@ -127,6 +129,10 @@ struct DeviceTy {
   // moved into the target task in libomp.
   std::map<int32_t, uint64_t> LoopTripCnt;
 
+  // Cache of device memory for small objects, created when the device is
+  // initialized. It is shared between copies of this DeviceTy.
+  std::shared_ptr<MemoryManagerTy> MemoryManager;
+
   DeviceTy(RTLInfoTy *RTL)
       : DeviceID(-1), RTL(RTL), RTLDeviceID(-1), IsInit(false), InitFlag(),
         HasPendingGlobals(false), HostDataToTargetMap(), PendingCtorsDtors(),
@@ -140,7 +146,7 @@ struct DeviceTy {
         HostDataToTargetMap(d.HostDataToTargetMap),
         PendingCtorsDtors(d.PendingCtorsDtors), ShadowPtrMap(d.ShadowPtrMap),
         DataMapMtx(), PendingGlobalsMtx(), ShadowMtx(),
-        LoopTripCnt(d.LoopTripCnt) {}
+        LoopTripCnt(d.LoopTripCnt), MemoryManager(d.MemoryManager) {}
 
   DeviceTy& operator=(const DeviceTy &d) {
     DeviceID = d.DeviceID;
@@ -152,6 +158,7 @@ struct DeviceTy {
     PendingCtorsDtors = d.PendingCtorsDtors;
     ShadowPtrMap = d.ShadowPtrMap;
     LoopTripCnt = d.LoopTripCnt;
+    MemoryManager = d.MemoryManager;
 
     return *this;
   }
@@ -173,6 +180,10 @@ struct DeviceTy {
   int32_t initOnce();
   __tgt_target_table *load_binary(void *Img);
 
+  // Allocate and free device memory through the memory manager.
+  void *allocData(int64_t Size, void *HstPtr);
+  int32_t deleteData(void *TgtPtr);
+
   int32_t data_submit(void *TgtPtrBegin, void *HstPtrBegin, int64_t Size);
   int32_t data_retrieve(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size);
 
@@ -4646,6 +4646,24 @@ static void __kmp_aux_affinity_initialize(void) {
 }
 #undef KMP_EXIT_AFF_NONE
 
+// On machines with several multi-core packages, the default hyper barrier
+// doesn't take into account that signaling a thread on another package is much
+// more expensive than one on the same package. When threads are bound, the
+// hierarchical barrier, which follows the machine hierarchy detected above, is
+// used for fork/join instead, unless a pattern was set explicitly. A flat
+// topology map has one core per package and is left alone.
+static void __kmp_affinity_tune_barriers(void) {
+  if (nPackages <= 1 || nCoresPerPkg <= 1)
+    return;
+  if (__kmp_barrier_pattern_set[bs_forkjoin_barrier])
+    return;
+  __kmp_barrier_gather_pattern[bs_forkjoin_barrier] = bp_hierarchical_bar;
+  __kmp_barrier_release_pattern[bs_forkjoin_barrier] = bp_hierarchical_bar;
+  KA_TRACE(10, ("__kmp_affinity_tune_barriers: %d packages of %d cores, using "
+                "the hierarchical fork/join barrier\n",
+                nPackages, nCoresPerPkg));
+}
+
 void __kmp_affinity_initialize(void) {
   // Much of the code above was written assuming that if a machine was not
   // affinity capable, then __kmp_affinity_type == affinity_none.  We now
@@ -4665,6 +4683,16 @@ void __kmp_affinity_initialize(void) {
   __kmp_aux_affinity_initialize();
   if (disabled) {
     __kmp_affinity_type = affinity_disabled;
+  } else if (__kmp_affinity_type != affinity_none) {
+    __kmp_affinity_tune_barriers();
+    // Consecutive thread ids only fill one package after the other when they
+    // are bound compactly, without permuting the topology levels or starting
+    // at an offset, and every package has the same number of processors.
+    if (__kmp_affinity_type == affinity_compact &&
+        __kmp_affinity_compact == 0 && __kmp_affinity_offset == 0 &&
+        nPackages > 1 && nCoresPerPkg > 1 &&
+        __kmp_avail_proc % nPackages == 0)
+      __kmp_steal_group_size = __kmp_avail_proc / nPackages;
   }
 }
 
@@ -87,6 +87,15 @@ kmp_uint32 __kmp_barrier_gather_branch_bits[bs_last_barrier] = {0};
 kmp_uint32 __kmp_barrier_release_branch_bits[bs_last_barrier] = {0};
 kmp_bar_pat_e __kmp_barrier_gather_pattern[bs_last_barrier] = {bp_linear_bar};
 kmp_bar_pat_e __kmp_barrier_release_pattern[bs_last_barrier] = {bp_linear_bar};
+// Whether the pattern of a barrier was set through KMP_*_BARRIER_PATTERN, in
+// which case it isn't tuned for the machine topology.
+int __kmp_barrier_pattern_set[bs_last_barrier] = {FALSE};
+
+// Number of consecutive thread ids sharing a package when threads are bound
+// compactly, or 0 if unknown. Task stealing prefers victims within this group.
+// This describes the threads of an outermost team; the grouping of the
+// threads of nested teams only matches it if they are bound the same way.
+int __kmp_steal_group_size = 0;
 char const *__kmp_barrier_branch_bit_env_name[bs_last_barrier] = {
     "KMP_PLAIN_BARRIER", "KMP_FORKJOIN_BARRIER"
 #if KMP_FAST_REDUCTION_BARRIER
@@ -1600,6 +1600,7 @@ static void __kmp_stg_parse_barrier_pattern(char const *name, char const *value,
     if ((strcmp(var, name) == 0) && (value != 0)) {
       int j;
       char *comma = CCAST(char *, strchr(value, ','));
+      __kmp_barrier_pattern_set[i] = TRUE;
 
       /* handle first parameter: gather pattern */
       for (j = bp_linear_bar; j < bp_last_bar; j++) {
@@ -245,7 +245,11 @@ __kmp_depnode_link_successor(kmp_int32 gtid, kmp_info_t *thread,
     kmp_depnode_t *dep = p->node;
     if (dep->dn.task) {
       KMP_ACQUIRE_DEPNODE(gtid, dep);
-      if (dep->dn.task) {
+      // The dependences of a task are processed before those of the next one,
+      // so if node is already a successor of dep (e.g. because dep wrote
+      // several of the addresses node depends on) it is the latest one.
+      if (dep->dn.task &&
+          (!dep->dn.successors || dep->dn.successors->node != node)) {
         __kmp_track_dependence(dep, node, task);
         dep->dn.successors = __kmp_add_node(thread, dep->dn.successors, node);
         KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
@@ -271,7 +275,8 @@ static inline kmp_int32 __kmp_depnode_link_successor(kmp_int32 gtid,
   if (sink->dn.task) {
     // synchronously add source to sink' list of successors
     KMP_ACQUIRE_DEPNODE(gtid, sink);
-    if (sink->dn.task) {
+    if (sink->dn.task &&
+        (!sink->dn.successors || sink->dn.successors->node != source)) {
       __kmp_track_dependence(sink, source, task);
       sink->dn.successors = __kmp_add_node(thread, sink->dn.successors, source);
       KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
@@ -2837,7 +2837,25 @@ static inline int __kmp_execute_tasks_template(
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
             // and failed.  Arch says that's not such a great idea.
-            victim_tid = __kmp_get_random(thread) % (nthreads - 1);
+            // On machines with several packages, every other pick is limited
+            // to the threads of our own package, so that the data of stolen
+            // tasks is more likely to be in a shared cache.
+            unsigned short rnd = __kmp_get_random(thread);
+            kmp_int32 first = 0, range = nthreads;
+            if (__kmp_steal_group_size > 1) {
+              // The low bit picks the kind of victim, the rest picks one.
+              bool in_group = rnd & 1;
+              rnd >>= 1;
+              if (in_group) {
+                first = tid - tid % __kmp_steal_group_size;
+                range = KMP_MIN(__kmp_steal_group_size, nthreads - first);
+                if (range <= 1) {
+                  first = 0;
+                  range = nthreads;
+                }
+              }
+            }
+            victim_tid = first + rnd % (range - 1);
             if (victim_tid >= tid) {
               ++victim_tid; // Adjusts random distribution to exclude self
             }
@@ -153,6 +153,11 @@ public:
   static bool isReductionParallel(__isl_keep isl_ast_node *Node);
 
   /// Will the loop be run as thread parallel?
+  ///
+  /// Besides being parallel, the loop has to be the outermost parallel loop,
+  /// not innermost and not known to do too little work to pay for starting
+  /// the threads (-polly-parallel-min-work). -polly-parallel-force skips the
+  /// last two checks.
   static bool isExecutedInParallel(__isl_keep isl_ast_node *Node);
 
   /// Get the nodes schedule or a nullptr if not available.
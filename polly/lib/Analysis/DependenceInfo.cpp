@@ -25,6 +25,7 @@
 #include "polly/ScopInfo.h"
 #include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLTools.h"
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/Support/Debug.h"
 #include "isl/aff.h"
 #include "isl/ctx.h"
@@ -485,6 +486,15 @@ void Dependences::calculateDependences(Scop &S) {
     isl_union_map_free(StrictWAW);
     RAW = WAW = WAR = StrictWAW = nullptr;
     isl_ctx_reset_error(IslCtx.get());
+
+    LLVM_DEBUG(dbgs() << "Dependence analysis exceeded max_operations\n");
+    S.getORE().emit(
+        OptimizationRemarkAnalysis(DEBUG_TYPE, "DependenceComputeOut",
+                                   S.getEntry()->getTerminator())
+        << "Dependence analysis was aborted after reaching the limit of "
+        << ore::NV("MaxOperations", OptComputeOut)
+        << " isl operations (-polly-dependences-computeout); the SCoP is not "
+           "optimized");
   }
 
   // Drop out early, as the remaining computations are only needed for
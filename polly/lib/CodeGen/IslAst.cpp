@@ -35,9 +35,11 @@
 #include "polly/ScopInfo.h"
 #include "polly/ScopPass.h"
 #include "polly/Support/GICHelper.h"
+#include "polly/Support/ISLTools.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/IR/Function.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 #include "isl/aff.h"
 #include "isl/ast.h"
@@ -75,6 +77,12 @@ static cl::opt<bool> PollyParallelForce(
         "Force generation of thread parallel code ignoring any cost model"),
     cl::init(false), cl::ZeroOrMore, cl::cat(PollyCategory));
 
+static cl::opt<unsigned> PollyParallelMinWork(
+    "polly-parallel-min-work",
+    cl::desc("Do not run loops in parallel that are known to execute fewer "
+             "statement instances than this (0 means no minimum)"),
+    cl::Hidden, cl::init(1000), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 static cl::opt<bool> UseContext("polly-ast-use-context",
                                 cl::desc("Use context"), cl::Hidden,
                                 cl::init(true), cl::ZeroOrMore,
@@ -621,23 +629,106 @@ bool IslAstInfo::isReductionParallel(__isl_keep isl_ast_node *Node) {
   return Payload && Payload->IsReductionParallel;
 }
 
+/// Return the number of iterations of the for node @p For, if it is known at
+/// compile time.
+static Optional<uint64_t> getConstantTripCount(const isl::ast_node &For) {
+  isl::ast_expr Init = For.for_get_init();
+  isl::ast_expr Inc = For.for_get_inc();
+  isl::ast_expr Cond = For.for_get_cond();
+  if (isl_ast_expr_get_type(Init.get()) != isl_ast_expr_int ||
+      isl_ast_expr_get_type(Inc.get()) != isl_ast_expr_int ||
+      isl_ast_expr_get_type(Cond.get()) != isl_ast_expr_op)
+    return None;
+
+  isl_ast_op_type OpType = isl_ast_expr_get_op_type(Cond.get());
+  if (OpType != isl_ast_op_le && OpType != isl_ast_op_lt)
+    return None;
+  isl::ast_expr UB = Cond.get_op_arg(1);
+  if (isl_ast_expr_get_type(UB.get()) != isl_ast_expr_int)
+    return None;
+
+  long LowerBound = Init.get_val().get_num_si();
+  long UpperBound = UB.get_val().get_num_si();
+  long Stride = Inc.get_val().get_num_si();
+  if (OpType == isl_ast_op_lt)
+    UpperBound--;
+  if (Stride <= 0)
+    return None;
+  if (UpperBound < LowerBound)
+    return 0;
+  return (UpperBound - LowerBound) / Stride + 1;
+}
+
+/// Return how many statement instances @p Node executes, if it is known at
+/// compile time.
+static Optional<uint64_t> getNumberOfStatementInstances(
+    const isl::ast_node &Node) {
+  switch (isl_ast_node_get_type(Node.get())) {
+  case isl_ast_node_user:
+    return 1;
+  case isl_ast_node_mark:
+    return getNumberOfStatementInstances(Node.mark_get_node());
+  case isl_ast_node_block: {
+    uint64_t Sum = 0;
+    for (isl::ast_node Child : Node.block_get_children()) {
+      Optional<uint64_t> Instances = getNumberOfStatementInstances(Child);
+      if (!Instances)
+        return None;
+      Sum = SaturatingAdd(Sum, *Instances);
+    }
+    return Sum;
+  }
+  case isl_ast_node_if: {
+    Optional<uint64_t> Then = getNumberOfStatementInstances(Node.if_get_then());
+    if (!Then || !Node.if_has_else())
+      return Then;
+    Optional<uint64_t> Else = getNumberOfStatementInstances(Node.if_get_else());
+    if (!Else)
+      return None;
+    return std::max(*Then, *Else);
+  }
+  case isl_ast_node_for: {
+    Optional<uint64_t> TripCount = getConstantTripCount(Node);
+    if (!TripCount)
+      return None;
+    Optional<uint64_t> Body =
+        getNumberOfStatementInstances(Node.for_get_body());
+    if (!Body)
+      return None;
+    return SaturatingMultiply(*TripCount, *Body);
+  }
+  default:
+    return None;
+  }
+}
+
 bool IslAstInfo::isExecutedInParallel(__isl_keep isl_ast_node *Node) {
   if (!PollyParallel)
     return false;
 
+  if (!isOutermostParallel(Node) || isReductionParallel(Node))
+    return false;
+
+  if (PollyParallelForce)
+    return true;
+
   // Do not parallelize innermost loops.
   //
   // Parallelizing innermost loops is often not profitable, especially if
   // they have a low number of iterations.
-  //
-  // TODO: Decide this based on the number of loop iterations that will be
-  //       executed. This can possibly require run-time checks, which again
-  //       raises the question of both run-time check overhead and code size
-  //       costs.
-  if (!PollyParallelForce && isInnermost(Node))
+  if (isInnermost(Node))
     return false;
 
-  return isOutermostParallel(Node) && !isReductionParallel(Node);
+  // Starting the threads costs far more than a few statement instances, so
+  // only run a loop in parallel if it is not known to be too small for that.
+  // Loops with bounds that are only known at run time are still run in
+  // parallel, deciding those would need a run-time check.
+  isl::ast_node For = isl::manage_copy(Node);
+  Optional<uint64_t> TripCount = getConstantTripCount(For);
+  if (TripCount && *TripCount < 2)
+    return false;
+  Optional<uint64_t> Instances = getNumberOfStatementInstances(For);
+  return !Instances || *Instances >= PollyParallelMinWork;
 }
 
 __isl_give isl_union_map *